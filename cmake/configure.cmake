@@ -156,8 +156,8 @@ if(LITE_WITH_ARM82_FP16)
 endif()
 
 if (LITE_WITH_CV)
-    if(NOT LITE_WITH_ARM)
-        message(FATAL_ERROR "CV functions uses the ARM instructions, so LITE_WITH_ARM must be turned on")
+    if(NOT LITE_WITH_ARM AND NOT LITE_WITH_X86)
+        message(FATAL_ERROR "CV functions uses the ARM or x86 instructions, so LITE_WITH_ARM or LITE_WITH_X86 must be turned on")
     endif()
     add_definitions("-DLITE_WITH_CV")
 endif()
@@ -0,0 +1,87 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/async_runner.h"
+#include <utility>
+#include "lite/api/cxx_api.h"
+
+namespace paddle {
+namespace lite {
+
+AsyncRunner::AsyncRunner(std::vector<Worker>&& workers)
+    : workers_(std::move(workers)) {
+  CHECK(!workers_.empty()) << "AsyncRunner needs at least one predictor.";
+  for (auto& worker : workers_) {
+    Worker* w = &worker;
+    threads_.emplace_back([this, w]() { WorkerLoop(w); });
+  }
+}
+
+AsyncRunner::~AsyncRunner() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  request_cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void AsyncRunner::Submit(std::vector<Tensor>&& inputs,
+                         const Callback& callback) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    requests_.push_back(Request{std::move(inputs), callback});
+  }
+  request_cv_.notify_one();
+}
+
+void AsyncRunner::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_cv_.wait(lock, [this] { return requests_.empty() && running_ == 0; });
+}
+
+void AsyncRunner::WorkerLoop(Worker* worker) {
+  while (true) {
+    Request request;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      request_cv_.wait(lock, [this] { return stop_ || !requests_.empty(); });
+      if (requests_.empty()) {
+        return;  // stopped and drained
+      }
+      request = std::move(requests_.front());
+      requests_.pop_front();
+      running_++;
+    }
+    // The request owns a private copy of the inputs, the clone just shares
+    // its buffers.
+    for (size_t i = 0; i < request.inputs.size(); ++i) {
+      worker->raw_predictor->GetInput(i)->ShareDataWith(request.inputs[i]);
+    }
+    worker->predictor->Run();
+    if (request.callback) {
+      request.callback(worker->predictor.get());
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_--;
+    }
+    idle_cv_.notify_all();
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
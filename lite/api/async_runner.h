@@ -0,0 +1,76 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <condition_variable>  //NOLINT
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>   //NOLINT
+#include <thread>  //NOLINT
+#include <vector>
+#include "lite/api/paddle_api.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+class Predictor;
+
+/*
+ * AsyncRunner backs PaddlePredictor::RunAsync. It owns a fixed set of
+ * clones of a predictor, each driven by its own thread. Requests are queued
+ * in submission order and picked up by the first idle clone.
+ */
+class AsyncRunner {
+ public:
+  using Callback = std::function<void(lite_api::PaddlePredictor*)>;
+
+  struct Worker {
+    // the public predictor passed to the callbacks
+    std::shared_ptr<lite_api::PaddlePredictor> predictor;
+    // the same predictor, used to feed the inputs of a request
+    std::shared_ptr<Predictor> raw_predictor;
+  };
+
+  explicit AsyncRunner(std::vector<Worker>&& workers);
+  // Finishes all the queued requests before returning.
+  ~AsyncRunner();
+
+  // Queue a request, `inputs` are the input tensors in the order of
+  // GetInputNames().
+  void Submit(std::vector<Tensor>&& inputs, const Callback& callback);
+  // Block until the queue is drained and every clone is idle.
+  void Wait();
+
+ private:
+  struct Request {
+    std::vector<Tensor> inputs;
+    Callback callback;
+  };
+
+  void WorkerLoop(Worker* worker);
+
+  std::vector<Worker> workers_;
+  std::vector<std::thread> threads_;
+  std::deque<Request> requests_;
+  int running_{0};
+  bool stop_{false};
+  std::mutex mutex_;
+  std::condition_variable request_cv_;
+  std::condition_variable idle_cv_;
+};
+
+}  // namespace lite
+}  // namespace paddle
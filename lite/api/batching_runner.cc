@@ -0,0 +1,287 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/batching_runner.h"
+#include <algorithm>
+#include <cstring>
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+
+using lite_api::BatchTensor;
+using lite_api::PrecisionType;
+
+namespace {
+
+int64_t RowsOf(const std::vector<BatchTensor>& inputs) {
+  if (inputs.empty() || inputs[0].shape.empty()) return 1;
+  return inputs[0].shape[0];
+}
+
+// The number of level-0 sequences of a request, every row is a sequence if
+// the first input has no LoD.
+int64_t SequencesOf(const std::vector<BatchTensor>& inputs) {
+  if (inputs.empty() || inputs[0].lod.empty()) return RowsOf(inputs);
+  return static_cast<int64_t>(inputs[0].lod[0].size()) - 1;
+}
+
+// Requests can be concatenated if every input only differs in dim 0.
+bool Concatenable(const std::vector<BatchTensor>& a,
+                  const std::vector<BatchTensor>& b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].precision != b[i].precision ||
+        a[i].shape.size() != b[i].shape.size() || a[i].shape.empty() ||
+        a[i].lod.size() != b[i].lod.size() ||
+        !std::equal(a[i].shape.begin() + 1,
+                    a[i].shape.end(),
+                    b[i].shape.begin() + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int64_t Production(const lite_api::shape_t& shape, size_t begin) {
+  int64_t res = 1;
+  for (size_t i = begin; i < shape.size(); ++i) res *= shape[i];
+  return res;
+}
+
+void* MutableData(lite_api::Tensor* tensor, PrecisionType precision) {
+  switch (precision) {
+    case PrecisionType::kFloat:
+      return tensor->mutable_data<float>();
+    case PrecisionType::kFP64:
+      return tensor->mutable_data<double>();
+    case PrecisionType::kInt64:
+      return tensor->mutable_data<int64_t>();
+    case PrecisionType::kInt32:
+      return tensor->mutable_data<int32_t>();
+    case PrecisionType::kInt16:
+      return tensor->mutable_data<int16_t>();
+    case PrecisionType::kInt8:
+      return tensor->mutable_data<int8_t>();
+    case PrecisionType::kUInt8:
+      return tensor->mutable_data<uint8_t>();
+    case PrecisionType::kBool:
+      return tensor->mutable_data<bool>();
+    default:
+      LOG(FATAL) << "Unsupported precision of RunBatched inputs: "
+                 << lite_api::PrecisionToStr(precision);
+  }
+  return nullptr;
+}
+
+size_t ElementSize(PrecisionType precision) {
+  size_t size = precision == PrecisionType::kBool
+                    ? sizeof(bool)
+                    : lite_api::PrecisionTypeLength(precision);
+  CHECK_GT(size, 0u) << "Unsupported precision of RunBatched tensors: "
+                     << lite_api::PrecisionToStr(precision);
+  return size;
+}
+
+}  // namespace
+
+BatchingRunner::BatchingRunner(lite_api::PaddlePredictor* predictor,
+                               int max_batch_size,
+                               int max_queue_delay_us)
+    : predictor_(predictor),
+      max_batch_size_(std::max(max_batch_size, 1)),
+      max_queue_delay_(std::max(max_queue_delay_us, 0)) {
+  dispatcher_ = std::thread(&BatchingRunner::DispatchLoop, this);
+}
+
+BatchingRunner::~BatchingRunner() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  request_cv_.notify_all();
+  dispatcher_.join();
+}
+
+void BatchingRunner::Run(const std::vector<BatchTensor>& inputs,
+                         std::vector<BatchTensor>* outputs) {
+  CHECK(outputs);
+  Request request;
+  request.inputs = &inputs;
+  request.outputs = outputs;
+  request.arrival = std::chrono::steady_clock::now();
+  request.rows = RowsOf(inputs);
+  std::unique_lock<std::mutex> lock(mutex_);
+  CHECK(!stop_) << "RunBatched is called on a destroyed predictor.";
+  requests_.push_back(&request);
+  request_cv_.notify_one();
+  done_cv_.wait(lock, [&request] { return request.done; });
+}
+
+void BatchingRunner::DispatchLoop() {
+  std::vector<Request*> batch;
+  while (CollectBatch(&batch)) {
+    RunBatch(batch);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto* request : batch) request->done = true;
+    }
+    done_cv_.notify_all();
+  }
+}
+
+bool BatchingRunner::CollectBatch(std::vector<Request*>* batch) {
+  batch->clear();
+  std::unique_lock<std::mutex> lock(mutex_);
+  request_cv_.wait(lock, [this] { return stop_ || !requests_.empty(); });
+  if (requests_.empty()) return false;
+  const auto& head = *requests_.front()->inputs;
+  // The rows the oldest request would be run with, a request which cannot be
+  // concatenated closes the batch to keep the arrival order.
+  auto ready_rows = [&]() {
+    int64_t rows = 0;
+    for (auto* request : requests_) {
+      if (rows > 0 && !Concatenable(head, *request->inputs)) break;
+      rows += request->rows;
+    }
+    return rows;
+  };
+  auto deadline = requests_.front()->arrival + max_queue_delay_;
+  while (!stop_ && ready_rows() < max_batch_size_) {
+    if (request_cv_.wait_until(lock, deadline) == std::cv_status::timeout) {
+      break;
+    }
+  }
+  int64_t rows = 0;
+  while (!requests_.empty()) {
+    auto* request = requests_.front();
+    if (!batch->empty() &&
+        (rows + request->rows > max_batch_size_ ||
+         !Concatenable(head, *request->inputs))) {
+      break;
+    }
+    rows += request->rows;
+    batch->push_back(request);
+    requests_.pop_front();
+  }
+  return true;
+}
+
+void BatchingRunner::RunBatch(const std::vector<Request*>& batch) {
+  const auto& head = *batch.front()->inputs;
+  // Feed the concatenated inputs.
+  for (size_t i = 0; i < head.size(); ++i) {
+    lite_api::shape_t shape = head[i].shape;
+    lite_api::lod_t lod(head[i].lod.size(), std::vector<uint64_t>(1, 0));
+    if (!shape.empty()) {
+      shape[0] = 0;
+      for (auto* request : batch) shape[0] += (*request->inputs)[i].shape[0];
+    }
+    for (auto* request : batch) {
+      const auto& request_lod = (*request->inputs)[i].lod;
+      for (size_t level = 0; level < lod.size(); ++level) {
+        uint64_t offset = lod[level].back();
+        for (size_t j = 1; j < request_lod[level].size(); ++j) {
+          lod[level].push_back(offset + request_lod[level][j]);
+        }
+      }
+    }
+    auto tensor = predictor_->GetInput(static_cast<int>(i));
+    tensor->Resize(shape);
+    tensor->SetLoD(lod);
+    auto* dst = static_cast<char*>(MutableData(tensor.get(), head[i].precision));
+    size_t element_size = ElementSize(head[i].precision);
+    for (auto* request : batch) {
+      const auto& input = (*request->inputs)[i];
+      size_t bytes = Production(input.shape, 0) * element_size;
+      CHECK_EQ(input.data.size(), bytes)
+          << "The data size of input " << i << " mismatches its shape.";
+      std::memcpy(dst, input.data.data(), bytes);
+      dst += bytes;
+    }
+  }
+
+  predictor_->Run();
+
+  int64_t total_rows = 0;
+  int64_t total_sequences = 0;
+  for (auto* request : batch) {
+    total_rows += request->rows;
+    total_sequences += SequencesOf(*request->inputs);
+  }
+  // Split every output along dim 0.
+  auto output_names = predictor_->GetOutputNames();
+  for (auto* request : batch) {
+    request->outputs->resize(output_names.size());
+  }
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    auto tensor = predictor_->GetOutput(static_cast<int>(i));
+    lite_api::shape_t shape = tensor->shape();
+    lite_api::lod_t lod = tensor->lod();
+    PrecisionType precision = tensor->precision();
+    const char* src = static_cast<const char*>(tensor->data<void>());
+    size_t element_size = ElementSize(precision);
+    if (batch.size() == 1) {
+      auto& output = (*batch.front()->outputs)[i];
+      output.shape = shape;
+      output.lod = lod;
+      output.precision = precision;
+      output.data.assign(src, src + Production(shape, 0) * element_size);
+      continue;
+    }
+    CHECK(!shape.empty()) << "Can not split the scalar output " << i
+                          << " of a batch.";
+    size_t row_bytes = Production(shape, 1) * element_size;
+    bool split_by_lod =
+        !lod.empty() &&
+        static_cast<int64_t>(lod[0].size()) - 1 == total_sequences;
+    bool split_by_sequences = !split_by_lod && shape[0] != total_rows;
+    CHECK(split_by_lod || shape[0] == total_rows ||
+          shape[0] == total_sequences)
+        << "Can not split output " << i << " with dim 0 of " << shape[0]
+        << " back to the " << batch.size() << " requests of a batch.";
+    uint64_t cursor = 0;
+    for (auto* request : batch) {
+      auto& output = (*request->outputs)[i];
+      output.shape = shape;
+      output.lod.clear();
+      output.precision = precision;
+      uint64_t begin = cursor;
+      uint64_t end = 0;
+      if (split_by_lod) {
+        end = begin + SequencesOf(*request->inputs);
+        // Descend the LoD levels down to the rows of the sequences.
+        for (const auto& level : lod) {
+          std::vector<uint64_t> offsets;
+          for (uint64_t j = begin; j <= end; ++j) {
+            offsets.push_back(level[j] - level[begin]);
+          }
+          output.lod.push_back(offsets);
+          begin = level[begin];
+          end = level[end];
+        }
+        cursor += SequencesOf(*request->inputs);
+      } else {
+        end = begin + (split_by_sequences ? SequencesOf(*request->inputs)
+                                          : request->rows);
+        cursor = end;
+      }
+      output.shape[0] = static_cast<int64_t>(end - begin);
+      output.data.assign(src + begin * row_bytes, src + end * row_bytes);
+    }
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
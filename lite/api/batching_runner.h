@@ -0,0 +1,78 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <chrono>              //NOLINT
+#include <condition_variable>  //NOLINT
+#include <deque>
+#include <mutex>   //NOLINT
+#include <thread>  //NOLINT
+#include <vector>
+#include "lite/api/paddle_api.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * BatchingRunner backs PaddlePredictor::RunBatched. Requests are queued by
+ * the calling threads and a dispatcher thread drains the queue: starting from
+ * the oldest request it waits at most `max_queue_delay_us` for more rows,
+ * concatenates the compatible requests along dim 0 (shifting their LoD), runs
+ * the predictor once and splits every output back along dim 0, by the
+ * level-0 LoD of the output if it has one.
+ *
+ * Only the dispatcher thread touches the predictor, so it must not be run
+ * by other threads while RunBatched requests are in flight.
+ */
+class BatchingRunner {
+ public:
+  BatchingRunner(lite_api::PaddlePredictor* predictor,
+                 int max_batch_size,
+                 int max_queue_delay_us);
+  // Finishes all the queued requests before returning.
+  ~BatchingRunner();
+
+  // Queue a request and block until its outputs are filled, `inputs` are in
+  // the order of GetInputNames().
+  void Run(const std::vector<lite_api::BatchTensor>& inputs,
+           std::vector<lite_api::BatchTensor>* outputs);
+
+ private:
+  struct Request {
+    const std::vector<lite_api::BatchTensor>* inputs;
+    std::vector<lite_api::BatchTensor>* outputs;
+    std::chrono::steady_clock::time_point arrival;
+    int64_t rows;
+    bool done{false};
+  };
+
+  void DispatchLoop();
+  // Moves the requests run together with the oldest one from the queue into
+  // `batch`, returns false if the runner is stopped and the queue is empty.
+  bool CollectBatch(std::vector<Request*>* batch);
+  void RunBatch(const std::vector<Request*>& batch);
+
+  lite_api::PaddlePredictor* predictor_;
+  int64_t max_batch_size_;
+  std::chrono::microseconds max_queue_delay_;
+  std::deque<Request*> requests_;
+  bool stop_{false};
+  std::mutex mutex_;
+  std::condition_variable request_cv_;
+  std::condition_variable done_cv_;
+  std::thread dispatcher_;
+};
+
+}  // namespace lite
+}  // namespace paddle
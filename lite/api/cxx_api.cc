@@ -70,7 +70,8 @@ bool IsQuantizedMode(const std::shared_ptr<cpp::ProgramDesc> &program_desc) {
 
 void Predictor::SaveModel(const std::string &dir,
                           lite_api::LiteModelType model_type,
-                          bool record_info) {
+                          bool record_info,
+                          lite_api::ParamEncodingType param_encoding) {
   if (!program_) {
     GenRuntimeProgram();
   }
@@ -80,7 +81,10 @@ void Predictor::SaveModel(const std::string &dir,
       SaveModelPb(dir, *program_->exec_scope(), *program_desc_.get(), true);
       break;
     case lite_api::LiteModelType::kNaiveBuffer:
-      SaveModelNaive(dir, *program_->exec_scope(), *program_desc_.get());
+      SaveModelNaive(dir,
+                     *program_->exec_scope(),
+                     *program_desc_.get(),
+                     param_encoding);
       break;
     default:
       LOG(FATAL) << "Unknown model type";
@@ -174,7 +178,7 @@ lite::Tensor *Predictor::GetInput(size_t offset) {
   CHECK(input_names_.size() > offset)
       << "The network has " << input_names_.size() << " inputs"
       << ", the offset should be less than this.";
-  auto *in_var = exec_scope_->FindVar(input_names_[offset]);
+  auto *in_var = input_vars_[offset];
   CHECK(in_var) << "no fatch variable " << input_names_[offset]
                 << " in exec_scope";
   return in_var->GetMutable<lite::Tensor>();
@@ -236,6 +240,14 @@ void Predictor::PrepareFeedFetch() {
     output_names_[fetchs[i]->GetAttr<int>("col")] =
         fetchs[i]->Input("X").front();
   }
+  input_vars_.resize(input_names_.size());
+  output_vars_.resize(output_names_.size());
+  for (size_t i = 0; i < input_names_.size(); i++) {
+    input_vars_[i] = FindVar(input_names_[i]);
+  }
+  for (size_t i = 0; i < output_names_.size(); i++) {
+    output_vars_[i] = FindVar(output_names_[i]);
+  }
   for (size_t i = 0; i < feeds.size(); i++) {
     input_precisions_[i] = GetInput(i)->precision();
   }
@@ -246,9 +258,9 @@ const lite::Tensor *Predictor::GetOutput(size_t offset) const {
   CHECK(output_names_.size() > offset)
       << "The network has " << output_names_.size() << " outputs"
       << ", the offset should be less than this.";
-  const std::string name = output_names_.at(offset);
-  auto *out_var = exec_scope_->FindVar(name);
-  CHECK(out_var) << "no fatch variable " << name << " in exec_scope";
+  auto *out_var = output_vars_[offset];
+  CHECK(out_var) << "no fatch variable " << output_names_[offset]
+                 << " in exec_scope";
   return out_var->GetMutable<lite::Tensor>();
 }
 
@@ -256,8 +268,7 @@ std::vector<const lite::Tensor *> Predictor::GetOutputs() const {
   std::vector<const lite::Tensor *> outputs;
   size_t out_size = output_names_.size();
   for (size_t i = 0; i < out_size; i++) {
-    const std::string name = output_names_.at(i);
-    outputs.push_back(GetTensor(name));
+    outputs.push_back(GetOutput(i));
   }
   return outputs;
 }
@@ -402,14 +413,19 @@ void Predictor::GenRuntimeProgram() {
   program_generated_ = true;
 }
 
+Variable *Predictor::FindVar(const std::string &name) const {
+  int slot = program_ ? program_->var_slot(name) : -1;
+  return slot >= 0 ? program_->var(slot) : exec_scope_->FindVar(name);
+}
+
 const lite::Tensor *Predictor::GetTensor(const std::string &name) const {
-  auto *var = exec_scope_->FindVar(name);
+  auto *var = FindVar(name);
   CHECK(var) << "no variable named with " << name << " in exec_scope";
   return &var->Get<lite::Tensor>();
 }
 
 lite::Tensor *Predictor::GetMutableTensor(const std::string &name) {
-  auto *var = exec_scope_->FindVar(name);
+  auto *var = FindVar(name);
   CHECK(var) << "no variable named with " << name << " in exec_scope";
   return var->GetMutable<lite::Tensor>();
 }
@@ -503,6 +519,10 @@ bool Predictor::TryShrinkMemory() {
   // Clear ArmL3Cache
   lite::DeviceInfo::Global().ClearArmL3Cache();
 #endif
+  // Drop the memory arena, it is planned again by the next run
+  if (program_->memory_planner()) {
+    program_->memory_planner()->Reset();
+  }
   const std::vector<std::string> &local_var_names =
       program_->exec_scope()->LocalVarNames();
   for (auto &var_name : local_var_names) {
@@ -544,23 +564,27 @@ void Predictor::CheckInputValid() {
 
 void Predictor::ClearTensorArray(
     const std::shared_ptr<const cpp::ProgramDesc> &program_desc) {
-  for (size_t blk_idx = 0; blk_idx < program_desc->BlocksSize(); blk_idx++) {
-    const cpp::BlockDesc *block =
-        program_desc->GetBlock<cpp::BlockDesc>(blk_idx);
-    for (size_t var_idx = 0; var_idx < block->VarsSize(); var_idx++) {
-      const cpp::VarDesc *var = block->GetVar<cpp::VarDesc>(var_idx);
-      CHECK(var);
-
-      auto *var_ptr = program_->exec_scope()->FindVar(var->Name());
-      if (var_ptr->IsType<std::vector<Tensor>>() &&
-          (var->Name() != "feed" && var->Name() != "fetch")) {
-        std::vector<Tensor> *tensor_array_var =
-            program_->exec_scope()->FindMutableTensorList(var->Name());
-        CHECK(tensor_array_var);
-        tensor_array_var->clear();
+  // The variables of the blocks are resolved by the first run, the later runs
+  // only check their types.
+  if (tensor_array_vars_.empty()) {
+    for (size_t blk_idx = 0; blk_idx < program_desc->BlocksSize(); blk_idx++) {
+      const cpp::BlockDesc *block =
+          program_desc->GetBlock<cpp::BlockDesc>(blk_idx);
+      for (size_t var_idx = 0; var_idx < block->VarsSize(); var_idx++) {
+        const cpp::VarDesc *var = block->GetVar<cpp::VarDesc>(var_idx);
+        CHECK(var);
+        if (var->Name() == "feed" || var->Name() == "fetch") continue;
+        auto *var_ptr = FindVar(var->Name());
+        CHECK(var_ptr);
+        tensor_array_vars_.push_back(var_ptr);
       }
     }
   }
+  for (auto *var : tensor_array_vars_) {
+    if (var->IsType<std::vector<Tensor>>()) {
+      var->GetMutable<std::vector<Tensor>>()->clear();
+    }
+  }
 }
 
 }  // namespace lite
@@ -19,6 +19,8 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include "lite/api/async_runner.h"
+#include "lite/api/batching_runner.h"
 #include "lite/api/paddle_api.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/optimizer/optimizer.h"
@@ -76,6 +78,7 @@ class LITE_API Predictor {
     program_.reset(
         new RuntimeProgram(program_desc_, exec_scope_, kRootBlockIdx));
     program_generated_ = true;
+    PrepareFeedFetch();
   }
 
   // Build from a model, with places set for hardware config.
@@ -182,6 +185,25 @@ class LITE_API Predictor {
     ClearTensorArray(program_desc_);
   }
 
+#ifdef LITE_USE_THREAD_POOL
+  void SetThreadPool(const std::shared_ptr<ThreadPool>& thread_pool) {
+    program_->SetThreadPool(thread_pool);
+  }
+#endif
+
+  void SetMemoryArena(bool enabled) { program_->SetMemoryArena(enabled); }
+
+  void SetShapeCache(size_t capacity) { program_->SetShapeCache(capacity); }
+  void SetShapeFastPath(bool enabled) { program_->SetShapeFastPath(enabled); }
+  void SetInterOpParallelism(int branches, int threads) {
+    program_->SetInterOpParallelism(branches, threads);
+  }
+  void SetKernelTuning(const std::string& db_path) {
+    program_->SetKernelTuning(db_path);
+  }
+  ShapeCache* shape_cache() { return program_->shape_cache(); }
+  ShapeFastPath* shape_fast_path() { return program_->shape_fast_path(); }
+
 #ifdef LITE_WITH_METAL
   void ConfigMetalContext(const lite_api::CxxConfig& config) {
     program_->ConfigMetalContext(config.metal_lib_path(),
@@ -227,10 +249,13 @@ class LITE_API Predictor {
   Scope* scope() { return scope_.get(); }
 
   // This method is disabled in mobile, for unnecessary dependencies required.
+  // `param_encoding` is used by the naive buffer models only.
   void SaveModel(
       const std::string& dir,
       lite_api::LiteModelType model_type = lite_api::LiteModelType::kProtobuf,
-      bool record_info = false);
+      bool record_info = false,
+      lite_api::ParamEncodingType param_encoding =
+          lite_api::ParamEncodingType::kRaw);
   void SaveOpKernelInfo(const std::string& model_dir);
 
   /////////////////////////////////////////////////////////////////////////////
@@ -254,6 +279,10 @@ class LITE_API Predictor {
   // would be called in Run().
   void CheckInputValid();
 
+  // The variable of `name` by its slot in the runtime program, the variables
+  // no instruction touches are looked up in the exec scope.
+  Variable* FindVar(const std::string& name) const;
+
   void ClearTensorArray(
       const std::shared_ptr<const cpp::ProgramDesc>& program_desc);
 
@@ -265,6 +294,11 @@ class LITE_API Predictor {
   bool program_generated_{false};
   std::vector<std::string> input_names_;
   std::vector<std::string> output_names_;
+  // the variables of input_names_ and output_names_
+  std::vector<Variable*> input_vars_;
+  std::vector<Variable*> output_vars_;
+  // the variables of the blocks cleared by ClearTensorArray
+  std::vector<Variable*> tensor_array_vars_;
   std::vector<Place> valid_places_;
   std::vector<PrecisionType> input_precisions_;
 };
@@ -293,6 +327,13 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
 
   void Run() override;
 
+  void RunAsync(const std::function<void(lite_api::PaddlePredictor*)>&
+                    callback) override;
+  void WaitAsync() override;
+
+  void RunBatched(const std::vector<lite_api::BatchTensor>& inputs,
+                  std::vector<lite_api::BatchTensor>* outputs) override;
+
   /// \brief Release all tmp tensor to compress the size of the memory pool.
   /// The memory pool is considered to be composed of a list of chunks, if
   /// the chunk is not occupied, it can be released.
@@ -300,6 +341,8 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
   /// \return a boolean variable.
   bool TryShrinkMemory() override;
 
+  lite_api::ShapeCacheStats GetShapeCacheStats() const override;
+
   std::shared_ptr<lite_api::PaddlePredictor> Clone() override;
 
   std::shared_ptr<lite_api::PaddlePredictor> Clone(
@@ -330,6 +373,11 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
   lite_api::CxxConfig config_;
   std::mutex mutex_;
   bool status_is_cloned_;
+  // created by the first RunAsync, destroyed before raw_predictor_
+  std::unique_ptr<AsyncRunner> async_runner_;
+  // created by the first RunBatched, destroyed before raw_predictor_
+  std::unique_ptr<BatchingRunner> batching_runner_;
+  std::once_flag batching_runner_flag_;
 };
 
 /*
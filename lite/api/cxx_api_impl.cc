@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/api/cxx_api.h"
+#include <algorithm>
 #include <memory>
 #include <mutex>  //NOLINT
 #include <string>
@@ -44,12 +45,6 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
   config_ = config;
   mode_ = config.power_mode();
   threads_ = config.threads();
-#ifdef LITE_USE_THREAD_POOL
-  int thread_num = ThreadPool::Init(threads_);
-  if (thread_num > 1) {
-    ThreadPool::AcquireThreadPool();
-  }
-#endif
   if (!status_is_cloned_) {
     auto places = config.valid_places();
     std::vector<std::string> passes = config.get_passes_internal();
@@ -146,6 +141,27 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
     CHECK(raw_predictor_) << "The Predictor can not be nullptr in Clone mode.";
   }
 
+#ifdef LITE_USE_THREAD_POOL
+  // pin the pool workers to cores unless LITE_POWER_NO_BIND is requested
+  raw_predictor_->SetThreadPool(
+      ThreadPool::Create(config.thread_pool_name(),
+                         threads_,
+                         config.thread_pool_core_ids(),
+                         mode_ != lite_api::LITE_POWER_NO_BIND));
+#endif
+  raw_predictor_->SetMemoryArena(config.memory_arena());
+  raw_predictor_->SetShapeCache(
+      static_cast<size_t>((std::max)(config.shape_cache_capacity(), 0)));
+  raw_predictor_->SetShapeFastPath(config.shape_fast_path());
+  int intra_op_threads = threads_;
+#if defined(LITE_WITH_X86) && defined(PADDLE_WITH_MKLML)
+  // the x86 kernels parallelize with the threads of the math library
+  intra_op_threads = (std::max)(threads_, config.x86_math_num_threads());
+#endif
+  raw_predictor_->SetInterOpParallelism(config.inter_op_parallelism(),
+                                        intra_op_threads);
+  raw_predictor_->SetKernelTuning(config.kernel_tuning_file());
+
 #ifdef LITE_WITH_METAL
   raw_predictor_->ConfigMetalContext(config);
 #endif
@@ -231,11 +247,7 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
 #endif
 }
 
-CxxPaddleApiImpl::~CxxPaddleApiImpl() {
-#ifdef LITE_USE_THREAD_POOL
-  ThreadPool::ReleaseThreadPool();
-#endif
-}
+CxxPaddleApiImpl::~CxxPaddleApiImpl() {}
 
 std::unique_ptr<lite_api::Tensor> CxxPaddleApiImpl::GetInputByName(
     const std::string &name) {
@@ -279,6 +291,56 @@ void CxxPaddleApiImpl::Run() {
   raw_predictor_->Run();
 }
 
+void CxxPaddleApiImpl::RunAsync(
+    const std::function<void(lite_api::PaddlePredictor *)> &callback) {
+  AsyncRunner *async_runner = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!async_runner_) {
+      int worker_num = std::max(config_.async_run_workers(), 1);
+      std::vector<AsyncRunner::Worker> workers(worker_num);
+      for (auto &worker : workers) {
+        worker.raw_predictor = raw_predictor_->Clone();
+        auto predictor =
+            std::make_shared<lite::CxxPaddleApiImpl>(worker.raw_predictor);
+        predictor->Init(config_);
+        worker.predictor = predictor;
+      }
+      async_runner_.reset(new AsyncRunner(std::move(workers)));
+    }
+    async_runner = async_runner_.get();
+  }
+  size_t input_num = raw_predictor_->GetInputNames().size();
+  std::vector<lite::Tensor> inputs(input_num);
+  for (size_t i = 0; i < input_num; ++i) {
+    inputs[i].CopyDataFrom(*raw_predictor_->GetInput(i));
+  }
+  async_runner->Submit(std::move(inputs), callback);
+}
+
+void CxxPaddleApiImpl::WaitAsync() {
+  // The runner is created by RunAsync under mutex_ and lives as long as the
+  // predictor, so it is waited for without holding the lock.
+  AsyncRunner *async_runner = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    async_runner = async_runner_.get();
+  }
+  if (async_runner) {
+    async_runner->Wait();
+  }
+}
+
+void CxxPaddleApiImpl::RunBatched(
+    const std::vector<lite_api::BatchTensor> &inputs,
+    std::vector<lite_api::BatchTensor> *outputs) {
+  std::call_once(batching_runner_flag_, [this]() {
+    batching_runner_.reset(new BatchingRunner(
+        this, config_.max_batch_size(), config_.max_queue_delay_us()));
+  });
+  batching_runner_->Run(inputs, outputs);
+}
+
 std::shared_ptr<lite_api::PaddlePredictor> CxxPaddleApiImpl::Clone() {
   std::lock_guard<std::mutex> lock(mutex_);
   auto predictor =
@@ -313,13 +375,28 @@ std::unique_ptr<lite_api::Tensor> CxxPaddleApiImpl::GetMutableTensor(
 void CxxPaddleApiImpl::SaveOptimizedModel(const std::string &model_dir,
                                           lite_api::LiteModelType model_type,
                                           bool record_info) {
-  raw_predictor_->SaveModel(model_dir, model_type, record_info);
+  raw_predictor_->SaveModel(
+      model_dir, model_type, record_info, config_.param_encoding());
 }
 
 bool CxxPaddleApiImpl::TryShrinkMemory() {
   return raw_predictor_->TryShrinkMemory();
 }
 
+lite_api::ShapeCacheStats CxxPaddleApiImpl::GetShapeCacheStats() const {
+  lite_api::ShapeCacheStats stats;
+  auto* shape_cache = raw_predictor_->shape_cache();
+  if (shape_cache) {
+    stats.hits = shape_cache->hits();
+    stats.misses = shape_cache->misses();
+  }
+  auto* shape_fast_path = raw_predictor_->shape_fast_path();
+  if (shape_fast_path) {
+    stats.fast_path_hits = shape_fast_path->hits();
+  }
+  return stats;
+}
+
 }  // namespace lite
 
 namespace lite_api {
@@ -14,6 +14,7 @@
 
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <vector>
 #include "lite/api/cxx_api.h"
 #include "lite/api/paddle_use_kernels.h"
@@ -27,6 +28,7 @@ DEFINE_int32(N, 1, "input_batch");
 DEFINE_int32(C, 3, "input_channel");
 DEFINE_int32(H, 224, "input_height");
 DEFINE_int32(W, 224, "input_width");
+DEFINE_int32(inter_op_branches, 4, "branches of the inter-op benchmark");
 
 namespace paddle {
 namespace lite {
@@ -180,5 +182,64 @@ TEST(GoogleNet, test_opencl) {
 
 #endif  // LITE_WITH_ARM
 
+#if defined(LITE_WITH_ARM) || defined(LITE_WITH_X86)
+// Runs the model with `branches` instructions at the same time, returns the
+// average latency in milliseconds and the output.
+double BenchmarkInterOp(int branches, std::vector<float>* output) {
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+#ifdef LITE_WITH_ARM
+  config.set_valid_places({lite_api::Place{TARGET(kARM), PRECISION(kFloat)}});
+#else
+  config.set_valid_places({lite_api::Place{TARGET(kX86), PRECISION(kFloat)}});
+  config.set_x86_math_num_threads(FLAGS_threads);
+#endif
+  config.set_threads(FLAGS_threads);
+  config.set_inter_op_parallelism(branches);
+  auto predictor = lite_api::CreatePaddlePredictor(config);
+
+  auto input_tensor = predictor->GetInput(0);
+  input_tensor->Resize(
+      std::vector<int64_t>({FLAGS_N, FLAGS_C, FLAGS_H, FLAGS_W}));
+  auto* data = input_tensor->mutable_data<float>();
+  for (int i = 0; i < FLAGS_N * FLAGS_C * FLAGS_H * FLAGS_W; i++) {
+    data[i] = 1;
+  }
+  // the first run executes the instructions in order
+  for (int i = 0; i < (std::max)(FLAGS_warmup, 1); ++i) {
+    predictor->Run();
+  }
+  auto start = GetCurrentUS();
+  for (int i = 0; i < FLAGS_repeats; ++i) {
+    predictor->Run();
+  }
+  double latency = (GetCurrentUS() - start) / 1000.0 / FLAGS_repeats;
+
+  auto output_tensor = predictor->GetOutput(0);
+  int64_t size = 1;
+  for (auto dim : output_tensor->shape()) size *= dim;
+  output->assign(output_tensor->data<float>(),
+                 output_tensor->data<float>() + size);
+  return latency;
+}
+
+TEST(GoogleNet, benchmark_inter_op_parallelism) {
+  std::vector<float> expect;
+  std::vector<float> output;
+  double in_order = BenchmarkInterOp(1, &expect);
+  double dataflow = BenchmarkInterOp(FLAGS_inter_op_branches, &output);
+  LOG(INFO) << "================== Speed Report ===================";
+  LOG(INFO) << "Model: " << FLAGS_model_dir << ", threads num "
+            << FLAGS_threads << ", repeats: " << FLAGS_repeats;
+  LOG(INFO) << "in order: " << in_order << " ms, "
+            << FLAGS_inter_op_branches << " branches: " << dataflow
+            << " ms, speedup: " << in_order / dataflow;
+  ASSERT_EQ(expect.size(), output.size());
+  for (size_t i = 0; i < expect.size(); ++i) {
+    EXPECT_NEAR(expect[i], output[i], 1e-5);
+  }
+}
+#endif
+
 }  // namespace lite
 }  // namespace paddle
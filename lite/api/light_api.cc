@@ -23,13 +23,20 @@ namespace paddle {
 namespace lite {
 
 void LightPredictor::Build(const std::string& lite_model_file,
-                           bool model_from_memory) {
+                           bool model_from_memory,
+                           bool model_mmap,
+                           bool lazy_params) {
   if (model_from_memory) {
     LoadModelNaiveFromMemory(
         lite_model_file, scope_.get(), program_desc_.get());
   } else {
-    LoadModelNaiveFromFile(lite_model_file, scope_.get(), program_desc_.get());
+    LoadModelNaiveFromFile(lite_model_file,
+                           scope_.get(),
+                           program_desc_.get(),
+                           model_mmap,
+                           lazy_params);
   }
+  if (lazy_params) LoadParamsOfSubgraphs();
 
   // For weight quantization of post training, load the int8/16 weights
   // for optimized model, and dequant it to fp32.
@@ -81,7 +88,7 @@ Tensor* LightPredictor::GetInput(size_t offset) {
   CHECK(input_names_.size() > offset)
       << "The network has " << input_names_.size() << " inputs"
       << ", the offset should be less than this.";
-  auto* in_var = program_->exec_scope()->FindVar(input_names_[offset]);
+  auto* in_var = input_vars_[offset];
   CHECK(in_var) << "no fatch variable " << input_names_[offset]
                 << " in exec_scope";
   return in_var->GetMutable<lite::Tensor>();
@@ -135,7 +142,7 @@ const Tensor* LightPredictor::GetOutput(size_t offset) {
   CHECK(output_names_.size() > offset)
       << "The network has " << output_names_.size() << " outputs"
       << ", the offset should be less than this.";
-  auto* out_var = program_->exec_scope()->FindVar(output_names_.at(offset));
+  auto* out_var = output_vars_[offset];
   CHECK(out_var) << "no fatch variable " << output_names_.at(offset)
                  << " in exec_scope";
   return out_var->GetMutable<lite::Tensor>();
@@ -188,6 +195,14 @@ void LightPredictor::PrepareFeedFetch() {
     output_names_[fetchs[i]->GetAttr<int>("col")] =
         fetchs[i]->Input("X").front();
   }
+  input_vars_.resize(input_names_.size());
+  output_vars_.resize(output_names_.size());
+  for (size_t i = 0; i < input_names_.size(); i++) {
+    input_vars_[i] = FindVar(input_names_[i]);
+  }
+  for (size_t i = 0; i < output_names_.size(); i++) {
+    output_vars_[i] = FindVar(output_names_[i]);
+  }
   for (size_t i = 0; i < feeds.size(); i++) {
     input_precisions_[i] = GetInput(i)->precision();
   }
@@ -258,12 +273,32 @@ void LightPredictor::DequantizeWeight() {
     }
     return result;
   };
-  Tensor tmp_tensor;
+  // The float fc, mul and lookup_table kernels of x86 compute with the int8
+  // or int16 weights directly, they are kept quantized.
+  auto keeps_quantized_weight = [](const cpp::OpDesc* op_desc) {
+#ifdef LITE_WITH_X86
+    const std::string& op_type = op_desc->Type();
+    if ((op_type == "fc" || op_type == "mul" || op_type == "lookup_table") &&
+        op_desc->HasAttr(kKernelTypeAttr)) {
+      std::string kernel_op_type, alias;
+      Place place;
+      KernelBase::ParseKernelType(
+          op_desc->GetAttr<std::string>(kKernelTypeAttr),
+          &kernel_op_type,
+          &alias,
+          &place);
+      return place.target == TARGET(kX86) &&
+             place.precision == PRECISION(kFloat);
+    }
+#endif
+    return false;
+  };
   for (size_t i = 0; i < program_desc->BlocksSize(); i++) {
     auto* block = program_desc->GetBlock<cpp::BlockDesc>(i);
     for (size_t k = 0; k < block->OpsSize(); ++k) {
       auto* op_desc = block->GetOp<cpp::OpDesc>(k);
-      if (is_weight_quantized_op(op_desc)) {
+      if (is_weight_quantized_op(op_desc) &&
+          !keeps_quantized_weight(op_desc)) {
         auto input_names = op_desc->input_vars();
         for (auto& input_name : input_names) {
           std::string input_scale_name = input_name + "_quant_scale";
@@ -281,41 +316,54 @@ void LightPredictor::DequantizeWeight() {
               input_scale_name = input_scale_name_alias;
               input_name = input_name.substr(0, found);
             }
-            auto input_tensor =
-                scope_->FindVar(input_name)->GetMutable<lite::Tensor>();
-            tmp_tensor.CopyDataFrom(*input_tensor);
             auto scale_list =
                 op_desc->GetAttr<std::vector<float>>(input_scale_name);
-
             int quantize_weight_bits =
                 op_desc->GetAttr<int>("quantize_weight_bits");
             CHECK(quantize_weight_bits == 8 || quantize_weight_bits == 16);
-            float* fp_data = input_tensor->mutable_data<float>();
-
             std::string op_type = op_desc->Type();
-            if (op_type == "conv2d" || op_type == "depthwise_conv2d") {
-              int64_t ch = input_tensor->dims()[0];
-              int64_t offset = input_tensor->numel() / ch;
-              CHECK_EQ(scale_list.size(), ch);
-              if (quantize_weight_bits == 8) {
-                const int8_t* int_data = tmp_tensor.data<int8_t>();
-                PROCESS_CONV2D_DATA()
-              } else {
-                const int16_t* int_data = tmp_tensor.data<int16_t>();
-                PROCESS_CONV2D_DATA()
-              }
-            } else if (op_type == "fc" || op_type == "mul" ||
-                       op_type == "lookup_table") {
-              int64_t chin = input_tensor->dims()[0];
-              int64_t chout = input_tensor->dims()[1];
-              CHECK_EQ(scale_list.size(), chout);
-              if (quantize_weight_bits == 8) {
-                const int8_t* int_data = tmp_tensor.data<int8_t>();
-                PROCESS_FC_DATA()
-              } else {
-                const int16_t* int_data = tmp_tensor.data<int16_t>();
-                PROCESS_FC_DATA()
+            auto dequantize = [=](Variable* var) {
+              auto input_tensor = var->GetMutable<lite::Tensor>();
+              Tensor tmp_tensor;
+              tmp_tensor.CopyDataFrom(*input_tensor);
+              float* fp_data = input_tensor->mutable_data<float>();
+
+              if (op_type == "conv2d" || op_type == "depthwise_conv2d") {
+                int64_t ch = input_tensor->dims()[0];
+                int64_t offset = input_tensor->numel() / ch;
+                CHECK_EQ(scale_list.size(), ch);
+                if (quantize_weight_bits == 8) {
+                  const int8_t* int_data = tmp_tensor.data<int8_t>();
+                  PROCESS_CONV2D_DATA()
+                } else {
+                  const int16_t* int_data = tmp_tensor.data<int16_t>();
+                  PROCESS_CONV2D_DATA()
+                }
+              } else if (op_type == "fc" || op_type == "mul" ||
+                         op_type == "lookup_table") {
+                int64_t chin = input_tensor->dims()[0];
+                int64_t chout = input_tensor->dims()[1];
+                CHECK_EQ(scale_list.size(), chout);
+                if (quantize_weight_bits == 8) {
+                  const int8_t* int_data = tmp_tensor.data<int8_t>();
+                  PROCESS_FC_DATA()
+                } else {
+                  const int16_t* int_data = tmp_tensor.data<int16_t>();
+                  PROCESS_FC_DATA()
+                }
               }
+            };
+            auto* var = scope_->FindVar(input_name);
+            auto loader = var->loader();
+            if (loader) {
+              // The deferred param is dequantized after it is loaded.
+              var->SetLoader([=](Variable* var) {
+                loader(var);
+                dequantize(var);
+              });
+              var->GetMutable<lite::Tensor>()->set_precision(PRECISION(kFloat));
+            } else {
+              dequantize(var);
             }
           }
         }
@@ -354,8 +402,9 @@ void LightPredictor::WeightFP32ToFP16() {
           std::string input_weight_name = input_name + "_fp16";
           if (op_desc->HasAttr(input_weight_name)) {  // the input is fp16
             Tensor tmp_tensor;
-            auto input_tensor =
-                scope_->FindVar(input_name)->GetMutable<lite::Tensor>();
+            auto* var = scope_->FindVar(input_name);
+            var->Load();
+            auto input_tensor = var->GetMutable<lite::Tensor>();
 
             if (input_tensor->precision() != PRECISION(kFloat)) continue;
 
@@ -375,6 +424,21 @@ void LightPredictor::WeightFP32ToFP16() {
 }
 #endif
 
+void LightPredictor::LoadParamsOfSubgraphs() {
+  // The params of a subgraph op are read by its device engine and not by the
+  // instructions, so a model with subgraph ops loads all of them.
+  for (size_t i = 0; i < program_desc_->BlocksSize(); i++) {
+    auto* block = program_desc_->GetBlock<cpp::BlockDesc>(i);
+    for (size_t k = 0; k < block->OpsSize(); ++k) {
+      if (block->GetOp<cpp::OpDesc>(k)->Type() != "subgraph") continue;
+      for (auto& name : scope_->LocalVarNames()) {
+        scope_->FindLocalVar(name)->Load();
+      }
+      return;
+    }
+  }
+}
+
 void LightPredictor::CheckInputValid() {
   for (size_t idx = 0; idx < input_precisions_.size(); ++idx) {
     if (GetInput(idx)->precision() != input_precisions_[idx]) {
@@ -393,6 +457,10 @@ bool LightPredictor::TryShrinkMemory() {
   // Clear ArmL3Cache
   lite::DeviceInfo::Global().ClearArmL3Cache();
 #endif
+  // Drop the memory arena, it is planned again by the next run
+  if (program_->memory_planner()) {
+    program_->memory_planner()->Reset();
+  }
   const std::vector<std::string>& local_var_names =
       program_->exec_scope()->LocalVarNames();
   for (auto& var_name : local_var_names) {
@@ -418,25 +486,37 @@ bool LightPredictor::TryShrinkMemory() {
   }
   return true;
 }
+
+Variable* LightPredictor::FindVar(const std::string& name) const {
+  int slot = program_->var_slot(name);
+  if (slot >= 0) return program_->var(slot);
+  return program_->exec_scope()->FindVar(name);
+}
+
 void LightPredictor::ClearTensorArray(
     const std::shared_ptr<const cpp::ProgramDesc>& program_desc) {
-  for (size_t blk_idx = 0; blk_idx < program_desc->BlocksSize(); blk_idx++) {
-    const cpp::BlockDesc* block =
-        program_desc->GetBlock<cpp::BlockDesc>(blk_idx);
-    for (size_t var_idx = 0; var_idx < block->VarsSize(); var_idx++) {
-      const cpp::VarDesc* var = block->GetVar<cpp::VarDesc>(var_idx);
-      CHECK(var);
-
-      auto* var_ptr = program_->exec_scope()->FindVar(var->Name());
-      if (var_ptr->IsType<std::vector<Tensor>>() &&
-          (var->Name() != "feed" && var->Name() != "fetch")) {
-        std::vector<Tensor>* tensor_array_var =
-            program_->exec_scope()->FindMutableTensorList(var->Name());
-        CHECK(tensor_array_var);
-        tensor_array_var->clear();
+  // The variables of the blocks are resolved by the first run, the later runs
+  // only check their types.
+  if (tensor_array_vars_.empty()) {
+    for (size_t blk_idx = 0; blk_idx < program_desc->BlocksSize(); blk_idx++) {
+      const cpp::BlockDesc* block =
+          program_desc->GetBlock<cpp::BlockDesc>(blk_idx);
+      for (size_t var_idx = 0; var_idx < block->VarsSize(); var_idx++) {
+        const cpp::VarDesc* var = block->GetVar<cpp::VarDesc>(var_idx);
+        CHECK(var);
+        if (var->Name() == "feed" || var->Name() == "fetch") continue;
+        auto* var_ptr = FindVar(var->Name());
+        CHECK(var_ptr);
+        tensor_array_vars_.push_back(var_ptr);
       }
     }
   }
+  for (auto* var : tensor_array_vars_) {
+    if (var->IsType<std::vector<Tensor>>()) {
+      var->GetMutable<std::vector<Tensor>>()->clear();
+    }
+  }
 }
+
 }  // namespace lite
 }  // namespace paddle
@@ -21,9 +21,11 @@
 #include <algorithm>
 #include <map>
 #include <memory>
+#include <mutex>  //NOLINT
 #include <string>
 #include <utility>
 #include <vector>
+#include "lite/api/batching_runner.h"
 #include "lite/api/paddle_api.h"
 #include "lite/core/context.h"
 #include "lite/core/program.h"
@@ -42,12 +44,15 @@ class LITE_API LightPredictor {
  public:
   // constructor function of LightPredictor, `lite_model_file` refers to data in
   // model file or buffer,`model_from_memory` refers to whther to load model
-  // from memory.
+  // from memory, `model_mmap` refers to whether to map the model file,
+  // `lazy_params` refers to whether to load the params on their first use.
   LightPredictor(const std::string& lite_model_file,
-                 bool model_from_memory = false) {
+                 bool model_from_memory = false,
+                 bool model_mmap = false,
+                 bool lazy_params = false) {
     scope_ = std::make_shared<Scope>();
     program_desc_ = std::make_shared<cpp::ProgramDesc>();
-    Build(lite_model_file, model_from_memory);
+    Build(lite_model_file, model_from_memory, model_mmap, lazy_params);
   }
 
   // NOTE: This is a deprecated API and will be removed in latter release.
@@ -68,6 +73,22 @@ class LITE_API LightPredictor {
     if (bool_clear_tensor_) ClearTensorArray(program_desc_);
   }
 
+#ifdef LITE_USE_THREAD_POOL
+  void SetThreadPool(const std::shared_ptr<ThreadPool>& thread_pool) {
+    program_->SetThreadPool(thread_pool);
+  }
+#endif
+
+  void SetMemoryArena(bool enabled) { program_->SetMemoryArena(enabled); }
+
+  void SetShapeCache(size_t capacity) { program_->SetShapeCache(capacity); }
+  void SetShapeFastPath(bool enabled) { program_->SetShapeFastPath(enabled); }
+  void SetKernelTuning(const std::string& db_path) {
+    program_->SetKernelTuning(db_path);
+  }
+  ShapeCache* shape_cache() { return program_->shape_cache(); }
+  ShapeFastPath* shape_fast_path() { return program_->shape_fast_path(); }
+
   /// \brief Release all tmp tensor to compress the size of the memory pool.
   /// The memory pool is considered to be composed of a list of chunks, if
   /// the chunk is not occupied, it can be released.
@@ -85,8 +106,9 @@ class LITE_API LightPredictor {
   const Tensor* GetOutput(size_t offset);
 
   const lite::Tensor* GetTensor(const std::string& name) const {
-    auto* var = program_->exec_scope()->FindVar(name);
+    auto* var = FindVar(name);
     CHECK(var) << "no fatch variable " << name << " in exec_scope";
+    var->Load();
     return &var->Get<lite::Tensor>();
   }
 
@@ -114,7 +136,9 @@ class LITE_API LightPredictor {
   void CheckInputValid();
 
   void Build(const std::string& lite_model_file,
-             bool model_from_memory = false);
+             bool model_from_memory = false,
+             bool model_mmap = false,
+             bool lazy_params = false);
 
   // NOTE: This is a deprecated API and will be removed in latter release.
   void Build(
@@ -129,10 +153,16 @@ class LITE_API LightPredictor {
 
   void DequantizeWeight();
 
+  void LoadParamsOfSubgraphs();
+
 #ifdef ENABLE_ARM_FP16
   void WeightFP32ToFP16();
 #endif
 
+  // The variable of `name` by its slot in the runtime program, the variables
+  // no instruction touches are looked up in the exec scope.
+  Variable* FindVar(const std::string& name) const;
+
   void ClearTensorArray(
       const std::shared_ptr<const cpp::ProgramDesc>& program_desc);
 
@@ -142,6 +172,11 @@ class LITE_API LightPredictor {
   std::shared_ptr<cpp::ProgramDesc> program_desc_;
   std::vector<std::string> input_names_;
   std::vector<std::string> output_names_;
+  // the variables of input_names_ and output_names_
+  std::vector<Variable*> input_vars_;
+  std::vector<Variable*> output_vars_;
+  // the variables of the blocks cleared by ClearTensorArray
+  std::vector<Variable*> tensor_array_vars_;
   std::vector<PrecisionType> input_precisions_;
   bool bool_clear_tensor_ = false;
 };
@@ -157,6 +192,9 @@ class LightPredictorImpl : public lite_api::PaddlePredictor {
       const std::string& name) const;
   void Run() override;
 
+  void RunBatched(const std::vector<lite_api::BatchTensor>& inputs,
+                  std::vector<lite_api::BatchTensor>* outputs) override;
+
   std::shared_ptr<lite_api::PaddlePredictor> Clone() override;
   std::shared_ptr<lite_api::PaddlePredictor> Clone(
       const std::vector<std::string>& var_names) override;
@@ -176,8 +214,15 @@ class LightPredictorImpl : public lite_api::PaddlePredictor {
   /// \return a boolean variable.
   bool TryShrinkMemory() override;
 
+  lite_api::ShapeCacheStats GetShapeCacheStats() const override;
+
  private:
   std::unique_ptr<lite::LightPredictor> raw_predictor_;
+  int max_batch_size_{1};
+  int max_queue_delay_us_{0};
+  // created by the first RunBatched, destroyed before raw_predictor_
+  std::unique_ptr<BatchingRunner> batching_runner_;
+  std::once_flag batching_runner_flag_;
 };
 
 }  // namespace lite
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/api/light_api.h"
+#include <algorithm>
 #include <string>
 #include "lite/api/paddle_api.h"
 #include "lite/core/version.h"
@@ -33,6 +34,19 @@ namespace paddle {
 namespace lite {
 
 void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
+  mode_ = config.power_mode();
+  threads_ = config.threads();
+  max_batch_size_ = config.max_batch_size();
+  max_queue_delay_us_ = config.max_queue_delay_us();
+#ifdef LITE_USE_THREAD_POOL
+  // pin the pool workers to cores unless LITE_POWER_NO_BIND is requested
+  auto thread_pool = ThreadPool::Create(config.thread_pool_name(),
+                                        threads_,
+                                        config.thread_pool_core_ids(),
+                                        mode_ != lite_api::LITE_POWER_NO_BIND);
+  // the encoded params of the model are decoded by the pool
+  ThreadPool::ScopedPool loading_pool(thread_pool.get());
+#endif
   // LightPredictor Only support NaiveBuffer backend in publish lib
   if (config.lite_model_file().empty()) {
     raw_predictor_.reset(
@@ -43,16 +57,18 @@ void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
                            lite_api::LiteModelType::kNaiveBuffer));
   } else {
     raw_predictor_.reset(new LightPredictor(config.lite_model_file(),
-                                            config.is_model_from_memory()));
+                                            config.is_model_from_memory(),
+                                            config.model_mmap(),
+                                            config.lazy_params()));
   }
-  mode_ = config.power_mode();
-  threads_ = config.threads();
 #ifdef LITE_USE_THREAD_POOL
-  int thread_num = ThreadPool::Init(threads_);
-  if (thread_num > 1) {
-    ThreadPool::AcquireThreadPool();
-  }
+  raw_predictor_->SetThreadPool(thread_pool);
 #endif
+  raw_predictor_->SetMemoryArena(config.memory_arena());
+  raw_predictor_->SetShapeCache(
+      static_cast<size_t>((std::max)(config.shape_cache_capacity(), 0)));
+  raw_predictor_->SetShapeFastPath(config.shape_fast_path());
+  raw_predictor_->SetKernelTuning(config.kernel_tuning_file());
 
 #ifdef LITE_WITH_METAL
   raw_predictor_->ConfigMetalContext(config);
@@ -102,11 +118,7 @@ void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
 #endif
 }
 
-LightPredictorImpl::~LightPredictorImpl() {
-#ifdef LITE_USE_THREAD_POOL
-  ThreadPool::ReleaseThreadPool();
-#endif
-}
+LightPredictorImpl::~LightPredictorImpl() {}
 
 std::unique_ptr<lite_api::Tensor> LightPredictorImpl::GetInputByName(
     const std::string& name) {
@@ -138,6 +150,16 @@ void LightPredictorImpl::Run() {
   raw_predictor_->Run();
 }
 
+void LightPredictorImpl::RunBatched(
+    const std::vector<lite_api::BatchTensor>& inputs,
+    std::vector<lite_api::BatchTensor>* outputs) {
+  std::call_once(batching_runner_flag_, [this]() {
+    batching_runner_.reset(
+        new BatchingRunner(this, max_batch_size_, max_queue_delay_us_));
+  });
+  batching_runner_->Run(inputs, outputs);
+}
+
 std::shared_ptr<lite_api::PaddlePredictor> LightPredictorImpl::Clone() {
   LOG(FATAL) << "The Clone API is not supported in LigthPredictor";
   return nullptr;
@@ -169,6 +191,20 @@ bool LightPredictorImpl::TryShrinkMemory() {
   return raw_predictor_->TryShrinkMemory();
 }
 
+lite_api::ShapeCacheStats LightPredictorImpl::GetShapeCacheStats() const {
+  lite_api::ShapeCacheStats stats;
+  auto* shape_cache = raw_predictor_->shape_cache();
+  if (shape_cache) {
+    stats.hits = shape_cache->hits();
+    stats.misses = shape_cache->misses();
+  }
+  auto* shape_fast_path = raw_predictor_->shape_fast_path();
+  if (shape_fast_path) {
+    stats.fast_path_hits = shape_fast_path->hits();
+  }
+  return stats;
+}
+
 }  // namespace lite
 
 namespace lite_api {
@@ -18,6 +18,7 @@
 
 #include "lite/core/context.h"
 #include "lite/core/device_info.h"
+#include "lite/core/profile/tracer.h"
 #include "lite/core/target_wrapper.h"
 #include "lite/core/tensor.h"
 
@@ -73,6 +74,12 @@ bool IsOpenCLBackendValid(bool check_fp16_valid) {
   return opencl_valid;
 }
 
+void StartTrace() { lite::profile::Tracer::Global().Start(); }
+
+bool StopTrace(const std::string &path) {
+  return lite::profile::Tracer::Global().Stop(path);
+}
+
 Tensor::Tensor(void *raw) : raw_tensor_(raw) {}
 
 // TODO(Superjomn) refine this by using another `const void* const_raw`;
@@ -289,6 +296,26 @@ void PaddlePredictor::SaveOptimizedModel(const std::string &model_dir,
       << "The SaveOptimizedModel API is only supported by CxxConfig predictor.";
 }
 
+void PaddlePredictor::RunAsync(
+    const std::function<void(PaddlePredictor *)> &callback) {
+  LOG(FATAL) << "The RunAsync API is only supported by CxxConfig predictor.";
+}
+
+void PaddlePredictor::WaitAsync() {
+  LOG(FATAL) << "The WaitAsync API is only supported by CxxConfig predictor.";
+}
+
+ShapeCacheStats PaddlePredictor::GetShapeCacheStats() const {
+  LOG(FATAL) << "The GetShapeCacheStats API is not supported by this "
+                "predictor.";
+  return ShapeCacheStats();
+}
+
+void PaddlePredictor::RunBatched(const std::vector<BatchTensor> &inputs,
+                                 std::vector<BatchTensor> *outputs) {
+  LOG(FATAL) << "The RunBatched API is not supported by this predictor.";
+}
+
 template <typename ConfigT>
 std::shared_ptr<PaddlePredictor> CreatePaddlePredictor(const ConfigT &) {
   return std::shared_ptr<PaddlePredictor>();
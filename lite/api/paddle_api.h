@@ -19,6 +19,7 @@
 
 #ifndef PADDLE_LITE_API_H_  // NOLINT
 #define PADDLE_LITE_API_H_
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -33,6 +34,15 @@ using shape_t = std::vector<int64_t>;
 using lod_t = std::vector<std::vector<uint64_t>>;
 
 enum class LiteModelType { kProtobuf = 0, kNaiveBuffer, UNK };
+// Encoding of the params of a naive buffer model saved by SaveOptimizedModel,
+// the encoded params are read by the Paddle-Lite supporting meta_version 3.
+enum class ParamEncodingType {
+  kRaw = 0,  // The data of the tensors as they are.
+  kLZ4,      // Compressed by LZ4.
+  kLZ4FP16,  // The FP32 weights stored as FP16, then compressed.
+  kLZ4Int8,  // The FP32 weights stored as INT8 with a scale per slice of
+             // their first dim, then compressed.
+};
 // Methods for allocating L3Cache on Arm platform
 enum class L3CacheSetMethod {
   kDeviceL3Cache = 0,  // Use the system L3 Cache size, best performance.
@@ -45,6 +55,12 @@ enum class L3CacheSetMethod {
 // return true if current device supports OpenCL model
 LITE_API bool IsOpenCLBackendValid(bool check_fp16_valid = false);
 
+// Records a timeline of the runs of all the predictors of the process, their
+// ops, the thread pool workers and the memory allocations until StopTrace,
+// which writes it into `path` in the Chrome trace event format.
+LITE_API void StartTrace();
+LITE_API bool StopTrace(const std::string& path);
+
 struct LITE_API Tensor {
   explicit Tensor(void* raw);
   explicit Tensor(const void* raw);
@@ -87,6 +103,26 @@ struct LITE_API Tensor {
   void* raw_tensor_;
 };
 
+/// A host tensor owned by the caller, it carries one request through
+/// PaddlePredictor::RunBatched.
+struct LITE_API BatchTensor {
+  shape_t shape;
+  lod_t lod;
+  PrecisionType precision{PrecisionType::kFloat};
+  std::vector<char> data;
+};
+
+/// The counters of the shape cache, see ConfigBase::set_shape_cache. A run
+/// hits if the shapes of all its instructions are found in the cache.
+/// fast_path_hits counts the runs with the input shapes of the previous run
+/// (see ConfigBase::set_shape_fast_path), they skip the shape inference
+/// without looking up the cache.
+struct LITE_API ShapeCacheStats {
+  int64_t hits{0};
+  int64_t misses{0};
+  int64_t fast_path_hits{0};
+};
+
 /// The PaddlePredictor defines the basic interfaces for different kinds of
 /// predictors.
 class LITE_API PaddlePredictor {
@@ -100,6 +136,22 @@ class LITE_API PaddlePredictor {
   virtual std::unique_ptr<const Tensor> GetOutput(int i) const = 0;
 
   virtual void Run() = 0;
+  /// Run asynchronously. The current inputs are copied into a request which
+  /// is executed by an idle clone of this predictor, so the inputs can be
+  /// refilled for the next request as soon as RunAsync returns. `callback` is
+  /// called on the executing thread with the clone holding the outputs, they
+  /// are only valid during the callback. This API is only supported by
+  /// CxxConfig.
+  virtual void RunAsync(const std::function<void(PaddlePredictor*)>& callback);
+  /// Block until all the requests of RunAsync are finished.
+  virtual void WaitAsync();
+  /// Run one request through the dynamic batching front end, it can be
+  /// called from many threads concurrently and blocks until `outputs` are
+  /// filled. Concurrent requests are concatenated along dim 0, executed by a
+  /// single Run() and the outputs, including LoD, are split back to the
+  /// callers, see ConfigBase::set_dynamic_batching.
+  virtual void RunBatched(const std::vector<BatchTensor>& inputs,
+                          std::vector<BatchTensor>* outputs);
   virtual std::shared_ptr<PaddlePredictor> Clone() = 0;
   virtual std::shared_ptr<PaddlePredictor> Clone(
       const std::vector<std::string>& var_names) = 0;
@@ -116,6 +168,9 @@ class LITE_API PaddlePredictor {
   /// Release all tmp tensor to compress the size of the memory pool.
   virtual bool TryShrinkMemory() = 0;
 
+  /// Get the counters of the shape cache.
+  virtual ShapeCacheStats GetShapeCacheStats() const;
+
   // Get Input by name
   virtual std::unique_ptr<Tensor> GetInputByName(const std::string& name) = 0;
 
@@ -166,6 +221,21 @@ class LITE_API ConfigBase {
   std::map<std::string, std::vector<char>> nnadapter_model_cache_buffers_{};
   int device_id_{0};
   int x86_math_num_threads_ = 1;
+  // The thread pool shared by the predictors with the same name, and the
+  // cores its workers are pinned to.
+  std::string thread_pool_name_{""};
+  std::vector<int> thread_pool_core_ids_{};
+  // Dynamic batching of the requests of RunBatched.
+  int max_batch_size_{1};
+  int max_queue_delay_us_{0};
+  // Place the intermediate tensors into one planned arena.
+  bool memory_arena_{false};
+  // The number of input shapes whose inferred shapes are cached.
+  int shape_cache_capacity_{0};
+  // Skip the shape inference of the runs with the input shapes of the last run.
+  bool shape_fast_path_{false};
+  // The tuning DB of the kernels picked by timing them, empty if disabled.
+  std::string kernel_tuning_file_{""};
 
   std::string metal_path_;
   bool metal_use_mps_{false};
@@ -186,6 +256,57 @@ class LITE_API ConfigBase {
   // set Power_mode
   void set_power_mode(PowerMode mode);
   PowerMode power_mode() const { return mode_; }
+  // set thread pool, only used when Paddle-Lite is built with
+  // LITE_THREAD_POOL. Predictors configured with the same name and the same
+  // `threads()` share one pool of `threads()` workers, the empty name
+  // (default) gives each predictor its own pool. The workers are pinned to
+  // `core_ids` if given.
+  void set_thread_pool(const std::string& name,
+                       const std::vector<int>& core_ids = {}) {
+    thread_pool_name_ = name;
+    thread_pool_core_ids_ = core_ids;
+  }
+  const std::string& thread_pool_name() const { return thread_pool_name_; }
+  const std::vector<int>& thread_pool_core_ids() const {
+    return thread_pool_core_ids_;
+  }
+  // set dynamic batching for RunBatched. The requests arriving within
+  // `max_queue_delay_us` microseconds after the oldest pending one are
+  // coalesced until `max_batch_size` rows along dim 0 are collected, a
+  // `max_batch_size` of 1 (default) runs every request alone.
+  void set_dynamic_batching(int max_batch_size, int max_queue_delay_us) {
+    max_batch_size_ = max_batch_size;
+    max_queue_delay_us_ = max_queue_delay_us;
+  }
+  int max_batch_size() const { return max_batch_size_; }
+  int max_queue_delay_us() const { return max_queue_delay_us_; }
+  // set memory arena. The intermediate host tensors are placed into one
+  // arena, their offsets are planned by their sizes measured in the first
+  // run and their lifetimes, and planned again when the input shapes change.
+  void set_memory_arena(bool enabled) { memory_arena_ = enabled; }
+  bool memory_arena() const { return memory_arena_; }
+  // set shape cache. The shapes inferred by every op are cached for the
+  // `capacity` recently seen shapes of the inputs, a run with cached input
+  // shapes skips inferring the shapes of the ops whose output shapes only
+  // depend on their input shapes. 0 (default) disables the cache.
+  void set_shape_cache(int capacity) { shape_cache_capacity_ = capacity; }
+  int shape_cache_capacity() const { return shape_cache_capacity_; }
+  // set shape fast path. A run whose inputs have the shapes of the last run
+  // resizes the outputs of the ops whose output shapes only depend on their
+  // input shapes to the ones recorded by the last run instead of inferring
+  // them. false (default) disables it.
+  void set_shape_fast_path(bool enabled) { shape_fast_path_ = enabled; }
+  bool shape_fast_path() const { return shape_fast_path_; }
+  // set kernel tuning. The first run times every kernel and implementation
+  // eligible for each op on the real shapes and keeps the fastest, the
+  // choices are saved into `file` keyed by the CPU model and the signature
+  // of the op, and the later predictors look them up instead of timing them
+  // again. The empty path (default) keeps the kernels picked by the
+  // optimizer.
+  void set_kernel_tuning(const std::string& file) {
+    kernel_tuning_file_ = file;
+  }
+  const std::string& kernel_tuning_file() const { return kernel_tuning_file_; }
   /// \brief Set path and file name of generated OpenCL compiled kernel binary.
   ///
   /// If you use GPU of specific soc, using OpenCL binary will speed up the
@@ -309,6 +430,10 @@ class LITE_API CxxConfig : public ConfigBase {
   QuantType quant_type_{QuantType::QUANT_INT16};
   bool sparse_model_{false};  // Enable sparse_conv_detect_pass in opt
   float sparse_threshold_{0.6f};
+  // Encoding of the params in SaveOptimizedModel
+  ParamEncodingType param_encoding_{ParamEncodingType::kRaw};
+  int async_run_workers_{2};  // Number of clones serving RunAsync
+  int inter_op_parallelism_{1};  // Instructions run at the same time on CPU
   std::map<int, std::vector<std::shared_ptr<void>>>
       preferred_inputs_for_warmup_;
 #ifdef LITE_WITH_CUDA
@@ -370,6 +495,15 @@ class LITE_API CxxConfig : public ConfigBase {
   void set_multi_stream(bool multi_stream) { multi_stream_ = multi_stream; }
   bool multi_stream() const { return multi_stream_; }
 #endif
+  // set inter-op parallelism on CPU. Up to `branches` instructions whose
+  // inputs are ready run at the same time, each with `threads()` / `branches`
+  // threads for its kernel, which helps the models of wide independent
+  // branches. The memory arena is not used then. 1 (default) runs the
+  // instructions in order.
+  void set_inter_op_parallelism(int branches) {
+    inter_op_parallelism_ = branches;
+  }
+  int inter_op_parallelism() const { return inter_op_parallelism_; }
 
 #ifdef LITE_WITH_MLU
   // set MLU core version, which is used when compiling MLU kernels
@@ -442,6 +576,16 @@ class LITE_API CxxConfig : public ConfigBase {
   }
   float sparse_threshold() const { return sparse_threshold_; }
 
+  void set_param_encoding(ParamEncodingType param_encoding) {
+    param_encoding_ = param_encoding;
+  }
+  ParamEncodingType param_encoding() const { return param_encoding_; }
+
+  // Number of predictor clones executing the requests of RunAsync, each clone
+  // runs with `threads()` threads.
+  void set_async_run_workers(int workers) { async_run_workers_ = workers; }
+  int async_run_workers() const { return async_run_workers_; }
+
   // Enable the custom subgraph partition for NNAdapter by providing the
   // configuration file or buffer
   void set_nnadapter_subgraph_partition_config_path(
@@ -495,6 +639,11 @@ class LITE_API MobileConfig : public ConfigBase {
   std::string model_buffer_;
   std::string param_buffer_;
 
+  // whether to map the model file into memory instead of reading it.
+  bool model_mmap_{false};
+  // whether to load the params on their first use.
+  bool lazy_params_{false};
+
  public:
   // set model data in combined format, `set_model_from_file` refers to loading
   // model from file, set_model_from_buffer refers to loading model from memory
@@ -512,6 +661,19 @@ class LITE_API MobileConfig : public ConfigBase {
   // abandoned in v3.0.
   bool model_from_memory() const { return model_from_memory_; }
 
+  // map the model file set by `set_model_from_file` read-only into memory,
+  // the params use their data in the file without copying it, which is
+  // shared by the processes loading the same model through the page cache.
+  // A param is only copied when it is modified, e.g. repacked by a kernel.
+  void set_model_mmap(bool x) { model_mmap_ = x; }
+  bool model_mmap() const { return model_mmap_; }
+
+  // load every param of the model file set by `set_model_from_file` on the
+  // first run of an op using it, the params of branches which are never taken
+  // are never read. The model file is mapped like `set_model_mmap`.
+  void set_lazy_params(bool x) { lazy_params_ = x; }
+  bool lazy_params() const { return lazy_params_; }
+
   // NOTE: This is a deprecated API and will be removed in latter release.
   void set_model_buffer(const char* model_buffer,
                         size_t model_buffer_size,
@@ -118,7 +118,8 @@ const std::string& DataLayoutToStr(DataLayoutType layout) {
                                                   "ImageFolder",
                                                   "ImageNW",
                                                   "MetalTexture2DArray",
-                                                  "MetalTexture2D"};
+                                                  "MetalTexture2D",
+                                                  "NCHWc8"};
   auto x = static_cast<int>(layout);
   CHECK_LT(x, static_cast<int>(DATALAYOUT(NUM)));
   return datalayout2string[x];
@@ -173,7 +174,8 @@ const std::string& DataLayoutRepr(DataLayoutType layout) {
                                                   "kImageFolder",
                                                   "kImageNW",
                                                   "kMetalTexture2DArray",
-                                                  "kMetalTexture2D"};
+                                                  "kMetalTexture2D",
+                                                  "kNCHWc8"};
   auto x = static_cast<int>(layout);
   CHECK_LT(x, static_cast<int>(DATALAYOUT(NUM)));
   return datalayout2string[x];
@@ -235,7 +237,8 @@ std::set<DataLayoutType> ExpandValidLayouts(DataLayoutType layout) {
        DATALAYOUT(kImageFolder),
        DATALAYOUT(kImageNW),
        DATALAYOUT(kMetalTexture2DArray),
-       DATALAYOUT(kMetalTexture2D)});
+       DATALAYOUT(kMetalTexture2D),
+       DATALAYOUT(kNCHWc8)});
   if (layout == DATALAYOUT(kAny)) {
     return valid_set;
   }
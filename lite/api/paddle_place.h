@@ -88,7 +88,8 @@ enum class DataLayoutType : int {
   kAny = 2,           // any data layout
   kMetalTexture2DArray = 7,
   kMetalTexture2D = 8,
-  NUM = 9,  // number of fields.
+  kNCHWc8 = 9,  // for x86, [N, C/8, H, W, 8] blocked over 8 channels
+  NUM = 10,     // number of fields.
 };
 
 typedef enum {
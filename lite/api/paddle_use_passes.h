@@ -36,6 +36,7 @@ USE_MIR_PASS(remove_scale1_pass);
 USE_MIR_PASS(remove_tf_redundant_ops_pass);
 USE_MIR_PASS(lite_conv_bn_fuse_pass);
 USE_MIR_PASS(lite_conv_conv_fuse_pass);
+USE_MIR_PASS(lite_multihead_attention_fuse_pass);
 USE_MIR_PASS(lite_squeeze2_matmul_fuse_pass);
 USE_MIR_PASS(lite_reshape2_matmul_fuse_pass);
 USE_MIR_PASS(lite_matmul_fuse_pass);
@@ -113,6 +114,7 @@ USE_MIR_PASS(__xpu__dynamic_lstm_fuse_pass);
 USE_MIR_PASS(__xpu__multi_softmax_fuse_pass);
 USE_MIR_PASS(__xpu__max_pooling_pad_zero_detect_fuse_pass);
 USE_MIR_PASS(x86_int8_attribute_pass);
+USE_MIR_PASS(x86_quantized_region_pass);
 USE_MIR_PASS(fill_range_fuse_pass);
 USE_MIR_PASS(range_calc_offline_pass);
 USE_MIR_PASS(p_norm_fill_constant_max_div_fuse_pass);
@@ -287,7 +287,8 @@ void BindLitePlace(py::module *m) {
       .value("ImageFolder", DataLayoutType::kImageFolder)
       .value("ImageNW", DataLayoutType::kImageNW)
       .value("MetalTexture2DArray", DataLayoutType::kMetalTexture2DArray)
-      .value("MetalTexture2D", DataLayoutType::kMetalTexture2D);
+      .value("MetalTexture2D", DataLayoutType::kMetalTexture2D)
+      .value("NCHWc8", DataLayoutType::kNCHWc8);
 
   // Place
   py::class_<Place>(*m, "Place")
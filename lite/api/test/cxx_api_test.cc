@@ -15,6 +15,8 @@
 #include "lite/api/cxx_api.h"
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <cstring>
+#include <thread>  // NOLINT
 #include <vector>
 #include "lite/api/paddle_use_kernels.h"
 #include "lite/api/paddle_use_ops.h"
@@ -51,6 +53,26 @@ TEST(CXXApi, input_precision) {
   ASSERT_EQ(precisions[0], PrecisionType::kFloat);
 }
 
+TEST(CXXApi, var_slots) {
+  lite::Predictor predictor;
+  std::vector<Place> valid_places({Place{TARGET(kX86), PRECISION(kFloat)}});
+  predictor.Build(FLAGS_model_dir, "", "", valid_places);
+  // the inputs and outputs are reached through the slots of the program
+  const auto& program = predictor.runtime_program();
+  int in_slot = program.var_slot(predictor.GetInputNames()[0]);
+  int out_slot = program.var_slot(predictor.GetOutputNames()[0]);
+  ASSERT_GE(in_slot, 0);
+  ASSERT_GE(out_slot, 0);
+  EXPECT_EQ(program.var(in_slot)->GetMutable<lite::Tensor>(),
+            predictor.GetInput(0));
+  EXPECT_EQ(program.var(out_slot)->GetMutable<lite::Tensor>(),
+            predictor.GetOutput(0));
+  EXPECT_EQ(program.var_slot("not_a_variable"), -1);
+
+  auto cloned_predictor = predictor.Clone();
+  EXPECT_NE(cloned_predictor->GetInput(0), predictor.GetInput(0));
+}
+
 TEST(CXXApi, save_model) {
   lite::Predictor predictor;
   std::vector<Place> valid_places({Place{TARGET(kX86), PRECISION(kFloat)}});
@@ -101,6 +123,198 @@ TEST(CXXApi, clone_predictor) {
   }
 }
 
+TEST(CXXApi, run_async) {
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+  config.set_valid_places({lite_api::Place{TARGET(kX86), PRECISION(kFloat)}});
+  config.set_async_run_workers(2);
+  auto predictor = lite_api::CreatePaddlePredictor(config);
+
+  // reference output of the synchronous run
+  auto input_tensor = predictor->GetInput(0);
+  input_tensor->Resize(std::vector<int64_t>({1, 100}));
+  auto* data = input_tensor->mutable_data<float>();
+  for (int i = 0; i < 100; i++) {
+    data[i] = 1;
+  }
+  predictor->Run();
+  auto output_tensor = predictor->GetOutput(0);
+  std::vector<float> expect(output_tensor->data<float>(),
+                            output_tensor->data<float>() + 500);
+
+  // requests with different inputs, the input is refilled right after
+  // RunAsync returns
+  const int request_num = 8;
+  std::vector<std::vector<float>> results(request_num);
+  for (int r = 0; r < request_num; r++) {
+    for (int i = 0; i < 100; i++) {
+      data[i] = r % 2 == 0 ? 1 : 0;
+    }
+    predictor->RunAsync([&results, r](lite_api::PaddlePredictor* done) {
+      auto out = done->GetOutput(0);
+      results[r].assign(out->data<float>(), out->data<float>() + 500);
+    });
+  }
+  predictor->WaitAsync();
+  for (int r = 0; r < request_num; r += 2) {
+    ASSERT_EQ(results[r].size(), expect.size());
+    for (size_t i = 0; i < expect.size(); i += 50) {
+      EXPECT_NEAR(results[r][i], expect[i], 1e-6);
+    }
+  }
+}
+
+TEST(CXXApi, memory_arena) {
+  // the outputs of every run, without and with the arena
+  std::vector<std::vector<std::vector<float>>> results(2);
+  for (int arena = 0; arena < 2; arena++) {
+    lite_api::CxxConfig config;
+    config.set_model_dir(FLAGS_model_dir);
+    config.set_valid_places(
+        {lite_api::Place{TARGET(kX86), PRECISION(kFloat)}});
+    config.set_memory_arena(arena == 1);
+    auto predictor = lite_api::CreatePaddlePredictor(config);
+    // the first run measures, the second runs in the planned arena, the
+    // third plans again for the new batch size and the last one runs in it
+    for (int batch : {1, 1, 2, 2}) {
+      auto input_tensor = predictor->GetInput(0);
+      input_tensor->Resize(std::vector<int64_t>({batch, 100}));
+      auto* data = input_tensor->mutable_data<float>();
+      for (int i = 0; i < batch * 100; i++) {
+        data[i] = i % 7;
+      }
+      predictor->Run();
+      auto output_tensor = predictor->GetOutput(0);
+      int64_t numel = 1;
+      for (auto dim : output_tensor->shape()) {
+        numel *= dim;
+      }
+      results[arena].emplace_back(output_tensor->data<float>(),
+                                  output_tensor->data<float>() + numel);
+    }
+  }
+  ASSERT_EQ(results[0].size(), results[1].size());
+  for (size_t run = 0; run < results[0].size(); run++) {
+    ASSERT_EQ(results[0][run].size(), results[1][run].size());
+    for (size_t i = 0; i < results[0][run].size(); i++) {
+      EXPECT_NEAR(results[0][run][i], results[1][run][i], 1e-6) << run;
+    }
+  }
+}
+
+TEST(CXXApi, shape_cache) {
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+  config.set_valid_places({lite_api::Place{TARGET(kX86), PRECISION(kFloat)}});
+  config.set_shape_cache(2);
+  auto predictor = lite_api::CreatePaddlePredictor(config);
+  // the batch sizes alternate, every shape misses once and hits afterwards
+  std::vector<std::vector<float>> results(3);
+  int run = 0;
+  for (int batch : {1, 2, 1, 2, 3}) {
+    auto input_tensor = predictor->GetInput(0);
+    input_tensor->Resize(std::vector<int64_t>({batch, 100}));
+    auto* data = input_tensor->mutable_data<float>();
+    for (int i = 0; i < batch * 100; i++) {
+      data[i] = i % 7;
+    }
+    predictor->Run();
+    auto output_tensor = predictor->GetOutput(0);
+    EXPECT_EQ(output_tensor->shape()[0], batch);
+    if (batch == 1) {
+      results[run++].assign(output_tensor->data<float>(),
+                            output_tensor->data<float>() + 500);
+    }
+  }
+  auto stats = predictor->GetShapeCacheStats();
+  EXPECT_EQ(stats.hits, 2);
+  EXPECT_EQ(stats.misses, 3);
+  for (size_t i = 0; i < results[0].size(); i++) {
+    EXPECT_NEAR(results[0][i], results[1][i], 1e-6);
+  }
+}
+
+TEST(CXXApi, shape_fast_path) {
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+  config.set_valid_places({lite_api::Place{TARGET(kX86), PRECISION(kFloat)}});
+  config.set_shape_fast_path(true);
+  auto predictor = lite_api::CreatePaddlePredictor(config);
+  // a run with the batch size of the previous run takes the fast path
+  std::vector<std::vector<float>> results;
+  for (int batch : {1, 1, 1, 2, 2, 1}) {
+    auto input_tensor = predictor->GetInput(0);
+    input_tensor->Resize(std::vector<int64_t>({batch, 100}));
+    auto* data = input_tensor->mutable_data<float>();
+    for (int i = 0; i < batch * 100; i++) {
+      data[i] = i % 7;
+    }
+    predictor->Run();
+    auto output_tensor = predictor->GetOutput(0);
+    EXPECT_EQ(output_tensor->shape()[0], batch);
+    if (batch == 1) {
+      results.emplace_back(output_tensor->data<float>(),
+                           output_tensor->data<float>() + 500);
+    }
+  }
+  EXPECT_EQ(predictor->GetShapeCacheStats().fast_path_hits, 3);
+  for (size_t r = 1; r < results.size(); r++) {
+    for (size_t i = 0; i < results[0].size(); i++) {
+      EXPECT_NEAR(results[0][i], results[r][i], 1e-6);
+    }
+  }
+}
+
+TEST(CXXApi, run_batched) {
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+  config.set_valid_places({lite_api::Place{TARGET(kX86), PRECISION(kFloat)}});
+  config.set_dynamic_batching(4, 2000);
+  auto predictor = lite_api::CreatePaddlePredictor(config);
+
+  // reference outputs of batch 1 runs for the two kinds of requests
+  std::vector<std::vector<float>> expects(2);
+  for (int k = 0; k < 2; k++) {
+    auto input_tensor = predictor->GetInput(0);
+    input_tensor->Resize(std::vector<int64_t>({1, 100}));
+    auto* data = input_tensor->mutable_data<float>();
+    for (int i = 0; i < 100; i++) {
+      data[i] = k;
+    }
+    predictor->Run();
+    auto output_tensor = predictor->GetOutput(0);
+    expects[k].assign(output_tensor->data<float>(),
+                      output_tensor->data<float>() + 500);
+  }
+
+  // concurrent requests are coalesced and the rows are scattered back
+  const int request_num = 8;
+  std::vector<std::vector<lite_api::BatchTensor>> outputs(request_num);
+  std::vector<std::thread> clients;
+  for (int r = 0; r < request_num; r++) {
+    clients.emplace_back([&predictor, &outputs, r]() {
+      std::vector<lite_api::BatchTensor> inputs(1);
+      inputs[0].shape = {1, 100};
+      std::vector<float> data(100, r % 2);
+      inputs[0].data.resize(data.size() * sizeof(float));
+      std::memcpy(inputs[0].data.data(), data.data(), inputs[0].data.size());
+      predictor->RunBatched(inputs, &outputs[r]);
+    });
+  }
+  for (auto& client : clients) {
+    client.join();
+  }
+  for (int r = 0; r < request_num; r++) {
+    ASSERT_EQ(outputs[r].size(), 1u);
+    ASSERT_EQ(outputs[r][0].shape, std::vector<int64_t>({1, 500}));
+    const float* result =
+        reinterpret_cast<const float*>(outputs[r][0].data.data());
+    for (size_t i = 0; i < 500; i += 50) {
+      EXPECT_NEAR(result[i], expects[r % 2][i], 1e-5);
+    }
+  }
+}
+
 /*TEST(CXXTrainer, train) {
   Place place({TARGET(kHost), PRECISION(kFloat), DATALAYOUT(kNCHW)});
   std::vector<Place> valid_places({place});
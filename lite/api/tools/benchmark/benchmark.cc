@@ -21,6 +21,7 @@
 #include <memory>
 #include <numeric>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 #ifdef __ANDROID__
@@ -65,6 +66,7 @@ std::shared_ptr<PaddlePredictor> CreatePredictor(
   config.set_model_from_file(model_file);
   config.set_threads(FLAGS_threads);
   config.set_power_mode(static_cast<PowerMode>(FLAGS_power_mode));
+  config.set_dynamic_batching(FLAGS_max_batch_size, FLAGS_max_queue_delay_us);
 
   // Set backend config info
   SetBackendConfig(config);
@@ -80,6 +82,49 @@ void RunImpl(std::shared_ptr<PaddlePredictor> predictor, PerfData* perf_data) {
   perf_data->set_run_time(timer.Stop());
 }
 
+// Each of FLAGS_batching_clients threads issues FLAGS_repeats requests
+// through RunBatched, with the inputs currently fed to the predictor.
+void RunBatchedImpl(std::shared_ptr<PaddlePredictor> predictor,
+                    PerfData* perf_data) {
+  std::vector<BatchTensor> inputs(predictor->GetInputNames().size());
+  for (size_t i = 0; i < inputs.size(); i++) {
+    auto input_tensor = predictor->GetInput(i);
+    auto precision = input_tensor->precision();
+    size_t element_size = PrecisionTypeLength(precision);
+    CHECK_GT(element_size, 0u) << "Unsupported precision of input " << i
+                               << ": " << PrecisionToStr(precision);
+    auto input_data = static_cast<const char*>(input_tensor->data<void>());
+    auto input_num = lite::ShapeProduction(input_tensor->shape());
+    inputs[i].shape = input_tensor->shape();
+    inputs[i].lod = input_tensor->lod();
+    inputs[i].precision = precision;
+    inputs[i].data.assign(input_data, input_data + input_num * element_size);
+  }
+
+  std::vector<std::vector<float>> latency(FLAGS_batching_clients);
+  std::vector<std::thread> clients;
+  lite::Timer timer;
+  timer.Start();
+  for (int c = 0; c < FLAGS_batching_clients; ++c) {
+    clients.emplace_back([&, c]() {
+      std::vector<BatchTensor> outputs;
+      lite::Timer request_timer;
+      for (int i = 0; i < FLAGS_repeats; ++i) {
+        request_timer.Start();
+        predictor->RunBatched(inputs, &outputs);
+        latency[c].push_back(request_timer.Stop());
+      }
+    });
+  }
+  for (auto& client : clients) {
+    client.join();
+  }
+  perf_data->set_batched_run_time(timer.Stop());
+  for (auto& client_latency : latency) {
+    perf_data->set_request_latency(client_latency);
+  }
+}
+
 #ifdef __ANDROID__
 void RunImpl(std::shared_ptr<PaddlePredictor> predictor,
              PerfData* perf_data,
@@ -200,6 +245,11 @@ void Run(const std::string& model_file,
     timer.SleepInMs(FLAGS_run_delay);
   }
 
+  // Run concurrent requests through dynamic batching
+  if (FLAGS_batching_clients > 0) {
+    RunBatchedImpl(predictor, &perf_data);
+  }
+
   // Get output
   size_t output_tensor_num = predictor->GetOutputNames().size();
   std::stringstream out_ss;
@@ -263,6 +313,11 @@ void Run(const std::string& model_file,
     ss << "run_delay(sec): " << FLAGS_run_delay << std::endl;
   }
   ss << "result_path: " << FLAGS_result_path << std::endl;
+  if (FLAGS_batching_clients > 0) {
+    ss << "batching_clients: " << FLAGS_batching_clients << std::endl;
+    ss << "max_batch_size: " << FLAGS_max_batch_size << std::endl;
+    ss << "max_queue_delay_us: " << FLAGS_max_queue_delay_us << std::endl;
+  }
   ss << "\n======= Backend Info =======\n";
   ss << "backend: " << FLAGS_backend << std::endl;
   ss << "cpu precision: " << FLAGS_cpu_precision << std::endl;
@@ -300,6 +355,14 @@ void Run(const std::string& model_file,
   ss << "min   = " << std::setw(12) << perf_data.min_run_time() << std::endl;
   ss << "max   = " << std::setw(12) << perf_data.max_run_time() << std::endl;
   ss << "avg   = " << std::setw(12) << perf_data.avg_run_time() << std::endl;
+  if (FLAGS_batching_clients > 0) {
+    ss << "\nDynamic Batching(unit: ms):\n";
+    ss << "qps   = " << std::setw(12) << perf_data.qps() << std::endl;
+    ss << "p50   = " << std::setw(12) << perf_data.request_latency(50.f)
+       << std::endl;
+    ss << "p99   = " << std::setw(12) << perf_data.request_latency(99.f)
+       << std::endl;
+  }
   if (FLAGS_enable_memory_profile) {
     ss << "\nMemory Usage(unit: kB):\n";
     ss << "init  = " << std::setw(12) << "Not supported yet" << std::endl;
@@ -76,6 +76,20 @@ class PerfData {
   const float max_run_time() const {
     return *std::max_element(run_time_.end() - repeats_, run_time_.end());
   }
+  // Requests per second served by RunBatched.
+  const float qps() const {
+    return request_latency_.size() * 1000.f / batched_run_time_;
+  }
+  // The latency below which `percentile` percent of the RunBatched requests
+  // finished.
+  const float request_latency(const float percentile) const {
+    std::vector<float> latency(request_latency_);
+    size_t k = std::min(latency.size() - 1,
+                        static_cast<size_t>(percentile / 100.f *
+                                            latency.size()));
+    std::nth_element(latency.begin(), latency.begin() + k, latency.end());
+    return latency[k];
+  }
 
   void set_init_time(const float ms) { init_time_ = ms; }
   void set_pre_process_time(const float ms) { pre_process_time_.push_back(ms); }
@@ -83,6 +97,10 @@ class PerfData {
     post_process_time_.push_back(ms);
   }
   void set_run_time(const float ms) { run_time_.push_back(ms); }
+  void set_batched_run_time(const float ms) { batched_run_time_ = ms; }
+  void set_request_latency(const std::vector<float>& ms) {
+    request_latency_.insert(request_latency_.end(), ms.begin(), ms.end());
+  }
 
  private:
   int repeats_{0};
@@ -90,6 +108,8 @@ class PerfData {
   std::vector<float> pre_process_time_;
   std::vector<float> post_process_time_;
   std::vector<float> run_time_;
+  float batched_run_time_{0.f};
+  std::vector<float> request_latency_;
 };
 
 int Benchmark(int argc, char** argv);
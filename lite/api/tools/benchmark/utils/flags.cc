@@ -35,6 +35,11 @@ DEFINE_int32(power_mode, 0, power_mode_msg);
 DEFINE_int32(threads, 1, threads_msg);
 DEFINE_string(result_path, "", result_path_msg);
 
+// Dynamic batching options
+DEFINE_int32(batching_clients, 0, batching_clients_msg);
+DEFINE_int32(max_batch_size, 1, max_batch_size_msg);
+DEFINE_int32(max_queue_delay_us, 1000, max_queue_delay_us_msg);
+
 // Backend options
 DEFINE_string(backend, "", backend_msg);
 DEFINE_string(cpu_precision, "fp32", cpu_precision_msg);
@@ -65,6 +65,17 @@ static const char power_mode_msg[] =
 static const char threads_msg[] = "threads num";
 static const char result_path_msg[] = "Save benchmark info to the file.";
 
+// Dynamic batching options
+static const char batching_clients_msg[] =
+    "The number of client threads issuing --repeats requests each through "
+    "RunBatched after the normal runs, and reporting QPS and p50/p99 "
+    "latency. Non-positive values disable the dynamic batching benchmark.";
+static const char max_batch_size_msg[] =
+    "The max rows along dim 0 coalesced into one run by dynamic batching.";
+static const char max_queue_delay_us_msg[] =
+    "The max time in microseconds a request waits to be coalesced by "
+    "dynamic batching.";
+
 // Backend options
 static const char backend_msg[] =
     "To use a particular backend for execution. "
@@ -130,6 +141,11 @@ DECLARE_int32(power_mode);
 DECLARE_int32(threads);
 DECLARE_string(result_path);
 
+// Dynamic batching options
+DECLARE_int32(batching_clients);
+DECLARE_int32(max_batch_size);
+DECLARE_int32(max_queue_delay_us);
+
 // Backend options
 DECLARE_string(backend);
 DECLARE_string(cpu_precision);
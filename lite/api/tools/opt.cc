@@ -38,7 +38,10 @@ DEFINE_string(param_file, "", "param file path of the combined-param model");
 DEFINE_string(
     optimize_out_type,
     "naive_buffer",
-    "store type of the output optimized model. protobuf/naive_buffer");
+    "store type of the output optimized model. protobuf/naive_buffer/"
+    "naive_buffer_lz4/naive_buffer_lz4_fp16/naive_buffer_lz4_int8, the "
+    "params of the last three are compressed, and the FP32 weights of the "
+    "last two are stored as FP16 or INT8");
 DEFINE_bool(display_kernels, false, "Display kernel information");
 DEFINE_bool(quant_model,
             false,
@@ -57,7 +60,7 @@ DEFINE_string(optimize_out, "", "path of the output optimized model");
 DEFINE_string(valid_targets,
               "arm",
               "The targets this model optimized for, should be one of (arm, "
-              "opencl, x86, x86_opencl), splitted by space");
+              "opencl, x86, x86_nchwc8, x86_opencl), splitted by space");
 DEFINE_bool(print_supported_ops,
             false,
             "Print supported operators on the inputed target");
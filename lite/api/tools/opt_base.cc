@@ -35,13 +35,24 @@ void OptBase::SetParamFile(const std::string& param_path) {
 }
 
 void OptBase::SetModelType(std::string optimize_out_type) {
+  auto param_encoding = lite_api::ParamEncodingType::kRaw;
   if (optimize_out_type == "protobuf") {
     model_type_ = LiteModelType::kProtobuf;
   } else if (optimize_out_type == "naive_buffer") {
     model_type_ = LiteModelType::kNaiveBuffer;
+  } else if (optimize_out_type == "naive_buffer_lz4") {
+    model_type_ = LiteModelType::kNaiveBuffer;
+    param_encoding = lite_api::ParamEncodingType::kLZ4;
+  } else if (optimize_out_type == "naive_buffer_lz4_fp16") {
+    model_type_ = LiteModelType::kNaiveBuffer;
+    param_encoding = lite_api::ParamEncodingType::kLZ4FP16;
+  } else if (optimize_out_type == "naive_buffer_lz4_int8") {
+    model_type_ = LiteModelType::kNaiveBuffer;
+    param_encoding = lite_api::ParamEncodingType::kLZ4Int8;
   } else {
     OPT_LOG_FATAL << "Unsupported Model type :" << optimize_out_type;
   }
+  opt_config_.set_param_encoding(param_encoding);
 }
 
 void OptBase::SetQuantModel(bool quant_model) {
@@ -145,6 +156,14 @@ void OptBase::SetValidPlaces(const std::string& valid_places) {
       valid_places_.emplace_back(Place{TARGET(kX86), PRECISION(kFloat)});
       valid_places_.emplace_back(Place{TARGET(kX86), PRECISION(kInt64)});
       valid_places_.emplace_back(Place{TARGET(kX86), PRECISION(kAny)});
+    } else if (target_repr == "x86_nchwc8") {
+      // the convs and the CNN ops around them run blocked over 8 channels,
+      // the other ops fall back to the x86 NCHW kernels
+      valid_places_.emplace_back(
+          Place{TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8)});
+      valid_places_.emplace_back(Place{TARGET(kX86), PRECISION(kFloat)});
+      valid_places_.emplace_back(Place{TARGET(kX86), PRECISION(kInt64)});
+      valid_places_.emplace_back(Place{TARGET(kX86), PRECISION(kAny)});
     } else if (target_repr == "x86_opencl") {
       valid_places_.emplace_back(
           Place{TARGET(kOpenCL), PRECISION(kFP16), DATALAYOUT(kImageDefault)});
@@ -345,7 +364,8 @@ void OptBase::PrintHelpInfo() {
       "        `set_model_dir(model_dir)`\n"
       "        `set_model_file(model_file_path)`\n"
       "        `set_param_file(param_file_path)`\n"
-      "        `set_model_type(protobuf|naive_buffer)`: naive_buffer by "
+      "        `set_model_type(protobuf|naive_buffer|naive_buffer_lz4|"
+      "naive_buffer_lz4_fp16|naive_buffer_lz4_int8)`: naive_buffer by "
       "default\n"
       "        `set_lite_out(output_optimize_model_dir)`\n"
       "        "
@@ -390,7 +410,8 @@ void OptBase::PrintExecutableBinHelpInfo() {
       "        `--model_dir=<model_param_dir>`\n"
       "        `--model_file=<model_path>`\n"
       "        `--param_file=<param_path>`\n"
-      "        `--optimize_out_type=(protobuf|naive_buffer)`\n"
+      "        `--optimize_out_type=(protobuf|naive_buffer|naive_buffer_lz4|"
+      "naive_buffer_lz4_fp16|naive_buffer_lz4_int8)`\n"
       "        `--optimize_out=<output_optimize_model_dir>`\n"
       "        "
       "`--valid_targets=(arm|opencl|x86|metal|xpu|bm|mlu|intel_fpga|"
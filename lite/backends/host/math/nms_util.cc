@@ -0,0 +1,294 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/host/math/nms_util.h"
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#include "lite/utils/macros.h"
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+void NMSBoxes::clear() {
+  xmin.clear();
+  ymin.clear();
+  xmax.clear();
+  ymax.clear();
+  area.clear();
+}
+
+void NMSBoxes::reserve(size_t size) {
+  xmin.reserve(size);
+  ymin.reserve(size);
+  xmax.reserve(size);
+  ymax.reserve(size);
+  area.reserve(size);
+}
+
+void NMSBoxes::push_back(const float* box, float box_area) {
+  xmin.push_back(box[0]);
+  ymin.push_back(box[1]);
+  xmax.push_back(box[2]);
+  ymax.push_back(box[3]);
+  area.push_back(box_area);
+}
+
+// The overlap of box and boxes i, the operations of JaccardOverlap in the
+// same order so the vectors give the same floats.
+static inline float OverlapOne(const NMSBoxes& boxes,
+                               size_t i,
+                               const float* box,
+                               float box_area,
+                               float norm) {
+  if (boxes.xmin[i] > box[2] || boxes.xmax[i] < box[0] ||
+      boxes.ymin[i] > box[3] || boxes.ymax[i] < box[1]) {
+    return 0.f;
+  }
+  const float inter_w = (std::min)(box[2], boxes.xmax[i]) -
+                        (std::max)(box[0], boxes.xmin[i]) + norm;
+  const float inter_h = (std::min)(box[3], boxes.ymax[i]) -
+                        (std::max)(box[1], boxes.ymin[i]) + norm;
+  const float inter_area = inter_w * inter_h;
+  return inter_area / (box_area + boxes.area[i] - inter_area);
+}
+
+#if defined(__AVX__)
+// the overlaps of box and the 8 boxes from i
+static inline __m256 Overlap8(const NMSBoxes& boxes,
+                              size_t i,
+                              const __m256 b[4],
+                              __m256 vbox_area,
+                              __m256 vnorm) {
+  __m256 xmin = _mm256_loadu_ps(boxes.xmin.data() + i);
+  __m256 ymin = _mm256_loadu_ps(boxes.ymin.data() + i);
+  __m256 xmax = _mm256_loadu_ps(boxes.xmax.data() + i);
+  __m256 ymax = _mm256_loadu_ps(boxes.ymax.data() + i);
+  __m256 apart = _mm256_or_ps(
+      _mm256_or_ps(_mm256_cmp_ps(xmin, b[2], _CMP_GT_OQ),
+                   _mm256_cmp_ps(xmax, b[0], _CMP_LT_OQ)),
+      _mm256_or_ps(_mm256_cmp_ps(ymin, b[3], _CMP_GT_OQ),
+                   _mm256_cmp_ps(ymax, b[1], _CMP_LT_OQ)));
+  __m256 inter_w = _mm256_add_ps(
+      _mm256_sub_ps(_mm256_min_ps(b[2], xmax), _mm256_max_ps(b[0], xmin)),
+      vnorm);
+  __m256 inter_h = _mm256_add_ps(
+      _mm256_sub_ps(_mm256_min_ps(b[3], ymax), _mm256_max_ps(b[1], ymin)),
+      vnorm);
+  __m256 inter_area = _mm256_mul_ps(inter_w, inter_h);
+  __m256 iou = _mm256_div_ps(
+      inter_area,
+      _mm256_sub_ps(
+          _mm256_add_ps(vbox_area, _mm256_loadu_ps(boxes.area.data() + i)),
+          inter_area));
+  return _mm256_andnot_ps(apart, iou);
+}
+#elif defined(__SSE2__)
+static inline __m128 Overlap4(const NMSBoxes& boxes,
+                              size_t i,
+                              const __m128 b[4],
+                              __m128 vbox_area,
+                              __m128 vnorm) {
+  __m128 xmin = _mm_loadu_ps(boxes.xmin.data() + i);
+  __m128 ymin = _mm_loadu_ps(boxes.ymin.data() + i);
+  __m128 xmax = _mm_loadu_ps(boxes.xmax.data() + i);
+  __m128 ymax = _mm_loadu_ps(boxes.ymax.data() + i);
+  __m128 apart =
+      _mm_or_ps(_mm_or_ps(_mm_cmpgt_ps(xmin, b[2]), _mm_cmplt_ps(xmax, b[0])),
+                _mm_or_ps(_mm_cmpgt_ps(ymin, b[3]), _mm_cmplt_ps(ymax, b[1])));
+  __m128 inter_w = _mm_add_ps(
+      _mm_sub_ps(_mm_min_ps(b[2], xmax), _mm_max_ps(b[0], xmin)), vnorm);
+  __m128 inter_h = _mm_add_ps(
+      _mm_sub_ps(_mm_min_ps(b[3], ymax), _mm_max_ps(b[1], ymin)), vnorm);
+  __m128 inter_area = _mm_mul_ps(inter_w, inter_h);
+  __m128 iou = _mm_div_ps(
+      inter_area,
+      _mm_sub_ps(_mm_add_ps(vbox_area, _mm_loadu_ps(boxes.area.data() + i)),
+                 inter_area));
+  return _mm_andnot_ps(apart, iou);
+}
+#elif defined(__aarch64__)
+static inline float32x4_t Overlap4(const NMSBoxes& boxes,
+                                   size_t i,
+                                   const float32x4_t b[4],
+                                   float32x4_t vbox_area,
+                                   float32x4_t vnorm) {
+  float32x4_t xmin = vld1q_f32(boxes.xmin.data() + i);
+  float32x4_t ymin = vld1q_f32(boxes.ymin.data() + i);
+  float32x4_t xmax = vld1q_f32(boxes.xmax.data() + i);
+  float32x4_t ymax = vld1q_f32(boxes.ymax.data() + i);
+  uint32x4_t apart =
+      vorrq_u32(vorrq_u32(vcgtq_f32(xmin, b[2]), vcltq_f32(xmax, b[0])),
+                vorrq_u32(vcgtq_f32(ymin, b[3]), vcltq_f32(ymax, b[1])));
+  float32x4_t inter_w = vaddq_f32(
+      vsubq_f32(vminq_f32(b[2], xmax), vmaxq_f32(b[0], xmin)), vnorm);
+  float32x4_t inter_h = vaddq_f32(
+      vsubq_f32(vminq_f32(b[3], ymax), vmaxq_f32(b[1], ymin)), vnorm);
+  float32x4_t inter_area = vmulq_f32(inter_w, inter_h);
+  float32x4_t iou = vdivq_f32(
+      inter_area,
+      vsubq_f32(vaddq_f32(vbox_area, vld1q_f32(boxes.area.data() + i)),
+                inter_area));
+  return vreinterpretq_f32_u32(
+      vbicq_u32(vreinterpretq_u32_f32(iou), apart));
+}
+#endif
+
+void BatchJaccardOverlap(const NMSBoxes& boxes,
+                         size_t num,
+                         const float* box,
+                         float box_area,
+                         bool normalized,
+                         float* ious) {
+  const float norm = normalized ? 0.f : 1.f;
+  size_t i = 0;
+#if defined(__AVX__)
+  const __m256 b[4] = {_mm256_set1_ps(box[0]),
+                       _mm256_set1_ps(box[1]),
+                       _mm256_set1_ps(box[2]),
+                       _mm256_set1_ps(box[3])};
+  const __m256 vbox_area = _mm256_set1_ps(box_area);
+  const __m256 vnorm = _mm256_set1_ps(norm);
+  for (; i + 8 <= num; i += 8) {
+    _mm256_storeu_ps(ious + i, Overlap8(boxes, i, b, vbox_area, vnorm));
+  }
+#elif defined(__SSE2__)
+  const __m128 b[4] = {_mm_set1_ps(box[0]),
+                       _mm_set1_ps(box[1]),
+                       _mm_set1_ps(box[2]),
+                       _mm_set1_ps(box[3])};
+  const __m128 vbox_area = _mm_set1_ps(box_area);
+  const __m128 vnorm = _mm_set1_ps(norm);
+  for (; i + 4 <= num; i += 4) {
+    _mm_storeu_ps(ious + i, Overlap4(boxes, i, b, vbox_area, vnorm));
+  }
+#elif defined(__aarch64__)
+  const float32x4_t b[4] = {vdupq_n_f32(box[0]),
+                            vdupq_n_f32(box[1]),
+                            vdupq_n_f32(box[2]),
+                            vdupq_n_f32(box[3])};
+  const float32x4_t vbox_area = vdupq_n_f32(box_area);
+  const float32x4_t vnorm = vdupq_n_f32(norm);
+  for (; i + 4 <= num; i += 4) {
+    vst1q_f32(ious + i, Overlap4(boxes, i, b, vbox_area, vnorm));
+  }
+#endif
+  for (; i < num; ++i) {
+    ious[i] = OverlapOne(boxes, i, box, box_area, norm);
+  }
+}
+
+bool OverlapsNotAbove(const NMSBoxes& boxes,
+                      const float* box,
+                      float box_area,
+                      float threshold,
+                      bool normalized) {
+  const float norm = normalized ? 0.f : 1.f;
+  const size_t num = boxes.size();
+  size_t i = 0;
+  // an ordered <= is false for a nan overlap, as the scalar comparison
+#if defined(__AVX__)
+  const __m256 b[4] = {_mm256_set1_ps(box[0]),
+                       _mm256_set1_ps(box[1]),
+                       _mm256_set1_ps(box[2]),
+                       _mm256_set1_ps(box[3])};
+  const __m256 vbox_area = _mm256_set1_ps(box_area);
+  const __m256 vnorm = _mm256_set1_ps(norm);
+  const __m256 vthreshold = _mm256_set1_ps(threshold);
+  for (; i + 8 <= num; i += 8) {
+    __m256 not_above = _mm256_cmp_ps(
+        Overlap8(boxes, i, b, vbox_area, vnorm), vthreshold, _CMP_LE_OQ);
+    if (_mm256_movemask_ps(not_above) != 0xFF) {
+      return false;
+    }
+  }
+#elif defined(__SSE2__)
+  const __m128 b[4] = {_mm_set1_ps(box[0]),
+                       _mm_set1_ps(box[1]),
+                       _mm_set1_ps(box[2]),
+                       _mm_set1_ps(box[3])};
+  const __m128 vbox_area = _mm_set1_ps(box_area);
+  const __m128 vnorm = _mm_set1_ps(norm);
+  const __m128 vthreshold = _mm_set1_ps(threshold);
+  for (; i + 4 <= num; i += 4) {
+    __m128 not_above =
+        _mm_cmple_ps(Overlap4(boxes, i, b, vbox_area, vnorm), vthreshold);
+    if (_mm_movemask_ps(not_above) != 0xF) {
+      return false;
+    }
+  }
+#elif defined(__aarch64__)
+  const float32x4_t b[4] = {vdupq_n_f32(box[0]),
+                            vdupq_n_f32(box[1]),
+                            vdupq_n_f32(box[2]),
+                            vdupq_n_f32(box[3])};
+  const float32x4_t vbox_area = vdupq_n_f32(box_area);
+  const float32x4_t vnorm = vdupq_n_f32(norm);
+  const float32x4_t vthreshold = vdupq_n_f32(threshold);
+  for (; i + 4 <= num; i += 4) {
+    uint32x4_t not_above =
+        vcleq_f32(Overlap4(boxes, i, b, vbox_area, vnorm), vthreshold);
+    if (vminvq_u32(not_above) == 0) {
+      return false;
+    }
+  }
+#endif
+  for (; i < num; ++i) {
+    if (!(OverlapOne(boxes, i, box, box_area, norm) <= threshold)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void GreedyNMS(const float* boxes,
+               int64_t box_stride,
+               const std::pair<float, int>* candidates,
+               int64_t num_candidates,
+               float nms_threshold,
+               float eta,
+               bool normalized,
+               int64_t max_keep,
+               std::vector<int>* selected_indices) {
+  static LITE_THREAD_LOCAL NMSBoxes kept;
+  kept.clear();
+  kept.reserve(num_candidates);
+  float adaptive_threshold = nms_threshold;
+  for (int64_t k = 0; k < num_candidates; ++k) {
+    if (max_keep > -1 && static_cast<int64_t>(kept.size()) >= max_keep) {
+      break;
+    }
+    const int idx = candidates[k].second;
+    const float* box = boxes + idx * box_stride;
+    const float box_area = BBoxArea<float>(box, normalized);
+    if (OverlapsNotAbove(kept, box, box_area, adaptive_threshold, normalized)) {
+      kept.push_back(box, box_area);
+      selected_indices->push_back(idx);
+      if (eta < 1 && adaptive_threshold > 0.5) {
+        adaptive_threshold *= eta;
+      }
+    }
+  }
+}
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
@@ -29,26 +29,52 @@ bool SortScorePairDescend(const std::pair<float, T>& pair1,
   return pair1.first > pair2.first;
 }
 
+// The descending order of the scores, equal scores by ascending index: the
+// order std::stable_sort gives by SortScorePairDescend, as a total order it
+// lets partial_sort pick the top k without sorting the others.
 template <typename T>
-static void GetMaxScoreIndex(const std::vector<T>& scores,
-                             const T threshold,
-                             int top_k,
-                             std::vector<std::pair<T, int>>* sorted_indices) {
-  for (size_t i = 0; i < scores.size(); ++i) {
-    if (scores[i] > threshold) {
-      sorted_indices->push_back(std::make_pair(scores[i], i));
+bool ScoreIndexDescend(const std::pair<T, int>& pair1,
+                       const std::pair<T, int>& pair2) {
+  return pair1.first > pair2.first ||
+         (pair1.first == pair2.first && pair1.second < pair2.second);
+}
+
+// The scores[i * stride] > threshold of i < num, sorted by ScoreIndexDescend
+// and cut to the first top_k if top_k > -1.
+template <typename T>
+void GetTopKScoreIndex(const T* scores,
+                       int64_t num,
+                       int64_t stride,
+                       const T threshold,
+                       int64_t top_k,
+                       std::vector<std::pair<T, int>>* sorted_indices) {
+  sorted_indices->clear();
+  for (int64_t i = 0; i < num; ++i) {
+    if (scores[i * stride] > threshold) {
+      sorted_indices->emplace_back(scores[i * stride], static_cast<int>(i));
     }
   }
-  // Sort the score pair according to the scores in descending order
-  std::stable_sort(sorted_indices->begin(),
-                   sorted_indices->end(),
-                   SortScorePairDescend<int>);
-  // Keep top_k scores if needed.
-  if (top_k > -1 && top_k < static_cast<int>(sorted_indices->size())) {
+  if (top_k > -1 && top_k < static_cast<int64_t>(sorted_indices->size())) {
+    std::partial_sort(sorted_indices->begin(),
+                      sorted_indices->begin() + top_k,
+                      sorted_indices->end(),
+                      ScoreIndexDescend<T>);
     sorted_indices->resize(top_k);
+  } else {
+    std::sort(
+        sorted_indices->begin(), sorted_indices->end(), ScoreIndexDescend<T>);
   }
 }
 
+template <typename T>
+static void GetMaxScoreIndex(const std::vector<T>& scores,
+                             const T threshold,
+                             int top_k,
+                             std::vector<std::pair<T, int>>* sorted_indices) {
+  GetTopKScoreIndex(
+      scores.data(), scores.size(), 1, threshold, top_k, sorted_indices);
+}
+
 template <typename T>
 static T BBoxArea(const T* box, const bool normalized) {
   if (box[2] < box[0] || box[3] < box[1]) {
@@ -121,6 +147,53 @@ std::vector<std::pair<T, int>> GetSortedScoreIndex(
   return sorted_indices;
 }
 
+// The boxes [xmin ymin xmax ymax] kept by NMS as structure of arrays, so the
+// overlaps of a box with all of them are computed a vector at a time.
+struct NMSBoxes {
+  std::vector<float> xmin;
+  std::vector<float> ymin;
+  std::vector<float> xmax;
+  std::vector<float> ymax;
+  std::vector<float> area;
+
+  size_t size() const { return xmin.size(); }
+  void clear();
+  void reserve(size_t size);
+  void push_back(const float* box, float box_area);
+};
+
+// ious[i] = JaccardOverlap(box, boxes i) for i < num, box_area is
+// BBoxArea(box).
+void BatchJaccardOverlap(const NMSBoxes& boxes,
+                         size_t num,
+                         const float* box,
+                         float box_area,
+                         bool normalized,
+                         float* ious);
+
+// Whether JaccardOverlap(box, boxes i) <= threshold for all the boxes.
+bool OverlapsNotAbove(const NMSBoxes& boxes,
+                      const float* box,
+                      float box_area,
+                      float threshold,
+                      bool normalized);
+
+// Greedy NMS of the boxes [xmin ymin xmax ymax] at boxes + index *
+// box_stride: the candidates, sorted by descending score, are kept when
+// their overlap with every kept box is <= the threshold, which eta < 1
+// lowers after every kept box while it is > 0.5. Appends the kept indices
+// to selected_indices, stops after max_keep of them if max_keep > -1. The
+// kept boxes go to a buffer of the thread, which is reused by the next call.
+void GreedyNMS(const float* boxes,
+               int64_t box_stride,
+               const std::pair<float, int>* candidates,
+               int64_t num_candidates,
+               float nms_threshold,
+               float eta,
+               bool normalized,
+               int64_t max_keep,
+               std::vector<int>* selected_indices);
+
 template <typename T>
 static Tensor VectorToTensor(const std::vector<T>& selected_indices,
                              int selected_num) {
@@ -133,48 +206,43 @@ static Tensor VectorToTensor(const std::vector<T>& selected_indices,
   return keep_nms;
 }
 
-template <typename T>
-static Tensor NMS(Tensor* bbox,
-                  Tensor* scores,
-                  const T nms_threshold,
-                  const float eta,
-                  const bool pixel_offset = true) {
+// NMS of all the boxes by descending score, equal scores by descending
+// index, as GetSortedScoreIndex pops them from its back. Keeps at most
+// max_keep boxes if max_keep > -1.
+inline Tensor NMS(Tensor* bbox,
+                 Tensor* scores,
+                 const float nms_threshold,
+                 const float eta,
+                 const bool pixel_offset = true,
+                 const int64_t max_keep = -1) {
   int64_t num_boxes = bbox->dims()[0];
   // 4: [xmin ymin xmax ymax]
   int64_t box_size = bbox->dims()[1];
+  const float* scores_data = scores->data<float>();
 
-  std::vector<T> scores_data(num_boxes);
-  std::copy_n(scores->data<T>(), num_boxes, scores_data.begin());
-  std::vector<std::pair<T, int>> sorted_indices =
-      GetSortedScoreIndex<T>(scores_data);
+  std::vector<std::pair<float, int>> sorted_indices;
+  sorted_indices.reserve(num_boxes);
+  for (int64_t i = 0; i < num_boxes; ++i) {
+    sorted_indices.emplace_back(scores_data[i], static_cast<int>(i));
+  }
+  std::sort(sorted_indices.begin(),
+            sorted_indices.end(),
+            [](const std::pair<float, int>& a, const std::pair<float, int>& b) {
+              return a.first > b.first ||
+                     (a.first == b.first && a.second > b.second);
+            });
 
   std::vector<int> selected_indices;
-  int selected_num = 0;
-  T adaptive_threshold = nms_threshold;
-  const T* bbox_data = bbox->data<T>();
-  while (sorted_indices.size() != 0) {
-    int idx = sorted_indices.back().second;
-    bool flag = true;
-    for (int kept_idx : selected_indices) {
-      if (flag) {
-        T overlap = JaccardOverlap<T>(bbox_data + idx * box_size,
-                                      bbox_data + kept_idx * box_size,
-                                      !pixel_offset);
-        flag = (overlap <= adaptive_threshold);
-      } else {
-        break;
-      }
-    }
-    if (flag) {
-      selected_indices.push_back(idx);
-      ++selected_num;
-    }
-    sorted_indices.erase(sorted_indices.end() - 1);
-    if (flag && eta < 1 && adaptive_threshold > 0.5) {
-      adaptive_threshold *= eta;
-    }
-  }
-  return VectorToTensor(selected_indices, selected_num);
+  GreedyNMS(bbox->data<float>(),
+            box_size,
+            sorted_indices.data(),
+            num_boxes,
+            nms_threshold,
+            eta,
+            !pixel_offset,
+            max_keep,
+            &selected_indices);
+  return VectorToTensor(selected_indices, selected_indices.size());
 }
 
 }  // namespace math
@@ -0,0 +1,819 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/avx/nchwc8.h"
+#include <immintrin.h>
+#include <algorithm>
+#include <cfloat>
+#include "lite/backends/x86/math/avx/avx_mathfuns.h"
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/backends/x86/math/avx/conv_utils.h"
+#include "lite/backends/x86/math/pooling.h"
+#include "lite/core/parallel_defines.h"
+
+// The AVX-512 conv tile is compiled for its own functions only and called if
+// the CPU supports it.
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define NCHWC8_WITH_AVX512
+#if defined(__GNUC__) && !defined(__AVX512F__)
+#define NCHWC8_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define NCHWC8_TARGET_AVX512
+#endif
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// elements of the elementwise ops and activations per task
+const int64_t kNCHWc8TaskSize = 16384;
+
+// the activation applied to the outputs in registers, the constants are set
+// once per call
+class ActNCHWc8 {
+ public:
+  ActNCHWc8(lite_api::ActivationType type,
+            const operators::ActivationParam& param,
+            float relu6_clip)
+      : type_(type) {
+    zero_ = _mm256_setzero_ps();
+    switch (type) {
+      case lite_api::ActivationType::kIndentity:
+      case lite_api::ActivationType::kRelu:
+        break;
+      case lite_api::ActivationType::kRelu6:
+        v0_ = _mm256_set1_ps(relu6_clip);
+        break;
+      case lite_api::ActivationType::kLeakyRelu:
+        v0_ = _mm256_set1_ps(param.Leaky_relu_alpha);
+        break;
+      case lite_api::ActivationType::kHardSwish:
+        v0_ = _mm256_set1_ps(param.hard_swish_offset);
+        v1_ = _mm256_set1_ps(1.f / param.hard_swish_scale);
+        v2_ = _mm256_set1_ps(param.hard_swish_threshold);
+        break;
+      case lite_api::ActivationType::kSigmoid:
+        v0_ = _mm256_set1_ps(1.f);
+        break;
+      default:
+        LOG(FATAL) << "[X86] NCHWc8 activation type not supported: "
+                   << static_cast<int>(type);
+    }
+  }
+
+  inline __m256 operator()(__m256 x) const {
+    switch (type_) {
+      case lite_api::ActivationType::kRelu:
+        return _mm256_max_ps(x, zero_);
+      case lite_api::ActivationType::kRelu6:
+        return _mm256_min_ps(_mm256_max_ps(x, zero_), v0_);
+      case lite_api::ActivationType::kLeakyRelu:
+        return _mm256_blendv_ps(_mm256_mul_ps(x, v0_),
+                                x,
+                                _mm256_cmp_ps(x, zero_, _CMP_GT_OS));
+      case lite_api::ActivationType::kHardSwish:
+        return _mm256_mul_ps(
+            _mm256_min_ps(v2_, _mm256_max_ps(_mm256_add_ps(x, v0_), zero_)),
+            _mm256_mul_ps(x, v1_));
+      case lite_api::ActivationType::kSigmoid:
+        return _mm256_div_ps(
+            v0_, _mm256_add_ps(v0_, exp256_ps(_mm256_sub_ps(zero_, x))));
+      default:
+        return x;
+    }
+  }
+
+ private:
+  lite_api::ActivationType type_;
+  __m256 zero_;
+  __m256 v0_;
+  __m256 v1_;
+  __m256 v2_;
+};
+
+ActNCHWc8 conv_act(const operators::ConvParam& param) {
+  const auto& act_param = param.activation_param;
+  auto type = act_param.has_active ? act_param.active_type
+                                   : lite_api::ActivationType::kIndentity;
+  return ActNCHWc8(type, act_param, act_param.Relu_clipped_coef);
+}
+
+// the shape of a conv, the input and output channels are in blocks
+struct ConvNCHWc8Shape {
+  int ih, iw, oh, ow;
+  int kh, kw, sh, sw, ph, pw, dh, dw;
+  int icb;      // input blocks of a group
+  int w_block;  // weights of an output block
+};
+
+ConvNCHWc8Shape conv_shape(const operators::ConvParam& param, int icb) {
+  auto in_dims = param.x->dims();
+  auto out_dims = param.output->dims();
+  auto w_dims = param.filter->dims();
+  const auto& paddings = *param.paddings;
+  const auto& dilations = *param.dilations;
+  ConvNCHWc8Shape s;
+  s.ih = in_dims[2];
+  s.iw = in_dims[3];
+  s.oh = out_dims[2];
+  s.ow = out_dims[3];
+  s.kh = w_dims[2];
+  s.kw = w_dims[3];
+  s.sh = param.strides[0];
+  s.sw = param.strides[1];
+  s.ph = paddings[0];
+  s.pw = paddings[2];
+  s.dh = dilations[0];
+  s.dw = dilations[1];
+  s.icb = icb;
+  s.w_block = icb * s.kh * s.kw * 64;
+  return s;
+}
+
+// the kernel columns [*kx0, *kx1) inside the input row for the input column
+// ix of the first one
+inline void valid_kx(const ConvNCHWc8Shape& s, int ix, int* kx0, int* kx1) {
+  *kx0 = ix >= 0 ? 0 : (-ix + s.dw - 1) / s.dw;
+  *kx1 = ix >= s.iw ? 0 : std::min(s.kw, (s.iw - 1 - ix) / s.dw + 1);
+}
+
+// the output columns [*ox0, *ox1) of which all the kernel columns are inside
+// the input row
+inline void interior_ox(const ConvNCHWc8Shape& s, int* ox0, int* ox1) {
+  *ox0 = std::min((s.pw + s.sw - 1) / s.sw, s.ow);
+  int last = s.iw - 1 + s.pw - (s.kw - 1) * s.dw;
+  *ox1 = last < 0 ? *ox0 : std::max(*ox0, std::min(last / s.sw + 1, s.ow));
+}
+
+// NB output blocks x TW output pixels of the row oy, the accumulators stay in
+// registers over all the input blocks and the kernel: 12 of them for 2 x 6,
+// the inputs are broadcasted once for the NB blocks.
+// din: the first input block of the group, weights: the first output block,
+// dout: the first output pixel of the first block
+template <int NB, int TW>
+inline void conv_nchwc8_tile(const ConvNCHWc8Shape& s,
+                             const float* din,
+                             const float* weights,
+                             const float* bias,
+                             float* dout,
+                             int oy,
+                             int ox,
+                             int kx0,
+                             int kx1,
+                             const ActNCHWc8& act) {
+  __m256 acc[NB][TW];
+  for (int b = 0; b < NB; ++b) {
+    __m256 vbias = _mm256_loadu_ps(bias + b * 8);
+    for (int t = 0; t < TW; ++t) {
+      acc[b][t] = vbias;
+    }
+  }
+  const int in_block = s.ih * s.iw * 8;
+  const int iy0 = oy * s.sh - s.ph;
+  const int ix0 = ox * s.sw - s.pw;
+  const int in_step = s.sw * 8;
+  for (int c = 0; c < s.icb; ++c) {
+    const float* in_c = din + c * in_block;
+    const float* w_c = weights + c * s.kh * s.kw * 64;
+    for (int ky = 0; ky < s.kh; ++ky) {
+      const int iy = iy0 + ky * s.dh;
+      if (iy < 0 || iy >= s.ih) continue;
+      const float* in_row = in_c + iy * s.iw * 8;
+      const float* w_row = w_c + ky * s.kw * 64;
+      for (int kx = kx0; kx < kx1; ++kx) {
+        const float* in_px = in_row + (ix0 + kx * s.dw) * 8;
+        const float* w_px = w_row + kx * 64;
+        for (int i = 0; i < 8; ++i) {
+          __m256 vw[NB];
+          for (int b = 0; b < NB; ++b) {
+            vw[b] = _mm256_loadu_ps(w_px + b * s.w_block + i * 8);
+          }
+          for (int t = 0; t < TW; ++t) {
+            __m256 vx = _mm256_broadcast_ss(in_px + t * in_step + i);
+            for (int b = 0; b < NB; ++b) {
+              acc[b][t] = _mm256_fmadd_ps(vx, vw[b], acc[b][t]);
+            }
+          }
+        }
+      }
+    }
+  }
+  const int out_block = s.oh * s.ow * 8;
+  for (int b = 0; b < NB; ++b) {
+    for (int t = 0; t < TW; ++t) {
+      _mm256_storeu_ps(dout + b * out_block + t * 8, act(acc[b][t]));
+    }
+  }
+}
+
+#ifdef NCHWC8_WITH_AVX512
+// the 8 floats of lo and hi in an __m512
+NCHWC8_TARGET_AVX512 inline __m512 load_pair_avx512(const float* lo,
+                                                    const float* hi) {
+  return _mm512_castpd_ps(_mm512_insertf64x4(
+      _mm512_castpd256_pd512(_mm256_castps_pd(_mm256_loadu_ps(lo))),
+      _mm256_castps_pd(_mm256_loadu_ps(hi)),
+      1));
+}
+
+// conv_nchwc8_tile of a pair of output blocks with AVX-512: the 16 output
+// channels of the pair are the 16 lanes of an __m512, the two halves are
+// stored to their blocks
+template <int TW>
+NCHWC8_TARGET_AVX512 void conv_nchwc8_pair_tile_avx512(
+    const ConvNCHWc8Shape& s,
+    const float* din,
+    const float* weights,
+    const float* bias,
+    float* dout,
+    int oy,
+    int ox,
+    int kx0,
+    int kx1,
+    const ActNCHWc8& act) {
+  __m512 acc[TW];
+  const __m512 vbias = load_pair_avx512(bias, bias + 8);
+  for (int t = 0; t < TW; ++t) {
+    acc[t] = vbias;
+  }
+  const int in_block = s.ih * s.iw * 8;
+  const int iy0 = oy * s.sh - s.ph;
+  const int ix0 = ox * s.sw - s.pw;
+  const int in_step = s.sw * 8;
+  for (int c = 0; c < s.icb; ++c) {
+    const float* in_c = din + c * in_block;
+    const float* w_c = weights + c * s.kh * s.kw * 64;
+    for (int ky = 0; ky < s.kh; ++ky) {
+      const int iy = iy0 + ky * s.dh;
+      if (iy < 0 || iy >= s.ih) continue;
+      const float* in_row = in_c + iy * s.iw * 8;
+      const float* w_row = w_c + ky * s.kw * 64;
+      for (int kx = kx0; kx < kx1; ++kx) {
+        const float* in_px = in_row + (ix0 + kx * s.dw) * 8;
+        const float* w_px = w_row + kx * 64;
+        for (int i = 0; i < 8; ++i) {
+          __m512 vw = load_pair_avx512(w_px + i * 8, w_px + s.w_block + i * 8);
+          for (int t = 0; t < TW; ++t) {
+            __m512 vx = _mm512_set1_ps(in_px[t * in_step + i]);
+            acc[t] = _mm512_fmadd_ps(vx, vw, acc[t]);
+          }
+        }
+      }
+    }
+  }
+  const int out_block = s.oh * s.ow * 8;
+  for (int t = 0; t < TW; ++t) {
+    __m256 lo = _mm512_castps512_ps256(acc[t]);
+    __m256 hi = _mm256_castpd_ps(
+        _mm512_extractf64x4_pd(_mm512_castps_pd(acc[t]), 1));
+    _mm256_storeu_ps(dout + t * 8, act(lo));
+    _mm256_storeu_ps(dout + out_block + t * 8, act(hi));
+  }
+}
+#endif
+
+// conv_nchwc8_tile, or its AVX-512 version for a pair of output blocks
+template <int NB, int TW, bool AVX512>
+inline void conv_nchwc8_any_tile(const ConvNCHWc8Shape& s,
+                                 const float* din,
+                                 const float* weights,
+                                 const float* bias,
+                                 float* dout,
+                                 int oy,
+                                 int ox,
+                                 int kx0,
+                                 int kx1,
+                                 const ActNCHWc8& act) {
+#ifdef NCHWC8_WITH_AVX512
+  if (AVX512) {
+    conv_nchwc8_pair_tile_avx512<TW>(
+        s, din, weights, bias, dout, oy, ox, kx0, kx1, act);
+    return;
+  }
+#endif
+  conv_nchwc8_tile<NB, TW>(s, din, weights, bias, dout, oy, ox, kx0, kx1, act);
+}
+
+// a row of NB output blocks: the interior pixels TW at a time, the border
+// pixels and the tail one at a time
+template <int NB, int TW, bool AVX512 = false>
+void conv_nchwc8_row(const ConvNCHWc8Shape& s,
+                     const float* din,
+                     const float* weights,
+                     const float* bias,
+                     float* dout,
+                     int oy,
+                     const ActNCHWc8& act) {
+  int ox0 = 0;
+  int ox1 = 0;
+  interior_ox(s, &ox0, &ox1);
+  int kx0 = 0;
+  int kx1 = 0;
+  for (int ox = 0; ox < s.ow; ++ox) {
+    if (ox == ox0) {
+      for (; ox + TW <= ox1; ox += TW) {
+        conv_nchwc8_any_tile<NB, TW, AVX512>(
+            s, din, weights, bias, dout + ox * 8, oy, ox, 0, s.kw, act);
+      }
+      if (ox >= s.ow) break;
+    }
+    valid_kx(s, ox * s.sw - s.pw, &kx0, &kx1);
+    conv_nchwc8_any_tile<NB, 1, AVX512>(
+        s, din, weights, bias, dout + ox * 8, oy, ox, kx0, kx1, act);
+  }
+}
+
+// TW output pixels of a depthwise conv, din, weights and dout point to the
+// block
+template <int TW>
+inline void conv_depthwise_nchwc8_tile(const ConvNCHWc8Shape& s,
+                                       const float* din,
+                                       const float* weights,
+                                       __m256 vbias,
+                                       float* dout,
+                                       int oy,
+                                       int ox,
+                                       int kx0,
+                                       int kx1,
+                                       const ActNCHWc8& act) {
+  __m256 acc[TW];
+  for (int t = 0; t < TW; ++t) {
+    acc[t] = vbias;
+  }
+  const int iy0 = oy * s.sh - s.ph;
+  const int ix0 = ox * s.sw - s.pw;
+  const int in_step = s.sw * 8;
+  for (int ky = 0; ky < s.kh; ++ky) {
+    const int iy = iy0 + ky * s.dh;
+    if (iy < 0 || iy >= s.ih) continue;
+    const float* in_row = din + iy * s.iw * 8;
+    const float* w_row = weights + ky * s.kw * 8;
+    for (int kx = kx0; kx < kx1; ++kx) {
+      const float* in_px = in_row + (ix0 + kx * s.dw) * 8;
+      __m256 vw = _mm256_loadu_ps(w_row + kx * 8);
+      for (int t = 0; t < TW; ++t) {
+        acc[t] =
+            _mm256_fmadd_ps(_mm256_loadu_ps(in_px + t * in_step), vw, acc[t]);
+      }
+    }
+  }
+  for (int t = 0; t < TW; ++t) {
+    _mm256_storeu_ps(dout + t * 8, act(acc[t]));
+  }
+}
+
+template <typename Op>
+void elementwise_nchwc8_impl(const float* dinx,
+                             const float* diny,
+                             float* dout,
+                             int num,
+                             int cb,
+                             int size,
+                             int x_size,
+                             int x_num,
+                             int y_size,
+                             int y_num,
+                             bool fuse_relu,
+                             Op op) {
+  const __m256 zero = _mm256_setzero_ps();
+  LITE_PARALLEL_BEGIN(nc, tid, num * cb) {
+    const int n = nc / cb;
+    const int c = nc % cb;
+    const float* px = dinx + ((x_num == 1 ? 0 : n) * cb + c) *
+                                 static_cast<int64_t>(x_size) * 8;
+    const float* py = diny + ((y_num == 1 ? 0 : n) * cb + c) *
+                                 static_cast<int64_t>(y_size) * 8;
+    float* pout = dout + static_cast<int64_t>(nc) * size * 8;
+    const int x_step = x_size == 1 ? 0 : 8;
+    const int y_step = y_size == 1 ? 0 : 8;
+    for (int i = 0; i < size; ++i) {
+      __m256 vout = op(_mm256_loadu_ps(px), _mm256_loadu_ps(py));
+      if (fuse_relu) vout = _mm256_max_ps(vout, zero);
+      _mm256_storeu_ps(pout, vout);
+      px += x_step;
+      py += y_step;
+      pout += 8;
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+}  // namespace
+
+void nchw_to_nchwc8(
+    const float* din, float* dout, int num, int channel, int size) {
+  const int cb = nchwc8_blocks(channel);
+  LITE_PARALLEL_BEGIN(nc, tid, num * cb) {
+    const int n = nc / cb;
+    const int c0 = (nc % cb) * 8;
+    const int valid = std::min(8, channel - c0);
+    const float* src[8];
+    for (int c = 0; c < 8; ++c) {
+      // the padded channels read the first one and are zeroed below
+      src[c] = din + (static_cast<int64_t>(n) * channel + c0 +
+                      (c < valid ? c : 0)) *
+                         size;
+    }
+    float* out = dout + static_cast<int64_t>(nc) * size * 8;
+    int i = 0;
+    if (valid == 8) {
+      for (; i + 8 <= size; i += 8) {
+        __m256 r0 = _mm256_loadu_ps(src[0] + i);
+        __m256 r1 = _mm256_loadu_ps(src[1] + i);
+        __m256 r2 = _mm256_loadu_ps(src[2] + i);
+        __m256 r3 = _mm256_loadu_ps(src[3] + i);
+        __m256 r4 = _mm256_loadu_ps(src[4] + i);
+        __m256 r5 = _mm256_loadu_ps(src[5] + i);
+        __m256 r6 = _mm256_loadu_ps(src[6] + i);
+        __m256 r7 = _mm256_loadu_ps(src[7] + i);
+        transpose8_ps(r0, r1, r2, r3, r4, r5, r6, r7);
+        _mm256_storeu_ps(out + i * 8, r0);
+        _mm256_storeu_ps(out + i * 8 + 8, r1);
+        _mm256_storeu_ps(out + i * 8 + 16, r2);
+        _mm256_storeu_ps(out + i * 8 + 24, r3);
+        _mm256_storeu_ps(out + i * 8 + 32, r4);
+        _mm256_storeu_ps(out + i * 8 + 40, r5);
+        _mm256_storeu_ps(out + i * 8 + 48, r6);
+        _mm256_storeu_ps(out + i * 8 + 56, r7);
+      }
+    }
+    for (; i < size; ++i) {
+      for (int c = 0; c < 8; ++c) {
+        out[i * 8 + c] = c < valid ? src[c][i] : 0.f;
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+void nchwc8_to_nchw(
+    const float* din, float* dout, int num, int channel, int size) {
+  const int cb = nchwc8_blocks(channel);
+  LITE_PARALLEL_BEGIN(nc, tid, num * cb) {
+    const int n = nc / cb;
+    const int c0 = (nc % cb) * 8;
+    const int valid = std::min(8, channel - c0);
+    const float* in = din + static_cast<int64_t>(nc) * size * 8;
+    float* dst = dout + (static_cast<int64_t>(n) * channel + c0) * size;
+    int i = 0;
+    if (valid == 8) {
+      for (; i + 8 <= size; i += 8) {
+        __m256 r0 = _mm256_loadu_ps(in + i * 8);
+        __m256 r1 = _mm256_loadu_ps(in + i * 8 + 8);
+        __m256 r2 = _mm256_loadu_ps(in + i * 8 + 16);
+        __m256 r3 = _mm256_loadu_ps(in + i * 8 + 24);
+        __m256 r4 = _mm256_loadu_ps(in + i * 8 + 32);
+        __m256 r5 = _mm256_loadu_ps(in + i * 8 + 40);
+        __m256 r6 = _mm256_loadu_ps(in + i * 8 + 48);
+        __m256 r7 = _mm256_loadu_ps(in + i * 8 + 56);
+        transpose8_ps(r0, r1, r2, r3, r4, r5, r6, r7);
+        _mm256_storeu_ps(dst + i, r0);
+        _mm256_storeu_ps(dst + size + i, r1);
+        _mm256_storeu_ps(dst + 2 * size + i, r2);
+        _mm256_storeu_ps(dst + 3 * size + i, r3);
+        _mm256_storeu_ps(dst + 4 * size + i, r4);
+        _mm256_storeu_ps(dst + 5 * size + i, r5);
+        _mm256_storeu_ps(dst + 6 * size + i, r6);
+        _mm256_storeu_ps(dst + 7 * size + i, r7);
+      }
+    }
+    for (; i < size; ++i) {
+      for (int c = 0; c < valid; ++c) {
+        dst[c * size + i] = in[i * 8 + c];
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+int64_t conv_nchwc8_weights_size(
+    int chout, int chin_group, int kh, int kw, int groups) {
+  int64_t ocb = static_cast<int64_t>(groups) * nchwc8_blocks(chout / groups);
+  return ocb * nchwc8_blocks(chin_group) * kh * kw * 64;
+}
+
+void conv_nchwc8_trans_weights(const float* din,
+                               float* dout,
+                               int chout,
+                               int chin_group,
+                               int kh,
+                               int kw,
+                               int groups) {
+  const int chout_group = chout / groups;
+  const int ocb_group = nchwc8_blocks(chout_group);
+  const int icb = nchwc8_blocks(chin_group);
+  std::fill(dout,
+            dout + conv_nchwc8_weights_size(chout, chin_group, kh, kw, groups),
+            0.f);
+  for (int oc = 0; oc < chout; ++oc) {
+    const int g = oc / chout_group;
+    const int ocl = oc % chout_group;
+    const int64_t ob = static_cast<int64_t>(g) * ocb_group + ocl / 8;
+    for (int ic = 0; ic < chin_group; ++ic) {
+      for (int y = 0; y < kh; ++y) {
+        for (int x = 0; x < kw; ++x) {
+          int64_t idx = (((ob * icb + ic / 8) * kh + y) * kw + x) * 64 +
+                        (ic % 8) * 8 + ocl % 8;
+          dout[idx] = din[((static_cast<int64_t>(oc) * chin_group + ic) * kh +
+                           y) *
+                              kw +
+                          x];
+        }
+      }
+    }
+  }
+}
+
+void conv_depthwise_nchwc8_trans_weights(
+    const float* din, float* dout, int ch, int kh, int kw) {
+  const int cb = nchwc8_blocks(ch);
+  std::fill(dout, dout + static_cast<int64_t>(cb) * kh * kw * 8, 0.f);
+  for (int c = 0; c < ch; ++c) {
+    for (int k = 0; k < kh * kw; ++k) {
+      dout[((c / 8) * kh * kw + k) * 8 + c % 8] = din[c * kh * kw + k];
+    }
+  }
+}
+
+void conv_nchwc8(const float* din,
+                 float* dout,
+                 const float* weights,
+                 const float* bias,
+                 const operators::ConvParam& param) {
+  const int num = param.x->dims()[0];
+  const int groups = param.groups;
+  const int icb = nchwc8_blocks(param.filter->dims()[1]);
+  const int ocb_group = nchwc8_blocks(param.output->dims()[1] / groups);
+  const int icb_all = nchwc8_blocks(param.x->dims()[1]);
+  const int ocb_all = groups * ocb_group;
+  const auto s = conv_shape(param, icb);
+  const auto act = conv_act(param);
+  // pairs of output blocks of a group share the broadcasted inputs, in the
+  // lanes of an __m512 if the CPU supports AVX-512
+  const int pairs = (ocb_group + 1) / 2;
+  const bool avx512 = MayIUse(avx512f);
+  const int64_t in_batch = static_cast<int64_t>(icb_all) * s.ih * s.iw * 8;
+  const int64_t out_block = static_cast<int64_t>(s.oh) * s.ow * 8;
+  LITE_PARALLEL_BEGIN(task, tid, num * groups * pairs * s.oh) {
+    const int oy = task % s.oh;
+    const int p = task / s.oh % pairs;
+    const int g = task / s.oh / pairs % groups;
+    const int n = task / s.oh / pairs / groups;
+    const int ocb = g * ocb_group + p * 2;
+    const float* in = din + n * in_batch + g * icb * s.ih * s.iw * 8;
+    const float* w = weights + static_cast<int64_t>(ocb) * s.w_block;
+    float* out =
+        dout + (static_cast<int64_t>(n) * ocb_all + ocb) * out_block +
+        oy * s.ow * 8;
+    if (ocb_group - p * 2 >= 2 && avx512) {
+      conv_nchwc8_row<2, 12, true>(s, in, w, bias + ocb * 8, out, oy, act);
+    } else if (ocb_group - p * 2 >= 2) {
+      conv_nchwc8_row<2, 6>(s, in, w, bias + ocb * 8, out, oy, act);
+    } else {
+      conv_nchwc8_row<1, 8>(s, in, w, bias + ocb * 8, out, oy, act);
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+void conv_depthwise_nchwc8(const float* din,
+                           float* dout,
+                           const float* weights,
+                           const float* bias,
+                           const operators::ConvParam& param) {
+  const int num = param.x->dims()[0];
+  const int cb = nchwc8_blocks(param.x->dims()[1]);
+  const auto s = conv_shape(param, 1);
+  const auto act = conv_act(param);
+  int ox0 = 0;
+  int ox1 = 0;
+  interior_ox(s, &ox0, &ox1);
+  LITE_PARALLEL_BEGIN(task, tid, num * cb * s.oh) {
+    const int oy = task % s.oh;
+    const int nc = task / s.oh;
+    const int c = nc % cb;
+    const float* in = din + static_cast<int64_t>(nc) * s.ih * s.iw * 8;
+    const float* w = weights + c * s.kh * s.kw * 8;
+    float* out = dout + (static_cast<int64_t>(nc) * s.oh + oy) * s.ow * 8;
+    const __m256 vbias = _mm256_loadu_ps(bias + c * 8);
+    int kx0 = 0;
+    int kx1 = 0;
+    for (int ox = 0; ox < s.ow; ++ox) {
+      if (ox == ox0) {
+        for (; ox + 8 <= ox1; ox += 8) {
+          conv_depthwise_nchwc8_tile<8>(
+              s, in, w, vbias, out + ox * 8, oy, ox, 0, s.kw, act);
+        }
+        if (ox >= s.ow) break;
+      }
+      valid_kx(s, ox * s.sw - s.pw, &kx0, &kx1);
+      conv_depthwise_nchwc8_tile<1>(
+          s, in, w, vbias, out + ox * 8, oy, ox, kx0, kx1, act);
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+void pooling_nchwc8(const float* din,
+                    float* dout,
+                    int num,
+                    int channel,
+                    int hin,
+                    int win,
+                    int hout,
+                    int wout,
+                    const std::vector<int>& ksize,
+                    const std::vector<int>& strides,
+                    const std::vector<int>& paddings,
+                    bool is_max,
+                    bool exclusive,
+                    bool adaptive) {
+  const int cb = nchwc8_blocks(channel);
+  const int kh = ksize[0];
+  const int kw = ksize[1];
+  const int sh = strides[0];
+  const int sw = strides[1];
+  const int ph = paddings[0];
+  const int pw = paddings[2];
+  LITE_PARALLEL_BEGIN(task, tid, num * cb * hout) {
+    const int oy = task % hout;
+    const int nc = task / hout;
+    const float* in = din + static_cast<int64_t>(nc) * hin * win * 8;
+    float* out = dout + (static_cast<int64_t>(nc) * hout + oy) * wout * 8;
+    int hstart = 0;
+    int hend = 0;
+    if (adaptive) {
+      hstart = AdaptStartIndex(oy, hin, hout);
+      hend = AdaptEndIndex(oy, hin, hout);
+    } else {
+      hstart = oy * sh - ph;
+      hend = std::min(hstart + kh, hin);
+      hstart = std::max(hstart, 0);
+    }
+    for (int ox = 0; ox < wout; ++ox) {
+      int wstart = 0;
+      int wend = 0;
+      if (adaptive) {
+        wstart = AdaptStartIndex(ox, win, wout);
+        wend = AdaptEndIndex(ox, win, wout);
+      } else {
+        wstart = ox * sw - pw;
+        wend = std::min(wstart + kw, win);
+        wstart = std::max(wstart, 0);
+      }
+      __m256 vres = is_max ? _mm256_set1_ps(-FLT_MAX) : _mm256_setzero_ps();
+      for (int y = hstart; y < hend; ++y) {
+        const float* in_row = in + y * win * 8;
+        for (int x = wstart; x < wend; ++x) {
+          __m256 vin = _mm256_loadu_ps(in_row + x * 8);
+          vres = is_max ? _mm256_max_ps(vres, vin) : _mm256_add_ps(vres, vin);
+        }
+      }
+      if (!is_max) {
+        int pool_size = (exclusive || adaptive)
+                            ? (hend - hstart) * (wend - wstart)
+                            : kh * kw;
+        vres = _mm256_div_ps(vres,
+                             _mm256_set1_ps(static_cast<float>(pool_size)));
+      }
+      _mm256_storeu_ps(out + ox * 8, vres);
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+void channel_affine_nchwc8(const float* din,
+                           float* dout,
+                           const float* scale,
+                           const float* bias,
+                           int num,
+                           int channel,
+                           int size) {
+  const int cb = nchwc8_blocks(channel);
+  LITE_PARALLEL_BEGIN(nc, tid, num * cb) {
+    const int c = nc % cb;
+    const __m256 vscale = _mm256_loadu_ps(scale + c * 8);
+    const __m256 vbias = _mm256_loadu_ps(bias + c * 8);
+    const float* in = din + static_cast<int64_t>(nc) * size * 8;
+    float* out = dout + static_cast<int64_t>(nc) * size * 8;
+    for (int i = 0; i < size; ++i) {
+      _mm256_storeu_ps(
+          out + i * 8,
+          _mm256_fmadd_ps(_mm256_loadu_ps(in + i * 8), vscale, vbias));
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+void scale_nchwc8(
+    const float* din, float* dout, int64_t num, float scale, float bias) {
+  const __m256 vscale = _mm256_set1_ps(scale);
+  const __m256 vbias = _mm256_set1_ps(bias);
+  // the blocked buffers hold whole vectors
+  const int tasks =
+      static_cast<int>((num + kNCHWc8TaskSize - 1) / kNCHWc8TaskSize);
+  LITE_PARALLEL_BEGIN(task, tid, tasks) {
+    const int64_t end = std::min(num, (task + 1) * kNCHWc8TaskSize);
+    for (int64_t i = task * kNCHWc8TaskSize; i < end; i += 8) {
+      _mm256_storeu_ps(
+          dout + i, _mm256_fmadd_ps(_mm256_loadu_ps(din + i), vscale, vbias));
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+void elementwise_nchwc8(const float* dinx,
+                        const float* diny,
+                        float* dout,
+                        const std::string& op_type,
+                        int num,
+                        int channel,
+                        int size,
+                        int x_size,
+                        int x_num,
+                        int y_size,
+                        int y_num,
+                        bool fuse_relu) {
+  const int cb = nchwc8_blocks(channel);
+  if (op_type == "add") {
+    elementwise_nchwc8_impl(
+        dinx,
+        diny,
+        dout,
+        num,
+        cb,
+        size,
+        x_size,
+        x_num,
+        y_size,
+        y_num,
+        fuse_relu,
+        [](__m256 a, __m256 b) { return _mm256_add_ps(a, b); });
+  } else if (op_type == "sub") {
+    elementwise_nchwc8_impl(
+        dinx,
+        diny,
+        dout,
+        num,
+        cb,
+        size,
+        x_size,
+        x_num,
+        y_size,
+        y_num,
+        fuse_relu,
+        [](__m256 a, __m256 b) { return _mm256_sub_ps(a, b); });
+  } else if (op_type == "mul") {
+    elementwise_nchwc8_impl(
+        dinx,
+        diny,
+        dout,
+        num,
+        cb,
+        size,
+        x_size,
+        x_num,
+        y_size,
+        y_num,
+        fuse_relu,
+        [](__m256 a, __m256 b) { return _mm256_mul_ps(a, b); });
+  } else {
+    LOG(FATAL) << "[X86] NCHWc8 elementwise type not supported: " << op_type;
+  }
+}
+
+void act_nchwc8(const float* din,
+                float* dout,
+                int64_t num,
+                const operators::ActivationParam& param) {
+  const ActNCHWc8 act(param.active_type, param, param.threshold);
+  const int tasks =
+      static_cast<int>((num + kNCHWc8TaskSize - 1) / kNCHWc8TaskSize);
+  LITE_PARALLEL_BEGIN(task, tid, tasks) {
+    const int64_t end = std::min(num, (task + 1) * kNCHWc8TaskSize);
+    for (int64_t i = task * kNCHWc8TaskSize; i < end; i += 8) {
+      _mm256_storeu_ps(dout + i, act(_mm256_loadu_ps(din + i)));
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,142 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "lite/core/tensor.h"
+#include "lite/operators/op_params.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The NCHWc8 layout keeps the logical dims [N, C, H, W] of a tensor and stores
+// it as [N, C/8, H, W, 8]: the 8 channels of a block are the 8 lanes of an
+// __m256. C is rounded up to a multiple of 8, the padded channels hold finite
+// values (zeros after a conv) and the padded weights are zeros.
+const int kNCHWc8Block = 8;
+
+inline int nchwc8_blocks(int64_t channel) {
+  return static_cast<int>((channel + kNCHWc8Block - 1) / kNCHWc8Block);
+}
+
+// elements of a tensor of logical dims [N, C, ...] stored in NCHWc8
+inline int64_t nchwc8_size(const DDim& dims) {
+  CHECK_GE(dims.size(), 2u) << "NCHWc8 needs the dims [N, C, ...]";
+  return dims[0] * nchwc8_blocks(dims[1]) * kNCHWc8Block *
+         dims.count(2, dims.size());
+}
+
+// the blocked buffer of a tensor, its dims stay the logical ones
+inline float* nchwc8_mutable_data(lite::Tensor* tensor) {
+  return tensor->mutable_data<float>(
+      TARGET(kX86), nchwc8_size(tensor->dims()) * sizeof(float));
+}
+
+// [N, C, size] to [N, C/8, size, 8] and back
+void nchw_to_nchwc8(
+    const float* din, float* dout, int num, int channel, int size);
+void nchwc8_to_nchw(
+    const float* din, float* dout, int num, int channel, int size);
+
+// weights of conv, [chout, chin / groups, kh, kw] to
+// [chout/8, chin/groups/8, kh, kw, 8(chin), 8(chout)], the channels of a group
+// are multiples of 8 for groups > 1
+int64_t conv_nchwc8_weights_size(
+    int chout, int chin_group, int kh, int kw, int groups);
+void conv_nchwc8_trans_weights(const float* din,
+                               float* dout,
+                               int chout,
+                               int chin_group,
+                               int kh,
+                               int kw,
+                               int groups);
+// weights of depthwise conv, [ch, 1, kh, kw] to [ch/8, kh, kw, 8]
+void conv_depthwise_nchwc8_trans_weights(
+    const float* din, float* dout, int ch, int kh, int kw);
+
+// conv and depthwise conv (groups == chin == chout) of the blocked input of
+// param.x to the blocked param.output with the activation of
+// param.activation_param, bias has nchwc8_blocks(chout) * 8 elements. On the
+// CPUs with AVX-512 the conv computes a pair of output blocks in an __m512.
+void conv_nchwc8(const float* din,
+                 float* dout,
+                 const float* weights,
+                 const float* bias,
+                 const operators::ConvParam& param);
+void conv_depthwise_nchwc8(const float* din,
+                           float* dout,
+                           const float* weights,
+                           const float* bias,
+                           const operators::ConvParam& param);
+
+// pool2d as Pool2dFunctor, paddings are {top, bottom, left, right}
+void pooling_nchwc8(const float* din,
+                    float* dout,
+                    int num,
+                    int channel,
+                    int hin,
+                    int win,
+                    int hout,
+                    int wout,
+                    const std::vector<int>& ksize,
+                    const std::vector<int>& strides,
+                    const std::vector<int>& paddings,
+                    bool is_max,
+                    bool exclusive,
+                    bool adaptive);
+
+// dout = din * scale[c] + bias[c], scale and bias of nchwc8_blocks(channel) * 8
+void channel_affine_nchwc8(const float* din,
+                           float* dout,
+                           const float* scale,
+                           const float* bias,
+                           int num,
+                           int channel,
+                           int size);
+
+// dout = din * scale + bias over the num elements of the blocked buffers
+void scale_nchwc8(
+    const float* din, float* dout, int64_t num, float scale, float bias);
+
+// elementwise add, sub or mul of two blocked tensors of [N, C, size], x and y
+// are broadcasted over the spatial positions for x_size (y_size) of 1 and over
+// the batch for x_num (y_num) of 1
+void elementwise_nchwc8(const float* dinx,
+                        const float* diny,
+                        float* dout,
+                        const std::string& op_type,
+                        int num,
+                        int channel,
+                        int size,
+                        int x_size,
+                        int x_num,
+                        int y_size,
+                        int y_num,
+                        bool fuse_relu);
+
+// relu, relu6, leaky_relu, hard_swish and sigmoid over the num elements of the
+// blocked buffers
+void act_nchwc8(const float* din,
+                float* dout,
+                int64_t num,
+                const operators::ActivationParam& param);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
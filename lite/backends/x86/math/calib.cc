@@ -35,8 +35,8 @@ void fp32_to_int8(const float* din,
   int cnt = inner_size >> 4;
   int remain = inner_size & 15;
 #endif
-  int rem_cnt = remain >> 3;
-  int rem_rem = remain & 7;
+  int rem_cnt = remain >> 2;
+  int rem_rem = remain & 3;
   int64_t loop_size = outer_size * axis_size;
 #pragma omp parallel for
   for (int j = 0; j < loop_size; ++j) {
@@ -140,8 +140,8 @@ void fp32_to_int8(const float* din,
       __m128i vres0_16 = _mm_packs_epi32(vres0, vres0);
       __m128i vres0_8 = _mm_packs_epi16(vres0_16, vres0_16);
       *(reinterpret_cast<int*>(dout_c)) = _mm_extract_epi32(vres0_8, 0);
-      din_c += 8;
-      dout_c += 8;
+      din_c += 4;
+      dout_c += 4;
     }
     for (int i = 0; i < rem_rem; ++i) {
       dout_c[i] = saturate_cast<int8_t>(roundf(inv_scale * din_c[i]));
@@ -238,6 +238,30 @@ void int8_to_fp32(const int8_t* in,
   }
 }
 
+void int8_to_int8(const int8_t* din, int8_t* dout, float scale, int64_t size) {
+  int64_t i = 0;
+#ifdef __AVX2__
+  __m256 vscale = _mm256_set1_ps(scale);
+  __m256 vmin = _mm256_set1_ps(-127.f);
+  __m256 vmax = _mm256_set1_ps(127.f);
+  for (; i + 8 <= size; i += 8) {
+    __m256i vin = _mm256_cvtepi8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(din + i)));
+    __m256 vout = _mm256_mul_ps(_mm256_cvtepi32_ps(vin), vscale);
+    vout = _mm256_min_ps(_mm256_max_ps(vout, vmin), vmax);
+    __m256i vres = _mm256_cvtps_epi32(vout);
+    __m128i vres_16 = _mm_packs_epi32(_mm256_castsi256_si128(vres),
+                                      _mm256_extracti128_si256(vres, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dout + i),
+                     _mm_packs_epi16(vres_16, vres_16));
+  }
+#endif
+  for (; i < size; ++i) {
+    dout[i] = saturate_cast<int8_t>(roundf(din[i] * scale));
+    dout[i] = dout[i] < -127 ? -127 : dout[i];
+  }
+}
+
 }  // namespace math
 }  // namespace x86
 }  // namespace lite
@@ -37,6 +37,10 @@ void int8_to_fp32(const int8_t* in,
                   int64_t outer_size,
                   int64_t inner_size);
 
+// dout = din * scale clamped to [-127, 127], requantizes the int8 data of
+// the scale in_scale to out_scale for scale = in_scale / out_scale
+void int8_to_int8(const int8_t* din, int8_t* dout, float scale, int64_t size);
+
 }  // namespace math
 }  // namespace x86
 }  // namespace lite
@@ -0,0 +1,183 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lite/backends/x86/math/elementwise_int8.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include "lite/backends/x86/math/saturate.h"
+#include "lite/core/parallel_defines.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// the elements handled by a task of the same shape add
+const int64_t kBlockSize = 16384;
+
+inline void store_out(float v, float* out) { *out = v; }
+
+inline void store_out(float v, int8_t* out) {
+  int8_t res = saturate_cast<int8_t>(roundf(v));
+  *out = res < -127 ? -127 : res;
+}
+
+#ifdef __AVX2__
+inline __m256 load_int8(const int8_t* p) {
+  return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+}
+
+inline void store_out(__m256 v, float* out) { _mm256_storeu_ps(out, v); }
+
+inline void store_out(__m256 v, int8_t* out) {
+  v = _mm256_min_ps(_mm256_max_ps(v, _mm256_set1_ps(-127.f)),
+                    _mm256_set1_ps(127.f));
+  __m256i vres = _mm256_cvtps_epi32(v);
+  __m128i vres_16 = _mm_packs_epi32(_mm256_castsi256_si128(vres),
+                                    _mm256_extracti128_si256(vres, 1));
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(out),
+                   _mm_packs_epi16(vres_16, vres_16));
+}
+#endif
+
+// dout = x * x_scale + (y ? y * y_scale : y_bias) of size elements
+template <typename T>
+void add_row(const int8_t* x,
+             const int8_t* y,
+             float y_bias,
+             T* dout,
+             int64_t size,
+             float x_scale,
+             float y_scale,
+             bool relu) {
+  const float lower = relu ? 0.f : -FLT_MAX;
+  int64_t i = 0;
+#ifdef __AVX2__
+  __m256 vx_scale = _mm256_set1_ps(x_scale);
+  __m256 vy_scale = _mm256_set1_ps(y_scale);
+  __m256 vy_bias = _mm256_set1_ps(y_bias);
+  __m256 vlower = _mm256_set1_ps(lower);
+  for (; i + 8 <= size; i += 8) {
+    __m256 vy = y ? _mm256_mul_ps(load_int8(y + i), vy_scale) : vy_bias;
+    __m256 vout = _mm256_add_ps(_mm256_mul_ps(load_int8(x + i), vx_scale), vy);
+    store_out(_mm256_max_ps(vout, vlower), dout + i);
+  }
+#endif
+  for (; i < size; ++i) {
+    float vy = y ? y[i] * y_scale : y_bias;
+    store_out((std::max)(x[i] * x_scale + vy, lower), dout + i);
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void elementwise_add_int8(const int8_t* dinx,
+                          const int8_t* diny,
+                          T* dout,
+                          int64_t num,
+                          float x_scale,
+                          float y_scale,
+                          bool relu) {
+  const int blocks = static_cast<int>((num + kBlockSize - 1) / kBlockSize);
+  LITE_PARALLEL_BEGIN(b, tid, blocks) {
+    const int64_t begin = b * kBlockSize;
+    const int64_t size = (std::min)(kBlockSize, num - begin);
+    add_row(dinx + begin,
+            diny + begin,
+            0.f,
+            dout + begin,
+            size,
+            x_scale,
+            y_scale,
+            relu);
+  }
+  LITE_PARALLEL_END();
+}
+
+template <typename T>
+void elementwise_add_broadcast_int8(const int8_t* dinx,
+                                    const int8_t* diny,
+                                    T* dout,
+                                    int batch,
+                                    int channels,
+                                    int num,
+                                    float x_scale,
+                                    float y_scale,
+                                    bool relu) {
+  if (num == 1) {
+    LITE_PARALLEL_BEGIN(b, tid, batch) {
+      const int64_t offset = static_cast<int64_t>(b) * channels;
+      add_row(dinx + offset,
+              diny,
+              0.f,
+              dout + offset,
+              channels,
+              x_scale,
+              y_scale,
+              relu);
+    }
+    LITE_PARALLEL_END();
+    return;
+  }
+  LITE_PARALLEL_BEGIN(task, tid, batch * channels) {
+    const int64_t offset = static_cast<int64_t>(task) * num;
+    add_row<T>(dinx + offset,
+               nullptr,
+               diny[task % channels] * y_scale,
+               dout + offset,
+               num,
+               x_scale,
+               y_scale,
+               relu);
+  }
+  LITE_PARALLEL_END();
+}
+
+template void elementwise_add_int8<int8_t>(
+    const int8_t*, const int8_t*, int8_t*, int64_t, float, float, bool);
+template void elementwise_add_int8<float>(
+    const int8_t*, const int8_t*, float*, int64_t, float, float, bool);
+template void elementwise_add_broadcast_int8<int8_t>(const int8_t*,
+                                                     const int8_t*,
+                                                     int8_t*,
+                                                     int,
+                                                     int,
+                                                     int,
+                                                     float,
+                                                     float,
+                                                     bool);
+template void elementwise_add_broadcast_int8<float>(const int8_t*,
+                                                    const int8_t*,
+                                                    float*,
+                                                    int,
+                                                    int,
+                                                    int,
+                                                    float,
+                                                    float,
+                                                    bool);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,57 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <stdint.h>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * \brief elementwise_add of the int8 x and y:
+ *        dout = x * x_scale + y * y_scale, followed by relu if relu is true.
+ *        For the int8 dout the scales are divided by the output scale and the
+ *        sum is rounded and clamped to [-127, 127].
+ * elementwise_add_int8 adds two tensors of num elements,
+ * elementwise_add_broadcast_int8 adds y of [channels] to x of
+ * [batch, channels, num].
+ */
+template <typename T>
+void elementwise_add_int8(const int8_t* dinx,
+                          const int8_t* diny,
+                          T* dout,
+                          int64_t num,
+                          float x_scale,
+                          float y_scale,
+                          bool relu);
+
+template <typename T>
+void elementwise_add_broadcast_int8(const int8_t* dinx,
+                                    const int8_t* diny,
+                                    T* dout,
+                                    int batch,
+                                    int channels,
+                                    int num,
+                                    float x_scale,
+                                    float y_scale,
+                                    bool relu);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,254 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/multihead_attention.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include "lite/backends/x86/parallel.h"
+#include "lite/utils/log/cp_logging.h"
+#ifdef __AVX__
+#include <immintrin.h>
+#include "lite/backends/x86/math/avx/avx_mathfuns.h"
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The rows of Q sharing a block of K and V in the cache, and the rows of a
+// block of K and V.
+constexpr int kBlockQ = 32;
+constexpr int kBlockK = 128;
+
+#ifdef __AVX__
+inline float reduce_sum(__m256 x) {
+  __m128 s = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_add_ss(s, _mm_movehdup_ps(s));
+  return _mm_cvtss_f32(s);
+}
+#endif
+
+// out[j] = <q, k_j> of the 4 rows of K starting at k with a stride of ldk.
+inline void dot4(const float* q, const float* k, int ldk, int n, float* out) {
+  const float* k0 = k;
+  const float* k1 = k + ldk;
+  const float* k2 = k + 2 * ldk;
+  const float* k3 = k + 3 * ldk;
+  int d = 0;
+#ifdef __AVX__
+  __m256 s0 = _mm256_setzero_ps();
+  __m256 s1 = _mm256_setzero_ps();
+  __m256 s2 = _mm256_setzero_ps();
+  __m256 s3 = _mm256_setzero_ps();
+  for (; d + 8 <= n; d += 8) {
+    __m256 vq = _mm256_loadu_ps(q + d);
+    s0 = _mm256_fmadd_ps(vq, _mm256_loadu_ps(k0 + d), s0);
+    s1 = _mm256_fmadd_ps(vq, _mm256_loadu_ps(k1 + d), s1);
+    s2 = _mm256_fmadd_ps(vq, _mm256_loadu_ps(k2 + d), s2);
+    s3 = _mm256_fmadd_ps(vq, _mm256_loadu_ps(k3 + d), s3);
+  }
+  out[0] = reduce_sum(s0);
+  out[1] = reduce_sum(s1);
+  out[2] = reduce_sum(s2);
+  out[3] = reduce_sum(s3);
+#else
+  out[0] = out[1] = out[2] = out[3] = 0.f;
+#endif
+  for (; d < n; ++d) {
+    out[0] += q[d] * k0[d];
+    out[1] += q[d] * k1[d];
+    out[2] += q[d] * k2[d];
+    out[3] += q[d] * k3[d];
+  }
+}
+
+inline float dot(const float* q, const float* k, int n) {
+  int d = 0;
+  float sum = 0.f;
+#ifdef __AVX__
+  __m256 s = _mm256_setzero_ps();
+  for (; d + 8 <= n; d += 8) {
+    s = _mm256_fmadd_ps(_mm256_loadu_ps(q + d), _mm256_loadu_ps(k + d), s);
+  }
+  sum = reduce_sum(s);
+#endif
+  for (; d < n; ++d) sum += q[d] * k[d];
+  return sum;
+}
+
+// y = a * y + b * x
+inline void scale_axpy(float a, float* y, float b, const float* x, int n) {
+  int d = 0;
+#ifdef __AVX__
+  __m256 va = _mm256_set1_ps(a);
+  __m256 vb = _mm256_set1_ps(b);
+  for (; d + 8 <= n; d += 8) {
+    __m256 vy = _mm256_mul_ps(va, _mm256_loadu_ps(y + d));
+    _mm256_storeu_ps(y + d, _mm256_fmadd_ps(vb, _mm256_loadu_ps(x + d), vy));
+  }
+#endif
+  for (; d < n; ++d) y[d] = a * y[d] + b * x[d];
+}
+
+// x = exp(x - max), returns the sum of x.
+inline float exp_sub_sum(float* x, float max, int n) {
+  int j = 0;
+  float sum = 0.f;
+#ifdef __AVX__
+  __m256 vmax = _mm256_set1_ps(max);
+  __m256 vsum = _mm256_setzero_ps();
+  for (; j + 8 <= n; j += 8) {
+    __m256 e = exp256_ps(_mm256_sub_ps(_mm256_loadu_ps(x + j), vmax));
+    _mm256_storeu_ps(x + j, e);
+    vsum = _mm256_add_ps(vsum, e);
+  }
+  sum = reduce_sum(vsum);
+#endif
+  for (; j < n; ++j) {
+    x[j] = std::exp(x[j] - max);
+    sum += x[j];
+  }
+  return sum;
+}
+
+// Attention of the rows [row_begin, row_end) of one head of one sequence,
+// the pointers are already moved to the first row and to the head.
+void attention_rows(const float* q,
+                    const float* k,
+                    const float* v,
+                    const float* bias,
+                    int64_t bias_row_stride,
+                    float* out,
+                    int ld,
+                    int row_begin,
+                    int row_end,
+                    int seq_k,
+                    int head_size,
+                    float alpha) {
+  const float kLowest = -std::numeric_limits<float>::infinity();
+  float scores[kBlockK];
+  float row_max[kBlockQ];
+  float row_sum[kBlockQ];
+  const int rows = row_end - row_begin;
+  for (int i = 0; i < rows; ++i) {
+    row_max[i] = kLowest;
+    row_sum[i] = 0.f;
+    std::fill_n(
+        out + (row_begin + i) * static_cast<int64_t>(ld), head_size, 0.f);
+  }
+  for (int j0 = 0; j0 < seq_k; j0 += kBlockK) {
+    const int cols = (std::min)(kBlockK, seq_k - j0);
+    const float* kb = k + j0 * static_cast<int64_t>(ld);
+    const float* vb = v + j0 * static_cast<int64_t>(ld);
+    for (int i = 0; i < rows; ++i) {
+      const int64_t r = row_begin + i;
+      const float* qi = q + r * ld;
+      int j = 0;
+      for (; j + 4 <= cols; j += 4) {
+        dot4(qi, kb + j * static_cast<int64_t>(ld), ld, head_size, scores + j);
+      }
+      for (; j < cols; ++j) {
+        scores[j] = dot(qi, kb + j * static_cast<int64_t>(ld), head_size);
+      }
+      float block_max = kLowest;
+      const float* bi = bias ? bias + r * bias_row_stride + j0 : nullptr;
+      for (j = 0; j < cols; ++j) {
+        scores[j] = alpha * scores[j] + (bi ? bi[j] : 0.f);
+        block_max = (std::max)(block_max, scores[j]);
+      }
+      const float new_max = (std::max)(row_max[i], block_max);
+      // every score so far is masked with -inf
+      if (new_max == kLowest) continue;
+      // rescale what is accumulated with the previous maximum
+      const float correction = std::exp(row_max[i] - new_max);
+      const float sum = exp_sub_sum(scores, new_max, cols);
+      row_sum[i] = row_sum[i] * correction + sum;
+      row_max[i] = new_max;
+      float* oi = out + r * ld;
+      for (j = 0; j < cols; ++j) {
+        scale_axpy(j == 0 ? correction : 1.f,
+                   oi,
+                   scores[j],
+                   vb + j * static_cast<int64_t>(ld),
+                   head_size);
+      }
+    }
+  }
+  for (int i = 0; i < rows; ++i) {
+    float* oi = out + (row_begin + i) * static_cast<int64_t>(ld);
+    const float scale = row_sum[i] > 0.f ? 1.f / row_sum[i] : 0.f;
+    for (int d = 0; d < head_size; ++d) oi[d] *= scale;
+  }
+}
+
+}  // namespace
+
+void multihead_attention(const float* q,
+                         const float* k,
+                         const float* v,
+                         const float* bias_qk,
+                         const int64_t bias_strides[3],
+                         float* out,
+                         const std::vector<int64_t>& q_offsets,
+                         const std::vector<int64_t>& kv_offsets,
+                         int head_num,
+                         int head_size,
+                         float alpha) {
+  CHECK_EQ(q_offsets.size(), kv_offsets.size());
+  CHECK_GT(q_offsets.size(), 1UL);
+  const int64_t seq_num = static_cast<int64_t>(q_offsets.size()) - 1;
+  const int ld = head_num * head_size;
+  lite::x86::RunParallelFor(0, seq_num * head_num, [&](int64_t begin,
+                                                       int64_t end) {
+    for (int64_t task = begin; task < end; ++task) {
+      const int64_t seq = task / head_num;
+      const int head = static_cast<int>(task % head_num);
+      const int seq_q = static_cast<int>(q_offsets[seq + 1] - q_offsets[seq]);
+      const int seq_k = static_cast<int>(kv_offsets[seq + 1] - kv_offsets[seq]);
+      const int64_t q_base = q_offsets[seq] * ld + head * head_size;
+      const int64_t kv_base = kv_offsets[seq] * ld + head * head_size;
+      const float* bias = nullptr;
+      int64_t bias_row_stride = 0;
+      if (bias_qk) {
+        bias = bias_qk + seq * bias_strides[0] + head * bias_strides[1];
+        bias_row_stride = bias_strides[2];
+      }
+      for (int i0 = 0; i0 < seq_q; i0 += kBlockQ) {
+        attention_rows(q + q_base,
+                       k + kv_base,
+                       v + kv_base,
+                       bias,
+                       bias_row_stride,
+                       out + q_base,
+                       ld,
+                       i0,
+                       (std::min)(i0 + kBlockQ, seq_q),
+                       seq_k,
+                       head_size,
+                       alpha);
+      }
+    }
+  });
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,54 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * out = softmax(alpha * Q * K^T + bias_qk) * V of every head, where Q, K, V
+ * and out are row-major with head_num * head_size columns and head h owns the
+ * columns [h * head_size, (h + 1) * head_size).
+ *
+ * The i-th sequence takes the rows [q_offsets[i], q_offsets[i + 1]) of Q and
+ * attends to the rows [kv_offsets[i], kv_offsets[i + 1]) of K and V. The rows
+ * of Q are processed in blocks against blocks of K and V with an online
+ * softmax, so the scores of a whole sequence are never stored.
+ *
+ * bias_qk may be null, otherwise the bias of the score (row r, column c) of
+ * sequence i and head h is bias_qk[i * bias_strides[0] + h * bias_strides[1]
+ * + r * bias_strides[2] + c], a zero stride broadcasts it.
+ */
+void multihead_attention(const float* q,
+                         const float* k,
+                         const float* v,
+                         const float* bias_qk,
+                         const int64_t bias_strides[3],
+                         float* out,
+                         const std::vector<int64_t>& q_offsets,
+                         const std::vector<int64_t>& kv_offsets,
+                         int head_num,
+                         int head_size,
+                         float alpha);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,725 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/packed_sgemm.h"
+#include <algorithm>
+#include <cstring>
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/backends/x86/parallel.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define SGEMM_WITH_AVX2
+// The AVX-512 kernel is compiled for its own functions only and called if
+// the CPU supports it.
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define SGEMM_WITH_AVX512
+#if defined(__GNUC__) && !defined(__AVX512F__)
+#define SGEMM_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define SGEMM_TARGET_AVX512
+#endif
+#endif
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The panels of A computed with a panel of B while it stays in L1.
+constexpr int MC_PANELS = 16;
+constexpr int MAX_NR = 32;
+
+inline int RoundUp(int x, int y) { return (x + y - 1) / y * y; }
+
+enum ActMode { kActNone = 0, kActRelu, kActRelu6, kActLeaky, kActHardSwish };
+
+struct KernelEpilogue {
+  float alpha;
+  int act;
+  float clip;
+  float leaky;
+  float threshold;
+  float inv_scale;
+  float offset;
+};
+
+KernelEpilogue MakeKernelEpilogue(const SgemmEpilogue& ep) {
+  KernelEpilogue res;
+  res.alpha = ep.alpha;
+  switch (ep.act_type) {
+    case lite_api::ActivationType::kRelu:
+      res.act = kActRelu;
+      break;
+    case lite_api::ActivationType::kRelu6:
+      res.act = kActRelu6;
+      break;
+    case lite_api::ActivationType::kLeakyRelu:
+      res.act = kActLeaky;
+      break;
+    case lite_api::ActivationType::kHardSwish:
+      res.act = kActHardSwish;
+      break;
+    default:
+      res.act = kActNone;
+  }
+  res.clip = ep.relu_clipped_coef;
+  res.leaky = ep.leaky_relu_alpha;
+  res.threshold = ep.hard_swish_threshold;
+  res.inv_scale = 1.f / ep.hard_swish_scale;
+  res.offset = ep.hard_swish_offset;
+  return res;
+}
+
+inline float ActScalar(float x, const KernelEpilogue& ep) {
+  switch (ep.act) {
+    case kActRelu:
+      return x > 0.f ? x : 0.f;
+    case kActRelu6:
+      return (std::min)((std::max)(x, 0.f), ep.clip);
+    case kActLeaky:
+      return x > 0.f ? x : x * ep.leaky;
+    case kActHardSwish:
+      return x * (std::min)((std::max)(x + ep.offset, 0.f), ep.threshold) *
+             ep.inv_scale;
+    default:
+      return x;
+  }
+}
+
+// Computes the tile of `ROWS` x NR from the panels `a` and `b` of `kc`, adds
+// the tile already in `c` if `accumulate`, and applies `ep` if not nullptr.
+// The panel of an int8 or int16 B is converted in registers and the sums of
+// the tile are scaled by `b_scale` of its columns, nullptr for a float B.
+template <typename TB>
+using MicroKernel = void (*)(int kc,
+                             const float* a,
+                             const TB* b,
+                             const float* b_scale,
+                             float* c,
+                             int ldc,
+                             bool accumulate,
+                             const KernelEpilogue* ep,
+                             const float* row_bias,
+                             const float* col_bias);
+
+template <int ROWS, int NR, typename TB>
+void KernelRef(int kc,
+               const float* a,
+               const TB* b,
+               const float* b_scale,
+               float* c,
+               int ldc,
+               bool accumulate,
+               const KernelEpilogue* ep,
+               const float* row_bias,
+               const float* col_bias) {
+  float acc[ROWS][NR] = {};
+  for (int p = 0; p < kc; ++p) {
+    for (int r = 0; r < ROWS; ++r) {
+      for (int j = 0; j < NR; ++j) acc[r][j] += a[r] * b[j];
+    }
+    a += SGEMM_MR;
+    b += NR;
+  }
+  for (int r = 0; r < ROWS; ++r) {
+    float* cr = c + r * ldc;
+    for (int j = 0; j < NR; ++j) {
+      if (b_scale) acc[r][j] *= b_scale[j];
+      float v = accumulate ? acc[r][j] + cr[j] : acc[r][j];
+      if (ep) {
+        v *= ep->alpha;
+        if (row_bias) v += row_bias[r];
+        if (col_bias) v += col_bias[j];
+        v = ActScalar(v, *ep);
+      }
+      cr[j] = v;
+    }
+  }
+}
+
+#ifdef SGEMM_WITH_AVX2
+inline __m256 ActAvx2(__m256 x, const KernelEpilogue& ep) {
+  __m256 zero = _mm256_setzero_ps();
+  switch (ep.act) {
+    case kActRelu:
+      return _mm256_max_ps(x, zero);
+    case kActRelu6:
+      return _mm256_min_ps(_mm256_max_ps(x, zero), _mm256_set1_ps(ep.clip));
+    case kActLeaky: {
+      __m256 mask = _mm256_cmp_ps(x, zero, _CMP_GT_OS);
+      return _mm256_blendv_ps(
+          _mm256_mul_ps(x, _mm256_set1_ps(ep.leaky)), x, mask);
+    }
+    case kActHardSwish: {
+      __m256 t = _mm256_min_ps(
+          _mm256_max_ps(_mm256_add_ps(x, _mm256_set1_ps(ep.offset)), zero),
+          _mm256_set1_ps(ep.threshold));
+      return _mm256_mul_ps(_mm256_mul_ps(x, t), _mm256_set1_ps(ep.inv_scale));
+    }
+    default:
+      return x;
+  }
+}
+
+inline __m256 LoadAvx2(const float* b) { return _mm256_loadu_ps(b); }
+
+inline __m256 LoadAvx2(const int8_t* b) {
+  return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b))));
+}
+
+inline __m256 LoadAvx2(const int16_t* b) {
+  return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(b))));
+}
+
+// The accumulators are named variables instead of arrays, which the compiler
+// may keep in memory.
+#define SGEMM_DECLARE_ACC(type, zero) \
+  type c00 = zero, c01 = zero;        \
+  type c10 = zero, c11 = zero;        \
+  type c20 = zero, c21 = zero;        \
+  type c30 = zero, c31 = zero;        \
+  type c40 = zero, c41 = zero;        \
+  type c50 = zero, c51 = zero;
+
+#define SGEMM_FMA_ROW(r, set1, fmadd)      \
+  if (ROWS > r) {                          \
+    auto va = set1(a[r]);                  \
+    c##r##0 = fmadd(va, b0, c##r##0);      \
+    c##r##1 = fmadd(va, b1, c##r##1);      \
+  }
+
+#define SGEMM_STORE_ROW(r, store, nr)      \
+  if (ROWS > r) {                          \
+    store(res + r * nr, c##r##0);          \
+    store(res + r * nr + nr / 2, c##r##1); \
+  }
+
+#define SGEMM_FOR_ROWS(macro, ...) \
+  macro(0, __VA_ARGS__);           \
+  macro(1, __VA_ARGS__);           \
+  macro(2, __VA_ARGS__);           \
+  macro(3, __VA_ARGS__);           \
+  macro(4, __VA_ARGS__);           \
+  macro(5, __VA_ARGS__);
+
+template <int ROWS, typename TB>
+void KernelAvx2(int kc,
+                const float* a,
+                const TB* b,
+                const float* b_scale,
+                float* c,
+                int ldc,
+                bool accumulate,
+                const KernelEpilogue* ep,
+                const float* row_bias,
+                const float* col_bias) {
+  SGEMM_DECLARE_ACC(__m256, _mm256_setzero_ps())
+  for (int p = 0; p < kc; ++p) {
+    __m256 b0 = LoadAvx2(b);
+    __m256 b1 = LoadAvx2(b + 8);
+    SGEMM_FOR_ROWS(SGEMM_FMA_ROW, _mm256_set1_ps, _mm256_fmadd_ps)
+    a += SGEMM_MR;
+    b += 16;
+  }
+  alignas(32) float res[ROWS * 16];
+  SGEMM_FOR_ROWS(SGEMM_STORE_ROW, _mm256_store_ps, 16)
+  for (int r = 0; r < ROWS; ++r) {
+    float* cr = c + r * ldc;
+    __m256 v0 = _mm256_load_ps(res + r * 16);
+    __m256 v1 = _mm256_load_ps(res + r * 16 + 8);
+    if (b_scale) {
+      v0 = _mm256_mul_ps(v0, _mm256_loadu_ps(b_scale));
+      v1 = _mm256_mul_ps(v1, _mm256_loadu_ps(b_scale + 8));
+    }
+    if (accumulate) {
+      v0 = _mm256_add_ps(v0, _mm256_loadu_ps(cr));
+      v1 = _mm256_add_ps(v1, _mm256_loadu_ps(cr + 8));
+    }
+    if (ep) {
+      __m256 alpha = _mm256_set1_ps(ep->alpha);
+      v0 = _mm256_mul_ps(v0, alpha);
+      v1 = _mm256_mul_ps(v1, alpha);
+      if (row_bias) {
+        __m256 bias = _mm256_set1_ps(row_bias[r]);
+        v0 = _mm256_add_ps(v0, bias);
+        v1 = _mm256_add_ps(v1, bias);
+      }
+      if (col_bias) {
+        v0 = _mm256_add_ps(v0, _mm256_loadu_ps(col_bias));
+        v1 = _mm256_add_ps(v1, _mm256_loadu_ps(col_bias + 8));
+      }
+      v0 = ActAvx2(v0, *ep);
+      v1 = ActAvx2(v1, *ep);
+    }
+    _mm256_storeu_ps(cr, v0);
+    _mm256_storeu_ps(cr + 8, v1);
+  }
+}
+#endif  // SGEMM_WITH_AVX2
+
+#ifdef SGEMM_WITH_AVX512
+SGEMM_TARGET_AVX512 inline __m512 ActAvx512(__m512 x,
+                                            const KernelEpilogue& ep) {
+  __m512 zero = _mm512_setzero_ps();
+  switch (ep.act) {
+    case kActRelu:
+      return _mm512_max_ps(x, zero);
+    case kActRelu6:
+      return _mm512_min_ps(_mm512_max_ps(x, zero), _mm512_set1_ps(ep.clip));
+    case kActLeaky: {
+      __mmask16 mask = _mm512_cmp_ps_mask(x, zero, _CMP_LT_OS);
+      return _mm512_mask_mul_ps(x, mask, x, _mm512_set1_ps(ep.leaky));
+    }
+    case kActHardSwish: {
+      __m512 t = _mm512_min_ps(
+          _mm512_max_ps(_mm512_add_ps(x, _mm512_set1_ps(ep.offset)), zero),
+          _mm512_set1_ps(ep.threshold));
+      return _mm512_mul_ps(_mm512_mul_ps(x, t), _mm512_set1_ps(ep.inv_scale));
+    }
+    default:
+      return x;
+  }
+}
+
+SGEMM_TARGET_AVX512 inline __m512 LoadAvx512(const float* b) {
+  return _mm512_loadu_ps(b);
+}
+
+SGEMM_TARGET_AVX512 inline __m512 LoadAvx512(const int8_t* b) {
+  return _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(b))));
+}
+
+SGEMM_TARGET_AVX512 inline __m512 LoadAvx512(const int16_t* b) {
+  return _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b))));
+}
+
+template <int ROWS, typename TB>
+SGEMM_TARGET_AVX512 void KernelAvx512(int kc,
+                                      const float* a,
+                                      const TB* b,
+                                      const float* b_scale,
+                                      float* c,
+                                      int ldc,
+                                      bool accumulate,
+                                      const KernelEpilogue* ep,
+                                      const float* row_bias,
+                                      const float* col_bias) {
+  SGEMM_DECLARE_ACC(__m512, _mm512_setzero_ps())
+  for (int p = 0; p < kc; ++p) {
+    __m512 b0 = LoadAvx512(b);
+    __m512 b1 = LoadAvx512(b + 16);
+    SGEMM_FOR_ROWS(SGEMM_FMA_ROW, _mm512_set1_ps, _mm512_fmadd_ps)
+    a += SGEMM_MR;
+    b += 32;
+  }
+  alignas(64) float res[ROWS * 32];
+  SGEMM_FOR_ROWS(SGEMM_STORE_ROW, _mm512_store_ps, 32)
+  for (int r = 0; r < ROWS; ++r) {
+    float* cr = c + r * ldc;
+    __m512 v0 = _mm512_load_ps(res + r * 32);
+    __m512 v1 = _mm512_load_ps(res + r * 32 + 16);
+    if (b_scale) {
+      v0 = _mm512_mul_ps(v0, _mm512_loadu_ps(b_scale));
+      v1 = _mm512_mul_ps(v1, _mm512_loadu_ps(b_scale + 16));
+    }
+    if (accumulate) {
+      v0 = _mm512_add_ps(v0, _mm512_loadu_ps(cr));
+      v1 = _mm512_add_ps(v1, _mm512_loadu_ps(cr + 16));
+    }
+    if (ep) {
+      __m512 alpha = _mm512_set1_ps(ep->alpha);
+      v0 = _mm512_mul_ps(v0, alpha);
+      v1 = _mm512_mul_ps(v1, alpha);
+      if (row_bias) {
+        __m512 bias = _mm512_set1_ps(row_bias[r]);
+        v0 = _mm512_add_ps(v0, bias);
+        v1 = _mm512_add_ps(v1, bias);
+      }
+      if (col_bias) {
+        v0 = _mm512_add_ps(v0, _mm512_loadu_ps(col_bias));
+        v1 = _mm512_add_ps(v1, _mm512_loadu_ps(col_bias + 16));
+      }
+      v0 = ActAvx512(v0, *ep);
+      v1 = ActAvx512(v1, *ep);
+    }
+    _mm512_storeu_ps(cr, v0);
+    _mm512_storeu_ps(cr + 16, v1);
+  }
+}
+#endif  // SGEMM_WITH_AVX512
+
+#ifdef SGEMM_WITH_AVX2
+#undef SGEMM_DECLARE_ACC
+#undef SGEMM_FMA_ROW
+#undef SGEMM_STORE_ROW
+#undef SGEMM_FOR_ROWS
+#endif
+
+template <typename TB>
+struct KernelSet {
+  int nr;
+  // kernels[rows - 1] computes a tile of `rows`
+  MicroKernel<TB> kernels[SGEMM_MR];
+};
+
+template <typename TB>
+KernelSet<TB> SelectKernels() {
+#ifdef SGEMM_WITH_AVX512
+  if (MayIUse(avx512f)) {
+    return {32,
+            {KernelAvx512<1, TB>,
+             KernelAvx512<2, TB>,
+             KernelAvx512<3, TB>,
+             KernelAvx512<4, TB>,
+             KernelAvx512<5, TB>,
+             KernelAvx512<6, TB>}};
+  }
+#endif
+#ifdef SGEMM_WITH_AVX2
+  // The library is built for AVX2 then, it needs no check at runtime.
+  return {16,
+          {KernelAvx2<1, TB>,
+           KernelAvx2<2, TB>,
+           KernelAvx2<3, TB>,
+           KernelAvx2<4, TB>,
+           KernelAvx2<5, TB>,
+           KernelAvx2<6, TB>}};
+#else
+  return {16,
+          {KernelRef<1, 16, TB>,
+           KernelRef<2, 16, TB>,
+           KernelRef<3, 16, TB>,
+           KernelRef<4, 16, TB>,
+           KernelRef<5, 16, TB>,
+           KernelRef<6, 16, TB>}};
+#endif
+}
+
+template <typename TB>
+const KernelSet<TB>& Kernels() {
+  static const KernelSet<TB> kernels = SelectKernels<TB>();
+  return kernels;
+}
+
+}  // namespace
+
+SgemmEpilogue::SgemmEpilogue(const float* bias,
+                             bool bias_per_col,
+                             const operators::ActivationParam& act_param)
+    : bias(bias), bias_per_col(bias_per_col) {
+  if (act_param.has_active) act_type = act_param.active_type;
+  relu_clipped_coef = act_param.Relu_clipped_coef;
+  leaky_relu_alpha = act_param.Leaky_relu_alpha;
+  hard_swish_threshold = act_param.hard_swish_threshold;
+  hard_swish_scale = act_param.hard_swish_scale;
+  hard_swish_offset = act_param.hard_swish_offset;
+}
+
+bool SgemmEpilogue::Supports(lite_api::ActivationType act_type) {
+  return act_type == lite_api::ActivationType::kIndentity ||
+         act_type == lite_api::ActivationType::kRelu ||
+         act_type == lite_api::ActivationType::kRelu6 ||
+         act_type == lite_api::ActivationType::kLeakyRelu ||
+         act_type == lite_api::ActivationType::kHardSwish;
+}
+
+int sgemm_nr() { return Kernels<float>().nr; }
+
+size_t sgemm_packed_a_size(int m, int k) {
+  return static_cast<size_t>(RoundUp(m, SGEMM_MR)) * k;
+}
+
+size_t sgemm_packed_b_size(int k, int n) {
+  return static_cast<size_t>(RoundUp(n, sgemm_nr())) * k;
+}
+
+void sgemm_pack_a(
+    bool trans, int m, int k, const float* a, int lda, float* packed_a) {
+  const int mp = RoundUp(m, SGEMM_MR);
+  for (int k0 = 0; k0 < k; k0 += SGEMM_KC) {
+    const int kc = (std::min)(SGEMM_KC, k - k0);
+    float* block = packed_a + static_cast<int64_t>(k0) * mp;
+    RunParallelFor(0, mp / SGEMM_MR, [&](int64_t begin, int64_t end) {
+      for (int64_t p = begin; p < end; ++p) {
+        float* out = block + p * SGEMM_MR * kc;
+        const int i0 = static_cast<int>(p) * SGEMM_MR;
+        const int rows = (std::min)(SGEMM_MR, m - i0);
+        for (int kk = 0; kk < kc; ++kk) {
+          for (int i = 0; i < rows; ++i) {
+            out[i] = trans ? a[static_cast<int64_t>(k0 + kk) * lda + i0 + i]
+                           : a[static_cast<int64_t>(i0 + i) * lda + k0 + kk];
+          }
+          for (int i = rows; i < SGEMM_MR; ++i) out[i] = 0.f;
+          out += SGEMM_MR;
+        }
+      }
+    });
+  }
+}
+
+namespace {
+
+template <typename T>
+void PackB(bool trans, int k, int n, const T* b, int ldb, T* packed_b) {
+  const int nr = sgemm_nr();
+  const int np = RoundUp(n, nr);
+  for (int k0 = 0; k0 < k; k0 += SGEMM_KC) {
+    const int kc = (std::min)(SGEMM_KC, k - k0);
+    T* block = packed_b + static_cast<int64_t>(k0) * np;
+    RunParallelFor(0, np / nr, [&](int64_t begin, int64_t end) {
+      for (int64_t q = begin; q < end; ++q) {
+        T* out = block + q * nr * kc;
+        const int j0 = static_cast<int>(q) * nr;
+        const int cols = (std::min)(nr, n - j0);
+        for (int kk = 0; kk < kc; ++kk) {
+          if (!trans) {
+            std::memcpy(out,
+                        b + static_cast<int64_t>(k0 + kk) * ldb + j0,
+                        cols * sizeof(T));
+          } else {
+            for (int j = 0; j < cols; ++j) {
+              out[j] = b[static_cast<int64_t>(j0 + j) * ldb + k0 + kk];
+            }
+          }
+          for (int j = cols; j < nr; ++j) out[j] = T(0);
+          out += nr;
+        }
+      }
+    });
+  }
+}
+
+template <typename TB>
+void PrepackedImpl(int m,
+                   int n,
+                   int k,
+                   const float* packed_a,
+                   const TB* packed_b,
+                   const float* b_scale,
+                   float* c,
+                   int ldc,
+                   const SgemmEpilogue& epilogue) {
+  if (m <= 0 || n <= 0) return;
+  CHECK_GT(k, 0) << "sgemm with an empty K.";
+  const auto& kernels = Kernels<TB>();
+  const int nr = kernels.nr;
+  const int mp = RoundUp(m, SGEMM_MR);
+  const int np = RoundUp(n, nr);
+  const int m_panels = mp / SGEMM_MR;
+  const KernelEpilogue ep = MakeKernelEpilogue(epilogue);
+  const float* row_bias = epilogue.bias_per_col ? nullptr : epilogue.bias;
+  const float* col_bias = epilogue.bias_per_col ? epilogue.bias : nullptr;
+
+  // Every thread computes the columns of its panels of B.
+  RunParallelFor(0, np / nr, [&](int64_t begin, int64_t end) {
+    float tile[SGEMM_MR * MAX_NR];
+    float col_bias_pad[MAX_NR];
+    float b_scale_pad[MAX_NR];
+    for (int k0 = 0; k0 < k; k0 += SGEMM_KC) {
+      const int kc = (std::min)(SGEMM_KC, k - k0);
+      const bool accumulate = k0 > 0;
+      const KernelEpilogue* tile_ep = k0 + kc >= k ? &ep : nullptr;
+      const float* a_block = packed_a + static_cast<int64_t>(k0) * mp;
+      const TB* b_block = packed_b + static_cast<int64_t>(k0) * np;
+      for (int mb = 0; mb < m_panels; mb += MC_PANELS) {
+        const int mb_end = (std::min)(m_panels, mb + MC_PANELS);
+        for (int64_t q = begin; q < end; ++q) {
+          const int j0 = static_cast<int>(q) * nr;
+          const int cols = (std::min)(nr, n - j0);
+          const TB* b_panel = b_block + q * nr * kc;
+          const float* tile_b_scale = b_scale ? b_scale + j0 : nullptr;
+          if (b_scale && cols < nr) {
+            std::memcpy(b_scale_pad, b_scale + j0, cols * sizeof(float));
+            std::fill(b_scale_pad + cols, b_scale_pad + nr, 0.f);
+            tile_b_scale = b_scale_pad;
+          }
+          const float* tile_col_bias = nullptr;
+          if (col_bias) {
+            if (cols == nr) {
+              tile_col_bias = col_bias + j0;
+            } else {
+              std::memcpy(col_bias_pad, col_bias + j0, cols * sizeof(float));
+              std::fill(col_bias_pad + cols, col_bias_pad + nr, 0.f);
+              tile_col_bias = col_bias_pad;
+            }
+          }
+          for (int p = mb; p < mb_end; ++p) {
+            const int i0 = p * SGEMM_MR;
+            const int rows = (std::min)(SGEMM_MR, m - i0);
+            const float* a_panel = a_block + static_cast<int64_t>(p) *
+                                                 SGEMM_MR * kc;
+            const float* tile_row_bias = row_bias ? row_bias + i0 : nullptr;
+            float* c_tile = c + static_cast<int64_t>(i0) * ldc + j0;
+            auto kernel = kernels.kernels[rows - 1];
+            if (cols == nr) {
+              kernel(kc,
+                     a_panel,
+                     b_panel,
+                     tile_b_scale,
+                     c_tile,
+                     ldc,
+                     accumulate,
+                     tile_ep,
+                     tile_row_bias,
+                     tile_col_bias);
+              continue;
+            }
+            // The last columns are computed in a full tile and copied.
+            if (accumulate) {
+              for (int r = 0; r < rows; ++r) {
+                std::memcpy(tile + r * nr,
+                            c_tile + static_cast<int64_t>(r) * ldc,
+                            cols * sizeof(float));
+              }
+            }
+            kernel(kc,
+                   a_panel,
+                   b_panel,
+                   tile_b_scale,
+                   tile,
+                   nr,
+                   accumulate,
+                   tile_ep,
+                   tile_row_bias,
+                   tile_col_bias);
+            for (int r = 0; r < rows; ++r) {
+              std::memcpy(c_tile + static_cast<int64_t>(r) * ldc,
+                          tile + r * nr,
+                          cols * sizeof(float));
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+}  // namespace
+
+void sgemm_pack_b(
+    bool trans, int k, int n, const float* b, int ldb, float* packed_b) {
+  PackB(trans, k, n, b, ldb, packed_b);
+}
+
+void sgemm_pack_b(
+    bool trans, int k, int n, const int8_t* b, int ldb, int8_t* packed_b) {
+  PackB(trans, k, n, b, ldb, packed_b);
+}
+
+void sgemm_pack_b(
+    bool trans, int k, int n, const int16_t* b, int ldb, int16_t* packed_b) {
+  PackB(trans, k, n, b, ldb, packed_b);
+}
+
+void sgemm_prepacked(int m,
+                     int n,
+                     int k,
+                     const float* packed_a,
+                     const float* packed_b,
+                     float* c,
+                     int ldc,
+                     const SgemmEpilogue& epilogue) {
+  PrepackedImpl(m, n, k, packed_a, packed_b, nullptr, c, ldc, epilogue);
+}
+
+void sgemm_prepacked(int m,
+                     int n,
+                     int k,
+                     const float* packed_a,
+                     const int8_t* packed_b,
+                     const float* b_scale,
+                     float* c,
+                     int ldc,
+                     const SgemmEpilogue& epilogue) {
+  CHECK(b_scale);
+  PrepackedImpl(m, n, k, packed_a, packed_b, b_scale, c, ldc, epilogue);
+}
+
+void sgemm_prepacked(int m,
+                     int n,
+                     int k,
+                     const float* packed_a,
+                     const int16_t* packed_b,
+                     const float* b_scale,
+                     float* c,
+                     int ldc,
+                     const SgemmEpilogue& epilogue) {
+  CHECK(b_scale);
+  PrepackedImpl(m, n, k, packed_a, packed_b, b_scale, c, ldc, epilogue);
+}
+
+void packed_sgemm(bool trans_a,
+                  bool trans_b,
+                  int m,
+                  int n,
+                  int k,
+                  const float* a,
+                  int lda,
+                  const float* b,
+                  int ldb,
+                  float* c,
+                  int ldc,
+                  const SgemmEpilogue& epilogue,
+                  Tensor* workspace) {
+  CHECK(workspace);
+  size_t a_size = sgemm_packed_a_size(m, k);
+  size_t b_size = sgemm_packed_b_size(k, n);
+  workspace->Resize({static_cast<int64_t>(a_size + b_size)});
+  float* packed_a = workspace->mutable_data<float>();
+  float* packed_b = packed_a + a_size;
+  sgemm_pack_a(trans_a, m, k, a, lda, packed_a);
+  sgemm_pack_b(trans_b, k, n, b, ldb, packed_b);
+  sgemm_prepacked(m, n, k, packed_a, packed_b, c, ldc, epilogue);
+}
+
+void sgemm_epilogue(int m, int n, float* c, int ldc, const SgemmEpilogue& ep) {
+  const KernelEpilogue kep = MakeKernelEpilogue(ep);
+  if (kep.alpha == 1.f && ep.bias == nullptr && kep.act == kActNone) return;
+  RunParallelFor(0, m, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      float* row = c + i * ldc;
+      float row_bias = (ep.bias && !ep.bias_per_col) ? ep.bias[i] : 0.f;
+      const float* col_bias = ep.bias_per_col ? ep.bias : nullptr;
+      int j = 0;
+#ifdef SGEMM_WITH_AVX2
+      __m256 alpha = _mm256_set1_ps(kep.alpha);
+      __m256 vrow_bias = _mm256_set1_ps(row_bias);
+      for (; j + 7 < n; j += 8) {
+        __m256 v = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(row + j), alpha),
+                                 vrow_bias);
+        if (col_bias) v = _mm256_add_ps(v, _mm256_loadu_ps(col_bias + j));
+        _mm256_storeu_ps(row + j, ActAvx2(v, kep));
+      }
+#endif
+      for (; j < n; ++j) {
+        float v = row[j] * kep.alpha + row_bias;
+        if (col_bias) v += col_bias[j];
+        row[j] = ActScalar(v, kep);
+      }
+    }
+  });
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,127 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "lite/core/tensor.h"
+#include "lite/operators/op_params.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * A row-major float GEMM C = alpha * A * B on operands packed into panels:
+ * A into panels of SGEMM_MR rows, B into panels of sgemm_nr() columns, both
+ * split along K into blocks of SGEMM_KC. The micro-kernel computes a tile of
+ * SGEMM_MR x sgemm_nr() in registers with AVX-512 (nr = 32) or AVX2 (nr = 16),
+ * chosen at runtime, and applies the epilogue before storing the tile.
+ */
+constexpr int SGEMM_MR = 6;
+constexpr int SGEMM_KC = 256;
+
+// The epilogue of C = alpha * A * B: the bias is added, then the activation.
+struct SgemmEpilogue {
+  float alpha{1.f};
+  const float* bias{nullptr};
+  // the bias is indexed by the column (fc) instead of the row (conv)
+  bool bias_per_col{false};
+  lite_api::ActivationType act_type{lite_api::ActivationType::kIndentity};
+  float relu_clipped_coef{6.f};
+  float leaky_relu_alpha{0.f};
+  float hard_swish_threshold{6.f};
+  float hard_swish_scale{6.f};
+  float hard_swish_offset{3.f};
+
+  SgemmEpilogue() = default;
+  SgemmEpilogue(const float* bias,
+                bool bias_per_col,
+                const operators::ActivationParam& act_param);
+
+  // identity, relu, relu6, leaky_relu and hard_swish are fused
+  static bool Supports(lite_api::ActivationType act_type);
+};
+
+// The columns of a panel of the packed B.
+int sgemm_nr();
+
+// The number of elements of the packed m x k matrix A or k x n matrix B.
+size_t sgemm_packed_a_size(int m, int k);
+size_t sgemm_packed_b_size(int k, int n);
+
+// Packs A (m x k) or B (k x n), `trans` if the memory holds the transpose.
+void sgemm_pack_a(
+    bool trans, int m, int k, const float* a, int lda, float* packed_a);
+void sgemm_pack_b(
+    bool trans, int k, int n, const float* b, int ldb, float* packed_b);
+// B quantized per column, packed as the float B.
+void sgemm_pack_b(
+    bool trans, int k, int n, const int8_t* b, int ldb, int8_t* packed_b);
+void sgemm_pack_b(
+    bool trans, int k, int n, const int16_t* b, int ldb, int16_t* packed_b);
+
+void sgemm_prepacked(int m,
+                     int n,
+                     int k,
+                     const float* packed_a,
+                     const float* packed_b,
+                     float* c,
+                     int ldc,
+                     const SgemmEpilogue& epilogue);
+
+// C = alpha * A * (B * b_scale) with the int8 or int16 packed B and the scale
+// of each of its n columns: the micro-kernel converts B in registers, so B
+// stays quantized in memory.
+void sgemm_prepacked(int m,
+                     int n,
+                     int k,
+                     const float* packed_a,
+                     const int8_t* packed_b,
+                     const float* b_scale,
+                     float* c,
+                     int ldc,
+                     const SgemmEpilogue& epilogue);
+void sgemm_prepacked(int m,
+                     int n,
+                     int k,
+                     const float* packed_a,
+                     const int16_t* packed_b,
+                     const float* b_scale,
+                     float* c,
+                     int ldc,
+                     const SgemmEpilogue& epilogue);
+
+// Packs both operands into `workspace` and runs sgemm_prepacked.
+void packed_sgemm(bool trans_a,
+                  bool trans_b,
+                  int m,
+                  int n,
+                  int k,
+                  const float* a,
+                  int lda,
+                  const float* b,
+                  int ldb,
+                  float* c,
+                  int ldc,
+                  const SgemmEpilogue& epilogue,
+                  Tensor* workspace);
+
+// Applies the epilogue to the result of another GEMM in place.
+void sgemm_epilogue(int m, int n, float* c, int ldc, const SgemmEpilogue& ep);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,267 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/packed_weight.h"
+#include <algorithm>
+#include <map>
+#include <mutex>  // NOLINT
+#include <tuple>
+#include "lite/backends/x86/math/blas.h"
+#include "lite/core/memory.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The weights are looked up by their precision, side, shape and address. A
+// packed weight shares the buffer of its matrix, the address can not be reused
+// by another weight as long as it is cached. The quantized weights are released
+// once packed, the address of their tensor is used instead.
+using Key = std::tuple<int, bool, int, int, int, const void*>;
+
+std::mutex& CacheMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::map<Key, std::weak_ptr<const PackedWeight>>& Cache() {
+  static std::map<Key, std::weak_ptr<const PackedWeight>> cache;
+  return cache;
+}
+
+// The cached weight of `key` accepted by `match`, or the one made by
+// `create` and cached.
+template <typename MatchFn, typename CreateFn>
+std::shared_ptr<const PackedWeight> GetOrCreate(const Key& key,
+                                                MatchFn match,
+                                                CreateFn create) {
+  std::lock_guard<std::mutex> lock(CacheMutex());
+  auto& cache = Cache();
+  auto it = cache.find(key);
+  if (it != cache.end()) {
+    auto packed = it->second.lock();
+    if (packed && match(*packed)) return packed;
+  }
+  // drop the released weights
+  for (auto iter = cache.begin(); iter != cache.end();) {
+    iter = iter->second.expired() ? cache.erase(iter) : ++iter;
+  }
+  std::shared_ptr<const PackedWeight> packed = create();
+  cache[key] = packed;
+  return packed;
+}
+
+}  // namespace
+
+std::shared_ptr<const PackedWeight> PackedWeight::Get(const X86Context& ctx,
+                                                      bool left,
+                                                      int rows,
+                                                      int cols,
+                                                      const Tensor& weight,
+                                                      const float* src,
+                                                      int ld) {
+  CHECK(src);
+  Key key(
+      static_cast<int>(PRECISION(kFloat)), left, rows, cols, ld, src);
+  auto match = [](const PackedWeight&) { return true; };
+  return GetOrCreate(key, match, [&]() {
+    std::shared_ptr<PackedWeight> packed(
+        new PackedWeight(left, rows, cols, PRECISION(kFloat)));
+    packed->weight_.ShareDataWith(weight);
+#ifdef PADDLE_WITH_MKLML
+    auto blas = GetBlas<TARGET(kX86), float>(ctx);
+    float* data = left ? blas.GEMM_ALLOC(CblasAMatrix, rows, 1, cols)
+                       : blas.GEMM_ALLOC(CblasBMatrix, 1, cols, rows);
+    packed->data_ = data;
+    if (left) {
+      blas.GEMM_PACK(
+          CblasAMatrix, CblasNoTrans, rows, 1, cols, 1.f, src, ld, data);
+    } else {
+      blas.GEMM_PACK(
+          CblasBMatrix, CblasNoTrans, 1, cols, rows, 1.f, src, ld, data);
+    }
+#else
+    size_t size = left ? sgemm_packed_a_size(rows, cols)
+                       : sgemm_packed_b_size(rows, cols);
+    float* data = static_cast<float*>(TargetMalloc(
+        TARGET(kX86), (std::max)(size, size_t(1)) * sizeof(float)));
+    packed->data_ = data;
+    if (left) {
+      sgemm_pack_a(false, rows, cols, src, ld, data);
+    } else {
+      sgemm_pack_b(false, rows, cols, src, ld, data);
+    }
+#endif
+    return packed;
+  });
+}
+
+template <typename T>
+std::shared_ptr<const PackedWeight> PackedWeight::GetQuantized(
+    int rows, int cols, Tensor* weight, const float* scale) {
+  CHECK(weight);
+  CHECK(scale);
+  const PrecisionType precision =
+      sizeof(T) == 1 ? PRECISION(kInt8) : PRECISION(kInt16);
+  Key key(static_cast<int>(precision), false, rows, cols, cols, weight);
+  // A tensor holding data is a weight not packed yet, even if the tensor of a
+  // released weight had the same address. The kernels may pass other scales
+  // for the same weight.
+  const bool released = !weight->IsInitialized();
+  auto match = [&](const PackedWeight& packed) {
+    return released &&
+           std::equal(packed.scale_.begin(), packed.scale_.end(), scale);
+  };
+  auto packed = GetOrCreate(key, match, [&]() {
+    CHECK(!released) << "The quantized weight is released once packed, it "
+                        "can not be packed again with other scales.";
+    std::shared_ptr<PackedWeight> packed(
+        new PackedWeight(false, rows, cols, precision));
+    size_t size = sgemm_packed_b_size(rows, cols);
+    T* data = static_cast<T*>(
+        TargetMalloc(TARGET(kX86), (std::max)(size, size_t(1)) * sizeof(T)));
+    packed->data_ = data;
+    sgemm_pack_b(false, rows, cols, weight->data<T>(), cols, data);
+    packed->scale_.assign(scale, scale + cols);
+    return packed;
+  });
+  weight->clear();
+  return packed;
+}
+
+std::shared_ptr<const PackedWeight> PackedWeight::GetQuantized(
+    int rows, int cols, Tensor* weight, const std::vector<float>& scale) {
+  CHECK(weight);
+  CHECK(scale.size() == 1 || scale.size() == static_cast<size_t>(cols))
+      << "The quantized weight needs 1 or " << cols << " scales, but got "
+      << scale.size();
+  std::vector<float> col_scale(scale);
+  col_scale.resize(cols, scale[0]);
+  if (weight->precision() == PRECISION(kInt8)) {
+    return GetQuantized<int8_t>(rows, cols, weight, col_scale.data());
+  }
+  CHECK(weight->precision() == PRECISION(kInt16))
+      << "The quantized weight is int8 or int16, but got "
+      << lite_api::PrecisionToStr(weight->precision());
+  return GetQuantized<int16_t>(rows, cols, weight, col_scale.data());
+}
+
+PackedWeight::~PackedWeight() {
+  if (data_ == nullptr) return;
+#ifdef PADDLE_WITH_MKLML
+  if (precision_ == PRECISION(kFloat)) {
+    CBlas<float>::GEMM_FREE(static_cast<float*>(data_));
+  } else {
+    TargetFree(TARGET(kX86), data_);
+  }
+#else
+  TargetFree(TARGET(kX86), data_);
+#endif
+}
+
+void PackedWeight::Compute(const X86Context& ctx,
+                           int other_dim,
+                           const float* other,
+                           int ld_other,
+                           float* c,
+                           int ldc,
+                           const SgemmEpilogue& epilogue,
+                           Tensor* workspace) const {
+  const int m = left_ ? rows_ : other_dim;
+  const int n = left_ ? other_dim : cols_;
+  const int k = left_ ? cols_ : rows_;
+  if (precision_ != PRECISION(kFloat)) {
+    // the quantized weights are the packed B of the sgemm in all builds
+    CHECK(workspace);
+    workspace->Resize({static_cast<int64_t>(sgemm_packed_a_size(m, k))});
+    float* packed_a = workspace->mutable_data<float>();
+    sgemm_pack_a(false, m, k, other, ld_other, packed_a);
+    if (precision_ == PRECISION(kInt8)) {
+      sgemm_prepacked(m,
+                      n,
+                      k,
+                      packed_a,
+                      static_cast<const int8_t*>(data_),
+                      scale_.data(),
+                      c,
+                      ldc,
+                      epilogue);
+    } else {
+      sgemm_prepacked(m,
+                      n,
+                      k,
+                      packed_a,
+                      static_cast<const int16_t*>(data_),
+                      scale_.data(),
+                      c,
+                      ldc,
+                      epilogue);
+    }
+    return;
+  }
+  float* data = static_cast<float*>(data_);
+#ifdef PADDLE_WITH_MKLML
+  auto blas = GetBlas<TARGET(kX86), float>(ctx);
+  if (left_) {
+    blas.GEMM_COMPUTE(CblasPacked,
+                      CblasNoTrans,
+                      m,
+                      n,
+                      k,
+                      data,
+                      k,
+                      other,
+                      ld_other,
+                      0.f,
+                      c,
+                      ldc);
+  } else {
+    blas.GEMM_COMPUTE(CblasNoTrans,
+                      CblasPacked,
+                      m,
+                      n,
+                      k,
+                      other,
+                      ld_other,
+                      data,
+                      n,
+                      0.f,
+                      c,
+                      ldc);
+  }
+  sgemm_epilogue(m, n, c, ldc, epilogue);
+#else
+  CHECK(workspace);
+  // pack the other operand
+  size_t size =
+      left_ ? sgemm_packed_b_size(k, n) : sgemm_packed_a_size(m, k);
+  workspace->Resize({static_cast<int64_t>(size)});
+  float* packed_other = workspace->mutable_data<float>();
+  if (left_) {
+    sgemm_pack_b(false, k, n, other, ld_other, packed_other);
+    sgemm_prepacked(m, n, k, data, packed_other, c, ldc, epilogue);
+  } else {
+    sgemm_pack_a(false, m, k, other, ld_other, packed_other);
+    sgemm_prepacked(m, n, k, packed_other, data, c, ldc, epilogue);
+  }
+#endif
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,110 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "lite/backends/x86/math/packed_sgemm.h"
+#include "lite/core/context.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * PackedWeight is a constant operand of a row-major float GEMM, packed once
+ * into the blocked layout of the GEMM micro-kernel so that the kernels do not
+ * pack it again on every call: the packed GEMM of MKL if available, the
+ * packed sgemm of packed_sgemm.h otherwise.
+ *
+ * Packed weights are shared by the kernels packing the same matrix of the same
+ * weight tensor, e.g. the kernels of cloned predictors, which share their
+ * weights, and released with the last of them.
+ *
+ * The int8 and int16 weights of the dynamic quantized models (a scale per
+ * column) are kept quantized in the packed sgemm and converted to float a
+ * panel at a time by the GEMM. The packed copy replaces the weight, whose
+ * memory is released, so they take a quarter or a half of the memory of the
+ * float weights.
+ */
+class PackedWeight {
+ public:
+  // Packs the `rows` x `cols` matrix `src` with the leading dimension `ld` as
+  // the left (A) or the right (B) operand, `src` points into the data of
+  // `weight`.
+  static std::shared_ptr<const PackedWeight> Get(const X86Context& ctx,
+                                                 bool left,
+                                                 int rows,
+                                                 int cols,
+                                                 const Tensor& weight,
+                                                 const float* src,
+                                                 int ld);
+
+  // Packs the int8 or int16 `rows` x `cols` `weight` quantized by
+  // post_quant_dynamic_pass with 1 or `cols` scales as the right (B) operand,
+  // then releases the memory of `weight`, which keeps its shape. The kernels
+  // of a released weight get the packed one.
+  static std::shared_ptr<const PackedWeight> GetQuantized(
+      int rows, int cols, Tensor* weight, const std::vector<float>& scale);
+
+  ~PackedWeight();
+
+  // C = A * B followed by `epilogue`, where the weight is A or B and the
+  // other operand has `other_dim` columns (B) or rows (A). The other operand
+  // is packed into `workspace` if needed.
+  void Compute(const X86Context& ctx,
+               int other_dim,
+               const float* other,
+               int ld_other,
+               float* c,
+               int ldc,
+               const SgemmEpilogue& epilogue,
+               Tensor* workspace) const;
+
+  bool left() const { return left_; }
+  int rows() const { return rows_; }
+  int cols() const { return cols_; }
+  PrecisionType precision() const { return precision_; }
+
+ private:
+  PackedWeight(bool left, int rows, int cols, PrecisionType precision)
+      : left_(left), rows_(rows), cols_(cols), precision_(precision) {}
+
+  // GetQuantized of the int8_t or int16_t weight and a scale per column
+  template <typename T>
+  static std::shared_ptr<const PackedWeight> GetQuantized(int rows,
+                                                          int cols,
+                                                          Tensor* weight,
+                                                          const float* scale);
+
+  bool left_;
+  int rows_;
+  int cols_;
+  PrecisionType precision_;
+  // float, int8_t or int16_t as precision_
+  void* data_{nullptr};
+  // the scales of the columns of a quantized weight
+  std::vector<float> scale_;
+  // shares the buffer of the packed float matrix, so that its address, which
+  // is a part of the key of the packed weight, is not reused by another weight
+  Tensor weight_;
+};
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
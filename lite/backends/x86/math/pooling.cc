@@ -14,7 +14,16 @@ limitations under the License. */
 
 #include "lite/backends/x86/math/pooling.h"
 #include <algorithm>
+#include <cfloat>
 #include <vector>
+#include "lite/backends/x86/math/saturate.h"
+#include "lite/core/parallel_defines.h"
+
+#ifdef __AVX__
+#include <immintrin.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
 
 namespace paddle {
 namespace lite {
@@ -904,6 +913,469 @@ template class MaxPool3dWithIndexFunctor<lite::TargetType::kX86, double, int>;
 template class MaxPool3dWithIndexGradFunctor<lite::TargetType::kX86,
                                              double,
                                              int>;
+
+namespace {
+
+// the window of one pooled dim
+struct PoolDim {
+  int in;
+  int out;
+  int ksize;
+  int stride;
+  int pad;
+
+  // [start, end) of the window of the output index i, clipped to the input
+  void window(int i, bool adaptive, int* start, int* end) const {
+    if (adaptive) {
+      *start = AdaptStartIndex(i, in, out);
+      *end = AdaptEndIndex(i, in, out);
+    } else {
+      *start = i * stride - pad;
+      *end = (std::min)(*start + ksize, in);
+      *start = (std::max)(*start, 0);
+    }
+  }
+
+  // [begin, end) of the output indices whose windows are inside the input
+  void interior(bool adaptive, int* begin, int* end) const {
+    *begin = out;
+    *end = out;
+    if (!adaptive) {
+      *begin = (std::min)((pad + stride - 1) / stride, out);
+      *end = in + pad - ksize >= 0
+                 ? (std::min)((in + pad - ksize) / stride + 1, out)
+                 : 0;
+      *end = (std::max)(*end, *begin);
+    }
+  }
+};
+
+template <bool IS_MAX>
+inline float pool_op(float a, float b) {
+  return IS_MAX ? (a > b ? a : b) : a + b;
+}
+
+#if defined(__AVX__) || defined(__SSE__)
+#define POOLING_WITH_SIMD
+#ifdef __AVX__
+struct PoolVec {
+  typedef __m256 type;
+  static const int kLanes = 8;
+  static type load(const float* p) { return _mm256_loadu_ps(p); }
+  static void store(float* p, type v) { _mm256_storeu_ps(p, v); }
+  static type max(type a, type b) { return _mm256_max_ps(a, b); }
+  static type add(type a, type b) { return _mm256_add_ps(a, b); }
+  static type set1(float a) { return _mm256_set1_ps(a); }
+  // p[0], p[2], ..., p[14]
+  static type even(const float* p) {
+    __m256 a = _mm256_loadu_ps(p);
+    __m256 b = _mm256_loadu_ps(p + 8);
+    __m256 lo = _mm256_permute2f128_ps(a, b, 0x20);
+    __m256 hi = _mm256_permute2f128_ps(a, b, 0x31);
+    return _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+  }
+};
+#else
+struct PoolVec {
+  typedef __m128 type;
+  static const int kLanes = 4;
+  static type load(const float* p) { return _mm_loadu_ps(p); }
+  static void store(float* p, type v) { _mm_storeu_ps(p, v); }
+  static type max(type a, type b) { return _mm_max_ps(a, b); }
+  static type add(type a, type b) { return _mm_add_ps(a, b); }
+  static type set1(float a) { return _mm_set1_ps(a); }
+  // p[0], p[2], p[4], p[6]
+  static type even(const float* p) {
+    return _mm_shuffle_ps(
+        _mm_loadu_ps(p), _mm_loadu_ps(p + 4), _MM_SHUFFLE(2, 0, 2, 0));
+  }
+};
+#endif
+
+template <bool IS_MAX>
+inline PoolVec::type pool_op(PoolVec::type a, PoolVec::type b) {
+  return IS_MAX ? PoolVec::max(a, b) : PoolVec::add(a, b);
+}
+
+// kLanes output columns from the input columns at ptr, the window width is
+// KSIZE, or ksize for KSIZE 0
+template <bool IS_MAX, int STRIDE, int KSIZE>
+inline PoolVec::type pool_block(const float* ptr,
+                                int width,
+                                int hstart,
+                                int hend,
+                                int ksize,
+                                PoolVec::type acc) {
+  const int kw = KSIZE > 0 ? KSIZE : ksize;
+  for (int h = hstart; h < hend; ++h) {
+    const float* row = ptr + h * width;
+    for (int k = 0; k < kw; ++k) {
+      acc = pool_op<IS_MAX>(
+          acc, STRIDE == 1 ? PoolVec::load(row + k) : PoolVec::even(row + k));
+    }
+  }
+  return acc;
+}
+
+// the interior output columns [begin, end) of one output row, a block reads
+// (kLanes - 1) * STRIDE + ksize + STRIDE - 1 input columns from its first
+template <bool IS_MAX, int STRIDE, int KSIZE>
+int pool_row_simd(const float* plane,
+                  const PoolDim& w,
+                  int hstart,
+                  int hend,
+                  int begin,
+                  int end,
+                  float* acc) {
+  const int lanes = PoolVec::kLanes;
+  const int span = (lanes - 1) * STRIDE + w.ksize + STRIDE - 1;
+  int ow = begin;
+  for (; ow + lanes <= end && ow * STRIDE - w.pad + span <= w.in;
+       ow += lanes) {
+    PoolVec::type v = pool_block<IS_MAX, STRIDE, KSIZE>(
+        plane + ow * STRIDE - w.pad,
+        w.in,
+        hstart,
+        hend,
+        w.ksize,
+        PoolVec::load(acc + ow));
+    PoolVec::store(acc + ow, v);
+  }
+  return ow;
+}
+#endif  // __AVX__ || __SSE__
+
+// folds the window rows [hstart, hend) of one input plane into the wout
+// values of acc, an output row
+template <bool IS_MAX>
+void pool_row(const float* plane,
+              const PoolDim& w,
+              int hstart,
+              int hend,
+              bool adaptive,
+              float* acc) {
+  int begin, end;
+  w.interior(adaptive, &begin, &end);
+  auto pool_scalar = [&](int ow) {
+    int wstart, wend;
+    w.window(ow, adaptive, &wstart, &wend);
+    float res = acc[ow];
+    for (int h = hstart; h < hend; ++h) {
+      const float* row = plane + h * w.in;
+      for (int iw = wstart; iw < wend; ++iw) {
+        res = pool_op<IS_MAX>(res, row[iw]);
+      }
+    }
+    acc[ow] = res;
+  };
+  for (int ow = 0; ow < begin; ++ow) {
+    pool_scalar(ow);
+  }
+  int ow = begin;
+#ifdef POOLING_WITH_SIMD
+  if (w.stride == 1) {
+    if (w.ksize == 3) {
+      ow = pool_row_simd<IS_MAX, 1, 3>(plane, w, hstart, hend, ow, end, acc);
+    } else {
+      ow = pool_row_simd<IS_MAX, 1, 0>(plane, w, hstart, hend, ow, end, acc);
+    }
+  } else if (w.stride == 2) {
+    if (w.ksize == 2) {
+      ow = pool_row_simd<IS_MAX, 2, 2>(plane, w, hstart, hend, ow, end, acc);
+    } else if (w.ksize == 3) {
+      ow = pool_row_simd<IS_MAX, 2, 3>(plane, w, hstart, hend, ow, end, acc);
+    } else {
+      ow = pool_row_simd<IS_MAX, 2, 0>(plane, w, hstart, hend, ow, end, acc);
+    }
+  }
+#endif
+  for (; ow < w.out; ++ow) {
+    pool_scalar(ow);
+  }
+}
+
+// max or sum of the size contiguous elements of din
+template <bool IS_MAX>
+float pool_reduce(const float* din, int64_t size) {
+  float res = IS_MAX ? -FLT_MAX : 0.f;
+  int64_t i = 0;
+#ifdef POOLING_WITH_SIMD
+  const int lanes = PoolVec::kLanes;
+  if (size >= 2 * lanes) {
+    PoolVec::type acc0 = PoolVec::set1(res);
+    PoolVec::type acc1 = acc0;
+    for (; i + 2 * lanes <= size; i += 2 * lanes) {
+      acc0 = pool_op<IS_MAX>(acc0, PoolVec::load(din + i));
+      acc1 = pool_op<IS_MAX>(acc1, PoolVec::load(din + i + lanes));
+    }
+    float lane[PoolVec::kLanes];
+    PoolVec::store(lane, pool_op<IS_MAX>(acc0, acc1));
+    for (int j = 0; j < lanes; ++j) {
+      res = pool_op<IS_MAX>(res, lane[j]);
+    }
+  }
+#endif
+  for (; i < size; ++i) {
+    res = pool_op<IS_MAX>(res, din[i]);
+  }
+  return res;
+}
+
+template <bool IS_MAX>
+void pooling_impl(const float* din,
+                  float* dout,
+                  int num_channel,
+                  const PoolDim& d,
+                  const PoolDim& h,
+                  const PoolDim& w,
+                  bool exclusive,
+                  bool adaptive) {
+  const int64_t in_plane = static_cast<int64_t>(h.in) * w.in;
+  const int64_t in_size = d.in * in_plane;
+  const int64_t out_plane = static_cast<int64_t>(h.out) * w.out;
+  const int64_t out_size = d.out * out_plane;
+  auto is_global = [&](const PoolDim& dim) {
+    return dim.out == 1 &&
+           (adaptive || (dim.ksize == dim.in && dim.pad == 0));
+  };
+  if (is_global(d) && is_global(h) && is_global(w)) {
+    LITE_PARALLEL_BEGIN(c, tid, num_channel) {
+      float res = pool_reduce<IS_MAX>(din + c * in_size, in_size);
+      dout[c] = IS_MAX ? res : res / in_size;
+    }
+    LITE_PARALLEL_END();
+    return;
+  }
+
+  const float init = IS_MAX ? -FLT_MAX : 0.f;
+  const int full_size = d.ksize * h.ksize * w.ksize;
+  LITE_PARALLEL_BEGIN(task, tid, num_channel * d.out * h.out) {
+    const int oh = task % h.out;
+    const int od = (task / h.out) % d.out;
+    const int c = task / (h.out * d.out);
+    int dstart, dend, hstart, hend;
+    d.window(od, adaptive, &dstart, &dend);
+    h.window(oh, adaptive, &hstart, &hend);
+    const float* plane = din + c * in_size;
+    float* acc = dout + c * out_size + od * out_plane + oh * w.out;
+    for (int ow = 0; ow < w.out; ++ow) {
+      acc[ow] = init;
+    }
+    for (int id = dstart; id < dend; ++id) {
+      pool_row<IS_MAX>(plane + id * in_plane, w, hstart, hend, adaptive, acc);
+    }
+    if (!IS_MAX) {
+      const int rows = (dend - dstart) * (hend - hstart);
+      auto pool_divide = [&](int ow) {
+        int pool_size = full_size;
+        if (exclusive || adaptive) {
+          int wstart, wend;
+          w.window(ow, adaptive, &wstart, &wend);
+          pool_size = rows * (wend - wstart);
+        }
+        acc[ow] /= pool_size;
+      };
+      int begin, end;
+      w.interior(adaptive, &begin, &end);
+      for (int ow = 0; ow < begin; ++ow) {
+        pool_divide(ow);
+      }
+      // the windows of the interior have the full width
+      const float scale = 1.f / (exclusive ? rows * w.ksize : full_size);
+      for (int ow = begin; ow < end; ++ow) {
+        acc[ow] *= scale;
+      }
+      for (int ow = end; ow < w.out; ++ow) {
+        pool_divide(ow);
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+inline void pool_store(float v, float* dout) { *dout = v; }
+
+inline void pool_store(float v, int8_t* dout) {
+  int8_t res = saturate_cast<int8_t>(roundf(v));
+  *dout = res < -127 ? -127 : res;
+}
+
+// the window rows of an output row are folded into the int32 columns first,
+// then the windows of the columns into the outputs
+template <bool IS_MAX, typename T>
+void pooling_int8_impl(const int8_t* din,
+                       T* dout,
+                       int num_channel,
+                       const PoolDim& h,
+                       const PoolDim& w,
+                       bool exclusive,
+                       bool adaptive,
+                       float scale) {
+  const int64_t in_size = static_cast<int64_t>(h.in) * w.in;
+  const int64_t out_size = static_cast<int64_t>(h.out) * w.out;
+  const int init = IS_MAX ? -128 : 0;
+  auto is_global = [&](const PoolDim& dim) {
+    return dim.out == 1 &&
+           (adaptive || (dim.ksize == dim.in && dim.pad == 0));
+  };
+  if (is_global(h) && is_global(w)) {
+    LITE_PARALLEL_BEGIN(c, tid, num_channel) {
+      const int8_t* plane = din + c * in_size;
+      int res = init;
+      for (int64_t i = 0; i < in_size; ++i) {
+        res = IS_MAX ? (std::max)(res, static_cast<int>(plane[i]))
+                     : res + plane[i];
+      }
+      pool_store(IS_MAX ? res * scale : res * scale / in_size, dout + c);
+    }
+    LITE_PARALLEL_END();
+    return;
+  }
+
+  const int full_size = h.ksize * w.ksize;
+  LITE_PARALLEL_BEGIN(c, tid, num_channel) {
+    std::vector<int> col(w.in);
+    const int8_t* plane = din + c * in_size;
+    T* out = dout + c * out_size;
+    for (int oh = 0; oh < h.out; ++oh) {
+      int hstart, hend;
+      h.window(oh, adaptive, &hstart, &hend);
+      for (int iw = 0; iw < w.in; ++iw) {
+        col[iw] = init;
+      }
+      for (int ih = hstart; ih < hend; ++ih) {
+        const int8_t* row = plane + ih * w.in;
+        for (int iw = 0; iw < w.in; ++iw) {
+          col[iw] = IS_MAX ? (std::max)(col[iw], static_cast<int>(row[iw]))
+                           : col[iw] + row[iw];
+        }
+      }
+      for (int ow = 0; ow < w.out; ++ow) {
+        int wstart, wend;
+        w.window(ow, adaptive, &wstart, &wend);
+        int res = init;
+        for (int iw = wstart; iw < wend; ++iw) {
+          res = IS_MAX ? (std::max)(res, col[iw]) : res + col[iw];
+        }
+        float pool_size = 1.f;
+        if (!IS_MAX) {
+          pool_size = full_size;
+          if (exclusive || adaptive) {
+            pool_size = (hend - hstart) * (wend - wstart);
+          }
+        }
+        pool_store(res * scale / pool_size, out + oh * w.out + ow);
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+}  // namespace
+
+void pooling2d(const float* din,
+               float* dout,
+               int num_channel,
+               int hin,
+               int win,
+               int hout,
+               int wout,
+               const std::vector<int>& ksize,
+               const std::vector<int>& strides,
+               const std::vector<int>& paddings,
+               bool is_max,
+               bool exclusive,
+               bool adaptive) {
+  const PoolDim d{1, 1, 1, 1, 0};
+  const PoolDim h{hin, hout, ksize[0], strides[0], paddings[0]};
+  const PoolDim w{win, wout, ksize[1], strides[1], paddings[2]};
+  if (is_max) {
+    pooling_impl<true>(din, dout, num_channel, d, h, w, exclusive, adaptive);
+  } else {
+    pooling_impl<false>(din, dout, num_channel, d, h, w, exclusive, adaptive);
+  }
+}
+
+void pooling3d(const float* din,
+               float* dout,
+               int num_channel,
+               int din_depth,
+               int hin,
+               int win,
+               int dout_depth,
+               int hout,
+               int wout,
+               const std::vector<int>& ksize,
+               const std::vector<int>& strides,
+               const std::vector<int>& paddings,
+               bool is_max,
+               bool exclusive,
+               bool adaptive) {
+  const PoolDim d{din_depth, dout_depth, ksize[0], strides[0], paddings[0]};
+  const PoolDim h{hin, hout, ksize[1], strides[1], paddings[2]};
+  const PoolDim w{win, wout, ksize[2], strides[2], paddings[4]};
+  if (is_max) {
+    pooling_impl<true>(din, dout, num_channel, d, h, w, exclusive, adaptive);
+  } else {
+    pooling_impl<false>(din, dout, num_channel, d, h, w, exclusive, adaptive);
+  }
+}
+
+template <typename T>
+void pooling2d_int8(const int8_t* din,
+                    T* dout,
+                    int num_channel,
+                    int hin,
+                    int win,
+                    int hout,
+                    int wout,
+                    const std::vector<int>& ksize,
+                    const std::vector<int>& strides,
+                    const std::vector<int>& paddings,
+                    bool is_max,
+                    bool exclusive,
+                    bool adaptive,
+                    float scale) {
+  const PoolDim h{hin, hout, ksize[0], strides[0], paddings[0]};
+  const PoolDim w{win, wout, ksize[1], strides[1], paddings[2]};
+  if (is_max) {
+    pooling_int8_impl<true>(
+        din, dout, num_channel, h, w, exclusive, adaptive, scale);
+  } else {
+    pooling_int8_impl<false>(
+        din, dout, num_channel, h, w, exclusive, adaptive, scale);
+  }
+}
+
+template void pooling2d_int8<int8_t>(const int8_t*,
+                                     int8_t*,
+                                     int,
+                                     int,
+                                     int,
+                                     int,
+                                     int,
+                                     const std::vector<int>&,
+                                     const std::vector<int>&,
+                                     const std::vector<int>&,
+                                     bool,
+                                     bool,
+                                     bool,
+                                     float);
+template void pooling2d_int8<float>(const int8_t*,
+                                    float*,
+                                    int,
+                                    int,
+                                    int,
+                                    int,
+                                    int,
+                                    const std::vector<int>&,
+                                    const std::vector<int>&,
+                                    const std::vector<int>&,
+                                    bool,
+                                    bool,
+                                    bool,
+                                    float);
+
 }  // namespace math
 }  // namespace x86
 }  // namespace lite
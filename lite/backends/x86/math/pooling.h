@@ -240,6 +240,66 @@ class MaxPool3dWithIndexGradFunctor {
                   lite::Tensor* input_grad);
 };
 
+/*
+ * \brief Max and avg pooling of float NCHW (pool2d) and NCDHW (pool3d)
+ * tensors as Pool2dFunctor and Pool3dFunctor compute them, SIMD over the
+ * output columns of the windows of stride 1 and 2 and parallel over N * C and
+ * the output rows. The global pooling reduces the contiguous planes.
+ * num_channel is N * C, ksize and strides have an element for each pooled
+ * dim, paddings two: {top, bottom, left, right} for pool2d and
+ * {front, back, top, bottom, left, right} for pool3d.
+ */
+void pooling2d(const float* din,
+               float* dout,
+               int num_channel,
+               int hin,
+               int win,
+               int hout,
+               int wout,
+               const std::vector<int>& ksize,
+               const std::vector<int>& strides,
+               const std::vector<int>& paddings,
+               bool is_max,
+               bool exclusive,
+               bool adaptive);
+
+void pooling3d(const float* din,
+               float* dout,
+               int num_channel,
+               int din_depth,
+               int hin,
+               int win,
+               int dout_depth,
+               int hout,
+               int wout,
+               const std::vector<int>& ksize,
+               const std::vector<int>& strides,
+               const std::vector<int>& paddings,
+               bool is_max,
+               bool exclusive,
+               bool adaptive);
+
+/*
+ * \brief pool2d of the int8 NCHW tensors as pooling2d, the windows are
+ * accumulated in int32 and dout = pooled din * scale, where scale is
+ * in_scale / out_scale for the int8 dout and in_scale for the float dout.
+ */
+template <typename T>
+void pooling2d_int8(const int8_t* din,
+                    T* dout,
+                    int num_channel,
+                    int hin,
+                    int win,
+                    int hout,
+                    int wout,
+                    const std::vector<int>& ksize,
+                    const std::vector<int>& strides,
+                    const std::vector<int>& paddings,
+                    bool is_max,
+                    bool exclusive,
+                    bool adaptive,
+                    float scale);
+
 }  // namespace math
 }  // namespace x86
 }  // namespace lite
@@ -49,6 +49,9 @@
 #include "lite/core/scope.h"
 #include "lite/core/target_wrapper.h"
 #include "lite/core/tensor.h"
+#ifdef LITE_USE_THREAD_POOL
+#include "lite/core/thread_pool.h"
+#endif
 #include "lite/utils/all.h"
 #include "lite/utils/env.h"
 #include "lite/utils/macros.h"
@@ -601,8 +604,20 @@ class KernelContext {
     return *ctx_.get_mutable<ContextT>();
   }
 
+#ifdef LITE_USE_THREAD_POOL
+  // The thread pool of the predictor which owns the kernel, the parallel
+  // regions of the kernel are dispatched to it.
+  void SetThreadPool(const std::shared_ptr<ThreadPool>& thread_pool) {
+    thread_pool_ = thread_pool;
+  }
+  ThreadPool* thread_pool() const { return thread_pool_.get(); }
+#endif
+
  private:
   Any ctx_;
+#ifdef LITE_USE_THREAD_POOL
+  std::shared_ptr<ThreadPool> thread_pool_{nullptr};
+#endif
 };
 
 // The ContextScheduler helps to assign different context for each kernel.
@@ -0,0 +1,228 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/dataflow_executor.h"
+#include <algorithm>
+#include <map>
+#include <set>
+#if defined(PADDLE_WITH_MKLML) || defined(ARM_WITH_OMP)
+#include <omp.h>
+#define LITE_DATAFLOW_WITH_OMP
+#endif
+#ifdef PADDLE_WITH_MKLML
+#include "lite/backends/x86/mklml.h"
+#endif
+#ifdef LITE_WITH_ARM
+#include "lite/core/device_info.h"
+#endif
+#include "lite/utils/log/logging.h"
+
+namespace paddle {
+namespace lite {
+
+std::vector<std::vector<size_t>> DataflowExecutor::Dependencies(
+    const std::vector<Access>& accesses) {
+  std::vector<std::vector<size_t>> preds(accesses.size());
+  std::map<std::string, size_t> last_writer;
+  std::map<std::string, std::vector<size_t>> readers;
+  // the instructions since the last barrier
+  std::vector<size_t> since_barrier;
+  size_t last_barrier = 0;
+  bool has_barrier = false;
+  for (size_t i = 0; i < accesses.size(); ++i) {
+    const auto& access = accesses[i];
+    std::set<size_t> deps;
+    if (has_barrier) deps.insert(last_barrier);
+    if (access.barrier) deps.insert(since_barrier.begin(), since_barrier.end());
+    for (auto& name : access.reads) {
+      auto it = last_writer.find(name);
+      if (it != last_writer.end()) deps.insert(it->second);
+    }
+    for (auto& name : access.writes) {
+      auto it = last_writer.find(name);
+      if (it != last_writer.end()) deps.insert(it->second);
+      auto& users = readers[name];
+      deps.insert(users.begin(), users.end());
+    }
+    for (auto& name : access.reads) readers[name].push_back(i);
+    for (auto& name : access.writes) {
+      last_writer[name] = i;
+      readers[name].clear();
+    }
+    deps.erase(i);
+    preds[i].assign(deps.begin(), deps.end());
+    if (access.barrier) {
+      since_barrier.clear();
+      last_barrier = i;
+      has_barrier = true;
+    } else {
+      since_barrier.push_back(i);
+    }
+  }
+  return preds;
+}
+
+DataflowExecutor::DataflowExecutor(const std::vector<Access>& accesses,
+                                   int branches,
+                                   int threads)
+    : branches_((std::max)(branches, 1)),
+      threads_per_branch_((std::max)(threads / (std::max)(branches, 1), 1)) {
+  auto preds = Dependencies(accesses);
+  successors_.resize(preds.size());
+  deps_.resize(preds.size());
+  for (size_t i = 0; i < preds.size(); ++i) {
+    deps_[i] = static_cast<int>(preds[i].size());
+    for (auto pred : preds[i]) successors_[pred].push_back(i);
+  }
+#ifdef LITE_USE_THREAD_POOL
+  for (int branch = 0; branch < branches_; ++branch) {
+    pools_.push_back(ThreadPool::Create("", threads_per_branch_, {}));
+  }
+#endif
+  for (int branch = 1; branch < branches_; ++branch) {
+    workers_.emplace_back(&DataflowExecutor::WorkerLoop, this, branch);
+  }
+  VLOG(3) << "Dataflow executor of " << preds.size() << " instructions, "
+          << branches_ << " branches of " << threads_per_branch_
+          << " threads.";
+}
+
+DataflowExecutor::~DataflowExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) worker.join();
+}
+
+void DataflowExecutor::Run(const std::function<void(size_t)>& run) {
+  if (successors_.empty()) return;
+#ifdef LITE_USE_THREAD_POOL
+  // the kernels of this branch use its pool instead of the predictor's
+  ThreadPool::ScopedPool pool_guard(pools_[0].get(), true);
+#endif
+  std::unique_lock<std::mutex> lock(mutex_);
+#ifdef LITE_WITH_ARM
+  run_mode_ = DeviceInfo::Global().mode();
+#endif
+  MathThreads saved = EnterBranch();
+  run_ = &run;
+  pending_ = deps_;
+  remaining_ = successors_.size();
+  for (size_t i = 0; i < deps_.size(); ++i) {
+    if (deps_[i] == 0) ready_.push(i);
+  }
+  cv_.notify_all();
+  while (remaining_ > 0) {
+    Drain(&lock);
+    if (remaining_ > 0) {
+      cv_.wait(lock, [this] { return remaining_ == 0 || !ready_.empty(); });
+    }
+  }
+  run_ = nullptr;
+  lock.unlock();
+  LeaveBranch(saved);
+}
+
+void DataflowExecutor::WorkerLoop(int branch) {
+#ifdef LITE_USE_THREAD_POOL
+  ThreadPool::ScopedPool pool_guard(pools_[branch].get(), true);
+#endif
+  std::unique_lock<std::mutex> lock(mutex_);
+  // the math threads are set at the first run, when run_mode_ is known
+  MathThreads saved;
+  bool entered = false;
+#ifdef LITE_WITH_ARM
+  lite_api::PowerMode mode = run_mode_;
+#endif
+  while (true) {
+    cv_.wait(lock, [this] { return stop_ || !ready_.empty(); });
+    if (stop_) break;
+    if (!entered) {
+      saved = EnterBranch();
+      entered = true;
+#ifdef LITE_WITH_ARM
+      mode = run_mode_;
+    } else if (mode != run_mode_) {
+      // the power mode of the predictor changed
+      DeviceInfo::Global().SetRunMode(run_mode_, threads_per_branch_);
+      mode = run_mode_;
+#endif
+    }
+    Drain(&lock);
+  }
+  if (entered) LeaveBranch(saved);
+}
+
+DataflowExecutor::MathThreads DataflowExecutor::EnterBranch() {
+  MathThreads saved;
+#ifdef LITE_DATAFLOW_WITH_OMP
+  saved.omp = omp_get_max_threads();
+#endif
+#ifdef LITE_WITH_ARM
+  // the workers start with the default DeviceInfo of a new thread
+  saved.mode = DeviceInfo::Global().mode();
+  saved.arm = DeviceInfo::Global().threads();
+  DeviceInfo::Global().SetRunMode(run_mode_, threads_per_branch_);
+#endif
+#ifdef LITE_DATAFLOW_WITH_OMP
+  omp_set_num_threads(threads_per_branch_);
+#endif
+#ifdef PADDLE_WITH_MKLML
+  // MKL keeps its own number of threads besides the OpenMP one
+#ifdef LITE_WITH_STATIC_MKL
+  saved.mkl = MKL_Set_Num_Threads_Local(threads_per_branch_);
+#else
+  saved.mkl = x86::MKL_Set_Num_Threads_Local(threads_per_branch_);
+#endif
+#endif
+  return saved;
+}
+
+void DataflowExecutor::LeaveBranch(const MathThreads& saved) {
+#ifdef LITE_WITH_ARM
+  if (saved.arm > 0) DeviceInfo::Global().SetRunMode(saved.mode, saved.arm);
+#endif
+#ifdef LITE_DATAFLOW_WITH_OMP
+  omp_set_num_threads(saved.omp);
+#endif
+#ifdef PADDLE_WITH_MKLML
+  // 0 goes back to the global number of MKL threads
+#ifdef LITE_WITH_STATIC_MKL
+  MKL_Set_Num_Threads_Local(saved.mkl);
+#else
+  x86::MKL_Set_Num_Threads_Local(saved.mkl);
+#endif
+#endif
+}
+
+void DataflowExecutor::Drain(std::unique_lock<std::mutex>* lock) {
+  while (!ready_.empty()) {
+    size_t idx = ready_.top();
+    ready_.pop();
+    // another branch takes the rest of the ready instructions
+    if (!ready_.empty()) cv_.notify_one();
+    lock->unlock();
+    (*run_)(idx);
+    lock->lock();
+    for (auto succ : successors_[idx]) {
+      if (--pending_[succ] == 0) ready_.push(succ);
+    }
+    if (--remaining_ == 0) cv_.notify_all();
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
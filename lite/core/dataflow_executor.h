@@ -0,0 +1,114 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <condition_variable>  // NOLINT
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <queue>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "lite/api/paddle_place.h"
+#include "lite/core/thread_pool.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * DataflowExecutor runs the instructions of a block as a dataflow graph on
+ * CPU: an instruction is ready once the instructions it depends on finished,
+ * and up to `branches` ready instructions run at the same time, so the
+ * independent branches of inception blocks, towers and detection heads keep
+ * the cores busy while their small kernels run.
+ *
+ * The calling thread works as branch 0 and `branches` - 1 threads are kept
+ * for the others. The parallel regions of the kernels of every branch run on
+ * a private pool of `threads` / `branches` threads (LITE_USE_THREAD_POOL), or
+ * with as many OpenMP and MKL threads, the ready instruction of the smallest
+ * index is picked first. On ARM every branch runs in the power mode of the
+ * calling thread with `threads` / `branches` threads.
+ */
+class DataflowExecutor {
+ public:
+  // The variables an instruction reads and writes. A `barrier` instruction,
+  // like a control flow or subgraph op, waits for all the previous ones and
+  // all the following ones wait for it.
+  struct Access {
+    std::vector<std::string> reads;
+    std::vector<std::string> writes;
+    bool barrier{false};
+  };
+
+  // The predecessors of every instruction: the last writer of each variable
+  // it reads or writes, and the readers of the variables it writes since
+  // their last write.
+  static std::vector<std::vector<size_t>> Dependencies(
+      const std::vector<Access>& accesses);
+
+  DataflowExecutor(const std::vector<Access>& accesses,
+                   int branches,
+                   int threads);
+  ~DataflowExecutor();
+
+  // Calls `run` for every instruction after its predecessors, returns when
+  // all of them finished.
+  void Run(const std::function<void(size_t)>& run);
+
+  int branches() const { return branches_; }
+  int threads_per_branch() const { return threads_per_branch_; }
+
+ private:
+  // The math threads of a thread before it runs a branch.
+  struct MathThreads {
+    int omp{0};
+    int mkl{0};
+    lite_api::PowerMode mode{lite_api::LITE_POWER_NO_BIND};
+    int arm{0};
+  };
+
+  void WorkerLoop(int branch);
+  // Limits the math threads of the calling thread to the ones of a branch in
+  // `run_mode_`, returns the previous ones for LeaveBranch.
+  MathThreads EnterBranch();
+  void LeaveBranch(const MathThreads& saved);
+  // Runs the ready instructions until none is left, `lock` holds mutex_.
+  void Drain(std::unique_lock<std::mutex>* lock);
+
+  std::vector<std::vector<size_t>> successors_;
+  // the number of predecessors of every instruction, and the ones not
+  // finished in the current run
+  std::vector<int> deps_;
+  std::vector<int> pending_;
+  std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>>
+      ready_;
+  size_t remaining_{0};
+  const std::function<void(size_t)>* run_{nullptr};
+  // the power mode of the thread calling Run, ARM only
+  lite_api::PowerMode run_mode_{lite_api::LITE_POWER_NO_BIND};
+
+  int branches_{1};
+  int threads_per_branch_{1};
+#ifdef LITE_USE_THREAD_POOL
+  std::vector<std::shared_ptr<ThreadPool>> pools_;
+#endif
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_{false};
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,100 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/dataflow_executor.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+using Access = DataflowExecutor::Access;
+
+Access MakeAccess(const std::vector<std::string>& reads,
+                  const std::vector<std::string>& writes,
+                  bool barrier = false) {
+  Access access;
+  access.reads = reads;
+  access.writes = writes;
+  access.barrier = barrier;
+  return access;
+}
+
+// An inception block: four towers read x, the concat reads all of them.
+std::vector<Access> InceptionBlock() {
+  return {MakeAccess({"x"}, {"a"}),
+          MakeAccess({"x"}, {"b0"}),
+          MakeAccess({"b0"}, {"b"}),
+          MakeAccess({"x"}, {"c0"}),
+          MakeAccess({"c0"}, {"c"}),
+          MakeAccess({"x"}, {"d"}),
+          MakeAccess({"a", "b", "c", "d"}, {"y"})};
+}
+
+TEST(dataflow_executor, dependencies) {
+  auto preds = DataflowExecutor::Dependencies(InceptionBlock());
+  ASSERT_EQ(preds.size(), 7u);
+  for (size_t i : {0, 1, 3, 5}) EXPECT_TRUE(preds[i].empty());
+  EXPECT_EQ(preds[2], std::vector<size_t>({1}));
+  EXPECT_EQ(preds[4], std::vector<size_t>({3}));
+  EXPECT_EQ(preds[6], std::vector<size_t>({0, 2, 4, 5}));
+}
+
+TEST(dataflow_executor, reuse_and_barrier) {
+  // t is reused by the memory optimization: the second write waits for the
+  // reader of the first value, and the barrier orders everything around it.
+  std::vector<Access> accesses{MakeAccess({"x"}, {"t"}),
+                               MakeAccess({"t"}, {"a"}),
+                               MakeAccess({"x"}, {"t"}),
+                               MakeAccess({"x"}, {"c"}),
+                               MakeAccess({"c"}, {"c"}, true),
+                               MakeAccess({"x"}, {"e"})};
+  auto preds = DataflowExecutor::Dependencies(accesses);
+  EXPECT_EQ(preds[2], std::vector<size_t>({0, 1}));
+  EXPECT_TRUE(preds[3].empty());
+  EXPECT_EQ(preds[4], std::vector<size_t>({0, 1, 2, 3}));
+  EXPECT_EQ(preds[5], std::vector<size_t>({4}));
+}
+
+TEST(dataflow_executor, run) {
+  auto accesses = InceptionBlock();
+  auto preds = DataflowExecutor::Dependencies(accesses);
+  DataflowExecutor executor(accesses, 4, 4);
+  EXPECT_EQ(executor.threads_per_branch(), 1);
+  for (int repeat = 0; repeat < 3; ++repeat) {
+    std::vector<std::atomic<bool>> done(accesses.size());
+    for (auto& d : done) d = false;
+    std::atomic<int> running{0};
+    std::atomic<int> max_running{0};
+    executor.Run([&](size_t idx) {
+      for (auto pred : preds[idx]) EXPECT_TRUE(done[pred].load());
+      int now = ++running;
+      int prev = max_running.load();
+      while (now > prev && !max_running.compare_exchange_weak(prev, now)) {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      --running;
+      done[idx] = true;
+    });
+    for (auto& d : done) EXPECT_TRUE(d.load());
+    // the four towers run at the same time
+    EXPECT_GT(max_running.load(), 1);
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
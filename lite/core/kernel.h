@@ -81,7 +81,7 @@ class KernelBase {
   }
 #endif
 
-  void Launch() {
+  void Launch(bool reinit = true) {
     /// First run, init kernel, do weights transform once
     if (is_first_epoch_) {
       PrepareForRun();
@@ -89,7 +89,7 @@ class KernelBase {
     }
     /// re-init the kernel if needed (input shape should be checked in conv
     /// kernel)
-    ReInitWhenNeeded();
+    if (reinit) ReInitWhenNeeded();
 
     // Reset the workspace to make every kernel in the same thread to share the
     // temporary memory.
@@ -196,6 +196,15 @@ class KernelBase {
 
   std::string key_with_alias() const { return op_type() + "/" + alias(); }
 
+  // The names of the alternative implementations the kernel offers for its
+  // param, the default one first. KernelTuner times each of them on the real
+  // shapes, an empty list means the kernel has a single implementation.
+  virtual std::vector<std::string> Implementations() const { return {}; }
+  // The implementation PrepareForRun sets up, one of Implementations(), or
+  // empty for the default one.
+  void set_implementation(const std::string& x) { implementation_ = x; }
+  const std::string& implementation() const { return implementation_; }
+
   virtual ~KernelBase() = default;
   void Torch() {}
 
@@ -207,6 +216,7 @@ class KernelBase {
   // The extra identity to help defficiate a specific kernel, op_type_ + alias_
   // is the unique ID for the kernel.
   std::string alias_{};
+  std::string implementation_{};
   bool is_first_epoch_{true};
 
 #ifdef LITE_WITH_PROFILE
@@ -0,0 +1,361 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/kernel_tuner.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <set>
+#include <sstream>
+#include <utility>
+#include "lite/core/program.h"
+#include "lite/utils/io.h"
+#include "lite/utils/timer.h"
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+// The fields of the lines of the DB are separated by tabs.
+std::string Sanitize(std::string str) {
+  std::replace(str.begin(), str.end(), '\t', ' ');
+  std::replace(str.begin(), str.end(), '\n', ' ');
+  return str;
+}
+
+template <typename T>
+void PrintList(std::ostream& os, const std::vector<T>& values) {
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (i > 0) os << ',';
+    os << values[i];
+  }
+}
+
+void PrintAttr(std::ostream& os, const OpInfo& info, const std::string& name) {
+  switch (info.GetAttrType(name)) {
+    case OpAttrType::INT:
+      os << info.GetAttr<int32_t>(name);
+      break;
+    case OpAttrType::FLOAT:
+      os << info.GetAttr<float>(name);
+      break;
+    case OpAttrType::STRING:
+      os << info.GetAttr<std::string>(name);
+      break;
+    case OpAttrType::BOOLEAN:
+      os << info.GetAttr<bool>(name);
+      break;
+    case OpAttrType::LONG:
+      os << info.GetAttr<int64_t>(name);
+      break;
+    case OpAttrType::INTS:
+      PrintList(os, info.GetAttr<std::vector<int32_t>>(name));
+      break;
+    case OpAttrType::FLOATS:
+      PrintList(os, info.GetAttr<std::vector<float>>(name));
+      break;
+    case OpAttrType::STRINGS:
+      PrintList(os, info.GetAttr<std::vector<std::string>>(name));
+      break;
+    case OpAttrType::LONGS:
+      PrintList(os, info.GetAttr<std::vector<int64_t>>(name));
+      break;
+    default:
+      os << '?';
+  }
+}
+
+const Type* DeclType(const KernelBase& kernel,
+                     const std::string& arg_name,
+                     bool input) {
+  auto key = kernel.GenParamTypeKey();
+  const auto* type =
+      input ? ParamTypeRegistry::Global().RetrieveInArgument(
+                  kernel.place(), key, arg_name)
+            : ParamTypeRegistry::Global().RetrieveOutArgument(
+                  kernel.place(), key, arg_name);
+  return type ? type->type : nullptr;
+}
+
+// Whether the kernels read and write the variables of the op in the same
+// types, so that one replaces the other without any type cast.
+bool SameDeclTypes(const KernelBase& a,
+                   const KernelBase& b,
+                   const OpInfo& info) {
+  for (auto& arg : info.InputArgumentNames()) {
+    if (DeclType(a, arg, true) != DeclType(b, arg, true)) return false;
+  }
+  for (auto& arg : info.OutputArgumentNames()) {
+    if (DeclType(a, arg, false) != DeclType(b, arg, false)) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+KernelTuningDB::KernelTuningDB(const std::string& path,
+                               const std::string& cpu_model)
+    : path_(path), cpu_model_(Sanitize(cpu_model)) {
+  if (!IsFileExists(path_)) return;
+  for (auto& line : ReadLines(path_)) {
+    if (line.empty()) continue;
+    auto first = line.find('\t');
+    auto last = line.rfind('\t');
+    if (first == std::string::npos || first == last) {
+      LOG(WARNING) << "Skip the malformed line of the kernel tuning DB "
+                   << path_ << ": " << line;
+      continue;
+    }
+    if (line.substr(0, first) == cpu_model_) {
+      entries_[line.substr(first + 1, last - first - 1)] =
+          line.substr(last + 1);
+    } else {
+      other_lines_.push_back(line);
+    }
+  }
+  VLOG(3) << "Loaded " << entries_.size() << " kernel choices for "
+          << cpu_model_ << " from " << path_;
+}
+
+const std::string* KernelTuningDB::Find(const std::string& signature) const {
+  auto it = entries_.find(signature);
+  return it == entries_.end() ? nullptr : &it->second;
+}
+
+void KernelTuningDB::Set(const std::string& signature,
+                         const std::string& choice) {
+  auto& entry = entries_[Sanitize(signature)];
+  auto value = Sanitize(choice);
+  dirty_ = dirty_ || entry != value;
+  entry = value;
+}
+
+void KernelTuningDB::Save() {
+  if (!dirty_) return;
+  // Written aside and renamed, the readers never see a partial file.
+  std::string tmp_path = path_ + ".tmp";
+  std::ofstream file(tmp_path.c_str());
+  if (!file.is_open()) {
+    LOG(WARNING) << "Failed to write the kernel tuning DB " << path_;
+    return;
+  }
+  for (auto& line : other_lines_) file << line << "\n";
+  for (auto& entry : entries_) {
+    file << cpu_model_ << "\t" << entry.first << "\t" << entry.second << "\n";
+  }
+  file.close();
+  if (std::rename(tmp_path.c_str(), path_.c_str()) != 0) {
+    LOG(WARNING) << "Failed to write the kernel tuning DB " << path_;
+    return;
+  }
+  dirty_ = false;
+}
+
+std::string KernelTuningDB::CpuModel() {
+  std::ifstream file("/proc/cpuinfo");
+  std::string line;
+  std::string hardware;
+  while (std::getline(file, line)) {
+    auto colon = line.find(':');
+    if (colon == std::string::npos) continue;
+    auto key = line.substr(0, line.find_first_of("\t:"));
+    auto value = line.substr(colon + 1);
+    value.erase(0, value.find_first_not_of(' '));
+    if (key == "model name") return value;
+    // ARM Linux names the SoC instead
+    if (key == "Hardware") hardware = value;
+  }
+  return hardware.empty() ? "unknown" : hardware;
+}
+
+KernelTuner::KernelTuner(const std::string& db_path, int repeats)
+    : db_(db_path), repeats_((std::max)(repeats, 1)) {}
+
+std::string KernelTuner::Signature(OpLite* op) {
+  const auto* info = op->op_info();
+  auto* scope = op->scope();
+  CHECK(info && scope);
+  std::ostringstream os;
+  os << info->Type();
+  for (auto& arg : info->InputArgumentNames()) {
+    os << " " << arg << ":";
+    for (auto& name : info->Input(arg)) {
+      os << "[";
+      auto* var = scope->FindVar(name);
+      if (var != nullptr && var->IsType<Tensor>()) {
+        const auto& tensor = var->Get<Tensor>();
+        os << PrecisionToStr(tensor.precision()) << ":";
+        PrintList(os, tensor.dims().Vectorize());
+      }
+      os << "]";
+    }
+  }
+  // The attributes set by the framework do not change the computation.
+  for (auto& name : info->AttrNames()) {
+    if (name.compare(0, 3, "__@") == 0 || name.compare(0, 3, "op_") == 0) {
+      continue;
+    }
+    os << " " << name << "=";
+    PrintAttr(os, *info, name);
+  }
+  return Sanitize(os.str());
+}
+
+std::string KernelTuner::Choice(const KernelBase& kernel) {
+  auto impl = kernel.implementation();
+  if (impl.empty()) {
+    auto impls = kernel.Implementations();
+    if (!impls.empty()) impl = impls.front();
+  }
+  auto type = kernel.SerializedKernelType();
+  return impl.empty() ? type : type + "#" + impl;
+}
+
+std::unique_ptr<KernelBase> KernelTuner::CreateKernel(
+    OpLite* op, const std::string& choice) {
+  auto pos = choice.find('#');
+  auto kernel_type = choice.substr(0, pos);
+  std::string impl = pos == std::string::npos ? "" : choice.substr(pos + 1);
+  std::string op_type, alias;
+  Place place;
+  KernelBase::ParseKernelType(kernel_type, &op_type, &alias, &place);
+  if (op_type != op->op_info()->Type()) return nullptr;
+  for (auto& kernel : op->CreateKernels({place})) {
+    if (kernel->SerializedKernelType() != kernel_type) continue;
+    if (!impl.empty()) {
+      auto impls = kernel->Implementations();
+      if (std::find(impls.begin(), impls.end(), impl) == impls.end()) {
+        return nullptr;
+      }
+    }
+    kernel->set_implementation(impl);
+    kernel->SetContext(ContextScheduler::Global().NewContext(kernel->target()));
+#ifdef LITE_USE_THREAD_POOL
+    kernel->mutable_context()->SetThreadPool(thread_pool_);
+#endif
+    return std::move(kernel);
+  }
+  return nullptr;
+}
+
+std::vector<std::string> KernelTuner::Candidates(OpLite* op,
+                                                 const KernelBase& picked) {
+  std::vector<std::string> choices;
+  std::set<std::string> seen;
+  for (auto& kernel : op->CreateKernels({picked.place()})) {
+    if (kernel->target() != picked.target() ||
+        !SameDeclTypes(*kernel, picked, *op->op_info())) {
+      continue;
+    }
+    auto kernel_type = kernel->SerializedKernelType();
+    auto impls = kernel->Implementations();
+    if (impls.empty()) impls.push_back("");
+    for (auto& impl : impls) {
+      auto choice = impl.empty() ? kernel_type : kernel_type + "#" + impl;
+      if (seen.insert(choice).second) choices.push_back(choice);
+    }
+  }
+  return choices;
+}
+
+float KernelTuner::Measure(KernelBase* kernel) {
+#ifdef LITE_USE_THREAD_POOL
+  ThreadPool::ScopedPool pool_guard(kernel->mutable_context()->thread_pool());
+#endif
+  // The first run prepares the kernel, the fastest of the others counts.
+  kernel->Launch();
+  uint64_t best = std::numeric_limits<uint64_t>::max();
+  for (int i = 0; i < repeats_; ++i) {
+    auto start = Timer::GetCurrentUS();
+    kernel->Launch();
+    best = (std::min)(best, Timer::GetCurrentUS() - start);
+  }
+  return static_cast<float>(best);
+}
+
+void KernelTuner::Tune(Instruction* inst) {
+  if (finished_ || inst->is_feed_fetch_op()) return;
+  auto* op = const_cast<OpLite*>(inst->op());
+  const auto* picked = inst->kernel();
+  const auto* info = op->op_info();
+  auto target = picked->target();
+  // The device kernels run asynchronously, and the control flow ops and the
+  // ops running once can not run again.
+  if ((target != TARGET(kHost) && target != TARGET(kX86) &&
+       target != TARGET(kARM)) ||
+      info->HasAttr("sub_block") || info->Type() == "subgraph" ||
+      op->run_once()) {
+    return;
+  }
+  // The in-place ops overwrite their inputs.
+  auto input_names = info->input_names();
+  std::set<std::string> inputs(input_names.begin(), input_names.end());
+  for (auto& name : info->output_names()) {
+    if (inputs.count(name)) return;
+  }
+
+  auto signature = Signature(op);
+  const auto* found = db_.Find(signature);
+  if (found != nullptr && *found == Choice(*picked)) {
+    ++reused_;
+    return;
+  }
+  if (found != nullptr) {
+    auto kernel = CreateKernel(op, *found);
+    if (kernel != nullptr) {
+      inst->set_kernel(std::move(kernel));
+      ++reused_;
+      return;
+    }
+    LOG(WARNING) << "The tuned kernel " << *found << " of " << info->Type()
+                 << " is not available, the op is tuned again.";
+  }
+
+  auto choices = Candidates(op, *picked);
+  if (choices.size() < 2) return;
+  std::unique_ptr<KernelBase> best;
+  std::string best_choice;
+  float best_time = std::numeric_limits<float>::max();
+  for (auto& choice : choices) {
+    auto kernel = CreateKernel(op, choice);
+    if (kernel == nullptr) continue;
+    float time = Measure(kernel.get());
+    VLOG(3) << info->Type() << " " << choice << ": " << time << " us";
+    if (time < best_time) {
+      best_time = time;
+      best_choice = choice;
+      best = std::move(kernel);
+    }
+  }
+  if (best == nullptr) return;
+  LOG(INFO) << "Tuned " << info->Type() << " with " << choices.size()
+            << " candidates, picked " << best_choice << " (" << best_time
+            << " us)";
+  db_.Set(signature, best_choice);
+  inst->set_kernel(std::move(best));
+  ++tuned_;
+}
+
+void KernelTuner::Finish() {
+  if (finished_) return;
+  finished_ = true;
+  db_.Save();
+  LOG(INFO) << "Kernel tuning finished, " << tuned_ << " ops tuned, "
+            << reused_ << " ops reused the choices of " << db_.path();
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,125 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/kernel.h"
+#include "lite/core/op_lite.h"
+#ifdef LITE_USE_THREAD_POOL
+#include "lite/core/thread_pool.h"
+#endif
+
+namespace paddle {
+namespace lite {
+
+struct Instruction;
+
+/*
+ * KernelTuningDB keeps the choices of KernelTuner in a text file, one line of
+ * `cpu model \t signature \t choice` for every tuned op instance. Only the
+ * lines of the CPU model it is created for are looked up, the lines of the
+ * other models are written back untouched.
+ */
+class KernelTuningDB {
+ public:
+  explicit KernelTuningDB(const std::string& path,
+                          const std::string& cpu_model = CpuModel());
+
+  // Returns nullptr if `signature` is not tuned on this CPU model.
+  const std::string* Find(const std::string& signature) const;
+  void Set(const std::string& signature, const std::string& choice);
+  // Writes the file if a choice is set since it is loaded.
+  void Save();
+
+  const std::string& path() const { return path_; }
+  size_t size() const { return entries_.size(); }
+
+  // The model name of the CPU in /proc/cpuinfo.
+  static std::string CpuModel();
+
+ private:
+  std::string path_;
+  std::string cpu_model_;
+  std::map<std::string, std::string> entries_;
+  std::vector<std::string> other_lines_;
+  bool dirty_{false};
+};
+
+/*
+ * KernelTuner picks the kernels of the main block by timing them instead of
+ * trusting the scores of StaticKernelPickPass. Right after an instruction
+ * runs for the first time, its inputs hold real data of real shapes, and
+ * every candidate runs `repeats` times on them: the kernels registered for
+ * the op on the target of the picked one whose inputs and outputs are
+ * declared with the same types, each with every implementation it offers for
+ * the param (KernelBase::Implementations). The fastest one replaces the
+ * kernel of the instruction.
+ *
+ * A choice is stored as `kernel type#implementation` under the signature of
+ * the op instance, its type, input shapes and attributes, so the instances
+ * tuned before only look their choices up.
+ */
+class KernelTuner {
+ public:
+  explicit KernelTuner(const std::string& db_path, int repeats = 10);
+
+#ifdef LITE_USE_THREAD_POOL
+  // The pool the candidates run their parallel regions in.
+  void SetThreadPool(const std::shared_ptr<ThreadPool>& thread_pool) {
+    thread_pool_ = thread_pool;
+  }
+#endif
+
+  // Called by RuntimeProgram::Run after the first run of the instruction.
+  void Tune(Instruction* inst);
+  // Saves the choices, the tuning is over.
+  void Finish();
+  bool finished() const { return finished_; }
+
+  KernelTuningDB* db() { return &db_; }
+  // the instructions timed, and the ones whose choices are looked up
+  int64_t tuned() const { return tuned_; }
+  int64_t reused() const { return reused_; }
+
+  // The key of the op instance in the DB, its type, the precisions and dims
+  // of its inputs and its attributes.
+  static std::string Signature(OpLite* op);
+  // The kernel type and the implementation of the kernel.
+  static std::string Choice(const KernelBase& kernel);
+
+ private:
+  // Creates the kernel of `choice` for the op, returns nullptr if its kernel
+  // is not registered.
+  std::unique_ptr<KernelBase> CreateKernel(OpLite* op,
+                                           const std::string& choice);
+  // The choices of the candidates of the kernel picked for the op.
+  std::vector<std::string> Candidates(OpLite* op, const KernelBase& picked);
+  // Returns the time of one run in microseconds.
+  float Measure(KernelBase* kernel);
+
+  KernelTuningDB db_;
+  int repeats_;
+  bool finished_{false};
+  int64_t tuned_{0};
+  int64_t reused_{0};
+#ifdef LITE_USE_THREAD_POOL
+  std::shared_ptr<ThreadPool> thread_pool_;
+#endif
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,54 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/kernel_tuner.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+
+namespace paddle {
+namespace lite {
+
+TEST(KernelTuningDB, save_and_load) {
+  const std::string path = "kernel_tuning_db_test.txt";
+  std::remove(path.c_str());
+  {
+    KernelTuningDB db(path, "cpu a");
+    EXPECT_EQ(db.Find("conv2d x"), nullptr);
+    db.Set("conv2d x", "conv2d/def/2/1/1#direct");
+    db.Set("fc\ty", "fc/def/2/1/1");
+    db.Save();
+  }
+  {
+    // the choices of another CPU model are kept apart
+    KernelTuningDB db(path, "cpu b");
+    EXPECT_EQ(db.size(), 0u);
+    db.Set("conv2d x", "conv2d/def/2/1/1#gemm");
+    db.Save();
+  }
+  KernelTuningDB a(path, "cpu a");
+  ASSERT_EQ(a.size(), 2u);
+  ASSERT_NE(a.Find("conv2d x"), nullptr);
+  EXPECT_EQ(*a.Find("conv2d x"), "conv2d/def/2/1/1#direct");
+  ASSERT_NE(a.Find("fc y"), nullptr);
+  EXPECT_EQ(*a.Find("fc y"), "fc/def/2/1/1");
+  KernelTuningDB b(path, "cpu b");
+  ASSERT_EQ(b.size(), 1u);
+  EXPECT_EQ(*b.Find("conv2d x"), "conv2d/def/2/1/1#gemm");
+  EXPECT_FALSE(KernelTuningDB::CpuModel().empty());
+  std::remove(path.c_str());
+}
+
+}  // namespace lite
+}  // namespace paddle
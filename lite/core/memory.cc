@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/core/memory.h"
+#include "lite/core/profile/tracer.h"
 
 #ifdef LITE_WITH_METAL
 #include "lite/backends/metal/target_wrapper.h"
@@ -23,6 +24,11 @@ namespace paddle {
 namespace lite {
 
 void* TargetMalloc(TargetType target, size_t size) {
+  profile::TraceSpan trace_span("memory", "TargetMalloc");
+  if (trace_span.active()) {
+    trace_span.set_args("{\"target\":\"" + TargetToStr(target) +
+                        "\",\"bytes\":" + std::to_string(size) + "}");
+  }
   void* data{nullptr};
   switch (target) {
     case TargetType::kHost:
@@ -73,6 +79,12 @@ void* TargetMalloc(TargetType target, size_t size) {
 }
 
 void TargetFree(TargetType target, void* data, std::string free_flag) {
+  if (profile::Tracer::enabled()) {
+    profile::Tracer::Global().AddInstant(
+        "memory",
+        "TargetFree",
+        "{\"target\":\"" + TargetToStr(target) + "\"}");
+  }
   switch (target) {
     case TargetType::kHost:
     case TargetType::kX86:
@@ -0,0 +1,301 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/memory_planner.h"
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <set>
+#include <string>
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+bool IsHostTarget(TargetType x) {
+  return x == TARGET(kHost) || x == TARGET(kX86) || x == TARGET(kARM);
+}
+
+// Every slice is aligned like TargetMalloc and keeps its padding for the
+// vectorized kernels reading past the end.
+size_t AlignSize(size_t size) {
+  const size_t align = host::MALLOC_ALIGN;
+  return (size + align + align - 1) / align * align;
+}
+
+}  // namespace
+
+void MemoryPlanner::ArenaBuffer::Bind(void* data, size_t size) {
+  if (own_data_) {
+    Buffer::Free();
+    own_data_ = false;
+  }
+  data_ = data;
+  space_ = size;
+}
+
+void MemoryPlanner::ArenaBuffer::Detach() {
+  if (!own_data_) {
+    data_ = nullptr;
+    space_ = 0;
+    own_data_ = true;
+  }
+}
+
+void MemoryPlanner::ArenaBuffer::ResetLazy(TargetType target, size_t size) {
+  if (!own_data_ && IsHostTarget(target) && size <= space_) {
+    target_ = target;
+    return;
+  }
+  if (!own_data_) {
+    *overflowed_ = true;
+    Detach();
+  }
+  Buffer::ResetLazy(target, size);
+}
+
+void MemoryPlanner::ArenaBuffer::Free() {
+  if (own_data_) {
+    Buffer::Free();
+  } else {
+    // the slice is bound again before the next write
+    data_ = nullptr;
+    space_ = 0;
+  }
+}
+
+size_t MemoryPlanner::PlanOffsets(std::vector<Interval>* intervals) {
+  std::vector<size_t> order(intervals->size());
+  for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return (*intervals)[a].size > (*intervals)[b].size;
+  });
+  size_t arena_size = 0;
+  std::vector<const Interval*> placed;
+  std::vector<const Interval*> alive;
+  for (auto i : order) {
+    auto& interval = (*intervals)[i];
+    alive.clear();
+    for (auto* other : placed) {
+      if (other->begin <= interval.end && interval.begin <= other->end) {
+        alive.push_back(other);
+      }
+    }
+    std::sort(alive.begin(),
+              alive.end(),
+              [](const Interval* a, const Interval* b) {
+                return a->offset < b->offset;
+              });
+    // The best fitting gap between the alive values, or above them.
+    size_t best_offset = std::numeric_limits<size_t>::max();
+    size_t best_gap = std::numeric_limits<size_t>::max();
+    size_t top = 0;
+    for (auto* other : alive) {
+      if (other->offset >= top) {
+        size_t gap = other->offset - top;
+        if (gap >= interval.size && gap < best_gap) {
+          best_gap = gap;
+          best_offset = top;
+        }
+      }
+      top = (std::max)(top, other->offset + other->size);
+    }
+    interval.offset =
+        best_offset == std::numeric_limits<size_t>::max() ? top : best_offset;
+    arena_size = (std::max)(arena_size, interval.offset + interval.size);
+    placed.push_back(&interval);
+  }
+  return arena_size;
+}
+
+MemoryPlanner::MemoryPlanner(
+    const std::vector<std::vector<Instruction>>& instructions,
+    Scope* exec_scope) {
+  CHECK(exec_scope);
+  const auto& insts = instructions[kRootBlockIdx];
+  bindings_.resize(insts.size());
+  touches_.resize(insts.size());
+
+  // The variables of the sub-blocks, control flow ops, subgraph ops and
+  // device kernels are left out of the arena.
+  std::set<std::string> invalid_var_names;
+  for (size_t block_idx = 0; block_idx < instructions.size(); ++block_idx) {
+    for (auto& inst : instructions[block_idx]) {
+      auto* op_info = inst.op()->op_info();
+      if (block_idx == kRootBlockIdx && !inst.is_feed_fetch_op() &&
+          IsHostTarget(inst.kernel()->target()) &&
+          !op_info->HasAttr("sub_block") && op_info->Type() != "subgraph") {
+        continue;
+      }
+      for (auto& name : op_info->input_names()) invalid_var_names.insert(name);
+      for (auto& name : op_info->output_names()) invalid_var_names.insert(name);
+    }
+  }
+
+  struct Access {
+    size_t idx;
+    bool read;
+    bool write;
+  };
+  std::map<std::string, std::vector<Access>> accesses;
+  for (size_t idx = 0; idx < insts.size(); ++idx) {
+    if (insts[idx].is_feed_fetch_op()) continue;
+    auto* op_info = insts[idx].op()->op_info();
+    auto input_names = op_info->input_names();
+    auto output_names = op_info->output_names();
+    std::set<std::string> reads(input_names.begin(), input_names.end());
+    std::set<std::string> writes(output_names.begin(), output_names.end());
+    std::set<std::string> names(reads);
+    names.insert(writes.begin(), writes.end());
+    for (auto& name : names) {
+      accesses[name].push_back({idx, reads.count(name) > 0,
+                                writes.count(name) > 0});
+    }
+  }
+
+  for (auto& item : accesses) {
+    auto* var = exec_scope->FindVar(item.first);
+    if (var == nullptr || !var->IsType<Tensor>()) continue;
+    auto* tensor = var->GetMutable<Tensor>();
+    tensors_.push_back(tensor);
+    bool local = exec_scope->FindLocalVar(item.first) != nullptr &&
+                 !tensor->persistable();
+    const auto& access = item.second;
+    if (access.front().read) {
+      // fed by the caller before the run
+      if (local) inputs_.emplace_back(tensor, DDim());
+      continue;
+    }
+    if (!local || invalid_var_names.count(item.first)) continue;
+    // Every write which does not read the variable starts a new value, a
+    // value nobody reads is an output of the block.
+    std::vector<Interval> values;
+    for (auto& a : access) {
+      if (a.write && !a.read) {
+        values.emplace_back();
+        values.back().begin = a.idx;
+      }
+      values.back().end = a.idx;
+    }
+    if (std::any_of(values.begin(), values.end(), [](const Interval& v) {
+          return v.begin == v.end;
+        })) {
+      continue;
+    }
+    size_t slot = slots_.size();
+    slots_.emplace_back();
+    slots_.back().tensor = tensor;
+    size_t a = 0;
+    for (auto& value : values) {
+      value.slot = slot;
+      size_t id = intervals_.size();
+      intervals_.push_back(value);
+      bindings_[value.begin].push_back(id);
+      for (; a < access.size() && access[a].idx <= value.end; ++a) {
+        touches_[access[a].idx].push_back(id);
+      }
+    }
+  }
+}
+
+void MemoryPlanner::BeginRun() {
+  if (!planned_) return;
+  bool changed = overflowed_;
+  for (auto& input : inputs_) {
+    changed = changed || input.first->dims() != input.second;
+  }
+  if (changed) {
+    VLOG(4) << "The memory plan is outdated, measure and plan again.";
+    Reset();
+  }
+}
+
+void MemoryPlanner::Measure(size_t idx) {
+  for (auto id : touches_[idx]) {
+    auto& interval = intervals_[id];
+    interval.size = (std::max)(interval.size,
+                               slots_[interval.slot].tensor->memory_size());
+  }
+}
+
+void MemoryPlanner::EndRun() {
+  if (!planned_) Plan();
+}
+
+void MemoryPlanner::Plan() {
+  // Tensors sharing their data with others, or not on the host, keep their
+  // own memory.
+  std::map<const void*, int> users;
+  for (auto* tensor : tensors_) {
+    if (tensor->raw_data() != nullptr) users[tensor->raw_data()]++;
+  }
+  for (auto& slot : slots_) {
+    const auto* tensor = slot.tensor;
+    slot.active = IsHostTarget(tensor->target()) && tensor->offset() == 0 &&
+                  (tensor->raw_data() == nullptr ||
+                   users[tensor->raw_data()] == 1);
+  }
+  std::vector<Interval> intervals;
+  std::vector<size_t> slot_sizes(slots_.size(), 0);
+  int slot_num = 0;
+  for (auto& slot : slots_) slot_num += slot.active;
+  for (auto& interval : intervals_) {
+    if (!slots_[interval.slot].active) continue;
+    interval.size = AlignSize(interval.size);
+    slot_sizes[interval.slot] =
+        (std::max)(slot_sizes[interval.slot], interval.size);
+    intervals.push_back(interval);
+  }
+  planned_peak_ = PlanOffsets(&intervals);
+  naive_peak_ = 0;
+  for (auto size : slot_sizes) naive_peak_ += size;
+
+  // Bind the tensors to the arena.
+  if (planned_peak_ > 0) arena_.ResetLazy(TARGET(kHost), planned_peak_);
+  for (size_t i = 0, j = 0; i < intervals_.size(); ++i) {
+    if (!slots_[intervals_[i].slot].active) continue;
+    intervals_[i].offset = intervals[j++].offset;
+  }
+  for (auto& slot : slots_) {
+    if (!slot.active) continue;
+    if (!slot.buffer) {
+      slot.buffer = std::make_shared<ArenaBuffer>(&overflowed_);
+    }
+    slot.buffer->Bind(arena_.data(), planned_peak_);
+    slot.tensor->ResetBuffer(slot.buffer, 0);
+  }
+  for (auto& input : inputs_) input.second = input.first->dims();
+  planned_ = true;
+  overflowed_ = false;
+  LOG(INFO) << "Memory arena planned for " << intervals.size()
+            << " values of " << slot_num
+            << " tensors, planned peak: " << planned_peak_
+            << " bytes, naive peak: " << naive_peak_ << " bytes";
+}
+
+void MemoryPlanner::Reset() {
+  // The tensors own their memory during the measuring run.
+  for (auto& slot : slots_) {
+    if (slot.buffer) slot.buffer->Detach();
+  }
+  for (auto& interval : intervals_) interval.size = 0;
+  arena_.Free();
+  planned_ = false;
+  overflowed_ = false;
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,131 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/memory.h"
+#include "lite/core/scope.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+struct Instruction;
+
+/*
+ * MemoryPlanner places the intermediate host tensors of the main block into
+ * one pre-sized arena.
+ *
+ * After MemoryOptimizePass a variable may carry several values, every write
+ * which does not read the variable starts a new one. Each value gets its
+ * size from a measuring run, which allocates tensors as usual, and an offset
+ * in the arena so that values alive at the same time never overlap. Before an
+ * instruction runs, the tensors it produces are bound to their slices.
+ *
+ * The plan is dropped and measured again when the dims of the block inputs
+ * change, or when a kernel asks for more memory than planned, in which case
+ * the tensor falls back to an own allocation until the next plan.
+ */
+class MemoryPlanner {
+ public:
+  // A value of a variable, alive from instruction `begin` to `end`.
+  struct Interval {
+    size_t begin{0};
+    size_t end{0};
+    size_t size{0};
+    size_t offset{0};
+    size_t slot{0};
+  };
+
+  // Assigns the offsets of `intervals` greedy by size: the largest value is
+  // placed first, into the smallest gap left by the placed values alive at
+  // the same time, or above them. Returns the arena size.
+  static size_t PlanOffsets(std::vector<Interval>* intervals);
+
+  MemoryPlanner(const std::vector<std::vector<Instruction>>& instructions,
+                Scope* exec_scope);
+  // The tensors get back their own memory.
+  ~MemoryPlanner() { Reset(); }
+
+  // Called around the instructions of the main block by RuntimeProgram::Run,
+  // `idx` is the index of the instruction.
+  void BeginRun();
+  void BeforeInstruction(size_t idx) {
+    if (!planned_) return;
+    for (auto id : bindings_[idx]) {
+      auto& interval = intervals_[id];
+      auto& slot = slots_[interval.slot];
+      if (!slot.active) continue;
+      slot.buffer->Bind(
+          static_cast<char*>(arena_.data()) + interval.offset, interval.size);
+    }
+  }
+  void AfterInstruction(size_t idx) {
+    if (!planned_) Measure(idx);
+  }
+  void EndRun();
+
+  // Releases the arena, the next run measures and plans again.
+  void Reset();
+
+  // The arena size and the memory held by the tensors without the arena.
+  size_t planned_peak() const { return planned_peak_; }
+  size_t naive_peak() const { return naive_peak_; }
+
+ private:
+  // An unowned slice of the arena. A request exceeding the slice makes it
+  // allocate and own memory, and flags the plan as outdated.
+  class ArenaBuffer : public Buffer {
+   public:
+    explicit ArenaBuffer(bool* overflowed) : overflowed_(overflowed) {}
+    void Bind(void* data, size_t size);
+    // Owns its memory again, like a plain Buffer.
+    void Detach();
+    void ResetLazy(TargetType target, size_t size) override;
+    void Free() override;
+
+   private:
+    bool* overflowed_;
+  };
+
+  // A variable whose values are placed in the arena.
+  struct Slot {
+    Tensor* tensor{nullptr};
+    std::shared_ptr<ArenaBuffer> buffer;
+    bool active{false};
+  };
+
+  void Measure(size_t idx);
+  void Plan();
+
+  std::vector<Slot> slots_;
+  std::vector<Interval> intervals_;
+  // intervals starting at / touched by every instruction
+  std::vector<std::vector<size_t>> bindings_;
+  std::vector<std::vector<size_t>> touches_;
+  // all the tensors used by the main block, to detect shared buffers
+  std::vector<const Tensor*> tensors_;
+  // the inputs of the main block and their dims of the planned run
+  std::vector<std::pair<const Tensor*, DDim>> inputs_;
+  Buffer arena_;
+  bool planned_{false};
+  bool overflowed_{false};
+  size_t planned_peak_{0};
+  size_t naive_peak_{0};
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,88 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/memory_planner.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+using Interval = MemoryPlanner::Interval;
+
+Interval MakeInterval(size_t begin, size_t end, size_t size) {
+  Interval interval;
+  interval.begin = begin;
+  interval.end = end;
+  interval.size = size;
+  return interval;
+}
+
+// Values alive at the same time must not share any byte of the arena.
+void CheckNoOverlap(const std::vector<Interval>& intervals, size_t arena_size) {
+  for (size_t i = 0; i < intervals.size(); ++i) {
+    const auto& a = intervals[i];
+    EXPECT_LE(a.offset + a.size, arena_size);
+    for (size_t j = i + 1; j < intervals.size(); ++j) {
+      const auto& b = intervals[j];
+      bool alive_together = a.begin <= b.end && b.begin <= a.end;
+      bool overlap =
+          a.offset < b.offset + b.size && b.offset < a.offset + a.size;
+      EXPECT_FALSE(alive_together && overlap) << "value " << i << " and " << j;
+    }
+  }
+}
+
+TEST(memory_planner, chain) {
+  // conv -> relu -> conv -> relu, every value is read by the next op only
+  std::vector<Interval> intervals{MakeInterval(0, 1, 1024),
+                                  MakeInterval(1, 2, 1024),
+                                  MakeInterval(2, 3, 256),
+                                  MakeInterval(3, 4, 256)};
+  size_t arena_size = MemoryPlanner::PlanOffsets(&intervals);
+  CheckNoOverlap(intervals, arena_size);
+  EXPECT_EQ(arena_size, 2048u);
+}
+
+TEST(memory_planner, fill_gaps) {
+  // A small value fits the gap between two large ones alive with it.
+  std::vector<Interval> intervals{MakeInterval(0, 2, 512),
+                                  MakeInterval(0, 0, 256),
+                                  MakeInterval(0, 4, 512),
+                                  MakeInterval(1, 3, 128),
+                                  MakeInterval(3, 4, 512)};
+  size_t arena_size = MemoryPlanner::PlanOffsets(&intervals);
+  CheckNoOverlap(intervals, arena_size);
+  EXPECT_EQ(arena_size, 1280u);
+}
+
+TEST(memory_planner, random) {
+  std::vector<Interval> intervals;
+  size_t naive_size = 0;
+  unsigned seed = 7;
+  for (int i = 0; i < 200; ++i) {
+    seed = seed * 1103515245 + 12345;
+    size_t begin = (seed >> 8) % 100;
+    size_t length = (seed >> 16) % 10;
+    size_t size = 64 * (1 + (seed >> 4) % 32);
+    intervals.push_back(MakeInterval(begin, begin + length, size));
+    naive_size += size;
+  }
+  size_t arena_size = MemoryPlanner::PlanOffsets(&intervals);
+  CheckNoOverlap(intervals, arena_size);
+  EXPECT_LT(arena_size, naive_size);
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -13,6 +13,12 @@
 // limitations under the License.
 
 #include "lite/core/model/base/io.h"
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace paddle {
 namespace lite {
@@ -56,6 +62,45 @@ void BinaryFileReader::Read(void* dst, size_t size) const {
   cur_ += size;
 }
 
+MappedFileReader::MappedFileReader(const std::string& path) {
+#if !defined(_WIN32)
+  int fd = open(path.c_str(), O_RDONLY);
+  CHECK_GE(fd, 0) << "Unable to open file: " << path;
+  struct stat st;
+  CHECK_EQ(fstat(fd, &st), 0) << "Unable to stat file: " << path;
+  length_ = static_cast<size_t>(st.st_size);
+  CHECK_GT(length_, 0u) << "The file is empty: " << path;
+  void* addr = mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  CHECK(addr != MAP_FAILED) << "Unable to map file: " << path;
+  size_t length = length_;
+  data_ = std::shared_ptr<const char>(
+      static_cast<const char*>(addr),
+      [length](const char* p) { munmap(const_cast<char*>(p), length); });
+#else
+  // No mapping on windows, the file is read into memory instead.
+  BinaryFileReader reader(path);
+  length_ = reader.length();
+  char* data = new char[length_];
+  reader.Read(data, length_);
+  data_ = std::shared_ptr<const char>(data, [](const char* p) { delete[] p; });
+#endif
+}
+
+void MappedFileReader::Read(void* dst, size_t size) const {
+  CHECK(dst);
+  CHECK_LE(cur_ + size, length_) << "Failed to read " << size << " bytes.";
+  lite::TargetCopy(TargetType::kHost, dst, data_.get() + cur_, size);
+  cur_ += size;
+}
+
+std::shared_ptr<const char> MappedFileReader::ReadInPlace(size_t size) const {
+  CHECK_LE(cur_ + size, length_) << "Failed to read " << size << " bytes.";
+  std::shared_ptr<const char> res(data_, data_.get() + cur_);
+  cur_ += size;
+  return res;
+}
+
 void BinaryFileWriter::Write(const void* src, size_t size) const {
   CHECK(src);
   CHECK_EQ(fwrite(src, 1, size, file_), size) << "Failed to read " << size
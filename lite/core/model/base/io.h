@@ -83,6 +83,12 @@ class ByteReader {
   virtual size_t length() const = 0;
   virtual size_t current() const = 0;
   virtual bool ReachEnd() const = 0;
+  // Returns the next `size` bytes without copying them and skips them, or
+  // nullptr if the reader does not hold its data in memory. The returned
+  // pointer keeps the memory alive.
+  virtual std::shared_ptr<const char> ReadInPlace(size_t size) const {
+    return nullptr;
+  }
 
   template <typename T,
             typename = typename std::enable_if<
@@ -118,6 +124,7 @@ class ByteWriter {
   }
 
   virtual size_t Align(size_t bytes_size) const = 0;
+  virtual size_t current() const = 0;
 
   virtual ~ByteWriter() = default;
 
@@ -145,6 +152,24 @@ class BinaryFileReader : public ByteReader {
   mutable size_t cur_{0};
 };
 
+// Maps the whole file read-only into memory, the pages are shared with the
+// other processes mapping the same file through the page cache.
+class MappedFileReader : public ByteReader {
+ public:
+  explicit MappedFileReader(const std::string& path);
+  void Read(void* dst, size_t size) const override;
+  std::shared_ptr<const char> ReadInPlace(size_t size) const override;
+  bool ReachEnd() const override { return cur_ >= length_; }
+  size_t length() const override { return length_; }
+  size_t current() const override { return cur_; }
+
+ private:
+  // unmapped when the last tensor using it is released
+  std::shared_ptr<const char> data_;
+  size_t length_{0};
+  mutable size_t cur_{0};
+};
+
 class BinaryFileWriter : public ByteWriter {
  public:
   explicit BinaryFileWriter(const std::string& path) {
@@ -167,6 +192,7 @@ class BinaryFileWriter : public ByteWriter {
     }
     return padding_bytes;
   }
+  size_t current() const override { return cur_; }
 
  private:
   FILE* file_{};
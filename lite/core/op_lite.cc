@@ -312,5 +312,18 @@ std::vector<float> OpInfo::GetOutputScale(const std::string &name,
   return GetAttr<std::vector<float>>(scale_name);
 }
 
+bool OpInfo::GetDynamicQuantWeightScale(const std::string &weight_name,
+                                        std::vector<float> *out) const {
+  CHECK(out);
+  if (!HasAttr("quantize_weight_bits")) return false;
+  // see lite/core/optimizer/mir/post_quant_dynamic_pass.cc, the weight may be
+  // renamed by a later pass
+  auto scale_name =
+      weight_name.substr(0, weight_name.find("/target_trans")) + "_quant_scale";
+  if (!HasAttr(scale_name)) return false;
+  *out = GetAttr<std::vector<float>>(scale_name);
+  return true;
+}
+
 }  // namespace lite
 }  // namespace paddle
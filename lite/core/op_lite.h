@@ -68,6 +68,9 @@ class OpLite : public Registry {
   // Inference the outputs' shape.
   virtual bool InferShapeImpl() const { return true; }
   virtual bool InferShape();
+  // Whether the output shapes only depend on the shapes and LoDs of the
+  // inputs, so that they can be cached.
+  bool IsShapeCacheable() const { return InferShapeWithCache(); }
   // Infer the outputs's data type during opt period
   virtual bool InferType() {
     LOG(FATAL) << "Error! " << op_type_
@@ -278,6 +281,13 @@ class OpInfo : public cpp::OpDesc {
                                    bool is_scale_name = false) const;
   std::vector<float> GetOutputScale(const std::string &name,
                                     bool is_scale_name = false) const;
+
+  // Gets the scales of the weight `weight_name` quantized by
+  // post_quant_dynamic_pass, which are saved in op desc as
+  // (<weight>_quant_scale, scale_value). Returns false and leaves `out` as it
+  // is if the weight is not quantized.
+  bool GetDynamicQuantWeightScale(const std::string &weight_name,
+                                  std::vector<float> *out) const;
 };
 
 }  // namespace lite
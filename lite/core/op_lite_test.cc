@@ -14,11 +14,29 @@
 
 #include "lite/core/op_lite.h"
 #include <gtest/gtest.h>
+#include <vector>
 
 namespace paddle {
 namespace lite {
 
 TEST(OpLite, test) {}
 
+TEST(OpInfo, dynamic_quant_weight_scale) {
+  cpp::OpDesc desc;
+  desc.SetType("fc");
+  desc.SetInput("W", {"fc_w/target_trans"});
+  desc.SetAttr<std::vector<float>>("fc_w_quant_scale", {0.5f, 0.25f});
+  OpInfo info(desc);
+  std::vector<float> scale{1.f};
+  // not quantized by post_quant_dynamic_pass
+  EXPECT_FALSE(info.GetDynamicQuantWeightScale("fc_w/target_trans", &scale));
+  EXPECT_EQ(scale, std::vector<float>({1.f}));
+
+  info.SetAttr<int>("quantize_weight_bits", 8);
+  EXPECT_FALSE(info.GetDynamicQuantWeightScale("fc_b", &scale));
+  EXPECT_TRUE(info.GetDynamicQuantWeightScale("fc_w/target_trans", &scale));
+  EXPECT_EQ(scale, std::vector<float>({0.5f, 0.25f}));
+}
+
 }  // namespace lite
 }  // namespace paddle
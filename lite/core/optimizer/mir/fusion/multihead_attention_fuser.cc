@@ -0,0 +1,291 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/multihead_attention_fuser.h"
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+namespace {
+
+bool IsHeadTranspose(const std::vector<int>& axis) {
+  return axis == std::vector<int>({0, 2, 1, 3});
+}
+
+// The shape comes from the attribute instead of the Shape or ShapeTensor input.
+bool HasStaticShape(const Node* node) {
+  auto* op_info = const_cast<Node*>(node)->stmt()->op_info();
+  for (auto& arg : {"Shape", "ShapeTensor"}) {
+    if (op_info->HasInput(arg) && !op_info->Input(arg).empty()) return false;
+  }
+  return true;
+}
+
+// The input has the shape [batch, seq_len, hidden] in the var desc.
+bool HasRank3Input(const Node* node) {
+  auto op = const_cast<Node*>(node)->AsStmt().op();
+  auto input_name = op->op_info()->Input("X").front();
+  auto* var = op->scope()->FindVar(input_name);
+  return var && var->Get<lite::Tensor>().dims().size() == 3;
+}
+
+// Walks back along the X inputs from var to the reshape2 splitting the heads,
+// returns its head_num, or -1 if there is no such reshape2.
+int HeadNum(const Node* var) {
+  while (var && !var->inlinks.empty()) {
+    auto* producer = var->inlinks.front();
+    auto* op_info = const_cast<Node*>(producer)->stmt()->op_info();
+    if (op_info->Type() == "reshape2") {
+      if (!op_info->HasAttr("shape")) break;
+      auto shape = op_info->GetAttr<std::vector<int>>("shape");
+      return shape.size() == 4 ? shape[2] : -1;
+    }
+    if (!op_info->HasInput("X") || op_info->Input("X").empty()) break;
+    auto x_name = op_info->Input("X").front();
+    var = nullptr;
+    for (auto* in : producer->inlinks) {
+      if (in->IsArg() && in->arg()->name == x_name) var = in;
+    }
+  }
+  return -1;
+}
+
+const Node* InputVar(const Node* op_node, const std::string& arg) {
+  auto name =
+      const_cast<Node*>(op_node)->stmt()->op_info()->Input(arg).front();
+  for (auto* in : op_node->inlinks) {
+    if (in->IsArg() && in->arg()->name == name) return in;
+  }
+  return nullptr;
+}
+
+// The X and Y of the matmul are split into the same number of heads, which
+// is what fused_multihead_attention assumes for Q, K and V.
+bool HasSameHeadNum(const Node* node) {
+  int x_head_num = HeadNum(InputVar(node, "X"));
+  return x_head_num > 0 && x_head_num == HeadNum(InputVar(node, "Y"));
+}
+
+}  // namespace
+
+PMNode* MultiheadAttentionFuser::SplitHeads(const std::string& prefix,
+                                            PMNode* input) {
+  auto* reshape2 =
+      OpNode(prefix + "_reshape2", "reshape2")
+          ->assert_op_attr_satisfied<std::vector<int>>(
+              "shape",
+              [](const std::vector<int>& shape) {
+                return shape.size() == 4 && shape[2] > 0 && shape[3] > 0;
+              })
+          ->assert_node_satisfied(HasStaticShape)
+          ->assert_node_satisfied(HasRank3Input)
+          ->AsIntermediate();
+  auto* reshape2_out = VarNode(prefix + "_reshape2_out")
+                           ->assert_is_op_output("reshape2", "Out")
+                           ->assert_is_op_input("transpose2", "X")
+                           ->AsIntermediate();
+  auto* reshape2_xshape = VarNode(prefix + "_reshape2_xshape")
+                              ->assert_is_op_output("reshape2", "XShape")
+                              ->AsIntermediate();
+  auto* transpose2 = OpNode(prefix + "_transpose2", "transpose2")
+                         ->assert_op_attr_satisfied<std::vector<int>>(
+                             "axis", IsHeadTranspose)
+                         ->AsIntermediate();
+  auto* transpose2_out = VarNode(prefix + "_transpose2_out")
+                             ->assert_is_op_output("transpose2", "Out")
+                             ->AsIntermediate();
+  auto* transpose2_xshape = VarNode(prefix + "_transpose2_xshape")
+                                ->assert_is_op_output("transpose2", "XShape")
+                                ->AsIntermediate();
+  *input >> *reshape2 >> *reshape2_out >> *transpose2 >> *transpose2_out;
+  *reshape2 >> *reshape2_xshape;
+  *transpose2 >> *transpose2_xshape;
+  return transpose2_out;
+}
+
+void MultiheadAttentionFuser::BuildPattern() {
+  const bool is_v2 = matmul_type_ == "matmul_v2";
+  const std::string trans_x = is_v2 ? "trans_x" : "transpose_X";
+  const std::string trans_y = is_v2 ? "trans_y" : "transpose_Y";
+
+  auto* q = VarNode("q")->assert_is_op_input("reshape2", "X")->AsInput();
+  auto* k = VarNode("k")->assert_is_op_input("reshape2", "X")->AsInput();
+  auto* v = VarNode("v")->assert_is_op_input("reshape2", "X")->AsInput();
+  auto* q_heads = SplitHeads("q", q);
+  auto* k_heads = SplitHeads("k", k);
+  auto* v_heads = SplitHeads("v", v);
+
+  auto* qk_matmul = OpNode("qk_matmul", matmul_type_)
+                        ->assert_op_attr<bool>(trans_x, false)
+                        ->assert_op_attr<bool>(trans_y, true)
+                        ->assert_node_satisfied(HasSameHeadNum)
+                        ->AsIntermediate();
+  if (with_q_scale_) {
+    q_heads->assert_is_op_input("scale", "X");
+    auto* q_scale = OpNode("q_scale", "scale")
+                        ->assert_op_attr_satisfied<float>(
+                            "bias", [](float bias) { return bias == 0.f; })
+                        ->AsIntermediate();
+    auto* q_scale_out = VarNode("q_scale_out")
+                            ->assert_is_op_output("scale", "Out")
+                            ->assert_is_op_input(matmul_type_, "X")
+                            ->AsIntermediate();
+    *q_heads >> *q_scale >> *q_scale_out >> *qk_matmul;
+  } else {
+    q_heads->assert_is_op_input(matmul_type_, "X");
+    *q_heads >> *qk_matmul;
+  }
+  k_heads->assert_is_op_input(matmul_type_, "Y");
+  *k_heads >> *qk_matmul;
+
+  auto* qk_matmul_out = VarNode("qk_matmul_out")
+                            ->assert_is_op_output(matmul_type_, "Out")
+                            ->AsIntermediate();
+  *qk_matmul >> *qk_matmul_out;
+  auto* softmax =
+      OpNode("softmax", "softmax")
+          ->assert_op_attr_satisfied<int>(
+              "axis", [](int axis) { return axis == -1 || axis == 3; })
+          ->AsIntermediate();
+  if (with_mask_) {
+    qk_matmul_out->assert_is_op_input("elementwise_add", "X");
+    auto* mask = VarNode("mask")
+                     ->assert_is_op_input("elementwise_add", "Y")
+                     ->AsInput();
+    auto* qk_add = OpNode("qk_add", "elementwise_add")
+                       ->assert_op_attr<int>("axis", -1)
+                       ->AsIntermediate();
+    auto* qk_add_out = VarNode("qk_add_out")
+                           ->assert_is_op_output("elementwise_add", "Out")
+                           ->assert_is_op_input("softmax", "X")
+                           ->AsIntermediate();
+    *qk_matmul_out >> *qk_add >> *qk_add_out >> *softmax;
+    *mask >> *qk_add;
+  } else {
+    qk_matmul_out->assert_is_op_input("softmax", "X");
+    *qk_matmul_out >> *softmax;
+  }
+  auto* softmax_out = VarNode("softmax_out")
+                          ->assert_is_op_output("softmax", "Out")
+                          ->assert_is_op_input(matmul_type_, "X")
+                          ->AsIntermediate();
+
+  auto* qkv_matmul = OpNode("qkv_matmul", matmul_type_)
+                         ->assert_op_attr<bool>(trans_x, false)
+                         ->assert_op_attr<bool>(trans_y, false)
+                         ->assert_node_satisfied(HasSameHeadNum)
+                         ->AsIntermediate();
+  if (!is_v2) {
+    qkv_matmul->assert_op_attr_satisfied<float>(
+        "alpha", [](float alpha) { return std::fabs(alpha - 1.f) < 1e-5f; });
+  }
+  v_heads->assert_is_op_input(matmul_type_, "Y");
+  auto* qkv_matmul_out = VarNode("qkv_matmul_out")
+                             ->assert_is_op_output(matmul_type_, "Out")
+                             ->assert_is_op_input("transpose2", "X")
+                             ->AsIntermediate();
+  auto* qkv_transpose2 = OpNode("qkv_transpose2", "transpose2")
+                             ->assert_op_attr_satisfied<std::vector<int>>(
+                                 "axis", IsHeadTranspose)
+                             ->AsIntermediate();
+  auto* qkv_transpose2_out = VarNode("qkv_transpose2_out")
+                                 ->assert_is_op_output("transpose2", "Out")
+                                 ->assert_is_op_input("reshape2", "X")
+                                 ->AsIntermediate();
+  auto* qkv_transpose2_xshape =
+      VarNode("qkv_transpose2_xshape")
+          ->assert_is_op_output("transpose2", "XShape")
+          ->AsIntermediate();
+  auto* qkv_reshape2 = OpNode("qkv_reshape2", "reshape2")
+                           ->assert_op_attr_satisfied<std::vector<int>>(
+                               "shape",
+                               [](const std::vector<int>& shape) {
+                                 return shape.size() == 3;
+                               })
+                           ->assert_node_satisfied(HasStaticShape)
+                           ->AsIntermediate();
+  auto* qkv_reshape2_xshape = VarNode("qkv_reshape2_xshape")
+                                  ->assert_is_op_output("reshape2", "XShape")
+                                  ->AsIntermediate();
+  auto* out =
+      VarNode("out")->assert_is_op_output("reshape2", "Out")->AsOutput();
+
+  *softmax >> *softmax_out >> *qkv_matmul;
+  *v_heads >> *qkv_matmul;
+  *qkv_matmul >> *qkv_matmul_out >> *qkv_transpose2 >> *qkv_transpose2_out >>
+      *qkv_reshape2 >> *out;
+  *qkv_transpose2 >> *qkv_transpose2_xshape;
+  *qkv_reshape2 >> *qkv_reshape2_xshape;
+}
+
+void MultiheadAttentionFuser::InsertNewNode(SSAGraph* graph,
+                                            const key2nodes_t& matched) {
+  auto op_desc = GenOpDesc(matched);
+  auto attention_op =
+      LiteOpRegistry::Global().Create("fused_multihead_attention");
+  auto qk_matmul = matched.at("qk_matmul")->stmt()->op();
+  auto* scope = qk_matmul->scope();
+  auto& valid_places = qk_matmul->valid_places();
+  attention_op->Attach(op_desc, scope);
+
+  auto* new_op_node =
+      graph->GraphCreateInstructNode(attention_op, valid_places);
+
+  IR_NODE_LINK_TO(matched.at("q"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("k"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("v"), new_op_node);
+  if (with_mask_) {
+    IR_NODE_LINK_TO(matched.at("mask"), new_op_node);
+  }
+  IR_NODE_LINK_TO(new_op_node, matched.at("out"));
+}
+
+cpp::OpDesc MultiheadAttentionFuser::GenOpDesc(const key2nodes_t& matched) {
+  cpp::OpDesc op_desc;
+  op_desc.SetType("fused_multihead_attention");
+  op_desc.SetInput("Q", {matched.at("q")->arg()->name});
+  op_desc.SetInput("K", {matched.at("k")->arg()->name});
+  op_desc.SetInput("V", {matched.at("v")->arg()->name});
+  if (with_mask_) {
+    op_desc.SetInput("BiasQK", {matched.at("mask")->arg()->name});
+  }
+  op_desc.SetOutput("Out", {matched.at("out")->arg()->name});
+
+  auto shape = matched.at("q_reshape2")
+                   ->stmt()
+                   ->op_info()
+                   ->GetAttr<std::vector<int>>("shape");
+  op_desc.SetAttr<int>("head_num", shape[2]);
+  float alpha = 1.f;
+  auto* qk_matmul_info = matched.at("qk_matmul")->stmt()->op_info();
+  if (qk_matmul_info->HasAttr("alpha")) {
+    alpha = qk_matmul_info->GetAttr<float>("alpha");
+  }
+  if (with_q_scale_) {
+    alpha *= matched.at("q_scale")->stmt()->op_info()->GetAttr<float>("scale");
+  }
+  op_desc.SetAttr<float>("alpha", alpha);
+  return op_desc;
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
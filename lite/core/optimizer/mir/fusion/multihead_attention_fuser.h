@@ -0,0 +1,77 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "lite/core/optimizer/mir/pattern_matcher_high_api.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+/* Fuses the attention of the transformer encoders into
+ * fused_multihead_attention:
+ *
+ *        Q                    K                    V
+ *        |                    |                    |
+ *     reshape2             reshape2             reshape2
+ *        |                    |                    |
+ *    transpose2           transpose2           transpose2
+ *        |                    |                    |
+ *     (scale)                 |                    |
+ *         \                  /                     |
+ *    matmul(transpose_Y=true)                      |
+ *              |                                   |
+ *     (elementwise_add BiasQK)                     |
+ *              |                                   |
+ *           softmax                                |
+ *               \                                 /
+ *                 ------------ matmul -----------
+ *                                |
+ *                            transpose2
+ *                                |
+ *                             reshape2
+ *                                |
+ *                               Out
+ */
+class MultiheadAttentionFuser : public FuseBase {
+ public:
+  explicit MultiheadAttentionFuser(const std::string& matmul_type,
+                                   bool with_q_scale,
+                                   bool with_mask)
+      : matmul_type_(matmul_type),
+        with_q_scale_(with_q_scale),
+        with_mask_(with_mask) {}
+
+  void BuildPattern() override;
+  void InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) override;
+
+ private:
+  cpp::OpDesc GenOpDesc(const key2nodes_t& matched) override;
+  // reshape2 to [batch, seq_len, head_num, head_size] and transpose2 to
+  // [batch, head_num, seq_len, head_size], returns the transposed var.
+  PMNode* SplitHeads(const std::string& prefix, PMNode* input);
+
+  std::string matmul_type_;
+  bool with_q_scale_;
+  bool with_mask_;
+};
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
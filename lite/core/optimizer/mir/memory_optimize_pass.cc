@@ -330,6 +330,9 @@ void MemoryOptimizePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
   // name of var and the value in the table represents the current name of var.
   // 3. Perform reuse plan: Replace all var's name in the model according to the
   // mapping table.
+  // The sizes are unknown until the input shapes are given, so the offsets of
+  // the values in one arena are planned at runtime by MemoryPlanner if
+  // ConfigBase::set_memory_arena is enabled.
   std::map<std::string, lifecycle_map_t> lifecycles;
   CollectLifeCycleByDevice(&lifecycles, graph.get());
   for (auto& ele : lifecycles) {
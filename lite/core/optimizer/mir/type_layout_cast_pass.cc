@@ -28,7 +28,117 @@ namespace paddle {
 namespace lite {
 namespace mir {
 
+namespace {
+
+// conv2d and depthwise_conv2d run blocked for one group, depthwise or the
+// channels of the groups in multiples of 8
+bool BlockedConvSupported(const Node::Stmt& inst) {
+  auto* op_info = inst.op_info();
+  if (op_info->HasAttr("fuse_elementwise_op_type")) return false;
+  auto* filter = inst.op()->scope()->FindVar(op_info->Input("Filter").front());
+  if (!filter) return false;
+  auto dims = filter->Get<Tensor>().dims();
+  if (dims.size() != 4) return false;
+  const int groups =
+      op_info->HasAttr("groups") ? op_info->GetAttr<int>("groups") : 1;
+  const int chout = dims[0];
+  const int chin_group = dims[1];
+  const bool depthwise = groups > 1 && chin_group == 1 && chout == groups;
+  return groups == 1 || depthwise ||
+         (chin_group % 8 == 0 && chout / groups % 8 == 0);
+}
+
+bool BlockedOpSupported(const Node::Stmt& inst) {
+  auto* op_info = inst.op_info();
+  const auto& op_type = inst.op_type();
+  if (op_type == "pool2d") {
+    const auto type = op_info->GetAttr<std::string>("pooling_type");
+    return op_info->GetAttr<std::vector<int>>("ksize").size() == 2u &&
+           (type == "max" || type == "avg");
+  }
+  if (op_type.find("fusion_elementwise_") == 0) {
+    return op_info->GetAttr<std::string>("act_type") == "relu";
+  }
+  return true;
+}
+
+// the NCHW kernel of an op picked with its NCHWc8 one, the layouts of its
+// outputs follow
+void ResetToPlainKernel(Node* node) {
+  auto& inst = node->AsStmt();
+  const auto& blocked = inst.picked_kernel();
+  const Place place{blocked.target(), blocked.precision(), DATALAYOUT(kNCHW)};
+  auto kernels = inst.op()->CreateKernels({place});
+  int best_score = -1;
+  std::unique_ptr<KernelBase> picked;
+  for (auto& kernel : kernels) {
+    if (kernel->layout() == DATALAYOUT(kNCHWc8)) continue;
+    int score = (kernel->place() == place) * 2 + (kernel->alias() == "def");
+    if (score > best_score) {
+      best_score = score;
+      picked = std::move(kernel);
+    }
+  }
+  CHECK(picked) << "no NCHW kernel of " << inst.op_type() << " for "
+                << place.DebugString();
+  VLOG(3) << "reset " << inst.op_type() << " to " << picked->summary();
+  inst.kernels().clear();
+  inst.kernels().emplace_back(std::move(picked));
+  inst.op()->AttachKernel(inst.kernels().front().get());
+  for (auto* out : node->outlinks) {
+    std::string arg_name;
+    if (!inst.op_info()->GetOutputArgname(out->AsArg().name, &arg_name)) {
+      continue;
+    }
+    const auto* decl = inst.picked_kernel().GetOutputDeclType(arg_name);
+    const auto* type = out->AsArg().type ? out->AsArg().type : decl;
+    out->AsArg().type = LiteType::GetTensorTy(
+        type->target(), type->precision(), decl->layout());
+  }
+}
+
+}  // namespace
+
+void TypeLayoutTransformPass::PropagateBlockedLayout(SSAGraph* graph) {
+  // The convs anchor the blocked part of the graph, the other ops stay
+  // blocked only if all their data inputs come blocked: a blocked pool2d or
+  // relu fed by a NCHW tensor would cost two reorders for nothing. The
+  // topological order settles the producers before their consumers.
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    auto& inst = node->AsStmt();
+    if (inst.kernels().empty() ||
+        inst.picked_kernel().layout() != DATALAYOUT(kNCHWc8)) {
+      continue;
+    }
+    const auto& op_type = inst.op_type();
+    bool blocked = false;
+    if (op_type == "conv2d" || op_type == "depthwise_conv2d") {
+      blocked = BlockedConvSupported(inst);
+    } else if (BlockedOpSupported(inst)) {
+      blocked = true;
+      for (auto* in : node->inlinks) {
+        std::string arg_name;
+        CHECK(inst.op_info()->GetInputArgname(in->AsArg().name, &arg_name));
+        if (inst.picked_kernel().GetInputDeclType(arg_name)->layout() !=
+            DATALAYOUT(kNCHWc8)) {
+          continue;
+        }
+        const auto& arg = in->AsArg();
+        if (arg.is_weight || arg.is_persist || !arg.type ||
+            arg.type->layout() != DATALAYOUT(kNCHWc8)) {
+          blocked = false;
+        }
+      }
+    }
+    if (!blocked) {
+      ResetToPlainKernel(node);
+    }
+  }
+}
+
 void TypeLayoutTransformPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  PropagateBlockedLayout(graph.get());
   // Start from inputs of the graph, those should have place set.
   VLOG(4) << "\n" << Visualize(graph.get());
   std::list<Node*> nodes;
@@ -94,6 +204,26 @@ void TypeLayoutTransformPass::ComplementInputs(
     return;
   }
 
+  // The NCHWc8 tensors are read by the NCHWc8 kernels only, the kernels of
+  // kAny layout get them reordered to NCHW too.
+  const bool in_blocked = in_arg_type->layout() == DATALAYOUT(kNCHWc8);
+  const bool decl_blocked = decl_arg_type->layout() == DATALAYOUT(kNCHWc8);
+  if (in_blocked != decl_blocked) {
+    const Type* to_type =
+        decl_blocked ? decl_arg_type
+                     : LiteType::GetTensorTy(in_arg_type->target(),
+                                             in_arg_type->precision(),
+                                             DATALAYOUT(kNCHW));
+    AddLayoutInst(*in_arg_type,
+                  *to_type,
+                  in,
+                  graph,
+                  inst_node,
+                  copied_nodes,
+                  graph->valid_places());
+    return;
+  }
+
   if (!DataLayoutCompatible(*in->AsArg().type, *decl_arg_type)) {
     VLOG(4) << "found Layout unmatched tensor: " << in->AsArg().name
             << " for kernel " << inst.op()->DebugString() << " "
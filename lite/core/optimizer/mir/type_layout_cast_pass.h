@@ -46,6 +46,10 @@ class TypeLayoutTransformPass : public ProgramPass {
   const std::vector<Place>& valid_places() const { return valid_places_; }
 
  private:
+  // Keeps the kernels of the x86 NCHWc8 layout where the blocked tensors flow
+  // between them, the others go back to their NCHW kernels.
+  void PropagateBlockedLayout(SSAGraph* graph);
+
   std::vector<Place> valid_places_;
 };
 
@@ -0,0 +1,230 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/type_layout_cast_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/core/optimizer/mir/pass_manager.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/optimizer/mir/static_kernel_pick_pass.h"
+#include "lite/core/optimizer/mir/type_target_cast_pass.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+void AddVar(cpp::BlockDesc* block_desc,
+            const std::shared_ptr<Scope>& scope,
+            const std::string& name,
+            const std::vector<int64_t>& shape = {},
+            bool persistable = false) {
+  auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+  var_desc->SetName(name);
+  var_desc->SetPersistable(persistable);
+  auto* tensor = scope->Var(name)->GetMutable<Tensor>();
+  if (!shape.empty()) {
+    tensor->Resize(shape);
+    tensor->mutable_data<float>();
+    tensor->set_persistable(persistable);
+  }
+}
+
+void AddReluDesc(cpp::BlockDesc* block_desc,
+                 const std::shared_ptr<Scope>& scope,
+                 const std::string& x,
+                 const std::string& out) {
+  AddVar(block_desc, scope, out);
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType("relu");
+  op_desc->SetInput("X", {x});
+  op_desc->SetOutput("Out", {out});
+}
+
+// feed -> relu -> conv2d -> relu -> pool2d -> fc -> fetch, the first relu
+// reads the NCHW output of feed
+std::shared_ptr<cpp::ProgramDesc> BuildProgramDesc(
+    const std::shared_ptr<Scope>& scope, int chin, int chout, int groups) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  block_desc->ClearOps();
+  block_desc->ClearVars();
+
+  for (const std::string name : {"feed", "fetch"}) {
+    block_desc->AddVar<cpp::VarDesc>()->SetName(name);
+    scope->Var(name)->GetMutable<std::vector<Tensor>>();
+  }
+
+  AddVar(block_desc, scope, "image");
+  auto* feed = block_desc->AddOp<cpp::OpDesc>();
+  feed->SetType("feed");
+  feed->SetInput("X", {"feed"});
+  feed->SetOutput("Out", {"image"});
+  feed->SetAttr<int>("col", 0);
+
+  AddReluDesc(block_desc, scope, "image", "relu_0_out");
+
+  AddVar(block_desc, scope, "conv_w", {chout, chin / groups, 3, 3}, true);
+  AddVar(block_desc, scope, "conv_out");
+  auto* conv = block_desc->AddOp<cpp::OpDesc>();
+  conv->SetType("conv2d");
+  conv->SetInput("Input", {"relu_0_out"});
+  conv->SetInput("Filter", {"conv_w"});
+  conv->SetOutput("Output", {"conv_out"});
+  conv->SetAttr<std::vector<int>>("strides", {1, 1});
+  conv->SetAttr<std::vector<int>>("paddings", {1, 1});
+  conv->SetAttr<std::vector<int>>("dilations", {1, 1});
+  conv->SetAttr<int>("groups", groups);
+
+  AddReluDesc(block_desc, scope, "conv_out", "relu_1_out");
+
+  AddVar(block_desc, scope, "pool_out");
+  auto* pool = block_desc->AddOp<cpp::OpDesc>();
+  pool->SetType("pool2d");
+  pool->SetInput("X", {"relu_1_out"});
+  pool->SetOutput("Out", {"pool_out"});
+  pool->SetAttr<std::string>("pooling_type", "max");
+  pool->SetAttr<std::vector<int>>("ksize", {2, 2});
+  pool->SetAttr<bool>("global_pooling", false);
+  pool->SetAttr<std::vector<int>>("strides", {2, 2});
+  pool->SetAttr<std::vector<int>>("paddings", {0, 0});
+
+  AddVar(block_desc, scope, "fc_w", {chout * 4 * 4, 10}, true);
+  AddVar(block_desc, scope, "fc_out");
+  auto* fc = block_desc->AddOp<cpp::OpDesc>();
+  fc->SetType("fc");
+  fc->SetInput("Input", {"pool_out"});
+  fc->SetInput("W", {"fc_w"});
+  fc->SetOutput("Out", {"fc_out"});
+  fc->SetAttr<int>("in_num_col_dims", 1);
+
+  auto* fetch = block_desc->AddOp<cpp::OpDesc>();
+  fetch->SetType("fetch");
+  fetch->SetInput("X", {"fc_out"});
+  fetch->SetOutput("Out", {"fetch"});
+  fetch->SetAttr<int>("col", 0);
+  return program_desc;
+}
+
+// runs the passes of the optimizer up to type_layout_cast_pass
+std::unique_ptr<SSAGraph> ApplyLayoutCast(
+    const std::shared_ptr<Scope>& scope,
+    const std::shared_ptr<cpp::ProgramDesc>& program_desc,
+    const std::vector<Place>& valid_places) {
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph);
+  graph->Build(program, valid_places);
+  graph->SetValidPlaces(valid_places);
+
+  core::KernelPickFactor factor;
+  factor.ConsiderTarget();
+  factor.ConsiderPrecision();
+  factor.ConsiderDataLayout();
+  auto& passes = PassManager::Global();
+  *passes.LookUp<StaticKernelPickPass>("static_kernel_pick_pass")
+       ->mutable_kernel_pick_factors() = factor;
+  passes.LookUp<TypeTargetTransformPass>("type_target_cast_pass")
+      ->SetValidPlaces(valid_places);
+  for (const std::string name : {"static_kernel_pick_pass",
+                                 "variable_place_inference_pass",
+                                 "type_target_cast_pass",
+                                 "variable_place_inference_pass",
+                                 "io_copy_kernel_pick_pass",
+                                 "variable_place_inference_pass",
+                                 "type_precision_cast_pass",
+                                 "variable_place_inference_pass",
+                                 "type_layout_cast_pass",
+                                 "variable_place_inference_pass"}) {
+    auto* pass = passes.LookUp(name);
+    CHECK(pass) << "no pass " << name;
+    pass->Apply(graph);
+  }
+  return graph;
+}
+
+// the op types and the layouts of the picked kernels in topological order,
+// the layout instructions are named by the layouts they convert between
+std::vector<std::string> Summarize(SSAGraph* graph) {
+  std::vector<std::string> stmts;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    auto& inst = node->AsStmt();
+    const auto& kernel = inst.picked_kernel();
+    if (inst.op_type() == "layout") {
+      stmts.push_back(
+          inst.op_type() + ":" +
+          DataLayoutToStr(kernel.GetInputDeclType("Input")->layout()) + "->" +
+          DataLayoutToStr(kernel.GetOutputDeclType("Out")->layout()));
+    } else {
+      stmts.push_back(inst.op_type() + ":" + DataLayoutToStr(kernel.layout()));
+    }
+  }
+  return stmts;
+}
+
+const std::vector<Place> kBlockedPlaces{
+    Place{TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8)},
+    Place{TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHW)},
+    Place{TARGET(kX86), PRECISION(kAny), DATALAYOUT(kNCHW)},
+    Place{TARGET(kHost), PRECISION(kFloat), DATALAYOUT(kNCHW)},
+    Place{TARGET(kHost), PRECISION(kAny), DATALAYOUT(kNCHW)},
+};
+
+}  // namespace
+
+TEST(type_layout_cast_pass, blocked_conv_relu_pool) {
+  auto scope = std::make_shared<Scope>();
+  auto graph = ApplyLayoutCast(
+      scope, BuildProgramDesc(scope, 16, 16, 1), kBlockedPlaces);
+  // The relu fed by feed is reset to NCHW, the conv anchors the blocked part
+  // and the layout instructions sit at its borders only.
+  const std::vector<std::string> expected{"feed:any",
+                                          "relu:NCHW",
+                                          "layout:NCHW->NCHWc8",
+                                          "conv2d:NCHWc8",
+                                          "relu:NCHWc8",
+                                          "pool2d:NCHWc8",
+                                          "layout:NCHWc8->NCHW",
+                                          "fc:NCHW",
+                                          "fetch:any"};
+  EXPECT_EQ(Summarize(graph.get()), expected);
+}
+
+TEST(type_layout_cast_pass, unsupported_group_conv) {
+  auto scope = std::make_shared<Scope>();
+  // 4 input channels a group can not be blocked, the ops after it go back to
+  // NCHW with it and no layout instruction is needed.
+  auto graph = ApplyLayoutCast(
+      scope, BuildProgramDesc(scope, 16, 16, 4), kBlockedPlaces);
+  const std::vector<std::string> expected{"feed:any",
+                                          "relu:NCHW",
+                                          "conv2d:NCHW",
+                                          "relu:NCHW",
+                                          "pool2d:NCHW",
+                                          "fc:NCHW",
+                                          "fetch:any"};
+  EXPECT_EQ(Summarize(graph.get()), expected);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
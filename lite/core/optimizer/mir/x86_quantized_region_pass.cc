@@ -0,0 +1,161 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/x86_quantized_region_pass.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+bool X86QuantizedRegionPass::IsInt8Supported(Node* op_node) const {
+  auto* op_info = op_node->AsStmt().op_info();
+  const std::string op_type = op_info->Type();
+  if (std::find(int8_ops_.begin(), int8_ops_.end(), op_type) ==
+      int8_ops_.end()) {
+    return true;
+  }
+  if (op_type == "fusion_elementwise_add_activation" &&
+      op_info->GetAttr<std::string>("act_type") != "relu") {
+    return false;
+  }
+  if (op_type == "elementwise_add" && op_info->HasAttr("fuse_scale") &&
+      op_info->GetAttr<bool>("fuse_scale")) {
+    return false;
+  }
+  bool has_scales = true;
+  std::string quantized_weight;
+  for (auto* in_node : op_node->inlinks) {
+    CHECK(in_node->IsArg());
+    const auto& name = in_node->arg()->name;
+    std::string argname;
+    if (!op_info->GetInputArgname(name, &argname) || argname == "AxisTensor") {
+      continue;
+    }
+    if (!op_info->HasInputScale(name)) {
+      has_scales = false;
+    } else if (in_node->arg()->is_weight) {
+      quantized_weight = name;
+    }
+  }
+  // the quantized weight of matmul can't run on the fp32 kernel either
+  if (!has_scales && !quantized_weight.empty()) {
+    LOG(FATAL) << op_type << " has the quantized weight " << quantized_weight
+               << " but not the scales of all its inputs.";
+  }
+  return has_scales;
+}
+
+bool X86QuantizedRegionPass::CanBeInt8(Node* op_node,
+                                       std::vector<float>* scale) const {
+  auto* op_info = op_node->AsStmt().op_info();
+  const std::string op_type = op_info->Type();
+  if (op_info->HasAttr("enable_int8")) return false;
+  if (op_type != "concat" &&
+      !(op_type == "pool2d" &&
+        op_info->GetAttr<std::string>("pooling_type") == "max")) {
+    return false;
+  }
+  for (auto* in_node : op_node->inlinks) {
+    CHECK(in_node->IsArg());
+    std::string argname;
+    CHECK(op_info->GetInputArgname(in_node->arg()->name, &argname));
+    if (argname == "AxisTensor") continue;
+    if (in_node->arg()->is_weight || in_node->inlinks.empty()) return false;
+    for (auto* producer : in_node->inlinks) {
+      if (!producer->AsStmt().op_info()->HasAttr("enable_int8")) return false;
+    }
+  }
+  bool has_scale = false;
+  for (auto* out_node : op_node->outlinks) {
+    CHECK(out_node->IsArg());
+    const auto& name = out_node->arg()->name;
+    if (out_node->outlinks.empty()) return false;
+    for (auto* consumer : out_node->outlinks) {
+      auto* consumer_info = consumer->AsStmt().op_info();
+      if (!consumer_info->HasAttr("enable_int8") ||
+          !consumer_info->HasInputScale(name) ||
+          consumer_info->Type() == "lstm" || consumer_info->Type() == "gru") {
+        return false;
+      }
+      if (!has_scale) {
+        *scale = consumer_info->GetInputScale(name);
+        has_scale = true;
+      }
+    }
+  }
+  return has_scale;
+}
+
+void X86QuantizedRegionPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  auto nodes = graph->StmtTopologicalOrder();
+  bool quantized = false;
+  for (auto* node : nodes) {
+    if (node->IsStmt() &&
+        node->AsStmt().op_info()->HasAttr("enable_int8")) {
+      quantized = true;
+      break;
+    }
+  }
+  if (!quantized) return;
+
+  for (auto* node : nodes) {
+    if (!node->IsStmt()) continue;
+    auto& inst = node->AsStmt();
+    if (!inst.op_info()->HasAttr("enable_int8") || IsInt8Supported(node)) {
+      continue;
+    }
+    VLOG(4) << "keep " << inst.op_type() << " fp32 for its int8 kernels";
+    auto op_desc = *inst.mutable_op_info();
+    op_desc.DeleteAttr("enable_int8");
+    inst.ResetOp(op_desc, graph->valid_places());
+  }
+
+  // an op turned int8 may let its neighbours turn int8, until none changes
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto* node : nodes) {
+      if (!node->IsStmt()) continue;
+      std::vector<float> scale;
+      if (!CanBeInt8(node, &scale)) continue;
+      auto& inst = node->AsStmt();
+      VLOG(4) << "run " << inst.op_type() << " int8 with the scale "
+              << scale[0];
+      auto op_desc = *inst.mutable_op_info();
+      op_desc.SetAttr("enable_int8", true);
+      op_desc.SetAttr<int>("bit_length", 8);
+      for (auto* in_node : node->inlinks) {
+        std::string argname;
+        CHECK(op_desc.GetInputArgname(in_node->arg()->name, &argname));
+        if (argname == "AxisTensor") continue;
+        op_desc.SetInputScale(in_node->arg()->name, scale);
+      }
+      inst.ResetOp(op_desc, graph->valid_places());
+      changed = true;
+    }
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(x86_quantized_region_pass,
+                  paddle::lite::mir::X86QuantizedRegionPass)
+    .BindTargets({TARGET(kX86)});
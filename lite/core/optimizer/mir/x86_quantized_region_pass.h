@@ -0,0 +1,55 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * Keeps the quantized regions of the x86 int8 models int8 between the convs
+ * and fcs:
+ * 1. The elementwise_add, pool2d, concat and matmul marked 'enable_int8'
+ *    by the quant fusers run on the x86 int8 kernels, which need the scales
+ *    of all their inputs. The attribute is removed from the ops their int8
+ *    kernels can't run, which stay fp32.
+ * 2. The max pool2d and concat whose outputs are consumed by the int8 ops
+ *    only, and whose inputs are produced by the int8 ops, become int8 ops
+ *    with the input scale of their consumers: max and concat don't change
+ *    the range of the data, so no calib is inserted around them.
+ */
+class X86QuantizedRegionPass : public mir::StmtPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  bool IsInt8Supported(Node* op_node) const;
+  bool CanBeInt8(Node* op_node, std::vector<float>* scale) const;
+
+  std::vector<std::string> int8_ops_{"elementwise_add",
+                                     "fusion_elementwise_add_activation",
+                                     "pool2d",
+                                     "concat",
+                                     "matmul"};
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,267 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/x86_quantized_region_pass.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/core/optimizer/mir/pass_manager.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+class QuantizedProgramBuilder {
+ public:
+  QuantizedProgramBuilder()
+      : program_desc_(std::make_shared<cpp::ProgramDesc>()),
+        scope_(std::make_shared<Scope>()) {
+    block_desc_ = program_desc_->AddBlock<cpp::BlockDesc>();
+    block_desc_->ClearOps();
+    block_desc_->ClearVars();
+  }
+
+  void AddVar(const std::string& name,
+              const std::vector<int64_t>& shape = {},
+              bool persistable = false) {
+    auto* var_desc = block_desc_->AddVar<cpp::VarDesc>();
+    var_desc->SetName(name);
+    var_desc->SetPersistable(persistable);
+    auto* tensor = scope_->Var(name)->GetMutable<Tensor>();
+    if (!shape.empty()) {
+      tensor->Resize(shape);
+      tensor->mutable_data<float>();
+      tensor->set_persistable(persistable);
+    }
+  }
+
+  // an int8 conv2d reading its input with the scale input_scale
+  void AddInt8Conv(const std::string& input,
+                   const std::string& output,
+                   float input_scale) {
+    const std::string filter = output + "_w";
+    AddVar(filter, {8, 8, 1, 1}, true);
+    AddVar(output);
+    auto* op_desc = block_desc_->AddOp<cpp::OpDesc>();
+    op_desc->SetType("conv2d");
+    op_desc->SetInput("Input", {input});
+    op_desc->SetInput("Filter", {filter});
+    op_desc->SetOutput("Output", {output});
+    op_desc->SetAttr<std::vector<int>>("strides", {1, 1});
+    op_desc->SetAttr<std::vector<int>>("paddings", {0, 0});
+    op_desc->SetAttr<std::vector<int>>("dilations", {1, 1});
+    op_desc->SetAttr<int>("groups", 1);
+    op_desc->SetAttr<bool>("enable_int8", true);
+    op_desc->SetAttr<int>("bit_length", 8);
+    op_desc->SetAttr<std::vector<float>>("Input0_scale", {input_scale});
+    op_desc->SetAttr<std::vector<float>>("Filter0_scale",
+                                         std::vector<float>(8, 0.01f));
+  }
+
+  void AddPool(const std::string& input,
+               const std::string& output,
+               const std::string& pooling_type) {
+    AddVar(output);
+    auto* op_desc = block_desc_->AddOp<cpp::OpDesc>();
+    op_desc->SetType("pool2d");
+    op_desc->SetInput("X", {input});
+    op_desc->SetOutput("Out", {output});
+    op_desc->SetAttr<std::string>("pooling_type", pooling_type);
+    op_desc->SetAttr<std::vector<int>>("ksize", {2, 2});
+    op_desc->SetAttr<bool>("global_pooling", false);
+    op_desc->SetAttr<std::vector<int>>("strides", {2, 2});
+    op_desc->SetAttr<std::vector<int>>("paddings", {0, 0});
+  }
+
+  void AddConcat(const std::vector<std::string>& inputs,
+                 const std::string& output) {
+    AddVar(output);
+    auto* op_desc = block_desc_->AddOp<cpp::OpDesc>();
+    op_desc->SetType("concat");
+    op_desc->SetInput("X", inputs);
+    op_desc->SetOutput("Out", {output});
+    op_desc->SetAttr<int>("axis", 1);
+  }
+
+  // an elementwise_add marked int8 by the quant fusers, the scales of x and
+  // y are set if given
+  cpp::OpDesc* AddInt8ElementwiseAdd(const std::string& op_type,
+                                     const std::string& x,
+                                     const std::string& y,
+                                     const std::string& output,
+                                     const std::vector<float>& x_scale,
+                                     const std::vector<float>& y_scale) {
+    AddVar(output);
+    auto* op_desc = block_desc_->AddOp<cpp::OpDesc>();
+    op_desc->SetType(op_type);
+    op_desc->SetInput("X", {x});
+    op_desc->SetInput("Y", {y});
+    op_desc->SetOutput("Out", {output});
+    op_desc->SetAttr<int>("axis", -1);
+    op_desc->SetAttr<bool>("enable_int8", true);
+    op_desc->SetAttr<int>("bit_length", 8);
+    if (!x_scale.empty()) {
+      op_desc->SetAttr<std::vector<float>>("X0_scale", x_scale);
+    }
+    if (!y_scale.empty()) {
+      op_desc->SetAttr<std::vector<float>>("Y0_scale", y_scale);
+    }
+    return op_desc;
+  }
+
+  cpp::BlockDesc* block_desc() { return block_desc_; }
+
+  // builds the graph and applies x86_quantized_region_pass on it
+  std::unique_ptr<SSAGraph> Apply() {
+    const std::vector<Place> valid_places{
+        Place{TARGET(kX86), PRECISION(kInt8)},
+        Place{TARGET(kX86), PRECISION(kFloat)},
+    };
+    Program program(program_desc_, scope_, valid_places);
+    std::unique_ptr<SSAGraph> graph(new SSAGraph);
+    graph->Build(program, valid_places);
+    graph->SetValidPlaces(valid_places);
+    auto* pass = PassManager::Global().LookUp("x86_quantized_region_pass");
+    CHECK(pass);
+    pass->Apply(graph);
+    return graph;
+  }
+
+ private:
+  std::shared_ptr<cpp::ProgramDesc> program_desc_;
+  std::shared_ptr<Scope> scope_;
+  cpp::BlockDesc* block_desc_{nullptr};
+};
+
+// the op info of the statement writing output
+const OpInfo* FindOpInfo(SSAGraph* graph, const std::string& output) {
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    auto* op_info = node->AsStmt().op_info();
+    auto outputs = op_info->output_names();
+    if (std::find(outputs.begin(), outputs.end(), output) != outputs.end()) {
+      return op_info;
+    }
+  }
+  LOG(FATAL) << "no op writes " << output;
+  return nullptr;
+}
+
+}  // namespace
+
+TEST(x86_quantized_region_pass, promote_max_pool2d_and_concat) {
+  QuantizedProgramBuilder builder;
+  builder.AddVar("x");
+  builder.AddInt8Conv("x", "a", 0.1f);
+  builder.AddInt8Conv("x", "b", 0.1f);
+  // max pool2d and concat between the int8 ops take the input scale of
+  // their consumers
+  builder.AddPool("a", "max_out", "max");
+  builder.AddInt8Conv("max_out", "c", 0.2f);
+  builder.AddConcat({"a", "b"}, "concat_out");
+  builder.AddInt8Conv("concat_out", "d", 0.3f);
+  // avg pool2d changes the range, and the max pool2d read by a fp32 op has
+  // no output scale to take
+  builder.AddPool("b", "avg_out", "avg");
+  builder.AddInt8Conv("avg_out", "e", 0.4f);
+  builder.AddPool("b", "fp32_max_out", "max");
+  builder.AddPool("fp32_max_out", "f", "avg");
+  auto graph = builder.Apply();
+
+  auto* max_pool = FindOpInfo(graph.get(), "max_out");
+  ASSERT_TRUE(max_pool->HasAttr("enable_int8"));
+  EXPECT_EQ(max_pool->GetAttr<int>("bit_length"), 8);
+  EXPECT_EQ(max_pool->GetInputScale("a"), std::vector<float>{0.2f});
+
+  auto* concat = FindOpInfo(graph.get(), "concat_out");
+  ASSERT_TRUE(concat->HasAttr("enable_int8"));
+  EXPECT_EQ(concat->GetInputScale("a"), std::vector<float>{0.3f});
+  EXPECT_EQ(concat->GetInputScale("b"), std::vector<float>{0.3f});
+
+  EXPECT_FALSE(FindOpInfo(graph.get(), "avg_out")->HasAttr("enable_int8"));
+  EXPECT_FALSE(
+      FindOpInfo(graph.get(), "fp32_max_out")->HasAttr("enable_int8"));
+}
+
+TEST(x86_quantized_region_pass, keep_unsupported_ops_fp32) {
+  QuantizedProgramBuilder builder;
+  builder.AddVar("x");
+  builder.AddInt8Conv("x", "a", 0.1f);
+  builder.AddInt8Conv("x", "b", 0.1f);
+  builder.AddInt8ElementwiseAdd(
+      "elementwise_add", "a", "b", "add_out", {0.1f}, {0.2f});
+  builder
+      .AddInt8ElementwiseAdd("fusion_elementwise_add_activation",
+                             "a",
+                             "b",
+                             "add_relu_out",
+                             {0.1f},
+                             {0.2f})
+      ->SetAttr<std::string>("act_type", "relu");
+  // the int8 kernels run relu only, and need the scales of all the inputs
+  builder
+      .AddInt8ElementwiseAdd("fusion_elementwise_add_activation",
+                             "a",
+                             "b",
+                             "add_sigmoid_out",
+                             {0.1f},
+                             {0.2f})
+      ->SetAttr<std::string>("act_type", "sigmoid");
+  builder.AddInt8ElementwiseAdd(
+      "elementwise_add", "a", "b", "no_y_scale_out", {0.1f}, {});
+  auto graph = builder.Apply();
+
+  EXPECT_TRUE(FindOpInfo(graph.get(), "add_out")->HasAttr("enable_int8"));
+  EXPECT_TRUE(
+      FindOpInfo(graph.get(), "add_relu_out")->HasAttr("enable_int8"));
+  EXPECT_FALSE(
+      FindOpInfo(graph.get(), "add_sigmoid_out")->HasAttr("enable_int8"));
+  EXPECT_FALSE(
+      FindOpInfo(graph.get(), "no_y_scale_out")->HasAttr("enable_int8"));
+}
+
+TEST(x86_quantized_region_pass, quantized_weight_without_scales) {
+  QuantizedProgramBuilder builder;
+  builder.AddVar("x");
+  builder.AddInt8Conv("x", "a", 0.1f);
+  // the quantized weight can't be read by the fp32 kernel either
+  builder.AddVar("w", {8, 8}, true);
+  auto* matmul = builder.block_desc()->AddOp<cpp::OpDesc>();
+  builder.AddVar("matmul_out");
+  matmul->SetType("matmul");
+  matmul->SetInput("X", {"a"});
+  matmul->SetInput("Y", {"w"});
+  matmul->SetOutput("Out", {"matmul_out"});
+  matmul->SetAttr<bool>("transpose_X", false);
+  matmul->SetAttr<bool>("transpose_Y", false);
+  matmul->SetAttr<float>("alpha", 1.f);
+  matmul->SetAttr<bool>("enable_int8", true);
+  matmul->SetAttr<int>("bit_length", 8);
+  matmul->SetAttr<std::vector<float>>("Y0_scale", std::vector<float>(8, 0.01f));
+  ASSERT_DEATH(builder.Apply(), "");
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
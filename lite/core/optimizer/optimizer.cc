@@ -150,6 +150,7 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        "lite_conv_activation_fuse_pass",              //
        "lite_var_conv_2d_activation_fuse_pass",       //
        "lite_match_matrix_activation_fuse_pass",      //
+       "lite_multihead_attention_fuse_pass",          //
        "lite_squeeze2_matmul_fuse_pass",              //
        "lite_reshape2_matmul_fuse_pass",              //
        "lite_matmul_element_add_fuse_pass",           //
@@ -212,6 +213,9 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        // inputs and outputs must have the same scale.
        "restrict_quantized_op_with_same_input_output_scale_pass",
        "quantization_parameters_removal_pass",
+       // Keep the pool2d, concat, elementwise_add and matmul between the x86
+       // int8 ops int8.
+       "x86_quantized_region_pass",
        "nnadapter_subgraph_pass",
        "npu_subgraph_pass",
        "xpu_subgraph_pass",
@@ -0,0 +1,180 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/profile/perf_counter.h"
+#include <string.h>
+#if defined(__linux__)
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include <atomic>
+#include "lite/utils/log/logging.h"
+
+namespace paddle {
+namespace lite {
+namespace profile {
+
+const char* PerfEventName(PerfEvent event) {
+  switch (event) {
+    case kPerfCycles:
+      return "cycles";
+    case kPerfInstructions:
+      return "instructions";
+    case kPerfL1DMisses:
+      return "L1D misses";
+    case kPerfLLCMisses:
+      return "LLC misses";
+    case kPerfBranchMisses:
+      return "branch misses";
+    default:
+      return "unknown";
+  }
+}
+
+void PerfCounts::Add(const PerfCounts& other) {
+  for (int i = 0; i < kNumPerfEvents; ++i) {
+    values[i] += other.values[i];
+  }
+  counted = intervals == 0 ? other.counted : (counted & other.counted);
+  intervals += other.intervals;
+}
+
+PerfCounters& PerfCounters::ThisThread() {
+  static thread_local PerfCounters counters;
+  return counters;
+}
+
+#if defined(__linux__)
+namespace {
+
+bool EventAttr(int event, perf_event_attr* attr) {
+  memset(attr, 0, sizeof(*attr));
+  attr->size = sizeof(*attr);
+  attr->disabled = 0;
+  attr->exclude_kernel = 1;
+  attr->exclude_hv = 1;
+  attr->read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  switch (event) {
+    case kPerfCycles:
+      attr->type = PERF_TYPE_HARDWARE;
+      attr->config = PERF_COUNT_HW_CPU_CYCLES;
+      return true;
+    case kPerfInstructions:
+      attr->type = PERF_TYPE_HARDWARE;
+      attr->config = PERF_COUNT_HW_INSTRUCTIONS;
+      return true;
+    case kPerfL1DMisses:
+      attr->type = PERF_TYPE_HW_CACHE;
+      attr->config = PERF_COUNT_HW_CACHE_L1D |
+                     (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      return true;
+    case kPerfLLCMisses:
+      attr->type = PERF_TYPE_HARDWARE;
+      attr->config = PERF_COUNT_HW_CACHE_MISSES;
+      return true;
+    case kPerfBranchMisses:
+      attr->type = PERF_TYPE_HARDWARE;
+      attr->config = PERF_COUNT_HW_BRANCH_MISSES;
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+PerfCounters::PerfCounters() {
+  static std::atomic<bool> warned{false};
+  int error = 0;
+  for (int i = 0; i < kNumPerfEvents; ++i) {
+    perf_event_attr attr;
+    fds_[i] = -1;
+    if (!EventAttr(i, &attr)) continue;
+    // the calling thread on any CPU
+    fds_[i] = static_cast<int>(
+        syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    if (fds_[i] < 0) {
+      if (error == 0) error = errno;
+      continue;
+    }
+    supported_ |= 1u << i;
+  }
+  if (supported_ != (1u << kNumPerfEvents) - 1 && !warned.exchange(true)) {
+    std::string missing;
+    for (int i = 0; i < kNumPerfEvents; ++i) {
+      if (fds_[i] >= 0) continue;
+      missing += std::string(missing.empty() ? "" : ", ") +
+                 PerfEventName(static_cast<PerfEvent>(i));
+    }
+    LOG(WARNING) << "Failed to open the hardware counters of " << missing
+                 << ": " << strerror(error)
+                 << ", check /proc/sys/kernel/perf_event_paranoid or the "
+                    "seccomp profile of the container.";
+  }
+}
+
+PerfCounters::~PerfCounters() {
+  for (int i = 0; i < kNumPerfEvents; ++i) {
+    if (fds_[i] >= 0) close(fds_[i]);
+  }
+}
+
+bool PerfCounters::Read(int event, Reading* reading) const {
+  return fds_[event] >= 0 &&
+         read(fds_[event], reading, sizeof(*reading)) ==
+             static_cast<ssize_t>(sizeof(*reading));
+}
+#else
+PerfCounters::PerfCounters() {
+  for (int i = 0; i < kNumPerfEvents; ++i) {
+    fds_[i] = -1;
+  }
+  LOG(WARNING) << "The hardware counters are only supported on Linux.";
+}
+
+PerfCounters::~PerfCounters() {}
+
+bool PerfCounters::Read(int event, Reading* reading) const { return false; }
+#endif
+
+void PerfCounters::Start() {
+  for (int i = 0; i < kNumPerfEvents; ++i) {
+    if (!Read(i, &start_[i])) start_[i] = Reading{0, 0, 0};
+  }
+}
+
+PerfCounts PerfCounters::Stop() {
+  PerfCounts counts;
+  counts.intervals = 1;
+  for (int i = 0; i < kNumPerfEvents; ++i) {
+    Reading stop;
+    if (!Read(i, &stop)) continue;
+    uint64_t enabled = stop.time_enabled - start_[i].time_enabled;
+    uint64_t running = stop.time_running - start_[i].time_running;
+    // not scheduled on the PMU during the interval
+    if (running == 0 && enabled > 0) continue;
+    double value = static_cast<double>(stop.value - start_[i].value);
+    counts.values[i] = running > 0 ? value * enabled / running : value;
+    counts.counted |= 1u << i;
+  }
+  return counts;
+}
+
+}  // namespace profile
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,85 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace paddle {
+namespace lite {
+namespace profile {
+
+// The hardware events counted for every kernel launch.
+enum PerfEvent {
+  kPerfCycles = 0,
+  kPerfInstructions,
+  kPerfL1DMisses,
+  kPerfLLCMisses,
+  kPerfBranchMisses,
+  kNumPerfEvents,
+};
+
+const char* PerfEventName(PerfEvent event);
+
+// The counts of the events in one or more intervals.
+struct PerfCounts {
+  double values[kNumPerfEvents]{};
+  // the bit of an event is set if it is counted in every interval
+  uint32_t counted{0};
+  int intervals{0};
+
+  bool has(PerfEvent event) const { return (counted >> event) & 1u; }
+  double value(PerfEvent event) const { return values[event]; }
+  void Add(const PerfCounts& other);
+};
+
+/*
+ * PerfCounters counts the hardware events of the calling thread with
+ * perf_event_open on Linux. The counters run since they are opened, Start and
+ * Stop read them, so the counts of an interval are the differences, scaled by
+ * the time the counters are scheduled when the PMU is multiplexed.
+ *
+ * The counters can not be opened in many containers and VMs, or if
+ * /proc/sys/kernel/perf_event_paranoid forbids it, available() is false then
+ * and Stop returns no counted event. The events the PMU lacks are left out.
+ */
+class PerfCounters {
+ public:
+  // The counters of the calling thread, opened on the first call.
+  static PerfCounters& ThisThread();
+
+  ~PerfCounters();
+
+  bool available() const { return supported_ != 0; }
+  void Start();
+  PerfCounts Stop();
+
+ private:
+  struct Reading {
+    uint64_t value;
+    uint64_t time_enabled;
+    uint64_t time_running;
+  };
+
+  PerfCounters();
+  bool Read(int event, Reading* reading) const;
+
+  int fds_[kNumPerfEvents];
+  uint32_t supported_{0};
+  Reading start_[kNumPerfEvents]{};
+};
+
+}  // namespace profile
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,83 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/profile/perf_counter.h"
+#include <gtest/gtest.h>
+#include "lite/core/profile/profiler.h"
+
+namespace paddle {
+namespace lite {
+namespace profile {
+
+TEST(PerfCounts, add) {
+  PerfCounts a;
+  a.values[kPerfCycles] = 10;
+  a.values[kPerfInstructions] = 20;
+  a.counted = (1u << kPerfCycles) | (1u << kPerfInstructions);
+  a.intervals = 1;
+  PerfCounts b = a;
+  b.counted = 1u << kPerfCycles;
+  PerfCounts sum;
+  sum.Add(a);
+  sum.Add(b);
+  EXPECT_EQ(sum.intervals, 2);
+  EXPECT_DOUBLE_EQ(sum.value(kPerfCycles), 20);
+  EXPECT_TRUE(sum.has(kPerfCycles));
+  // not counted in every interval
+  EXPECT_FALSE(sum.has(kPerfInstructions));
+}
+
+TEST(PerfCounters, count_loop) {
+  auto& counters = PerfCounters::ThisThread();
+  if (!counters.available()) {
+    LOG(INFO) << "The hardware counters are not available, skipped.";
+    return;
+  }
+  counters.Start();
+  volatile float x = 0.f;
+  for (int i = 0; i < 1000000; ++i) {
+    x = x + 1.f;
+  }
+  auto counts = counters.Stop();
+  EXPECT_EQ(counts.intervals, 1);
+  if (counts.has(kPerfInstructions)) {
+    EXPECT_GT(counts.value(kPerfInstructions), 1e6);
+  }
+}
+
+TEST(Profiler, hardware_counters_summary) {
+  Profiler profiler("perf");
+  profiler.set_hardware_counters(true);
+  OpCharacter ch;
+  ch.target = TargetType::kHost;
+  ch.op_type = "loop";
+  ch.macs = 1e6;
+  int idx = profiler.NewTimer(ch);
+  for (int run = 0; run < 3; ++run) {
+    profiler.StartTiming(Type::kDispatch, idx, nullptr);
+    volatile float x = 0.f;
+    for (int i = 0; i < 1000000; ++i) {
+      x = x + 1.f;
+    }
+    profiler.StopTiming(Type::kDispatch, idx, nullptr);
+  }
+  auto summary = profiler.Summary(Type::kDispatch, false, 1);
+  // the counters are turned off if they can not be opened
+  EXPECT_EQ(summary.find("IPC") != std::string::npos,
+            profiler.hardware_counters());
+}
+
+}  // namespace profile
+}  // namespace lite
+}  // namespace paddle
@@ -17,6 +17,7 @@
 #include <map>
 #include <string>
 #include <utility>
+#include "lite/utils/env.h"
 
 namespace paddle {
 namespace lite {
@@ -28,8 +29,94 @@ auto op_comp = [](const OpCharacter& c1, const OpCharacter& c2) {
   return (c1.kernel_name + c1.kernel_func_name <
           c2.kernel_name + c2.kernel_func_name);
 };
+
+// The memory traffic of a last level cache miss.
+const float kCacheLineBytes = 64.f;
+
+// The average counts of a run, excluding `w` warm-ups.
+PerfCounts PerfCountsPerRun(const StatisUnit& unit, size_t w) {
+  PerfCounts sum;
+  for (size_t i = w; i < unit.perf_counts.size(); ++i) {
+    sum.Add(unit.perf_counts[i]);
+  }
+  PerfCounts res;
+  res.counted = sum.counted;
+  res.intervals = 1;
+  for (int i = 0; i < kNumPerfEvents; ++i) {
+    if (sum.intervals > 0) res.values[i] = sum.values[i] / sum.intervals;
+  }
+  return res;
+}
+
+// The detailed summary has a GOPS column already.
+std::string PerfHeader(bool with_gops) {
+  using std::setw;
+  using std::left;
+  STL::stringstream ss;
+  ss << " " << setw(10) << left << "Cycles(M)"
+     << " " << setw(10) << left << "Instr(M)"
+     << " " << setw(5) << left << "IPC"
+     << " " << setw(10) << left << "L1DMiss(K)"
+     << " " << setw(10) << left << "LLCMiss(K)"
+     << " " << setw(9) << left << "BrMiss(K)";
+  if (with_gops) {
+    ss << " " << setw(7) << left << "GOPS";
+  }
+  ss << " " << setw(7) << left << "Bytes/Op";
+  return ss.str();
+}
+
+// The counts of a run of the kernel, `gops` and `ms` are the ops and the time
+// of a run.
+std::string PerfColumns(const PerfCounts& counts,
+                        float gops,
+                        float ms,
+                        bool with_gops) {
+  using std::setw;
+  using std::left;
+  using std::fixed;
+  using std::setprecision;
+  STL::stringstream ss;
+  auto column = [&](PerfEvent event, float scale, int width) {
+    ss << " " << setw(width) << left;
+    if (counts.has(event)) {
+      ss << fixed << setprecision(3) << scale * counts.value(event);
+    } else {
+      ss << "N/A";
+    }
+  };
+  column(kPerfCycles, 1e-6f, 10);
+  column(kPerfInstructions, 1e-6f, 10);
+  ss << " " << setw(5) << left;
+  if (counts.has(kPerfCycles) && counts.has(kPerfInstructions) &&
+      counts.value(kPerfCycles) > 0) {
+    ss << fixed << setprecision(2)
+       << counts.value(kPerfInstructions) / counts.value(kPerfCycles);
+  } else {
+    ss << "N/A";
+  }
+  column(kPerfL1DMisses, 1e-3f, 10);
+  column(kPerfLLCMisses, 1e-3f, 10);
+  column(kPerfBranchMisses, 1e-3f, 9);
+  if (with_gops) {
+    ss << " " << setw(7) << left << fixed << setprecision(2)
+       << (ms > 0 ? 1e3f * gops / ms : 0.f);
+  }
+  ss << " " << setw(7) << left;
+  if (counts.has(kPerfLLCMisses) && gops > 0) {
+    ss << fixed << setprecision(3)
+       << kCacheLineBytes * counts.value(kPerfLLCMisses) / (1e9f * gops);
+  } else {
+    ss << "N/A";
+  }
+  return ss.str();
+}
 }  // namespace
 
+bool Profiler::HardwareCountersFromEnv() {
+  return GetBoolFromEnv("PADDLE_LITE_PROFILE_PERF_COUNTERS");
+}
+
 std::map<Type, std::string> TypeStr{
     {Type::kUnk, "Unknown"},
     {Type::kCreate, "Create"},
@@ -76,11 +163,22 @@ void Profiler::StartTiming(Type type, const int index, KernelContext* ctx) {
   CHECK_LT(index, units_.size())
       << "The timer index in the profiler is out of range.";
   units_[index].Timer(type)->Start(ctx);
+  if (hardware_counters_ && type == Type::kDispatch) {
+    auto& counters = PerfCounters::ThisThread();
+    if (counters.available()) {
+      counters.Start();
+    } else {
+      hardware_counters_ = false;
+    }
+  }
 }
 
 void Profiler::StopTiming(Type type, const int index, KernelContext* ctx) {
   CHECK_LT(index, units_.size())
       << "The timer index in the profiler is out of range.";
+  if (hardware_counters_ && type == Type::kDispatch) {
+    units_[index].perf_counts.push_back(PerfCounters::ThisThread().Stop());
+  }
 #ifdef LITE_WITH_OPENCL
   units_[index].Timer(type)->CLStop(units_[index].character.op_type,
                                     units_[index].character.io_duration,
@@ -136,6 +234,11 @@ std::string Profiler::Summary(Type type, bool concise, size_t w) {
        << " Profiler Summary: " << name_ << ", Exclude " << w
        << " warm-ups =====" << std::endl;
   }
+  const bool perf = hardware_counters_ && type == Type::kDispatch;
+  if (perf) {
+    ss << "Hardware counts per run, of the thread dispatching the kernel"
+       << std::endl;
+  }
   ss << setw(20) << left << "OperatorType"
      << " " << setw(30) << left << "KerneAttr(Place)"
      << " " << setw(24) << left << "KernelFuncName";
@@ -159,6 +262,9 @@ std::string Profiler::Summary(Type type, bool concise, size_t w) {
   if (concise) {
     ss << " " << setw(11) << left << "CalledTimes";
   }
+  if (perf) {
+    ss << PerfHeader(concise);
+  }
 #ifdef LITE_WITH_OPENCL
   ss << " " << setw(9) << left << "clAvg(ms)"
      << " " << setw(9) << left << "clMin(ms)"
@@ -174,7 +280,11 @@ std::string Profiler::Summary(Type type, bool concise, size_t w) {
   // Profile information.
   if (concise) {
     std::map<OpCharacter, TimeInfo, decltype(op_comp)> summary(op_comp);
+    std::map<OpCharacter, PerfCounts, decltype(op_comp)> perf_summary(op_comp);
     for (auto& unit : units_) {
+      if (perf) {
+        perf_summary[unit.Character()].Add(PerfCountsPerRun(unit, w));
+      }
       auto ch = summary.find(unit.Character());
       if (ch != summary.end()) {
         ch->second.avg += unit.Timer(type)->LapTimes().Avg(w);
@@ -235,6 +345,14 @@ std::string Profiler::Summary(Type type, bool concise, size_t w) {
          << GetKernelFuncCalledTimes(item.first.op_type,
                                      item.first.kernel_attr,
                                      item.first.kernel_func_name);
+      if (perf) {
+        ss << PerfColumns(perf_summary.find(item.first)->second,
+                          GetKernelFuncSummaryGOPs(item.first.op_type,
+                                                   item.first.kernel_attr,
+                                                   item.first.kernel_func_name),
+                          item.second.avg,
+                          true);
+      }
 #ifdef LITE_WITH_OPENCL
       float cl_percent = 0;
       if (cl_total > 0) {
@@ -300,6 +418,12 @@ std::string Profiler::Summary(Type type, bool concise, size_t w) {
          << " " << setw(7) << left << fixed << setprecision(2)
                 << 1e-6f * unit.Character().macs / times.Avg(w);
 // clang-format on
+      if (perf) {
+        ss << PerfColumns(PerfCountsPerRun(unit, w),
+                          1e-9f * unit.Character().macs,
+                          times.Avg(w),
+                          false);
+      }
 #ifdef LITE_WITH_OPENCL
       ss << " " << setw(9) << left << fixed << setprecision(3)
          << cl_times.Avg(w) << " " << setw(9) << left << fixed
@@ -17,6 +17,7 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include "lite/core/profile/perf_counter.h"
 #include "lite/core/profile/timer.h"
 #include "lite/core/tensor.h"
 #include "lite/utils/replace_stl/stream.h"
@@ -114,6 +115,8 @@ class StatisUnit final {
   OpCharacter& Character() { return character; }
 
   OpCharacter character;
+  // the hardware counts of every dispatch, see Profiler::hardware_counters
+  std::vector<PerfCounts> perf_counts;
 
  protected:
   std::unique_ptr<lite::profile::Timer> create_t;
@@ -136,9 +139,19 @@ class Profiler final {
                                  const std::string& kernel_func_name);
   OpCharacter* GetOpCharacter(const size_t index);
 
+  // Counts the hardware events of every kernel dispatch with PerfCounters,
+  // Summary of kDispatch adds the counts per run and the IPC, GOPS and bytes
+  // per op derived from them. It is on if PADDLE_LITE_PROFILE_PERF_COUNTERS
+  // is set, and turned off when the counters can not be opened.
+  void set_hardware_counters(bool enabled) { hardware_counters_ = enabled; }
+  bool hardware_counters() const { return hardware_counters_; }
+
  private:
   std::string name_{std::string("N/A")};
   std::vector<StatisUnit> units_;
+  bool hardware_counters_{HardwareCountersFromEnv()};
+
+  static bool HardwareCountersFromEnv();
 };
 
 }  // namespace profile
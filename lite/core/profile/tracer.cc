@@ -0,0 +1,191 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/profile/tracer.h"
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <fstream>
+#include <utility>
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+#include "lite/utils/log/logging.h"
+
+namespace paddle {
+namespace lite {
+namespace profile {
+
+namespace {
+// The name of the calling thread, see Tracer::SetThreadName.
+thread_local std::string gThreadName;
+}  // namespace
+
+std::atomic<bool> Tracer::enabled_{false};
+
+Tracer& Tracer::Global() {
+  static auto* x = new Tracer;
+  return *x;
+}
+
+int64_t Tracer::NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+std::shared_ptr<Tracer::ThreadBuffer>& Tracer::LocalBuffer() {
+  static thread_local std::shared_ptr<ThreadBuffer> buffer;
+  return buffer;
+}
+
+Tracer::ThreadBuffer* Tracer::CurrentBuffer() {
+  auto& buffer = LocalBuffer();
+  if (buffer == nullptr) {
+    buffer = std::make_shared<ThreadBuffer>();
+    buffer->name = gThreadName;
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer->tid = next_tid_++;
+    buffers_.push_back(buffer);
+  }
+  return buffer.get();
+}
+
+void Tracer::SetThreadName(const std::string& name) {
+  gThreadName = name;
+  auto& buffer = LocalBuffer();
+  if (buffer != nullptr) {
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    buffer->name = name;
+  }
+}
+
+void Tracer::Start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // The buffers of the exited threads are only kept by the tracer.
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  for (auto& buffer : buffers_) {
+    if (buffer.use_count() > 1) buffers.push_back(buffer);
+  }
+  buffers_.swap(buffers);
+  ++generation_;
+  start_us_ = NowUs();
+  enabled_ = true;
+}
+
+void Tracer::Add(Event&& event) {
+  auto* buffer = CurrentBuffer();
+  std::lock_guard<std::mutex> lock(buffer->mutex);
+  int generation = generation_.load();
+  if (buffer->generation != generation) {
+    // the events of the previous trace
+    buffer->events.clear();
+    buffer->generation = generation;
+  }
+  buffer->events.push_back(std::move(event));
+}
+
+void Tracer::AddComplete(const char* category,
+                         const std::string& name,
+                         int64_t begin_us,
+                         int64_t end_us,
+                         const std::string& args) {
+  Add({'X', category, name, begin_us, end_us - begin_us, args});
+}
+
+void Tracer::AddInstant(const char* category,
+                        const std::string& name,
+                        const std::string& args) {
+  Add({'i', category, name, NowUs(), 0, args});
+}
+
+bool Tracer::Stop(const std::string& path) {
+  enabled_ = false;
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::ofstream file(path.c_str());
+  if (!file.is_open()) {
+    LOG(WARNING) << "Failed to write the trace " << path;
+    return false;
+  }
+#if !defined(_WIN32)
+  const int64_t pid = getpid();
+#else
+  const int64_t pid = 0;
+#endif
+  int64_t events = 0;
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (auto& buffer : buffers_) {
+    std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+    if (buffer->generation != generation_ || buffer->events.empty()) {
+      continue;
+    }
+    std::string name = buffer->name.empty()
+                           ? "thread " + std::to_string(buffer->tid)
+                           : buffer->name;
+    file << (events > 0 ? ",\n" : "\n") << "{\"ph\":\"M\",\"pid\":" << pid
+         << ",\"tid\":" << buffer->tid
+         << ",\"name\":\"thread_name\",\"args\":{\"name\":"
+         << JsonString(name) << "}}";
+    for (auto& event : buffer->events) {
+      file << ",\n{\"ph\":\"" << event.phase << "\",\"cat\":\""
+           << event.category << "\",\"name\":" << JsonString(event.name)
+           << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+           << ",\"ts\":" << event.ts - start_us_;
+      if (event.phase == 'X') {
+        file << ",\"dur\":" << event.dur;
+      } else {
+        file << ",\"s\":\"t\"";
+      }
+      if (!event.args.empty()) file << ",\"args\":" << event.args;
+      file << "}";
+    }
+    events += buffer->events.size();
+  }
+  file << "\n]}\n";
+  file.close();
+  LOG(INFO) << "Wrote " << events << " trace events to " << path;
+  return !file.fail();
+}
+
+std::string JsonString(const std::string& str) {
+  std::string res = "\"";
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        res += "\\\"";
+        break;
+      case '\\':
+        res += "\\\\";
+        break;
+      case '\n':
+        res += "\\n";
+        break;
+      case '\t':
+        res += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char buf[8];
+          snprintf(buf, sizeof(buf), "\\u%04x", c);
+          res += buf;
+        } else {
+          res += c;
+        }
+    }
+  }
+  return res + "\"";
+}
+
+}  // namespace profile
+}  // namespace lite
+}  // namespace paddle
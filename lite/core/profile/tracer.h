@@ -0,0 +1,133 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace profile {
+
+/*
+ * Tracer records a timeline of the runtime in the Chrome trace event format,
+ * which chrome://tracing and ui.perfetto.dev open: the runs of the programs,
+ * their instructions with the op type, kernel and shapes, the parallel
+ * regions executed by every thread pool worker, and the memory allocations.
+ *
+ * Unlike Profiler it is built without LITE_WITH_PROFILE and switched at
+ * runtime by Start and Stop, the hooks only test one atomic flag when it is
+ * off. Every thread appends its events to its own buffer, they are merged by
+ * Stop.
+ */
+class Tracer {
+ public:
+  static Tracer& Global();
+
+  // Starts recording, the events recorded before are dropped.
+  void Start();
+  // Stops recording and writes the events into `path` as JSON, returns false
+  // if the file can not be written.
+  bool Stop(const std::string& path);
+
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+  static int64_t NowUs();
+
+  // A span of the calling thread, `args` is a JSON object or empty.
+  void AddComplete(const char* category,
+                   const std::string& name,
+                   int64_t begin_us,
+                   int64_t end_us,
+                   const std::string& args = "");
+  // A point in time of the calling thread.
+  void AddInstant(const char* category,
+                  const std::string& name,
+                  const std::string& args = "");
+
+  // Names the calling thread in the timeline.
+  static void SetThreadName(const std::string& name);
+
+ private:
+  struct Event {
+    char phase;
+    const char* category;
+    std::string name;
+    int64_t ts;
+    int64_t dur;
+    std::string args;
+  };
+  struct ThreadBuffer {
+    int tid;
+    std::string name;
+    // the generation of Start the events belong to
+    int generation{0};
+    std::vector<Event> events;
+    std::mutex mutex;
+  };
+
+  Tracer() = default;
+  // The buffer of the calling thread, it is shared with buffers_ so the
+  // events of the exited threads are kept.
+  static std::shared_ptr<ThreadBuffer>& LocalBuffer();
+  ThreadBuffer* CurrentBuffer();
+  void Add(Event&& event);
+
+  static std::atomic<bool> enabled_;
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+  int next_tid_{0};
+  std::atomic<int> generation_{0};
+  int64_t start_us_{0};
+};
+
+// Records the lifetime of the scope as a span when the tracer is on, the name
+// and the args are only set if it is active.
+class TraceSpan {
+ public:
+  explicit TraceSpan(const char* category, const char* name = "")
+      : category_(category),
+        active_(Tracer::enabled()),
+        begin_us_(active_ ? Tracer::NowUs() : 0) {
+    if (active_) name_ = name;
+  }
+  ~TraceSpan() {
+    if (active_) {
+      Tracer::Global().AddComplete(
+          category_, name_, begin_us_, Tracer::NowUs(), args_);
+    }
+  }
+
+  bool active() const { return active_; }
+  void set_name(const std::string& name) { name_ = name; }
+  // `args` is a JSON object.
+  void set_args(const std::string& args) { args_ = args; }
+
+ private:
+  const char* category_;
+  bool active_;
+  int64_t begin_us_;
+  std::string name_;
+  std::string args_;
+};
+
+// Quotes `str` as a JSON string.
+std::string JsonString(const std::string& str);
+
+}  // namespace profile
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,92 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/profile/tracer.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+
+namespace paddle {
+namespace lite {
+namespace profile {
+
+std::string ReadTrace(const std::string& path) {
+  std::ifstream file(path.c_str());
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+size_t Count(const std::string& str, const std::string& sub) {
+  size_t res = 0;
+  for (auto pos = str.find(sub); pos != std::string::npos;
+       pos = str.find(sub, pos + 1)) {
+    ++res;
+  }
+  return res;
+}
+
+TEST(Tracer, record_spans_of_threads) {
+  const std::string path = "tracer_test.json";
+  auto& tracer = Tracer::Global();
+  { TraceSpan span("test", "before"); }
+  tracer.Start();
+  EXPECT_TRUE(Tracer::enabled());
+  {
+    TraceSpan span("test", "main");
+    span.set_args("{\"a\":1}");
+  }
+  std::thread worker([] {
+    Tracer::SetThreadName("test \"worker\"");
+    TraceSpan span("test", "worker");
+  });
+  worker.join();
+  tracer.AddInstant("test", "instant");
+  ASSERT_TRUE(tracer.Stop(path));
+  EXPECT_FALSE(Tracer::enabled());
+  { TraceSpan span("test", "after"); }
+
+  auto trace = ReadTrace(path);
+  EXPECT_EQ(trace.find("\"before\""), std::string::npos);
+  EXPECT_EQ(trace.find("\"after\""), std::string::npos);
+  EXPECT_NE(trace.find("\"name\":\"main\""), std::string::npos);
+  EXPECT_NE(trace.find("\"args\":{\"a\":1}"), std::string::npos);
+  // the worker has exited, its events are kept
+  EXPECT_NE(trace.find("\"name\":\"worker\""), std::string::npos);
+  EXPECT_NE(trace.find("\"test \\\"worker\\\"\""), std::string::npos);
+  EXPECT_EQ(Count(trace, "\"ph\":\"X\""), 2u);
+  EXPECT_EQ(Count(trace, "\"ph\":\"i\""), 1u);
+  EXPECT_EQ(Count(trace, "\"ph\":\"M\""), 2u);
+
+  // a new trace drops the events of the previous one
+  tracer.Start();
+  { TraceSpan span("test", "second"); }
+  ASSERT_TRUE(tracer.Stop(path));
+  trace = ReadTrace(path);
+  EXPECT_EQ(trace.find("\"main\""), std::string::npos);
+  EXPECT_EQ(Count(trace, "\"ph\":\"X\""), 1u);
+  std::remove(path.c_str());
+}
+
+TEST(Tracer, json_string) {
+  EXPECT_EQ(JsonString("a\"b\\c\n"), "\"a\\\"b\\\\c\\n\"");
+  EXPECT_EQ(JsonString(std::string(1, '\x01')), "\"\\u0001\"");
+}
+
+}  // namespace profile
+}  // namespace lite
+}  // namespace paddle
@@ -18,6 +18,7 @@
 #include <map>
 #include <set>
 
+#include "lite/core/profile/tracer.h"
 #include "lite/model_parser/cpp_desc.h"
 #include "lite/operators/conditional_block_op.h"
 #include "lite/operators/subgraph_op.h"
@@ -155,6 +156,11 @@ void AddOpDescFromOpInfo(std::shared_ptr<cpp::ProgramDesc> program_desc,
   auto* op_info = op->op_info();
   *op_desc = *op_info;
   op_desc->SetAttr(kKernelTypeAttr, kernel->SerializedKernelType());
+  if (kernel->implementation().empty()) {
+    op_desc->DeleteAttr(kKernelImplAttr);
+  } else {
+    op_desc->SetAttr<std::string>(kKernelImplAttr, kernel->implementation());
+  }
   auto* scope = op->scope();
   auto op_type = op_info->Type();
   // Update subgraph op
@@ -395,7 +401,103 @@ void RuntimeProgram::SaveOutput() {
 }
 #endif
 
+void RuntimeProgram::ResolveVarSlots() {
+  vars_.clear();
+  var_slots_.clear();
+  for (auto& insts : instructions_) {
+    for (auto& inst : insts) {
+      auto* scope = inst.scope();
+      if (scope == nullptr) continue;
+      auto* op_info = inst.op()->op_info();
+      auto resolve = [&](const std::string& name) -> Variable* {
+        auto it = var_slots_.find(name);
+        if (it != var_slots_.end()) return vars_[it->second];
+        auto* var = scope->FindVar(name);
+        if (var == nullptr) return nullptr;
+        var_slots_[name] = static_cast<int>(vars_.size());
+        vars_.push_back(var);
+        return var;
+      };
+      std::vector<Variable*> input_vars;
+      for (auto& name : op_info->input_names()) {
+        input_vars.push_back(resolve(name));
+      }
+      for (auto& name : op_info->output_names()) resolve(name);
+      inst.set_input_vars(std::move(input_vars));
+    }
+  }
+}
+
+void RuntimeProgram::SetInterOpParallelism(int branches, int threads) {
+  dataflow_executor_.reset();
+  dataflow_insts_.clear();
+  if (branches <= 1) return;
+#if defined(LITE_WITH_PROFILE) || defined(LITE_WITH_PRECISION_PROFILE) || \
+    defined(LITE_WITH_NVTX) || defined(LITE_WITH_FPGA) ||                 \
+    defined(LITE_WITH_METAL)
+  LOG(WARNING) << "Inter-op parallelism is not supported by this build.";
+  return;
+#endif
+  std::vector<DataflowExecutor::Access> accesses;
+  auto& insts = instructions_[kRootBlockIdx];
+  for (size_t idx = 0; idx < insts.size(); ++idx) {
+    auto& inst = insts[idx];
+    if (inst.is_feed_fetch_op()) continue;
+    auto target = inst.kernel()->target();
+    if (target != TARGET(kHost) && target != TARGET(kX86) &&
+        target != TARGET(kARM)) {
+      LOG(WARNING) << "Inter-op parallelism is only supported on CPU, "
+                   << inst.kernel()->summary() << " runs on "
+                   << TargetToStr(target);
+      dataflow_insts_.clear();
+      return;
+    }
+    auto* op_info = inst.op()->op_info();
+    DataflowExecutor::Access access;
+    access.reads = op_info->input_names();
+    access.writes = op_info->output_names();
+    access.barrier =
+        op_info->HasAttr("sub_block") || op_info->Type() == "subgraph";
+    accesses.push_back(std::move(access));
+    dataflow_insts_.push_back(idx);
+  }
+  if (memory_planner_) {
+    LOG(WARNING) << "The memory arena is not used with inter-op parallelism.";
+    memory_planner_.reset();
+  }
+  dataflow_executor_.reset(new DataflowExecutor(accesses, branches, threads));
+}
+
+void RuntimeProgram::SetKernelTuning(const std::string& db_path) {
+  kernel_tuner_.reset();
+  if (db_path.empty()) return;
+#if defined(LITE_WITH_FPGA) || defined(LITE_WITH_METAL)
+  LOG(WARNING) << "Kernel tuning is not supported on this target.";
+  return;
+#endif
+  kernel_tuner_.reset(new KernelTuner(db_path));
+#ifdef LITE_USE_THREAD_POOL
+  kernel_tuner_->SetThreadPool(thread_pool_);
+#endif
+}
+
 void RuntimeProgram::Run() {
+  profile::TraceSpan trace_span("run", "RuntimeProgram::Run");
+  if (trace_span.active()) {
+    trace_span.set_args("{\"run\":" + std::to_string(run_idx_) + "}");
+  }
+  ++run_idx_;
+  // The first run prepares the kernels and loads the deferred params in
+  // order, so does the run tuning the kernels.
+  const bool tuning = kernel_tuner_ && !kernel_tuner_->finished();
+  if (dataflow_executor_ && has_run_ && !tuning) {
+    auto& insts = instructions_[kRootBlockIdx];
+    dataflow_executor_->Run(
+        [&](size_t node) { insts[dataflow_insts_[node]].Run(); });
+    return;
+  }
+  has_run_ = true;
+
 #ifdef LITE_WITH_PRECISION_PROFILE
   auto inst_precision_profiler = paddle::lite::profile::PrecisionProfiler();
   std::string precision_profiler_summary =
@@ -418,6 +520,9 @@ void RuntimeProgram::Run() {
 
   int idx = -1;
 
+  const bool fast_path = shape_fast_path_ && shape_fast_path_->BeginRun();
+  if (memory_planner_) memory_planner_->BeginRun();
+  if (shape_cache_ && !fast_path) shape_cache_->BeginRun();
   auto& insts = instructions_[kRootBlockIdx];
   for (auto& inst : insts) {
     ++idx;
@@ -446,7 +551,20 @@ void RuntimeProgram::Run() {
     inst.Flush(idx);
 #endif
 
-    inst.Run();
+    if (memory_planner_) memory_planner_->BeforeInstruction(idx);
+    if (fast_path && shape_fast_path_->BeforeInstruction(idx)) {
+      inst.Run(false, false);
+    } else if (shape_cache_ && !fast_path) {
+      inst.Run(shape_cache_->BeforeInstruction(idx));
+    } else {
+      inst.Run();
+    }
+    // The candidate kernels run on the inputs of the instruction before the
+    // next instructions overwrite them.
+    if (tuning) kernel_tuner_->Tune(&inst);
+    if (shape_fast_path_) shape_fast_path_->AfterInstruction(idx);
+    if (shape_cache_ && !fast_path) shape_cache_->AfterInstruction(idx);
+    if (memory_planner_) memory_planner_->AfterInstruction(idx);
 
 #ifdef LITE_WITH_FPGA
     monitor.postRun(inst);
@@ -461,6 +579,10 @@ void RuntimeProgram::Run() {
 #endif
 #endif  // LITE_WITH_PRECISION_PROFILE
   }
+  if (shape_cache_ && !fast_path) shape_cache_->EndRun();
+  if (shape_fast_path_) shape_fast_path_->EndRun();
+  if (memory_planner_) memory_planner_->EndRun();
+  if (tuning) kernel_tuner_->Finish();
 
 #ifdef LITE_WITH_METAL
   if (metal_ctx_) {
@@ -631,7 +753,31 @@ void Instruction::SaveOutput() {
 }
 #endif
 
-void Instruction::Run() {
+namespace {
+// The dims of the tensors of the arguments, as a JSON object.
+std::string TraceShapes(const std::map<std::string, std::vector<std::string>>&
+                            args,
+                        Scope* scope) {
+  std::string res = "{";
+  for (auto& arg : args) {
+    std::string dims;
+    for (auto& name : arg.second) {
+      auto* var = scope->FindVar(name);
+      if (!dims.empty()) dims += " ";
+      if (var != nullptr && var->IsType<Tensor>()) {
+        dims += var->Get<Tensor>().dims().repr();
+      } else {
+        dims += "-";
+      }
+    }
+    if (res.size() > 1) res += ",";
+    res += profile::JsonString(arg.first) + ":" + profile::JsonString(dims);
+  }
+  return res + "}";
+}
+}  // namespace
+
+void Instruction::Run(bool infer_shape, bool reinit) {
 #ifdef LITE_WITH_PROFILE
   CHECK(profiler_) << "Profiler pointer of kernel can not be nullptr. "
                       "When LITE_WITH_PROFILE is defined, please set a "
@@ -644,6 +790,10 @@ void Instruction::Run() {
 
   if (first_epoch_) {
     first_epoch_ = false;
+    // The deferred params are loaded before the kernel prepares to run.
+    for (auto* var : input_vars_) {
+      if (var != nullptr) var->Load();
+    }
     CHECK(op_->CheckShape());
   }
 
@@ -651,9 +801,24 @@ void Instruction::Run() {
     return;
   }
 
-  op_->InferShape();
-  kernel_->Launch();
+#ifdef LITE_USE_THREAD_POOL
+  auto* ctx = kernel_->mutable_context();
+  ThreadPool::ScopedPool pool_guard(ctx != nullptr ? ctx->thread_pool()
+                                                   : nullptr);
+#endif
+  profile::TraceSpan trace_span("op");
+  if (infer_shape) op_->InferShape();
+  kernel_->Launch(reinit);
   has_run_ = true;
+  if (trace_span.active()) {
+    const auto* info = op_->op_info();
+    trace_span.set_name(op_->Type());
+    trace_span.set_args("{\"kernel\":" +
+                        profile::JsonString(kernel_->summary()) +
+                        ",\"inputs\":" + TraceShapes(info->inputs(), scope()) +
+                        ",\"outputs\":" +
+                        TraceShapes(info->outputs(), scope()) + "}");
+  }
 
 #ifdef LITE_WITH_PROFILE
   if (first_epoch_for_profiler_) {
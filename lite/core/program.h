@@ -17,9 +17,14 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
+#include "lite/core/dataflow_executor.h"
 #include "lite/core/kernel.h"
+#include "lite/core/kernel_tuner.h"
+#include "lite/core/memory_planner.h"
+#include "lite/core/shape_cache.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
 #include "lite/model_parser/cpp_desc.h"
@@ -37,6 +42,8 @@ namespace paddle {
 namespace lite {
 
 static const char kKernelTypeAttr[] = "__@kernel_type_attr@__";
+// The implementation of the kernel picked by KernelTuner.
+static const char kKernelImplAttr[] = "__@kernel_impl_attr@__";
 
 // A program is used to represent a code program, in Paddle, a code program
 // contains:
@@ -114,10 +121,18 @@ struct Instruction {
     if (op_type == "feed" || op_type == "fetch") {
       is_feed_fetch_op_ = true;
     }
+    auto* op_info = op->op_info();
+    if (kernel_ && op_info && op_info->HasAttr(kKernelImplAttr)) {
+      kernel_->set_implementation(
+          op_info->GetAttr<std::string>(kKernelImplAttr));
+    }
   }
 
-  // Run the instruction.
-  void Run();
+  // Run the instruction, the output shapes are not inferred without
+  // `infer_shape` as they are set by ShapeCache or ShapeFastPath,
+  // and the kernel is not re-initialized without `reinit` as its input shapes
+  // are the ones of the last run.
+  void Run(bool infer_shape = true, bool reinit = true);
 #ifdef LITE_WITH_METAL
   void SaveOutput();
 #endif
@@ -127,9 +142,26 @@ struct Instruction {
   const OpLite* op() const { return op_.get(); }
   const KernelBase* kernel() const { return kernel_.get(); }
   KernelBase* mutable_kernel() { return kernel_.get(); }
+  // Replaces the kernel with the one picked by KernelTuner.
+  void set_kernel(std::unique_ptr<KernelBase>&& kernel) {
+    kernel_ = std::move(kernel);
+#ifdef LITE_WITH_PROFILE
+    if (profile_id_ >= 0) {
+      kernel_->SetProfiler(profiler_, profile_id_);
+      kernel_->SetIsKernelTest(first_epoch_for_profiler_);
+    }
+#endif
+  }
 
   bool is_feed_fetch_op() const { return is_feed_fetch_op_; }
 
+  // The scope the op is attached to, and the variables of its inputs resolved
+  // by RuntimeProgram::ResolveVarSlots.
+  Scope* scope() const { return op_->scope(); }
+  void set_input_vars(std::vector<Variable*>&& vars) {
+    input_vars_ = std::move(vars);
+  }
+
 #ifdef LITE_WITH_CUDA
   bool need_sync() const {
     if (kernel_->target() == TargetType::kCUDA) {
@@ -182,6 +214,7 @@ struct Instruction {
  private:
   std::shared_ptr<OpLite> op_;
   std::unique_ptr<KernelBase> kernel_;
+  std::vector<Variable*> input_vars_;
   bool is_feed_fetch_op_{false};
   bool first_epoch_{true};
   bool has_run_{false};
@@ -222,6 +255,7 @@ class LITE_API RuntimeProgram {
     if (instructions_.empty()) {
       LOG(FATAL) << "no instructions";
     }
+    ResolveVarSlots();
 #ifdef LITE_WITH_PROFILE
     set_profiler();
 #endif
@@ -285,9 +319,96 @@ class LITE_API RuntimeProgram {
   void SaveOutput();
 #endif
 
+#ifdef LITE_USE_THREAD_POOL
+  // Dispatch the parallel regions of all the kernels to `thread_pool`.
+  void SetThreadPool(const std::shared_ptr<ThreadPool>& thread_pool) {
+    thread_pool_ = thread_pool;
+    if (kernel_tuner_) kernel_tuner_->SetThreadPool(thread_pool);
+    for (auto& insts : instructions_) {
+      for (auto& inst : insts) {
+        auto* ctx = inst.mutable_kernel()->mutable_context();
+        if (ctx != nullptr) {
+          ctx->SetThreadPool(thread_pool);
+        }
+      }
+    }
+  }
+#endif
+
   void set_exec_scope(Scope* x) { exec_scope_ = x; }
   Scope* exec_scope() { return exec_scope_; }
 
+  // Every variable touched by the instructions of every block is resolved to
+  // a dense slot when the program is built, the runtime reaches it through
+  // var(slot) instead of looking its name up in the scopes. Returns -1 if no
+  // instruction touches the variable.
+  int var_slot(const std::string& name) const {
+    auto it = var_slots_.find(name);
+    return it == var_slots_.end() ? -1 : it->second;
+  }
+  Variable* var(int slot) const { return vars_[slot]; }
+  size_t var_size() const { return vars_.size(); }
+
+  // Place the intermediate host tensors of the main block into one arena
+  // planned by MemoryPlanner.
+  void SetMemoryArena(bool enabled) {
+    if (!enabled) {
+      memory_planner_.reset();
+    } else if (dataflow_executor_) {
+      LOG(WARNING) << "The memory arena is not used with inter-op "
+                      "parallelism.";
+    } else if (!memory_planner_) {
+      memory_planner_.reset(new MemoryPlanner(instructions_, exec_scope_));
+    }
+  }
+  MemoryPlanner* memory_planner() { return memory_planner_.get(); }
+
+  // Cache the inferred shapes of the main block for the `capacity` recently
+  // seen input shapes, 0 disables the cache.
+  void SetShapeCache(size_t capacity) {
+#if defined(LITE_WITH_FPGA) || defined(LITE_WITH_METAL)
+    // the feed ops resize the inputs inside the run
+    LOG(WARNING) << "The shape cache is not supported on this target.";
+    return;
+#endif
+    if (capacity == 0) {
+      shape_cache_.reset();
+    } else if (!shape_cache_ || shape_cache_->capacity() != capacity) {
+      shape_cache_.reset(new ShapeCache(instructions_, exec_scope_, capacity));
+    }
+  }
+  ShapeCache* shape_cache() { return shape_cache_.get(); }
+  // Skip the shape inference of a run with the input shapes of the last run.
+  void SetShapeFastPath(bool enabled) {
+#if defined(LITE_WITH_FPGA) || defined(LITE_WITH_METAL)
+    // the feed ops resize the inputs inside the run
+    LOG(WARNING) << "The shape fast path is not supported on this target.";
+    return;
+#endif
+    if (!enabled) {
+      shape_fast_path_.reset();
+    } else if (!shape_fast_path_) {
+      shape_fast_path_.reset(new ShapeFastPath(instructions_, exec_scope_));
+    }
+  }
+  ShapeFastPath* shape_fast_path() { return shape_fast_path_.get(); }
+
+  // Run up to `branches` independent instructions of the main block at the
+  // same time with DataflowExecutor, the kernels of each branch get `threads`
+  // / `branches` threads. The runs after the first one take the dataflow
+  // path, which skips the memory arena and the shape caches as they follow
+  // the order of the instructions. A `branches` not above 1 runs the
+  // instructions in order.
+  void SetInterOpParallelism(int branches, int threads);
+  DataflowExecutor* dataflow_executor() { return dataflow_executor_.get(); }
+
+  // Pick the kernels of the main block by timing the candidates in the next
+  // run, see KernelTuner. The choices are kept in the tuning DB at
+  // `db_path` and looked up by the later programs, an empty path disables
+  // the tuning.
+  void SetKernelTuning(const std::string& db_path);
+  KernelTuner* kernel_tuner() { return kernel_tuner_.get(); }
+
   const std::vector<Instruction>& instructions(
       int block_idx = kRootBlockIdx) const {
     return instructions_[block_idx];
@@ -321,9 +442,26 @@ class LITE_API RuntimeProgram {
 
  private:
   RuntimeProgram(const RuntimeProgram&) = delete;
+  void ResolveVarSlots();
+
   std::vector<std::vector<Instruction>> instructions_;
   Scope* exec_scope_{};
+  std::vector<Variable*> vars_;
+  std::unordered_map<std::string, int> var_slots_;
   int64_t version_{0};
+  std::unique_ptr<MemoryPlanner> memory_planner_;
+  std::unique_ptr<ShapeCache> shape_cache_;
+  std::unique_ptr<ShapeFastPath> shape_fast_path_;
+  // the instructions run by dataflow_executor_
+  std::vector<size_t> dataflow_insts_;
+  std::unique_ptr<DataflowExecutor> dataflow_executor_;
+  bool has_run_{false};
+  // the number of the runs, recorded in the trace
+  int64_t run_idx_{0};
+  std::unique_ptr<KernelTuner> kernel_tuner_;
+#ifdef LITE_USE_THREAD_POOL
+  std::shared_ptr<ThreadPool> thread_pool_;
+#endif
 
 #ifdef LITE_WITH_METAL
   std::unique_ptr<KernelContext> metal_ctx_{nullptr};
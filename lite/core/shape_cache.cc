@@ -0,0 +1,217 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/shape_cache.h"
+#include <algorithm>
+#include <set>
+#include <string>
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+
+BlockShapes::BlockShapes(
+    const std::vector<std::vector<Instruction>>& instructions,
+    Scope* exec_scope) {
+  CHECK(exec_scope);
+  const auto& insts = instructions[kRootBlockIdx];
+  std::set<std::string> written;
+  std::set<const Tensor*> inputs;
+  begins_.push_back(0);
+  for (auto& inst : insts) {
+    auto* op = inst.op();
+    cacheable_.push_back(!inst.is_feed_fetch_op() && op->IsShapeCacheable());
+    if (inst.is_feed_fetch_op()) {
+      begins_.push_back(outputs_.size());
+      continue;
+    }
+    // The variables read before they are written are fed by the caller, or
+    // by the parent block of a sub-block.
+    for (auto& name : op->op_info()->input_names()) {
+      if (written.count(name)) continue;
+      auto* var = exec_scope->FindVar(name);
+      if (var == nullptr || !var->IsType<Tensor>()) continue;
+      const auto* tensor = &var->Get<Tensor>();
+      if (!tensor->persistable() && inputs.insert(tensor).second) {
+        inputs_.push_back(tensor);
+      }
+    }
+    for (auto& name : op->op_info()->output_names()) {
+      written.insert(name);
+      auto* var = exec_scope->FindVar(name);
+      if (var == nullptr || !var->IsType<Tensor>()) continue;
+      outputs_.push_back(var->GetMutable<Tensor>());
+    }
+    begins_.push_back(outputs_.size());
+  }
+}
+
+BlockShapes::Key BlockShapes::InputKey() const {
+  Key key;
+  for (auto* tensor : inputs_) {
+    const auto& dims = tensor->dims();
+    key.push_back(static_cast<int64_t>(dims.size()));
+    for (size_t i = 0; i < dims.size(); ++i) key.push_back(dims[i]);
+    const auto& lod = tensor->lod();
+    key.push_back(static_cast<int64_t>(lod.size()));
+    for (auto& level : lod) {
+      key.push_back(static_cast<int64_t>(level.size()));
+      for (auto offset : level) key.push_back(static_cast<int64_t>(offset));
+    }
+  }
+  return key;
+}
+
+ShapeCache::ShapeCache(
+    const std::vector<std::vector<Instruction>>& instructions,
+    Scope* exec_scope,
+    size_t capacity)
+    : BlockShapes(instructions, exec_scope),
+      capacity_((std::max)(capacity, static_cast<size_t>(1))) {}
+
+void ShapeCache::BeginRun() {
+  Key key = InputKey();
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    entries_.splice(entries_.begin(), entries_, it->second);
+    hit_ = true;
+    recording_ = false;
+  } else {
+    entries_.emplace_front();
+    entries_.front().key = key;
+    entries_.front().dims.resize(outputs_.size());
+    entries_.front().lods.resize(outputs_.size());
+    index_[key] = entries_.begin();
+    if (entries_.size() > capacity_) {
+      index_.erase(entries_.back().key);
+      entries_.pop_back();
+    }
+    hit_ = false;
+    recording_ = true;
+  }
+  entry_ = &entries_.front();
+}
+
+bool ShapeCache::BeforeInstruction(size_t idx) {
+  if (recording_ || !cacheable_[idx]) return true;
+  for (size_t i = begins_[idx]; i < begins_[idx + 1]; ++i) {
+    outputs_[i]->Resize(entry_->dims[i]);
+    outputs_[i]->set_lod(entry_->lods[i]);
+  }
+  return false;
+}
+
+void ShapeCache::AfterInstruction(size_t idx) {
+  if (recording_) {
+    Record(idx);
+  } else if (!cacheable_[idx] && !Matches(idx)) {
+    // The shapes of the op depend on the data, the rest of the run infers
+    // its shapes and updates the entry.
+    VLOG(4) << "The cached shapes of instruction " << idx << " are outdated.";
+    recording_ = true;
+    hit_ = false;
+    Record(idx);
+  }
+}
+
+void ShapeCache::EndRun() {
+  if (hit_) {
+    ++hits_;
+  } else {
+    ++misses_;
+  }
+  entry_ = nullptr;
+}
+
+void ShapeCache::Clear() {
+  entries_.clear();
+  index_.clear();
+  entry_ = nullptr;
+}
+
+void ShapeCache::Record(size_t idx) {
+  for (size_t i = begins_[idx]; i < begins_[idx + 1]; ++i) {
+    entry_->dims[i] = outputs_[i]->dims();
+    entry_->lods[i] = outputs_[i]->lod();
+  }
+}
+
+bool ShapeCache::Matches(size_t idx) const {
+  for (size_t i = begins_[idx]; i < begins_[idx + 1]; ++i) {
+    if (outputs_[i]->dims() != entry_->dims[i] ||
+        outputs_[i]->lod() != entry_->lods[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+ShapeFastPath::ShapeFastPath(
+    const std::vector<std::vector<Instruction>>& instructions,
+    Scope* exec_scope)
+    : BlockShapes(instructions, exec_scope),
+      dims_(outputs_.size()),
+      lods_(outputs_.size()) {}
+
+bool ShapeFastPath::BeginRun() {
+  Key key = InputKey();
+  hit_ = has_run_ && key == last_key_;
+  active_ = hit_;
+  if (!hit_) last_key_.swap(key);
+  return hit_;
+}
+
+bool ShapeFastPath::BeforeInstruction(size_t idx) {
+  if (!active_ || !cacheable_[idx]) return false;
+  for (size_t i = begins_[idx]; i < begins_[idx + 1]; ++i) {
+    outputs_[i]->Resize(dims_[i]);
+    outputs_[i]->set_lod(lods_[i]);
+  }
+  return true;
+}
+
+void ShapeFastPath::AfterInstruction(size_t idx) {
+  if (active_ && cacheable_[idx]) return;
+  if (active_ && !Matches(idx)) {
+    VLOG(4) << "The shapes of instruction " << idx << " changed, the rest "
+            << "of the run infers its shapes.";
+    active_ = false;
+  }
+  Record(idx);
+}
+
+void ShapeFastPath::EndRun() {
+  has_run_ = true;
+  if (hit_) ++hits_;
+  active_ = false;
+}
+
+void ShapeFastPath::Record(size_t idx) {
+  for (size_t i = begins_[idx]; i < begins_[idx + 1]; ++i) {
+    dims_[i] = outputs_[i]->dims();
+    lods_[i] = outputs_[i]->lod();
+  }
+}
+
+bool ShapeFastPath::Matches(size_t idx) const {
+  for (size_t i = begins_[idx]; i < begins_[idx + 1]; ++i) {
+    if (outputs_[i]->dims() != dims_[i] || outputs_[i]->lod() != lods_[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,145 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <list>
+#include <map>
+#include <vector>
+#include "lite/core/scope.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+struct Instruction;
+
+// The inputs of the main block, and the outputs of every instruction of it.
+class BlockShapes {
+ protected:
+  using Key = std::vector<int64_t>;
+
+  BlockShapes(const std::vector<std::vector<Instruction>>& instructions,
+              Scope* exec_scope);
+
+  // The dims and LoDs of the inputs.
+  Key InputKey() const;
+
+  // the inputs of the main block, they make up the key of an entry
+  std::vector<const Tensor*> inputs_;
+  // the outputs of every instruction are outputs_[begins_[idx]:begins_[idx+1]]
+  std::vector<Tensor*> outputs_;
+  std::vector<size_t> begins_;
+  // whether the output shapes of the instruction only depend on its input
+  // shapes (OpLite::InferShapeWithCache)
+  std::vector<bool> cacheable_;
+};
+
+/*
+ * ShapeCache keeps the shapes inferred by the instructions of the main block
+ * for the recently seen dims and LoDs of the block inputs, the least recently
+ * used entry is dropped when more than `capacity` are kept.
+ *
+ * When the inputs are seen again, the outputs of the ops whose shapes only
+ * depend on the shapes of their inputs (OpLite::InferShapeWithCache) are
+ * resized from the entry instead of inferring them. The outputs of the other
+ * ops are compared with the entry after they run, a difference makes the rest
+ * of the run infer its shapes and updates the entry.
+ */
+class ShapeCache : private BlockShapes {
+ public:
+  ShapeCache(const std::vector<std::vector<Instruction>>& instructions,
+             Scope* exec_scope,
+             size_t capacity);
+
+  // Called around the instructions of the main block by RuntimeProgram::Run,
+  // `idx` is the index of the instruction.
+  void BeginRun();
+  // Resizes the outputs of the instruction from the cache if possible,
+  // returns whether the instruction has to infer its shapes.
+  bool BeforeInstruction(size_t idx);
+  void AfterInstruction(size_t idx);
+  void EndRun();
+
+  void Clear();
+
+  size_t capacity() const { return capacity_; }
+  size_t size() const { return entries_.size(); }
+  int64_t hits() const { return hits_; }
+  int64_t misses() const { return misses_; }
+
+ private:
+  struct Entry {
+    Key key;
+    std::vector<DDim> dims;
+    std::vector<LoD> lods;
+  };
+
+  void Record(size_t idx);
+  bool Matches(size_t idx) const;
+
+  size_t capacity_;
+  std::list<Entry> entries_;
+  std::map<Key, std::list<Entry>::iterator> index_;
+  // the entry of the current run, and whether it is filled by this run
+  Entry* entry_{nullptr};
+  bool recording_{false};
+  bool hit_{false};
+  int64_t hits_{0};
+  int64_t misses_{0};
+};
+
+/*
+ * ShapeFastPath skips the shape inference of a run whose inputs have the dims
+ * and LoDs of the previous run. The output shapes of every instruction are
+ * recorded by the runs inferring them, and the outputs of the ops whose
+ * shapes only depend on the shapes of their inputs are resized from the record
+ * instead, as a tensor shared by several variables after MemoryOptimizePass
+ * keeps the shape of the last one. Both their InferShape and the
+ * ReInitWhenNeeded of their kernels are skipped. The other ops run as usual,
+ * and the rest of the run infers its shapes as soon as one of them changes
+ * the shapes of its outputs.
+ */
+class ShapeFastPath : private BlockShapes {
+ public:
+  ShapeFastPath(const std::vector<std::vector<Instruction>>& instructions,
+                Scope* exec_scope);
+
+  // Called around the instructions of the main block by RuntimeProgram::Run,
+  // returns whether the run takes the fast path.
+  bool BeginRun();
+  // Resizes the outputs of the instruction from the record if it skips
+  // InferShape and ReInitWhenNeeded, returns whether it skips them.
+  bool BeforeInstruction(size_t idx);
+  void AfterInstruction(size_t idx);
+  void EndRun();
+
+  // the number of runs which took the fast path
+  int64_t hits() const { return hits_; }
+
+ private:
+  void Record(size_t idx);
+  bool Matches(size_t idx) const;
+
+  Key last_key_;
+  bool has_run_{false};
+  bool active_{false};
+  bool hit_{false};
+  // the output shapes of every instruction in the runs with last_key_
+  std::vector<DDim> dims_;
+  std::vector<LoD> lods_;
+  int64_t hits_{0};
+};
+
+}  // namespace lite
+}  // namespace paddle
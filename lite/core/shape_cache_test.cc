@@ -0,0 +1,146 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/shape_cache.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/core/kernel.h"
+#include "lite/core/op_lite.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+struct TestParam {
+  lite::Tensor* x{nullptr};
+  lite::Tensor* out{nullptr};
+  int cols{0};
+};
+
+// test_expand: Out[i][j] = X[i][0] * (j + 1) with `cols` columns,
+// test_row_sum: Out[i][0] = sum(X[i]). The output shapes of both only depend
+// on the input shapes.
+class TestOp : public OpLite {
+ public:
+  explicit TestOp(const std::string& type) : OpLite(type) {}
+
+  bool InferShapeImpl() const override {
+    int64_t cols = Type() == "test_expand" ? param_.cols : 1;
+    param_.out->Resize({param_.x->dims()[0], cols});
+    return true;
+  }
+
+  bool AttachImpl(const cpp::OpDesc& op_desc, lite::Scope* scope) override {
+    AttachInput(op_desc, scope, "X", false, &param_.x);
+    AttachOutput(op_desc, scope, "Out", false, &param_.out);
+    if (op_desc.HasAttr("cols")) param_.cols = op_desc.GetAttr<int>("cols");
+    return true;
+  }
+
+  void AttachKernel(KernelBase* kernel) override { kernel->SetParam(param_); }
+
+  std::string DebugString() const override { return Type(); }
+
+ protected:
+  bool InferShapeWithCache() const override { return true; }
+
+ private:
+  TestParam param_;
+};
+
+class TestKernel : public KernelLite<TARGET(kHost), PRECISION(kFloat)> {
+ public:
+  explicit TestKernel(bool expand) : expand_(expand) {}
+
+  void Run() override {
+    auto& param = Param<TestParam>();
+    int64_t rows = param.out->dims()[0];
+    int64_t cols = param.out->dims()[1];
+    int64_t x_cols = param.x->dims()[1];
+    const float* x = param.x->data<float>();
+    float* out = param.out->mutable_data<float>();
+    for (int64_t i = 0; i < rows; ++i) {
+      if (expand_) {
+        for (int64_t j = 0; j < cols; ++j) {
+          out[i * cols + j] = x[i * x_cols] * (j + 1);
+        }
+      } else {
+        out[i] = 0.f;
+        for (int64_t j = 0; j < x_cols; ++j) out[i] += x[i * x_cols + j];
+      }
+    }
+  }
+
+ private:
+  bool expand_;
+};
+
+Instruction MakeInstruction(Scope* scope,
+                            const std::string& type,
+                            const std::string& x,
+                            const std::string& out,
+                            int cols = 0) {
+  cpp::OpDesc op_desc;
+  op_desc.SetType(type);
+  op_desc.SetInput("X", {x});
+  op_desc.SetOutput("Out", {out});
+  if (cols > 0) op_desc.SetAttr<int>("cols", cols);
+  std::shared_ptr<OpLite> op(new TestOp(type));
+  op->Attach(op_desc, scope);
+  std::unique_ptr<KernelBase> kernel(new TestKernel(type == "test_expand"));
+  op->AttachKernel(kernel.get());
+  return Instruction(op, std::move(kernel));
+}
+
+}  // namespace
+
+TEST(ShapeFastPath, reused_var) {
+  Scope scope;
+  for (auto& name : {"x", "t", "y", "z"}) {
+    scope.Var(name)->GetMutable<Tensor>();
+  }
+  // "t" is shared by a [n, 4] and a [n, 2] value as MemoryOptimizePass does,
+  // so it keeps the shape of the second one at the end of every run.
+  std::vector<std::vector<Instruction>> insts(1);
+  insts[0].push_back(MakeInstruction(&scope, "test_expand", "x", "t", 4));
+  insts[0].push_back(MakeInstruction(&scope, "test_row_sum", "t", "y"));
+  insts[0].push_back(MakeInstruction(&scope, "test_expand", "y", "t", 2));
+  insts[0].push_back(MakeInstruction(&scope, "test_row_sum", "t", "z"));
+  RuntimeProgram program(std::move(insts));
+  program.set_exec_scope(&scope);
+  program.SetShapeFastPath(true);
+
+  auto* x = scope.FindVar("x")->GetMutable<Tensor>();
+  const auto& z = scope.FindVar("z")->Get<Tensor>();
+  for (int64_t rows : {3, 3, 3, 5, 5}) {
+    x->Resize({rows, 1});
+    float* x_data = x->mutable_data<float>();
+    for (int64_t i = 0; i < rows; ++i) x_data[i] = i + 1;
+    program.Run();
+    ASSERT_EQ(z.dims(), DDim({rows, 1}));
+    // z = (1 + 2) * (1 + 2 + 3 + 4) * x
+    for (int64_t i = 0; i < rows; ++i) {
+      EXPECT_FLOAT_EQ(z.data<float>()[i], 30.f * (i + 1)) << rows;
+    }
+  }
+  EXPECT_EQ(program.shape_fast_path()->hits(), 3);
+}
+
+}  // namespace lite
+}  // namespace paddle
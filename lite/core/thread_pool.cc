@@ -14,21 +14,116 @@
 
 #include "lite/core/thread_pool.h"
 #include <string.h>
+#include <stdio.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "lite/core/profile/tracer.h"
 #include "lite/utils/log/logging.h"
 
 namespace paddle {
 namespace lite {
 
+namespace {
+// Number of polls an idle worker makes before parking, it covers the gap
+// between two back-to-back parallel regions of one inference.
+constexpr int kSpinCount = 1 << 11;
+// Every worker range is consumed in about this many chunks, which bounds the
+// load imbalance without taking the queue lock for each index.
+constexpr int kChunksPerWorker = 8;
+// Nested parallel regions are executed serially by the calling worker.
+thread_local bool gInParallelRegion = false;
+// The pool of the predictor running on this thread, see ScopedPool.
+thread_local ThreadPool* gCurrentPool = nullptr;
+// Whether gCurrentPool is pinned by a branch of DataflowExecutor.
+thread_local bool gPoolPinned = false;
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#else
+  std::this_thread::yield();
+#endif
+}
+
+#if defined(__linux__) && !defined(__ANDROID__)
+int NumaNodeOfCpu(int cpu) {
+  std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+  DIR* dir = opendir(path.c_str());
+  if (dir == nullptr) return 0;
+  int node = 0;
+  while (struct dirent* entry = readdir(dir)) {
+    if (strncmp(entry->d_name, "node", 4) == 0 &&
+        sscanf(entry->d_name + 4, "%d", &node) == 1) {
+      break;
+    }
+  }
+  closedir(dir);
+  return node;
+}
+
+// Returns the cpus this process may run on, those sharing the NUMA node of
+// the calling thread first, so that a small pool stays on one memory node.
+std::vector<int> GetBindCoreIds() {
+  std::vector<int> cpus;
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  if (sched_getaffinity(0, sizeof(mask), &mask) != 0) {
+    return cpus;
+  }
+  for (int i = 0; i < CPU_SETSIZE; ++i) {
+    if (CPU_ISSET(i, &mask)) cpus.push_back(i);
+  }
+  int current_cpu = sched_getcpu();
+  int home_node = current_cpu >= 0 ? NumaNodeOfCpu(current_cpu) : 0;
+  std::stable_partition(cpus.begin(), cpus.end(), [&](int cpu) {
+    return NumaNodeOfCpu(cpu) == home_node;
+  });
+  // The calling thread keeps its own core as worker 0.
+  auto it = std::find(cpus.begin(), cpus.end(), current_cpu);
+  if (it != cpus.end()) {
+    std::rotate(cpus.begin(), it, it + 1);
+  }
+  return cpus;
+}
+
+void BindCurrentThread(int core_id) {
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  CPU_SET(core_id, &mask);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) != 0) {
+    LOG(WARNING) << "ThreadPool failed to bind worker to core " << core_id;
+  }
+}
+#else
+std::vector<int> GetBindCoreIds() { return std::vector<int>(); }
+void BindCurrentThread(int core_id) {}
+#endif
+}  // namespace
+
 ThreadPool* ThreadPool::gInstance = nullptr;
 static std::mutex gInitMutex;  // confirm thread-safe when use singleton mode
-int ThreadPool::Init(int number) {
+// keyed by the name and the thread count, the kernels of a predictor size
+// their per-thread buffers by its thread count
+static std::map<std::pair<std::string, int>, std::weak_ptr<ThreadPool>>
+    gNamedPools;
+int ThreadPool::Init(int number, bool bind_cores) {
   // Don't instantiate ThreadPool when compile ThreadPool and only use 1 thread
   if (number <= 1) {
     return 1;
   }
   std::lock_guard<std::mutex> _l(gInitMutex);
   if (nullptr == gInstance) {
-    gInstance = new ThreadPool(number);
+    gInstance = new ThreadPool(
+        number, bind_cores ? GetBindCoreIds() : std::vector<int>());
   }
   return gInstance->thread_num_;
 }
@@ -40,92 +135,215 @@ void ThreadPool::Destroy() {
   }
 }
 
-ThreadPool::ThreadPool(int number) {
+std::shared_ptr<ThreadPool> ThreadPool::Create(
+    const std::string& name,
+    int number,
+    const std::vector<int>& core_ids,
+    bool bind_cores) {
+  if (number <= 1) {
+    return nullptr;
+  }
+  std::vector<int> cores = core_ids;
+  if (cores.empty() && bind_cores) {
+    cores = GetBindCoreIds();
+  }
+  if (name.empty()) {
+    return std::shared_ptr<ThreadPool>(new ThreadPool(number, cores));
+  }
+  std::lock_guard<std::mutex> _l(gInitMutex);
+  auto& entry = gNamedPools[std::make_pair(name, number)];
+  auto pool = entry.lock();
+  if (pool == nullptr) {
+    pool.reset(new ThreadPool(number, cores));
+    entry = pool;
+  }
+  return pool;
+}
+
+ThreadPool::ScopedPool::ScopedPool(ThreadPool* pool, bool pinned) {
+  if (gPoolPinned || (pool == nullptr && !pinned)) return;
+  prev_pool_ = gCurrentPool;
+  prev_in_parallel_region_ = gInParallelRegion;
+  gCurrentPool = pool;
+  gPoolPinned = pinned;
+  if (pinned && pool == nullptr) gInParallelRegion = true;
+  active_ = true;
+}
+
+ThreadPool::ScopedPool::~ScopedPool() {
+  if (active_) {
+    gCurrentPool = prev_pool_;
+    gInParallelRegion = prev_in_parallel_region_;
+    gPoolPinned = false;
+  }
+}
+
+ThreadPool::ThreadPool(int number, const std::vector<int>& core_ids) {
   thread_num_ = number;
   for (int i = 0; i < thread_num_; ++i) {
-    tasks_.second.emplace_back(new std::atomic<bool>{false});
+    queues_.emplace_back(new WorkQueue);
   }
   for (int thread_index = 1; thread_index < thread_num_; ++thread_index) {
-    workers_.emplace_back([this, thread_index]() {
-      while (!stop_) {
-        // if (*tasks_.second[thread_index]) {
-        while (!(*tasks_.second[thread_index])) {
-          std::this_thread::yield();
-        }
-        tasks_.first(thread_index, thread_index);
-        *tasks_.second[thread_index] = false;
-      }
-    });
+    int core_id = core_ids.empty()
+                      ? -1
+                      : core_ids[thread_index % core_ids.size()];
+    workers_.emplace_back(
+        [this, thread_index, core_id]() { WorkerLoop(thread_index, core_id); });
   }
 }
 
 ThreadPool::~ThreadPool() {
-  stop_ = true;
+  {
+    std::lock_guard<std::mutex> _l(park_mutex_);
+    stop_ = true;
+  }
+  park_cv_.notify_all();
   for (auto& worker : workers_) {
     worker.join();
   }
-  for (auto c : tasks_.second) {
-    delete c;
+}
+
+void ThreadPool::WorkerLoop(int tid, int core_id) {
+  if (core_id >= 0) {
+    BindCurrentThread(core_id);
+  }
+  profile::Tracer::SetThreadName("ThreadPool worker " + std::to_string(tid));
+  gInParallelRegion = true;
+  int seen_epoch = 0;
+  while (true) {
+    int epoch = epoch_.load();
+    for (int i = 0; i < kSpinCount && epoch == seen_epoch && !stop_; ++i) {
+      CpuRelax();
+      epoch = epoch_.load();
+    }
+    if (epoch == seen_epoch && !stop_) {
+      std::unique_lock<std::mutex> _l(park_mutex_);
+      parked_++;
+      park_cv_.wait(_l, [&] {
+        epoch = epoch_.load();
+        return stop_ || epoch != seen_epoch;
+      });
+      parked_--;
+    }
+    if (stop_) {
+      return;
+    }
+    seen_epoch = epoch;
+    // task_ is published before epoch_, it may already belong to a newer
+    // epoch, in which case no range stamped with `epoch` is left to run.
+    const TASK* task = task_.load();
+    if (task != nullptr) {
+      Execute(tid, epoch, *task);
+    }
   }
 }
 
-void ThreadPool::AcquireThreadPool() {
-  if (nullptr == gInstance) {
-    return;
+bool ThreadPool::PopRange(int tid, int epoch, int* begin, int* end) {
+  auto& queue = *queues_[tid];
+  std::lock_guard<std::mutex> _l(queue.mutex);
+  if (queue.epoch != epoch || queue.begin >= queue.end) {
+    return false;
   }
-  LOG(INFO) << "ThreadPool::AcquireThreadPool()\n";
-  std::unique_lock<std::mutex> _l(gInstance->mutex_);
-  while (!gInstance->ready_) gInstance->cv_.wait(_l);
-  gInstance->ready_ = false;
-  return;
+  *begin = queue.begin;
+  *end = std::min(queue.begin + grain_, queue.end);
+  queue.begin = *end;
+  return true;
 }
 
-void ThreadPool::ReleaseThreadPool() {
-  if (nullptr == gInstance) {
-    return;
+bool ThreadPool::StealRange(int tid, int epoch) {
+  for (int i = 1; i < thread_num_; ++i) {
+    auto& victim = *queues_[(tid + i) % thread_num_];
+    int begin = 0;
+    int end = 0;
+    {
+      std::lock_guard<std::mutex> _l(victim.mutex);
+      if (victim.epoch != epoch || victim.begin >= victim.end) {
+        continue;
+      }
+      int mid = victim.begin + (victim.end - victim.begin) / 2;
+      begin = mid;
+      end = victim.end;
+      victim.end = mid;
+    }
+    auto& queue = *queues_[tid];
+    std::lock_guard<std::mutex> _l(queue.mutex);
+    queue.begin = begin;
+    queue.end = end;
+    queue.epoch = epoch;
+    return true;
   }
-  LOG(INFO) << "ThreadPool::ReleaseThreadPool()\n";
-  std::unique_lock<std::mutex> _l(gInstance->mutex_);
-  gInstance->ready_ = true;
-  gInstance->cv_.notify_all();
+  return false;
+}
+
+void ThreadPool::Execute(int tid, int epoch, const TASK& task) {
+  const bool tracing = profile::Tracer::enabled();
+  const int64_t begin_us = tracing ? profile::Tracer::NowUs() : 0;
+  int64_t executed = 0;
+  int begin = 0;
+  int end = 0;
+  while (PopRange(tid, epoch, &begin, &end) || StealRange(tid, epoch)) {
+    if (begin >= end) {
+      continue;  // a stolen range was just pushed to the own queue
+    }
+    for (int i = begin; i < end; ++i) {
+      task(i, tid);
+    }
+    pending_.fetch_sub(end - begin);
+    executed += end - begin;
+    begin = end = 0;
+  }
+  // the workers woken up after the others ran every index are left out
+  if (tracing && executed > 0) {
+    profile::Tracer::Global().AddComplete(
+        "thread_pool",
+        "ThreadPool::Execute",
+        begin_us,
+        profile::Tracer::NowUs(),
+        "{\"worker\":" + std::to_string(tid) + ",\"indices\":" +
+            std::to_string(executed) + "}");
+  }
+}
+
+void ThreadPool::Run(const TASK& task, int work_size) {
+  std::lock_guard<std::mutex> _l(run_mutex_);
+  int epoch = epoch_.load() + 1;
+  grain_ = std::max(1, work_size / (thread_num_ * kChunksPerWorker));
+  for (int i = 0; i < thread_num_; ++i) {
+    auto& queue = *queues_[i];
+    std::lock_guard<std::mutex> _l(queue.mutex);
+    queue.begin = static_cast<int64_t>(work_size) * i / thread_num_;
+    queue.end = static_cast<int64_t>(work_size) * (i + 1) / thread_num_;
+    queue.epoch = epoch;
+  }
+  pending_ = work_size;
+  task_ = &task;
+  epoch_ = epoch;
+  if (parked_.load() > 0) {
+    std::lock_guard<std::mutex> _l(park_mutex_);
+    park_cv_.notify_all();
+  }
+  // the calling thread works as tid 0 and then waits for the stragglers
+  gInParallelRegion = true;
+  Execute(0, epoch, task);
+  {
+    // the imbalance of the parallel region
+    profile::TraceSpan wait_span("thread_pool", "ThreadPool::Wait");
+    while (pending_.load() > 0) {
+      std::this_thread::yield();
+    }
+  }
+  gInParallelRegion = false;
 }
 
 void ThreadPool::Enqueue(TASK_BASIC&& task) {
-  if (task.second <= 1 || (nullptr == gInstance)) {
+  ThreadPool* pool = gCurrentPool != nullptr ? gCurrentPool : gInstance;
+  if (task.second <= 1 || (nullptr == pool) || gInParallelRegion) {
     for (int i = 0; i < task.second; ++i) {
       task.first(i, 0);
     }
     return;
   }
-  int work_size = task.second;
-  if (work_size > gInstance->thread_num_) {
-    gInstance->tasks_.first = [work_size, &task](int index, int tId) {
-      for (int v = tId; v < work_size; v += gInstance->thread_num_) {
-        task.first(v, tId);  // nested lambda func
-      }
-    };
-    work_size = gInstance->thread_num_;
-  } else {
-    gInstance->tasks_.first = std::move(task.first);
-  }
-  for (int i = 1; i < work_size; ++i) {
-    *(gInstance->tasks_.second[i]) = true;
-  }
-  // invoke tid 0 callback in main thread
-  // other tid task is invoked in child thread
-  gInstance->tasks_.first(0, 0);
-  bool complete = true;
-  // check tid 1 to thread_num - 1 all work completed in child thread
-  do {
-    std::this_thread::yield();
-    complete = true;
-    for (int i = 1; i < work_size; ++i) {
-      if (*gInstance->tasks_.second[i]) {
-        complete = false;
-        break;
-      }
-    }
-  } while (!complete);
+  pool->Run(task.first, task.second);
 }
 
 void ThreadPool::Enqueue(TASK_COMMON&& task) {
@@ -133,45 +351,19 @@ void ThreadPool::Enqueue(TASK_COMMON&& task) {
   int start = std::get<2>(task);
   int step = std::get<3>(task);
   int work_size = (end - start + step - 1) / step;
-  if (work_size <= 1 || (nullptr == gInstance)) {
+  ThreadPool* pool = gCurrentPool != nullptr ? gCurrentPool : gInstance;
+  if (work_size <= 1 || (nullptr == pool) || gInParallelRegion) {
     for (int v = start; v < end; v += step) {
       std::get<0>(task)(v, 0);
     }
     return;
   }
-  if (work_size > gInstance->thread_num_) {
-    gInstance->tasks_.first = ([=, &task](int index, int tId) {
-      auto start_index = start + tId * step;
-      auto stride = gInstance->thread_num_ * step;
-      for (int v = start_index; v < end; v += stride) {
-        std::get<0>(task)(v, tId);  // nested lambda func
-      }
-    });
-    work_size = gInstance->thread_num_;
-  } else {
-    gInstance->tasks_.first = ([=, &task](int index, int tId) {
-      auto v = start + tId * step;
-      std::get<0>(task)(v, tId);  // nested lambda func
-    });
-  }
-  for (int i = 1; i < work_size; ++i) {
-    *(gInstance->tasks_.second[i]) = true;
-  }
-  // invoke tid 0 callback in main thread
-  // other tid task is invoked in new thread
-  gInstance->tasks_.first(0, 0);
-  bool complete = true;
-  // check tid 1 to thread_num - 1 all work completed in new thread
-  do {
-    std::this_thread::yield();
-    complete = true;
-    for (int i = 1; i < work_size; ++i) {
-      if (*gInstance->tasks_.second[i]) {
-        complete = false;
-        break;
-      }
-    }
-  } while (!complete);
+  auto& func = std::get<0>(task);
+  pool->Run(
+      [start, step, &func](int index, int tid) {
+        func(start + index * step, tid);  // nested lambda func
+      },
+      work_size);
 }
 
 }  // namespace lite
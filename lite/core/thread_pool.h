@@ -16,7 +16,9 @@
 #include <atomic>
 #include <condition_variable>  //NOLINT
 #include <functional>
+#include <memory>
 #include <mutex>   //NOLINT
+#include <string>
 #include <thread>  //NOLINT
 #include <tuple>
 #include <utility>
@@ -25,6 +27,21 @@
 namespace paddle {
 namespace lite {
 
+/*
+ * Fork-join thread pool used by the LITE_PARALLEL_* macros.
+ *
+ * Each Enqueue splits the iteration space into one contiguous range per
+ * worker. A worker consumes its own range from the front in small chunks and,
+ * once it runs dry, steals the back half of another worker's range, so
+ * kernels with uneven per-index cost keep every core busy. Idle workers spin
+ * for a short while before parking on a condition variable, and can be
+ * pinned to cores, preferring the NUMA node of the calling thread.
+ *
+ * Every predictor owns a pool or shares a named one (see Create), which is
+ * stored in the KernelContext of its kernels. Instruction::Run installs it as
+ * the current pool of the running thread, the static Enqueue dispatches to
+ * the current pool and falls back to the global pool created by Init.
+ */
 class ThreadPool {
  public:
   typedef std::function<void(int, int)> TASK;
@@ -33,22 +50,72 @@ class ThreadPool {
 
   static void Enqueue(TASK_BASIC&& task);
   static void Enqueue(TASK_COMMON&& task);
-  static void AcquireThreadPool();
-  static void ReleaseThreadPool();
-  static int Init(int number);
+  // `number` is the thread count set by ConfigBase::set_threads, the calling
+  // thread is counted as worker 0. Workers are pinned to cores when
+  // `bind_cores` is true.
+  static int Init(int number, bool bind_cores = false);
   static void Destroy();
 
+  // Returns the pool registered as `name` with `number` threads, or creates
+  // it. The same name with another `number` gets another pool, so the tid of
+  // a worker stays below the thread count of every predictor using it. An
+  // empty name always creates a private pool. Workers are pinned
+  // to `core_ids` if given, otherwise to automatically chosen cores when
+  // `bind_cores` is true. Returns nullptr if `number` is not above 1.
+  static std::shared_ptr<ThreadPool> Create(const std::string& name,
+                                            int number,
+                                            const std::vector<int>& core_ids,
+                                            bool bind_cores = false);
+
+  // Dispatches the parallel regions of the current thread to `pool` during
+  // the lifetime of the guard, a nullptr pool keeps the current one. A
+  // `pinned` guard, used by the branches of DataflowExecutor, keeps its pool
+  // against the nested guards and runs the parallel regions serially if
+  // `pool` is nullptr.
+  class ScopedPool {
+   public:
+    explicit ScopedPool(ThreadPool* pool, bool pinned = false);
+    ~ScopedPool();
+
+   private:
+    ThreadPool* prev_pool_{nullptr};
+    bool prev_in_parallel_region_{false};
+    bool active_{false};
+  };
+
+  int thread_num() const { return thread_num_; }
+  ~ThreadPool();
+
  private:
+  // The not yet executed indices [begin, end) owned by one worker.
+  struct alignas(64) WorkQueue {
+    std::mutex mutex;
+    int begin{0};
+    int end{0};
+    int epoch{0};
+  };
+
   static ThreadPool* gInstance;
-  explicit ThreadPool(int number = 0);
-  ~ThreadPool();
+  ThreadPool(int number, const std::vector<int>& core_ids);
+
+  void Run(const TASK& task, int work_size);
+  void WorkerLoop(int tid, int core_id);
+  void Execute(int tid, int epoch, const TASK& task);
+  bool PopRange(int tid, int epoch, int* begin, int* end);
+  bool StealRange(int tid, int epoch);
 
+  // serializes the parallel regions of predictors sharing this pool
+  std::mutex run_mutex_;
   std::vector<std::thread> workers_;
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+  std::atomic<const TASK*> task_{nullptr};
+  std::atomic<int> epoch_{0};
+  std::atomic<int> pending_{0};
+  std::atomic<int> parked_{0};
   std::atomic<bool> stop_{false};
-  bool ready_{true};
-  std::pair<TASK, std::vector<std::atomic<bool>*>> tasks_;
-  std::condition_variable cv_;
-  std::mutex mutex_;
+  int grain_{1};
+  std::condition_variable park_cv_;
+  std::mutex park_mutex_;
 
   int thread_num_ = 0;
 };
@@ -0,0 +1,115 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/thread_pool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+TEST(ThreadPool, basic) {
+  const int thread_num = 4;
+  ASSERT_EQ(ThreadPool::Init(thread_num), thread_num);
+  for (int work_size : {1, 3, 4, 17, 1000}) {
+    std::vector<std::atomic<int>> visits(work_size);
+    for (auto& v : visits) v = 0;
+    std::atomic<bool> tid_ok{true};
+    ThreadPool::Enqueue({[&](int index, int tid) {
+                           visits[index]++;
+                           if (tid < 0 || tid >= thread_num) tid_ok = false;
+                         },
+                         work_size});
+    for (int i = 0; i < work_size; ++i) {
+      EXPECT_EQ(visits[i], 1) << "index " << i << " of " << work_size;
+    }
+    EXPECT_TRUE(tid_ok);
+  }
+  ThreadPool::Destroy();
+}
+
+TEST(ThreadPool, common) {
+  ASSERT_EQ(ThreadPool::Init(3, true), 3);
+  const int start = 5, end = 200, step = 3;
+  std::vector<std::atomic<int>> visits(end);
+  for (auto& v : visits) v = 0;
+  ThreadPool::Enqueue(ThreadPool::TASK_COMMON(
+      [&](int index, int tid) { visits[index]++; }, end, start, step));
+  for (int i = 0; i < end; ++i) {
+    bool hit = i >= start && (i - start) % step == 0;
+    EXPECT_EQ(visits[i], hit ? 1 : 0) << "index " << i;
+  }
+  ThreadPool::Destroy();
+}
+
+TEST(ThreadPool, uneven_and_nested) {
+  ASSERT_EQ(ThreadPool::Init(4), 4);
+  std::atomic<int64_t> sum{0};
+  for (int repeat = 0; repeat < 100; ++repeat) {
+    // the first indices are far more expensive and get stolen
+    ThreadPool::Enqueue({[&](int index, int tid) {
+                           int64_t local = 0;
+                           int cost = index < 4 ? 2000 : 10;
+                           for (int i = 0; i < cost; ++i) local += i % 7;
+                           // a nested region runs serially in the worker
+                           ThreadPool::Enqueue(
+                               {[&](int j, int) { local += j; }, 4});
+                           sum += local;
+                         },
+                         64});
+  }
+  int64_t expect = 0;
+  for (int index = 0; index < 64; ++index) {
+    int cost = index < 4 ? 2000 : 10;
+    for (int i = 0; i < cost; ++i) expect += i % 7;
+    expect += 6;
+  }
+  EXPECT_EQ(sum, expect * 100);
+  ThreadPool::Destroy();
+}
+
+TEST(ThreadPool, named_pools) {
+  auto pool_a = ThreadPool::Create("shared", 3, {});
+  auto pool_b = ThreadPool::Create("shared", 3, {});
+  auto pool_c = ThreadPool::Create("", 2, {});
+  // another thread count never joins the pool of `shared`
+  auto pool_d = ThreadPool::Create("shared", 2, {});
+  ASSERT_TRUE(pool_a);
+  EXPECT_EQ(pool_a.get(), pool_b.get());
+  EXPECT_NE(pool_a.get(), pool_c.get());
+  ASSERT_TRUE(pool_d);
+  EXPECT_NE(pool_a.get(), pool_d.get());
+  EXPECT_EQ(pool_d->thread_num(), 2);
+  EXPECT_EQ(ThreadPool::Create("", 1, {}), nullptr);
+
+  // without a global pool the regions run in the pool of the guard
+  std::atomic<int> max_tid{0};
+  auto task = [&](int index, int tid) {
+    int prev = max_tid;
+    while (tid > prev && !max_tid.compare_exchange_weak(prev, tid)) {
+    }
+  };
+  {
+    ThreadPool::ScopedPool guard(pool_c.get());
+    for (int i = 0; i < 100; ++i) ThreadPool::Enqueue({task, 64});
+  }
+  EXPECT_LT(max_tid, 2);
+  max_tid = 0;
+  ThreadPool::Enqueue({task, 64});
+  EXPECT_EQ(max_tid, 0);
+}
+
+}  // namespace lite
+}  // namespace paddle
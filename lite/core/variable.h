@@ -13,8 +13,10 @@
 // limitations under the License.
 
 #pragma once
+#include <functional>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 #include "lite/core/tensor.h"
 #include "lite/utils/all.h"
@@ -44,8 +46,24 @@ class Variable {
     return blob_.is_type<T>();
   }
 
+  // A persistable variable may defer loading its data until its first use,
+  // the `loader` fills the variable when Load is called the first time.
+  void SetLoader(std::function<void(Variable*)> loader) {
+    loader_ = std::move(loader);
+  }
+  // The pending loader, nullptr if the variable is loaded.
+  const std::function<void(Variable*)>& loader() const { return loader_; }
+  void Load() {
+    if (loader_) {
+      auto loader = std::move(loader_);
+      loader_ = nullptr;
+      loader(this);
+    }
+  }
+
  private:
   Any blob_;
+  std::function<void(Variable*)> loader_;
 };
 
 }  // namespace lite
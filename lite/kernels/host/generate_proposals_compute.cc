@@ -21,6 +21,7 @@
 #include "lite/backends/host/math/nms_util.h"
 #include "lite/backends/host/math/transpose.h"
 #include "lite/core/op_registry.h"
+#include "lite/core/parallel_defines.h"
 
 namespace paddle {
 namespace lite {
@@ -89,11 +90,14 @@ std::pair<Tensor, Tensor> ProposalForOneImage(
     return std::make_pair(bbox_sel, scores_filter);
   }
 
+  // the greedy NMS keeps the boxes in order, it stops after post_nms_top_n
   Tensor keep_nms =
-      lite::host::math::NMS<float>(&bbox_sel, &scores_filter, nms_thresh, eta);
-  if (post_nms_top_n > 0 && post_nms_top_n < keep_nms.numel()) {
-    keep_nms.Resize(std::vector<int64_t>({post_nms_top_n}));
-  }
+      lite::host::math::NMS(&bbox_sel,
+                            &scores_filter,
+                            nms_thresh,
+                            eta,
+                            true,
+                            post_nms_top_n > 0 ? post_nms_top_n : -1);
   proposals.Resize(std::vector<int64_t>({keep_nms.numel(), 4}));
   scores_sel.Resize(std::vector<int64_t>({keep_nms.numel(), 1}));
   lite::host::math::Gather<float>(bbox_sel, keep_nms, &proposals);
@@ -145,8 +149,9 @@ void GenerateProposalsCompute::Run() {
   std::vector<int64_t> tmp_lod;
   std::vector<int64_t> tmp_num;
 
-  int64_t num_proposals = 0;
-  for (int64_t i = 0; i < num; ++i) {
+  // the images run in parallel, their proposals are appended in order
+  std::vector<std::pair<Tensor, Tensor>> image_proposals(num);
+  LITE_PARALLEL_BEGIN(i, tid, num) {
     Tensor im_info_slice = im_info->Slice<float>(i, i + 1);
     Tensor bbox_deltas_slice = bbox_deltas_swap.Slice<float>(i, i + 1);
     Tensor scores_slice = scores_swap.Slice<float>(i, i + 1);
@@ -155,17 +160,22 @@ void GenerateProposalsCompute::Run() {
         std::vector<int64_t>({c_bbox * h_bbox * w_bbox / 4, 4}));
     scores_slice.Resize(std::vector<int64_t>({c_score * h_score * w_score, 1}));
 
-    std::pair<Tensor, Tensor> tensor_pair =
-        ProposalForOneImage(im_info_slice,
-                            *anchors,
-                            *variances,
-                            bbox_deltas_slice,
-                            scores_slice,
-                            pre_nms_top_n,
-                            post_nms_top_n,
-                            nms_thresh,
-                            min_size,
-                            eta);
+    image_proposals[i] = ProposalForOneImage(im_info_slice,
+                                             *anchors,
+                                             *variances,
+                                             bbox_deltas_slice,
+                                             scores_slice,
+                                             pre_nms_top_n,
+                                             post_nms_top_n,
+                                             nms_thresh,
+                                             min_size,
+                                             eta);
+  }
+  LITE_PARALLEL_END();
+
+  int64_t num_proposals = 0;
+  for (int64_t i = 0; i < num; ++i) {
+    std::pair<Tensor, Tensor> &tensor_pair = image_proposals[i];
     Tensor &proposals = tensor_pair.first;
     Tensor &scores = tensor_pair.second;
 
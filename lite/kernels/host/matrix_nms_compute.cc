@@ -17,59 +17,14 @@
 #include <map>
 #include <utility>
 #include <vector>
+#include "lite/backends/host/math/nms_util.h"
+#include "lite/core/parallel_defines.h"
 
 namespace paddle {
 namespace lite {
 namespace kernels {
 namespace host {
 
-template <class T>
-static T BBoxArea(const T* box, const bool normalized) {
-  if (box[2] < box[0] || box[3] < box[1]) {
-    // If coordinate values are is invalid
-    // (e.g. xmax < xmin or ymax < ymin), return 0.
-    return static_cast<T>(0.);
-  } else {
-    const T w = box[2] - box[0];
-    const T h = box[3] - box[1];
-    if (normalized) {
-      return w * h;
-    } else {
-      // If coordinate values are not within range [0, 1].
-      return (w + 1) * (h + 1);
-    }
-  }
-}
-
-template <class T>
-static T JaccardOverlap(const T* box1, const T* box2, const bool normalized) {
-  if (box2[0] > box1[2] || box2[2] < box1[0] || box2[1] > box1[3] ||
-      box2[3] < box1[1]) {
-    return static_cast<T>(0.);
-  } else {
-    const T inter_xmin = (std::max)(box1[0], box2[0]);
-    const T inter_ymin = (std::max)(box1[1], box2[1]);
-    const T inter_xmax = (std::min)(box1[2], box2[2]);
-    const T inter_ymax = (std::min)(box1[3], box2[3]);
-    T norm = normalized ? static_cast<T>(0.) : static_cast<T>(1.);
-    T inter_w = inter_xmax - inter_xmin + norm;
-    T inter_h = inter_ymax - inter_ymin + norm;
-    const T inter_area = inter_w * inter_h;
-    const T bbox1_area = BBoxArea<T>(box1, normalized);
-    const T bbox2_area = BBoxArea<T>(box2, normalized);
-    return inter_area / (bbox1_area + bbox2_area - inter_area);
-  }
-}
-
-template <class T>
-T PolyIoU(const T* box1,
-          const T* box2,
-          const size_t box_size,
-          const bool normalized) {
-  LOG(FATAL) << "PolyIoU not implement.";
-  return *box1;
-}
-
 template <typename T, bool gaussian>
 struct decay_score;
 
@@ -88,8 +43,10 @@ struct decay_score<T, false> {
 };
 
 template <typename T, bool gaussian>
-void NMSMatrix(const Tensor& bbox,
-               const Tensor& scores,
+void NMSMatrix(const T* bbox_ptr,
+               const int64_t box_size,
+               const T* score_ptr,
+               const int64_t num_boxes,
                const T score_threshold,
                const T post_threshold,
                const float sigma,
@@ -97,51 +54,41 @@ void NMSMatrix(const Tensor& bbox,
                const bool normalized,
                std::vector<int>* selected_indices,
                std::vector<T>* decayed_scores) {
-  int64_t num_boxes = bbox.dims()[0];
-  int64_t box_size = bbox.dims()[1];
-
-  auto score_ptr = scores.data<T>();
-  auto bbox_ptr = bbox.data<T>();
-
-  std::vector<int32_t> perm(num_boxes);
-  std::iota(perm.begin(), perm.end(), 0);
-  auto end = std::remove_if(
-      perm.begin(), perm.end(), [&score_ptr, score_threshold](int32_t idx) {
-        return score_ptr[idx] <= score_threshold;
-      });
-  auto sort_fn = [&score_ptr](int32_t lhs, int32_t rhs) {
-    return score_ptr[lhs] > score_ptr[rhs];
-  };
-
-  int64_t num_pre = std::distance(perm.begin(), end);
+  std::vector<std::pair<T, int>> perm;
+  lite::host::math::GetTopKScoreIndex(
+      score_ptr, num_boxes, 1, score_threshold, top_k, &perm);
+  int64_t num_pre = perm.size();
   if (num_pre <= 0) {
     return;
   }
-  if (top_k > -1 && num_pre > top_k) {
-    num_pre = top_k;
-  }
-  std::partial_sort(perm.begin(), perm.begin() + num_pre, end, sort_fn);
 
+  // the boxes in score order, the overlaps of a box with the ones before it
+  // are computed by vectors
+  lite::host::math::NMSBoxes sorted_boxes;
+  sorted_boxes.reserve(num_pre);
   std::vector<T> iou_matrix((num_pre * (num_pre - 1)) >> 1);
   std::vector<T> iou_max(num_pre);
 
   iou_max[0] = 0.;
-  for (int64_t i = 1; i < num_pre; i++) {
-    T max_iou = 0.;
-    auto idx_a = perm[i];
-    for (int64_t j = 0; j < i; j++) {
-      auto idx_b = perm[j];
-      auto iou = JaccardOverlap<T>(
-          bbox_ptr + idx_a * box_size, bbox_ptr + idx_b * box_size, normalized);
-      max_iou = (std::max)(max_iou, iou);
-      iou_matrix[i * (i - 1) / 2 + j] = iou;
+  for (int64_t i = 0; i < num_pre; i++) {
+    const T* box = bbox_ptr + perm[i].second * box_size;
+    T area = lite::host::math::BBoxArea<T>(box, normalized);
+    if (i > 0) {
+      T* ious = iou_matrix.data() + i * (i - 1) / 2;
+      lite::host::math::BatchJaccardOverlap(
+          sorted_boxes, i, box, area, normalized, ious);
+      T max_iou = 0.;
+      for (int64_t j = 0; j < i; j++) {
+        max_iou = (std::max)(max_iou, ious[j]);
+      }
+      iou_max[i] = max_iou;
     }
-    iou_max[i] = max_iou;
+    sorted_boxes.push_back(box, area);
   }
 
-  if (score_ptr[perm[0]] > post_threshold) {
-    selected_indices->push_back(perm[0]);
-    decayed_scores->push_back(score_ptr[perm[0]]);
+  if (perm[0].first > post_threshold) {
+    selected_indices->push_back(perm[0].second);
+    decayed_scores->push_back(perm[0].first);
   }
 
   decay_score<T, gaussian> decay_fn;
@@ -153,67 +100,41 @@ void NMSMatrix(const Tensor& bbox,
       auto decay = decay_fn(iou, max_iou, sigma);
       min_decay = (std::min)(min_decay, decay);
     }
-    auto ds = min_decay * score_ptr[perm[i]];
+    auto ds = min_decay * perm[i].first;
     if (ds <= post_threshold) continue;
-    selected_indices->push_back(perm[i]);
+    selected_indices->push_back(perm[i].second);
     decayed_scores->push_back(ds);
   }
 }
 
+// The detections matrix NMS keeps of one class.
+template <typename T>
+struct ClassDetections {
+  std::vector<int> indices;
+  std::vector<T> scores;
+};
+
+// Merges the detections of the classes of an image, keeps the keep_top_k of
+// the highest scores.
 template <typename T>
-size_t MultiClassMatrixNMS(const Tensor& scores,
-                           const Tensor& bboxes,
+size_t MultiClassMatrixNMS(const Tensor& bboxes,
+                           const ClassDetections<T>* class_dets,
+                           int64_t class_num,
                            std::vector<T>* out,
                            std::vector<int>* indices,
                            int start,
-                           int64_t background_label,
-                           int64_t nms_top_k,
-                           int64_t keep_top_k,
-                           bool normalized,
-                           T score_threshold,
-                           T post_threshold,
-                           bool use_gaussian,
-                           float gaussian_sigma) {
-  std::vector<int> all_indices;
-  std::vector<T> all_scores;
-  std::vector<T> all_classes;
-  all_indices.reserve(scores.numel());
-  all_scores.reserve(scores.numel());
-  all_classes.reserve(scores.numel());
-
-  size_t num_det = 0;
-  auto class_num = scores.dims()[0];
-  Tensor score_slice;
+                           int64_t keep_top_k) {
+  // the score and the position of every detection in class order
+  std::vector<std::pair<T, int>> all_scores;
+  std::vector<std::pair<int, int>> all_dets;
   for (int64_t c = 0; c < class_num; ++c) {
-    if (c == background_label) continue;
-    score_slice = scores.Slice<float>(c, c + 1);
-    if (use_gaussian) {
-      NMSMatrix<T, true>(bboxes,
-                         score_slice,
-                         score_threshold,
-                         post_threshold,
-                         gaussian_sigma,
-                         nms_top_k,
-                         normalized,
-                         &all_indices,
-                         &all_scores);
-    } else {
-      NMSMatrix<T, false>(bboxes,
-                          score_slice,
-                          score_threshold,
-                          post_threshold,
-                          gaussian_sigma,
-                          nms_top_k,
-                          normalized,
-                          &all_indices,
-                          &all_scores);
-    }
-    for (size_t i = 0; i < all_indices.size() - num_det; i++) {
-      all_classes.push_back(static_cast<T>(c));
+    const auto& dets = class_dets[c];
+    for (size_t i = 0; i < dets.indices.size(); i++) {
+      all_scores.emplace_back(dets.scores[i], all_dets.size());
+      all_dets.emplace_back(c, dets.indices[i]);
     }
-    num_det = all_indices.size();
   }
-
+  size_t num_det = all_dets.size();
   if (num_det <= 0) {
     return num_det;
   }
@@ -223,21 +144,15 @@ size_t MultiClassMatrixNMS(const Tensor& scores,
     if (num_det > k) num_det = k;
   }
 
-  std::vector<int32_t> perm(all_indices.size());
-  std::iota(perm.begin(), perm.end(), 0);
-
-  std::partial_sort(perm.begin(),
-                    perm.begin() + num_det,
-                    perm.end(),
-                    [&all_scores](int lhs, int rhs) {
-                      return all_scores[lhs] > all_scores[rhs];
-                    });
+  std::partial_sort(all_scores.begin(),
+                    all_scores.begin() + num_det,
+                    all_scores.end(),
+                    lite::host::math::ScoreIndexDescend<T>);
 
   for (size_t i = 0; i < num_det; i++) {
-    auto p = perm[i];
-    auto idx = all_indices[p];
-    auto cls = all_classes[p];
-    auto score = all_scores[p];
+    auto score = all_scores[i].first;
+    auto cls = static_cast<T>(all_dets[all_scores[i].second].first);
+    auto idx = all_dets[all_scores[i].second].second;
     auto bbox = bboxes.data<T>() + idx * bboxes.dims()[1];
     (*indices).push_back(start + idx);
     (*out).push_back(cls);
@@ -272,7 +187,48 @@ void MatrixNmsCompute::Run() {
   auto box_dim = boxes->dims()[2];
   auto out_dim = box_dim + 2;
 
-  Tensor boxes_slice, scores_slice;
+  int64_t class_num = score_dims[1];
+  auto* boxes_data = boxes->data<float>();
+  auto* scores_data = scores->data<float>();
+  // the classes of all the images run in parallel
+  std::vector<ClassDetections<float>> class_dets(batch_size * class_num);
+  LITE_PARALLEL_BEGIN(task, tid, batch_size * class_num) {
+    int i = task / class_num;
+    int64_t c = task % class_num;
+    if (c != background_label) {
+      const float* bboxes_ptr = boxes_data + i * num_boxes * box_dim;
+      const float* score_ptr = scores_data + (i * class_num + c) * num_boxes;
+      auto& dets = class_dets[task];
+      if (use_gaussian) {
+        NMSMatrix<float, true>(bboxes_ptr,
+                               box_dim,
+                               score_ptr,
+                               num_boxes,
+                               score_threshold,
+                               post_threshold,
+                               gaussian_sigma,
+                               nms_top_k,
+                               normalized,
+                               &dets.indices,
+                               &dets.scores);
+      } else {
+        NMSMatrix<float, false>(bboxes_ptr,
+                                box_dim,
+                                score_ptr,
+                                num_boxes,
+                                score_threshold,
+                                post_threshold,
+                                gaussian_sigma,
+                                nms_top_k,
+                                normalized,
+                                &dets.indices,
+                                &dets.scores);
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+
+  Tensor boxes_slice;
   int64_t num_out = 0;
   std::vector<int64_t> offsets = {0};
   std::vector<float> detections;
@@ -282,24 +238,16 @@ void MatrixNmsCompute::Run() {
   indices.reserve(num_boxes * batch_size);
   num_per_batch.reserve(batch_size);
   for (int i = 0; i < batch_size; ++i) {
-    scores_slice = scores->Slice<float>(i, i + 1);
-    scores_slice.Resize({score_dims[1], score_dims[2]});
     boxes_slice = boxes->Slice<float>(i, i + 1);
     boxes_slice.Resize({score_dims[2], box_dim});
     int start = i * score_dims[2];
-    num_out = MultiClassMatrixNMS(scores_slice,
-                                  boxes_slice,
+    num_out = MultiClassMatrixNMS(boxes_slice,
+                                  class_dets.data() + i * class_num,
+                                  class_num,
                                   &detections,
                                   &indices,
                                   start,
-                                  background_label,
-                                  nms_top_k,
-                                  keep_top_k,
-                                  normalized,
-                                  score_threshold,
-                                  post_threshold,
-                                  use_gaussian,
-                                  gaussian_sigma);
+                                  keep_top_k);
     offsets.push_back(offsets.back() + num_out);
     num_per_batch.emplace_back(num_out);
   }
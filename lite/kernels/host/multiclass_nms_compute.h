@@ -20,6 +20,8 @@
 #include "lite/backends/host/math/nms_util.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
+#include "lite/core/parallel_defines.h"
+#include "lite/utils/macros.h"
 namespace paddle {
 namespace lite {
 namespace kernels {
@@ -36,180 +38,186 @@ inline std::vector<uint64_t> GetNmsLodFromRoisNum(const Tensor* rois_num) {
   return rois_lod;
 }
 
-template <class T>
-void SliceOneClass(const Tensor& items,
-                   const int class_id,
-                   Tensor* one_class_item) {
-  T* item_data = one_class_item->template mutable_data<T>();
-  const T* items_data = items.data<T>();
-  const int64_t num_item = items.dims()[0];
-  const int64_t class_num = items.dims()[1];
-  if (items.dims().size() == 3) {
-    int64_t item_size = items.dims()[2];
-    for (int i = 0; i < num_item; ++i) {
-      std::memcpy(item_data + i * item_size,
-                  items_data + i * class_num * item_size + class_id * item_size,
-                  sizeof(T) * item_size);
-    }
+// The scores and the boxes of one class of an image: box i has the score
+// scores[i * score_stride] and the box_size coordinates from
+// bbox[i * box_stride].
+template <typename T>
+struct NmsClassData {
+  const T* scores;
+  int64_t score_stride;
+  const T* bbox;
+  int64_t box_stride;
+  int64_t box_size;
+  int64_t num_boxes;
+};
+
+// scores is [class_num, num_boxes] and bboxes [num_boxes, box_size] if
+// scores_size is 3, else scores is [num_boxes, class_num] and bboxes
+// [num_boxes, class_num, box_size].
+template <typename T>
+NmsClassData<T> GetNmsClassData(const Tensor& scores,
+                                const Tensor& bboxes,
+                                const int scores_size,
+                                const int64_t class_id) {
+  NmsClassData<T> data;
+  if (scores_size == 3) {
+    data.num_boxes = scores.dims()[1];
+    data.scores = scores.data<T>() + class_id * data.num_boxes;
+    data.score_stride = 1;
+    data.box_size = bboxes.dims()[1];
+    data.bbox = bboxes.data<T>();
+    data.box_stride = data.box_size;
   } else {
-    for (int i = 0; i < num_item; ++i) {
-      item_data[i] = items_data[i * class_num + class_id];
-    }
+    const int64_t class_num = scores.dims()[1];
+    data.num_boxes = scores.dims()[0];
+    data.scores = scores.data<T>() + class_id;
+    data.score_stride = class_num;
+    data.box_size = bboxes.dims()[2];
+    data.bbox = bboxes.data<T>() + class_id * data.box_size;
+    data.box_stride = class_num * data.box_size;
   }
+  return data;
 }
 
 template <typename T>
-void NMSFast(const Tensor& bbox,
-             const Tensor& scores,
+void NMSFast(const NmsClassData<T>& data,
              const T score_threshold,
              const T nms_threshold,
              const T eta,
              const int64_t top_k,
              std::vector<int>* selected_indices,
              const bool normalized) {
-  // The total boxes for each instance.
-  int64_t num_boxes = bbox.dims()[0];
   // 4: [xmin ymin xmax ymax]
   // 8: [x1 y1 x2 y2 x3 y3 x4 y4]
   // 16, 24, or 32: [x1 y1 x2 y2 ...  xn yn], n = 8, 12 or 16
-  int64_t box_size = bbox.dims()[1];
-
-  std::vector<T> scores_data(num_boxes);
-  std::copy_n(scores.data<T>(), num_boxes, scores_data.begin());
-  std::vector<std::pair<T, int>> sorted_indices;
-  lite::host::math::GetMaxScoreIndex(
-      scores_data, score_threshold, top_k, &sorted_indices);
+  const int64_t box_size = data.box_size;
+  // the candidates of the classes a thread runs share the buffer
+  static LITE_THREAD_LOCAL std::vector<std::pair<T, int>> sorted_indices;
+  lite::host::math::GetTopKScoreIndex(data.scores,
+                                      data.num_boxes,
+                                      data.score_stride,
+                                      score_threshold,
+                                      top_k,
+                                      &sorted_indices);
 
   selected_indices->clear();
-  T adaptive_threshold = nms_threshold;
-  const T* bbox_data = bbox.data<T>();
+  if (box_size == 4) {
+    lite::host::math::GreedyNMS(data.bbox,
+                                data.box_stride,
+                                sorted_indices.data(),
+                                sorted_indices.size(),
+                                nms_threshold,
+                                eta,
+                                normalized,
+                                -1,
+                                selected_indices);
+    return;
+  }
 
-  while (sorted_indices.size() != 0) {
-    const int idx = sorted_indices.front().second;
+  T adaptive_threshold = nms_threshold;
+  for (const auto& candidate : sorted_indices) {
+    const int idx = candidate.second;
     bool keep = true;
-    for (size_t k = 0; k < selected_indices->size(); ++k) {
-      if (keep) {
+    // 8: [x1 y1 x2 y2 x3 y3 x4 y4] or 16, 24, 32
+    if (box_size == 8 || box_size == 16 || box_size == 24 || box_size == 32) {
+      for (size_t k = 0; k < selected_indices->size() && keep; ++k) {
         const int kept_idx = (*selected_indices)[k];
-        T overlap = T(0.);
-        // 4: [xmin ymin xmax ymax]
-        if (box_size == 4) {
-          overlap = lite::host::math::JaccardOverlap<T>(
-              bbox_data + idx * box_size,
-              bbox_data + kept_idx * box_size,
-              normalized);
-        }
-        // 8: [x1 y1 x2 y2 x3 y3 x4 y4] or 16, 24, 32
-        if (box_size == 8 || box_size == 16 || box_size == 24 ||
-            box_size == 32) {
-          overlap =
-              lite::host::math::PolyIoU<T>(bbox_data + idx * box_size,
-                                           bbox_data + kept_idx * box_size,
-                                           box_size,
-                                           normalized);
-        }
+        T overlap =
+            lite::host::math::PolyIoU<T>(data.bbox + idx * data.box_stride,
+                                         data.bbox + kept_idx * data.box_stride,
+                                         box_size,
+                                         normalized);
         keep = overlap <= adaptive_threshold;
-      } else {
-        break;
       }
+    } else {
+      // the other sizes have no overlap
+      keep = selected_indices->empty() || T(0.) <= adaptive_threshold;
     }
     if (keep) {
       selected_indices->push_back(idx);
     }
-    sorted_indices.erase(sorted_indices.begin());
     if (keep && eta < 1 && adaptive_threshold > 0.5) {
       adaptive_threshold *= eta;
     }
   }
 }
 
+// The NMS of class c of an image, the kept indices in ascending order for
+// the 2-D scores.
 template <typename T>
-void MultiClassNMS(const operators::MulticlassNmsParam& param,
-                   const Tensor& scores,
-                   const Tensor& bboxes,
-                   const int scores_size,
-                   std::map<int, std::vector<int>>* indices,
-                   int* num_nmsed_out) {
-  int64_t background_label = param.background_label;
-  int64_t nms_top_k = param.nms_top_k;
-  int64_t keep_top_k = param.keep_top_k;
-  bool normalized = param.normalized;
-  T nms_threshold = static_cast<T>(param.nms_threshold);
-  T nms_eta = static_cast<T>(param.nms_eta);
-  T score_threshold = static_cast<T>(param.score_threshold);
+void NMSOneClass(const operators::MulticlassNmsParam& param,
+                 const Tensor& scores,
+                 const Tensor& bboxes,
+                 const int scores_size,
+                 const int64_t c,
+                 std::vector<int>* indices) {
+  NMSFast(GetNmsClassData<T>(scores, bboxes, scores_size, c),
+          static_cast<T>(param.score_threshold),
+          static_cast<T>(param.nms_threshold),
+          static_cast<T>(param.nms_eta),
+          param.nms_top_k,
+          indices,
+          param.normalized);
+  if (scores_size == 2) {
+    std::sort(indices->begin(), indices->end());
+  }
+}
 
+// Keeps the keep_top_k detections of the highest scores of an image, the
+// equal scores in the order of the labels and of their indices.
+template <typename T>
+void KeepTopKDetections(const operators::MulticlassNmsParam& param,
+                        const Tensor& scores,
+                        const int scores_size,
+                        std::map<int, std::vector<int>>* indices,
+                        int* num_nmsed_out) {
+  int64_t keep_top_k = param.keep_top_k;
   int num_det = 0;
-
-  int64_t class_num = scores_size == 3 ? scores.dims()[0] : scores.dims()[1];
-  Tensor bbox_slice, score_slice;
-  for (int64_t c = 0; c < class_num; ++c) {
-    if (c == background_label) continue;
-    if (scores_size == 3) {
-      score_slice = scores.Slice<T>(c, c + 1);
-      bbox_slice = bboxes;
-    } else {
-      score_slice.Resize({scores.dims()[0], 1});
-      bbox_slice.Resize({scores.dims()[0], 4});
-      SliceOneClass<T>(scores, c, &score_slice);
-      SliceOneClass<T>(bboxes, c, &bbox_slice);
-    }
-    NMSFast(bbox_slice,
-            score_slice,
-            score_threshold,
-            nms_threshold,
-            nms_eta,
-            nms_top_k,
-            &((*indices)[c]),
-            normalized);
-    if (scores_size == 2) {
-      std::stable_sort((*indices)[c].begin(), (*indices)[c].end());
-    }
-    num_det += (*indices)[c].size();
+  for (const auto& it : *indices) {
+    num_det += it.second.size();
   }
-
   *num_nmsed_out = num_det;
+  if (keep_top_k <= -1 || num_det <= keep_top_k) {
+    return;
+  }
+
   const T* scores_data = scores.data<T>();
-  if (keep_top_k > -1 && num_det > keep_top_k) {
-    const T* sdata;
-    std::vector<std::pair<T, std::pair<int, int>>> score_index_pairs;
-    for (const auto& it : *indices) {
-      int label = it.first;
-      if (scores_size == 3) {
-        sdata = scores_data + label * scores.dims()[1];
-      } else {
-        score_slice.Resize({scores.dims()[0], 1});
-        SliceOneClass<T>(scores, label, &score_slice);
-        sdata = score_slice.data<T>();
-      }
-      const std::vector<int>& label_indices = it.second;
-      for (size_t j = 0; j < label_indices.size(); ++j) {
-        int idx = label_indices[j];
-        score_index_pairs.push_back(
-            std::make_pair(sdata[idx], std::make_pair(label, idx)));
-      }
+  int64_t class_num = scores_size == 3 ? scores.dims()[0] : scores.dims()[1];
+  int64_t num_boxes = scores_size == 3 ? scores.dims()[1] : scores.dims()[0];
+  // the score and the position of a detection in (label, index) order
+  std::vector<std::pair<T, int>> score_index_pairs;
+  std::vector<std::pair<int, int>> detections;
+  score_index_pairs.reserve(num_det);
+  detections.reserve(num_det);
+  for (const auto& it : *indices) {
+    int label = it.first;
+    for (int idx : it.second) {
+      T score = scores_size == 3 ? scores_data[label * num_boxes + idx]
+                                 : scores_data[idx * class_num + label];
+      score_index_pairs.emplace_back(score, detections.size());
+      detections.emplace_back(label, idx);
     }
-    // Keep top k results per image.
-    std::stable_sort(
-        score_index_pairs.begin(),
-        score_index_pairs.end(),
-        lite::host::math::SortScorePairDescend<std::pair<int, int>>);
-    score_index_pairs.resize(keep_top_k);
+  }
+  // Keep top k results per image.
+  std::partial_sort(score_index_pairs.begin(),
+                    score_index_pairs.begin() + keep_top_k,
+                    score_index_pairs.end(),
+                    lite::host::math::ScoreIndexDescend<T>);
+  score_index_pairs.resize(keep_top_k);
 
-    // Store the new indices.
-    std::map<int, std::vector<int>> new_indices;
-    for (size_t j = 0; j < score_index_pairs.size(); ++j) {
-      int label = score_index_pairs[j].second.first;
-      int idx = score_index_pairs[j].second.second;
-      new_indices[label].push_back(idx);
-    }
-    if (scores_size == 2) {
-      for (const auto& it : new_indices) {
-        int label = it.first;
-        std::stable_sort(new_indices[label].begin(), new_indices[label].end());
-      }
+  // Store the new indices.
+  std::map<int, std::vector<int>> new_indices;
+  for (const auto& pair : score_index_pairs) {
+    const auto& detection = detections[pair.second];
+    new_indices[detection.first].push_back(detection.second);
+  }
+  if (scores_size == 2) {
+    for (auto& it : new_indices) {
+      std::sort(it.second.begin(), it.second.end());
     }
-    new_indices.swap(*indices);
-    *num_nmsed_out = keep_top_k;
   }
+  new_indices.swap(*indices);
+  *num_nmsed_out = keep_top_k;
 }
 
 template <typename T>
@@ -230,16 +238,12 @@ void MultiClassOutput(const Tensor& scores,
   auto* scores_data = scores.data<T>();
   auto* bboxes_data = bboxes.data<T>();
   auto* odata = outs->template mutable_data<T>();
-  const T* sdata;
-  Tensor bbox;
-  bbox.Resize({scores.dims()[0], box_size});
+  const T* sdata = scores_data;
   int count = 0;
   for (const auto& it : selected_indices) {
     int label = it.first;
     const std::vector<int>& indices = it.second;
-    if (scores_size == 2) {
-      SliceOneClass<T>(bboxes, label, &bbox);
-    } else {
+    if (scores_size == 3) {
       sdata = scores_data + label * predict_dim;
     }
     for (size_t j = 0; j < indices.size(); ++j) {
@@ -253,7 +257,7 @@ void MultiClassOutput(const Tensor& scores,
           oindices[count] = offset + idx;
         }
       } else {
-        bdata = bbox.data<T>() + idx * box_size;
+        bdata = bboxes_data + (idx * class_num + label) * box_size;
         odata[count * out_dim + 1] = *(scores_data + idx * class_num + label);
         if (oindices != nullptr) {
           oindices[count] = offset + idx * class_num + label;
@@ -282,44 +286,66 @@ class MulticlassNmsCompute : public KernelLite<TType, PType> {
     auto return_rois_num = param.nms_rois_num != nullptr;
     auto rois_num = param.rois_num;
 
-    std::vector<std::map<int, std::vector<int>>> all_indices;
     std::vector<uint64_t> batch_starts = {0};
     int64_t batch_size = score_dims[0];
     int64_t box_dim = boxes->dims()[2];
     int64_t out_dim = box_dim + 2;
-    int num_nmsed_out = 0;
-    Tensor boxes_slice, scores_slice;
     int n;
+    std::vector<uint64_t> boxes_lod;
     if (has_roissum) {
       n = score_size == 3 ? batch_size : rois_num->numel();
+      if (score_size != 3) {
+        boxes_lod = GetNmsLodFromRoisNum(rois_num);
+      }
     } else {
       n = score_size == 3 ? batch_size : boxes->lod().back().size() - 1;
+      if (score_size != 3) {
+        boxes_lod = boxes->lod().back();
+      }
     }
+    std::vector<Tensor> scores_slices(n);
+    std::vector<Tensor> boxes_slices(n);
     for (int i = 0; i < n; ++i) {
       if (score_size == 3) {
-        scores_slice = scores->template Slice<T>(i, i + 1);
-        scores_slice.Resize({score_dims[1], score_dims[2]});
-        boxes_slice = boxes->template Slice<T>(i, i + 1);
-        boxes_slice.Resize({score_dims[2], box_dim});
+        scores_slices[i] = scores->template Slice<T>(i, i + 1);
+        scores_slices[i].Resize({score_dims[1], score_dims[2]});
+        boxes_slices[i] = boxes->template Slice<T>(i, i + 1);
+        boxes_slices[i].Resize({score_dims[2], box_dim});
       } else {
-        std::vector<uint64_t> boxes_lod;
-        if (has_roissum) {
-          boxes_lod = GetNmsLodFromRoisNum(rois_num);
-        } else {
-          boxes_lod = boxes->lod().back();
-        }
-        scores_slice =
+        scores_slices[i] =
             scores->template Slice<T>(boxes_lod[i], boxes_lod[i + 1]);
-        boxes_slice = boxes->template Slice<T>(boxes_lod[i], boxes_lod[i + 1]);
+        boxes_slices[i] =
+            boxes->template Slice<T>(boxes_lod[i], boxes_lod[i + 1]);
       }
-      std::map<int, std::vector<int>> indices;
-      MultiClassNMS<T>(param,
-                       scores_slice,
-                       boxes_slice,
+    }
+
+    // the classes of all the images run in parallel
+    int64_t class_num = score_dims[1];
+    std::vector<std::vector<int>> class_indices(n * class_num);
+    LITE_PARALLEL_BEGIN(task, tid, n * class_num) {
+      int i = task / class_num;
+      int64_t c = task % class_num;
+      if (c != param.background_label && scores_slices[i].numel() > 0) {
+        NMSOneClass<T>(param,
+                       scores_slices[i],
+                       boxes_slices[i],
                        score_size,
-                       &indices,
-                       &num_nmsed_out);
-      all_indices.push_back(indices);
+                       c,
+                       &class_indices[task]);
+      }
+    }
+    LITE_PARALLEL_END();
+
+    std::vector<std::map<int, std::vector<int>>> all_indices(n);
+    for (int i = 0; i < n; ++i) {
+      auto& indices = all_indices[i];
+      for (int64_t c = 0; c < class_num; ++c) {
+        if (c == param.background_label) continue;
+        indices[c].swap(class_indices[i * class_num + c]);
+      }
+      int num_nmsed_out = 0;
+      KeepTopKDetections<T>(
+          param, scores_slices[i], score_size, &indices, &num_nmsed_out);
       batch_starts.push_back(batch_starts.back() + num_nmsed_out);
     }
 
@@ -340,28 +366,9 @@ class MulticlassNmsCompute : public KernelLite<TType, PType> {
       int offset = 0;
       int* oindices = nullptr;
       for (int i = 0; i < n; ++i) {
-        if (score_size == 3) {
-          scores_slice = scores->template Slice<T>(i, i + 1);
-          boxes_slice = boxes->template Slice<T>(i, i + 1);
-          scores_slice.Resize({score_dims[1], score_dims[2]});
-          boxes_slice.Resize({score_dims[2], box_dim});
-          if (return_index) {
-            offset = i * score_dims[2];
-          }
-        } else {
-          std::vector<uint64_t> boxes_lod;
-          if (has_roissum) {
-            boxes_lod = GetNmsLodFromRoisNum(rois_num);
-          } else {
-            boxes_lod = boxes->lod().back();
-          }
-          scores_slice =
-              scores->template Slice<T>(boxes_lod[i], boxes_lod[i + 1]);
-          boxes_slice =
-              boxes->template Slice<T>(boxes_lod[i], boxes_lod[i + 1]);
-          if (return_index) {
-            offset = boxes_lod[i] * score_dims[1];
-          }
+        if (return_index) {
+          offset = score_size == 3 ? i * score_dims[2]
+                                   : boxes_lod[i] * score_dims[1];
         }
         int64_t s = static_cast<int64_t>(batch_starts[i]);
         int64_t e = static_cast<int64_t>(batch_starts[i + 1]);
@@ -372,8 +379,8 @@ class MulticlassNmsCompute : public KernelLite<TType, PType> {
             int* output_idx = index->template mutable_data<int>();
             oindices = output_idx + s;
           }
-          MultiClassOutput<T>(scores_slice,
-                              boxes_slice,
+          MultiClassOutput<T>(scores_slices[i],
+                              boxes_slices[i],
                               all_indices[i],
                               score_dims.size(),
                               &out,
@@ -382,7 +389,6 @@ class MulticlassNmsCompute : public KernelLite<TType, PType> {
         }
       }
     }
-
     if (return_rois_num) {
       auto* nms_rois_num = param.nms_rois_num;
       nms_rois_num->Resize({n});
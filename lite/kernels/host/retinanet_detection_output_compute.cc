@@ -17,6 +17,8 @@
 #include <map>
 #include <utility>
 #include <vector>
+#include "lite/backends/host/math/nms_util.h"
+#include "lite/core/parallel_defines.h"
 #include "lite/operators/retinanet_detection_output_op.h"
 
 namespace paddle {
@@ -24,133 +26,50 @@ namespace lite {
 namespace kernels {
 namespace host {
 
-template <class T>
-bool SortScorePairDescend(const std::pair<float, T>& pair1,
-                          const std::pair<float, T>& pair2) {
-  return pair1.first > pair2.first;
-}
-
-template <class T>
-bool SortScoreTwoPairDescend(const std::pair<float, std::pair<T, T>>& pair1,
-                             const std::pair<float, std::pair<T, T>>& pair2) {
-  return pair1.first > pair2.first;
-}
-
-template <class T>
-static inline void GetMaxScoreIndex(
-    const std::vector<T>& scores,
-    const T threshold,
-    int top_k,
-    std::vector<std::pair<T, int>>* sorted_indices) {
-  for (size_t i = 0; i < scores.size(); ++i) {
-    if (scores[i] > threshold) {
-      sorted_indices->push_back(std::make_pair(scores[i], i));
-    }
-  }
-  // Sort the score pair according to the scores in descending order
-  std::stable_sort(sorted_indices->begin(),
-                   sorted_indices->end(),
-                   SortScorePairDescend<int>);
-  // Keep top_k scores if needed.
-  if (top_k > -1 && top_k < static_cast<int>(sorted_indices->size())) {
-    sorted_indices->resize(top_k);
-  }
-}
-
-template <class T>
-static inline T BBoxArea(const std::vector<T>& box, const bool normalized) {
-  if (box[2] < box[0] || box[3] < box[1]) {
-    // If coordinate values are is invalid
-    // (e.g. xmax < xmin or ymax < ymin), return 0.
-    return static_cast<T>(0.);
-  } else {
-    const T w = box[2] - box[0];
-    const T h = box[3] - box[1];
-    if (normalized) {
-      return w * h;
-    } else {
-      // If coordinate values are not within range [0, 1].
-      return (w + 1) * (h + 1);
-    }
-  }
-}
-
-template <class T>
-static inline T JaccardOverlap(const std::vector<T>& box1,
-                               const std::vector<T>& box2,
-                               const bool normalized) {
-  if (box2[0] > box1[2] || box2[2] < box1[0] || box2[1] > box1[3] ||
-      box2[3] < box1[1]) {
-    return static_cast<T>(0.);
-  } else {
-    const T inter_xmin = (std::max)(box1[0], box2[0]);
-    const T inter_ymin = (std::max)(box1[1], box2[1]);
-    const T inter_xmax = (std::min)(box1[2], box2[2]);
-    const T inter_ymax = (std::min)(box1[3], box2[3]);
-    T norm = normalized ? static_cast<T>(0.) : static_cast<T>(1.);
-    T inter_w = inter_xmax - inter_xmin + norm;
-    T inter_h = inter_ymax - inter_ymin + norm;
-    const T inter_area = inter_w * inter_h;
-    const T bbox1_area = BBoxArea<T>(box1, normalized);
-    const T bbox2_area = BBoxArea<T>(box2, normalized);
-    return inter_area / (bbox1_area + bbox2_area - inter_area);
-  }
-}
+// The predictions of a class, kPredSize values each: xmin, ymin, xmax, ymax
+// and the score.
+static const int kPredSize = 5;
 
 template <class T>
-void NMSFast(const std::vector<std::vector<T>>& cls_dets,
+void NMSFast(const std::vector<T>& cls_dets,
              const T nms_threshold,
              const T eta,
              std::vector<int>* selected_indices) {
-  int64_t num_boxes = cls_dets.size();
+  int64_t num_boxes = cls_dets.size() / kPredSize;
   std::vector<std::pair<T, int>> sorted_indices;
+  sorted_indices.reserve(num_boxes);
   for (int64_t i = 0; i < num_boxes; ++i) {
-    sorted_indices.push_back(std::make_pair(cls_dets[i][4], i));
+    sorted_indices.emplace_back(cls_dets[i * kPredSize + 4], i);
   }
   // Sort the score pair according to the scores in descending order
-  std::stable_sort(
-      sorted_indices.begin(), sorted_indices.end(), SortScorePairDescend<int>);
+  std::sort(sorted_indices.begin(),
+            sorted_indices.end(),
+            lite::host::math::ScoreIndexDescend<T>);
   selected_indices->clear();
-  T adaptive_threshold = nms_threshold;
-
-  while (sorted_indices.size() != 0) {
-    const int idx = sorted_indices.front().second;
-    bool keep = true;
-    for (size_t k = 0; k < selected_indices->size(); ++k) {
-      if (keep) {
-        const int kept_idx = (*selected_indices)[k];
-        T overlap = T(0.);
-
-        overlap = JaccardOverlap<T>(cls_dets[idx], cls_dets[kept_idx], false);
-        keep = overlap <= adaptive_threshold;
-      } else {
-        break;
-      }
-    }
-    if (keep) {
-      selected_indices->push_back(idx);
-    }
-    sorted_indices.erase(sorted_indices.begin());
-    if (keep && eta < 1 && adaptive_threshold > 0.5) {
-      adaptive_threshold *= eta;
-    }
-  }
+  lite::host::math::GreedyNMS(cls_dets.data(),
+                              kPredSize,
+                              sorted_indices.data(),
+                              num_boxes,
+                              nms_threshold,
+                              eta,
+                              false,
+                              -1,
+                              selected_indices);
 }
 
 template <class T>
 void DeltaScoreToPrediction(
-    const std::vector<T>& bboxes_data,
-    const std::vector<T>& anchors_data,
+    const T* bboxes_data,
+    const T* anchors_data,
     T im_height,
     T im_width,
     T im_scale,
     int class_num,
     const std::vector<std::pair<T, int>>& sorted_indices,
-    std::map<int, std::vector<std::vector<T>>>* preds) {
+    std::map<int, std::vector<T>>* preds) {
   im_height = static_cast<T>(std::round(im_height / im_scale));
   im_width = static_cast<T>(std::round(im_width / im_scale));
   T zero(0);
-  int i = 0;
   for (const auto& it : sorted_indices) {
     T score = it.first;
     int idx = it.second;
@@ -188,69 +107,72 @@ void DeltaScoreToPrediction(
     pred_box_xmax = (std::max)((std::min)(pred_box_xmax, im_width - 1), zero);
     pred_box_ymax = (std::max)((std::min)(pred_box_ymax, im_height - 1), zero);
 
-    std::vector<T> one_pred;
+    auto& one_pred = (*preds)[c];
     one_pred.push_back(pred_box_xmin);
     one_pred.push_back(pred_box_ymin);
     one_pred.push_back(pred_box_xmax);
     one_pred.push_back(pred_box_ymax);
     one_pred.push_back(score);
-    (*preds)[c].push_back(one_pred);
-    i++;
   }
 }
 
 template <class T>
-void MultiClassNMS(const std::map<int, std::vector<std::vector<T>>>& preds,
+void MultiClassNMS(const std::map<int, std::vector<T>>& preds,
                    int class_num,
                    const int keep_top_k,
                    const T nms_threshold,
                    const T nms_eta,
                    std::vector<std::vector<T>>* nmsed_out,
                    int* num_nmsed_out) {
-  std::map<int, std::vector<int>> indices;
-  int num_det = 0;
-  for (int c = 0; c < class_num; ++c) {
-    if (static_cast<bool>(preds.count(c))) {
-      const std::vector<std::vector<T>> cls_dets = preds.at(c);
-      NMSFast(cls_dets, nms_threshold, nms_eta, &(indices[c]));
-      num_det += indices[c].size();
+  // the classes with predictions run in parallel
+  std::vector<int> labels;
+  std::vector<const std::vector<T>*> cls_dets;
+  for (const auto& it : preds) {
+    if (it.first < class_num) {
+      labels.push_back(it.first);
+      cls_dets.push_back(&it.second);
     }
   }
-
-  std::vector<std::pair<float, std::pair<int, int>>> score_index_pairs;
-  for (const auto& it : indices) {
-    int label = it.first;
-    const std::vector<int>& label_indices = it.second;
-    for (size_t j = 0; j < label_indices.size(); ++j) {
-      int idx = label_indices[j];
-      score_index_pairs.push_back(
-          std::make_pair(preds.at(label)[idx][4], std::make_pair(label, idx)));
+  int num_labels = labels.size();
+  std::vector<std::vector<int>> indices(num_labels);
+  LITE_PARALLEL_BEGIN(l, tid, num_labels) {
+    NMSFast(*cls_dets[l], nms_threshold, nms_eta, &indices[l]);
+  }
+  LITE_PARALLEL_END();
+
+  // the score and the position of every kept prediction in label order
+  std::vector<std::pair<T, int>> score_index_pairs;
+  std::vector<std::pair<int, int>> kept;
+  for (int l = 0; l < num_labels; ++l) {
+    for (int idx : indices[l]) {
+      score_index_pairs.emplace_back((*cls_dets[l])[idx * kPredSize + 4],
+                                     kept.size());
+      kept.emplace_back(l, idx);
     }
   }
+  int num_det = kept.size();
+  int num_keep = num_det > keep_top_k ? keep_top_k : num_det;
   // Keep top k results per image.
-  std::stable_sort(score_index_pairs.begin(),
-                   score_index_pairs.end(),
-                   SortScoreTwoPairDescend<int>);
-  if (num_det > keep_top_k) {
-    score_index_pairs.resize(keep_top_k);
-  }
+  std::partial_sort(score_index_pairs.begin(),
+                    score_index_pairs.begin() + num_keep,
+                    score_index_pairs.end(),
+                    lite::host::math::ScoreIndexDescend<T>);
+  score_index_pairs.resize(num_keep);
 
-  // Store the new indices.
-  std::map<int, std::vector<int>> new_indices;
   for (const auto& it : score_index_pairs) {
-    int label = it.second.first;
-    int idx = it.second.second;
+    int l = kept[it.second].first;
+    const T* pred = cls_dets[l]->data() + kept[it.second].second * kPredSize;
     std::vector<T> one_pred;
-    one_pred.push_back(label);
-    one_pred.push_back(preds.at(label)[idx][4]);
-    one_pred.push_back(preds.at(label)[idx][0]);
-    one_pred.push_back(preds.at(label)[idx][1]);
-    one_pred.push_back(preds.at(label)[idx][2]);
-    one_pred.push_back(preds.at(label)[idx][3]);
+    one_pred.push_back(labels[l]);
+    one_pred.push_back(pred[4]);
+    one_pred.push_back(pred[0]);
+    one_pred.push_back(pred[1]);
+    one_pred.push_back(pred[2]);
+    one_pred.push_back(pred[3]);
     nmsed_out->push_back(one_pred);
   }
 
-  *num_nmsed_out = (num_det > keep_top_k ? keep_top_k : num_det);
+  *num_nmsed_out = num_keep;
 }
 
 template <class T>
@@ -269,34 +191,23 @@ void RetinanetDetectionOutput(
   T score_threshold = static_cast<T>(param.score_threshold);
 
   int64_t class_num = scores[0].dims()[1];
-  std::map<int, std::vector<std::vector<T>>> preds;
+  std::map<int, std::vector<T>> preds;
+  std::vector<std::pair<T, int>> sorted_indices;
   for (size_t l = 0; l < scores.size(); ++l) {
-    // Fetch per level score
-    Tensor scores_per_level = scores[l];
-    // Fetch per level bbox
-    Tensor bboxes_per_level = bboxes[l];
-    // Fetch per level anchor
-    Tensor anchors_per_level = anchors[l];
-
-    int64_t scores_num = scores_per_level.numel();
-    int64_t bboxes_num = bboxes_per_level.numel();
-    std::vector<T> scores_data(scores_num);
-    std::vector<T> bboxes_data(bboxes_num);
-    std::vector<T> anchors_data(bboxes_num);
-    std::copy_n(scores_per_level.data<T>(), scores_num, scores_data.begin());
-    std::copy_n(bboxes_per_level.data<T>(), bboxes_num, bboxes_data.begin());
-    std::copy_n(anchors_per_level.data<T>(), bboxes_num, anchors_data.begin());
-    std::vector<std::pair<T, int>> sorted_indices;
-
     // For the highest level, we take the threshold 0.0
     T threshold = (l < (scores.size() - 1) ? score_threshold : 0.0);
-    GetMaxScoreIndex(scores_data, threshold, nms_top_k, &sorted_indices);
+    lite::host::math::GetTopKScoreIndex(scores[l].data<T>(),
+                                        scores[l].numel(),
+                                        1,
+                                        threshold,
+                                        nms_top_k,
+                                        &sorted_indices);
     auto* im_info_data = im_info.data<T>();
     auto im_height = im_info_data[0];
     auto im_width = im_info_data[1];
     auto im_scale = im_info_data[2];
-    DeltaScoreToPrediction(bboxes_data,
-                           anchors_data,
+    DeltaScoreToPrediction(bboxes[l].data<T>(),
+                           anchors[l].data<T>(),
                            im_height,
                            im_width,
                            im_scale,
@@ -353,10 +264,10 @@ void RetinanetDetectionOutputCompute::Run() {
   int64_t box_dim = box_dims[2];
   int64_t out_dim = box_dim + 2;
 
-  std::vector<std::vector<std::vector<float>>> all_nmsed_out;
-  std::vector<uint64_t> batch_starts = {0};
-  for (int i = 0; i < batch_size; ++i) {
-    int num_nmsed_out = 0;
+  // the images run in parallel, and the classes of an image if it is one
+  std::vector<std::vector<std::vector<float>>> all_nmsed_out(batch_size);
+  std::vector<int> all_num_nmsed_out(batch_size, 0);
+  LITE_PARALLEL_BEGIN(i, tid, batch_size) {
     std::vector<Tensor> box_per_batch_list(boxes_list.size());
     std::vector<Tensor> score_per_batch_list(scores_list.size());
     for (size_t j = 0; j < boxes_list.size(); ++j) {
@@ -368,16 +279,18 @@ void RetinanetDetectionOutputCompute::Run() {
     }
     Tensor im_info_slice = im_info->Slice<float>(i, i + 1);
 
-    std::vector<std::vector<float>> nmsed_out;
     RetinanetDetectionOutput(param,
                              score_per_batch_list,
                              box_per_batch_list,
                              anchors_list,
                              im_info_slice,
-                             &nmsed_out,
-                             &num_nmsed_out);
-    all_nmsed_out.push_back(nmsed_out);
-    batch_starts.push_back(batch_starts.back() + num_nmsed_out);
+                             &all_nmsed_out[i],
+                             &all_num_nmsed_out[i]);
+  }
+  LITE_PARALLEL_END();
+  std::vector<uint64_t> batch_starts = {0};
+  for (int i = 0; i < batch_size; ++i) {
+    batch_starts.push_back(batch_starts.back() + all_num_nmsed_out[i]);
   }
 
   uint64_t num_kept = batch_starts.back();
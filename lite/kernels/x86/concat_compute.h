@@ -14,7 +14,9 @@
 #pragma once
 
 #include <Eigen/Core>
+#include <type_traits>
 #include <vector>
+#include "lite/backends/x86/math/calib.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -78,6 +80,74 @@ class ConcatCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
   virtual ~ConcatCompute() = default;
 };
 
+// the int8 data of an input requantized to the scale of the output
+inline void concat_requantize(const int8_t* din,
+                              int8_t* dout,
+                              float scale,
+                              int64_t size) {
+  if (scale == 1.f) {
+    std::memcpy(dout, din, size);
+  } else {
+    lite::x86::math::int8_to_int8(din, dout, scale, size);
+  }
+}
+
+inline void concat_requantize(const int8_t* din,
+                              float* dout,
+                              float scale,
+                              int64_t size) {
+  lite::x86::math::int8_to_fp32(din, dout, &scale, 1, 1, size);
+}
+
+// concat of the int8 inputs of the scales param.input_scale, the int8 output
+// of OutType is quantized with param.output_scale
+template <PrecisionType OutType>
+class ConcatInt8Compute : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::ConcatParam;
+
+  void Run() override {
+    using T = typename std::
+        conditional<OutType == PRECISION(kInt8), int8_t, float>::type;
+    auto& param = *param_.get_mutable<param_t>();
+    CHECK_EQ(param.input_scale.size(), param.x.size())
+        << "The int8 concat needs the scales of all the inputs";
+    int axis = param.axis;
+    auto* axis_tensor = param.axis_tensor;
+    if (axis_tensor != nullptr) {
+      axis = axis_tensor->template data<int>()[0];
+    }
+    const auto& x_dims = param.x[0]->dims();
+    if (axis < 0) {
+      axis += static_cast<int>(x_dims.size());
+    }
+
+    const float out_scale =
+        OutType == PRECISION(kInt8) ? param.output_scale : 1.f;
+    T* output_data = param.output->template mutable_data<T>();
+    int offset_concat_axis = 0;
+    int num_concat = count(0, axis, x_dims);
+    int concat_input_size = count(axis + 1, x_dims.size(), x_dims);
+    const int top_concat_axis = param.output->dims()[axis];
+    for (size_t i = 0; i < param.x.size(); ++i) {
+      const int8_t* bottom_data = param.x[i]->template data<int8_t>();
+      const int64_t bottom_concat_axis = param.x[i]->dims()[axis];
+      const float scale = param.input_scale[i] / out_scale;
+      for (int n = 0; n < num_concat; ++n) {
+        concat_requantize(
+            bottom_data + n * bottom_concat_axis * concat_input_size,
+            output_data +
+                (n * top_concat_axis + offset_concat_axis) * concat_input_size,
+            scale,
+            bottom_concat_axis * concat_input_size);
+      }
+      offset_concat_axis += bottom_concat_axis;
+    }
+  }
+
+  virtual ~ConcatInt8Compute() = default;
+};
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -0,0 +1,121 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/concat_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// compares the int8 concat with the concat of the dequantized inputs, every
+// input is requantized from its own scale to the output scale
+static void test_concat_int8(const std::vector<std::vector<int64_t>>& shapes,
+                             const std::vector<float>& scales,
+                             int axis) {
+  const float out_scale = 0.04f;
+  const int rank = static_cast<int>(shapes[0].size());
+  const int real_axis = axis < 0 ? axis + rank : axis;
+  std::vector<lite::Tensor> inputs(shapes.size());
+  std::vector<lite::Tensor*> x;
+  std::vector<int64_t> out_shape = shapes[0];
+  out_shape[real_axis] = 0;
+  for (size_t i = 0; i < shapes.size(); i++) {
+    inputs[i].Resize(lite::DDim(shapes[i]));
+    auto* data = inputs[i].mutable_data<int8_t>();
+    for (int64_t j = 0; j < inputs[i].numel(); j++) {
+      data[j] = static_cast<int8_t>((j * 37 + 11 * i + 5) % 255 - 127);
+    }
+    x.push_back(&inputs[i]);
+    out_shape[real_axis] += shapes[i][real_axis];
+  }
+
+  // the dequantized reference, the rows of the inputs before axis are
+  // interleaved in the output
+  lite::Tensor ref;
+  ref.Resize(lite::DDim(out_shape));
+  float* ref_data = ref.mutable_data<float>();
+  int64_t outer = 1;
+  for (int d = 0; d < real_axis; d++) {
+    outer *= out_shape[d];
+  }
+  int64_t pos = 0;
+  for (int64_t n = 0; n < outer; n++) {
+    for (size_t i = 0; i < x.size(); i++) {
+      const int64_t row = x[i]->numel() / outer;
+      const int8_t* data = x[i]->data<int8_t>() + n * row;
+      for (int64_t j = 0; j < row; j++) {
+        ref_data[pos++] = data[j] * scales[i];
+      }
+    }
+  }
+
+  lite::Tensor out_int8, out_fp32;
+  out_int8.Resize(lite::DDim(out_shape));
+  out_fp32.Resize(lite::DDim(out_shape));
+  operators::ConcatParam param;
+  param.x = x;
+  param.axis = axis;
+  param.enable_int8 = true;
+  param.input_scale = scales;
+  param.output_scale = out_scale;
+  auto run = [&](KernelBase* kernel, lite::Tensor* out) {
+    param.output = out;
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    kernel->SetContext(std::move(ctx));
+    kernel->SetParam(param);
+    kernel->Launch();
+  };
+  ConcatInt8Compute<PRECISION(kInt8)> concat_int8;
+  ConcatInt8Compute<PRECISION(kFloat)> concat_fp32;
+  run(&concat_int8, &out_int8);
+  run(&concat_fp32, &out_fp32);
+
+  const int8_t* out_int8_data = out_int8.data<int8_t>();
+  const float* out_fp32_data = out_fp32.data<float>();
+  for (int64_t i = 0; i < ref.numel(); i++) {
+    float expect = (std::min)((std::max)(ref_data[i], -127 * out_scale),
+                              127 * out_scale);
+    ASSERT_NEAR(out_fp32_data[i], ref_data[i], 1e-5)
+        << "axis " << axis << " at " << i;
+    ASSERT_NEAR(out_int8_data[i] * out_scale, expect, out_scale * 0.51f)
+        << "axis " << axis << " at " << i;
+  }
+}
+
+TEST(concat_x86, int8) {
+  // the first input has the output scale and is copied as it is
+  test_concat_int8(
+      {{2, 3, 4, 5}, {2, 2, 4, 5}, {2, 1, 4, 5}}, {0.04f, 0.02f, 0.07f}, 1);
+  test_concat_int8({{2, 3, 4, 5}, {2, 3, 2, 5}}, {0.03f, 0.05f}, 2);
+  test_concat_int8({{3, 7}, {3, 9}, {3, 1}}, {0.01f, 0.04f, 0.1f}, -1);
+  test_concat_int8({{1, 16, 3, 3}, {2, 16, 3, 3}}, {0.05f, 0.04f}, 0);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(concat, kX86, kInt8, kNCHW, int8_out);
+USE_LITE_KERNEL(concat, kX86, kInt8, kNCHW, fp32_out);
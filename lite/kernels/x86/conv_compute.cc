@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/kernels/x86/conv_compute.h"
+#include <algorithm>
 #include <utility>
 #include "lite/backends/x86/math/fill_bias_activate.h"
 #include "lite/kernels/x86/conv_depthwise.h"
@@ -80,17 +81,11 @@ namespace x86 {
       ((paddings[0] == paddings[1]) && (paddings[2] == paddings[3]));
 
 template <>
-void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
+std::vector<std::string>
+Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::Implementations() const {
   PREPARE_PARAM
   //! todo add conv_5x5_depthwise implement
   bool flag_dw = flag_dw_3x3 || flag_dw_5x5;
-  if (kernel_w == 1 && stride_w == 1 && paddings[0] == 0 && kps_equal &&
-      pads_equal) {
-    flag_1x1gemm_ = true;
-  } else {
-    flag_1x1gemm_ = false;
-  }
-
   bool nodilations = true;
   for (auto ele : *(param.dilations))
     if (ele != 1) nodilations = false;
@@ -100,28 +95,73 @@ void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
                        (paddings[2] == paddings[3]);
   bool flag_p = paddings[0] <= stride_h;
 
-  //! select conv impl
-  if (dw_kernel && kps_equal && flag_dw && pads_equal &&
-      ((flag_dw_5x5 && no_dilation) || (flag_dw_3x3 && (groups & 3) == 0))) {
-    impl_ = new DepthwiseConv<PRECISION(kFloat), PRECISION(kFloat)>;
-    VLOG(3) << "invoking conv_depthwise_3x3p0p1 or conv_depthwise_5x5";
-  }
-
+  std::vector<std::string> impls;
   // support 3x3s1p01,5x5s1p01,7x7s1p01
   //  3x3s2p012,5x5s1p012,7x7s1p012
   if (output_channel % 8 == 0 && groups == 1 &&
       (kernel_h == 3 || kernel_h == 5 || kernel_h == 7) &&
       (stride_h == 2 || stride_h == 1) && nodilations && kps_equal &&
       pad_all_equal && flag_p) {
+    impls.push_back("direct");
+  }
+  if (dw_kernel && kps_equal && flag_dw && pads_equal &&
+      ((flag_dw_5x5 && no_dilation) || (flag_dw_3x3 && (groups & 3) == 0))) {
+    impls.push_back("depthwise");
+  }
+  //! im2col followed by the packed gemm, or by the gemm of the math library
+  impls.push_back("gemm");
+  impls.push_back("blas_gemm");
+  return impls;
+}
+
+template <>
+void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
+  PREPARE_PARAM
+  if (kernel_w == 1 && stride_w == 1 && paddings[0] == 0 && kps_equal &&
+      pads_equal) {
+    flag_1x1gemm_ = true;
+  } else {
+    flag_1x1gemm_ = false;
+  }
+
+  //! select conv impl
+  auto impls = Implementations();
+  std::string impl = implementation_;
+  if (std::find(impls.begin(), impls.end(), impl) == impls.end()) {
+    if (!impl.empty()) {
+      LOG(WARNING) << "The conv2d implementation " << impl
+                   << " does not support the param, " << impls.front()
+                   << " is used instead.";
+    }
+    impl = impls.front();
+  }
+  if (impl == "depthwise") {
+    impl_ = new DepthwiseConv<PRECISION(kFloat), PRECISION(kFloat)>;
+    VLOG(3) << "invoking conv_depthwise_3x3p0p1 or conv_depthwise_5x5";
+  } else if (impl == "direct") {
     impl_ = new DirectConv<PRECISION(kFloat), PRECISION(kFloat)>();
     VLOG(3) << "invoking directConv";
   }
 
   if (impl_) {
-    impl_->SetContext(std::move(this->ctx_));
+    // the parallel regions of impl_ run in the pool of this kernel
+    impl_->SetContext(ContextScheduler::Global().NewContext(TARGET(kX86)));
     impl_->SetParam(param);
     impl_->PrepareForRun();
     is_first_epoch_ = false;
+    return;
+  }
+  if (impl == "blas_gemm") return;
+
+  //! pack the weights of every group once for the gemm
+  auto& ctx = ctx_->As<X86Context>();
+  int m = output_channel / groups;
+  int k = input_channel * kernel_h * kernel_w / groups;
+  auto weights = param.filter->data<float>();
+  packed_weights_.clear();
+  for (int g = 0; g < groups; g++) {
+    packed_weights_.push_back(lite::x86::math::PackedWeight::Get(
+        ctx, true, m, k, *param.filter, weights + g * m * k, k));
   }
 }
 
@@ -150,11 +190,14 @@ void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   float* col_data = nullptr;
 
   if (!flag_1x1gemm_) {
-    size_t col_size = group_size_coldata * group;
-    size_t col_data_size = static_cast<size_t>(col_size * sizeof(float));
-    col_data = static_cast<float*>(TargetMalloc(TARGET(kX86), col_data_size));
+    col_buffer_.Resize({static_cast<int64_t>(group_size_coldata * group)});
+    col_data = col_buffer_.mutable_data<float>();
   }
   auto act_param = param.activation_param;
+  //! the packed gemm adds the bias and activates before storing the output
+  bool fuse_bias_act =
+      !packed_weights_.empty() &&
+      lite::x86::math::SgemmEpilogue::Supports(act_param.active_type);
   paddle::lite::x86::math::Blas<lite::TargetType::kX86> matmul(ctx);
   for (int i = 0; i < num; i++) {
     const float* din_batch = din + i * channel_in_size;
@@ -183,7 +226,21 @@ void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
       const float* col_data_group = din_data + g * group_size_coldata;
       const float* weights_group = weights + g * group_size_weights;
       float* dout_group = dout_batch + g * group_size_out;
-      if (n == 1) {
+      if (!packed_weights_.empty()) {
+        lite::x86::math::SgemmEpilogue epilogue;
+        if (fuse_bias_act) {
+          epilogue = lite::x86::math::SgemmEpilogue(
+              flag_bias ? bias_ptr + g * m : nullptr, false, act_param);
+        }
+        packed_weights_[g]->Compute(ctx,
+                                    n,
+                                    col_data_group,
+                                    n,
+                                    dout_group,
+                                    n,
+                                    epilogue,
+                                    &gemm_workspace_);
+      } else if (n == 1) {
         matmul.GEMV<float>(
             false, m, k, 1.f, weights_group, col_data_group, 0.f, dout_group);
       } else {
@@ -203,10 +260,11 @@ void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
       }
     }
     //! bias and activate
-    lite::x86::math::fill_bias_act(
-        dout_batch, bias_ptr, chout, wout * hout, flag_bias, &act_param);
+    if (!fuse_bias_act) {
+      lite::x86::math::fill_bias_act(
+          dout_batch, bias_ptr, chout, wout * hout, flag_bias, &act_param);
+    }
   }
-  if (!flag_1x1gemm_) TargetFree(TARGET(kX86), col_data);
 }
 
 template <>
@@ -301,9 +359,8 @@ void Conv2dCompute<PRECISION(kInt8), PRECISION(kFloat)>::Run() {
   auto dilations = *param.dilations;
 
   if (!flag_1x1gemm_) {
-    int col_size = group * group_size_coldata;
-    col_data = static_cast<int8_t*>(
-        TargetMalloc(TARGET(kX86), col_size * sizeof(int8_t)));
+    col_buffer_.Resize({static_cast<int64_t>(group * group_size_coldata)});
+    col_data = col_buffer_.mutable_data<int8_t>();
   }
   for (int b = 0; b < num; ++b) {
     for (int g = 0; g < group; ++g) {
@@ -334,7 +391,6 @@ void Conv2dCompute<PRECISION(kInt8), PRECISION(kFloat)>::Run() {
       }
     }
   }
-  if (!flag_1x1gemm_) TargetFree(TARGET(kX86), col_data);
 }
 
 template <>
@@ -432,9 +488,8 @@ void Conv2dCompute<PRECISION(kInt8), PRECISION(kInt8)>::Run() {
   auto dilations = *param.dilations;
 
   if (!flag_1x1gemm_) {
-    int col_size = group * group_size_coldata;
-    col_data = static_cast<int8_t*>(
-        TargetMalloc(TARGET(kX86), col_size * sizeof(int8_t)));
+    col_buffer_.Resize({static_cast<int64_t>(group * group_size_coldata)});
+    col_data = col_buffer_.mutable_data<int8_t>();
   }
   for (int b = 0; b < num; ++b) {
     for (int g = 0; g < group; ++g) {
@@ -465,7 +520,6 @@ void Conv2dCompute<PRECISION(kInt8), PRECISION(kInt8)>::Run() {
       }
     }
   }
-  if (!flag_1x1gemm_) TargetFree(TARGET(kX86), col_data);
 }
 
 #undef PREPARE_PARAM
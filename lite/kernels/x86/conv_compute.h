@@ -14,6 +14,7 @@
 #pragma once
 
 #include <Eigen/Core>
+#include <memory>
 #include <string>
 #include <vector>
 #include "lite/backends/x86/math/avx/conv_utils.h"
@@ -21,6 +22,7 @@
 #include "lite/backends/x86/math/conv_bias.h"
 #include "lite/backends/x86/math/gemm_s8u8_compute.h"
 #include "lite/backends/x86/math/im2col.h"
+#include "lite/backends/x86/math/packed_weight.h"
 #include "lite/backends/x86/math/vol2col.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
@@ -51,6 +53,9 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), Ptype> {
  public:
   virtual void PrepareForRun();
 
+  // depthwise, direct, gemm and blas_gemm for the float kernel
+  virtual std::vector<std::string> Implementations() const { return {}; }
+
   virtual void ReInitWhenNeeded() {
     if (impl_) {
       impl_->ReInitWhenNeeded();
@@ -86,12 +91,22 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), Ptype> {
   std::vector<float> w_scale_;
   Tensor weights_;
   Tensor bias_;
+  // the im2col buffer and the packed input of the gemm, kept across runs
+  Tensor col_buffer_;
+  Tensor gemm_workspace_;
+  // the weights of every group packed for the gemm
+  std::vector<std::shared_ptr<const lite::x86::math::PackedWeight>>
+      packed_weights_;
   std::vector<lite::x86::math::generate_gemm_s8u8_x86_kern<float>*>
       gemm_s8_ptr_float_{};
   std::vector<lite::x86::math::generate_gemm_s8u8_x86_kern<int8_t>*>
       gemm_s8_ptr_int8_{};
 };
 
+template <>
+std::vector<std::string>
+Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::Implementations() const;
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -13,8 +13,10 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
 
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -92,6 +94,182 @@ TEST(conv2d_x86, run_test) {
   }
 }
 
+TEST(conv2d_x86, run_prepared_test) {
+  // grouped 3x3 conv on the im2col + gemm path, run twice after preparing
+  const int batch_size = 2, chin = 4, chout = 6, groups = 2, hw = 5;
+  lite::Tensor x, filter, out;
+  x.Resize({batch_size, chin, hw, hw});
+  filter.Resize({chout, chin / groups, 3, 3});
+  out.Resize({batch_size, chout, hw, hw});
+  auto x_data = x.mutable_data<float>();
+  auto filter_data = filter.mutable_data<float>();
+  for (int64_t i = 0; i < x.dims().production(); i++) {
+    x_data[i] = static_cast<float>(i % 7) - 3.f;
+  }
+  for (int64_t i = 0; i < filter.dims().production(); i++) {
+    filter_data[i] = static_cast<float>(i % 5) * 0.5f - 1.f;
+  }
+  std::vector<float> ref(out.dims().production(), 0.f);
+  for (int n = 0; n < batch_size; n++) {
+    for (int oc = 0; oc < chout; oc++) {
+      int g = oc / (chout / groups);
+      for (int oh = 0; oh < hw; oh++) {
+        for (int ow = 0; ow < hw; ow++) {
+          float sum = 0.f;
+          for (int ic = 0; ic < chin / groups; ic++) {
+            for (int kh = 0; kh < 3; kh++) {
+              for (int kw = 0; kw < 3; kw++) {
+                int ih = oh + kh - 1, iw = ow + kw - 1;
+                if (ih < 0 || ih >= hw || iw < 0 || iw >= hw) continue;
+                int c = g * (chin / groups) + ic;
+                sum += x_data[((n * chin + c) * hw + ih) * hw + iw] *
+                       filter_data[((oc * (chin / groups) + ic) * 3 + kh) * 3 +
+                                   kw];
+              }
+            }
+          }
+          ref[((n * chout + oc) * hw + oh) * hw + ow] = sum;
+        }
+      }
+    }
+  }
+
+  Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)> conv2d;
+  operators::ConvParam param;
+  param.x = &x;
+  param.filter = &filter;
+  param.output = &out;
+  param.strides = {1, 1};
+  param.groups = groups;
+  param.paddings = std::make_shared<std::vector<int>>(4, 1);
+  param.dilations = std::make_shared<std::vector<int>>(2, 1);
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  conv2d.SetContext(std::move(ctx));
+  conv2d.SetParam(param);
+  conv2d.PrepareForRun();
+  for (int iter = 0; iter < 2; iter++) {
+    conv2d.Run();
+    auto out_data = out.data<float>();
+    for (int i = 0; i < out.dims().production(); i++) {
+      EXPECT_NEAR(out_data[i], ref[i], 1e-4);
+    }
+  }
+}
+
+TEST(conv2d_x86, run_fused_bias_act_test) {
+  // 1x1 conv with the bias and relu6 fused into the gemm
+  const int batch_size = 1, chin = 5, chout = 7, hw = 6;
+  lite::Tensor x, filter, bias, out;
+  x.Resize({batch_size, chin, hw, hw});
+  filter.Resize({chout, chin, 1, 1});
+  bias.Resize({chout});
+  out.Resize({batch_size, chout, hw, hw});
+  auto x_data = x.mutable_data<float>();
+  auto filter_data = filter.mutable_data<float>();
+  auto bias_data = bias.mutable_data<float>();
+  for (int64_t i = 0; i < x.dims().production(); i++) {
+    x_data[i] = static_cast<float>(i % 9) - 4.f;
+  }
+  for (int64_t i = 0; i < filter.dims().production(); i++) {
+    filter_data[i] = static_cast<float>(i % 4) * 0.5f - 0.5f;
+  }
+  for (int i = 0; i < chout; i++) {
+    bias_data[i] = static_cast<float>(i) - 3.f;
+  }
+  std::vector<float> ref(out.dims().production(), 0.f);
+  for (int oc = 0; oc < chout; oc++) {
+    for (int p = 0; p < hw * hw; p++) {
+      float sum = bias_data[oc];
+      for (int ic = 0; ic < chin; ic++) {
+        sum += x_data[ic * hw * hw + p] * filter_data[oc * chin + ic];
+      }
+      ref[oc * hw * hw + p] = std::min(std::max(sum, 0.f), 6.f);
+    }
+  }
+
+  Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)> conv2d;
+  operators::ConvParam param;
+  param.x = &x;
+  param.filter = &filter;
+  param.bias = &bias;
+  param.output = &out;
+  param.strides = {1, 1};
+  param.paddings = std::make_shared<std::vector<int>>(4, 0);
+  param.dilations = std::make_shared<std::vector<int>>(2, 1);
+  param.activation_param.has_active = true;
+  param.activation_param.active_type = lite_api::ActivationType::kRelu6;
+  param.activation_param.Relu_clipped_coef = 6.f;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  conv2d.SetContext(std::move(ctx));
+  conv2d.SetParam(param);
+  conv2d.PrepareForRun();
+  conv2d.Run();
+  auto out_data = out.data<float>();
+  for (int i = 0; i < out.dims().production(); i++) {
+    EXPECT_NEAR(out_data[i], ref[i], 1e-4);
+  }
+}
+
+TEST(conv2d_x86, run_implementations_test) {
+  // 3x3s1p1 conv offers the direct, gemm and blas_gemm implementations
+  const int batch_size = 2, chin = 3, chout = 8, hw = 7;
+  lite::Tensor x, filter, bias;
+  x.Resize({batch_size, chin, hw, hw});
+  filter.Resize({chout, chin, 3, 3});
+  bias.Resize({chout});
+  auto x_data = x.mutable_data<float>();
+  auto filter_data = filter.mutable_data<float>();
+  auto bias_data = bias.mutable_data<float>();
+  for (int64_t i = 0; i < x.dims().production(); i++) {
+    x_data[i] = static_cast<float>(i % 11) * 0.25f - 1.f;
+  }
+  for (int64_t i = 0; i < filter.dims().production(); i++) {
+    filter_data[i] = static_cast<float>(i % 5) * 0.5f - 1.f;
+  }
+  for (int i = 0; i < chout; i++) {
+    bias_data[i] = static_cast<float>(i) * 0.5f - 2.f;
+  }
+
+  std::vector<std::vector<float>> outs;
+  std::vector<std::string> impls;
+  for (size_t i = 0; impls.empty() || i < impls.size(); i++) {
+    lite::Tensor out;
+    out.Resize({batch_size, chout, hw, hw});
+    Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)> conv2d;
+    operators::ConvParam param;
+    param.x = &x;
+    param.filter = &filter;
+    param.bias = &bias;
+    param.output = &out;
+    param.strides = {1, 1};
+    param.paddings = std::make_shared<std::vector<int>>(4, 1);
+    param.dilations = std::make_shared<std::vector<int>>(2, 1);
+    param.activation_param.has_active = true;
+    param.activation_param.active_type = lite_api::ActivationType::kRelu;
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    conv2d.SetContext(std::move(ctx));
+    conv2d.SetParam(param);
+    if (impls.empty()) {
+      impls = conv2d.Implementations();
+      ASSERT_EQ(impls.size(), 3u);
+      EXPECT_EQ(impls.front(), "direct");
+    }
+    conv2d.set_implementation(impls[i]);
+    conv2d.PrepareForRun();
+    conv2d.Run();
+    outs.emplace_back(out.data<float>(),
+                      out.data<float>() + out.dims().production());
+  }
+  for (size_t i = 1; i < outs.size(); i++) {
+    for (size_t j = 0; j < outs[0].size(); j++) {
+      EXPECT_NEAR(outs[i][j], outs[0][j], 1e-4) << impls[i];
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -17,9 +17,11 @@
 
 #include "lite/kernels/x86/elementwise_compute.h"
 #include <string>
+#include <type_traits>
 #include <vector>
 #include "lite/backends/x86/math/elementwise.h"
 #include "lite/backends/x86/math/elementwise_common_broadcast_config.h"
+#include "lite/backends/x86/math/elementwise_int8.h"
 #include "lite/kernels/host/elementwise_op_func.h"
 
 namespace paddle {
@@ -371,6 +373,50 @@ ElementwiseOpCompute(Pow)
 ElementwiseOpActivationCompute(Pow)
 // clang-format on
 
+inline bool fuse_relu(const operators::ElementwiseParam& param) {
+  return false;
+}
+
+inline bool fuse_relu(
+    const operators::FusionElementwiseActivationParam& param) {
+  CHECK_EQ(param.act_type, "relu")
+      << "The int8 elementwise_add supports relu only";
+  return true;
+}
+
+template <typename ParamT, PrecisionType OutType>
+void ElementwiseAddInt8Compute<ParamT, OutType>::Run() {
+  using T = typename std::
+      conditional<OutType == PRECISION(kInt8), int8_t, float>::type;
+  auto& param = this->template Param<ParamT>();
+  CHECK(!param.fuse_scale) << "The int8 elementwise_add can't fuse scale";
+  const bool relu = fuse_relu(param);
+  const float out_scale =
+      OutType == PRECISION(kInt8) ? param.output_scale : 1.f;
+  const float x_scale = param.x_input_scale / out_scale;
+  const float y_scale = param.y_input_scale / out_scale;
+  auto* x_data = param.X->template data<int8_t>();
+  auto* y_data = param.Y->template data<int8_t>();
+  auto* out_data = param.Out->template mutable_data<T>();
+  auto x_dims = param.X->dims();
+  auto y_dims = param.Y->dims();
+  int pre, n, post;
+  if (x_dims == y_dims) {
+    x86_math::elementwise_add_int8(
+        x_data, y_data, out_data, x_dims.production(), x_scale, y_scale, relu);
+  } else if (is_fast_broadcast(x_dims, y_dims, param.axis, &pre, &n, &post)) {
+    x86_math::elementwise_add_broadcast_int8(
+        x_data, y_data, out_data, pre, n, post, x_scale, y_scale, relu);
+  } else if (param.axis == -1 &&
+             is_fast_broadcast(y_dims, x_dims, param.axis, &pre, &n, &post)) {
+    x86_math::elementwise_add_broadcast_int8(
+        y_data, x_data, out_data, pre, n, post, y_scale, x_scale, relu);
+  } else {
+    LOG(FATAL) << "The int8 elementwise_add doesn't support the broadcast of "
+               << x_dims << " and " << y_dims;
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -421,6 +467,59 @@ REGISTER_LITE_KERNEL(
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
     .Finalize();
 
+typedef paddle::lite::kernels::x86::ElementwiseAddInt8Compute<
+    paddle::lite::operators::ElementwiseParam,
+    PRECISION(kInt8)>
+    ElementwiseAddInt8_Int8;
+typedef paddle::lite::kernels::x86::ElementwiseAddInt8Compute<
+    paddle::lite::operators::ElementwiseParam,
+    PRECISION(kFloat)>
+    ElementwiseAddInt8_Fp32;
+typedef paddle::lite::kernels::x86::ElementwiseAddInt8Compute<
+    paddle::lite::operators::FusionElementwiseActivationParam,
+    PRECISION(kInt8)>
+    ElementwiseAddActivationInt8_Int8;
+typedef paddle::lite::kernels::x86::ElementwiseAddInt8Compute<
+    paddle::lite::operators::FusionElementwiseActivationParam,
+    PRECISION(kFloat)>
+    ElementwiseAddActivationInt8_Fp32;
+
+REGISTER_LITE_KERNEL(
+    elementwise_add, kX86, kInt8, kNCHW, ElementwiseAddInt8_Int8, int8_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    elementwise_add, kX86, kInt8, kNCHW, ElementwiseAddInt8_Fp32, fp32_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(fusion_elementwise_add_activation,
+                     kX86,
+                     kInt8,
+                     kNCHW,
+                     ElementwiseAddActivationInt8_Int8,
+                     int8_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(fusion_elementwise_add_activation,
+                     kX86,
+                     kInt8,
+                     kNCHW,
+                     ElementwiseAddActivationInt8_Fp32,
+                     fp32_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
+
 REGISTER_LITE_KERNEL(elementwise_sub,
                      kX86,
                      kFloat,
@@ -40,6 +40,19 @@ class ElementwiseAddActivationCompute
   virtual ~ElementwiseAddActivationCompute() = default;
 };
 
+// elementwise_add and fusion_elementwise_add_activation with relu of the int8
+// x and y, the int8 output of OutType is quantized with param.output_scale
+template <typename ParamT, PrecisionType OutType>
+class ElementwiseAddInt8Compute
+    : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = ParamT;
+
+  void Run() override;
+
+  virtual ~ElementwiseAddInt8Compute() = default;
+};
+
 template <typename T>
 class ElementwiseSubCompute
     : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
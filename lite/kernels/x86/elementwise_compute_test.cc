@@ -0,0 +1,171 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/elementwise_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+static std::unique_ptr<KernelBase> create_int8_kernel(
+    const std::string& op_type, const std::string& alias) {
+  auto kernels = KernelRegistry::Global().Create(
+      op_type, TARGET(kX86), PRECISION(kInt8), DATALAYOUT(kNCHW));
+  for (auto& kernel : kernels) {
+    if (kernel->alias() == alias) {
+      return std::move(kernel);
+    }
+  }
+  LOG(FATAL) << "no " << alias << " kernel of " << op_type;
+  return nullptr;
+}
+
+// the float sum of the dequantized x and y, the smaller one of them is
+// broadcast to the other from axis
+static void elementwise_add_ref(const lite::Tensor& x,
+                                const lite::Tensor& y,
+                                float x_scale,
+                                float y_scale,
+                                int axis,
+                                bool relu,
+                                lite::Tensor* out) {
+  const bool swapped = x.dims().size() < y.dims().size();
+  const auto& big = swapped ? y.dims() : x.dims();
+  const auto& small = swapped ? x.dims() : y.dims();
+  const int offset = axis == -1 ? big.size() - small.size() : axis;
+  out->Resize(big);
+  const int8_t* x_data = x.data<int8_t>();
+  const int8_t* y_data = y.data<int8_t>();
+  float* out_data = out->mutable_data<float>();
+  for (int64_t i = 0; i < big.production(); i++) {
+    int64_t small_index = 0;
+    int64_t rest = i;
+    int64_t small_stride = 1;
+    for (int d = big.size() - 1; d >= 0; d--) {
+      const int64_t index = rest % big[d];
+      rest /= big[d];
+      if (d >= offset && d < offset + static_cast<int>(small.size()) &&
+          small[d - offset] > 1) {
+        small_index += index * small_stride;
+        small_stride *= small[d - offset];
+      }
+    }
+    const int64_t x_index = swapped ? small_index : i;
+    const int64_t y_index = swapped ? i : small_index;
+    float sum = x_data[x_index] * x_scale + y_data[y_index] * y_scale;
+    out_data[i] = relu ? (std::max)(sum, 0.f) : sum;
+  }
+}
+
+// compares the int8 elementwise_add and its fused relu form with the float
+// sum of the dequantized inputs
+static void test_elementwise_add_int8(const std::vector<int64_t>& x_shape,
+                                      const std::vector<int64_t>& y_shape,
+                                      int axis,
+                                      bool relu) {
+  const float x_scale = 0.05f;
+  const float y_scale = 0.02f;
+  const float out_scale = 0.06f;
+  lite::Tensor x, y, out_int8, out_fp32, ref;
+  x.Resize(lite::DDim(x_shape));
+  y.Resize(lite::DDim(y_shape));
+  auto* x_data = x.mutable_data<int8_t>();
+  auto* y_data = y.mutable_data<int8_t>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = static_cast<int8_t>((i * 37 + 11) % 255 - 127);
+  }
+  for (int64_t i = 0; i < y.numel(); i++) {
+    y_data[i] = static_cast<int8_t>((i * 53 + 5) % 255 - 127);
+  }
+  elementwise_add_ref(x, y, x_scale, y_scale, axis, relu, &ref);
+  out_int8.Resize(ref.dims());
+  out_fp32.Resize(ref.dims());
+
+  operators::FusionElementwiseActivationParam param;
+  param.X = &x;
+  param.Y = &y;
+  param.axis = axis;
+  param.act_type = "relu";
+  param.enable_int8 = true;
+  param.x_input_scale = x_scale;
+  param.y_input_scale = y_scale;
+  param.output_scale = out_scale;
+  const std::string op_type =
+      relu ? "fusion_elementwise_add_activation" : "elementwise_add";
+  auto run = [&](const std::string& alias, lite::Tensor* out) {
+    auto kernel = create_int8_kernel(op_type, alias);
+    param.Out = out;
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    kernel->SetContext(std::move(ctx));
+    if (relu) {
+      kernel->SetParam(param);
+    } else {
+      kernel->SetParam(static_cast<operators::ElementwiseParam>(param));
+    }
+    kernel->Launch();
+  };
+  run("int8_out", &out_int8);
+  run("fp32_out", &out_fp32);
+
+  const float* ref_data = ref.data<float>();
+  const int8_t* out_int8_data = out_int8.data<int8_t>();
+  const float* out_fp32_data = out_fp32.data<float>();
+  for (int64_t i = 0; i < ref.numel(); i++) {
+    float expect = (std::min)((std::max)(ref_data[i], -127 * out_scale),
+                              127 * out_scale);
+    ASSERT_NEAR(out_fp32_data[i], ref_data[i], 1e-4)
+        << op_type << " " << x.dims() << " + " << y.dims() << " at " << i;
+    ASSERT_NEAR(out_int8_data[i] * out_scale, expect, out_scale * 0.51f)
+        << op_type << " " << x.dims() << " + " << y.dims() << " at " << i;
+  }
+}
+
+TEST(elementwise_add_x86, int8) {
+  for (bool relu : {false, true}) {
+    // same shape
+    test_elementwise_add_int8({2, 3, 4, 5}, {2, 3, 4, 5}, -1, relu);
+    test_elementwise_add_int8({37}, {37}, -1, relu);
+    // y broadcast to x
+    test_elementwise_add_int8({2, 3, 4, 5}, {3}, 1, relu);
+    test_elementwise_add_int8({2, 3, 4, 5}, {3, 4}, 1, relu);
+    test_elementwise_add_int8({2, 3, 4, 5}, {4, 5}, -1, relu);
+    test_elementwise_add_int8({1, 40, 3, 3}, {40, 1, 1}, 1, relu);
+    // x broadcast to y
+    test_elementwise_add_int8({4, 5}, {2, 3, 4, 5}, -1, relu);
+    test_elementwise_add_int8({17}, {2, 17}, -1, relu);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(elementwise_add, kX86, kInt8, kNCHW, int8_out);
+USE_LITE_KERNEL(elementwise_add, kX86, kInt8, kNCHW, fp32_out);
+USE_LITE_KERNEL(
+    fusion_elementwise_add_activation, kX86, kInt8, kNCHW, int8_out);
+USE_LITE_KERNEL(
+    fusion_elementwise_add_activation, kX86, kInt8, kNCHW, fp32_out);
@@ -140,6 +140,30 @@ class FCFunctor {
   }
 };
 
+template <>
+void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
+  auto& param = *param_.get_mutable<param_t>();
+  auto* w = param.w;
+  bool padding_weights = param.padding_weights;
+  const auto& w_dims = w->dims();
+  auto w_dims0 = padding_weights ? w_dims[0] - 4 : w_dims[0];
+  auto w_dims1 = padding_weights ? w_dims[1] - 4 : w_dims[1];
+  if (w->precision() == PRECISION(kInt8) ||
+      w->precision() == PRECISION(kInt16)) {
+    CHECK(!padding_weights) << "The quantized weights of fc are not padded";
+    packed_w_ = lite::x86::math::PackedWeight::GetQuantized(
+        w_dims0, w_dims1, w, param.weight_scale);
+    return;
+  }
+  packed_w_ = lite::x86::math::PackedWeight::Get(ctx_->As<X86Context>(),
+                                                 false,
+                                                 w_dims0,
+                                                 w_dims1,
+                                                 *w,
+                                                 w->template data<float>(),
+                                                 w_dims[1]);
+}
+
 template <>
 void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   auto& param = *param_.get_mutable<param_t>();
@@ -157,23 +181,45 @@ void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   int M = output->dims().production() / w_dims1;
 
   const float* input_data = input->template data<float>();
-  const float* w_data = w->template data<float>();
   float* output_data = output->template mutable_data<float>();
 
   auto& context = ctx_->As<X86Context>();
+  if (packed_w_) {
+    // The packed weights skip the padding, the bias and relu are applied by
+    // the gemm.
+    lite::x86::math::SgemmEpilogue epilogue;
+    epilogue.bias = bias ? bias->template data<float>() : nullptr;
+    epilogue.bias_per_col = true;
+    if (with_relu) epilogue.act_type = lite_api::ActivationType::kRelu;
+    packed_w_->Compute(context,
+                       M,
+                       input_data,
+                       w_dims0,
+                       output_data,
+                       w_dims1,
+                       epilogue,
+                       &gemm_workspace_);
+    return;
+  }
   FCFunctor<lite::TargetType::kX86, float> fc;
   fc(context,
      M,
      w_dims1,
      w_dims0,
      input_data,
-     w_data,
+     w->template data<float>(),
      output_data,
      bias ? bias->template data<float>() : NULL,
      with_relu,
      padding_weights);
 }
 
+template <>
+void FcCompute<PRECISION(kInt8), PRECISION(kInt8)>::PrepareForRun() {}
+
+template <>
+void FcCompute<PRECISION(kInt8), PRECISION(kFloat)>::PrepareForRun() {}
+
 template <>
 void FcCompute<PRECISION(kInt8), PRECISION(kInt8)>::Run() {
   auto& param = this->Param<operators::FcParam>();
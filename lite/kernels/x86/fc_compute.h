@@ -14,11 +14,13 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 #include "lite/backends/x86/jit/helper.h"
 #include "lite/backends/x86/jit/kernel_base.h"
 #include "lite/backends/x86/jit/kernels.h"
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/packed_weight.h"
 #include "lite/backends/x86/parallel.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_lite.h"
@@ -36,9 +38,16 @@ class FcCompute : public KernelLite<TARGET(kX86), PType> {
  public:
   using param_t = operators::FcParam;
 
+  virtual void PrepareForRun();
+
   virtual void Run();
 
   virtual ~FcCompute() = default;
+
+ private:
+  // the weights packed for the gemm, and the packed input
+  std::shared_ptr<const lite::x86::math::PackedWeight> packed_w_;
+  Tensor gemm_workspace_;
 };
 
 }  // namespace x86
@@ -0,0 +1,98 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fused_multihead_attention_compute.h"
+#include <vector>
+#include "lite/backends/x86/math/multihead_attention.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace {
+
+std::vector<int64_t> SeqOffsets(const lite::Tensor& x) {
+  const auto& dims = x.dims();
+  std::vector<int64_t> offsets;
+  if (dims.size() == 3) {
+    for (int64_t i = 0; i <= dims[0]; ++i) offsets.push_back(i * dims[1]);
+  } else {
+    for (auto offset : x.lod().back()) {
+      offsets.push_back(static_cast<int64_t>(offset));
+    }
+  }
+  return offsets;
+}
+
+}  // namespace
+
+void FusedMultiheadAttentionCompute::Run() {
+  auto& param = this->Param<param_t>();
+  const auto& q_dims = param.q->dims();
+  const int hidden = static_cast<int>(q_dims[q_dims.size() - 1]);
+  const int head_num = param.head_num;
+  const int head_size = hidden / head_num;
+  auto q_offsets = SeqOffsets(*param.q);
+  auto kv_offsets = SeqOffsets(*param.k);
+
+  const float* bias_qk = nullptr;
+  int64_t bias_strides[3] = {0, 0, 0};
+  if (param.bias_qk) {
+    // [batch or 1, head_num or 1, seq_q or 1, seq_k]
+    const auto& bias_dims = param.bias_qk->dims();
+    const int64_t seq_num = static_cast<int64_t>(q_offsets.size()) - 1;
+    const int64_t seq_q = q_dims[1];
+    const int64_t seq_k = param.k->dims()[1];
+    CHECK(bias_dims[0] == 1 || bias_dims[0] == seq_num) << bias_dims;
+    CHECK(bias_dims[1] == 1 || bias_dims[1] == head_num) << bias_dims;
+    CHECK(bias_dims[2] == 1 || bias_dims[2] == seq_q) << bias_dims;
+    CHECK_EQ(bias_dims[3], seq_k) << bias_dims;
+    bias_strides[2] = bias_dims[2] == 1 ? 0 : seq_k;
+    bias_strides[1] = bias_dims[1] == 1 ? 0 : bias_dims[2] * seq_k;
+    bias_strides[0] =
+        bias_dims[0] == 1 ? 0 : bias_dims[1] * bias_dims[2] * seq_k;
+    bias_qk = param.bias_qk->data<float>();
+  }
+
+  lite::x86::math::multihead_attention(param.q->data<float>(),
+                                       param.k->data<float>(),
+                                       param.v->data<float>(),
+                                       bias_qk,
+                                       bias_strides,
+                                       param.out->mutable_data<float>(),
+                                       q_offsets,
+                                       kv_offsets,
+                                       head_num,
+                                       head_size,
+                                       param.alpha);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(fused_multihead_attention,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::FusedMultiheadAttentionCompute,
+                     def)
+    .BindInput("Q", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("K", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("V", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("BiasQK", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
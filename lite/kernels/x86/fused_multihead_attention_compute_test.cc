@@ -0,0 +1,199 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/fused_multihead_attention_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// softmax(alpha * q * k^T + bias) * v of one head, the bias is a full
+// [seq_q, seq_k] matrix or null.
+void attention_ref(const float* q,
+                   const float* k,
+                   const float* v,
+                   const float* bias,
+                   float* out,
+                   int seq_q,
+                   int seq_k,
+                   int ld,
+                   int head_size,
+                   float alpha) {
+  std::vector<float> scores(seq_k);
+  for (int i = 0; i < seq_q; i++) {
+    float max = -1e30f;
+    for (int j = 0; j < seq_k; j++) {
+      float sum = 0.f;
+      for (int d = 0; d < head_size; d++) sum += q[i * ld + d] * k[j * ld + d];
+      scores[j] = alpha * sum + (bias ? bias[i * seq_k + j] : 0.f);
+      max = std::max(max, scores[j]);
+    }
+    float total = 0.f;
+    for (int j = 0; j < seq_k; j++) {
+      scores[j] = std::exp(scores[j] - max);
+      total += scores[j];
+    }
+    for (int d = 0; d < head_size; d++) {
+      float sum = 0.f;
+      for (int j = 0; j < seq_k; j++) sum += scores[j] * v[j * ld + d];
+      out[i * ld + d] = sum / total;
+    }
+  }
+}
+
+void fill(lite::Tensor* x, int seed) {
+  auto* data = x->mutable_data<float>();
+  for (int64_t i = 0; i < x->numel(); i++) {
+    data[i] = static_cast<float>((i * 7 + seed) % 23) / 23.f - 0.5f;
+  }
+}
+
+void run_attention(FusedMultiheadAttentionCompute* kernel,
+                   operators::FusedMultiheadAttentionParam* param) {
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  kernel->SetContext(std::move(ctx));
+  kernel->SetParam(*param);
+  kernel->Run();
+}
+
+TEST(fused_multihead_attention_x86, retrive_op) {
+  auto kernel = KernelRegistry::Global().Create("fused_multihead_attention");
+  ASSERT_FALSE(kernel.empty());
+  ASSERT_TRUE(kernel.front());
+}
+
+TEST(fused_multihead_attention_x86, run_padded_test) {
+  // the keys span two blocks, the queries two blocks
+  const int batch = 2, seq_q = 40, seq_k = 150, head_num = 3, head_size = 20;
+  const int hidden = head_num * head_size;
+  const float alpha = 0.125f;
+  lite::Tensor q, k, v, bias, out;
+  q.Resize({batch, seq_q, hidden});
+  k.Resize({batch, seq_k, hidden});
+  v.Resize({batch, seq_k, hidden});
+  out.Resize({batch, seq_q, hidden});
+  fill(&q, 1);
+  fill(&k, 2);
+  fill(&v, 3);
+  // padding mask of [batch, 1, 1, seq_k]
+  bias.Resize({batch, 1, 1, seq_k});
+  auto* bias_data = bias.mutable_data<float>();
+  for (int b = 0; b < batch; b++) {
+    for (int j = 0; j < seq_k; j++) {
+      bias_data[b * seq_k + j] = j < seq_k - 17 * b ? 0.f : -10000.f;
+    }
+  }
+
+  FusedMultiheadAttentionCompute kernel;
+  operators::FusedMultiheadAttentionParam param;
+  param.q = &q;
+  param.k = &k;
+  param.v = &v;
+  param.bias_qk = &bias;
+  param.out = &out;
+  param.head_num = head_num;
+  param.alpha = alpha;
+  run_attention(&kernel, &param);
+
+  std::vector<float> full_bias(seq_q * seq_k);
+  std::vector<float> ref(out.numel());
+  for (int b = 0; b < batch; b++) {
+    for (int i = 0; i < seq_q; i++) {
+      for (int j = 0; j < seq_k; j++) {
+        full_bias[i * seq_k + j] = bias_data[b * seq_k + j];
+      }
+    }
+    for (int h = 0; h < head_num; h++) {
+      int64_t q_offset = b * seq_q * hidden + h * head_size;
+      int64_t kv_offset = b * seq_k * hidden + h * head_size;
+      attention_ref(q.data<float>() + q_offset,
+                    k.data<float>() + kv_offset,
+                    v.data<float>() + kv_offset,
+                    full_bias.data(),
+                    ref.data() + q_offset,
+                    seq_q,
+                    seq_k,
+                    hidden,
+                    head_size,
+                    alpha);
+    }
+  }
+  auto* out_data = out.data<float>();
+  for (int64_t i = 0; i < out.numel(); i++) {
+    EXPECT_NEAR(out_data[i], ref[i], 1e-5);
+  }
+}
+
+TEST(fused_multihead_attention_x86, run_lod_test) {
+  const int head_num = 2, head_size = 16;
+  const int hidden = head_num * head_size;
+  const std::vector<uint64_t> offsets = {0, 5, 5, 37, 170};
+  const int total = static_cast<int>(offsets.back());
+  lite::Tensor q, k, v, out;
+  for (auto* x : {&q, &k, &v}) {
+    x->Resize({total, hidden});
+    x->set_lod({offsets});
+  }
+  out.Resize({total, hidden});
+  fill(&q, 4);
+  fill(&k, 5);
+  fill(&v, 6);
+
+  FusedMultiheadAttentionCompute kernel;
+  operators::FusedMultiheadAttentionParam param;
+  param.q = &q;
+  param.k = &k;
+  param.v = &v;
+  param.out = &out;
+  param.head_num = head_num;
+  run_attention(&kernel, &param);
+
+  std::vector<float> ref(out.numel());
+  for (size_t s = 0; s + 1 < offsets.size(); s++) {
+    int len = static_cast<int>(offsets[s + 1] - offsets[s]);
+    for (int h = 0; h < head_num; h++) {
+      int64_t offset = offsets[s] * hidden + h * head_size;
+      attention_ref(q.data<float>() + offset,
+                    k.data<float>() + offset,
+                    v.data<float>() + offset,
+                    nullptr,
+                    ref.data() + offset,
+                    len,
+                    len,
+                    hidden,
+                    head_size,
+                    1.f);
+    }
+  }
+  auto* out_data = out.data<float>();
+  for (int64_t i = 0; i < out.numel(); i++) {
+    EXPECT_NEAR(out_data[i], ref[i], 1e-5);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fused_multihead_attention, kX86, kFloat, kNCHW, def);
@@ -0,0 +1,99 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/layout_compute.h"
+#include "lite/backends/x86/math/avx/nchwc8.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void NCHWToNCHWc8Compute::Run() {
+  auto& param = this->Param<param_t>();
+  auto dims = param.x->dims();
+  CHECK_GE(dims.size(), 2u) << "NCHW to NCHWc8 needs the dims [N, C, ...]";
+  param.y->Resize(dims);
+  lite::x86::math::nchw_to_nchwc8(param.x->data<float>(),
+                                  lite::x86::math::nchwc8_mutable_data(param.y),
+                                  dims[0],
+                                  dims[1],
+                                  dims.count(2, dims.size()));
+}
+
+void NCHWc8ToNCHWCompute::Run() {
+  auto& param = this->Param<param_t>();
+  auto dims = param.x->dims();
+  CHECK_GE(dims.size(), 2u) << "NCHWc8 to NCHW needs the dims [N, C, ...]";
+  param.y->Resize(dims);
+  lite::x86::math::nchwc8_to_nchw(param.x->data<float>(),
+                                  param.y->mutable_data<float>(),
+                                  dims[0],
+                                  dims[1],
+                                  dims.count(2, dims.size()));
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+typedef paddle::lite::kernels::x86::NCHWToNCHWc8Compute NCHW_NCHWc8_fp32;
+typedef paddle::lite::kernels::x86::NCHWc8ToNCHWCompute NCHWc8_NCHW_fp32;
+
+REGISTER_LITE_KERNEL(layout, kX86, kFloat, kNCHW, NCHW_NCHWc8_fp32, nchw2nchwc8)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(layout, kX86, kFloat, kNCHW, NCHWc8_NCHW_fp32, nchwc82nchw)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    layout_once, kX86, kFloat, kNCHW, NCHW_NCHWc8_fp32, nchw2nchwc8)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    layout_once, kX86, kFloat, kNCHW, NCHWc8_NCHW_fp32, nchwc82nchw)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .Finalize();
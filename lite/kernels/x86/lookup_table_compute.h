@@ -23,6 +23,32 @@ namespace lite {
 namespace kernels {
 namespace x86 {
 
+// The rows of the int8 or int16 table quantized by post_quant_dynamic_pass,
+// scaled by the scales of its columns.
+template <typename Q>
+void LookupQuantizedTable(const Q *table,
+                          const float *scale,
+                          const int64_t *ids,
+                          int64_t ids_numel,
+                          int64_t row_number,
+                          int64_t row_width,
+                          int64_t padding_idx,
+                          float *output) {
+  for (int64_t i = 0; i < ids_numel; ++i) {
+    float *out = output + i * row_width;
+    if (padding_idx != -1 && ids[i] == padding_idx) {
+      memset(out, 0, row_width * sizeof(float));
+    } else {
+      CHECK_LT(ids[i], row_number);
+      CHECK_GE(ids[i], 0);
+      const Q *row = table + ids[i] * row_width;
+      for (int64_t j = 0; j < row_width; ++j) {
+        out[j] = row[j] * scale[j];
+      }
+    }
+  }
+}
+
 template <typename T>
 class LookupTableCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
@@ -40,6 +66,36 @@ class LookupTableCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     int64_t row_number = table_t->dims()[0];
     int64_t row_width = table_t->dims()[1];
 
+    if (table_t->precision() == PRECISION(kInt8) ||
+        table_t->precision() == PRECISION(kInt16)) {
+      std::vector<float> scale = param.weight_scale;
+      CHECK(scale.size() == 1 || scale.size() == static_cast<size_t>(row_width))
+          << "lookup_table needs 1 or " << row_width
+          << " weight scales, but got " << scale.size();
+      scale.resize(row_width, scale[0]);
+      float *output = output_t->template mutable_data<float>();
+      if (table_t->precision() == PRECISION(kInt8)) {
+        LookupQuantizedTable(table_t->template data<int8_t>(),
+                             scale.data(),
+                             ids,
+                             ids_numel,
+                             row_number,
+                             row_width,
+                             padding_idx,
+                             output);
+      } else {
+        LookupQuantizedTable(table_t->template data<int16_t>(),
+                             scale.data(),
+                             ids,
+                             ids_numel,
+                             row_number,
+                             row_width,
+                             padding_idx,
+                             output);
+      }
+      return;
+    }
+
     const T *table = table_t->template data<T>();
     T *output = output_t->template mutable_data<T>();
     memset(output, 0, output_t->dims().production() * sizeof(T));
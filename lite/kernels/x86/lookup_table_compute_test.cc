@@ -74,6 +74,45 @@ TEST(lookup_table_x86, compute) {
   }
 }
 
+TEST(lookup_table_x86, compute_quantized) {
+  LookupTableCompute<float> lookup_table;
+  operators::LookupTableParam param;
+  lite::Tensor w, ids, out;
+  int vocab_size = 40;
+  int emb_size = 50;
+  int ids_num = 60;
+  int64_t padding_idx = 3;
+
+  w.Resize({vocab_size, emb_size});
+  ids.Resize({ids_num, 1});
+  out.Resize({ids_num, 1, emb_size});
+  auto* w_data = w.mutable_data<int8_t>();
+  auto* ids_data = ids.mutable_data<int64_t>();
+  std::vector<float> scale(emb_size);
+  for (int j = 0; j < emb_size; j++) scale[j] = 0.1f * (j + 1) / 127;
+  for (int i = 0; i < vocab_size * emb_size; i++) {
+    w_data[i] = static_cast<int8_t>(i % 255 - 127);
+  }
+  for (int i = 0; i < ids_num; i++) ids_data[i] = (i * 7) % vocab_size;
+
+  param.W = &w;
+  param.Ids = &ids;
+  param.Out = &out;
+  param.padding_idx = padding_idx;
+  param.weight_scale = scale;
+  lookup_table.SetParam(param);
+  lookup_table.Run();
+  auto* out_data = out.data<float>();
+  for (int i = 0; i < ids_num; i++) {
+    for (int j = 0; j < emb_size; j++) {
+      float ref = ids_data[i] == padding_idx
+                      ? 0.f
+                      : w_data[ids_data[i] * emb_size + j] * scale[j];
+      EXPECT_NEAR(out_data[i * emb_size + j], ref, 1e-6);
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
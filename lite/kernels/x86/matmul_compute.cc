@@ -13,6 +13,127 @@
 // limitations under the License.
 
 #include "lite/kernels/x86/matmul_compute.h"
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "lite/backends/x86/math/gemm_s8u8_compute.h"
+#include "lite/backends/x86/math/saturate.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+inline void store_matmul_out(float v, float* out) { *out = v; }
+
+inline void store_matmul_out(float v, int8_t* out) {
+  int8_t res = lite::x86::math::saturate_cast<int8_t>(roundf(v));
+  *out = res < -127 ? -127 : res;
+}
+
+template <PrecisionType OutType>
+void MatMulInt8Compute<OutType>::Run() {
+  namespace math = lite::x86::math;
+  using T = typename std::
+      conditional<OutType == PRECISION(kInt8), int8_t, float>::type;
+  auto &param = *param_.get_mutable<operators::MatMulParam>();
+  auto dim_a = math::CreateMatrixDescriptor(
+      RowMatrixFromVector(param.X->dims()), 0, param.transpose_X);
+  auto dim_b = math::CreateMatrixDescriptor(
+      ColumnMatrixFromVector(param.Y->dims()), 0, param.transpose_Y);
+  CHECK_EQ(dim_a.width_, dim_b.height_);
+  CHECK(dim_a.batch_size_ == dim_b.batch_size_ || dim_a.batch_size_ == 0 ||
+        dim_b.batch_size_ == 0);
+  int m = dim_a.height_;
+  int n = dim_b.width_;
+  int k = dim_a.width_;
+  int64_t batch_size =
+      (std::max)((std::max)(dim_a.batch_size_, dim_b.batch_size_), int64_t(1));
+  // the batches of x share y, they are the rows of a single gemm
+  if (dim_b.batch_size_ == 0 && dim_a.batch_size_ > 0 && !dim_a.trans_) {
+    m *= batch_size;
+    batch_size = 1;
+    dim_a.batch_size_ = 0;
+  }
+  const auto &y_scale = param.weight_scale;
+  CHECK(y_scale.size() == 1 || y_scale.size() == static_cast<size_t>(n))
+      << "The scales of y should have 1 or " << n << " elements, but got "
+      << y_scale.size();
+  const bool col_scale = y_scale.size() > 1;
+  const float out_scale =
+      OutType == PRECISION(kInt8) ? param.output_scale : 1.f;
+  std::vector<float> x_scale(m, param.input_scale * param.alpha);
+  const int8_t *a = param.X->template data<int8_t>();
+  const int8_t *b = param.Y->template data<int8_t>();
+  T *c = param.Out->template mutable_data<T>();
+
+  if (!col_scale) {
+    std::unique_ptr<math::generate_gemm_s8u8_x86_kern<T>> gemm;
+    for (int64_t i = 0; i < batch_size; ++i) {
+      const int8_t *a_i = a + (dim_a.batch_size_ > 0 ? i * dim_a.stride_ : 0);
+      // x is packed by the gemm, once if it is shared by the batches
+      if (!gemm || dim_a.batch_size_ > 0) {
+        gemm.reset(new math::generate_gemm_s8u8_x86_kern<T>(dim_a.trans_,
+                                                             dim_b.trans_,
+                                                             m,
+                                                             n,
+                                                             k,
+                                                             a_i,
+                                                             n,
+                                                             x_scale.data(),
+                                                             y_scale[0],
+                                                             out_scale,
+                                                             nullptr,
+                                                             0,
+                                                             1.f));
+      }
+      gemm->compute(a_i, b + i * dim_b.stride_, c + i * m * n);
+    }
+    return;
+  }
+
+  // the gemm runs with the unit scale of y, the scales of the columns are
+  // applied to its float output
+  workspace_.Resize({static_cast<int64_t>(m) * n});
+  float *tmp = workspace_.mutable_data<float>();
+  std::unique_ptr<math::generate_gemm_s8u8_x86_kern<float>> gemm;
+  for (int64_t i = 0; i < batch_size; ++i) {
+    const int8_t *a_i = a + (dim_a.batch_size_ > 0 ? i * dim_a.stride_ : 0);
+    if (!gemm || dim_a.batch_size_ > 0) {
+      gemm.reset(new math::generate_gemm_s8u8_x86_kern<float>(dim_a.trans_,
+                                                               dim_b.trans_,
+                                                               m,
+                                                               n,
+                                                               k,
+                                                               a_i,
+                                                               n,
+                                                               x_scale.data(),
+                                                               1.f,
+                                                               1.f,
+                                                               nullptr,
+                                                               0,
+                                                               1.f));
+    }
+    gemm->compute(a_i, b + i * dim_b.stride_, tmp);
+    T *c_i = c + i * m * n;
+    for (int mm = 0; mm < m; ++mm) {
+      for (int nn = 0; nn < n; ++nn) {
+        store_matmul_out(tmp[mm * n + nn] * y_scale[nn] / out_scale,
+                         c_i + mm * n + nn);
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+typedef paddle::lite::kernels::x86::MatMulInt8Compute<PRECISION(kInt8)>
+    MatMulInt8_Int8;
+typedef paddle::lite::kernels::x86::MatMulInt8Compute<PRECISION(kFloat)>
+    MatMulInt8_Fp32;
 
 REGISTER_LITE_KERNEL(matmul,
                      kX86,
@@ -24,3 +145,15 @@ REGISTER_LITE_KERNEL(matmul,
     .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
     .Finalize();
+
+REGISTER_LITE_KERNEL(matmul, kX86, kInt8, kNCHW, MatMulInt8_Int8, int8_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(matmul, kX86, kInt8, kNCHW, MatMulInt8_Fp32, fp32_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
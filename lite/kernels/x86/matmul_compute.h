@@ -13,7 +13,9 @@
 // limitations under the License.
 #pragma once
 
+#include <algorithm>
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/packed_sgemm.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -44,6 +46,66 @@ static lite::DDim ColumnMatrixFromVector(const lite::DDim &y_dim) {
   return lite::DDim({y_dim[0], 1});
 }
 
+/**
+ * Runs the matmul on the packed sgemm, an input shared by the batches is
+ * packed once. Returns false for the types other than float.
+ */
+template <typename T>
+bool PackedMatMul(const lite::Tensor &x,
+                  const lite::x86::math::MatDescriptor &dim_a,
+                  const lite::Tensor &y,
+                  const lite::x86::math::MatDescriptor &dim_b,
+                  T alpha,
+                  lite::Tensor *out,
+                  lite::Tensor *workspace) {
+  return false;
+}
+
+template <>
+inline bool PackedMatMul<float>(const lite::Tensor &x,
+                                const lite::x86::math::MatDescriptor &dim_a,
+                                const lite::Tensor &y,
+                                const lite::x86::math::MatDescriptor &dim_b,
+                                float alpha,
+                                lite::Tensor *out,
+                                lite::Tensor *workspace) {
+  namespace math = lite::x86::math;
+  CHECK_EQ(dim_a.width_, dim_b.height_);
+  CHECK(dim_a.batch_size_ == dim_b.batch_size_ || dim_a.batch_size_ == 0 ||
+        dim_b.batch_size_ == 0);
+  int m = dim_a.height_;
+  int n = dim_b.width_;
+  int k = dim_a.width_;
+  if (k == 0) return false;
+  int lda = dim_a.trans_ ? m : k;
+  int ldb = dim_b.trans_ ? k : n;
+  int64_t batch_size =
+      (std::max)((std::max)(dim_a.batch_size_, dim_b.batch_size_), int64_t(1));
+  size_t a_size = math::sgemm_packed_a_size(m, k);
+  size_t b_size = math::sgemm_packed_b_size(k, n);
+  workspace->Resize({static_cast<int64_t>(a_size + b_size)});
+  float *packed_a = workspace->mutable_data<float>();
+  float *packed_b = packed_a + a_size;
+  const float *a = x.data<float>();
+  const float *b = y.data<float>();
+  float *c = out->mutable_data<float>();
+  math::SgemmEpilogue epilogue;
+  epilogue.alpha = alpha;
+  for (int64_t i = 0; i < batch_size; ++i) {
+    if (i == 0 || dim_a.batch_size_ > 0) {
+      math::sgemm_pack_a(
+          dim_a.trans_, m, k, a + i * dim_a.stride_, lda, packed_a);
+    }
+    if (i == 0 || dim_b.batch_size_ > 0) {
+      math::sgemm_pack_b(
+          dim_b.trans_, k, n, b + i * dim_b.stride_, ldb, packed_b);
+    }
+    math::sgemm_prepacked(
+        m, n, k, packed_a, packed_b, c + i * m * n, n, epilogue);
+  }
+  return true;
+}
+
 template <typename T>
 class MatMulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
@@ -64,10 +126,38 @@ class MatMulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto mat_dim_b = lite::x86::math::CreateMatrixDescriptor(
         ColumnMatrixFromVector(y->dims()), 0, param.transpose_Y);
     auto scale = static_cast<T>(param.alpha);
+#ifndef PADDLE_WITH_MKLML
+    if (PackedMatMul<T>(
+            *x, mat_dim_a, *y, mat_dim_b, scale, out, &workspace_)) {
+      return;
+    }
+#endif
     blas.MatMul(*x, mat_dim_a, *y, mat_dim_b, scale, out, T(0));
   }
 
   virtual ~MatMulCompute() = default;
+
+ private:
+  // the packed inputs, kept across runs
+  lite::Tensor workspace_;
+};
+
+// matmul of the int8 x and y on the s8u8 gemm, x has the scale
+// param.input_scale and y param.weight_scale, of one element or of one for
+// each column of y. The int8 output of OutType is quantized with
+// param.output_scale
+template <PrecisionType OutType>
+class MatMulInt8Compute : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::MatMulParam;
+
+  void Run() override;
+
+  virtual ~MatMulInt8Compute() = default;
+
+ private:
+  // the float output of the gemm for the scales of the columns of y
+  lite::Tensor workspace_;
 };
 
 }  // namespace x86
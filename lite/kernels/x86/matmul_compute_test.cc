@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <utility>
@@ -80,9 +81,109 @@ TEST(matmul_x86, run_test) {
   }
 }
 
+// compares the int8 matmul with the float one on the dequantized inputs, y
+// has a scale for each column for col_scale. The inputs are in [-63, 63], the
+// u8 * s8 pairs of the gemm saturate int16 for the larger values
+static void test_matmul_int8(const std::vector<int64_t>& x_shape,
+                             const std::vector<int64_t>& y_shape,
+                             bool trans_x,
+                             bool trans_y,
+                             float alpha,
+                             bool col_scale) {
+  const float x_scale = 0.02f;
+  const float out_scale = 0.05f;
+  const int64_t n = trans_y ? y_shape[y_shape.size() - 2] : y_shape.back();
+  const int64_t k = trans_y ? y_shape.back() : y_shape[y_shape.size() - 2];
+  std::vector<float> y_scale(col_scale ? n : 1);
+  for (size_t i = 0; i < y_scale.size(); i++) {
+    y_scale[i] = 0.01f + 0.001f * (i % 7);
+  }
+  lite::Tensor x, y, x_fp32, y_fp32;
+  x.Resize(lite::DDim(x_shape));
+  x_fp32.Resize(lite::DDim(x_shape));
+  y.Resize(lite::DDim(y_shape));
+  y_fp32.Resize(lite::DDim(y_shape));
+  auto* x_data = x.mutable_data<int8_t>();
+  auto* x_fp32_data = x_fp32.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = static_cast<int8_t>((i * 37 + 11) % 127 - 63);
+    x_fp32_data[i] = x_data[i] * x_scale;
+  }
+  auto* y_data = y.mutable_data<int8_t>();
+  auto* y_fp32_data = y_fp32.mutable_data<float>();
+  for (int64_t i = 0; i < y.numel(); i++) {
+    int64_t col = trans_y ? (i / k) % n : i % n;
+    y_data[i] = static_cast<int8_t>((i * 53 + 7) % 127 - 63);
+    y_fp32_data[i] = y_data[i] * y_scale[col_scale ? col : 0];
+  }
+
+  const int64_t m = trans_x ? x_shape.back() : x_shape[x_shape.size() - 2];
+  std::vector<int64_t> out_shape(
+      x_shape.size() > y_shape.size() ? x_shape : y_shape);
+  out_shape[out_shape.size() - 2] = m;
+  out_shape.back() = n;
+  lite::Tensor out_int8, out_fp32, ref;
+  for (auto* tensor : {&out_int8, &out_fp32, &ref}) {
+    tensor->Resize(lite::DDim(out_shape));
+  }
+
+  operators::MatMulParam param;
+  param.transpose_X = trans_x;
+  param.transpose_Y = trans_y;
+  param.alpha = alpha;
+  param.enable_int8 = true;
+  param.input_scale = x_scale;
+  param.weight_scale = y_scale;
+  param.output_scale = out_scale;
+  auto run = [&](KernelBase* kernel,
+                 lite::Tensor* in_x,
+                 lite::Tensor* in_y,
+                 lite::Tensor* out) {
+    param.X = in_x;
+    param.Y = in_y;
+    param.Out = out;
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    kernel->SetContext(std::move(ctx));
+    kernel->SetParam(param);
+    kernel->Launch();
+  };
+  MatMulCompute<float> matmul;
+  MatMulInt8Compute<PRECISION(kInt8)> matmul_int8;
+  MatMulInt8Compute<PRECISION(kFloat)> matmul_fp32;
+  run(&matmul, &x_fp32, &y_fp32, &ref);
+  run(&matmul_int8, &x, &y, &out_int8);
+  run(&matmul_fp32, &x, &y, &out_fp32);
+
+  const float* ref_data = ref.data<float>();
+  const int8_t* out_int8_data = out_int8.data<int8_t>();
+  const float* out_fp32_data = out_fp32.data<float>();
+  for (int64_t i = 0; i < ref.numel(); i++) {
+    float expect = (std::min)((std::max)(ref_data[i], -127 * out_scale),
+                              127 * out_scale);
+    ASSERT_NEAR(out_fp32_data[i], ref_data[i], 1e-3)
+        << "m" << m << "n" << n << "k" << k << " at " << i;
+    ASSERT_NEAR(out_int8_data[i] * out_scale, expect, out_scale * 0.51f)
+        << "m" << m << "n" << n << "k" << k << " at " << i;
+  }
+}
+
+TEST(matmul_x86, int8) {
+  for (bool col_scale : {false, true}) {
+    test_matmul_int8({5, 19}, {19, 37}, false, false, 1.f, col_scale);
+    test_matmul_int8({3, 4, 33}, {33, 9}, false, false, 0.5f, col_scale);
+    test_matmul_int8({3, 33, 4}, {33, 9}, true, false, 1.f, col_scale);
+    test_matmul_int8(
+        {2, 3, 7, 16}, {2, 3, 18, 16}, false, true, 1.f, col_scale);
+    test_matmul_int8({7, 16}, {2, 16, 18}, false, false, 1.f, col_scale);
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
 }  // namespace paddle
 
 USE_LITE_KERNEL(matmul, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(matmul, kX86, kInt8, kNCHW, int8_out);
+USE_LITE_KERNEL(matmul, kX86, kInt8, kNCHW, fp32_out);
@@ -13,7 +13,10 @@
 // limitations under the License.
 #pragma once
 
+#include <memory>
+#include <vector>
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/packed_weight.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -39,6 +42,19 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::MulParam;
 
+  void PrepareForRun() override {
+    auto& param = *param_.get_mutable<operators::MulParam>();
+    auto* y = param.y;
+    if (y->precision() != PRECISION(kInt8) &&
+        y->precision() != PRECISION(kInt16)) {
+      return;
+    }
+    // the weight is released once packed
+    auto y_dims = y->dims().Flatten2D(param.y_num_col_dims);
+    packed_y_ = lite::x86::math::PackedWeight::GetQuantized(
+        y_dims[0], y_dims[1], const_cast<Tensor*>(y), param.weight_scale);
+  }
+
   void Run() override {
     auto& context = ctx_->As<X86Context>();
     auto& param = *param_.get_mutable<operators::MulParam>();
@@ -49,6 +65,20 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto* x = param.x;
     auto* y = param.y;
 
+    if (packed_y_) {
+      auto x_dims = x->dims().Flatten2D(param.x_num_col_dims);
+      CHECK_EQ(x_dims[1], packed_y_->rows());
+      packed_y_->Compute(context,
+                         x_dims[0],
+                         x->template data<float>(),
+                         x_dims[1],
+                         z->template mutable_data<float>(),
+                         packed_y_->cols(),
+                         lite::x86::math::SgemmEpilogue(),
+                         &gemm_workspace_);
+      return;
+    }
+
     Tensor x_matrix, y_matrix;
 
     if (x->dims().size() > 2) {
@@ -79,6 +109,11 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
   }
 
   virtual ~MulCompute() = default;
+
+ private:
+  // the int8 or int16 y packed for the gemm, and the packed x
+  std::shared_ptr<const lite::x86::math::PackedWeight> packed_y_;
+  Tensor gemm_workspace_;
 };
 
 }  // namespace x86
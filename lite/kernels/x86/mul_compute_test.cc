@@ -80,6 +80,89 @@ TEST(mul_x86, run_test) {
   }
 }
 
+// y quantized per column as post_quant_dynamic_pass, against the float y
+template <typename T>
+void test_mul_quantized(int m, int k, int n) {
+  lite::Tensor x, y, y_ref, out, out_ref;
+  x.Resize({m, k});
+  y.Resize({k, n});
+  y_ref.Resize({k, n});
+  auto* x_data = x.mutable_data<float>();
+  auto* y_data = y.mutable_data<T>();
+  auto* y_ref_data = y_ref.mutable_data<float>();
+  for (int i = 0; i < m * k; i++) {
+    x_data[i] = static_cast<float>(i % 13) / 13.f - 0.5f;
+  }
+  std::vector<float> scale(n);
+  const int range = sizeof(T) == 1 ? 127 : 32767;
+  for (int j = 0; j < n; j++) scale[j] = 0.01f * (j % 7 + 1) / range;
+  for (int i = 0; i < k; i++) {
+    for (int j = 0; j < n; j++) {
+      T q = static_cast<T>((i * 31 + j * 17) % (2 * range + 1) - range);
+      y_data[i * n + j] = q;
+      y_ref_data[i * n + j] = q * scale[j];
+    }
+  }
+
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  MulCompute<float> mul;
+  operators::MulParam param;
+  param.x = &x;
+  param.y = &y;
+  param.output = &out;
+  param.weight_scale = scale;
+  out.Resize({m, n});
+  mul.SetContext(std::move(ctx));
+  mul.SetParam(param);
+  mul.PrepareForRun();
+  mul.Run();
+  // the packed copy replaces y
+  EXPECT_FALSE(y.IsInitialized());
+
+  // the kernel of a cloned predictor gets the packed y
+  lite::Tensor out_clone;
+  out_clone.Resize({m, n});
+  std::unique_ptr<KernelContext> ctx_clone(new KernelContext);
+  ctx_clone->As<X86Context>();
+  MulCompute<float> mul_clone;
+  param.output = &out_clone;
+  mul_clone.SetContext(std::move(ctx_clone));
+  mul_clone.SetParam(param);
+  mul_clone.PrepareForRun();
+  mul_clone.Run();
+
+  std::unique_ptr<KernelContext> ctx_ref(new KernelContext);
+  ctx_ref->As<X86Context>();
+  MulCompute<float> mul_ref;
+  param.y = &y_ref;
+  param.output = &out_ref;
+  out_ref.Resize({m, n});
+  mul_ref.SetContext(std::move(ctx_ref));
+  mul_ref.SetParam(param);
+  mul_ref.PrepareForRun();
+  mul_ref.Run();
+
+  auto* out_data = out.data<float>();
+  auto* out_ref_data = out_ref.data<float>();
+  auto* out_clone_data = out_clone.data<float>();
+  for (int i = 0; i < m * n; i++) {
+    EXPECT_NEAR(out_data[i], out_ref_data[i], 1e-4);
+    EXPECT_EQ(out_clone_data[i], out_data[i]);
+  }
+}
+
+TEST(mul_x86, quantized_y) {
+  for (int m : {1, 7, 64}) {
+    for (int k : {3, 300}) {
+      for (int n : {5, 40}) {
+        test_mul_quantized<int8_t>(m, k, n);
+        test_mul_quantized<int16_t>(m, k, n);
+      }
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -0,0 +1,429 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/nchwc8_compute.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include "lite/backends/x86/math/avx/nchwc8.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace math = paddle::lite::x86::math;
+
+void ConvNCHWc8Compute::PrepareForRun() {
+  auto& param = this->Param<param_t>();
+  CHECK(param.second_x == nullptr)
+      << "NCHWc8 conv doesn't support the fused elementwise input";
+  auto w_dims = param.filter->dims();
+  const int chout = w_dims[0];
+  const int chin_group = w_dims[1];
+  const int kh = w_dims[2];
+  const int kw = w_dims[3];
+  const int groups = param.groups;
+  const float* weights = param.filter->data<float>();
+  depthwise_ = groups > 1 && chin_group == 1 && chout == groups;
+  if (depthwise_) {
+    weights_.Resize({math::nchwc8_blocks(chout) * kh * kw * 8});
+    math::conv_depthwise_nchwc8_trans_weights(
+        weights, weights_.mutable_data<float>(), chout, kh, kw);
+  } else {
+    CHECK(groups == 1 || (chin_group % 8 == 0 && chout / groups % 8 == 0))
+        << "NCHWc8 conv needs the channels of a group in multiples of 8, "
+           "groups: "
+        << groups << ", chin of a group: " << chin_group
+        << ", chout: " << chout;
+    weights_.Resize(
+        {math::conv_nchwc8_weights_size(chout, chin_group, kh, kw, groups)});
+    math::conv_nchwc8_trans_weights(weights,
+                                    weights_.mutable_data<float>(),
+                                    chout,
+                                    chin_group,
+                                    kh,
+                                    kw,
+                                    groups);
+  }
+  // the bias of the padded output channels is zero
+  bias_.Resize({math::nchwc8_blocks(chout) * 8});
+  float* bias = bias_.mutable_data<float>();
+  std::fill(bias, bias + bias_.numel(), 0.f);
+  if (param.bias) {
+    const float* bias_data = param.bias->data<float>();
+    std::copy(bias_data, bias_data + chout, bias);
+  }
+}
+
+void ConvNCHWc8Compute::Run() {
+  auto& param = this->Param<param_t>();
+  const float* din = param.x->data<float>();
+  float* dout = math::nchwc8_mutable_data(param.output);
+  if (depthwise_) {
+    math::conv_depthwise_nchwc8(
+        din, dout, weights_.data<float>(), bias_.data<float>(), param);
+  } else {
+    math::conv_nchwc8(
+        din, dout, weights_.data<float>(), bias_.data<float>(), param);
+  }
+}
+
+void PoolNCHWc8Compute::Run() {
+  auto& param = this->Param<param_t>();
+  auto in_dims = param.x->dims();
+  auto out_dims = param.output->dims();
+  if (param.global_pooling) {
+    for (size_t i = 0; i < param.ksize.size(); ++i) {
+      param.ksize[i] = static_cast<int>(in_dims[i + 2]);
+    }
+  }
+  CHECK_EQ(param.ksize.size(), 2u) << "NCHWc8 supports pool2d only";
+  CHECK(param.pooling_type == "max" || param.pooling_type == "avg")
+      << "NCHWc8 pooling type not supported: " << param.pooling_type;
+  math::pooling_nchwc8(param.x->data<float>(),
+                       math::nchwc8_mutable_data(param.output),
+                       in_dims[0],
+                       in_dims[1],
+                       in_dims[2],
+                       in_dims[3],
+                       out_dims[2],
+                       out_dims[3],
+                       param.ksize,
+                       param.strides,
+                       *param.paddings,
+                       param.pooling_type == "max",
+                       param.exclusive,
+                       param.adaptive);
+}
+
+void BatchNormNCHWc8Compute::Run() {
+  auto& param = this->Param<param_t>();
+  // inference only, as the NCHW kernel with the global mean and variance
+  auto in_dims = param.x->dims();
+  const int channel = in_dims[1];
+  const float* scale = param.scale->data<float>();
+  const float* bias = param.bias->data<float>();
+  const float* mean = param.mean->data<float>();
+  const float* variance = param.variance->data<float>();
+  scale_.assign(math::nchwc8_blocks(channel) * 8, 0.f);
+  bias_.assign(scale_.size(), 0.f);
+  for (int c = 0; c < channel; ++c) {
+    scale_[c] = scale[c] / std::sqrt(variance[c] + param.epsilon);
+    bias_[c] = bias[c] - mean[c] * scale_[c];
+  }
+  math::channel_affine_nchwc8(param.x->data<float>(),
+                              math::nchwc8_mutable_data(param.y),
+                              scale_.data(),
+                              bias_.data(),
+                              in_dims[0],
+                              channel,
+                              in_dims.count(2, in_dims.size()));
+}
+
+void ScaleNCHWc8Compute::Run() {
+  auto& param = this->Param<param_t>();
+  float bias = param.bias_after_scale ? param.bias : param.bias * param.scale;
+  math::scale_nchwc8(param.x->data<float>(),
+                     math::nchwc8_mutable_data(param.output),
+                     math::nchwc8_size(param.x->dims()),
+                     param.scale,
+                     bias);
+}
+
+// add, sub or mul of elementwise_* and fusion_elementwise_*_activation
+static std::string elementwise_type(const std::string& op_type) {
+  for (const char* type : {"add", "sub", "mul"}) {
+    if (op_type.find(std::string("_") + type) != std::string::npos) {
+      return type;
+    }
+  }
+  LOG(FATAL) << "NCHWc8 elementwise op not supported: " << op_type;
+  return "";
+}
+
+template <typename ParamT>
+void ElementwiseNCHWc8Compute<ParamT>::PrepareForRun() {
+  type_ = elementwise_type(this->op_type());
+}
+
+template <>
+void ElementwiseNCHWc8Compute<
+    operators::FusionElementwiseActivationParam>::PrepareForRun() {
+  auto& param = this->Param<param_t>();
+  CHECK_EQ(param.act_type, "relu")
+      << "NCHWc8 elementwise activation not supported: " << param.act_type;
+  type_ = elementwise_type(this->op_type());
+  fuse_relu_ = true;
+}
+
+template <typename ParamT>
+void ElementwiseNCHWc8Compute<ParamT>::Run() {
+  auto& param = this->template Param<param_t>();
+  auto out_dims = param.Out->dims();
+  const int num = out_dims[0];
+  const int channel = out_dims[1];
+  const int size = out_dims.count(2, out_dims.size());
+  // the same dims, or the per channel values of [1 or N, C, 1, 1]
+  auto broadcast = [&](const DDim& dims, int* in_size, int* in_num) {
+    CHECK_EQ(dims.size(), out_dims.size());
+    CHECK_EQ(dims[1], channel);
+    *in_num = dims[0];
+    *in_size = dims.count(2, dims.size());
+    CHECK(*in_num == num || *in_num == 1)
+        << "NCHWc8 elementwise broadcast not supported: " << dims;
+    CHECK(*in_size == size || *in_size == 1)
+        << "NCHWc8 elementwise broadcast not supported: " << dims;
+  };
+  int x_size = 0;
+  int x_num = 0;
+  int y_size = 0;
+  int y_num = 0;
+  broadcast(param.X->dims(), &x_size, &x_num);
+  broadcast(param.Y->dims(), &y_size, &y_num);
+  math::elementwise_nchwc8(param.X->template data<float>(),
+                           param.Y->template data<float>(),
+                           math::nchwc8_mutable_data(param.Out),
+                           type_,
+                           num,
+                           channel,
+                           size,
+                           x_size,
+                           x_num,
+                           y_size,
+                           y_num,
+                           fuse_relu_);
+}
+
+void ActivationNCHWc8Compute::Run() {
+  auto& param = this->Param<param_t>();
+  math::act_nchwc8(param.X->data<float>(),
+                   math::nchwc8_mutable_data(param.Out),
+                   math::nchwc8_size(param.X->dims()),
+                   param);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+using ConvNCHWc8 = paddle::lite::kernels::x86::ConvNCHWc8Compute;
+using PoolNCHWc8 = paddle::lite::kernels::x86::PoolNCHWc8Compute;
+using BatchNormNCHWc8 = paddle::lite::kernels::x86::BatchNormNCHWc8Compute;
+using ScaleNCHWc8 = paddle::lite::kernels::x86::ScaleNCHWc8Compute;
+using ElementwiseNCHWc8 = paddle::lite::kernels::x86::ElementwiseNCHWc8Compute<
+    paddle::lite::operators::ElementwiseParam>;
+using ElementwiseActNCHWc8 =
+    paddle::lite::kernels::x86::ElementwiseNCHWc8Compute<
+        paddle::lite::operators::FusionElementwiseActivationParam>;
+using ActNCHWc8 = paddle::lite::kernels::x86::ActivationNCHWc8Compute;
+
+REGISTER_LITE_KERNEL(conv2d, kX86, kFloat, kNCHWc8, ConvNCHWc8, def)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindInput("SecondInput",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Filter", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Output",
+                {LiteType::GetTensorTy(
+                    TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindPaddleOpVersion("conv2d", 1)
+    .Finalize();
+
+REGISTER_LITE_KERNEL(depthwise_conv2d, kX86, kFloat, kNCHWc8, ConvNCHWc8, def)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Filter", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Output",
+                {LiteType::GetTensorTy(
+                    TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindPaddleOpVersion("depthwise_conv2d", 1)
+    .Finalize();
+
+REGISTER_LITE_KERNEL(pool2d, kX86, kFloat, kNCHWc8, PoolNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindPaddleOpVersion("pool2d", 1)
+    .Finalize();
+
+REGISTER_LITE_KERNEL(batch_norm, kX86, kFloat, kNCHWc8, BatchNormNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindInput("Scale", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Mean", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Variance", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Y",
+                {LiteType::GetTensorTy(
+                    TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindOutput("MeanOut", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("VarianceOut", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("SavedMean", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("SavedVariance", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(scale, kX86, kFloat, kNCHWc8, ScaleNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    elementwise_add, kX86, kFloat, kNCHWc8, ElementwiseNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    elementwise_sub, kX86, kFloat, kNCHWc8, ElementwiseNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    elementwise_mul, kX86, kFloat, kNCHWc8, ElementwiseNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(fusion_elementwise_add_activation,
+                     kX86,
+                     kFloat,
+                     kNCHWc8,
+                     ElementwiseActNCHWc8,
+                     def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(fusion_elementwise_sub_activation,
+                     kX86,
+                     kFloat,
+                     kNCHWc8,
+                     ElementwiseActNCHWc8,
+                     def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(fusion_elementwise_mul_activation,
+                     kX86,
+                     kFloat,
+                     kNCHWc8,
+                     ElementwiseActNCHWc8,
+                     def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(relu, kX86, kFloat, kNCHWc8, ActNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(relu6, kX86, kFloat, kNCHWc8, ActNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(leaky_relu, kX86, kFloat, kNCHWc8, ActNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(hard_swish, kX86, kFloat, kNCHWc8, ActNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(sigmoid, kX86, kFloat, kNCHWc8, ActNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8))})
+    .Finalize();
@@ -0,0 +1,117 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// The kernels of the NCHWc8 layout: the data inputs and outputs are blocked
+// over 8 channels (see lite/backends/x86/math/avx/nchwc8.h), the weights stay
+// NCHW and are packed in PrepareForRun. type_layout_cast_pass keeps them for
+// the convs and the ops fed by blocked tensors only, and puts the layout
+// kernels on the edges of the blocked part of the graph.
+
+class ConvNCHWc8Compute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8)> {
+ public:
+  using param_t = operators::ConvParam;
+
+  void PrepareForRun() override;
+
+  void Run() override;
+
+  virtual ~ConvNCHWc8Compute() = default;
+
+ private:
+  bool depthwise_{false};
+  Tensor weights_;
+  Tensor bias_;
+};
+
+class PoolNCHWc8Compute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8)> {
+ public:
+  using param_t = operators::PoolParam;
+
+  void Run() override;
+
+  virtual ~PoolNCHWc8Compute() = default;
+};
+
+class BatchNormNCHWc8Compute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8)> {
+ public:
+  using param_t = operators::BatchNormParam;
+
+  void Run() override;
+
+  virtual ~BatchNormNCHWc8Compute() = default;
+
+ private:
+  std::vector<float> scale_;
+  std::vector<float> bias_;
+};
+
+class ScaleNCHWc8Compute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8)> {
+ public:
+  using param_t = operators::ScaleParam;
+
+  void Run() override;
+
+  virtual ~ScaleNCHWc8Compute() = default;
+};
+
+// elementwise_add, sub and mul, and their fusion_elementwise_*_activation
+// with relu
+template <typename ParamT>
+class ElementwiseNCHWc8Compute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8)> {
+ public:
+  using param_t = ParamT;
+
+  void PrepareForRun() override;
+
+  void Run() override;
+
+  virtual ~ElementwiseNCHWc8Compute() = default;
+
+ private:
+  std::string type_;
+  bool fuse_relu_{false};
+};
+
+// relu, relu6, leaky_relu, hard_swish and sigmoid
+class ActivationNCHWc8Compute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHWc8)> {
+ public:
+  using param_t = operators::ActivationParam;
+
+  void Run() override;
+
+  virtual ~ActivationNCHWc8Compute() = default;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,427 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/layout_compute.h"
+#include "lite/kernels/x86/nchwc8_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// The blocked kernels run between the layout kernels and are compared with
+// plain NCHW references, the channels off the multiples of 8 leave padded
+// lanes in the last block.
+
+static void fill(Tensor* x, int seed) {
+  float* data = x->mutable_data<float>();
+  for (int64_t i = 0; i < x->numel(); i++) {
+    data[i] = static_cast<float>((i * 7 + seed) % 23) * 0.125f - 1.25f;
+  }
+}
+
+static void to_blocked(const Tensor& x, Tensor* y) {
+  NCHWToNCHWc8Compute kernel;
+  operators::LayoutParam param;
+  param.x = &x;
+  param.y = y;
+  kernel.SetParam(param);
+  kernel.Run();
+}
+
+static void to_plain(const Tensor& x, Tensor* y) {
+  NCHWc8ToNCHWCompute kernel;
+  operators::LayoutParam param;
+  param.x = &x;
+  param.y = y;
+  kernel.SetParam(param);
+  kernel.Run();
+}
+
+static void expect_near(const Tensor& blocked,
+                        const std::vector<float>& ref,
+                        float eps = 1e-4f) {
+  Tensor out;
+  to_plain(blocked, &out);
+  ASSERT_EQ(out.numel(), static_cast<int64_t>(ref.size()));
+  const float* data = out.data<float>();
+  for (size_t i = 0; i < ref.size(); i++) {
+    ASSERT_NEAR(data[i], ref[i], eps * std::max(1.f, std::fabs(ref[i])))
+        << "at " << i;
+  }
+}
+
+TEST(nchwc8_x86, layout) {
+  for (int channel : {3, 8, 13, 16}) {
+    Tensor x, blocked, y;
+    x.Resize({2, channel, 5, 3});
+    fill(&x, channel);
+    to_blocked(x, &blocked);
+    // the padded lanes are zeros
+    const float* data = blocked.data<float>();
+    for (int i = 0; i < 2 * 8 * ((channel + 7) / 8) * 15; i++) {
+      if ((i / 15 / 8 % ((channel + 7) / 8)) * 8 + i % 8 >= channel) {
+        EXPECT_EQ(data[i], 0.f);
+      }
+    }
+    to_plain(blocked, &y);
+    for (int64_t i = 0; i < x.numel(); i++) {
+      EXPECT_EQ(x.data<float>()[i], y.data<float>()[i]);
+    }
+  }
+}
+
+struct ConvCase {
+  int num, chin, h, w, chout, k, stride, pad, dilation, groups;
+  lite_api::ActivationType act;
+};
+
+static float act_ref(float x, lite_api::ActivationType act) {
+  switch (act) {
+    case lite_api::ActivationType::kRelu:
+      return std::max(x, 0.f);
+    case lite_api::ActivationType::kRelu6:
+      return std::min(std::max(x, 0.f), 6.f);
+    case lite_api::ActivationType::kLeakyRelu:
+      return x > 0.f ? x : x * 0.1f;
+    case lite_api::ActivationType::kHardSwish:
+      return x * std::min(std::max(x + 3.f, 0.f), 6.f) / 6.f;
+    case lite_api::ActivationType::kSigmoid:
+      return 1.f / (1.f + std::exp(-x));
+    default:
+      return x;
+  }
+}
+
+TEST(nchwc8_x86, conv) {
+  const auto relu = lite_api::ActivationType::kRelu;
+  const auto none = lite_api::ActivationType::kIndentity;
+  const ConvCase cases[] = {
+      {1, 3, 13, 11, 16, 3, 1, 1, 1, 1, relu},
+      {2, 16, 9, 10, 24, 3, 2, 1, 1, 1, none},
+      {1, 13, 7, 20, 5, 1, 1, 0, 1, 1, lite_api::ActivationType::kRelu6},
+      {1, 16, 8, 9, 32, 3, 1, 2, 2, 2, lite_api::ActivationType::kLeakyRelu},
+      {1, 8, 3, 2, 8, 5, 1, 2, 1, 1, relu},
+      {1, 16, 12, 19, 16, 3, 1, 1, 1, 16, lite_api::ActivationType::kHardSwish},
+      {2, 20, 11, 11, 20, 5, 2, 2, 1, 20, none},
+      {1, 24, 10, 14, 24, 3, 1, 2, 2, 24, relu},
+      // rows of full tiles of pairs of output blocks
+      {1, 16, 6, 30, 24, 3, 1, 1, 1, 1, relu},
+      {2, 32, 5, 27, 32, 3, 1, 1, 1, 2, none},
+  };
+  for (const auto& c : cases) {
+    const int ext = c.dilation * (c.k - 1) + 1;
+    const int oh = (c.h + 2 * c.pad - ext) / c.stride + 1;
+    const int ow = (c.w + 2 * c.pad - ext) / c.stride + 1;
+    const int chin_group = c.chin / c.groups;
+    const int chout_group = c.chout / c.groups;
+    Tensor x, blocked_x, filter, bias, out;
+    x.Resize({c.num, c.chin, c.h, c.w});
+    filter.Resize({c.chout, chin_group, c.k, c.k});
+    bias.Resize({c.chout});
+    fill(&x, 1);
+    fill(&filter, 2);
+    fill(&bias, 3);
+    to_blocked(x, &blocked_x);
+    out.Resize({c.num, c.chout, oh, ow});
+
+    std::vector<float> ref(out.numel());
+    const float* xd = x.data<float>();
+    const float* wd = filter.data<float>();
+    const float* bd = bias.data<float>();
+    for (int n = 0; n < c.num; n++) {
+      for (int oc = 0; oc < c.chout; oc++) {
+        const int g = oc / chout_group;
+        for (int y = 0; y < oh; y++) {
+          for (int x0 = 0; x0 < ow; x0++) {
+            float sum = bd[oc];
+            for (int ic = 0; ic < chin_group; ic++) {
+              for (int ky = 0; ky < c.k; ky++) {
+                for (int kx = 0; kx < c.k; kx++) {
+                  int iy = y * c.stride - c.pad + ky * c.dilation;
+                  int ix = x0 * c.stride - c.pad + kx * c.dilation;
+                  if (iy < 0 || iy >= c.h || ix < 0 || ix >= c.w) continue;
+                  sum += xd[((n * c.chin + g * chin_group + ic) * c.h + iy) *
+                                c.w +
+                            ix] *
+                         wd[((oc * chin_group + ic) * c.k + ky) * c.k + kx];
+                }
+              }
+            }
+            ref[((n * c.chout + oc) * oh + y) * ow + x0] = act_ref(sum, c.act);
+          }
+        }
+      }
+    }
+
+    ConvNCHWc8Compute conv;
+    operators::ConvParam param;
+    param.x = &blocked_x;
+    param.filter = &filter;
+    param.bias = &bias;
+    param.output = &out;
+    param.strides = {c.stride, c.stride};
+    param.groups = c.groups;
+    param.paddings = std::make_shared<std::vector<int>>(
+        std::vector<int>{c.pad, c.pad, c.pad, c.pad});
+    param.dilations = std::make_shared<std::vector<int>>(
+        std::vector<int>{c.dilation, c.dilation});
+    param.activation_param.has_active = c.act != none;
+    param.activation_param.active_type = c.act;
+    param.activation_param.Leaky_relu_alpha = 0.1f;
+    conv.SetParam(param);
+    conv.PrepareForRun();
+    conv.Run();
+    expect_near(out, ref);
+  }
+}
+
+TEST(nchwc8_x86, pool) {
+  struct PoolCase {
+    int k, stride, pad;
+    bool is_max, exclusive, global, adaptive;
+  };
+  const PoolCase cases[] = {{3, 2, 1, true, true, false, false},
+                            {2, 2, 0, false, true, false, false},
+                            {3, 2, 1, false, false, false, false},
+                            {3, 1, 1, false, true, false, false},
+                            {0, 1, 0, false, true, true, false},
+                            {3, 1, 0, false, true, false, true}};
+  const int num = 2, channel = 13, h = 9, w = 10;
+  for (const auto& c : cases) {
+    int oh = c.global ? 1 : (h + 2 * c.pad - c.k) / c.stride + 1;
+    int ow = c.global ? 1 : (w + 2 * c.pad - c.k) / c.stride + 1;
+    if (c.adaptive) {
+      oh = ow = c.k;
+    }
+    Tensor x, blocked_x, out;
+    x.Resize({num, channel, h, w});
+    fill(&x, 4);
+    to_blocked(x, &blocked_x);
+    out.Resize({num, channel, oh, ow});
+
+    const int kh = c.global ? h : c.k;
+    const int kw = c.global ? w : c.k;
+    std::vector<float> ref(out.numel());
+    const float* xd = x.data<float>();
+    for (int nc = 0; nc < num * channel; nc++) {
+      for (int y = 0; y < oh; y++) {
+        for (int x0 = 0; x0 < ow; x0++) {
+          int hs = y * c.stride - c.pad;
+          int ws = x0 * c.stride - c.pad;
+          int he = std::min(hs + kh, h);
+          int we = std::min(ws + kw, w);
+          hs = std::max(hs, 0);
+          ws = std::max(ws, 0);
+          if (c.adaptive) {
+            hs = y * h / oh;
+            he = ((y + 1) * h + oh - 1) / oh;
+            ws = x0 * w / ow;
+            we = ((x0 + 1) * w + ow - 1) / ow;
+          }
+          float res = c.is_max ? -FLT_MAX : 0.f;
+          for (int iy = hs; iy < he; iy++) {
+            for (int ix = ws; ix < we; ix++) {
+              float v = xd[(nc * h + iy) * w + ix];
+              res = c.is_max ? std::max(res, v) : res + v;
+            }
+          }
+          if (!c.is_max) {
+            res /= (c.exclusive || c.adaptive) ? (he - hs) * (we - ws)
+                                               : kh * kw;
+          }
+          ref[(nc * oh + y) * ow + x0] = res;
+        }
+      }
+    }
+
+    PoolNCHWc8Compute pool;
+    operators::PoolParam param;
+    param.x = &blocked_x;
+    param.output = &out;
+    param.pooling_type = c.is_max ? "max" : "avg";
+    param.ksize = {c.k, c.k};
+    param.global_pooling = c.global;
+    param.strides = {c.stride, c.stride};
+    param.paddings = std::make_shared<std::vector<int>>(
+        std::vector<int>{c.pad, c.pad, c.pad, c.pad});
+    param.exclusive = c.exclusive;
+    param.adaptive = c.adaptive;
+    pool.SetParam(param);
+    pool.Run();
+    expect_near(out, ref);
+  }
+}
+
+TEST(nchwc8_x86, batch_norm_scale_act) {
+  const int num = 2, channel = 11, h = 4, w = 5;
+  Tensor x, blocked_x, scale, bias, mean, variance, bn_out, scale_out, act_out;
+  x.Resize({num, channel, h, w});
+  for (auto* t : {&scale, &bias, &mean, &variance}) {
+    t->Resize({channel});
+  }
+  fill(&x, 5);
+  fill(&scale, 6);
+  fill(&bias, 7);
+  fill(&mean, 8);
+  float* var = variance.mutable_data<float>();
+  for (int c = 0; c < channel; c++) {
+    var[c] = 0.5f + c * 0.25f;
+  }
+  to_blocked(x, &blocked_x);
+  bn_out.Resize(x.dims());
+  scale_out.Resize(x.dims());
+  act_out.Resize(x.dims());
+
+  BatchNormNCHWc8Compute bn;
+  operators::BatchNormParam bn_param;
+  bn_param.x = &blocked_x;
+  bn_param.scale = &scale;
+  bn_param.bias = &bias;
+  bn_param.mean = &mean;
+  bn_param.variance = &variance;
+  bn_param.y = &bn_out;
+  bn_param.epsilon = 1e-5f;
+  bn.SetParam(bn_param);
+  bn.Run();
+
+  ScaleNCHWc8Compute scale_kernel;
+  operators::ScaleParam scale_param;
+  scale_param.x = &bn_out;
+  scale_param.output = &scale_out;
+  scale_param.scale = 1.5f;
+  scale_param.bias = -0.5f;
+  scale_param.bias_after_scale = false;
+  scale_kernel.SetParam(scale_param);
+  scale_kernel.Run();
+
+  std::vector<float> bn_ref(x.numel());
+  std::vector<float> scale_ref(x.numel());
+  const float* xd = x.data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    int c = i / (h * w) % channel;
+    bn_ref[i] = (xd[i] - mean.data<float>()[c]) /
+                    std::sqrt(var[c] + bn_param.epsilon) *
+                    scale.data<float>()[c] +
+                bias.data<float>()[c];
+    scale_ref[i] = (bn_ref[i] - 0.5f) * 1.5f;
+  }
+  expect_near(bn_out, bn_ref);
+  expect_near(scale_out, scale_ref);
+
+  for (auto act : {lite_api::ActivationType::kRelu,
+                   lite_api::ActivationType::kRelu6,
+                   lite_api::ActivationType::kLeakyRelu,
+                   lite_api::ActivationType::kHardSwish,
+                   lite_api::ActivationType::kSigmoid}) {
+    ActivationNCHWc8Compute act_kernel;
+    operators::ActivationParam act_param;
+    act_param.X = &scale_out;
+    act_param.Out = &act_out;
+    act_param.active_type = act;
+    act_param.Leaky_relu_alpha = 0.1f;
+    act_kernel.SetParam(act_param);
+    act_kernel.Run();
+    std::vector<float> act_ref_out(x.numel());
+    for (int64_t i = 0; i < x.numel(); i++) {
+      act_ref_out[i] = act_ref(scale_ref[i], act);
+    }
+    expect_near(act_out, act_ref_out);
+  }
+}
+
+TEST(nchwc8_x86, elementwise) {
+  const int num = 2, channel = 13, h = 3, w = 7;
+  Tensor x, y, bias, blocked_x, blocked_y, blocked_bias, out;
+  x.Resize({num, channel, h, w});
+  y.Resize({num, channel, h, w});
+  bias.Resize({1, channel, 1, 1});
+  fill(&x, 9);
+  fill(&y, 10);
+  fill(&bias, 11);
+  to_blocked(x, &blocked_x);
+  to_blocked(y, &blocked_y);
+  to_blocked(bias, &blocked_bias);
+  out.Resize(x.dims());
+
+  const float* xd = x.data<float>();
+  const float* yd = y.data<float>();
+  const float* bd = bias.data<float>();
+  {
+    ElementwiseNCHWc8Compute<operators::ElementwiseParam> add;
+    add.set_op_type("elementwise_add");
+    operators::ElementwiseParam param;
+    param.X = &blocked_x;
+    param.Y = &blocked_y;
+    param.Out = &out;
+    add.SetParam(param);
+    add.PrepareForRun();
+    add.Run();
+    std::vector<float> ref(x.numel());
+    for (int64_t i = 0; i < x.numel(); i++) {
+      ref[i] = xd[i] + yd[i];
+    }
+    expect_near(out, ref);
+  }
+  {
+    ElementwiseNCHWc8Compute<operators::FusionElementwiseActivationParam> mul;
+    mul.set_op_type("fusion_elementwise_mul_activation");
+    operators::FusionElementwiseActivationParam param;
+    param.X = &blocked_x;
+    param.Y = &blocked_bias;
+    param.Out = &out;
+    param.act_type = "relu";
+    mul.SetParam(param);
+    mul.PrepareForRun();
+    mul.Run();
+    std::vector<float> ref(x.numel());
+    for (int64_t i = 0; i < x.numel(); i++) {
+      ref[i] = std::max(xd[i] * bd[i / (h * w) % channel], 0.f);
+    }
+    expect_near(out, ref);
+  }
+  {
+    ElementwiseNCHWc8Compute<operators::ElementwiseParam> sub;
+    sub.set_op_type("elementwise_sub");
+    operators::ElementwiseParam param;
+    param.X = &blocked_bias;
+    param.Y = &blocked_y;
+    param.Out = &out;
+    sub.SetParam(param);
+    sub.PrepareForRun();
+    sub.Run();
+    std::vector<float> ref(x.numel());
+    for (int64_t i = 0; i < x.numel(); i++) {
+      ref[i] = bd[i / (h * w) % channel] - yd[i];
+    }
+    expect_near(out, ref);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(conv2d, kX86, kFloat, kNCHWc8, def);
+USE_LITE_KERNEL(layout, kX86, kFloat, kNCHW, nchw2nchwc8);
@@ -14,6 +14,62 @@
 
 #include "lite/kernels/x86/pool_compute.h"
 
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+template <typename T>
+void pool2d_int8(operators::PoolParam* param, float scale) {
+  const auto& x_dims = param->x->dims();
+  const auto& out_dims = param->output->dims();
+  CHECK_EQ(param->ksize.size(), 2u) << "The int8 pooling supports pool2d only";
+  if (param->global_pooling) {
+    for (size_t i = 0; i < param->ksize.size(); ++i) {
+      param->ksize[i] = static_cast<int>(x_dims[i + 2]);
+    }
+  }
+  CHECK(param->pooling_type == "max" || param->pooling_type == "avg")
+      << "Unsupported pooling type: " << param->pooling_type;
+  paddle::lite::x86::math::pooling2d_int8(
+      param->x->data<int8_t>(),
+      param->output->mutable_data<T>(),
+      static_cast<int>(x_dims[0] * x_dims[1]),
+      x_dims[2],
+      x_dims[3],
+      out_dims[2],
+      out_dims[3],
+      param->ksize,
+      param->strides,
+      *param->paddings,
+      param->pooling_type == "max",
+      param->exclusive,
+      param->adaptive,
+      scale);
+}
+
+template <>
+void PoolInt8Compute<PRECISION(kInt8)>::Run() {
+  auto& param = *param_.get_mutable<param_t>();
+  pool2d_int8<int8_t>(&param, param.input_scale / param.output_scale);
+}
+
+template <>
+void PoolInt8Compute<PRECISION(kFloat)>::Run() {
+  auto& param = *param_.get_mutable<param_t>();
+  pool2d_int8<float>(&param, param.input_scale);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+typedef paddle::lite::kernels::x86::PoolInt8Compute<PRECISION(kInt8)>
+    PoolInt8_Int8;
+typedef paddle::lite::kernels::x86::PoolInt8Compute<PRECISION(kFloat)>
+    PoolInt8_Fp32;
+
 REGISTER_LITE_KERNEL(pool2d,
                      kX86,
                      kFloat,
@@ -23,3 +79,23 @@ REGISTER_LITE_KERNEL(pool2d,
     .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
     .Finalize();
+
+REGISTER_LITE_KERNEL(pool3d,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::PoolCompute<float>,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(pool2d, kX86, kInt8, kNCHW, PoolInt8_Int8, int8_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(pool2d, kX86, kInt8, kNCHW, PoolInt8_Fp32, fp32_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
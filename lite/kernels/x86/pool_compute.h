@@ -13,9 +13,6 @@
 // limitations under the License.
 #pragma once
 
-#include <Eigen/Core>
-#include "lite/backends/x86/fluid/eigen.h"
-#include "lite/backends/x86/math/math_function.h"
 #include "lite/backends/x86/math/pooling.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
@@ -31,56 +28,72 @@ class PoolCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::PoolParam;
   void Run() override {
-    auto& context = ctx_->As<X86Context>();
     auto& param = *param_.get_mutable<param_t>();
+    const auto& x_dims = param.x->dims();
+    const auto& out_dims = param.output->dims();
     if (param.global_pooling) {
       for (size_t i = 0; i < param.ksize.size(); ++i) {
-        param.ksize[i] = static_cast<int>(param.x->dims()[i + 2]);
+        param.ksize[i] = static_cast<int>(x_dims[i + 2]);
       }
     }
+    CHECK(param.pooling_type == "max" || param.pooling_type == "avg")
+        << "Unsupported pooling type: " << param.pooling_type;
+    const bool is_max = param.pooling_type == "max";
+    const int num_channel = static_cast<int>(x_dims[0] * x_dims[1]);
+    const T* din = param.x->template data<T>();
+    T* dout = param.output->template mutable_data<T>();
     switch (param.ksize.size()) {
       case 2: {
-        if (param.pooling_type == "max") {
-          paddle::lite::x86::math::Pool2dFunctor<
-              lite::TargetType::kX86,
-              paddle::lite::x86::math::MaxPool<T>,
-              T>
-              pool2d_forward;
-          paddle::lite::x86::math::MaxPool<T> pool_process;
-          pool2d_forward(context,
-                         param.x,
-                         param.ksize,
-                         param.strides,
-                         *param.paddings,
-                         pool_process,
-                         true,
-                         false,
-                         param.output);
-        } else if (param.pooling_type == "avg") {
-          paddle::lite::x86::math::Pool2dFunctor<
-              lite::TargetType::kX86,
-              paddle::lite::x86::math::AvgPool<T>,
-              T>
-              pool2d_forward;
-          paddle::lite::x86::math::AvgPool<T> pool_process;
-          pool2d_forward(context,
-                         param.x,
-                         param.ksize,
-                         param.strides,
-                         *param.paddings,
-                         pool_process,
-                         param.exclusive,
-                         param.adaptive,
-                         param.output);
-        }
+        paddle::lite::x86::math::pooling2d(din,
+                                           dout,
+                                           num_channel,
+                                           x_dims[2],
+                                           x_dims[3],
+                                           out_dims[2],
+                                           out_dims[3],
+                                           param.ksize,
+                                           param.strides,
+                                           *param.paddings,
+                                           is_max,
+                                           param.exclusive,
+                                           param.adaptive);
       } break;
       case 3: {
+        paddle::lite::x86::math::pooling3d(din,
+                                           dout,
+                                           num_channel,
+                                           x_dims[2],
+                                           x_dims[3],
+                                           x_dims[4],
+                                           out_dims[2],
+                                           out_dims[3],
+                                           out_dims[4],
+                                           param.ksize,
+                                           param.strides,
+                                           *param.paddings,
+                                           is_max,
+                                           param.exclusive,
+                                           param.adaptive);
       } break;
+      default:
+        LOG(FATAL) << "Unsupported pooling dims: " << param.ksize.size();
     }
   }
   virtual ~PoolCompute() = default;
 };
 
+// pool2d of the int8 input of the scale param.input_scale, the int8 output
+// of OutType is quantized with param.output_scale
+template <PrecisionType OutType>
+class PoolInt8Compute : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::PoolParam;
+
+  void Run() override;
+
+  virtual ~PoolInt8Compute() = default;
+};
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -14,8 +14,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -79,9 +81,262 @@ TEST(pool2d_x86, run_test) {
   }
 }
 
+// the output size of PoolOpLite for non adaptive pooling
+static int pool_output_size(
+    int in, int ksize, int pad, int stride, bool ceil_mode) {
+  return (in - ksize + 2 * pad + (ceil_mode ? stride - 1 : 0)) / stride + 1;
+}
+
+static void fill_pool_input(lite::Tensor* x) {
+  auto* data = x->mutable_data<float>();
+  for (int64_t i = 0; i < x->numel(); i++) {
+    data[i] = static_cast<float>((i * 37 + 11) % 101) / 10.f - 5.f;
+  }
+}
+
+// the pooling of Pool2dFunctor or Pool3dFunctor
+template <typename PoolProcess>
+static void ref_pool(const lite::Tensor& x,
+                     const std::vector<int>& ksize,
+                     const std::vector<int>& strides,
+                     int pad,
+                     bool exclusive,
+                     bool adaptive,
+                     lite::Tensor* out) {
+  X86Context context;
+  PoolProcess process;
+  if (ksize.size() == 2) {
+    lite::x86::math::Pool2dFunctor<TARGET(kX86), PoolProcess, float> pool2d;
+    pool2d(context,
+           &x,
+           ksize,
+           strides,
+           std::vector<int>(4, pad),
+           process,
+           exclusive,
+           adaptive,
+           out);
+  } else {
+    lite::x86::math::Pool3dFunctor<TARGET(kX86), PoolProcess, float> pool3d;
+    pool3d(context,
+           x,
+           ksize,
+           strides,
+           std::vector<int>(3, pad),
+           process,
+           exclusive,
+           adaptive,
+           out);
+  }
+}
+
+// compares the pooling of PoolCompute with Pool2dFunctor and Pool3dFunctor
+static void test_pool_compute(const std::vector<int64_t>& x_shape,
+                              int ksize,
+                              int stride,
+                              int pad,
+                              const std::string& pooling_type,
+                              bool exclusive,
+                              bool adaptive,
+                              bool global_pooling,
+                              bool ceil_mode) {
+  const int pool_dims = static_cast<int>(x_shape.size()) - 2;
+  lite::Tensor x, out, ref;
+  x.Resize(lite::DDim(x_shape));
+  fill_pool_input(&x);
+  std::vector<int64_t> out_shape{x_shape[0], x_shape[1]};
+  for (int i = 0; i < pool_dims; i++) {
+    if (global_pooling) {
+      out_shape.push_back(1);
+    } else if (adaptive) {
+      out_shape.push_back(ksize);
+    } else {
+      out_shape.push_back(
+          pool_output_size(x_shape[i + 2], ksize, pad, stride, ceil_mode));
+    }
+  }
+  out.Resize(lite::DDim(out_shape));
+  ref.Resize(lite::DDim(out_shape));
+
+  operators::PoolParam param;
+  param.x = &x;
+  param.output = &out;
+  param.pooling_type = pooling_type;
+  param.ksize = std::vector<int>(pool_dims, ksize);
+  if (global_pooling) {
+    param.ksize = std::vector<int>(x_shape.begin() + 2, x_shape.end());
+  }
+  param.strides = std::vector<int>(pool_dims, stride);
+  param.paddings =
+      std::make_shared<std::vector<int>>(std::vector<int>(2 * pool_dims, pad));
+  param.exclusive = exclusive;
+  param.adaptive = adaptive;
+  param.global_pooling = global_pooling;
+  param.ceil_mode = ceil_mode;
+
+  PoolCompute<float> pool;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  pool.SetContext(std::move(ctx));
+  pool.SetParam(param);
+  pool.Run();
+
+  if (pooling_type == "max") {
+    ref_pool<lite::x86::math::MaxPool<float>>(
+        x, param.ksize, param.strides, pad, true, adaptive, &ref);
+  } else {
+    ref_pool<lite::x86::math::AvgPool<float>>(
+        x, param.ksize, param.strides, pad, exclusive, adaptive, &ref);
+  }
+
+  const float* out_data = out.data<float>();
+  const float* ref_data = ref.data<float>();
+  for (int64_t i = 0; i < out.numel(); i++) {
+    ASSERT_NEAR(out_data[i], ref_data[i], 1e-4)
+        << "pool" << pool_dims << "d " << pooling_type << " k" << ksize << "s"
+        << stride << "p" << pad << " at " << i;
+  }
+}
+
+TEST(pool2d_x86, compare_with_functor) {
+  for (auto type : {"max", "avg"}) {
+    for (bool exclusive : {true, false}) {
+      for (bool ceil_mode : {false, true}) {
+        for (int w : {7, 16, 33}) {
+          // 3x3s2p1, 2x2s2p0, 3x3s1p1, 5x5s1p2, 3x3s3p0
+          test_pool_compute(
+              {2, 3, 11, w}, 3, 2, 1, type, exclusive, false, false, ceil_mode);
+          test_pool_compute(
+              {2, 3, 11, w}, 2, 2, 0, type, exclusive, false, false, ceil_mode);
+          test_pool_compute(
+              {1, 4, 9, w}, 3, 1, 1, type, exclusive, false, false, ceil_mode);
+          test_pool_compute(
+              {1, 2, 9, w}, 5, 1, 2, type, exclusive, false, false, ceil_mode);
+          test_pool_compute(
+              {1, 2, 9, w}, 3, 3, 0, type, exclusive, false, false, ceil_mode);
+        }
+      }
+    }
+    // global and adaptive
+    test_pool_compute({2, 5, 7, 7}, 7, 1, 0, type, true, false, true, false);
+    test_pool_compute({1, 3, 13, 35}, 1, 1, 0, type, true, false, true, false);
+    test_pool_compute({2, 3, 15, 20}, 1, 1, 0, type, true, true, false, false);
+    test_pool_compute({2, 3, 15, 20}, 4, 1, 0, type, true, true, false, false);
+  }
+}
+
+TEST(pool3d_x86, compare_with_functor) {
+  for (auto type : {"max", "avg"}) {
+    for (bool exclusive : {true, false}) {
+      test_pool_compute(
+          {2, 3, 6, 9, 21}, 3, 2, 1, type, exclusive, false, false, false);
+      test_pool_compute(
+          {1, 2, 5, 8, 17}, 2, 2, 0, type, exclusive, false, false, false);
+      test_pool_compute(
+          {1, 2, 5, 8, 19}, 3, 1, 1, type, exclusive, false, false, false);
+    }
+    test_pool_compute({1, 4, 3, 5, 6}, 3, 1, 0, type, true, false, true, false);
+    test_pool_compute(
+        {1, 3, 6, 8, 10}, 3, 1, 0, type, true, true, false, false);
+  }
+}
+
+// compares the int8 pool2d with the float one on the dequantized input
+static void test_pool_int8(const std::vector<int64_t>& x_shape,
+                           int ksize,
+                           int stride,
+                           int pad,
+                           const std::string& pooling_type,
+                           bool exclusive,
+                           bool adaptive,
+                           bool global_pooling) {
+  const float in_scale = 0.05f;
+  const float out_scale = 0.04f;
+  lite::Tensor x, x_fp32, out_int8, out_fp32, ref;
+  x.Resize(lite::DDim(x_shape));
+  x_fp32.Resize(lite::DDim(x_shape));
+  auto* x_data = x.mutable_data<int8_t>();
+  auto* x_fp32_data = x_fp32.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = static_cast<int8_t>((i * 37 + 11) % 255 - 127);
+    x_fp32_data[i] = x_data[i] * in_scale;
+  }
+  std::vector<int64_t> out_shape{x_shape[0], x_shape[1]};
+  for (int i = 0; i < 2; i++) {
+    if (global_pooling) {
+      out_shape.push_back(1);
+    } else if (adaptive) {
+      out_shape.push_back(ksize);
+    } else {
+      out_shape.push_back(
+          pool_output_size(x_shape[i + 2], ksize, pad, stride, false));
+    }
+  }
+  for (auto* tensor : {&out_int8, &out_fp32, &ref}) {
+    tensor->Resize(lite::DDim(out_shape));
+  }
+
+  operators::PoolParam param;
+  param.pooling_type = pooling_type;
+  param.ksize = std::vector<int>(2, ksize);
+  param.strides = std::vector<int>(2, stride);
+  param.paddings =
+      std::make_shared<std::vector<int>>(std::vector<int>(4, pad));
+  param.exclusive = exclusive;
+  param.adaptive = adaptive;
+  param.global_pooling = global_pooling;
+  param.enable_int8 = true;
+  param.input_scale = in_scale;
+  param.output_scale = out_scale;
+  auto run = [&](KernelBase* kernel, lite::Tensor* in, lite::Tensor* out) {
+    param.x = in;
+    param.output = out;
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    kernel->SetContext(std::move(ctx));
+    kernel->SetParam(param);
+    kernel->Launch();
+  };
+  PoolCompute<float> pool;
+  PoolInt8Compute<PRECISION(kInt8)> pool_int8;
+  PoolInt8Compute<PRECISION(kFloat)> pool_fp32;
+  run(&pool, &x_fp32, &ref);
+  run(&pool_int8, &x, &out_int8);
+  run(&pool_fp32, &x, &out_fp32);
+
+  const float* ref_data = ref.data<float>();
+  const int8_t* out_int8_data = out_int8.data<int8_t>();
+  const float* out_fp32_data = out_fp32.data<float>();
+  for (int64_t i = 0; i < ref.numel(); i++) {
+    float expect = (std::min)((std::max)(ref_data[i], -127 * out_scale),
+                              127 * out_scale);
+    ASSERT_NEAR(out_fp32_data[i], ref_data[i], 1e-4)
+        << pooling_type << " k" << ksize << "s" << stride << "p" << pad
+        << " at " << i;
+    ASSERT_NEAR(out_int8_data[i] * out_scale, expect, out_scale * 0.51f)
+        << pooling_type << " k" << ksize << "s" << stride << "p" << pad
+        << " at " << i;
+  }
+}
+
+TEST(pool2d_x86, int8) {
+  for (auto type : {"max", "avg"}) {
+    for (bool exclusive : {true, false}) {
+      test_pool_int8({2, 3, 11, 16}, 3, 2, 1, type, exclusive, false, false);
+      test_pool_int8({1, 4, 9, 7}, 2, 2, 0, type, exclusive, false, false);
+      test_pool_int8({1, 2, 9, 33}, 3, 1, 1, type, exclusive, false, false);
+    }
+    test_pool_int8({2, 5, 7, 7}, 7, 1, 0, type, true, false, true);
+    test_pool_int8({2, 3, 15, 20}, 4, 1, 0, type, true, true, false);
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
 }  // namespace paddle
 
 USE_LITE_KERNEL(pool2d, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(pool3d, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(pool2d, kX86, kInt8, kNCHW, int8_out);
+USE_LITE_KERNEL(pool2d, kX86, kInt8, kNCHW, fp32_out);
@@ -13,12 +13,14 @@
 // limitations under the License.
 
 #include "lite/model_parser/flatbuffers/io.h"
+#include <algorithm>
 #include <cstring>
 #include <limits>
 #include <memory>
 #include <utility>
 #include <vector>
 #include "lite/core/model/base/io.h"
+#include "lite/model_parser/flatbuffers/param_codec.h"
 #include "lite/model_parser/flatbuffers/traits.h"
 
 namespace paddle {
@@ -68,6 +70,73 @@ void FillTensor(lite::Tensor* tensor, const ParamDescReadAPI& param) {
   std::memcpy(dst, param.GetData(), param.byte_size());
   tensor->set_persistable(true);
 }
+
+namespace {
+
+// The unowned data of a param in a mapped model file. The mapping is
+// read-only, so the data is copied into an own allocation on the first
+// mutable access, e.g. when a kernel repacks or dequantizes its weights.
+class MappedBuffer : public lite::Buffer {
+ public:
+  MappedBuffer(std::shared_ptr<const char> holder, const void* data, size_t size)
+      : lite::Buffer(const_cast<void*>(data), TARGET(kHost), size),
+        holder_(std::move(holder)) {}
+
+  void ResetLazy(TargetType target, size_t size) override {
+    if (!own_data_) {
+      const void* mapped = data_;
+      const size_t mapped_size = space_;
+      const bool copy = target == TARGET(kHost) || target == TARGET(kX86) ||
+                        target == TARGET(kARM);
+      data_ = nullptr;
+      space_ = 0;
+      own_data_ = true;
+      lite::Buffer::ResetLazy(target, (std::max)(size, mapped_size));
+      if (copy) TargetCopy(TARGET(kHost), data_, mapped, mapped_size);
+      holder_.reset();
+      return;
+    }
+    lite::Buffer::ResetLazy(target, size);
+  }
+
+  void Free() override {
+    if (!own_data_) {
+      data_ = nullptr;
+      space_ = 0;
+      own_data_ = true;
+      holder_.reset();
+      return;
+    }
+    lite::Buffer::Free();
+  }
+
+ private:
+  std::shared_ptr<const char> holder_;
+};
+
+}  // namespace
+
+bool FillTensorInPlace(lite::Tensor* tensor,
+                       const ParamDescReadAPI& param,
+                       const std::shared_ptr<const char>& holder,
+                       const char* end) {
+  CHECK(tensor);
+  const char* data = static_cast<const char*>(param.GetData());
+  const size_t bytes = param.byte_size();
+  // Like TargetMalloc, the data is aligned and readable beyond its end for
+  // the vectorized kernels.
+  if (data == nullptr || bytes == 0 ||
+      reinterpret_cast<uintptr_t>(data) % lite::host::MALLOC_ALIGN != 0 ||
+      data + bytes + lite::host::MALLOC_ALIGN > end) {
+    return false;
+  }
+  tensor->Resize(param.Dim());
+  tensor->set_precision(lite::ConvertPrecisionType(param.GetDataType()));
+  tensor->ResetBuffer(std::make_shared<MappedBuffer>(holder, data, bytes),
+                      bytes);
+  tensor->set_persistable(true);
+  return true;
+}
 #ifdef LITE_WITH_FLATBUFFERS_DESC
 void ParamSerializer::ForwardWrite(const lite::Scope& scope,
                                    const std::set<std::string>& param_names) {
@@ -95,14 +164,27 @@ void ParamSerializer::ForwardWrite(const lite::Scope& scope,
     fbs::ParamDesc param;
     auto& tensor = scope.FindVar(name)->Get<lite::Tensor>();
     FillParam(name, tensor, &param);
+    EncodeParam(tensor, encoding_, &param);
     param.CopyDataToBuffer(buf_.get());
 
     const size_t param_bytes = buf_->size();
     CHECK(param_bytes) << "The bytes size of param can not be zero";
-    constexpr uint32_t offset = sizeof(uint32_t);
+    // Pad the param so that its data is aligned in the file, and can be used
+    // in place when the model file is mapped.
+    const size_t data_offset =
+        static_cast<const char*>(ParamDescView(buf_.get()).GetData()) -
+        static_cast<const char*>(buf_->data());
+    const size_t align = lite::host::MALLOC_ALIGN;
+    const size_t data_pos =
+        writer_->current() + 2 * sizeof(uint32_t) + data_offset;
+    const uint32_t padding = (align - data_pos % align) % align;
+    const uint32_t offset = sizeof(uint32_t) + padding;
     const uint32_t total_size = param_bytes + offset;
     writer_->Write<uint32_t>(total_size);
     writer_->Write<uint32_t>(offset);
+    for (uint32_t j = 0; j < padding; ++j) {
+      writer_->Write<uint8_t>(0U);
+    }
     writer_->Write(buf_->data(), param_bytes);
   }
 }
@@ -115,7 +197,7 @@ void ParamSerializer::WriteHeader() {
 }
 #endif
 
-void ParamDeserializer::ForwardRead(lite::Scope* scope) {
+void ParamDeserializer::ForwardRead(lite::Scope* scope, bool lazy) {
   CHECK(scope) << "The pointer of scope is nullptr";
   uint16_t header_size = reader_->Read<uint16_t>();
   ReadBytesToBuffer(header_size);
@@ -125,15 +207,65 @@ void ParamDeserializer::ForwardRead(lite::Scope* scope) {
       *reinterpret_cast<uint32_t const*>(data + sizeof(uint16_t));
 
   buf_->ResetLazy(max_tensor_size);
+  // The encoded params and the memory holding their data
+  std::vector<std::pair<lite::Tensor*, ParamDescView>> encoded;
+  std::vector<std::shared_ptr<const void>> encoded_data;
   for (size_t i = 0; i < params_size; ++i) {
     uint32_t total_size = reader_->Read<uint32_t>();
     uint32_t offset = reader_->Read<uint32_t>();
     uint32_t param_bytes = total_size - offset;
     ReadBytesToBuffer(offset - sizeof(offset));
-    ReadBytesToBuffer(param_bytes);
+    // Share the data of the params in a mapped file instead of copying it,
+    // the words of the param desc must be aligned to be read in place.
+    auto mapped = reader_->ReadInPlace(param_bytes);
+    if (mapped &&
+        reinterpret_cast<uintptr_t>(mapped.get()) % sizeof(uint32_t) == 0) {
+      fbs::ParamDescView param(mapped.get(), param_bytes);
+      auto* var = scope->Var(param.Name());
+      auto* tensor = var->GetMutable<lite::Tensor>();
+      const char* end =
+          mapped.get() + param_bytes + (reader_->length() - reader_->current());
+      auto load = [mapped, param_bytes, end](lite::Variable* var) {
+        fbs::ParamDescView param(mapped.get(), param_bytes);
+        auto* tensor = var->GetMutable<lite::Tensor>();
+        if (param.encoded()) {
+          DecodeParams({{tensor, param}});
+        } else if (!FillTensorInPlace(tensor, param, mapped, end)) {
+          FillTensor(tensor, param);
+        }
+      };
+      if (lazy) {
+        // Only the dims and the precision are known until the first use.
+        tensor->Resize(param.Dim());
+        tensor->set_precision(lite::ConvertPrecisionType(param.GetDataType()));
+        tensor->set_persistable(true);
+        var->SetLoader(load);
+      } else if (param.encoded()) {
+        encoded.emplace_back(tensor, param);
+        encoded_data.push_back(mapped);
+      } else {
+        load(var);
+      }
+      continue;
+    }
+    if (mapped) {
+      buf_->ResetLazy(param_bytes);
+      model_parser::memcpy(buf_->data(), mapped.get(), param_bytes);
+    } else {
+      ReadBytesToBuffer(param_bytes);
+    }
     fbs::ParamDescView param(buf_.get());
-    FillTensor(scope->Var(param.Name())->GetMutable<lite::Tensor>(), param);
+    auto* tensor = scope->Var(param.Name())->GetMutable<lite::Tensor>();
+    if (param.encoded()) {
+      // keep the data of the param, and read the next ones into a new buffer
+      encoded.emplace_back(tensor, param);
+      encoded_data.emplace_back(buf_.release());
+      buf_.reset(new model_parser::Buffer);
+    } else {
+      FillTensor(tensor, param);
+    }
   }
+  DecodeParams(encoded);
 }
 
 void ParamDeserializer::ReadHeader() {
@@ -18,6 +18,7 @@
 #include <set>
 #include <string>
 #include <vector>
+#include "lite/api/paddle_api.h"
 #include "lite/core/scope.h"
 #include "lite/core/variable.h"
 #include "lite/model_parser/flatbuffers/param_desc.h"
@@ -33,12 +34,26 @@ void FillParam(const std::string& name,
 
 void FillTensor(lite::Tensor* tensor, const ParamDescReadAPI& param);
 
+// Lets the tensor use the data of `param` in place, which is kept alive by
+// `holder` and readable until `end`. The data is copied on the first mutable
+// access. Returns false if the data is not aligned for the kernels.
+bool FillTensorInPlace(lite::Tensor* tensor,
+                       const ParamDescReadAPI& param,
+                       const std::shared_ptr<const char>& holder,
+                       const char* end);
+
 #ifdef LITE_WITH_FLATBUFFERS_DESC
 class ParamSerializer {
  public:
+  // The params are encoded as `encoding`, see param_codec.h.
   explicit ParamSerializer(model_parser::ByteWriter* writer,
-                           uint16_t version = 0)
-      : writer_(writer), version_{version}, buf_(new model_parser::Buffer) {
+                           uint16_t version = 0,
+                           lite_api::ParamEncodingType encoding =
+                               lite_api::ParamEncodingType::kRaw)
+      : writer_(writer),
+        version_{version},
+        encoding_{encoding},
+        buf_(new model_parser::Buffer) {
     CHECK(writer_)
         << "A valid writer should be passed in the ctor of param serializer.";
     WriteHeader();
@@ -50,6 +65,7 @@ class ParamSerializer {
   void WriteHeader();
   model_parser::ByteWriter* writer_{nullptr};
   uint16_t version_{0};
+  lite_api::ParamEncodingType encoding_{lite_api::ParamEncodingType::kRaw};
   std::unique_ptr<model_parser::Buffer> buf_;
 };
 #endif
@@ -62,7 +78,10 @@ class ParamDeserializer {
         << "A valid reader should be passed in the ctor of param deserializer.";
     ReadHeader();
   }
-  void ForwardRead(lite::Scope* scope);
+  // With `lazy`, the params in a mapped file are loaded on their first use,
+  // see Variable::Load. Otherwise the encoded params are decoded in parallel
+  // once all the params are read.
+  void ForwardRead(lite::Scope* scope, bool lazy = false);
 
  private:
   void ReadBytesToBuffer(size_t size) {
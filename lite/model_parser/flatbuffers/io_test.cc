@@ -18,6 +18,7 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include "lite/model_parser/flatbuffers/param_codec.h"
 #include "lite/model_parser/model_parser.h"
 
 namespace paddle {
@@ -128,6 +129,150 @@ TEST(CombinedParamsDesc, Scope) {
     deserializer.ForwardRead(&scope_3);
     check_params(scope_3);
   }
+
+  {
+    Scope scope_4;
+    LOG(INFO) << "Load params from mapped file...";
+    model_parser::MappedFileReader reader(path);
+    fbs::ParamDeserializer deserializer(&reader);
+    deserializer.ForwardRead(&scope_4);
+    check_params(scope_4);
+    // The data is used in place, and copied when it is modified.
+    auto* tensor = scope_4.FindVar(param_names[0])->GetMutable<Tensor>();
+    const void* mapped = tensor->raw_data();
+    CHECK_EQ(reinterpret_cast<uintptr_t>(mapped) % host::MALLOC_ALIGN, 0u);
+    float* data = tensor->mutable_data<float>();
+    CHECK(static_cast<const void*>(data) != mapped);
+    CHECK(TensorCompareWith(*tensor_0, *tensor));
+    data[0] = 1.f;
+    CHECK_EQ(static_cast<const float*>(mapped)[0], tensor_0->data<float>()[0]);
+  }
+
+  {
+    Scope scope_5;
+    LOG(INFO) << "Load params from mapped file lazily...";
+    model_parser::MappedFileReader reader(path);
+    fbs::ParamDeserializer deserializer(&reader);
+    deserializer.ForwardRead(&scope_5, true);
+    // Only the dims and the precision are known before the params are used.
+    for (auto& name : param_names) {
+      auto* var = scope_5.FindVar(name);
+      CHECK(var->loader());
+      CHECK(var->Get<Tensor>().raw_data() == nullptr);
+    }
+    CHECK(scope_5.FindVar(param_names[1])->Get<Tensor>().dims() ==
+          tensor_1->dims());
+    for (auto& name : param_names) {
+      scope_5.FindVar(name)->Load();
+    }
+    check_params(scope_5);
+  }
+}
+
+TEST(ParamCodec, LZ4) {
+  std::vector<std::string> blocks{"", "a", "abcdefghijklmnop"};
+  blocks.emplace_back(1000, 'x');
+  std::string text;
+  for (int i = 0; i < 5000; ++i) {
+    text += std::to_string(i % 37) + ",";
+  }
+  blocks.push_back(text);
+  std::string noise;
+  uint32_t seed = 1;
+  for (int i = 0; i < 70000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    noise.push_back(static_cast<char>(seed >> 16));
+  }
+  blocks.push_back(noise);
+  blocks.push_back(noise + noise);
+  for (auto& block : blocks) {
+    std::vector<char> compressed(lz4::CompressBound(block.size()));
+    size_t size = lz4::Compress(
+        block.data(), block.size(), compressed.data(), compressed.size());
+    ASSERT_GT(size, 0u);
+    std::string out(block.size(), '\0');
+    ASSERT_TRUE(
+        lz4::Decompress(compressed.data(), size, &out[0], block.size()));
+    EXPECT_EQ(out, block);
+    if (!block.empty()) {
+      EXPECT_FALSE(lz4::Decompress(
+          compressed.data(), size, &out[0], block.size() - 1));
+    }
+  }
+  // The repeated data gets smaller.
+  std::vector<char> compressed(lz4::CompressBound(text.size()));
+  EXPECT_LT(
+      lz4::Compress(text.data(), text.size(), compressed.data(), text.size()),
+      text.size() / 4);
+}
+
+TEST(ParamSerializer, Encoding) {
+  const std::string path{"io_test.encoded_params.fbs"};
+  Scope scope;
+  // weights of several blocks, the bias and the int8 param keep their values
+  auto* weight = scope.Var("weight")->GetMutable<Tensor>();
+  weight->Resize({96, 2048});
+  float* weight_data = weight->mutable_data<float>();
+  for (int i = 0; i < weight->numel(); ++i) {
+    weight_data[i] = ((i * 7) % 97 - 48) / 16.f + (i / 2048) * 0.01f;
+  }
+  weight->set_persistable(true);
+  auto* bias = scope.Var("bias")->GetMutable<Tensor>();
+  set_tensor<float>(bias, std::vector<int64_t>({96}));
+  auto* int8_param = scope.Var("int8_param")->GetMutable<Tensor>();
+  set_tensor<int8_t>(int8_param, std::vector<int64_t>({10, 1}));
+  const std::set<std::string> params_set{"weight", "bias", "int8_param"};
+
+  auto check_params = [&](const lite::Scope& scope, float tolerance) {
+    CHECK(TensorCompareWith(*bias, scope.FindVar("bias")->Get<Tensor>()));
+    CHECK(TensorCompareWith(*int8_param,
+                            scope.FindVar("int8_param")->Get<Tensor>()));
+    const auto& loaded = scope.FindVar("weight")->Get<Tensor>();
+    ASSERT_EQ(loaded.dims(), weight->dims());
+    ASSERT_EQ(loaded.precision(), PRECISION(kFloat));
+    for (int i = 0; i < weight->numel(); ++i) {
+      ASSERT_NEAR(loaded.data<float>()[i], weight_data[i], tolerance) << i;
+    }
+  };
+
+  // the tolerance of each encoding, INT8 rounds to a half of its scale
+  const std::vector<std::pair<lite_api::ParamEncodingType, float>> encodings{
+      {lite_api::ParamEncodingType::kLZ4, 0.f},
+      {lite_api::ParamEncodingType::kLZ4FP16, 2e-3f},
+      {lite_api::ParamEncodingType::kLZ4Int8, 3.96f / 127 / 2 + 1e-5f}};
+  for (auto& encoding : encodings) {
+    {
+      model_parser::BinaryFileWriter writer{path};
+      fbs::ParamSerializer serializer{&writer, 0, encoding.first};
+      serializer.ForwardWrite(scope, params_set);
+    }
+    {
+      model_parser::BinaryFileReader reader(path);
+      EXPECT_LT(reader.length(), weight->memory_size() / 2);
+      Scope scope_0;
+      fbs::ParamDeserializer deserializer(&reader);
+      deserializer.ForwardRead(&scope_0);
+      check_params(scope_0, encoding.second);
+    }
+    {
+      Scope scope_1;
+      model_parser::MappedFileReader reader(path);
+      fbs::ParamDeserializer deserializer(&reader);
+      deserializer.ForwardRead(&scope_1);
+      check_params(scope_1, encoding.second);
+    }
+    {
+      Scope scope_2;
+      model_parser::MappedFileReader reader(path);
+      fbs::ParamDeserializer deserializer(&reader);
+      deserializer.ForwardRead(&scope_2, true);
+      CHECK(scope_2.FindVar("weight")->Get<Tensor>().raw_data() == nullptr);
+      for (auto& name : params_set) {
+        scope_2.FindVar(name)->Load();
+      }
+      check_params(scope_2, encoding.second);
+    }
+  }
 }
 #endif  // LITE_WITH_FLATBUFFERS_DESC
 
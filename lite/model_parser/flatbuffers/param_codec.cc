@@ -0,0 +1,474 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/model_parser/flatbuffers/param_codec.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include "lite/core/parallel_defines.h"
+#include "lite/utils/float16.h"
+
+namespace paddle {
+namespace lite {
+namespace fbs {
+
+namespace lz4 {
+
+namespace {
+
+constexpr size_t kMinMatch = 4;
+// The last 5 bytes of a block are literals, and its last match starts 12
+// bytes before the end at least.
+constexpr size_t kLastLiterals = 5;
+constexpr size_t kMatchFindLimit = 12;
+constexpr size_t kMaxOffset = 65535;
+constexpr int kHashLog = 16;
+
+inline uint32_t Read32(const char* p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline uint32_t Hash(uint32_t v) {
+  return (v * 2654435761U) >> (32 - kHashLog);
+}
+
+// the part of a length beyond the 4 bits of the token
+bool WriteLength(size_t len, char** op, const char* oend) {
+  char* p = *op;
+  for (; len >= 255; len -= 255) {
+    if (p >= oend) return false;
+    *p++ = static_cast<char>(255);
+  }
+  if (p >= oend) return false;
+  *p++ = static_cast<char>(len);
+  *op = p;
+  return true;
+}
+
+// A `match_len` of 0 writes the last sequence, which has no match.
+bool WriteSequence(const char* literals,
+                   size_t literal_len,
+                   size_t offset,
+                   size_t match_len,
+                   char** op,
+                   const char* oend) {
+  char* p = *op;
+  if (p >= oend) return false;
+  char* token = p++;
+  const size_t ml = match_len > 0 ? match_len - kMinMatch : 0;
+  *token = static_cast<char>((std::min<size_t>(literal_len, 15) << 4) |
+                             std::min<size_t>(ml, 15));
+  if (literal_len >= 15 && !WriteLength(literal_len - 15, &p, oend)) {
+    return false;
+  }
+  if (static_cast<size_t>(oend - p) < literal_len) return false;
+  std::memcpy(p, literals, literal_len);
+  p += literal_len;
+  if (match_len > 0) {
+    if (oend - p < 2) return false;
+    *p++ = static_cast<char>(offset & 0xff);
+    *p++ = static_cast<char>(offset >> 8);
+    if (ml >= 15 && !WriteLength(ml - 15, &p, oend)) return false;
+  }
+  *op = p;
+  return true;
+}
+
+bool ReadLength(const uint8_t** ip, const uint8_t* iend, size_t* len) {
+  uint8_t b = 0;
+  do {
+    if (*ip >= iend) return false;
+    b = *(*ip)++;
+    *len += b;
+  } while (b == 255);
+  return true;
+}
+
+}  // namespace
+
+size_t Compress(const char* src, size_t size, char* dst, size_t capacity) {
+  CHECK_LE(size, static_cast<size_t>(0x7E000000))
+      << "The block is too large to be compressed.";
+  // positions + 1 of the last 4 bytes of each hash, 0 for none
+  std::vector<uint32_t> table(1 << kHashLog, 0);
+  const char* const oend = dst + capacity;
+  char* op = dst;
+  size_t ip = 0;
+  size_t anchor = 0;
+  if (size > kMatchFindLimit) {
+    const size_t match_limit = size - kMatchFindLimit;
+    const size_t match_end = size - kLastLiterals;
+    size_t misses = 0;
+    while (ip < match_limit) {
+      const uint32_t seq = Read32(src + ip);
+      uint32_t& entry = table[Hash(seq)];
+      const size_t ref = entry;
+      entry = static_cast<uint32_t>(ip + 1);
+      if (ref == 0 || ip + 1 - ref > kMaxOffset ||
+          Read32(src + ref - 1) != seq) {
+        // skip faster over the data without matches
+        ip += 1 + (misses++ >> 6);
+        continue;
+      }
+      misses = 0;
+      size_t match = ref - 1;
+      size_t len = kMinMatch;
+      while (ip > anchor && match > 0 && src[ip - 1] == src[match - 1]) {
+        --ip;
+        --match;
+        ++len;
+      }
+      while (ip + len < match_end && src[ip + len] == src[match + len]) {
+        ++len;
+      }
+      if (!WriteSequence(
+              src + anchor, ip - anchor, ip - match, len, &op, oend)) {
+        return 0;
+      }
+      ip += len;
+      anchor = ip;
+      if (ip - 2 < match_limit) {
+        table[Hash(Read32(src + ip - 2))] = static_cast<uint32_t>(ip - 1);
+      }
+    }
+  }
+  if (!WriteSequence(src + anchor, size - anchor, 0, 0, &op, oend)) {
+    return 0;
+  }
+  return op - dst;
+}
+
+bool Decompress(const char* src, size_t size, char* dst, size_t raw_size) {
+  const uint8_t* ip = reinterpret_cast<const uint8_t*>(src);
+  const uint8_t* const iend = ip + size;
+  char* op = dst;
+  char* const oend = dst + raw_size;
+  while (true) {
+    if (ip >= iend) return false;
+    const uint8_t token = *ip++;
+    size_t literal_len = token >> 4;
+    if (literal_len == 15 && !ReadLength(&ip, iend, &literal_len)) {
+      return false;
+    }
+    if (literal_len > static_cast<size_t>(iend - ip) ||
+        literal_len > static_cast<size_t>(oend - op)) {
+      return false;
+    }
+    std::memcpy(op, ip, literal_len);
+    ip += literal_len;
+    op += literal_len;
+    if (ip == iend) break;
+    if (iend - ip < 2) return false;
+    const size_t offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > static_cast<size_t>(op - dst)) return false;
+    size_t match_len = token & 15;
+    if (match_len == 15 && !ReadLength(&ip, iend, &match_len)) {
+      return false;
+    }
+    match_len += kMinMatch;
+    if (match_len > static_cast<size_t>(oend - op)) return false;
+    // An overlapping match repeats the last `offset` bytes, they are copied
+    // in chunks doubling in size.
+    const char* match = op - offset;
+    for (size_t chunk = offset; match_len > 0; chunk += chunk) {
+      const size_t n = std::min(chunk, match_len);
+      std::memcpy(op, match, n);
+      op += n;
+      match_len -= n;
+    }
+  }
+  return op == oend;
+}
+
+}  // namespace lz4
+
+namespace {
+
+template <typename T>
+T ReadScalar(const char* p) {
+  T v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+}  // namespace
+
+#ifdef LITE_WITH_FLATBUFFERS_DESC
+namespace {
+
+template <typename T>
+void WriteScalar(T v, std::vector<char>* out) {
+  const char* p = reinterpret_cast<const char*>(&v);
+  out->insert(out->end(), p, p + sizeof(v));
+}
+
+// FP16 keeps the finite values of its range only.
+bool StoreFP16(const float* din, int64_t num, std::vector<char>* stored) {
+  stored->resize(num * sizeof(lite::float16));
+  auto* dout = reinterpret_cast<lite::float16*>(stored->data());
+  for (int64_t i = 0; i < num; ++i) {
+    if (!std::isfinite(din[i]) || std::fabs(din[i]) > 65504.f) return false;
+    dout[i] = lite::float16(din[i]);
+  }
+  return true;
+}
+
+// INT8 with the symmetric scale of each slice of the first dim
+bool StoreInt8(const float* din,
+               int64_t rows,
+               int64_t cols,
+               std::vector<char>* stored,
+               std::vector<float>* scales) {
+  stored->resize(rows * cols);
+  scales->resize(rows);
+  auto* dout = reinterpret_cast<int8_t*>(stored->data());
+  for (int64_t r = 0; r < rows; ++r) {
+    const float* row = din + r * cols;
+    float max_abs = 0.f;
+    for (int64_t c = 0; c < cols; ++c) {
+      if (!std::isfinite(row[c])) return false;
+      max_abs = (std::max)(max_abs, std::fabs(row[c]));
+    }
+    const float scale = max_abs / 127.f;
+    const float inv_scale = scale > 0.f ? 1.f / scale : 0.f;
+    for (int64_t c = 0; c < cols; ++c) {
+      const float q = std::round(row[c] * inv_scale);
+      dout[r * cols + c] =
+          static_cast<int8_t>((std::min)((std::max)(q, -127.f), 127.f));
+    }
+    (*scales)[r] = scale;
+  }
+  return true;
+}
+
+}  // namespace
+
+void EncodeParam(const lite::Tensor& tensor,
+                 lite_api::ParamEncodingType encoding,
+                 ParamDesc* param) {
+  CHECK(param);
+  if (encoding == lite_api::ParamEncodingType::kRaw) return;
+  auto storage = proto::ParamDesc_::Storage_RAW;
+  std::vector<char> stored;
+  std::vector<float> scales;
+  const auto& dims = tensor.dims();
+  if (tensor.precision() == PRECISION(kFloat) && dims.size() >= 2 &&
+      tensor.numel() > 0) {
+    const float* din = tensor.data<float>();
+    const int64_t rows = dims[0];
+    const int64_t cols = dims.count(1, dims.size());
+    if (encoding == lite_api::ParamEncodingType::kLZ4FP16 &&
+        StoreFP16(din, tensor.numel(), &stored)) {
+      storage = proto::ParamDesc_::Storage_FP16;
+    } else if (encoding == lite_api::ParamEncodingType::kLZ4Int8 &&
+               StoreInt8(din, rows, cols, &stored, &scales)) {
+      storage = proto::ParamDesc_::Storage_INT8;
+    } else {
+      scales.clear();
+    }
+  }
+  const char* src = static_cast<const char*>(param->GetData());
+  size_t size = param->byte_size();
+  if (storage != proto::ParamDesc_::Storage_RAW) {
+    src = stored.data();
+    size = stored.size();
+  }
+
+  // The blocks are kept compressed if the whole param gets smaller.
+  const size_t block_count = (size + kParamBlockSize - 1) / kParamBlockSize;
+  std::vector<char> frame;
+  WriteScalar<uint32_t>(kParamBlockSize, &frame);
+  WriteScalar<uint32_t>(block_count, &frame);
+  const size_t sizes_pos = frame.size();
+  frame.resize(sizes_pos + block_count * sizeof(uint32_t));
+  std::vector<char> block(lz4::CompressBound(kParamBlockSize));
+  for (size_t i = 0; i < block_count; ++i) {
+    const size_t begin = i * kParamBlockSize;
+    const size_t raw_size = (std::min)(kParamBlockSize, size - begin);
+    size_t block_size =
+        lz4::Compress(src + begin, raw_size, block.data(), raw_size - 1);
+    if (block_size == 0) {
+      block_size = raw_size;
+      frame.insert(frame.end(), src + begin, src + begin + raw_size);
+    } else {
+      frame.insert(frame.end(), block.data(), block.data() + block_size);
+    }
+    const uint32_t block_size32 = static_cast<uint32_t>(block_size);
+    std::memcpy(frame.data() + sizes_pos + i * sizeof(uint32_t),
+                &block_size32,
+                sizeof(block_size32));
+  }
+  auto compression = proto::ParamDesc_::Compression_LZ4;
+  if (frame.size() >= size) {
+    compression = proto::ParamDesc_::Compression_NONE;
+    if (storage == proto::ParamDesc_::Storage_RAW) return;
+    param->SetData(src, size);
+  } else {
+    param->SetData(frame.data(), frame.size());
+  }
+  param->SetEncoding(compression, storage, size, scales);
+}
+#endif  // LITE_WITH_FLATBUFFERS_DESC
+
+ParamDecoder::ParamDecoder(const ParamDescView& param)
+    : storage_(param.GetStorage()), scales_(param.Scales()) {
+  int64_t numel = 1;
+  const auto dims = param.Dim();
+  for (auto dim : dims) {
+    numel *= dim;
+  }
+  byte_size_ = numel * lite_api::PrecisionTypeLength(
+                           lite::ConvertPrecisionType(param.GetDataType()));
+  size_t elem_size = 0;
+  switch (storage_) {
+    case proto::ParamDesc_::Storage_RAW:
+      elem_size = 1;
+      break;
+    case proto::ParamDesc_::Storage_FP16:
+      elem_size = sizeof(lite::float16);
+      break;
+    case proto::ParamDesc_::Storage_INT8:
+      elem_size = sizeof(int8_t);
+      CHECK(!scales_.empty() && numel % scales_.size() == 0)
+          << "The scales of the INT8 param " << param.Name() << " are wrong.";
+      scale_stride_ = numel / scales_.size();
+      break;
+    default:
+      LOG(FATAL) << "Unsupported storage " << static_cast<int>(storage_)
+                 << " of the param " << param.Name();
+  }
+  if (storage_ != proto::ParamDesc_::Storage_RAW) {
+    CHECK(param.GetDataType() == VarDataType::FP32)
+        << "Only FP32 params are stored as FP16 or INT8.";
+    elem_size *= numel;
+  } else {
+    elem_size = byte_size_;
+  }
+  const size_t raw_size = param.raw_size();
+  CHECK_EQ(raw_size, elem_size) << "The size of the param " << param.Name()
+                                << " is not the one of its dims.";
+
+  const char* data = static_cast<const char*>(param.GetData());
+  const size_t size = param.byte_size();
+  if (param.GetCompression() == proto::ParamDesc_::Compression_NONE) {
+    CHECK_EQ(size, raw_size);
+    for (size_t begin = 0; begin < raw_size; begin += kParamBlockSize) {
+      const size_t n = (std::min)(kParamBlockSize, raw_size - begin);
+      blocks_.push_back(Block{data + begin, n, begin, n});
+    }
+    return;
+  }
+  CHECK(param.GetCompression() == proto::ParamDesc_::Compression_LZ4)
+      << "Unsupported compression of the param " << param.Name();
+  CHECK_GE(size, 2 * sizeof(uint32_t));
+  const size_t block_size = ReadScalar<uint32_t>(data);
+  const size_t block_count = ReadScalar<uint32_t>(data + sizeof(uint32_t));
+  CHECK(block_size > 0 && block_size % sizeof(lite::float16) == 0 &&
+        block_count == (raw_size + block_size - 1) / block_size)
+      << "The blocks of the param " << param.Name() << " are broken.";
+  const char* sizes = data + 2 * sizeof(uint32_t);
+  size_t pos = 2 * sizeof(uint32_t) + block_count * sizeof(uint32_t);
+  CHECK_LE(pos, size);
+  for (size_t i = 0; i < block_count; ++i) {
+    const size_t n = ReadScalar<uint32_t>(sizes + i * sizeof(uint32_t));
+    CHECK_LE(n, size - pos) << "The blocks of the param " << param.Name()
+                            << " are broken.";
+    const size_t begin = i * block_size;
+    blocks_.push_back(
+        Block{data + pos, n, begin, (std::min)(block_size, raw_size - begin)});
+    pos += n;
+  }
+}
+
+void ParamDecoder::DecodeBlock(size_t idx, void* dst) const {
+  CHECK_LT(idx, blocks_.size());
+  const Block& block = blocks_[idx];
+  const bool compressed = block.size != block.raw_size;
+  if (storage_ == proto::ParamDesc_::Storage_RAW) {
+    char* out = static_cast<char*>(dst) + block.begin;
+    if (compressed) {
+      CHECK(lz4::Decompress(block.data, block.size, out, block.raw_size))
+          << "The compressed param is broken.";
+    } else {
+      std::memcpy(out, block.data, block.raw_size);
+    }
+    return;
+  }
+  const char* stored = block.data;
+  std::unique_ptr<char[]> buf;
+  if (compressed) {
+    buf.reset(new char[block.raw_size]);
+    CHECK(lz4::Decompress(block.data, block.size, buf.get(), block.raw_size))
+        << "The compressed param is broken.";
+    stored = buf.get();
+  }
+  float* out = static_cast<float*>(dst);
+  if (storage_ == proto::ParamDesc_::Storage_FP16) {
+    const int64_t begin = block.begin / sizeof(lite::float16);
+    const int64_t num = block.raw_size / sizeof(lite::float16);
+    for (int64_t i = 0; i < num; ++i) {
+      lite::float16 v;
+      std::memcpy(&v, stored + i * sizeof(v), sizeof(v));
+      out[begin + i] = static_cast<float>(v);
+    }
+  } else {
+    const int64_t begin = block.begin;
+    const int64_t end = begin + block.raw_size;
+    const auto* q = reinterpret_cast<const int8_t*>(stored);
+    for (int64_t i = begin; i < end;) {
+      const int64_t row = i / scale_stride_;
+      const int64_t row_end = (std::min)(end, (row + 1) * scale_stride_);
+      const float scale = scales_[row];
+      for (; i < row_end; ++i) {
+        out[i] = q[i - begin] * scale;
+      }
+    }
+  }
+}
+
+void DecodeParams(
+    const std::vector<std::pair<lite::Tensor*, ParamDescView>>& params) {
+  // The tensors are allocated before the parallel region.
+  std::vector<std::unique_ptr<ParamDecoder>> decoders;
+  std::vector<void*> dsts;
+  std::vector<std::pair<size_t, size_t>> blocks;
+  for (size_t i = 0; i < params.size(); ++i) {
+    auto* tensor = params[i].first;
+    const auto& param = params[i].second;
+    CHECK(tensor);
+    decoders.emplace_back(new ParamDecoder(param));
+    tensor->Resize(param.Dim());
+    tensor->set_precision(lite::ConvertPrecisionType(param.GetDataType()));
+    tensor->set_persistable(true);
+    dsts.push_back(tensor->mutable_data(decoders[i]->byte_size()));
+    for (size_t j = 0; j < decoders[i]->BlocksSize(); ++j) {
+      blocks.emplace_back(i, j);
+    }
+  }
+  const int blocks_size = static_cast<int>(blocks.size());
+  LITE_PARALLEL_BEGIN(k, tid, blocks_size) {
+    const size_t i = blocks[k].first;
+    decoders[i]->DecodeBlock(blocks[k].second, dsts[i]);
+  }
+  LITE_PARALLEL_END();
+}
+
+}  // namespace fbs
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,97 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "lite/api/paddle_api.h"
+#include "lite/core/tensor.h"
+#include "lite/model_parser/flatbuffers/param_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace fbs {
+
+// The LZ4 block format, see
+// https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+namespace lz4 {
+
+inline size_t CompressBound(size_t size) { return size + size / 255 + 16; }
+
+// Returns the size of the block written into `dst`, or 0 if it does not fit
+// into `capacity` bytes.
+size_t Compress(const char* src, size_t size, char* dst, size_t capacity);
+
+// Returns false if `src` is not a block of `raw_size` bytes.
+bool Decompress(const char* src, size_t size, char* dst, size_t raw_size);
+
+}  // namespace lz4
+
+// The params of the models of meta_version 3 may be encoded, see param.fbs.
+// The stored elements are split into blocks of kParamBlockSize bytes, which
+// are compressed separately so that a large param is decoded by several
+// threads. The data of a compressed param is
+//   uint32 block_size | uint32 block_count | uint32 sizes[block_count] | blocks
+// and a block whose size is the one of its stored bytes is not compressed.
+const size_t kParamBlockSize = 256 * 1024;
+
+#ifdef LITE_WITH_FLATBUFFERS_DESC
+// Encodes the data of `tensor` which FillParam has put into `param`. Only the
+// FP32 weights (two dims at least) are stored as FP16 or INT8, the biases and
+// the other vectors keep their values.
+void EncodeParam(const lite::Tensor& tensor,
+                 lite_api::ParamEncodingType encoding,
+                 ParamDesc* param);
+#endif
+
+// Decodes an encoded param block by block. It refers to the data of the
+// param, which must outlive the decoder.
+class ParamDecoder {
+ public:
+  explicit ParamDecoder(const ParamDescView& param);
+
+  // bytes of the decoded tensor
+  size_t byte_size() const { return byte_size_; }
+
+  size_t BlocksSize() const { return blocks_.size(); }
+
+  // Decodes the block `idx` into `dst`, the data of the whole tensor.
+  void DecodeBlock(size_t idx, void* dst) const;
+
+ private:
+  struct Block {
+    const char* data;
+    size_t size;
+    // the range of the stored bytes
+    size_t begin;
+    size_t raw_size;
+  };
+  std::vector<Block> blocks_;
+  proto::ParamDesc_::Storage storage_{proto::ParamDesc_::Storage_RAW};
+  std::vector<float> scales_;
+  int64_t scale_stride_{1};
+  size_t byte_size_{0};
+};
+
+// Resizes the tensors and decodes the params into them, the blocks of all the
+// params are decoded in parallel.
+void DecodeParams(
+    const std::vector<std::pair<lite::Tensor*, ParamDescView>>& params);
+
+}  // namespace fbs
+}  // namespace lite
+}  // namespace paddle
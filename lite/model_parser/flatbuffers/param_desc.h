@@ -34,12 +34,16 @@ class ParamDescView : public ParamDescReadAPI {
  public:
   explicit ParamDescView(model_parser::Buffer* buf) {
     CHECK(buf) << "The pointer in buf can not be nullptr";
-    flatbuffers::Verifier verifier(static_cast<const uint8_t*>(buf->data()),
-                                   buf->size());
+    Init(buf->data(), buf->size());
+  }
+  // The view of a param in memory not owned by the view, e.g. a mapped file.
+  ParamDescView(const void* data, size_t size) { Init(data, size); }
+  void Init(const void* data, size_t size) {
+    CHECK(data) << "The pointer in data can not be nullptr";
+    flatbuffers::Verifier verifier(static_cast<const uint8_t*>(data), size);
     CHECK(verifier.VerifyBuffer<paddle::lite::fbs::proto::ParamDesc>(nullptr))
         << "Param verification failed.";
-    desc_ =
-        flatbuffers::GetRoot<paddle::lite::fbs::proto::ParamDesc>(buf->data());
+    desc_ = flatbuffers::GetRoot<paddle::lite::fbs::proto::ParamDesc>(data);
     Init();
   }
   explicit ParamDescView(proto::ParamDesc const* desc) : desc_(desc) { Init(); }
@@ -75,6 +79,28 @@ class ParamDescView : public ParamDescReadAPI {
 
   size_t byte_size() const override { return tensor_desc_->data()->size(); }
 
+  // The encoding of the data in the models of meta_version 3, the data of an
+  // encoded param is decoded by ParamDecoder.
+  bool encoded() const {
+    return GetCompression() != proto::ParamDesc_::Compression_NONE ||
+           GetStorage() != proto::ParamDesc_::Storage_RAW;
+  }
+  proto::ParamDesc_::Compression GetCompression() const {
+    return tensor_desc_->compression();
+  }
+  proto::ParamDesc_::Storage GetStorage() const {
+    return tensor_desc_->storage();
+  }
+  uint64_t raw_size() const { return tensor_desc_->raw_size(); }
+  std::vector<float> Scales() const {
+    std::vector<float> scales;
+    if (tensor_desc_->scales()) {
+      scales.assign(tensor_desc_->scales()->begin(),
+                    tensor_desc_->scales()->end());
+    }
+    return scales;
+  }
+
   ParamDescView() = default;
 
  private:
@@ -167,6 +193,17 @@ class ParamDesc : public ParamDescAPI {
     model_parser::memcpy(lod_tensor_->data.data(), data, byte_size);
   }
 
+  // Marks the data set by SetData as encoded, see ParamDescView::encoded.
+  void SetEncoding(proto::ParamDesc_::Compression compression,
+                   proto::ParamDesc_::Storage storage,
+                   uint64_t raw_size,
+                   const std::vector<float>& scales) {
+    lod_tensor_->compression = compression;
+    lod_tensor_->storage = storage;
+    lod_tensor_->raw_size = raw_size;
+    lod_tensor_->scales = scales;
+  }
+
   const proto::ParamDescT* raw_desc() const { return desc_; }
 
   void CopyDataToBuffer(model_parser::Buffer* buffer) {
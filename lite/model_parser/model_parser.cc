@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <fstream>
 #include <limits>
+#include <memory>
 #include <set>
 #include <utility>
 
@@ -499,7 +500,8 @@ void AppendToFile(const std::string &filename,
 /* ---------- Flatbuffers ---------- */
 void SaveModelNaive(const std::string &model_file,
                     const Scope &exec_scope,
-                    const cpp::ProgramDesc &cpp_prog) {
+                    const cpp::ProgramDesc &cpp_prog,
+                    lite_api::ParamEncodingType param_encoding) {
   model_parser::Buffer buffer;
   /* 1. Save model to model.fbs */
   const std::string prog_path = model_file + ".nb";
@@ -514,6 +516,13 @@ void SaveModelNaive(const std::string &model_file,
   if (PADDLE_LITE_EXPERIMENTAL_MODEL != nullptr) {
     meta_version = 1;
   }
+  // The encoded params need meta_version 3, which the former Paddle-Lite
+  // refuses to load.
+  if (param_encoding != lite_api::ParamEncodingType::kRaw) {
+    CHECK_NE(meta_version, 1)
+        << "The params of meta_version 1 can not be encoded.";
+    meta_version = 3;
+  }
   // Save meta_version(uint16) into file
   writer.Write(&meta_version, sizeof(uint16_t));
 
@@ -555,15 +564,16 @@ void SaveModelNaive(const std::string &model_file,
       writer.Write(buffer.data(), buffer.size());
       break;
     }
-    case 2: {
-      fbs::ParamSerializer serializer{&writer};
+    case 2:
+    case 3: {
+      fbs::ParamSerializer serializer{&writer, 0, param_encoding};
       // 3.2 Save params into naive model
       serializer.ForwardWrite(exec_scope, unique_var_names);
       break;
     }
     default: {
       LOG(FATAL) << "Error: Unsupported opt meta_version, "
-                    "meta_version should be set as 1 or 2.";
+                    "meta_version should be set as 1, 2 or 3.";
       break;
     }
   }
@@ -765,7 +775,8 @@ void LoadModelNaiveFromMemory(const std::string &model_buffer,
  * |   5   |  param_data     |   char[]    |                |
  * ----------------------------------------------------------
  *  Meaning of each part:
- *      meta_version: meata_version, 0 default.
+ *      meta_version: meata_version, 0 default. 3 if the params are encoded,
+ *                    see lite/model_parser/flatbuffers/param_codec.h.
  *      opt_version:  lite_version of opt tool that transformed this model.
  *      topo_size:    length of `topo_data`.
  *      topo_data:    contains model's topology data.
@@ -774,13 +785,21 @@ void LoadModelNaiveFromMemory(const std::string &model_buffer,
 
 void LoadModelNaiveFromFile(const std::string &filename,
                             Scope *scope,
-                            cpp::ProgramDesc *cpp_prog) {
+                            cpp::ProgramDesc *cpp_prog,
+                            bool use_mmap,
+                            bool lazy_params) {
   CHECK(cpp_prog);
   CHECK(scope);
   // ModelFile
   const std::string prog_path = filename;
   // Offset
-  model_parser::BinaryFileReader reader(filename, 0);
+  std::unique_ptr<model_parser::ByteReader> reader_ptr;
+  if (use_mmap || lazy_params) {
+    reader_ptr.reset(new model_parser::MappedFileReader(filename));
+  } else {
+    reader_ptr.reset(new model_parser::BinaryFileReader(filename, 0));
+  }
+  auto &reader = *reader_ptr;
 
   // (1)get meta version
   uint16_t meta_version;
@@ -801,7 +820,9 @@ void LoadModelNaiveFromFile(const std::string &filename,
       LoadModelFbsFromFile(&reader, scope, cpp_prog, 1);
       break;
     case 2:
-      LoadModelFbsFromFile(&reader, scope, cpp_prog, 2);
+    case 3:
+      LoadModelFbsFromFile(
+          &reader, scope, cpp_prog, meta_version, lazy_params);
       break;
     default:
       LOG(FATAL) << "The model format cannot be recognized. Please make sure "
@@ -866,10 +887,11 @@ void LoadModelNaiveV0FromFile(const std::string &filename,
   VLOG(4) << "Load naive buffer model in '" << filename << "' successfully";
 }
 #endif  // LITE_ON_TINY_PUBLISH
-void LoadModelFbsFromFile(model_parser::BinaryFileReader *reader,
+void LoadModelFbsFromFile(model_parser::ByteReader *reader,
                           Scope *scope,
                           cpp::ProgramDesc *cpp_prog,
-                          uint16_t meta_version) {
+                          uint16_t meta_version,
+                          bool lazy_params) {
   CHECK(cpp_prog);
   CHECK(scope);
   CHECK_EQ(cpp_prog->BlocksSize(), 0);
@@ -919,10 +941,12 @@ void LoadModelFbsFromFile(model_parser::BinaryFileReader *reader,
       fbs::deprecated::SetScopeWithCombinedParams(scope, params);
       break;
     }
-    case 2: {
-      /* load scope from param.fbs with meta_version=2 */
+    case 2:
+    case 3: {
+      /* load scope from param.fbs with meta_version=2, the params may be
+       * encoded with meta_version=3 */
       fbs::ParamDeserializer deserializer(reader);
-      deserializer.ForwardRead(scope);
+      deserializer.ForwardRead(scope, lazy_params);
       break;
     }
     default:
@@ -958,7 +982,8 @@ void LoadModelNaiveFromMemory(const std::string &model_buffer,
       LoadModelFbsFromMemory(&reader, scope, cpp_prog, 1);
       break;
     case 2:
-      LoadModelFbsFromMemory(&reader, scope, cpp_prog, 2);
+    case 3:
+      LoadModelFbsFromMemory(&reader, scope, cpp_prog, meta_version);
       break;
     default:
       LOG(FATAL) << "The model format cannot be recognized. Please make sure "
@@ -1042,7 +1067,8 @@ void LoadModelFbsFromMemory(model_parser::StringBufferReader *reader,
       fbs::deprecated::SetScopeWithCombinedParams(scope, params);
       break;
     }
-    case 2: {
+    case 2:
+    case 3: {
       fbs::ParamDeserializer deserializer(reader);
       deserializer.ForwardRead(scope);
       break;
@@ -98,9 +98,12 @@ void SaveCombinedParamsNaive(const std::string& path,
                              const lite::Scope& exec_scope,
                              const cpp::ProgramDesc& cpp_prog);
 
+// The params are saved with meta_version 3 if they are encoded.
 void SaveModelNaive(const std::string& model_dir,
                     const Scope& exec_scope,
-                    const cpp::ProgramDesc& cpp_prog);
+                    const cpp::ProgramDesc& cpp_prog,
+                    lite_api::ParamEncodingType param_encoding =
+                        lite_api::ParamEncodingType::kRaw);
 
 void SaveModelFbs(const std::string& model_dir,
                   const Scope& exec_scope,
@@ -139,14 +142,21 @@ void LoadNonCombinedParamsPb(const std::string& model_dir,
                              const lite_api::CxxModelBuffer& model_buffer,
                              Scope* scope);
 #endif  // LITE_ON_TINY_PUBLISH
-void LoadModelFbsFromFile(model_parser::BinaryFileReader* reader,
+void LoadModelFbsFromFile(model_parser::ByteReader* reader,
                           Scope* scope,
                           cpp::ProgramDesc* cpp_prog,
-                          uint16_t meta_version);
+                          uint16_t meta_version,
+                          bool lazy_params = false);
 
+// `use_mmap` maps the model file into memory, and the params of the model in
+// the latest format use their data in the file without copying it.
+// `lazy_params` maps the model file too, and defers loading these params to
+// their first use, see Variable::Load.
 void LoadModelNaiveFromFile(const std::string& filename,
                             lite::Scope* scope,
-                            cpp::ProgramDesc* prog);
+                            cpp::ProgramDesc* prog,
+                            bool use_mmap = false,
+                            bool lazy_params = false);
 
 void LoadModelNaiveFromMemory(const std::string& model_buffer,
                               lite::Scope* scope,
@@ -31,6 +31,8 @@ class ActivationOp : public OpLite {
 
   bool InferShapeImpl() const override;
 
+  bool InferShapeWithCache() const override { return true; }
+
   bool InferType() const { return true; }
 
   bool AttachImpl(const cpp::OpDesc& opdesc, lite::Scope* scope) override;
@@ -88,6 +88,20 @@ bool ConcatOpLite::AttachImpl(const cpp::OpDesc &op_desc, lite::Scope *scope) {
       }
     }
   }
+
+  const OpInfo *op_info = static_cast<const OpInfo *>(&op_desc);
+  if (op_info != nullptr && op_info->HasAttr("enable_int8")) {
+    param_.enable_int8 = op_info->GetAttr<bool>("enable_int8");
+    param_.input_scale.clear();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      std::string scale_name = "X" + to_string(i) + "_scale";
+      if (op_info->HasInputScale(scale_name, true))
+        param_.input_scale.push_back(
+            op_info->GetInputScale(scale_name, true)[0]);
+    }
+    if (op_info->HasOutputScale("Out0_scale", true))
+      param_.output_scale = op_info->GetOutputScale("Out0_scale", true)[0];
+  }
   return true;
 }
 
@@ -129,6 +129,9 @@ bool FcOpLite::AttachImpl(const cpp::OpDesc& op_desc, lite::Scope* scope) {
       param_.output_scale = op_info->GetOutputScale(out_scale_name, true)[0];
   }
 
+  op_info->GetDynamicQuantWeightScale(op_desc.Input("W").front(),
+                                      &param_.weight_scale);
+
 #ifdef LITE_WITH_FPGA
   if (op_info != nullptr && op_info->HasAttr("fpga_static_quant")) {
     param_.enable_int8 = op_info->GetAttr<bool>("fpga_static_quant");
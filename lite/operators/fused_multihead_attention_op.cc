@@ -0,0 +1,81 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/fused_multihead_attention_op.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool FusedMultiheadAttentionOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.q);
+  CHECK_OR_FALSE(param_.k);
+  CHECK_OR_FALSE(param_.v);
+  CHECK_OR_FALSE(param_.out);
+  const auto q_dims = param_.q->dims();
+  const auto k_dims = param_.k->dims();
+  CHECK_GT_OR_FALSE(param_.head_num, 0);
+  CHECK(q_dims.size() == 3 || (q_dims.size() == 2 && !param_.q->lod().empty()))
+      << "Q should be [batch, seq_len, hidden] or [total_len, hidden] with "
+         "LoD, but got "
+      << q_dims;
+  CHECK_EQ_OR_FALSE(k_dims.size(), q_dims.size());
+  CHECK(param_.v->dims() == k_dims) << "K and V should have the same shape";
+  CHECK_EQ_OR_FALSE(q_dims[q_dims.size() - 1], k_dims[k_dims.size() - 1]);
+  CHECK_EQ_OR_FALSE(q_dims[q_dims.size() - 1] % param_.head_num, 0);
+  if (q_dims.size() == 3) {
+    CHECK_EQ_OR_FALSE(q_dims[0], k_dims[0]);
+  } else {
+    CHECK_OR_FALSE(!param_.k->lod().empty());
+    CHECK_EQ_OR_FALSE(param_.q->lod().back().size(),
+                      param_.k->lod().back().size());
+    CHECK(param_.bias_qk == nullptr)
+        << "BiasQK is not supported with the sequences in the LoD";
+  }
+  if (param_.bias_qk) {
+    CHECK_EQ_OR_FALSE(param_.bias_qk->dims().size(), 4UL);
+  }
+  return true;
+}
+
+bool FusedMultiheadAttentionOp::InferShapeImpl() const {
+  param_.out->Resize(param_.q->dims());
+  param_.out->set_lod(param_.q->lod());
+  return true;
+}
+
+bool FusedMultiheadAttentionOp::AttachImpl(const cpp::OpDesc &op_desc,
+                                           lite::Scope *scope) {
+  param_.q = scope->FindTensor(op_desc.Input("Q").front());
+  param_.k = scope->FindTensor(op_desc.Input("K").front());
+  param_.v = scope->FindTensor(op_desc.Input("V").front());
+  if (op_desc.HasInput("BiasQK") && !op_desc.Input("BiasQK").empty()) {
+    param_.bias_qk = scope->FindTensor(op_desc.Input("BiasQK").front());
+  } else {
+    param_.bias_qk = nullptr;
+  }
+  param_.out = scope->FindMutableTensor(op_desc.Output("Out").front());
+  param_.head_num = op_desc.GetAttr<int>("head_num");
+  param_.alpha = op_desc.HasAttr("alpha") ? op_desc.GetAttr<float>("alpha")
+                                          : 1.f;
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(fused_multihead_attention,
+                 paddle::lite::operators::FusedMultiheadAttentionOp);
@@ -0,0 +1,51 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <string>
+#include "lite/core/op_lite.h"
+#include "lite/operators/op_params.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+// softmax(alpha * Q * K^T + BiasQK) * V of every head, computed by one kernel
+// instead of the reshape2/transpose2/matmul/softmax ops of the attention.
+class FusedMultiheadAttentionOp : public OpLite {
+ public:
+  FusedMultiheadAttentionOp() {}
+  explicit FusedMultiheadAttentionOp(const std::string &op_type)
+      : OpLite(op_type) {}
+
+  bool CheckShape() const override;
+
+  bool InferShapeImpl() const override;
+
+  bool InferShapeWithCache() const override { return true; }
+
+  bool AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) override;
+
+  void AttachKernel(KernelBase *kernel) override { kernel->SetParam(param_); }
+  std::string DebugString() const override {
+    return "fused_multihead_attention";
+  }
+
+ private:
+  mutable FusedMultiheadAttentionParam param_;
+};
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
@@ -98,6 +98,16 @@ bool FusionElementwiseActivationOp::AttachImpl(const cpp::OpDesc& opdesc,
   param_.axis = opdesc.GetAttr<int>("axis");
   param_.act_type = opdesc.GetAttr<std::string>("act_type");
 
+  const OpInfo* op_info = static_cast<const OpInfo*>(&opdesc);
+  if (op_info != nullptr && op_info->HasAttr("enable_int8")) {
+    param_.enable_int8 = op_info->GetAttr<bool>("enable_int8");
+    if (op_info->HasInputScale("X0_scale", true))
+      param_.x_input_scale = op_info->GetInputScale("X0_scale", true)[0];
+    if (op_info->HasInputScale("Y0_scale", true))
+      param_.y_input_scale = op_info->GetInputScale("Y0_scale", true)[0];
+    if (op_info->HasOutputScale("Out0_scale", true))
+      param_.output_scale = op_info->GetOutputScale("Out0_scale", true)[0];
+  }
   return true;
 }
 
@@ -69,6 +69,8 @@ bool LookupTableOpLite::AttachImpl(const cpp::OpDesc& op_desc,
   if (op_desc.HasAttr("entry")) {
     param_.entry = op_desc.GetAttr<std::string>("entry");
   }
+  const OpInfo* op_info = static_cast<const OpInfo*>(&op_desc);
+  op_info->GetDynamicQuantWeightScale(input, &param_.weight_scale);
 
   return true;
 }
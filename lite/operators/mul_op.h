@@ -72,6 +72,8 @@ class MulOpLite : public OpLite {
       if (op_info->HasOutputScale(out_scale_name, true))
         param_.output_scale = op_info->GetOutputScale(out_scale_name, true)[0];
     }
+    op_info->GetDynamicQuantWeightScale(op_desc.Input("Y").front(),
+                                        &param_.weight_scale);
 
     return true;
   }
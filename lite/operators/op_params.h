@@ -279,6 +279,10 @@ struct ConcatParam : ParamBase {
   lite::Tensor* output{};
   int axis{0};
   lite::Tensor* axis_tensor{};
+  // for int8, the scale of each input
+  bool enable_int8{false};
+  std::vector<float> input_scale{};
+  float output_scale{1.0f};
 };
 
 /// ----------------------- activation operators ----------------------
@@ -928,6 +932,8 @@ struct LookupTableParam : ParamBase {
   bool is_test{true};
   std::string entry_config{""};  // used in distributed training
   std::string entry{"none"};
+  // the scales of the columns of the int8 or int16 W
+  std::vector<float> weight_scale{};
 };
 
 struct LookupTableDequantParam : ParamBase {
@@ -1349,6 +1355,19 @@ struct MatMulParam : ParamBase {
   WITH_INT8_CONFIG
 };
 
+// Q, K and V of [batch, seq_len, head_num * head_size], or of
+// [total_len, head_num * head_size] with the sequences in the LoD.
+struct FusedMultiheadAttentionParam : ParamBase {
+  const lite::Tensor* q{nullptr};
+  const lite::Tensor* k{nullptr};
+  const lite::Tensor* v{nullptr};
+  // added to the scores, broadcast to [batch, head_num, seq_q, seq_k]
+  const lite::Tensor* bias_qk{nullptr};
+  lite::Tensor* out{nullptr};
+  int head_num{1};
+  float alpha{1.f};
+};
+
 struct GatherNdParam : ParamBase {
   const lite::Tensor* x{nullptr};
   const lite::Tensor* index{nullptr};
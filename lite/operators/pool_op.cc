@@ -35,8 +35,8 @@ bool PoolOpLite::CheckShape() const {
   CHECK_OR_FALSE(x_dims.size() - ksize.size() == 2U);
   // Strides size and pooling size should be the same.
   CHECK_OR_FALSE(ksize.size() == strides.size());
-  // Paddings size must be 4.
-  CHECK_OR_FALSE(paddings.size() == 4L);
+  // Paddings size must be twice the pooling size.
+  CHECK_OR_FALSE(paddings.size() == 2 * ksize.size());
 
   return true;
 }
@@ -100,3 +100,4 @@ bool PoolOpLite::InferShapeImpl() const {
 }  // namespace paddle
 
 REGISTER_LITE_OP(pool2d, paddle::lite::operators::PoolOpLite);
+REGISTER_LITE_OP(pool3d, paddle::lite::operators::PoolOpLite);
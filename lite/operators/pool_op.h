@@ -73,20 +73,30 @@ class PoolOpLite : public OpLite {
       param_.padding_algorithm =
           op_desc.GetAttr<std::string>("padding_algorithm");
     }
-    // 2-pad to 4-pad
-    if (paddings.size() == 2L) {
-      for (size_t i = 0; i < 2L; ++i) {
+    // 2-pad to 4-pad for pool2d, 3-pad to 6-pad for pool3d
+    const size_t pool_dims = param_.ksize.size();
+    if (paddings.size() == pool_dims) {
+      for (size_t i = 0; i < pool_dims; ++i) {
         int copy_pad = *(paddings.begin() + 2 * i);
         paddings.insert(paddings.begin() + 2 * i + 1, copy_pad);
       }
     } else {
-      if (paddings.size() != 4L) {
+      if (paddings.size() != 2 * pool_dims) {
         LOG(FATAL)
             << "Paddings size should be the same or twice as the inputs size.";
       }
     }
     param_.paddings = std::make_shared<std::vector<int>>(paddings);
 
+    const OpInfo *op_info = static_cast<const OpInfo *>(&op_desc);
+    if (op_info != nullptr && op_info->HasAttr("enable_int8")) {
+      param_.enable_int8 = op_info->GetAttr<bool>("enable_int8");
+      if (op_info->HasInputScale("X0_scale", true))
+        param_.input_scale = op_info->GetInputScale("X0_scale", true)[0];
+      if (op_info->HasOutputScale("Out0_scale", true))
+        param_.output_scale = op_info->GetOutputScale("Out0_scale", true)[0];
+    }
+
 #ifdef LITE_WITH_XPU
     if (op_desc.HasAttr("pad_zero")) {
       param_.pad_zero = op_desc.GetAttr<bool>("pad_zero");
@@ -32,7 +32,13 @@ def get_args():
         default='latency_lookup_table.txt',
         help='Output ops latency path.')
     parser.add_argument(
-        '--platform', default='android', help='Platform: android/ios/custom.')
+        '--platform',
+        default='android',
+        help='Platform: android/ios/x86/custom.')
+    parser.add_argument(
+        '--bin_dir',
+        default='.',
+        help='Directory of get_x86_latency on the x86 platform.')
     parser.add_argument('--threads', type=int, default=1, help='Threads.')
     parser.add_argument('--power_mode', type=int, default=0, help='PowerMode.')
     parser.add_argument(
@@ -121,7 +127,26 @@ def get_dev_info():
     return dev_info, core_num, arch_type
 
 
-def get_op_latency(op, platform):
+def get_x86_dev_info():
+    with open('/proc/cpuinfo') as f:
+        lines = f.read().split('\n')
+    model = [_ for _ in lines if _.startswith('model name')]
+    dev_info = model[0].split(':')[1].strip() if model else 'UNKNOWN CPU'
+    core_num = len([_ for _ in lines if _.startswith('processor')])
+    arch_type = ['X86_64'] * min(core_num, 8)
+    return dev_info, core_num, arch_type
+
+
+def parse_latency(out):
+    """Parse the avg, min and max latencies printed by get_*_latency."""
+    res = []
+    for name in ['Avg Latency', 'Min Latency', 'Max Latency']:
+        line = [_ for _ in out.decode().split('\n') if name in _][-1]
+        res.append(float(re.findall(r'\d+\.?\d*', line)[0]))
+    return res
+
+
+def get_op_latency(op, platform, bin_dir='.'):
     """Get model latency.
 
     Args:
@@ -140,18 +165,17 @@ def get_op_latency(op, platform):
             stderr=subprocess.PIPE,
             shell=True)
         out = proc.communicate()[0]
-        avg_out = [_ for _ in out.decode().split('\n')
-                   if 'Avg Latency' in _][-1]
-        avg_out = re.findall(r'\d+\.?\d*', avg_out)[0]
-        avg_out = float(avg_out)
-        min_out = [_ for _ in out.decode().split('\n')
-                   if 'Min Latency' in _][-1]
-        min_out = re.findall(r'\d+\.?\d*', min_out)[0]
-        min_out = float(min_out)
-        max_out = [_ for _ in out.decode().split('\n')
-                   if 'Max Latency' in _][-1]
-        max_out = re.findall(r'\d+\.?\d*', max_out)[0]
-        max_out = float(max_out)
+        avg_out, min_out, max_out = parse_latency(out)
+    elif platform == 'x86':
+        commands = '{}/get_x86_latency {} {}'.format(bin_dir, op[0],
+                                                      ' '.join(op[1:]))
+        proc = subprocess.Popen(
+            commands,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.PIPE,
+            shell=True)
+        out = proc.communicate()[0]
+        avg_out, min_out, max_out = parse_latency(out)
     elif platform == 'ios':
         print('ios platform is not supported now')
         sys.exit()
@@ -164,7 +188,8 @@ def get_op_latency(op, platform):
 
 def main():
     args = get_args()
-    check_dev_connect()
+    if args.platform != 'x86':
+        check_dev_connect()
     conv_param_dict = {
         'ch_out': '1',
         'stride': '[1 1]',
@@ -207,10 +232,15 @@ def main():
         'core1 arch'.ljust(10), 'core2 arch'.ljust(10), 'core3 arch'.ljust(
             10), 'core4 arch'.ljust(10), 'core5 arch'.ljust(
                 10), 'core6 arch'.ljust(10), 'core7 arch'.ljust(10)))
-    dev_info, core_num, arch_type = get_dev_info()
+    if args.platform == 'x86':
+        dev_info, core_num, arch_type = get_x86_dev_info()
+        arch = 'x86_64'
+    else:
+        dev_info, core_num, arch_type = get_dev_info()
+        arch = args.arm_v7_v8
     handle.write('{}\t{}\t{}\t{}'.format(
         dev_info.ljust(30),
-        str(args.arm_v7_v8).ljust(10),
+        str(arch).ljust(10),
         str(core_num).ljust(10),
         str(args.threads).ljust(10), str(args.power_mode).ljust(10)))
     for i in arch_type:
@@ -426,7 +456,7 @@ def main():
             [cur_op_name] + runtime_cmd + [
                 str(args.threads), str(args.power_mode),
                 str(args.warmup_times), str(args.repeats_times)
-            ], args.platform)
+            ], args.platform, args.bin_dir)
 
         param_dict = ''
         for k in cur_param_dict:
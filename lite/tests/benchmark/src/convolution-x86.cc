@@ -0,0 +1,193 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "lite/kernels/x86/conv_compute.h"
+#include "lite/tests/benchmark/src/convolution_configs.h"
+#include "lite/tests/benchmark/src/x86_bench_utils.h"
+
+using paddle::lite::DDim;
+using paddle::lite::Tensor;
+using paddle::lite::bench::X86Threads;
+
+// Benchmarks the x86 conv2d kernel on the layers of convolution_configs.h:
+// the float kernel with each of its implementations (direct, depthwise, gemm
+// on im2col and blas_gemm), a layer an implementation does not support is
+// skipped, and the int8 kernels running gemm_s8u8.
+template <paddle::lite::PrecisionType Ptype,
+          paddle::lite::PrecisionType OutType>
+void bench_conv(benchmark::State& state,
+                int threads,
+                const std::string& implementation) {
+  const int64_t batch_size = state.range(0);
+  const int64_t input_height = state.range(1);
+  const int64_t input_width = state.range(2);
+  const int64_t kernel_height = state.range(3);
+  const int64_t kernel_width = state.range(4);
+  const int64_t padding_height = state.range(5);
+  const int64_t padding_width = state.range(6);
+  const int subsampling = state.range(7);
+  const int dilation = state.range(8);
+  const int64_t groups = state.range(9);
+  const int64_t group_input_channels = state.range(10);
+  const int64_t group_output_channels = state.range(11);
+
+  const int64_t effective_kernel_height = (kernel_height - 1) * dilation + 1;
+  const int64_t effective_kernel_width = (kernel_width - 1) * dilation + 1;
+  const int64_t output_height =
+      (input_height + padding_height - effective_kernel_height) / subsampling +
+      1;
+  const int64_t output_width =
+      (input_width + padding_width - effective_kernel_width) / subsampling + 1;
+  const bool is_int8 = Ptype == PRECISION(kInt8);
+
+  X86Threads x86_threads(threads);
+  Tensor x, filter, bias, output;
+  x.Resize(DDim(
+      {batch_size, groups * group_input_channels, input_height, input_width}));
+  filter.Resize(DDim({groups * group_output_channels,
+                      group_input_channels,
+                      kernel_height,
+                      kernel_width}));
+  bias.Resize(DDim({groups * group_output_channels}));
+  output.Resize(DDim({batch_size,
+                      groups * group_output_channels,
+                      output_height,
+                      output_width}));
+  if (is_int8) {
+    paddle::lite::bench::FillRandom<int8_t>(&x, -127.f, 127.f);
+    paddle::lite::bench::FillRandom<int8_t>(&filter, -127.f, 127.f);
+  } else {
+    paddle::lite::bench::FillRandom<float>(&x);
+    paddle::lite::bench::FillRandom<float>(&filter);
+  }
+  paddle::lite::bench::FillRandom<float>(&bias);
+
+  paddle::lite::operators::ConvParam param;
+  param.x = &x;
+  param.filter = &filter;
+  param.bias = &bias;
+  param.output = &output;
+  const int padding_top = padding_height / 2;
+  const int padding_left = padding_width / 2;
+  param.paddings = std::make_shared<std::vector<int>>(
+      std::vector<int>{padding_top,
+                       static_cast<int>(padding_height - padding_top),
+                       padding_left,
+                       static_cast<int>(padding_width - padding_left)});
+  param.strides = std::vector<int>{subsampling, subsampling};
+  param.dilations =
+      std::make_shared<std::vector<int>>(std::vector<int>{dilation, dilation});
+  param.groups = groups;
+  if (is_int8) {
+    param.enable_int8 = true;
+    param.input_scale = 1.f / 127;
+    param.output_scale = group_input_channels * kernel_height * kernel_width /
+                         127.f / 127.f;
+    param.weight_scale =
+        std::vector<float>(groups * group_output_channels, 1.f / 127);
+  }
+
+  paddle::lite::kernels::x86::Conv2dCompute<Ptype, OutType> conv;
+  conv.SetParam(param);
+  if (!implementation.empty()) {
+    auto impls = conv.Implementations();
+    if (std::find(impls.begin(), impls.end(), implementation) ==
+        impls.end()) {
+      state.SkipWithError("the implementation does not support the layer");
+      return;
+    }
+    conv.set_implementation(implementation);
+  }
+  conv.SetContext(x86_threads.NewContext());
+  conv.PrepareForRun();
+  conv.Launch();
+
+  for (auto _ : state) {
+    conv.Launch();
+  }
+
+  const double flops = 2.0 * batch_size * output_height * output_width *
+                       groups * group_input_channels * group_output_channels *
+                       kernel_height * kernel_width;
+  const double element_size = is_int8 ? 1 : 4;
+  const double out_element_size = OutType == PRECISION(kInt8) ? 1 : 4;
+  const double bytes =
+      (x.numel() + filter.numel()) * element_size + bias.numel() * 4.0 +
+      output.numel() * out_element_size;
+  paddle::lite::bench::ReportRates(state, flops, bytes);
+}
+
+namespace {
+
+struct Network {
+  const char* name;
+  void (*apply)(benchmark::internal::Benchmark*);
+};
+
+const Network kNetworks[] = {{"mobilenet_v1", MobileNetV1},
+                             {"mobilenet_v2", MobileNetV2},
+                             {"mobilenet_v3_large", MobileNetV3Large},
+                             {"shufflenet_v2_x10", ShuffleNetV2X10},
+                             {"squeezenet_v11", SqueezeNetV11},
+                             {"inception_v3", InceptionV3},
+                             {"resnet18", ResNet18},
+                             {"resnet50", ResNet50},
+                             {"vgg", VGG}};
+
+void RegisterAll() {
+  using paddle::lite::bench::RegisterThreaded;
+  const std::vector<std::string> f32_impls = {
+      "direct", "depthwise", "gemm", "blas_gemm"};
+  for (auto& net : kNetworks) {
+    // the implementation the kernel picks by itself
+    RegisterThreaded(std::string("f32_conv/") + net.name,
+                     [](benchmark::State& state, int threads) {
+                       bench_conv<PRECISION(kFloat), PRECISION(kFloat)>(
+                           state, threads, "");
+                     },
+                     net.apply);
+    for (auto& impl : f32_impls) {
+      RegisterThreaded(std::string("f32_conv_") + impl + "/" + net.name,
+                       [impl](benchmark::State& state, int threads) {
+                         bench_conv<PRECISION(kFloat), PRECISION(kFloat)>(
+                             state, threads, impl);
+                       },
+                       net.apply);
+    }
+    RegisterThreaded(std::string("int8_fp32_conv/") + net.name,
+                     [](benchmark::State& state, int threads) {
+                       bench_conv<PRECISION(kInt8), PRECISION(kFloat)>(
+                           state, threads, "");
+                     },
+                     net.apply);
+    RegisterThreaded(std::string("int8_conv/") + net.name,
+                     [](benchmark::State& state, int threads) {
+                       bench_conv<PRECISION(kInt8), PRECISION(kInt8)>(
+                           state, threads, "");
+                     },
+                     net.apply);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  return paddle::lite::bench::RunBenchmarks(argc, argv, RegisterAll);
+}
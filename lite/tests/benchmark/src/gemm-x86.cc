@@ -0,0 +1,152 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "lite/kernels/x86/fc_compute.h"
+#include "lite/kernels/x86/matmul_compute.h"
+#include "lite/tests/benchmark/src/gemm_configs.h"
+#include "lite/tests/benchmark/src/x86_bench_utils.h"
+
+using paddle::lite::DDim;
+using paddle::lite::Tensor;
+using paddle::lite::bench::X86Threads;
+
+// Benchmarks the x86 fc kernels, float and int8 with float output, and the
+// float matmul kernel on the gemm shapes of gemm_configs.h.
+template <paddle::lite::PrecisionType PType>
+void bench_fc(benchmark::State& state, int threads) {
+  const int64_t m = state.range(0);
+  const int64_t n = state.range(1);
+  const int64_t k = state.range(2);
+  const bool is_int8 = PType == PRECISION(kInt8);
+
+  X86Threads x86_threads(threads);
+  Tensor input, w, bias, output;
+  input.Resize(DDim({m, k}));
+  w.Resize(DDim({k, n}));
+  bias.Resize(DDim({n}));
+  output.Resize(DDim({m, n}));
+  if (is_int8) {
+    paddle::lite::bench::FillRandom<int8_t>(&input, -127.f, 127.f);
+    paddle::lite::bench::FillRandom<int8_t>(&w, -127.f, 127.f);
+  } else {
+    paddle::lite::bench::FillRandom<float>(&input);
+    paddle::lite::bench::FillRandom<float>(&w);
+  }
+  paddle::lite::bench::FillRandom<float>(&bias);
+
+  paddle::lite::operators::FcParam param;
+  param.input = &input;
+  param.w = &w;
+  param.bias = &bias;
+  param.output = &output;
+  param.in_num_col_dims = 1;
+  if (is_int8) {
+    param.enable_int8 = true;
+    param.input_scale = 1.f / 127;
+    param.output_scale = 1.f;
+    param.weight_scale = std::vector<float>(1, 1.f / 127);
+  }
+
+  paddle::lite::kernels::x86::FcCompute<PType, PRECISION(kFloat)> fc;
+  fc.SetParam(param);
+  fc.SetContext(x86_threads.NewContext());
+  fc.PrepareForRun();
+  fc.Launch();
+
+  for (auto _ : state) {
+    fc.Launch();
+  }
+
+  const double element_size = is_int8 ? 1 : 4;
+  paddle::lite::bench::ReportRates(
+      state,
+      2.0 * m * n * k,
+      (m * k + k * n) * element_size + (n + m * n) * 4.0);
+}
+
+void bench_matmul(benchmark::State& state, int threads) {
+  const int64_t m = state.range(0);
+  const int64_t n = state.range(1);
+  const int64_t k = state.range(2);
+
+  X86Threads x86_threads(threads);
+  Tensor x, y, out;
+  x.Resize(DDim({m, k}));
+  y.Resize(DDim({k, n}));
+  out.Resize(DDim({m, n}));
+  paddle::lite::bench::FillRandom<float>(&x);
+  paddle::lite::bench::FillRandom<float>(&y);
+  out.mutable_data<float>();
+
+  paddle::lite::operators::MatMulParam param;
+  param.X = &x;
+  param.Y = &y;
+  param.Out = &out;
+
+  paddle::lite::kernels::x86::MatMulCompute<float> matmul;
+  matmul.SetParam(param);
+  matmul.SetContext(x86_threads.NewContext());
+  matmul.PrepareForRun();
+  matmul.Launch();
+
+  for (auto _ : state) {
+    matmul.Launch();
+  }
+
+  paddle::lite::bench::ReportRates(
+      state, 2.0 * m * n * k, (m * k + k * n + m * n) * 4.0);
+}
+
+namespace {
+
+struct Network {
+  const char* name;
+  void (*apply)(benchmark::internal::Benchmark*);
+};
+
+const Network kNetworks[] = {
+    {"mobilenet_v1", MobileNetV1GemmArguments},
+    {"mobilenet_v2", MobileNetV2GemmArguments},
+    {"mobilenet_v3_large", MobileNetV3LargeGemmArguments},
+    {"shufflenet_v2_x10", ShuffleNetV2X10GemmArguments},
+    {"squeezenet_v11", SqueezeNetV11GemmArguments},
+    {"inception_v3", InceptionV3GemmArguments},
+    {"resnet18", ResNet18GemmArguments},
+    {"resnet50", ResNet50GemmArguments},
+    {"vgg", VGGGemmArguments}};
+
+void RegisterAll() {
+  using paddle::lite::bench::RegisterThreaded;
+  for (auto& net : kNetworks) {
+    RegisterThreaded(std::string("f32_fc/") + net.name,
+                     bench_fc<PRECISION(kFloat)>,
+                     net.apply);
+    RegisterThreaded(std::string("int8_fp32_fc/") + net.name,
+                     bench_fc<PRECISION(kInt8)>,
+                     net.apply);
+    RegisterThreaded(
+        std::string("f32_matmul/") + net.name, bench_matmul, net.apply);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  return paddle::lite::bench::RunBenchmarks(argc, argv, RegisterAll);
+}
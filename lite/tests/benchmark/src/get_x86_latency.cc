@@ -0,0 +1,520 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/backends/x86/parallel.h"
+#include "lite/core/context.h"
+#include "lite/core/profile/timer.h"
+#include "lite/core/tensor.h"
+#include "lite/kernels/x86/activation_compute.h"
+#include "lite/kernels/x86/batch_norm_compute.h"
+#include "lite/kernels/x86/conv_compute.h"
+#include "lite/kernels/x86/fc_compute.h"
+#include "lite/kernels/x86/pool_compute.h"
+#include "lite/operators/op_params.h"
+#include "lite/tests/utils/tensor_utils.h"
+#ifdef LITE_USE_THREAD_POOL
+#include "lite/core/thread_pool.h"
+#endif
+
+// The x86 counterpart of get_{conv,fc,batchnorm,pooling,activation}_latency:
+// `get_x86_latency <op> <the arguments of get_<op>_latency>` prints the
+// latencies of the x86 kernel of the op in the same format, the power_mode
+// argument is ignored. get_latency_lookup_table.py runs it for the x86
+// platform.
+
+typedef paddle::lite::Tensor Tensor;
+typedef paddle::lite::DDim DDim;
+using paddle::lite::profile::Timer;
+using paddle::lite_api::PrecisionType;
+namespace x86_kernels = paddle::lite::kernels::x86;
+
+// Runs `kernel` on `thread_num` threads and prints its latencies.
+template <typename Kernel, typename Param>
+void measure(const Param& param,
+             const int thread_num,
+             const int warmup,
+             const int repeats) {
+  paddle::lite::x86::SetNumThreads(thread_num);
+  auto ctx = paddle::lite::ContextScheduler::Global().NewContext(TARGET(kX86));
+#ifdef LITE_USE_THREAD_POOL
+  auto pool = paddle::lite::ThreadPool::Create("", thread_num, {});
+  paddle::lite::ThreadPool::ScopedPool pool_guard(pool.get());
+  ctx->SetThreadPool(pool);
+#endif
+  Kernel kernel;
+  kernel.SetParam(param);
+  kernel.SetContext(std::move(ctx));
+  kernel.PrepareForRun();
+  // warm up
+  for (int i = 0; i < warmup; ++i) {
+    kernel.Launch();
+  }
+  // compute
+  Timer t0;
+  for (int i = 0; i < repeats; ++i) {
+    t0.Start();
+    kernel.Launch();
+    t0.Stop();
+  }
+  printf("Avg Latency is %f\n", t0.LapTimes().Avg());
+  printf("Min Latency is %f\n", t0.LapTimes().Min());
+  printf("Max Latency is %f\n", t0.LapTimes().Max());
+}
+
+template <PrecisionType Ptype, PrecisionType OutType>
+void test_conv(const DDim& input_dims,
+               const DDim& weight_dims,
+               const int group,
+               const std::vector<int>& strides,
+               const std::vector<int>& pads,
+               const std::vector<int>& dilas,
+               const bool flag_bias,
+               const int flag_act,
+               const int thread_num,
+               const int warmup,
+               const int repeats) {
+  paddle::lite::operators::ConvParam param;
+  Tensor x, f, y, bias;
+  x.set_precision(Ptype);
+  x.Resize(input_dims);
+  f.set_precision(Ptype);
+  f.Resize(weight_dims);
+  param.x = &x;
+  param.filter = &f;
+  if (flag_bias) {
+    bias.set_precision(PRECISION(kFloat));
+    bias.Resize({weight_dims[0]});
+    paddle::lite::fill_tensor_rand(bias, -1.f, 1.f);
+    param.bias = &bias;
+  }
+  param.strides = strides;
+  param.paddings = std::make_shared<std::vector<int>>(pads);
+  param.dilations = std::make_shared<std::vector<int>>(dilas);
+  param.groups = group;
+  if (Ptype == PRECISION(kInt8)) {
+    param.enable_int8 = true;
+    param.input_scale = 1.f / 127;
+    param.output_scale = weight_dims.count(1, 4) / 127.f;
+    param.weight_scale = std::vector<float>(weight_dims[0], 1.f / 127);
+  }
+  if (flag_act > 0) {
+    // 1-relu, 2-relu6, 4-leakyrelu
+    param.activation_param.has_active = true;
+    param.activation_param.active_type =
+        static_cast<paddle::lite_api::ActivationType>(flag_act);
+    param.activation_param.Relu_clipped_coef = 6.f;
+    param.activation_param.Leaky_relu_alpha = 0.1f;
+    param.fuse_relu = flag_act == 1;
+  }
+
+  std::vector<int64_t> out_shape = {
+      input_dims[0], weight_dims[0], input_dims[2], input_dims[3]};
+  for (int i = 0; i < 2; ++i) {
+    int64_t kernel_exten = dilas[i] * (weight_dims[i + 2] - 1) + 1;
+    out_shape[i + 2] =
+        (input_dims[i + 2] + pads[2 * i] + pads[2 * i + 1] - kernel_exten) /
+            strides[i] +
+        1;
+  }
+  y.set_precision(OutType);
+  y.Resize(out_shape);
+  param.output = &y;
+  paddle::lite::fill_tensor_rand(f, -1.f, 1.f);
+  paddle::lite::fill_tensor_rand(x, -1.f, 1.f);
+
+  measure<x86_kernels::Conv2dCompute<Ptype, OutType>>(
+      param, thread_num, warmup, repeats);
+}
+
+int conv_latency(int argc, char** argv) {
+  if (argc != 23) {
+    std::cerr << "usage: " << argv[0] << " conv\n"
+              << "  <batch_size>\n"
+              << "  <input_channel>\n"
+              << "  <input_height>\n"
+              << "  <input_width>\n"
+              << "  <output_channel>\n"
+              << "  <group_size>\n"
+              << "  <kernel_size>\n"
+              << "  <pad_top>\n"
+              << "  <pad_bottom>\n"
+              << "  <pad_left>\n"
+              << "  <pad_right>\n"
+              << "  <stride_h>\n"
+              << "  <stride_w>\n"
+              << "  <dilation_h>\n"
+              << "  <dilation_w>\n"
+              << "  <flag_bias>\n"
+              << "  <flag_act>\n"
+              << "  <dtype>\n"
+              << "  <thread_num>\n"
+              << "  <power_mode>\n"
+              << "  <warmup_times>\n"
+              << "  <repeats_times>\n"
+              << std::endl;
+    return 0;
+  }
+  int batch_size = atoi(argv[1]);
+  int input_channel = atoi(argv[2]);
+  int input_height = atoi(argv[3]);
+  int input_width = atoi(argv[4]);
+  int output_channel = atoi(argv[5]);
+  int group_size = atoi(argv[6]);
+  int kernel_size = atoi(argv[7]);
+  std::vector<int> pads = {
+      atoi(argv[8]), atoi(argv[9]), atoi(argv[10]), atoi(argv[11])};
+  std::vector<int> strides = {atoi(argv[12]), atoi(argv[13])};
+  std::vector<int> dilas = {atoi(argv[14]), atoi(argv[15])};
+  bool flag_bias = atoi(argv[16]) != 0;
+  int flag_act = atoi(argv[17]);
+  int dtype = atoi(argv[18]);
+  int thread_num = atoi(argv[19]);
+  int warmup = atoi(argv[21]);
+  int repeats = atoi(argv[22]);
+
+  DDim weight_dims(
+      {output_channel, input_channel / group_size, kernel_size, kernel_size});
+  DDim input_dims({batch_size, input_channel, input_height, input_width});
+  switch (dtype) {
+    case 1:
+      test_conv<PRECISION(kInt8), PRECISION(kFloat)>(input_dims,
+                                                      weight_dims,
+                                                      group_size,
+                                                      strides,
+                                                      pads,
+                                                      dilas,
+                                                      flag_bias,
+                                                      flag_act,
+                                                      thread_num,
+                                                      warmup,
+                                                      repeats);
+      break;
+    case 2:
+      test_conv<PRECISION(kInt8), PRECISION(kInt8)>(input_dims,
+                                                     weight_dims,
+                                                     group_size,
+                                                     strides,
+                                                     pads,
+                                                     dilas,
+                                                     flag_bias,
+                                                     flag_act,
+                                                     thread_num,
+                                                     warmup,
+                                                     repeats);
+      break;
+    default:
+      test_conv<PRECISION(kFloat), PRECISION(kFloat)>(input_dims,
+                                                       weight_dims,
+                                                       group_size,
+                                                       strides,
+                                                       pads,
+                                                       dilas,
+                                                       flag_bias,
+                                                       flag_act,
+                                                       thread_num,
+                                                       warmup,
+                                                       repeats);
+  }
+  return 0;
+}
+
+template <PrecisionType Ptype>
+void test_fc(const int m,
+             const int n,
+             const int k,
+             const bool has_bias,
+             const int thread_num,
+             const int warmup,
+             const int repeats) {
+  paddle::lite::operators::FcParam param;
+  Tensor x, w, bias, y;
+  x.set_precision(Ptype);
+  x.Resize({m, k});
+  w.set_precision(Ptype);
+  w.Resize({k, n});
+  y.set_precision(PRECISION(kFloat));
+  y.Resize({m, n});
+  paddle::lite::fill_tensor_rand(x, -1.f, 1.f);
+  paddle::lite::fill_tensor_rand(w, -1.f, 1.f);
+  param.input = &x;
+  param.w = &w;
+  param.output = &y;
+  param.in_num_col_dims = 1;
+  if (has_bias) {
+    bias.set_precision(PRECISION(kFloat));
+    bias.Resize({n});
+    paddle::lite::fill_tensor_rand(bias, -1.f, 1.f);
+    param.bias = &bias;
+  }
+  if (Ptype == PRECISION(kInt8)) {
+    param.enable_int8 = true;
+    param.input_scale = 1.f / 127;
+    param.output_scale = 1.f;
+    param.weight_scale = std::vector<float>(1, 1.f / 127);
+  }
+  measure<x86_kernels::FcCompute<Ptype, PRECISION(kFloat)>>(
+      param, thread_num, warmup, repeats);
+}
+
+int fc_latency(int argc, char** argv) {
+  if (argc != 10) {
+    std::cerr << "usage: " << argv[0] << " fc\n"
+              << " <m>\n"
+              << " <n>\n"
+              << " <k>\n"
+              << " <has_bias>\n"
+              << " <dtype>\n"
+              << " <thread_num>\n"
+              << " <power_mode>\n"
+              << " <warmup_times>\n"
+              << " <repeats_times>\n"
+              << std::endl;
+    return 0;
+  }
+  int m = atoi(argv[1]);
+  int n = atoi(argv[2]);
+  int k = atoi(argv[3]);
+  bool has_bias = atoi(argv[4]) != 0;
+  bool int8 = strcmp(argv[5], "int8_float") == 0;
+  int thread_num = atoi(argv[6]);
+  int warmup = atoi(argv[8]);
+  int repeats = atoi(argv[9]);
+  if (int8) {
+    test_fc<PRECISION(kInt8)>(m, n, k, has_bias, thread_num, warmup, repeats);
+  } else {
+    test_fc<PRECISION(kFloat)>(m, n, k, has_bias, thread_num, warmup, repeats);
+  }
+  return 0;
+}
+
+int batchnorm_latency(int argc, char** argv) {
+  if (argc != 11) {
+    std::cerr << "usage: " << argv[0] << " batchnorm\n"
+              << "  <batch_size>\n"
+              << "  <input_channel>\n"
+              << "  <input_height>\n"
+              << "  <input_width>\n"
+              << "  <epsilon>\n"
+              << "  <momentum>\n"
+              << "  <thread_num>\n"
+              << "  <power_mode>\n"
+              << "  <warmup_times>\n"
+              << "  <repeats_times>\n"
+              << std::endl;
+    return 0;
+  }
+  int batch_size = atoi(argv[1]);
+  int input_channel = atoi(argv[2]);
+  int input_height = atoi(argv[3]);
+  int input_width = atoi(argv[4]);
+  float epsilon = atof(argv[5]);
+  float momentum = atof(argv[6]);
+  int thread_num = atoi(argv[7]);
+  int warmup = atoi(argv[9]);
+  int repeats = atoi(argv[10]);
+
+  Tensor x, scale, bias, mean, variance, y;
+  x.Resize({batch_size, input_channel, input_height, input_width});
+  y.Resize({batch_size, input_channel, input_height, input_width});
+  for (auto* t : {&scale, &bias, &mean, &variance}) {
+    t->Resize({input_channel});
+  }
+  for (auto* t : {&x, &scale, &bias, &mean}) {
+    paddle::lite::fill_tensor_rand(*t, -1.f, 1.f);
+  }
+  paddle::lite::fill_tensor_rand(variance, 0.5f, 1.5f);
+
+  paddle::lite::operators::BatchNormParam param;
+  param.x = &x;
+  param.scale = &scale;
+  param.bias = &bias;
+  param.mean = &mean;
+  param.variance = &variance;
+  param.y = &y;
+  param.is_test = true;
+  param.use_global_stats = true;
+  param.epsilon = epsilon;
+  param.momentum = momentum;
+  param.data_layout = DATALAYOUT(kNCHW);
+  measure<x86_kernels::BatchNormCompute<float>>(
+      param, thread_num, warmup, repeats);
+  return 0;
+}
+
+int pooling_latency(int argc, char** argv) {
+  if (argc != 20) {
+    std::cerr << "usage: " << argv[0] << " pooling\n"
+              << "  <batch_size>\n"
+              << "  <input_channel>\n"
+              << "  <input_height>\n"
+              << "  <input_width>\n"
+              << "  <stride_h>\n"
+              << "  <stride_w>\n"
+              << "  <pad_top>\n"
+              << "  <pad_bottom>\n"
+              << "  <pad_left>\n"
+              << "  <pad_right>\n"
+              << "  <kernel_size>\n"
+              << "  <ceil_mode>\n"
+              << "  <flag_global>\n"
+              << "  <exclusive>\n"
+              << "  <pooling_type>\n"
+              << "  <thread_num>\n"
+              << "  <power_mode>\n"
+              << "  <warmup_times>\n"
+              << "  <repeats_times>\n"
+              << std::endl;
+    return 0;
+  }
+  int batch_size = atoi(argv[1]);
+  int input_channel = atoi(argv[2]);
+  int input_height = atoi(argv[3]);
+  int input_width = atoi(argv[4]);
+  int stride_h = atoi(argv[5]);
+  int stride_w = atoi(argv[6]);
+  std::vector<int> pads = {
+      atoi(argv[7]), atoi(argv[8]), atoi(argv[9]), atoi(argv[10])};
+  int kernel_size = atoi(argv[11]);
+  bool ceil_mode = atoi(argv[12]) != 0;
+  bool flag_global = atoi(argv[13]) != 0;
+  bool exclusive = atoi(argv[14]) != 0;
+  std::string pooling_type = atoi(argv[15]) == 0 ? "max" : "avg";
+  int thread_num = atoi(argv[16]);
+  int warmup = atoi(argv[18]);
+  int repeats = atoi(argv[19]);
+
+  int64_t hout = 1;
+  int64_t wout = 1;
+  if (!flag_global) {
+    int ceil_h = ceil_mode ? stride_h - 1 : 0;
+    int ceil_w = ceil_mode ? stride_w - 1 : 0;
+    hout = (input_height - kernel_size + pads[0] + pads[1] + ceil_h) /
+               stride_h +
+           1;
+    wout =
+        (input_width - kernel_size + pads[2] + pads[3] + ceil_w) / stride_w +
+        1;
+  }
+  Tensor x, y;
+  x.Resize({batch_size, input_channel, input_height, input_width});
+  y.Resize({batch_size, input_channel, hout, wout});
+  paddle::lite::fill_tensor_rand(x, -1.f, 1.f);
+
+  paddle::lite::operators::PoolParam param;
+  param.x = &x;
+  param.output = &y;
+  param.ksize = {kernel_size, kernel_size};
+  param.strides = {stride_h, stride_w};
+  param.paddings = std::make_shared<std::vector<int>>(pads);
+  param.ceil_mode = ceil_mode;
+  param.global_pooling = flag_global;
+  param.pooling_type = pooling_type;
+  param.exclusive = exclusive;
+  measure<x86_kernels::PoolCompute<float>>(param, thread_num, warmup, repeats);
+  return 0;
+}
+
+int activation_latency(int argc, char** argv) {
+  if (argc != 10) {
+    std::cerr << "usage: " << argv[0] << " activation\n"
+              << "  <batch_size>\n"
+              << "  <input_channel>\n"
+              << "  <input_height>\n"
+              << "  <input_width>\n"
+              << "  <act_type>\n"
+              << "  <thread_num>\n"
+              << "  <power_mode>\n"
+              << "  <warmup_times>\n"
+              << "  <repeats_times>" << std::endl;
+    return 0;
+  }
+  int batch_size = atoi(argv[1]);
+  int input_channel = atoi(argv[2]);
+  int input_height = atoi(argv[3]);
+  int input_width = atoi(argv[4]);
+  int act_type = atoi(argv[5]);
+  int thread_num = atoi(argv[6]);
+  int warmup = atoi(argv[8]);
+  int repeats = atoi(argv[9]);
+
+  Tensor x, y;
+  x.Resize({batch_size, input_channel, input_height, input_width});
+  y.Resize({batch_size, input_channel, input_height, input_width});
+  paddle::lite::fill_tensor_rand(x, -1.f, 1.f);
+  paddle::lite::operators::ActivationParam param;
+  param.X = &x;
+  param.Out = &y;
+  param.has_active = true;
+  param.active_type = static_cast<paddle::lite_api::ActivationType>(act_type);
+  param.Relu_clipped_coef = 6.f;
+  param.threshold = 6.f;
+  param.Leaky_relu_alpha = 0.1f;
+
+  switch (act_type) {
+    case 1:
+      measure<x86_kernels::ReluCompute<float>>(
+          param, thread_num, warmup, repeats);
+      break;
+    case 2:
+      measure<x86_kernels::Relu6Compute<float>>(
+          param, thread_num, warmup, repeats);
+      break;
+    case 4:
+      measure<x86_kernels::LeakyReluCompute<float>>(
+          param, thread_num, warmup, repeats);
+      break;
+    case 5:
+      measure<x86_kernels::SigmoidCompute<float>>(
+          param, thread_num, warmup, repeats);
+      break;
+    case 6:
+      measure<x86_kernels::TanhCompute<float>>(
+          param, thread_num, warmup, repeats);
+      break;
+    case 10:
+      measure<x86_kernels::HardSwishComputeCompute<float>>(
+          param, thread_num, warmup, repeats);
+      break;
+    default:
+      std::cerr << "act_type " << act_type << " has no x86 kernel"
+                << std::endl;
+      return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0]
+              << " <conv|fc|batchnorm|pooling|activation> <arguments>"
+              << std::endl;
+    return 0;
+  }
+  std::string op = argv[1];
+  // the arguments of the op start at argv[1]
+  argv[1] = argv[0];
+  if (op == "conv") return conv_latency(argc - 1, argv + 1);
+  if (op == "fc") return fc_latency(argc - 1, argv + 1);
+  if (op == "batchnorm") return batchnorm_latency(argc - 1, argv + 1);
+  if (op == "pooling") return pooling_latency(argc - 1, argv + 1);
+  if (op == "activation") return activation_latency(argc - 1, argv + 1);
+  std::cerr << "unknown op " << op << std::endl;
+  return 1;
+}
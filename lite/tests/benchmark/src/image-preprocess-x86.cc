@@ -0,0 +1,222 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "lite/tests/benchmark/src/x86_bench_utils.h"
+#include "lite/utils/cv/image2tensor_fused.h"
+#include "lite/utils/cv/x86/image_x86.h"
+
+// Benchmarks the x86 image preprocess of lite/utils/cv: every op runs the
+// plain C++ rows (scalar) and the SSE4.1/AVX2 ones (simd), and
+// resize_to_tensor compares image_resize + image_convert + image_to_tensor
+// with the fused Image2TensorFused.
+
+namespace cv = paddle::lite::utils::cv;
+using paddle::lite::bench::X86Threads;
+
+namespace {
+
+std::vector<uint8_t> RandomImage(int64_t size) {
+  std::mt19937 rng(size);
+  std::uniform_int_distribution<int> dist(0, 255);
+  std::vector<uint8_t> res(size);
+  for (auto& v : res) v = static_cast<uint8_t>(dist(rng));
+  return res;
+}
+
+const float kMeans[3] = {103.94f, 116.78f, 123.68f};
+const float kScales[3] = {0.017f, 0.017f, 0.017f};
+
+}  // namespace
+
+// a camera frame to the input of a classification or a detection model
+static void ImageArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"srcw", "srch", "dstw", "dsth", "simd"});
+  for (int simd : {0, 1}) {
+    b->Args({1920, 1080, 224, 224, simd});
+    b->Args({1280, 720, 608, 608, simd});
+    b->Args({640, 480, 320, 240, simd});
+  }
+}
+
+static void bench_convert(benchmark::State& state, int threads) {
+  const int w = state.range(0);
+  const int h = state.range(1);
+  const bool simd = state.range(4) != 0;
+  X86Threads x86_threads(threads);
+  auto src = RandomImage(w * h * 3 / 2);
+  std::vector<uint8_t> dst(w * h * 3);
+  for (auto _ : state) {
+    cv::x86::image_convert(
+        src.data(), dst.data(), cv::NV21, cv::BGR, w, h, simd);
+    benchmark::ClobberMemory();
+  }
+  paddle::lite::bench::ReportRates(state, 0, src.size() + dst.size());
+}
+
+static void bench_resize(benchmark::State& state, int threads) {
+  const int srcw = state.range(0);
+  const int srch = state.range(1);
+  const int dstw = state.range(2);
+  const int dsth = state.range(3);
+  const bool simd = state.range(4) != 0;
+  X86Threads x86_threads(threads);
+  auto src = RandomImage(srcw * srch * 3);
+  std::vector<uint8_t> dst(dstw * dsth * 3);
+  for (auto _ : state) {
+    cv::x86::image_resize(
+        src.data(), dst.data(), cv::BGR, srcw, srch, dstw, dsth, simd);
+    benchmark::ClobberMemory();
+  }
+  paddle::lite::bench::ReportRates(state, 0, src.size() + dst.size());
+}
+
+static void bench_to_tensor(benchmark::State& state, int threads) {
+  const int w = state.range(2);
+  const int h = state.range(3);
+  const bool simd = state.range(4) != 0;
+  X86Threads x86_threads(threads);
+  auto src = RandomImage(w * h * 3);
+  std::vector<float> dst(w * h * 3);
+  for (auto _ : state) {
+    cv::x86::image_to_tensor(src.data(),
+                             dst.data(),
+                             cv::BGR,
+                             paddle::lite_api::DataLayoutType::kNCHW,
+                             w,
+                             h,
+                             kMeans,
+                             kScales,
+                             simd);
+    benchmark::ClobberMemory();
+  }
+  paddle::lite::bench::ReportRates(
+      state, 2.0 * dst.size(), src.size() + dst.size() * sizeof(float));
+}
+
+static void bench_flip(benchmark::State& state, int threads) {
+  const int w = state.range(0);
+  const int h = state.range(1);
+  const bool simd = state.range(4) != 0;
+  X86Threads x86_threads(threads);
+  auto src = RandomImage(w * h * 3);
+  std::vector<uint8_t> dst(src.size());
+  for (auto _ : state) {
+    cv::x86::image_flip(src.data(), dst.data(), 3, w, h, cv::XY, simd);
+    benchmark::ClobberMemory();
+  }
+  paddle::lite::bench::ReportRates(state, 0, 2.0 * src.size());
+}
+
+static void bench_rotate(benchmark::State& state, int threads) {
+  const int w = state.range(0);
+  const int h = state.range(1);
+  const bool simd = state.range(4) != 0;
+  X86Threads x86_threads(threads);
+  // the tiles transpose 1 and 4 byte pixels
+  auto src = RandomImage(w * h * 4);
+  std::vector<uint8_t> dst(src.size());
+  for (auto _ : state) {
+    cv::x86::image_rotate(src.data(), dst.data(), 4, w, h, 90, simd);
+    benchmark::ClobberMemory();
+  }
+  paddle::lite::bench::ReportRates(state, 0, 2.0 * src.size());
+}
+
+// nv21 to a bgr nchw tensor, the three passes over the temporary images
+static void bench_resize_to_tensor_sequential(benchmark::State& state,
+                                              int threads) {
+  const int srcw = state.range(0);
+  const int srch = state.range(1);
+  const int dstw = state.range(2);
+  const int dsth = state.range(3);
+  const bool simd = state.range(4) != 0;
+  X86Threads x86_threads(threads);
+  auto src = RandomImage(srcw * srch * 3 / 2);
+  std::vector<uint8_t> resized(dstw * dsth * 3 / 2);
+  std::vector<uint8_t> bgr(dstw * dsth * 3);
+  std::vector<float> dst(dstw * dsth * 3);
+  for (auto _ : state) {
+    cv::x86::image_resize(
+        src.data(), resized.data(), cv::NV21, srcw, srch, dstw, dsth, simd);
+    cv::x86::image_convert(
+        resized.data(), bgr.data(), cv::NV21, cv::BGR, dstw, dsth, simd);
+    cv::x86::image_to_tensor(bgr.data(),
+                             dst.data(),
+                             cv::BGR,
+                             paddle::lite_api::DataLayoutType::kNCHW,
+                             dstw,
+                             dsth,
+                             kMeans,
+                             kScales,
+                             simd);
+    benchmark::ClobberMemory();
+  }
+  paddle::lite::bench::ReportRates(
+      state, 0, src.size() + dst.size() * sizeof(float));
+}
+
+static void bench_resize_to_tensor_fused(benchmark::State& state,
+                                         int threads) {
+  const int srcw = state.range(0);
+  const int srch = state.range(1);
+  const int dstw = state.range(2);
+  const int dsth = state.range(3);
+  const bool simd = state.range(4) != 0;
+  X86Threads x86_threads(threads);
+  auto src = RandomImage(srcw * srch * 3 / 2);
+  std::vector<float> dst(dstw * dsth * 3);
+  cv::Image2TensorFused fused;
+  for (auto _ : state) {
+    fused.choose(src.data(),
+                 dst.data(),
+                 cv::NV21,
+                 cv::BGR,
+                 paddle::lite_api::DataLayoutType::kNCHW,
+                 srcw,
+                 srch,
+                 dstw,
+                 dsth,
+                 kMeans,
+                 kScales,
+                 simd);
+    benchmark::ClobberMemory();
+  }
+  paddle::lite::bench::ReportRates(
+      state, 0, src.size() + dst.size() * sizeof(float));
+}
+
+static void RegisterAll() {
+  using paddle::lite::bench::RegisterThreaded;
+  RegisterThreaded("image/convert_nv21_bgr", bench_convert, ImageArguments);
+  RegisterThreaded("image/resize_bgr", bench_resize, ImageArguments);
+  RegisterThreaded("image/to_tensor_bgr", bench_to_tensor, ImageArguments);
+  RegisterThreaded("image/flip_bgr_xy", bench_flip, ImageArguments);
+  RegisterThreaded("image/rotate_bgra_90", bench_rotate, ImageArguments);
+  RegisterThreaded("image/resize_to_tensor/sequential",
+                   bench_resize_to_tensor_sequential,
+                   ImageArguments);
+  RegisterThreaded("image/resize_to_tensor/fused",
+                   bench_resize_to_tensor_fused,
+                   ImageArguments);
+}
+
+int main(int argc, char** argv) {
+  return paddle::lite::bench::RunBenchmarks(argc, argv, RegisterAll);
+}
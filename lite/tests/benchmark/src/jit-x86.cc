@@ -0,0 +1,203 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "lite/backends/x86/jit/helper.h"
+#include "lite/backends/x86/jit/kernel_base.h"
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/tests/benchmark/src/x86_bench_utils.h"
+
+// Benchmarks every implementation of the jit kernels the x86 kernels call:
+// the generated JitCode, the ones of the `more` directory (MKL, Intrinsic,
+// Mix) and Refer, as jit/<kernel>/<implementation>/<size>. They are single
+// threaded, the kernels parallelize around them.
+
+namespace jit = paddle::lite::jit;
+using paddle::lite::fluid::CPUPlace;
+
+namespace {
+
+std::vector<float> RandomVector(size_t size) {
+  std::mt19937 rng(size);
+  std::uniform_real_distribution<float> dist(-2.f, 2.f);
+  std::vector<float> res(size);
+  for (auto& v : res) v = dist(rng);
+  return res;
+}
+
+// Registers `bench(state, func, attr)` for every candidate of `attr`.
+template <typename KernelTuple, typename Bench>
+void RegisterCandidates(const std::string& kernel,
+                        const typename KernelTuple::attr_type& attr,
+                        const std::string& size,
+                        Bench bench) {
+  auto funcs = jit::GetAllCandidateFuncsWithTypes<KernelTuple, CPUPlace>(attr);
+  for (auto& func : funcs) {
+    auto fn = func.second;
+    auto* b = benchmark::RegisterBenchmark(
+        ("jit/" + kernel + "/" + func.first + "/" + size).c_str(),
+        [=](benchmark::State& state) { bench(state, fn, attr); });
+    paddle::lite::bench::StableStatistics(b);
+  }
+}
+
+// z = x op y, one flop and 12 bytes for every element.
+template <typename KernelTuple>
+void RegisterXYZN(const std::string& kernel) {
+  for (int n : {16, 256, 4096, 65536}) {
+    RegisterCandidates<KernelTuple>(
+        kernel,
+        n,
+        std::to_string(n),
+        [](benchmark::State& state,
+           typename KernelTuple::func_type fn,
+           int n) {
+          auto x = RandomVector(n);
+          auto y = RandomVector(n);
+          std::vector<float> z(n);
+          for (auto _ : state) {
+            fn(x.data(), y.data(), z.data(), n);
+            benchmark::ClobberMemory();
+          }
+          paddle::lite::bench::ReportRates(state, n, 12.0 * n);
+        });
+  }
+}
+
+// y = f(x), `flops` for every element.
+template <typename KernelTuple>
+void RegisterXYN(const std::string& kernel, double flops) {
+  for (int n : {16, 256, 4096, 65536}) {
+    RegisterCandidates<KernelTuple>(
+        kernel,
+        n,
+        std::to_string(n),
+        [flops](benchmark::State& state,
+                typename KernelTuple::func_type fn,
+                int n) {
+          auto x = RandomVector(n);
+          std::vector<float> y(n);
+          for (auto _ : state) {
+            fn(x.data(), y.data(), n);
+            benchmark::ClobberMemory();
+          }
+          paddle::lite::bench::ReportRates(state, flops * n, 8.0 * n);
+        });
+  }
+}
+
+void RegisterLayerNorm() {
+  const int rows = 128;
+  for (int cols : {64, 768, 1024, 4096}) {
+    RegisterCandidates<jit::LayerNormTuple<float>>(
+        "LayerNorm",
+        cols,
+        std::to_string(rows) + "x" + std::to_string(cols),
+        [=](benchmark::State& state,
+            jit::LayerNormTuple<float>::func_type fn,
+            int cols) {
+          auto x = RandomVector(rows * cols);
+          auto scale = RandomVector(cols);
+          auto bias = RandomVector(cols);
+          std::vector<float> out(rows * cols), mean(rows), var(rows);
+          for (auto _ : state) {
+            fn(x.data(),
+               out.data(),
+               mean.data(),
+               var.data(),
+               scale.data(),
+               bias.data(),
+               rows,
+               1e-5f,
+               cols);
+            benchmark::ClobberMemory();
+          }
+          paddle::lite::bench::ReportRates(
+              state, 8.0 * rows * cols, 8.0 * rows * cols);
+        });
+  }
+}
+
+void RegisterSoftmax() {
+  const int rows = 64;
+  for (int cols : {16, 128, 1000, 4096}) {
+    RegisterCandidates<jit::SoftmaxTuple<float>>(
+        "Softmax",
+        cols,
+        std::to_string(rows) + "x" + std::to_string(cols),
+        [=](benchmark::State& state,
+            jit::SoftmaxTuple<float>::func_type fn,
+            int cols) {
+          auto x = RandomVector(rows * cols);
+          std::vector<float> y(rows * cols);
+          for (auto _ : state) {
+            fn(x.data(), y.data(), cols, rows, 1);
+            benchmark::ClobberMemory();
+          }
+          paddle::lite::bench::ReportRates(
+              state, 5.0 * rows * cols, 8.0 * rows * cols);
+        });
+  }
+}
+
+void RegisterMatMul() {
+  const int shapes[][3] = {{1, 256, 256}, {16, 64, 64}, {64, 256, 128}};
+  for (auto& shape : shapes) {
+    jit::matmul_attr_t attr(shape[0], shape[1], shape[2]);
+    RegisterCandidates<jit::MatMulTuple<float>>(
+        "MatMul",
+        attr,
+        std::to_string(attr.m) + "x" + std::to_string(attr.n) + "x" +
+            std::to_string(attr.k),
+        [](benchmark::State& state,
+           jit::MatMulTuple<float>::func_type fn,
+           const jit::matmul_attr_t& attr) {
+          auto a = RandomVector(attr.m * attr.k);
+          auto b = RandomVector(attr.k * attr.n);
+          std::vector<float> c(attr.m * attr.n);
+          for (auto _ : state) {
+            fn(a.data(), b.data(), c.data(), &attr);
+            benchmark::ClobberMemory();
+          }
+          paddle::lite::bench::ReportRates(
+              state,
+              2.0 * attr.m * attr.n * attr.k,
+              4.0 * (attr.m * attr.k + attr.k * attr.n + attr.m * attr.n));
+        });
+  }
+}
+
+void RegisterAll() {
+  RegisterXYZN<jit::VAddTuple<float>>("VAdd");
+  RegisterXYZN<jit::VMulTuple<float>>("VMul");
+  RegisterXYN<jit::VReluTuple<float>>("VRelu", 1);
+  // the polynomial approximations cost about 10 flops an element
+  RegisterXYN<jit::VExpTuple<float>>("VExp", 10);
+  RegisterXYN<jit::VSigmoidTuple<float>>("VSigmoid", 12);
+  RegisterXYN<jit::VTanhTuple<float>>("VTanh", 14);
+  RegisterLayerNorm();
+  RegisterSoftmax();
+  RegisterMatMul();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  return paddle::lite::bench::RunBenchmarks(argc, argv, RegisterAll);
+}
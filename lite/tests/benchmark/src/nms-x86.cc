@@ -0,0 +1,190 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "lite/kernels/host/generate_proposals_compute.h"
+#include "lite/kernels/host/matrix_nms_compute.h"
+#include "lite/kernels/host/multiclass_nms_compute.h"
+#include "lite/tests/benchmark/src/x86_bench_utils.h"
+
+using paddle::lite::DDim;
+using paddle::lite::Tensor;
+using paddle::lite::bench::X86Threads;
+
+// Benchmarks the detection post-processing of the host kernels on x86:
+// multiclass_nms and matrix_nms on the outputs of YOLOv3 and SSD, and the
+// proposals of Faster R-CNN. They are bound by the sort and the overlaps of
+// the boxes, no FLOPS or bytes are reported.
+
+template <typename Kernel, typename Param>
+static void RunKernel(benchmark::State& state,
+                      const X86Threads& x86_threads,
+                      const Param& param) {
+  Kernel kernel;
+  kernel.SetParam(param);
+  kernel.SetContext(x86_threads.NewContext());
+  kernel.PrepareForRun();
+  kernel.Launch();
+  for (auto _ : state) {
+    kernel.Launch();
+  }
+}
+
+// num boxes [xmin, ymin, xmax, ymax] of up to a quarter of the image, the
+// normalized ones in [0, 1], the others in pixels of a size x size image.
+static void FillBoxes(Tensor* boxes, bool normalized, float size = 608.f) {
+  std::mt19937 rng(boxes->numel());
+  float scale = normalized ? 1.f : size;
+  std::uniform_real_distribution<float> pos(0.f, scale);
+  std::uniform_real_distribution<float> len(0.f, scale / 4);
+  auto* data = boxes->mutable_data<float>();
+  for (int64_t i = 0; i < boxes->numel() / 4; ++i) {
+    data[i * 4] = pos(rng);
+    data[i * 4 + 1] = pos(rng);
+    data[i * 4 + 2] = data[i * 4] + len(rng);
+    data[i * 4 + 3] = data[i * 4 + 1] + len(rng);
+  }
+}
+
+static void NmsArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"batch", "classes", "boxes"});
+  // YOLOv3 608x608 on COCO
+  b->Args({1, 80, 10647});
+  b->Args({4, 80, 10647});
+  // SSD MobileNet 300x300 on VOC
+  b->Args({1, 21, 1917});
+  b->Args({8, 21, 1917});
+}
+
+void bench_multiclass_nms(benchmark::State& state, int threads) {
+  const int64_t batch = state.range(0);
+  const int64_t classes = state.range(1);
+  const int64_t boxes = state.range(2);
+  X86Threads x86_threads(threads);
+  Tensor bboxes, scores, out, index, nms_rois_num;
+  bboxes.Resize(DDim({batch, boxes, 4}));
+  scores.Resize(DDim({batch, classes, boxes}));
+  FillBoxes(&bboxes, true);
+  paddle::lite::bench::FillRandom<float>(&scores, 0.f, 1.f);
+
+  paddle::lite::operators::MulticlassNmsParam param;
+  param.bboxes = &bboxes;
+  param.scores = &scores;
+  param.out = &out;
+  param.index = &index;
+  param.nms_rois_num = &nms_rois_num;
+  param.background_label = -1;
+  param.score_threshold = 0.01f;
+  param.nms_top_k = 1000;
+  param.nms_threshold = 0.45f;
+  param.keep_top_k = 100;
+  param.normalized = true;
+  using Kernel = paddle::lite::kernels::host::
+      MulticlassNmsCompute<float, TARGET(kHost), PRECISION(kFloat)>;
+  RunKernel<Kernel>(state, x86_threads, param);
+}
+
+void bench_matrix_nms(benchmark::State& state, int threads) {
+  const int64_t batch = state.range(0);
+  const int64_t classes = state.range(1);
+  const int64_t boxes = state.range(2);
+  X86Threads x86_threads(threads);
+  Tensor bboxes, scores, out, index, rois_num;
+  bboxes.Resize(DDim({batch, boxes, 4}));
+  scores.Resize(DDim({batch, classes, boxes}));
+  FillBoxes(&bboxes, true);
+  paddle::lite::bench::FillRandom<float>(&scores, 0.f, 1.f);
+
+  paddle::lite::operators::MatrixNmsParam param;
+  param.bboxes = &bboxes;
+  param.scores = &scores;
+  param.out = &out;
+  param.index = &index;
+  param.rois_num = &rois_num;
+  param.background_label = -1;
+  param.score_threshold = 0.01f;
+  param.post_threshold = 0.01f;
+  param.nms_top_k = 400;
+  param.keep_top_k = 100;
+  param.normalized = true;
+  param.use_gaussian = false;
+  RunKernel<paddle::lite::kernels::host::MatrixNmsCompute>(
+      state, x86_threads, param);
+}
+
+// The RPN of Faster R-CNN on a feature map of stride 16, 15 anchors a cell.
+static void ProposalsArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"batch", "height", "width", "pre_nms"});
+  b->Args({1, 38, 50, 6000});
+  b->Args({2, 38, 50, 6000});
+  b->Args({1, 50, 84, 12000});
+}
+
+void bench_generate_proposals(benchmark::State& state, int threads) {
+  const int64_t batch = state.range(0);
+  const int64_t height = state.range(1);
+  const int64_t width = state.range(2);
+  const int64_t anchors_per_cell = 15;
+  X86Threads x86_threads(threads);
+  Tensor scores, bbox_deltas, im_info, anchors, variances;
+  Tensor rpn_rois, rpn_roi_probs, rpn_rois_num;
+  scores.Resize(DDim({batch, anchors_per_cell, height, width}));
+  bbox_deltas.Resize(DDim({batch, anchors_per_cell * 4, height, width}));
+  im_info.Resize(DDim({batch, 3}));
+  anchors.Resize(DDim({height, width, anchors_per_cell, 4}));
+  variances.Resize(DDim({height, width, anchors_per_cell, 4}));
+  paddle::lite::bench::FillRandom<float>(&scores, 0.f, 1.f);
+  paddle::lite::bench::FillRandom<float>(&bbox_deltas, -0.5f, 0.5f);
+  paddle::lite::bench::FillRandom<float>(&variances, 0.5f, 1.f);
+  FillBoxes(&anchors, false, 16.f * width);
+  auto* im_info_data = im_info.mutable_data<float>();
+  for (int64_t i = 0; i < batch; ++i) {
+    im_info_data[i * 3] = 16.f * height;
+    im_info_data[i * 3 + 1] = 16.f * width;
+    im_info_data[i * 3 + 2] = 1.f;
+  }
+
+  paddle::lite::operators::GenerateProposalsParam param;
+  param.Scores = &scores;
+  param.BboxDeltas = &bbox_deltas;
+  param.ImInfo = &im_info;
+  param.Anchors = &anchors;
+  param.Variances = &variances;
+  param.pre_nms_topN = state.range(3);
+  param.post_nms_topN = 1000;
+  param.nms_thresh = 0.7f;
+  param.min_size = 0.f;
+  param.RpnRois = &rpn_rois;
+  param.RpnRoiProbs = &rpn_roi_probs;
+  param.RpnRoisNum = &rpn_rois_num;
+  RunKernel<paddle::lite::kernels::host::GenerateProposalsCompute>(
+      state, x86_threads, param);
+}
+
+static void RegisterAll() {
+  using paddle::lite::bench::RegisterThreaded;
+  RegisterThreaded("nms/multiclass_nms", bench_multiclass_nms, NmsArguments);
+  RegisterThreaded("nms/matrix_nms", bench_matrix_nms, NmsArguments);
+  RegisterThreaded(
+      "nms/generate_proposals", bench_generate_proposals, ProposalsArguments);
+}
+
+int main(int argc, char** argv) {
+  return paddle::lite::bench::RunBenchmarks(argc, argv, RegisterAll);
+}
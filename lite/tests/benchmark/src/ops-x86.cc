@@ -0,0 +1,280 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "lite/kernels/x86/elementwise_compute.h"
+#include "lite/kernels/x86/layer_norm_compute.h"
+#include "lite/kernels/x86/pool_compute.h"
+#include "lite/kernels/x86/softmax_compute.h"
+#include "lite/tests/benchmark/src/x86_bench_utils.h"
+
+using paddle::lite::DDim;
+using paddle::lite::Tensor;
+using paddle::lite::bench::X86Threads;
+
+// Benchmarks the memory bound x86 kernels: softmax, layer_norm, pool2d, pool3d
+// and elementwise_add with broadcast. Their FLOPS count one operation for each
+// add, mul, compare and exp, the bytes are what bounds them.
+
+template <typename Kernel, typename Param>
+static void RunKernel(benchmark::State& state,
+                      const X86Threads& x86_threads,
+                      const Param& param) {
+  Kernel kernel;
+  kernel.SetParam(param);
+  kernel.SetContext(x86_threads.NewContext());
+  kernel.PrepareForRun();
+  kernel.Launch();
+  for (auto _ : state) {
+    kernel.Launch();
+  }
+}
+
+// Softmax over the last axis of a [rows, cols] input.
+static void SoftmaxArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"rows", "cols"});
+  b->Args({1, 1000});
+  b->Args({64, 1000});
+  // the attention of BERT base, 12 heads of 128 tokens
+  b->Args({12 * 128, 128});
+  b->Args({12 * 512, 512});
+}
+
+void bench_softmax(benchmark::State& state, int threads) {
+  const int64_t rows = state.range(0);
+  const int64_t cols = state.range(1);
+  X86Threads x86_threads(threads);
+  Tensor x, out;
+  x.Resize(DDim({rows, cols}));
+  out.Resize(DDim({rows, cols}));
+  paddle::lite::bench::FillRandom<float>(&x);
+
+  paddle::lite::operators::SoftmaxParam param;
+  param.x = &x;
+  param.output = &out;
+  param.axis = -1;
+  RunKernel<paddle::lite::kernels::x86::SoftmaxCompute<float>>(
+      state, x86_threads, param);
+  // max, sub, exp, sum and scale
+  paddle::lite::bench::ReportRates(
+      state, 5.0 * rows * cols, 2.0 * rows * cols * sizeof(float));
+}
+
+// LayerNorm over the last axis of a [rows, cols] input.
+static void LayerNormArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"rows", "cols"});
+  b->Args({128, 768});
+  b->Args({512, 768});
+  b->Args({128, 1024});
+  b->Args({1, 4096});
+}
+
+void bench_layer_norm(benchmark::State& state, int threads) {
+  const int64_t rows = state.range(0);
+  const int64_t cols = state.range(1);
+  X86Threads x86_threads(threads);
+  Tensor x, scale, bias, y, mean, variance;
+  x.Resize(DDim({rows, cols}));
+  scale.Resize(DDim({cols}));
+  bias.Resize(DDim({cols}));
+  y.Resize(DDim({rows, cols}));
+  mean.Resize(DDim({rows}));
+  variance.Resize(DDim({rows}));
+  paddle::lite::bench::FillRandom<float>(&x);
+  paddle::lite::bench::FillRandom<float>(&scale);
+  paddle::lite::bench::FillRandom<float>(&bias);
+
+  paddle::lite::operators::LayerNormParam param;
+  param.X = &x;
+  param.Scale = &scale;
+  param.Bias = &bias;
+  param.Y = &y;
+  param.Mean = &mean;
+  param.Variance = &variance;
+  param.begin_norm_axis = 1;
+  RunKernel<paddle::lite::kernels::x86::LayerNormCompute<float>>(
+      state, x86_threads, param);
+  // sum, squared difference, normalize, scale and shift
+  paddle::lite::bench::ReportRates(
+      state,
+      8.0 * rows * cols,
+      (2.0 * rows * cols + 2.0 * cols + 2.0 * rows) * sizeof(float));
+}
+
+// pooling_type is 0 for max and 1 for avg, a global pooling has kernel 0.
+// The type 2 is the adaptive avg pooling to an output of K x K.
+static void Pool2dArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N", "C", "H", "W", "K", "S", "P", "type"});
+  /*       N   C    H    W   K  S  P  type */
+  b->Args({1, 64, 112, 112, 3, 2, 1, 0});
+  b->Args({1, 64, 112, 112, 3, 2, 1, 1});
+  b->Args({1, 96, 56, 56, 2, 2, 0, 0});
+  b->Args({1, 192, 28, 28, 3, 1, 1, 1});
+  b->Args({1, 2048, 7, 7, 0, 1, 0, 1});
+  b->Args({8, 1024, 7, 7, 0, 1, 0, 1});
+  b->Args({1, 512, 14, 14, 7, 1, 0, 2});
+}
+
+void bench_pool2d(benchmark::State& state, int threads) {
+  const int64_t n = state.range(0);
+  const int64_t c = state.range(1);
+  const int64_t h = state.range(2);
+  const int64_t w = state.range(3);
+  const bool global = state.range(4) == 0;
+  const bool adaptive = state.range(7) == 2;
+  const int kernel = global ? h : state.range(4);
+  const int stride = state.range(5);
+  const int pad = state.range(6);
+  int64_t out_h = global ? 1 : (h + 2 * pad - kernel) / stride + 1;
+  int64_t out_w = global ? 1 : (w + 2 * pad - kernel) / stride + 1;
+  if (adaptive) {
+    out_h = kernel;
+    out_w = kernel;
+  }
+  X86Threads x86_threads(threads);
+  Tensor x, out;
+  x.Resize(DDim({n, c, h, w}));
+  out.Resize(DDim({n, c, out_h, out_w}));
+  paddle::lite::bench::FillRandom<float>(&x);
+
+  paddle::lite::operators::PoolParam param;
+  param.x = &x;
+  param.output = &out;
+  param.pooling_type = state.range(7) == 0 ? "max" : "avg";
+  param.global_pooling = global;
+  param.adaptive = adaptive;
+  param.ksize = {kernel, global ? static_cast<int>(w) : kernel};
+  param.strides = {stride, stride};
+  param.paddings =
+      std::make_shared<std::vector<int>>(std::vector<int>{pad, pad, pad, pad});
+  RunKernel<paddle::lite::kernels::x86::PoolCompute<float>>(
+      state, x86_threads, param);
+  // an adaptive window reads about (H / K) x (W / K) elements
+  const double window = adaptive
+                            ? static_cast<double>(h * w) / (out_h * out_w)
+                            : param.ksize[0] * param.ksize[1];
+  paddle::lite::bench::ReportRates(
+      state,
+      static_cast<double>(out.numel()) * window,
+      static_cast<double>(x.numel() + out.numel()) * sizeof(float));
+}
+
+// pool3d of [N, C, D, H, W], the type is 0 for max and 1 for avg.
+static void Pool3dArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N", "C", "D", "H", "W", "K", "S", "P", "type"});
+  /*       N   C   D   H   W  K  S  P  type */
+  b->Args({1, 64, 16, 56, 56, 3, 2, 1, 0});
+  b->Args({1, 64, 16, 56, 56, 3, 2, 1, 1});
+  b->Args({1, 128, 8, 28, 28, 2, 2, 0, 0});
+}
+
+void bench_pool3d(benchmark::State& state, int threads) {
+  std::vector<int64_t> x_shape(5);
+  for (int i = 0; i < 5; ++i) {
+    x_shape[i] = state.range(i);
+  }
+  const int kernel = state.range(5);
+  const int stride = state.range(6);
+  const int pad = state.range(7);
+  std::vector<int64_t> out_shape{x_shape[0], x_shape[1]};
+  for (int i = 2; i < 5; ++i) {
+    out_shape.push_back((x_shape[i] + 2 * pad - kernel) / stride + 1);
+  }
+  X86Threads x86_threads(threads);
+  Tensor x, out;
+  x.Resize(DDim(x_shape));
+  out.Resize(DDim(out_shape));
+  paddle::lite::bench::FillRandom<float>(&x);
+
+  paddle::lite::operators::PoolParam param;
+  param.x = &x;
+  param.output = &out;
+  param.pooling_type = state.range(8) == 0 ? "max" : "avg";
+  param.ksize = {kernel, kernel, kernel};
+  param.strides = {stride, stride, stride};
+  param.paddings = std::make_shared<std::vector<int>>(std::vector<int>(6, pad));
+  RunKernel<paddle::lite::kernels::x86::PoolCompute<float>>(
+      state, x86_threads, param);
+  paddle::lite::bench::ReportRates(
+      state,
+      static_cast<double>(out.numel()) * kernel * kernel * kernel,
+      static_cast<double>(x.numel() + out.numel()) * sizeof(float));
+}
+
+// The broadcast adds Y of [N, C, H, W] when it is 0, of [C] at axis 1 when
+// it is 1, and of [W] at the last axis when it is 2.
+static void ElementwiseArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N", "C", "H", "W", "broadcast"});
+  for (int broadcast = 0; broadcast < 3; ++broadcast) {
+    b->Args({1, 64, 112, 112, broadcast});
+    b->Args({1, 256, 28, 28, broadcast});
+    b->Args({1, 1024, 7, 7, broadcast});
+    // the bias of the fc layers of BERT base
+    b->Args({1, 1, 128, 3072, broadcast});
+  }
+}
+
+void bench_elementwise_add(benchmark::State& state, int threads) {
+  const int64_t n = state.range(0);
+  const int64_t c = state.range(1);
+  const int64_t h = state.range(2);
+  const int64_t w = state.range(3);
+  const int64_t broadcast = state.range(4);
+  X86Threads x86_threads(threads);
+  Tensor x, y, out;
+  x.Resize(DDim({n, c, h, w}));
+  out.Resize(DDim({n, c, h, w}));
+  paddle::lite::operators::ElementwiseParam param;
+  if (broadcast == 0) {
+    y.Resize(DDim({n, c, h, w}));
+    param.axis = -1;
+  } else if (broadcast == 1) {
+    y.Resize(DDim({c}));
+    param.axis = 1;
+  } else {
+    y.Resize(DDim({w}));
+    param.axis = 3;
+  }
+  paddle::lite::bench::FillRandom<float>(&x);
+  paddle::lite::bench::FillRandom<float>(&y);
+
+  param.X = &x;
+  param.Y = &y;
+  param.Out = &out;
+  RunKernel<paddle::lite::kernels::x86::ElementwiseAddCompute<float>>(
+      state, x86_threads, param);
+  paddle::lite::bench::ReportRates(
+      state,
+      static_cast<double>(out.numel()),
+      static_cast<double>(x.numel() + y.numel() + out.numel()) *
+          sizeof(float));
+}
+
+static void RegisterAll() {
+  using paddle::lite::bench::RegisterThreaded;
+  RegisterThreaded("softmax", bench_softmax, SoftmaxArguments);
+  RegisterThreaded("layer_norm", bench_layer_norm, LayerNormArguments);
+  RegisterThreaded("pool2d", bench_pool2d, Pool2dArguments);
+  RegisterThreaded("pool3d", bench_pool3d, Pool3dArguments);
+  RegisterThreaded(
+      "elementwise_add", bench_elementwise_add, ElementwiseArguments);
+}
+
+int main(int argc, char** argv) {
+  return paddle::lite::bench::RunBenchmarks(argc, argv, RegisterAll);
+}
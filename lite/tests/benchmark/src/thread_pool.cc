@@ -0,0 +1,173 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <atomic>
+#include <functional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "lite/core/thread_pool.h"
+
+// Compares the fork/join cost and the load balance of lite::ThreadPool with
+// the previous broadcast pool and OpenMP. state.range(0) is the thread
+// number, state.range(1) the work size, state.range(2) the skew: the first
+// 1/8 of the indices cost `skew` times more than the others.
+
+namespace {
+
+// The single slot pool lite::ThreadPool used before work stealing: each
+// worker gets a fixed strided share of the indices.
+class BroadcastPool {
+ public:
+  explicit BroadcastPool(int number) : thread_num_(number) {
+    for (int i = 0; i < thread_num_; ++i) {
+      flags_.emplace_back(new std::atomic<bool>{false});
+    }
+    for (int tid = 1; tid < thread_num_; ++tid) {
+      workers_.emplace_back([this, tid]() {
+        while (!stop_) {
+          while (!(*flags_[tid]) && !stop_) std::this_thread::yield();
+          if (stop_) break;
+          task_(tid, tid);
+          *flags_[tid] = false;
+        }
+      });
+    }
+  }
+  ~BroadcastPool() {
+    stop_ = true;
+    for (auto& worker : workers_) worker.join();
+    for (auto flag : flags_) delete flag;
+  }
+  void Enqueue(const std::function<void(int, int)>& task, int work_size) {
+    task_ = [&](int index, int tid) {
+      for (int v = tid; v < work_size; v += thread_num_) task(v, tid);
+    };
+    for (int i = 1; i < thread_num_; ++i) *flags_[i] = true;
+    task_(0, 0);
+    bool complete = true;
+    do {
+      std::this_thread::yield();
+      complete = true;
+      for (int i = 1; i < thread_num_; ++i) {
+        if (*flags_[i]) {
+          complete = false;
+          break;
+        }
+      }
+    } while (!complete);
+  }
+
+ private:
+  int thread_num_;
+  std::vector<std::thread> workers_;
+  std::vector<std::atomic<bool>*> flags_;
+  std::function<void(int, int)> task_;
+  std::atomic<bool> stop_{false};
+};
+
+inline float Work(int index, int work_size, int skew) {
+  int cost = index < work_size / 8 ? 64 * skew : 64;
+  float acc = index;
+  for (int i = 0; i < cost; ++i) {
+    acc = acc * 0.999f + 1.f;
+  }
+  return acc;
+}
+
+void SetCounters(benchmark::State& state) {
+  state.counters["tasks"] = benchmark::Counter(
+      static_cast<double>(state.iterations()) * state.range(1),
+      benchmark::Counter::kIsRate);
+}
+
+}  // namespace
+
+static void BM_ThreadPool(benchmark::State& state) {
+  const int threads = state.range(0);
+  const int work_size = state.range(1);
+  const int skew = state.range(2);
+  std::vector<float> out(work_size);
+  paddle::lite::ThreadPool::Init(threads, true);
+  for (auto _ : state) {
+    paddle::lite::ThreadPool::Enqueue(
+        {[&](int index, int tid) { out[index] = Work(index, work_size, skew); },
+         work_size});
+    benchmark::DoNotOptimize(out.data());
+  }
+  paddle::lite::ThreadPool::Destroy();
+  SetCounters(state);
+}
+
+static void BM_BroadcastPool(benchmark::State& state) {
+  const int threads = state.range(0);
+  const int work_size = state.range(1);
+  const int skew = state.range(2);
+  std::vector<float> out(work_size);
+  BroadcastPool pool(threads);
+  for (auto _ : state) {
+    pool.Enqueue(
+        [&](int index, int tid) { out[index] = Work(index, work_size, skew); },
+        work_size);
+    benchmark::DoNotOptimize(out.data());
+  }
+  SetCounters(state);
+}
+
+#ifdef _OPENMP
+static void BM_OpenMP(benchmark::State& state) {
+  const int threads = state.range(0);
+  const int work_size = state.range(1);
+  const int skew = state.range(2);
+  std::vector<float> out(work_size);
+  omp_set_num_threads(threads);
+  for (auto _ : state) {
+#pragma omp parallel for schedule(static)
+    for (int index = 0; index < work_size; ++index) {
+      out[index] = Work(index, work_size, skew);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  SetCounters(state);
+}
+#endif
+
+static void ThreadPoolArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"threads", "work", "skew"});
+  for (int threads : {2, 4, 8, 16, 32}) {
+    if (threads > 2 &&
+        threads > static_cast<int>(std::thread::hardware_concurrency())) {
+      break;
+    }
+    for (int work : {threads, 64, 4096}) {
+      for (int skew : {1, 16}) {
+        b->Args({threads, work, skew});
+      }
+    }
+  }
+  b->UseRealTime();
+}
+
+BENCHMARK(BM_ThreadPool)->Apply(ThreadPoolArgs);
+BENCHMARK(BM_BroadcastPool)->Apply(ThreadPoolArgs);
+#ifdef _OPENMP
+BENCHMARK(BM_OpenMP)->Apply(ThreadPoolArgs);
+#endif
+
+BENCHMARK_MAIN();
@@ -0,0 +1,158 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "lite/backends/x86/parallel.h"
+#include "lite/core/context.h"
+#include "lite/core/tensor.h"
+#ifdef LITE_USE_THREAD_POOL
+#include "lite/core/thread_pool.h"
+#endif
+
+// Helpers shared by the x86 operator benchmarks: every benchmark is
+// registered once per thread count as `name/threads:N`, runs 5 repetitions
+// and reports the mean, median, stddev and min of them, with the FLOPS and
+// the bytes_per_second of one run.
+
+namespace paddle {
+namespace lite {
+namespace bench {
+
+// The thread counts to sweep, LITE_BENCHMARK_THREADS="1,2,4" overrides the
+// default powers of two up to the hardware concurrency.
+inline std::vector<int> BenchmarkThreads() {
+  std::vector<int> threads;
+  const char* env = std::getenv("LITE_BENCHMARK_THREADS");
+  if (env != nullptr) {
+    std::stringstream ss(env);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+      int n = std::atoi(item.c_str());
+      if (n > 0) threads.push_back(n);
+    }
+  }
+  if (threads.empty()) {
+    int max_threads =
+        std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int n = 1; n < max_threads; n *= 2) threads.push_back(n);
+    threads.push_back(max_threads);
+  }
+  return threads;
+}
+
+// Sets the threads of the math library and the thread pool of the kernels
+// to `threads` during its lifetime.
+class X86Threads {
+ public:
+  explicit X86Threads(int threads) {
+    lite::x86::SetNumThreads(threads);
+#ifdef LITE_USE_THREAD_POOL
+    pool_ = ThreadPool::Create("", threads, {});
+    guard_.reset(new ThreadPool::ScopedPool(pool_.get()));
+#endif
+  }
+  ~X86Threads() {
+#ifdef LITE_USE_THREAD_POOL
+    guard_.reset();
+#endif
+    lite::x86::SetNumThreads(1);
+  }
+
+  // A context of a kernel running in these threads.
+  std::unique_ptr<KernelContext> NewContext() const {
+    auto ctx = ContextScheduler::Global().NewContext(TARGET(kX86));
+#ifdef LITE_USE_THREAD_POOL
+    ctx->SetThreadPool(pool_);
+#endif
+    return ctx;
+  }
+
+ private:
+#ifdef LITE_USE_THREAD_POOL
+  std::shared_ptr<ThreadPool> pool_;
+  std::unique_ptr<ThreadPool::ScopedPool> guard_;
+#endif
+};
+
+template <typename T>
+void FillRandom(Tensor* x, float lo = -1.f, float hi = 1.f) {
+  std::mt19937 rng(x->numel());
+  std::uniform_real_distribution<float> dist(lo, hi);
+  auto* data = x->mutable_data<T>();
+  for (int64_t i = 0; i < x->numel(); ++i) {
+    data[i] = static_cast<T>(dist(rng));
+  }
+}
+
+// `flops` and `bytes` are the arithmetic and the memory traffic of one run,
+// bytes count every input read and every output written once.
+inline void ReportRates(benchmark::State& state, double flops, double bytes) {
+  if (flops > 0) {
+    state.counters["FLOPS"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * flops,
+        benchmark::Counter::kIsRate);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+
+// Repeats the benchmark 5 times and reports the statistics of the
+// repetitions only, the min is the most stable one on a busy machine.
+inline void StableStatistics(benchmark::internal::Benchmark* b) {
+  b->Repetitions(5)
+      ->ReportAggregatesOnly(true)
+      ->UseRealTime()
+      ->ComputeStatistics("min", [](const std::vector<double>& v) {
+        return *std::min_element(v.begin(), v.end());
+      });
+}
+
+// Registers `fn(state, threads)` as `name/threads:N` for every thread count
+// of BenchmarkThreads, with the arguments set by `apply`.
+template <typename Fn>
+void RegisterThreaded(const std::string& name,
+                      Fn fn,
+                      void (*apply)(benchmark::internal::Benchmark*)) {
+  for (int threads : BenchmarkThreads()) {
+    auto* b = benchmark::RegisterBenchmark(
+        (name + "/threads:" + std::to_string(threads)).c_str(),
+        [=](benchmark::State& state) { fn(state, threads); });
+    b->Apply(apply);
+    StableStatistics(b);
+  }
+}
+
+// The main of a benchmark whose cases are registered by `register_all`.
+inline int RunBenchmarks(int argc, char** argv, void (*register_all)()) {
+  register_all();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
+
+}  // namespace bench
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,262 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "lite/core/tensor.h"
+#include "lite/tests/cv/cv_basic.h"
+#include "lite/utils/cv/image2tensor_fused.h"
+#include "lite/utils/cv/x86/image_x86.h"
+
+namespace x86_cv = paddle::lite::utils::cv::x86;
+using paddle::lite::utils::cv::Image2TensorFused;
+
+// widths off the vector sizes leave the scalar tails of the simd loops, the
+// sizes are even for nv12(nv21)
+static const int kSizes[][4] = {
+    {64, 48, 32, 24}, {70, 46, 38, 30}, {36, 18, 90, 50}, {54, 40, 54, 40}};
+
+static std::vector<uint8_t> rand_image(int size) {
+  std::mt19937 rng(size);
+  std::uniform_int_distribution<int> dist(0, 255);
+  std::vector<uint8_t> data(size);
+  for (auto& v : data) {
+    v = static_cast<uint8_t>(dist(rng));
+  }
+  return data;
+}
+
+static int image_size(ImageFormat format, int w, int h) {
+  switch (format) {
+    case ImageFormat::NV12:
+    case ImageFormat::NV21:
+      return w * h * 3 / 2;
+    case ImageFormat::GRAY:
+      return w * h;
+    case ImageFormat::BGRA:
+    case ImageFormat::RGBA:
+      return w * h * 4;
+    default:
+      return w * h * 3;
+  }
+}
+
+TEST(image_x86, convert) {
+  const ImageFormat pairs[][2] = {{ImageFormat::NV12, ImageFormat::BGR},
+                                  {ImageFormat::NV21, ImageFormat::BGRA},
+                                  {ImageFormat::BGR, ImageFormat::GRAY},
+                                  {ImageFormat::BGRA, ImageFormat::RGB},
+                                  {ImageFormat::BGR, ImageFormat::RGBA},
+                                  {ImageFormat::GRAY, ImageFormat::BGR},
+                                  {ImageFormat::RGBA, ImageFormat::BGRA}};
+  for (auto& size : kSizes) {
+    int w = size[0];
+    int h = size[1];
+    for (auto& pair : pairs) {
+      auto src = rand_image(image_size(pair[0], w, h));
+      int out_size = image_size(pair[1], w, h);
+      std::vector<uint8_t> basic(out_size);
+      std::vector<uint8_t> scalar(out_size);
+      std::vector<uint8_t> simd(out_size);
+      image_convert_basic(
+          src.data(), basic.data(), pair[0], pair[1], w, h, out_size);
+      x86_cv::image_convert(
+          src.data(), scalar.data(), pair[0], pair[1], w, h, false);
+      x86_cv::image_convert(
+          src.data(), simd.data(), pair[0], pair[1], w, h, true);
+      EXPECT_EQ(basic, scalar) << pair[0] << " to " << pair[1];
+      EXPECT_EQ(scalar, simd) << pair[0] << " to " << pair[1];
+    }
+  }
+}
+
+TEST(image_x86, resize) {
+  const ImageFormat formats[] = {ImageFormat::GRAY,
+                                 ImageFormat::NV21,
+                                 ImageFormat::BGR,
+                                 ImageFormat::BGRA};
+  for (auto& size : kSizes) {
+    for (auto format : formats) {
+      auto src = rand_image(image_size(format, size[0], size[1]));
+      int out_size = image_size(format, size[2], size[3]);
+      std::vector<uint8_t> scalar(out_size);
+      std::vector<uint8_t> simd(out_size);
+      x86_cv::image_resize(src.data(),
+                           scalar.data(),
+                           format,
+                           size[0],
+                           size[1],
+                           size[2],
+                           size[3],
+                           false);
+      x86_cv::image_resize(src.data(),
+                           simd.data(),
+                           format,
+                           size[0],
+                           size[1],
+                           size[2],
+                           size[3],
+                           true);
+      EXPECT_EQ(scalar, simd) << "format " << format;
+    }
+  }
+}
+
+TEST(image_x86, flip_rotate) {
+  const ImageFormat formats[] = {
+      ImageFormat::GRAY, ImageFormat::BGR, ImageFormat::BGRA};
+  const FlipParam flips[] = {FlipParam::X, FlipParam::Y, FlipParam::XY};
+  for (auto& size : kSizes) {
+    int w = size[0];
+    int h = size[1];
+    for (int k = 0; k < 3; k++) {
+      int channels = k == 0 ? 1 : k + 2;
+      auto src = rand_image(w * h * channels);
+      std::vector<uint8_t> basic(src.size());
+      std::vector<uint8_t> out(src.size());
+      for (auto flip : flips) {
+        image_flip_basic(src.data(), basic.data(), formats[k], w, h, flip);
+        x86_cv::image_flip(src.data(), out.data(), channels, w, h, flip, true);
+        EXPECT_EQ(basic, out) << "flip " << flip;
+      }
+      rotate90_basic(src.data(), h, w, basic.data(), w, h, channels);
+      x86_cv::image_rotate(src.data(), out.data(), channels, w, h, 90, true);
+      EXPECT_EQ(basic, out) << "rotate 90";
+      rotate270_basic(src.data(), h, w, basic.data(), w, h, channels);
+      x86_cv::image_rotate(src.data(), out.data(), channels, w, h, 270, true);
+      EXPECT_EQ(basic, out) << "rotate 270";
+      rotate180_basic(src.data(), h, w, basic.data(), h, w, channels);
+      x86_cv::image_rotate(src.data(), out.data(), channels, w, h, 180, true);
+      EXPECT_EQ(basic, out) << "rotate 180";
+    }
+  }
+}
+
+TEST(image_x86, to_tensor) {
+  // the basic functions take means[2] for channel 0, the same values for all
+  // channels keep them comparable
+  float means[3] = {127.5f, 127.5f, 127.5f};
+  float scales[3] = {1 / 127.5f, 1 / 127.5f, 1 / 127.5f};
+  const ImageFormat formats[] = {
+      ImageFormat::GRAY, ImageFormat::BGR, ImageFormat::BGRA};
+  const LayoutType layouts[] = {LayoutType::kNCHW, LayoutType::kNHWC};
+  for (auto& size : kSizes) {
+    int w = size[0];
+    int h = size[1];
+    for (auto format : formats) {
+      auto src = rand_image(image_size(format, w, h));
+      int out_channels = format == ImageFormat::GRAY ? 1 : 3;
+      for (auto layout : layouts) {
+        // the basic hwc output of a bgra image keeps a stride of 4
+        if (format == ImageFormat::BGRA && layout == LayoutType::kNHWC) {
+          continue;
+        }
+        Tensor basic;
+        basic.Resize({1, out_channels, h, w});
+        image_to_tensor_basic(
+            src.data(), &basic, format, layout, w, h, means, scales);
+        std::vector<float> scalar(w * h * out_channels);
+        std::vector<float> simd(w * h * out_channels);
+        x86_cv::image_to_tensor(src.data(),
+                                scalar.data(),
+                                format,
+                                layout,
+                                w,
+                                h,
+                                means,
+                                scales,
+                                false);
+        x86_cv::image_to_tensor(src.data(),
+                                simd.data(),
+                                format,
+                                layout,
+                                w,
+                                h,
+                                means,
+                                scales,
+                                true);
+        const float* ref = basic.data<float>();
+        for (int i = 0; i < w * h * out_channels; i++) {
+          EXPECT_NEAR(ref[i], scalar[i], 1e-5f);
+          EXPECT_NEAR(scalar[i], simd[i], 1e-5f);
+        }
+      }
+    }
+  }
+}
+
+// the fused path gives the tensor of resize + convert + to_tensor
+TEST(image_x86, resize_to_tensor_fused) {
+  float means[3] = {127.5f, 120.f, 110.f};
+  float scales[3] = {1 / 127.5f, 1 / 120.f, 1 / 110.f};
+  const ImageFormat pairs[][2] = {{ImageFormat::NV21, ImageFormat::BGR},
+                                  {ImageFormat::NV12, ImageFormat::RGB},
+                                  {ImageFormat::BGR, ImageFormat::RGB},
+                                  {ImageFormat::BGRA, ImageFormat::BGR},
+                                  {ImageFormat::RGBA, ImageFormat::BGR},
+                                  {ImageFormat::GRAY, ImageFormat::GRAY}};
+  const LayoutType layouts[] = {LayoutType::kNCHW, LayoutType::kNHWC};
+  for (auto& size : kSizes) {
+    int srcw = size[0];
+    int srch = size[1];
+    int dstw = size[2];
+    int dsth = size[3];
+    for (auto& pair : pairs) {
+      auto src = rand_image(image_size(pair[0], srcw, srch));
+      std::vector<uint8_t> resized(image_size(pair[0], dstw, dsth));
+      std::vector<uint8_t> converted(image_size(pair[1], dstw, dsth));
+      x86_cv::image_resize(
+          src.data(), resized.data(), pair[0], srcw, srch, dstw, dsth, true);
+      x86_cv::image_convert(resized.data(),
+                            converted.data(),
+                            pair[0],
+                            pair[1],
+                            dstw,
+                            dsth,
+                            true);
+      int out_size = dstw * dsth * (pair[1] == ImageFormat::GRAY ? 1 : 3);
+      for (auto layout : layouts) {
+        std::vector<float> sequential(out_size);
+        x86_cv::image_to_tensor(converted.data(),
+                                sequential.data(),
+                                pair[1],
+                                layout,
+                                dstw,
+                                dsth,
+                                means,
+                                scales,
+                                true);
+        for (bool simd : {false, true}) {
+          std::vector<float> fused(out_size);
+          Image2TensorFused().choose(src.data(),
+                                     fused.data(),
+                                     pair[0],
+                                     pair[1],
+                                     layout,
+                                     srcw,
+                                     srch,
+                                     dstw,
+                                     dsth,
+                                     means,
+                                     scales,
+                                     simd);
+          for (int i = 0; i < out_size; i++) {
+            EXPECT_NEAR(sequential[i], fused[i], 1e-5f);
+          }
+        }
+      }
+    }
+  }
+}
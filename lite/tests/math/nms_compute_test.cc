@@ -0,0 +1,147 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+#include "lite/backends/host/math/nms_util.h"
+
+namespace math = paddle::lite::host::math;
+
+// the overlap of the kernels before the vectorised one
+static float jaccard_overlap_basic(const float* box1,
+                                   const float* box2,
+                                   bool normalized) {
+  if (box2[0] > box1[2] || box2[2] < box1[0] || box2[1] > box1[3] ||
+      box2[3] < box1[1]) {
+    return 0.f;
+  }
+  float norm = normalized ? 0.f : 1.f;
+  float inter_w = std::min(box1[2], box2[2]) - std::max(box1[0], box2[0]);
+  float inter_h = std::min(box1[3], box2[3]) - std::max(box1[1], box2[1]);
+  float inter_area = (inter_w + norm) * (inter_h + norm);
+  float area1 = (box1[2] - box1[0] + norm) * (box1[3] - box1[1] + norm);
+  float area2 = (box2[2] - box2[0] + norm) * (box2[3] - box2[1] + norm);
+  return inter_area / (area1 + area2 - inter_area);
+}
+
+static std::vector<int> greedy_nms_basic(
+    const std::vector<float>& boxes,
+    int stride,
+    const std::vector<std::pair<float, int>>& candidates,
+    float threshold,
+    float eta,
+    bool normalized) {
+  std::vector<int> selected;
+  for (auto& candidate : candidates) {
+    bool keep = true;
+    for (int kept : selected) {
+      float overlap = jaccard_overlap_basic(
+          &boxes[candidate.second * stride], &boxes[kept * stride], normalized);
+      if (overlap > threshold) {
+        keep = false;
+        break;
+      }
+    }
+    if (keep) {
+      selected.push_back(candidate.second);
+      if (eta < 1 && threshold > 0.5) {
+        threshold *= eta;
+      }
+    }
+  }
+  return selected;
+}
+
+// boxes of a stride of 4 to 6 floats, the counts leave the scalar tails of
+// the simd loops
+TEST(nms, greedy_nms) {
+  for (int test = 0; test < 32; test++) {
+    std::mt19937 rng(test);
+    std::uniform_real_distribution<float> dist(0.f, 100.f);
+    int num = 1 + test * 37 % 500;
+    int stride = 4 + test % 3;
+    bool normalized = test % 2;
+    float eta = test % 4 < 2 ? 1.f : 0.9f;
+    float threshold = 0.3f + 0.05f * (test % 8);
+    std::vector<float> boxes(num * stride);
+    std::vector<std::pair<float, int>> candidates;
+    for (int i = 0; i < num; i++) {
+      float* box = &boxes[i * stride];
+      box[0] = dist(rng);
+      box[1] = dist(rng);
+      box[2] = box[0] + dist(rng) / 3;
+      box[3] = box[1] + dist(rng) / 3;
+      candidates.emplace_back(dist(rng), i);
+    }
+    std::sort(candidates.begin(),
+              candidates.end(),
+              math::ScoreIndexDescend<float>);
+
+    auto basic = greedy_nms_basic(
+        boxes, stride, candidates, threshold, eta, normalized);
+    std::vector<int> selected;
+    math::GreedyNMS(boxes.data(),
+                    stride,
+                    candidates.data(),
+                    num,
+                    threshold,
+                    eta,
+                    normalized,
+                    -1,
+                    &selected);
+    EXPECT_EQ(basic, selected) << "test " << test;
+
+    basic.resize(std::min<size_t>(3, basic.size()));
+    selected.clear();
+    math::GreedyNMS(boxes.data(),
+                    stride,
+                    candidates.data(),
+                    num,
+                    threshold,
+                    eta,
+                    normalized,
+                    3,
+                    &selected);
+    EXPECT_EQ(basic, selected) << "test " << test << " max_keep 3";
+  }
+}
+
+TEST(nms, top_k_score_index) {
+  std::mt19937 rng(0);
+  // few distinct scores, the ties keep the ascending indices
+  std::uniform_int_distribution<int> dist(0, 20);
+  std::vector<float> scores(999);
+  for (auto& score : scores) {
+    score = dist(rng) / 20.f;
+  }
+  // every third score
+  std::vector<std::pair<float, int>> all;
+  math::GetTopKScoreIndex(scores.data(), 333, 3, 0.3f, -1, &all);
+  for (size_t i = 0; i < all.size(); i++) {
+    EXPECT_GT(all[i].first, 0.3f);
+    EXPECT_EQ(all[i].first, scores[all[i].second * 3]);
+    if (i > 0) {
+      EXPECT_TRUE(all[i - 1].first > all[i].first ||
+                  (all[i - 1].first == all[i].first &&
+                   all[i - 1].second < all[i].second));
+    }
+  }
+  std::vector<std::pair<float, int>> top_k;
+  math::GetTopKScoreIndex(scores.data(), 333, 3, 0.3f, 50, &top_k);
+  all.resize(50);
+  EXPECT_EQ(all, top_k);
+}
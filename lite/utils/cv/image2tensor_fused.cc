@@ -0,0 +1,260 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/utils/cv/image2tensor_fused.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "lite/core/parallel_defines.h"
+#include "lite/utils/cv/image_rows.h"
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+
+// the rows of a task share the horizontally resized source rows, an even
+// count lets the nv12(nv21) rows share their uv row too
+static const int kFusedRowsPerTask = 16;
+
+// a plane of pixels of num bytes, resized from srcw x srch to dstw x dsth
+struct ResizePlane {
+  const uint8_t* src;
+  int stride;
+  int dstw;
+  int num;
+  bool identity;  // the same size, the rows are read in place
+  ResizeCoefs coefs;
+};
+
+static void init_plane(ResizePlane* plane,
+                       const uint8_t* src,
+                       int stride,
+                       int srcw,
+                       int srch,
+                       int dstw,
+                       int dsth,
+                       int num,
+                       double scale_x,
+                       double scale_y,
+                       bool identity) {
+  plane->src = src;
+  plane->stride = stride;
+  plane->dstw = dstw;
+  plane->num = num;
+  plane->identity = identity;
+  if (!identity) {
+    compute_resize_coefs(
+        srcw, srch, dstw, dsth, num, scale_x, scale_y, &plane->coefs);
+  }
+}
+
+// the resized rows of a plane in order, as resize_one_channel of
+// image_resize.cc it keeps the two horizontally resized source rows
+class RowResizer {
+ public:
+  explicit RowResizer(const ResizePlane& plane) : plane_(plane) {
+    int row_size = plane.dstw * plane.num;
+    rowsbuf_.resize(row_size * 2);
+    rows0_ = rowsbuf_.data();
+    rows1_ = rows0_ + row_size;
+    line_.resize(row_size);
+  }
+
+  const uint8_t* row(int dy, bool simd) {
+    if (plane_.identity) {
+      return plane_.src + plane_.stride * dy;
+    }
+    if (dy == prev_dy_) {
+      return line_.data();
+    }
+    const ResizeCoefs& coefs = plane_.coefs;
+    int sy = coefs.yofs[dy];
+    if (sy == prev_sy_ + 1) {
+      std::swap(rows0_, rows1_);
+      hresize(sy + 1, rows1_, simd);
+    } else if (sy != prev_sy_) {
+      hresize(sy, rows0_, simd);
+      hresize(sy + 1, rows1_, simd);
+    }
+    prev_sy_ = sy;
+    prev_dy_ = dy;
+    vresize_row(rows0_,
+                rows1_,
+                coefs.ibeta[dy * 2],
+                coefs.ibeta[dy * 2 + 1],
+                plane_.dstw * plane_.num,
+                line_.data(),
+                simd);
+    return line_.data();
+  }
+
+ private:
+  void hresize(int sy, int16_t* rows, bool simd) {
+    hresize_row(plane_.src + plane_.stride * sy,
+                plane_.coefs.xofs.data(),
+                plane_.coefs.ialpha.data(),
+                plane_.dstw,
+                plane_.num,
+                rows,
+                simd);
+  }
+
+  const ResizePlane& plane_;
+  std::vector<int16_t> rowsbuf_;
+  int16_t* rows0_;
+  int16_t* rows1_;
+  std::vector<uint8_t> line_;
+  int prev_sy_{-2};
+  int prev_dy_{-1};
+};
+
+/*
+ * param src: input image data
+ * param dst: output tensor data of dsth * dstw * 3 (1 for GRAY) floats
+ * param srcFormat: NV12(NV21), BGR(RGB), BGRA(RGBA) or GRAY
+ * param dstFormat: BGR(RGB), or GRAY of a GRAY image, the nv12(nv21) pixels
+ * are in bgr order for RGB too, as image_convert
+ * param layout: output tensor layout，support NHWC and NCHW
+ * param means: means of image
+ * param scales: scales of image
+ */
+void Image2TensorFused::choose(const uint8_t* src,
+                               float* dst,
+                               ImageFormat srcFormat,
+                               ImageFormat dstFormat,
+                               LayoutType layout,
+                               int srcw,
+                               int srch,
+                               int dstw,
+                               int dsth,
+                               const float* means,
+                               const float* scales,
+                               bool simd) {
+  bool nv = srcFormat == NV12 || srcFormat == NV21;
+  int channels = 0;
+  if (srcFormat == BGR || srcFormat == RGB) {
+    channels = 3;
+  } else if (srcFormat == BGRA || srcFormat == RGBA) {
+    channels = 4;
+  } else if (srcFormat == GRAY) {
+    channels = 1;
+  }
+  bool color_dst = dstFormat == BGR || dstFormat == RGB;
+  bool supported = (nv && color_dst) || (channels > 1 && color_dst) ||
+                   (channels == 1 && dstFormat == GRAY);
+  if (!supported ||
+      (layout != LayoutType::kNCHW && layout != LayoutType::kNHWC)) {
+    printf("srcFormat: %d, dstFormat: %d, layout: %d does not support! \n",
+           srcFormat,
+           dstFormat,
+           static_cast<int>(layout));
+    return;
+  }
+  bool swap_rb = channels > 1 && (srcFormat == BGR || srcFormat == BGRA) !=
+                                     (dstFormat == BGR);
+  int out_channels = channels == 1 ? 1 : 3;
+  bool identity = srcw == dstw && srch == dsth;
+  double scale_x = static_cast<double>(srcw) / dstw;
+  double scale_y = static_cast<double>(srch) / dsth;
+
+  ResizePlane plane;
+  ResizePlane uv_plane;
+  int dst_uv_h = dsth / 2;
+  if (nv) {
+    init_plane(&plane,
+               src,
+               srcw,
+               srcw,
+               srch,
+               dstw,
+               dsth,
+               1,
+               scale_x,
+               scale_y,
+               identity);
+    // as nv21_resize, pairs of bytes of half the height
+    init_plane(&uv_plane,
+               src + srcw * srch,
+               srcw,
+               srcw / 2,
+               srch / 2,
+               dstw / 2,
+               dst_uv_h,
+               2,
+               scale_x,
+               static_cast<double>(srch / 2) / dst_uv_h,
+               identity);
+  } else {
+    init_plane(&plane,
+               src,
+               srcw * channels,
+               srcw,
+               srch,
+               dstw,
+               dsth,
+               channels,
+               scale_x,
+               scale_y,
+               identity);
+  }
+
+  LITE_PARALLEL_COMMON_BEGIN(dy0, tid, dsth, 0, kFusedRowsPerTask) {
+    RowResizer resizer(plane);
+    RowResizer uv_resizer(nv ? uv_plane : plane);
+    std::vector<uint8_t> bgr(nv ? dstw * 3 : 0);
+    int dy_end = std::min(dy0 + kFusedRowsPerTask, dsth);
+    for (int dy = dy0; dy < dy_end; dy++) {
+      const uint8_t* pixels = resizer.row(dy, simd);
+      int pixel_channels = channels;
+      if (nv) {
+        int uv_dy = identity ? dy / 2 : std::min(dy / 2, dst_uv_h - 1);
+        nv_to_bgr_row(pixels,
+                      uv_resizer.row(uv_dy, simd),
+                      dstw,
+                      srcFormat == NV21,
+                      3,
+                      bgr.data(),
+                      simd);
+        pixels = bgr.data();
+        pixel_channels = 3;
+      }
+      if (layout == LayoutType::kNCHW) {
+        to_tensor_chw_row(pixels,
+                          dstw,
+                          pixel_channels,
+                          swap_rb,
+                          means,
+                          scales,
+                          dst + dy * dstw,
+                          dstw * dsth,
+                          simd);
+      } else {
+        to_tensor_hwc_row(pixels,
+                          dstw,
+                          pixel_channels,
+                          swap_rb,
+                          means,
+                          scales,
+                          dst + dy * dstw * out_channels,
+                          simd);
+      }
+    }
+  }
+  LITE_PARALLEL_COMMON_END();
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
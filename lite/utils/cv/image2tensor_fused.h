@@ -0,0 +1,51 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include "lite/utils/cv/paddle_image_preprocess.h"
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+/*
+ * resize, color convert and image to tensor in one pass over the image: each
+ * output row is resized, converted and normalized while it is in the cache.
+ * The tensor is the one of image_resize + image_convert + image_to_tensor.
+ */
+class Image2TensorFused {
+ public:
+  /*
+   * param srcFormat: NV12(NV21), BGR(RGB), BGRA(RGBA) or GRAY
+   * param dstFormat: BGR(RGB) of a color image, GRAY of a GRAY one
+   * param simd: false runs the plain C++ rows, for the tests and benchmarks
+   */
+  void choose(const uint8_t* src,
+              float* dst,
+              ImageFormat srcFormat,
+              ImageFormat dstFormat,
+              LayoutType layout,
+              int srcw,
+              int srch,
+              int dstw,
+              int dsth,
+              const float* means,
+              const float* scales,
+              bool simd = true);
+};
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
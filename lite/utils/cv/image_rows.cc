@@ -0,0 +1,976 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/utils/cv/image_rows.h"
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#ifdef LITE_CV_WITH_X86_SIMD
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+
+#ifdef LITE_CV_WITH_X86_SIMD
+bool cpu_has_sse41() {
+#if defined(_MSC_VER)
+  static const bool has_sse41 = [] {
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+  }();
+#else
+  static const bool has_sse41 = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.1") != 0;
+  }();
+#endif
+  return has_sse41;
+}
+
+bool cpu_has_avx2() {
+#if defined(_MSC_VER)
+  static const bool has_avx2 = [] {
+    int info[4];
+    __cpuid(info, 1);
+    bool fma = (info[2] & (1 << 12)) != 0;
+    bool os_avx = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    return fma && os_avx && (info[1] & (1 << 5)) != 0;
+  }();
+#else
+  static const bool has_avx2 = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  }();
+#endif
+  return has_avx2;
+}
+#endif
+
+void compute_resize_coefs(int srcw,
+                          int srch,
+                          int dstw,
+                          int dsth,
+                          int num,
+                          double scale_x,
+                          double scale_y,
+                          ResizeCoefs* coefs) {
+  const int resize_coef_bits = 11;
+  const int resize_coef_scale = 1 << resize_coef_bits;
+  coefs->xofs.resize(dstw);
+  coefs->yofs.resize(dsth);
+  coefs->ialpha.resize(dstw * 2);
+  coefs->ibeta.resize(dsth * 2);
+#define SATURATE_CAST_SHORT(X)                                               \
+  (int16_t)::std::min(                                                       \
+      ::std::max(static_cast<int>(X + (X >= 0.f ? 0.5f : -0.5f)), SHRT_MIN), \
+      SHRT_MAX);
+  for (int dx = 0; dx < dstw; dx++) {
+    float fx = static_cast<float>((dx + 0.5) * scale_x - 0.5);
+    int sx = floor(fx);
+    fx -= sx;
+    if (sx < 0) {
+      sx = 0;
+      fx = 0.f;
+    }
+    if (sx >= srcw - 1) {
+      sx = srcw - 2;
+      fx = 1.f;
+    }
+    coefs->xofs[dx] = sx * num;
+    float a0 = (1.f - fx) * resize_coef_scale;
+    float a1 = fx * resize_coef_scale;
+    coefs->ialpha[dx * 2] = SATURATE_CAST_SHORT(a0);
+    coefs->ialpha[dx * 2 + 1] = SATURATE_CAST_SHORT(a1);
+  }
+  for (int dy = 0; dy < dsth; dy++) {
+    float fy = static_cast<float>((dy + 0.5) * scale_y - 0.5);
+    int sy = floor(fy);
+    fy -= sy;
+    if (sy < 0) {
+      sy = 0;
+      fy = 0.f;
+    }
+    if (sy >= srch - 1) {
+      sy = srch - 2;
+      fy = 1.f;
+    }
+    coefs->yofs[dy] = sy;
+    float b0 = (1.f - fy) * resize_coef_scale;
+    float b1 = fy * resize_coef_scale;
+    coefs->ibeta[dy * 2] = SATURATE_CAST_SHORT(b0);
+    coefs->ibeta[dy * 2 + 1] = SATURATE_CAST_SHORT(b1);
+  }
+#undef SATURATE_CAST_SHORT
+}
+
+#ifdef LITE_CV_WITH_X86_SIMD
+static inline int load_u16(const uint8_t* ptr) {
+  uint16_t val;
+  memcpy(&val, ptr, sizeof(val));
+  return val;
+}
+
+static inline int load_u32(const void* ptr) {
+  int val;
+  memcpy(&val, ptr, sizeof(val));
+  return val;
+}
+
+static inline int64_t load_u48(const uint8_t* ptr) {
+  int64_t val = 0;
+  memcpy(&val, ptr, 6);
+  return val;
+}
+
+static inline int64_t load_u64(const uint8_t* ptr) {
+  int64_t val;
+  memcpy(&val, ptr, sizeof(val));
+  return val;
+}
+
+// splits 16 pixels of 3(4) bytes into the vectors of their first 3 bytes
+LITE_CV_TARGET_SSE41 static inline void load_deinterleave(
+    const uint8_t* src, int channels, __m128i* c0, __m128i* c1, __m128i* c2) {
+  if (channels == 3) {
+    __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+    __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+    *c0 = _mm_or_si128(
+        _mm_or_si128(
+            _mm_shuffle_epi8(v0,
+                             _mm_setr_epi8(
+                                 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1,
+                                 -1, -1, -1, -1)),
+            _mm_shuffle_epi8(v1,
+                             _mm_setr_epi8(
+                                 -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1,
+                                 -1, -1, -1, -1))),
+        _mm_shuffle_epi8(
+            v2,
+            _mm_setr_epi8(
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13)));
+    *c1 = _mm_or_si128(
+        _mm_or_si128(
+            _mm_shuffle_epi8(v0,
+                             _mm_setr_epi8(
+                                 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1,
+                                 -1, -1, -1, -1)),
+            _mm_shuffle_epi8(v1,
+                             _mm_setr_epi8(
+                                 -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1,
+                                 -1, -1, -1, -1))),
+        _mm_shuffle_epi8(
+            v2,
+            _mm_setr_epi8(
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14)));
+    *c2 = _mm_or_si128(
+        _mm_or_si128(
+            _mm_shuffle_epi8(v0,
+                             _mm_setr_epi8(
+                                 2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1,
+                                 -1, -1, -1, -1)),
+            _mm_shuffle_epi8(v1,
+                             _mm_setr_epi8(
+                                 -1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1,
+                                 -1, -1, -1, -1))),
+        _mm_shuffle_epi8(
+            v2,
+            _mm_setr_epi8(
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15)));
+  } else {
+    const __m128i mask = _mm_setr_epi8(
+        0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    __m128i v0 = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), mask);
+    __m128i v1 = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16)), mask);
+    __m128i v2 = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32)), mask);
+    __m128i v3 = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48)), mask);
+    __m128i t0 = _mm_unpacklo_epi32(v0, v1);
+    __m128i t1 = _mm_unpacklo_epi32(v2, v3);
+    __m128i t2 = _mm_unpackhi_epi32(v0, v1);
+    __m128i t3 = _mm_unpackhi_epi32(v2, v3);
+    *c0 = _mm_unpacklo_epi64(t0, t1);
+    *c1 = _mm_unpackhi_epi64(t0, t1);
+    *c2 = _mm_unpacklo_epi64(t2, t3);
+  }
+}
+
+// stores 16 pixels of b, g, r as bgr, or bgra with a = 255
+LITE_CV_TARGET_SSE41 static inline void store_interleave(
+    uint8_t* dst, int channels, __m128i b, __m128i g, __m128i r) {
+  if (channels == 3) {
+    __m128i v0 = _mm_or_si128(
+        _mm_or_si128(
+            _mm_shuffle_epi8(
+                b,
+                _mm_setr_epi8(
+                    0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5)),
+            _mm_shuffle_epi8(g,
+                             _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1,
+                                           3, -1, -1, 4, -1, -1))),
+        _mm_shuffle_epi8(
+            r,
+            _mm_setr_epi8(
+                -1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1)));
+    __m128i v1 = _mm_or_si128(
+        _mm_or_si128(
+            _mm_shuffle_epi8(b,
+                             _mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1,
+                                           -1, 9, -1, -1, 10, -1)),
+            _mm_shuffle_epi8(g,
+                             _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8,
+                                           -1, -1, 9, -1, -1, 10))),
+        _mm_shuffle_epi8(
+            r,
+            _mm_setr_epi8(
+                -1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1)));
+    __m128i v2 = _mm_or_si128(
+        _mm_or_si128(
+            _mm_shuffle_epi8(b,
+                             _mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1,
+                                           -1, 14, -1, -1, 15, -1, -1)),
+            _mm_shuffle_epi8(g,
+                             _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13,
+                                           -1, -1, 14, -1, -1, 15, -1))),
+        _mm_shuffle_epi8(r,
+                         _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13,
+                                       -1, -1, 14, -1, -1, 15)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), v1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), v2);
+  } else {
+    const __m128i a = _mm_set1_epi8(static_cast<char>(255));
+    __m128i bg_lo = _mm_unpacklo_epi8(b, g);
+    __m128i bg_hi = _mm_unpackhi_epi8(b, g);
+    __m128i ra_lo = _mm_unpacklo_epi8(r, a);
+    __m128i ra_hi = _mm_unpackhi_epi8(r, a);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm_unpacklo_epi16(bg_lo, ra_lo));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16),
+                     _mm_unpackhi_epi16(bg_lo, ra_lo));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32),
+                     _mm_unpacklo_epi16(bg_hi, ra_hi));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 48),
+                     _mm_unpackhi_epi16(bg_hi, ra_hi));
+  }
+}
+#endif  // LITE_CV_WITH_X86_SIMD
+
+#ifdef LITE_CV_WITH_X86_SIMD
+// the pixel pairs are gathered by scalar loads, a madd weights them
+LITE_CV_TARGET_SSE41 static int hresize_row_sse41(const uint8_t* src,
+                                                  const int* xofs,
+                                                  const int16_t* ialpha,
+                                                  int dstw,
+                                                  int num,
+                                                  int16_t* rows) {
+  int dx = 0;
+  if (num == 1) {
+    const __m128i zero = _mm_setzero_si128();
+    for (; dx + 8 <= dstw; dx += 8) {
+      const int* x = xofs + dx;
+      __m128i s = _mm_setr_epi16(load_u16(src + x[0]),
+                                 load_u16(src + x[1]),
+                                 load_u16(src + x[2]),
+                                 load_u16(src + x[3]),
+                                 load_u16(src + x[4]),
+                                 load_u16(src + x[5]),
+                                 load_u16(src + x[6]),
+                                 load_u16(src + x[7]));
+      __m128i a_lo = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(ialpha + dx * 2));
+      __m128i a_hi = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(ialpha + dx * 2 + 8));
+      __m128i v_lo =
+          _mm_srai_epi32(_mm_madd_epi16(_mm_cvtepu8_epi16(s), a_lo), 4);
+      __m128i v_hi =
+          _mm_srai_epi32(_mm_madd_epi16(_mm_unpackhi_epi8(s, zero), a_hi), 4);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(rows + dx),
+                       _mm_packs_epi32(v_lo, v_hi));
+    }
+  } else if (num == 2) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask = _mm_setr_epi8(
+        0, 2, 1, 3, 4, 6, 5, 7, 8, 10, 9, 11, 12, 14, 13, 15);
+    for (; dx + 4 <= dstw; dx += 4) {
+      const int* x = xofs + dx;
+      __m128i s = _mm_shuffle_epi8(_mm_setr_epi32(load_u32(src + x[0]),
+                                                  load_u32(src + x[1]),
+                                                  load_u32(src + x[2]),
+                                                  load_u32(src + x[3])),
+                                   mask);
+      __m128i alpha = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(ialpha + dx * 2));
+      __m128i v_lo =
+          _mm_srai_epi32(_mm_madd_epi16(_mm_cvtepu8_epi16(s),
+                                        _mm_unpacklo_epi32(alpha, alpha)),
+                         4);
+      __m128i v_hi =
+          _mm_srai_epi32(_mm_madd_epi16(_mm_unpackhi_epi8(s, zero),
+                                        _mm_unpackhi_epi32(alpha, alpha)),
+                         4);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(rows + dx * 2),
+                       _mm_packs_epi32(v_lo, v_hi));
+    }
+  } else if (num == 3 || num == 4) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask =
+        num == 3
+            ? _mm_setr_epi8(0, 3, 1, 4, 2, 5, -1, -1, 8, 11, 9, 12, 10, 13, -1,
+                            -1)
+            : _mm_setr_epi8(0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11,
+                            15);
+    for (; dx + 2 <= dstw; dx += 2) {
+      const uint8_t* p0 = src + xofs[dx];
+      const uint8_t* p1 = src + xofs[dx + 1];
+      __m128i s =
+          num == 3 ? _mm_set_epi64x(load_u48(p1), load_u48(p0))
+                   : _mm_set_epi64x(load_u64(p1), load_u64(p0));
+      s = _mm_shuffle_epi8(s, mask);
+      __m128i v_lo = _mm_srai_epi32(
+          _mm_madd_epi16(_mm_cvtepu8_epi16(s),
+                         _mm_set1_epi32(load_u32(ialpha + dx * 2))),
+          4);
+      __m128i v_hi = _mm_srai_epi32(
+          _mm_madd_epi16(_mm_unpackhi_epi8(s, zero),
+                         _mm_set1_epi32(load_u32(ialpha + dx * 2 + 2))),
+          4);
+      __m128i v = _mm_packs_epi32(v_lo, v_hi);
+      if (num == 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(rows + dx * 4), v);
+      } else {
+        // drop the zero lane after each pixel
+        v = _mm_shuffle_epi8(v,
+                             _mm_setr_epi8(0, 1, 2, 3, 4, 5, 8, 9, 10, 11, 12,
+                                           13, -1, -1, -1, -1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(rows + dx * 3), v);
+        int tail = _mm_extract_epi32(v, 2);
+        memcpy(rows + dx * 3 + 4, &tail, sizeof(tail));
+      }
+    }
+  }
+  return dx;
+}
+#endif
+
+void hresize_row(const uint8_t* src,
+                 const int* xofs,
+                 const int16_t* ialpha,
+                 int dstw,
+                 int num,
+                 int16_t* rows,
+                 bool simd) {
+  int dx = 0;
+#ifdef LITE_CV_WITH_X86_SIMD
+  if (simd && cpu_has_sse41()) {
+    dx = hresize_row_sse41(src, xofs, ialpha, dstw, num, rows);
+  }
+#endif
+  for (; dx < dstw; dx++) {
+    int sx = xofs[dx];
+    int16_t a0 = ialpha[dx * 2];
+    int16_t a1 = ialpha[dx * 2 + 1];
+    const uint8_t* sp = src + sx;
+    int16_t* rp = rows + dx * num;
+    for (int c = 0; c < num; c++) {
+      rp[c] = (sp[c] * a0 + sp[c + num] * a1) >> 4;
+    }
+  }
+}
+
+#ifdef LITE_CV_WITH_X86_SIMD
+LITE_CV_TARGET_AVX2 static int vresize_row_avx2(const int16_t* rows0,
+                                                const int16_t* rows1,
+                                                int16_t b0,
+                                                int16_t b1,
+                                                int size,
+                                                uint8_t* dst) {
+  int x = 0;
+  const __m256i wb0 = _mm256_set1_epi16(b0);
+  const __m256i wb1 = _mm256_set1_epi16(b1);
+  const __m256i w2 = _mm256_set1_epi16(2);
+  for (; x + 32 <= size; x += 32) {
+    __m256i r0a =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows0 + x));
+    __m256i r1a =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows1 + x));
+    __m256i r0b =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows0 + x + 16));
+    __m256i r1b =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows1 + x + 16));
+    // mulhi is (rows * b) >> 16
+    __m256i a = _mm256_add_epi16(
+        _mm256_add_epi16(_mm256_mulhi_epi16(r0a, wb0),
+                         _mm256_mulhi_epi16(r1a, wb1)),
+        w2);
+    __m256i b = _mm256_add_epi16(
+        _mm256_add_epi16(_mm256_mulhi_epi16(r0b, wb0),
+                         _mm256_mulhi_epi16(r1b, wb1)),
+        w2);
+    __m256i out = _mm256_packus_epi16(_mm256_srai_epi16(a, 2),
+                                      _mm256_srai_epi16(b, 2));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x),
+                        _mm256_permute4x64_epi64(out, 0xD8));
+  }
+  return x;
+}
+
+LITE_CV_TARGET_SSE41 static int vresize_row_sse41(const int16_t* rows0,
+                                                  const int16_t* rows1,
+                                                  int16_t b0,
+                                                  int16_t b1,
+                                                  int size,
+                                                  uint8_t* dst,
+                                                  int x) {
+  const __m128i vb0 = _mm_set1_epi16(b0);
+  const __m128i vb1 = _mm_set1_epi16(b1);
+  const __m128i v2 = _mm_set1_epi16(2);
+  for (; x + 16 <= size; x += 16) {
+    __m128i r0a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows0 + x));
+    __m128i r1a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows1 + x));
+    __m128i r0b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows0 + x + 8));
+    __m128i r1b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows1 + x + 8));
+    __m128i a = _mm_add_epi16(
+        _mm_add_epi16(_mm_mulhi_epi16(r0a, vb0), _mm_mulhi_epi16(r1a, vb1)),
+        v2);
+    __m128i b = _mm_add_epi16(
+        _mm_add_epi16(_mm_mulhi_epi16(r0b, vb0), _mm_mulhi_epi16(r1b, vb1)),
+        v2);
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst + x),
+        _mm_packus_epi16(_mm_srai_epi16(a, 2), _mm_srai_epi16(b, 2)));
+  }
+  return x;
+}
+#endif
+
+void vresize_row(const int16_t* rows0,
+                 const int16_t* rows1,
+                 int16_t b0,
+                 int16_t b1,
+                 int size,
+                 uint8_t* dst,
+                 bool simd) {
+  int x = 0;
+#ifdef LITE_CV_WITH_X86_SIMD
+  if (simd && cpu_has_avx2()) {
+    x = vresize_row_avx2(rows0, rows1, b0, b1, size, dst);
+  }
+  if (simd && cpu_has_sse41()) {
+    x = vresize_row_sse41(rows0, rows1, b0, b1, size, dst, x);
+  }
+#endif
+  for (; x < size; x++) {
+    dst[x] = (uint8_t)(((int16_t)((b0 * rows0[x]) >> 16) +
+                        (int16_t)((b1 * rows1[x]) >> 16) + 2) >>
+                       2);
+  }
+}
+
+#ifdef LITE_CV_WITH_X86_SIMD
+LITE_CV_TARGET_AVX2 static int nv_to_bgr_row_avx2(const uint8_t* y,
+                                                  const uint8_t* uv,
+                                                  int width,
+                                                  bool nv21,
+                                                  int channels,
+                                                  uint8_t* dst) {
+  int j = 0;
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i v128 = _mm256_set1_epi16(128);
+  const __m256i low_byte = _mm256_set1_epi16(0xff);
+  for (; j + 32 <= width; j += 32) {
+    __m256i vy = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + j));
+    __m256i vuv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(uv + j));
+    __m256i first = _mm256_sub_epi16(_mm256_and_si256(vuv, low_byte), v128);
+    __m256i second = _mm256_sub_epi16(_mm256_srli_epi16(vuv, 8), v128);
+    __m256i u = nv21 ? second : first;
+    __m256i v = nv21 ? first : second;
+    __m256i ra = _mm256_srai_epi16(
+        _mm256_mullo_epi16(v, _mm256_set1_epi16(179)), 7);
+    __m256i ga = _mm256_srai_epi16(
+        _mm256_add_epi16(_mm256_mullo_epi16(u, _mm256_set1_epi16(44)),
+                         _mm256_mullo_epi16(v, _mm256_set1_epi16(91))),
+        7);
+    __m256i ba = _mm256_srai_epi16(
+        _mm256_mullo_epi16(u, _mm256_set1_epi16(227)), 7);
+    // a uv pair is shared by two pixels, in each 128 bits lane
+    __m256i y_lo = _mm256_unpacklo_epi8(vy, zero);
+    __m256i y_hi = _mm256_unpackhi_epi8(vy, zero);
+    __m256i b = _mm256_packus_epi16(
+        _mm256_add_epi16(y_lo, _mm256_unpacklo_epi16(ba, ba)),
+        _mm256_add_epi16(y_hi, _mm256_unpackhi_epi16(ba, ba)));
+    __m256i g = _mm256_packus_epi16(
+        _mm256_sub_epi16(y_lo, _mm256_unpacklo_epi16(ga, ga)),
+        _mm256_sub_epi16(y_hi, _mm256_unpackhi_epi16(ga, ga)));
+    __m256i r = _mm256_packus_epi16(
+        _mm256_add_epi16(y_lo, _mm256_unpacklo_epi16(ra, ra)),
+        _mm256_add_epi16(y_hi, _mm256_unpackhi_epi16(ra, ra)));
+    store_interleave(dst + j * channels,
+                     channels,
+                     _mm256_castsi256_si128(b),
+                     _mm256_castsi256_si128(g),
+                     _mm256_castsi256_si128(r));
+    store_interleave(dst + (j + 16) * channels,
+                     channels,
+                     _mm256_extracti128_si256(b, 1),
+                     _mm256_extracti128_si256(g, 1),
+                     _mm256_extracti128_si256(r, 1));
+  }
+  return j;
+}
+
+LITE_CV_TARGET_SSE41 static int nv_to_bgr_row_sse41(const uint8_t* y,
+                                                    const uint8_t* uv,
+                                                    int width,
+                                                    bool nv21,
+                                                    int channels,
+                                                    uint8_t* dst,
+                                                    int j) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i v128 = _mm_set1_epi16(128);
+  const __m128i low_byte = _mm_set1_epi16(0xff);
+  for (; j + 16 <= width; j += 16) {
+    __m128i vy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + j));
+    __m128i vuv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(uv + j));
+    __m128i first = _mm_sub_epi16(_mm_and_si128(vuv, low_byte), v128);
+    __m128i second = _mm_sub_epi16(_mm_srli_epi16(vuv, 8), v128);
+    __m128i u = nv21 ? second : first;
+    __m128i v = nv21 ? first : second;
+    __m128i ra = _mm_srai_epi16(_mm_mullo_epi16(v, _mm_set1_epi16(179)), 7);
+    __m128i ga = _mm_srai_epi16(
+        _mm_add_epi16(_mm_mullo_epi16(u, _mm_set1_epi16(44)),
+                      _mm_mullo_epi16(v, _mm_set1_epi16(91))),
+        7);
+    __m128i ba = _mm_srai_epi16(_mm_mullo_epi16(u, _mm_set1_epi16(227)), 7);
+    __m128i y_lo = _mm_unpacklo_epi8(vy, zero);
+    __m128i y_hi = _mm_unpackhi_epi8(vy, zero);
+    __m128i b = _mm_packus_epi16(
+        _mm_add_epi16(y_lo, _mm_unpacklo_epi16(ba, ba)),
+        _mm_add_epi16(y_hi, _mm_unpackhi_epi16(ba, ba)));
+    __m128i g = _mm_packus_epi16(
+        _mm_sub_epi16(y_lo, _mm_unpacklo_epi16(ga, ga)),
+        _mm_sub_epi16(y_hi, _mm_unpackhi_epi16(ga, ga)));
+    __m128i r = _mm_packus_epi16(
+        _mm_add_epi16(y_lo, _mm_unpacklo_epi16(ra, ra)),
+        _mm_add_epi16(y_hi, _mm_unpackhi_epi16(ra, ra)));
+    store_interleave(dst + j * channels, channels, b, g, r);
+  }
+  return j;
+}
+#endif
+
+/*
+R = Y + 1.402*(V-128);
+G = Y - 0.34414*(U-128) - 0.71414*(V-128);
+B = Y + 1.772*(U-128);
+in 7 bits fixed point, as image_convert.cc
+*/
+void nv_to_bgr_row(const uint8_t* y,
+                   const uint8_t* uv,
+                   int width,
+                   bool nv21,
+                   int channels,
+                   uint8_t* dst,
+                   bool simd) {
+  int j = 0;
+#ifdef LITE_CV_WITH_X86_SIMD
+  if (simd && cpu_has_avx2()) {
+    j = nv_to_bgr_row_avx2(y, uv, width, nv21, channels, dst);
+  }
+  if (simd && cpu_has_sse41()) {
+    j = nv_to_bgr_row_sse41(y, uv, width, nv21, channels, dst, j);
+  }
+#endif
+  uint8_t* out = dst + j * channels;
+  for (; j < width; j += 2) {
+    int u = nv21 ? uv[j + 1] : uv[j];
+    int v = nv21 ? uv[j] : uv[j + 1];
+    int ra = (179 * (v - 128)) >> 7;
+    int ga = (44 * (u - 128) + 91 * (v - 128)) >> 7;
+    int ba = (227 * (u - 128)) >> 7;
+    for (int k = j; k < j + 2 && k < width; k++) {
+      int r = y[k] + ra;
+      int g = y[k] - ga;
+      int b = y[k] + ba;
+      *out++ = b < 0 ? 0 : (b > 255) ? 255 : b;
+      *out++ = g < 0 ? 0 : (g > 255) ? 255 : g;
+      *out++ = r < 0 ? 0 : (r > 255) ? 255 : r;
+      if (channels == 4) {
+        *out++ = 255;
+      }
+    }
+  }
+}
+
+#ifdef LITE_CV_WITH_X86_SIMD
+LITE_CV_TARGET_SSE41 static int bgr_to_gray_row_sse41(const uint8_t* src,
+                                                      int width,
+                                                      int channels,
+                                                      uint8_t* dst) {
+  int j = 0;
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i wb = _mm_set1_epi16(15);
+  const __m128i wg = _mm_set1_epi16(75);
+  const __m128i wr = _mm_set1_epi16(38);
+  for (; j + 16 <= width; j += 16) {
+    __m128i b, g, r;
+    load_deinterleave(src + j * channels, channels, &b, &g, &r);
+    // 15 + 75 + 38 = 128, the sums fit in int16
+    __m128i lo = _mm_add_epi16(
+        _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), wb),
+                      _mm_mullo_epi16(_mm_unpacklo_epi8(g, zero), wg)),
+        _mm_mullo_epi16(_mm_unpacklo_epi8(r, zero), wr));
+    __m128i hi = _mm_add_epi16(
+        _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), wb),
+                      _mm_mullo_epi16(_mm_unpackhi_epi8(g, zero), wg)),
+        _mm_mullo_epi16(_mm_unpackhi_epi8(r, zero), wr));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst + j),
+        _mm_packus_epi16(_mm_srli_epi16(lo, 7), _mm_srli_epi16(hi, 7)));
+  }
+  return j;
+}
+#endif
+
+void bgr_to_gray_row(const uint8_t* src,
+                     int width,
+                     int channels,
+                     uint8_t* dst,
+                     bool simd) {
+  int j = 0;
+#ifdef LITE_CV_WITH_X86_SIMD
+  if (simd && cpu_has_sse41()) {
+    j = bgr_to_gray_row_sse41(src, width, channels, dst);
+  }
+#endif
+  const uint8_t* in = src + j * channels;
+  for (; j < width; j++) {
+    dst[j] = (in[0] * 15 + in[1] * 75 + in[2] * 38) >> 7;
+    in += channels;
+  }
+}
+
+#ifdef LITE_CV_WITH_X86_SIMD
+// bgra <-> rgba in place of each pixel
+LITE_CV_TARGET_AVX2 static int swap_rb4_row_avx2(const uint8_t* src,
+                                                 int width,
+                                                 uint8_t* dst) {
+  int j = 0;
+  const __m256i mask = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11,
+                                        14, 13, 12, 15, 2, 1, 0, 3, 6, 5, 4,
+                                        7, 10, 9, 8, 11, 14, 13, 12, 15);
+  for (; j + 8 <= width; j += 8) {
+    __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + j * 4));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + j * 4),
+                        _mm256_shuffle_epi8(v, mask));
+  }
+  return j;
+}
+
+LITE_CV_TARGET_SSE41 static int convert_hwc_row_sse41(const uint8_t* src,
+                                                      int src_channels,
+                                                      int width,
+                                                      int dst_channels,
+                                                      bool swap_rb,
+                                                      uint8_t* dst,
+                                                      int j) {
+  if (src_channels == 4 && dst_channels == 4) {
+    const __m128i mask4 = _mm_setr_epi8(
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    for (; j + 4 <= width; j += 4) {
+      __m128i v =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j * 4));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + j * 4),
+                       _mm_shuffle_epi8(v, mask4));
+    }
+  } else {
+    for (; j + 16 <= width; j += 16) {
+      __m128i c0, c1, c2;
+      if (src_channels == 1) {
+        c0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j));
+        c1 = c0;
+        c2 = c0;
+      } else {
+        load_deinterleave(src + j * src_channels, src_channels, &c0, &c1, &c2);
+      }
+      if (swap_rb) {
+        store_interleave(dst + j * dst_channels, dst_channels, c2, c1, c0);
+      } else {
+        store_interleave(dst + j * dst_channels, dst_channels, c0, c1, c2);
+      }
+    }
+  }
+  return j;
+}
+#endif
+
+void convert_hwc_row(const uint8_t* src,
+                     int src_channels,
+                     int width,
+                     int dst_channels,
+                     bool swap_rb,
+                     uint8_t* dst,
+                     bool simd) {
+  int j = 0;
+#ifdef LITE_CV_WITH_X86_SIMD
+  if (simd && src_channels == 4 && dst_channels == 4 && cpu_has_avx2()) {
+    j = swap_rb4_row_avx2(src, width, dst);
+  }
+  if (simd && cpu_has_sse41()) {
+    j = convert_hwc_row_sse41(
+        src, src_channels, width, dst_channels, swap_rb, dst, j);
+  }
+#endif
+  const uint8_t* in = src + j * src_channels;
+  uint8_t* out = dst + j * dst_channels;
+  for (; j < width; j++) {
+    uint8_t c0 = in[0];
+    uint8_t c1 = src_channels == 1 ? in[0] : in[1];
+    uint8_t c2 = src_channels == 1 ? in[0] : in[2];
+    out[0] = swap_rb ? c2 : c0;
+    out[1] = c1;
+    out[2] = swap_rb ? c0 : c2;
+    if (dst_channels == 4) {
+      out[3] = src_channels == 4 ? in[3] : 255;
+    }
+    in += src_channels;
+    out += dst_channels;
+  }
+}
+
+#ifdef LITE_CV_WITH_X86_SIMD
+// dst[i] = (src[i] - mean) * scale for 16 bytes
+LITE_CV_TARGET_SSE41 static inline void normalize16_sse41(__m128i src,
+                                                          float mean,
+                                                          float scale,
+                                                          float* dst) {
+  const __m128 vmean = _mm_set1_ps(mean);
+  const __m128 vscale = _mm_set1_ps(scale);
+  for (int k = 0; k < 4; k++) {
+    __m128 val = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(src));
+    _mm_storeu_ps(dst + k * 4, _mm_mul_ps(_mm_sub_ps(val, vmean), vscale));
+    src = _mm_srli_si128(src, 4);
+  }
+}
+
+LITE_CV_TARGET_AVX2 static inline void normalize16_avx2(__m128i src,
+                                                        float mean,
+                                                        float scale,
+                                                        float* dst) {
+  const __m256 vmean = _mm256_set1_ps(mean);
+  const __m256 vscale = _mm256_set1_ps(scale);
+  __m256 lo = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(src));
+  __m256 hi = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(src, 8)));
+  _mm256_storeu_ps(dst, _mm256_mul_ps(_mm256_sub_ps(lo, vmean), vscale));
+  _mm256_storeu_ps(dst + 8, _mm256_mul_ps(_mm256_sub_ps(hi, vmean), vscale));
+}
+
+LITE_CV_TARGET_SSE41 static int to_tensor_chw_row_sse41(const uint8_t* src,
+                                                        int width,
+                                                        int channels,
+                                                        bool swap_rb,
+                                                        const float* means,
+                                                        const float* scales,
+                                                        float* dst,
+                                                        int plane_size) {
+  int j = 0;
+  for (; j + 16 <= width; j += 16) {
+    if (channels == 1) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j));
+      normalize16_sse41(v, means[0], scales[0], dst + j);
+      continue;
+    }
+    __m128i c[3];
+    load_deinterleave(src + j * channels, channels, &c[0], &c[1], &c[2]);
+    for (int k = 0; k < 3; k++) {
+      normalize16_sse41(c[swap_rb ? 2 - k : k],
+                        means[k],
+                        scales[k],
+                        dst + k * plane_size + j);
+    }
+  }
+  return j;
+}
+
+LITE_CV_TARGET_AVX2 static int to_tensor_chw_row_avx2(const uint8_t* src,
+                                                      int width,
+                                                      int channels,
+                                                      bool swap_rb,
+                                                      const float* means,
+                                                      const float* scales,
+                                                      float* dst,
+                                                      int plane_size) {
+  int j = 0;
+  for (; j + 16 <= width; j += 16) {
+    if (channels == 1) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j));
+      normalize16_avx2(v, means[0], scales[0], dst + j);
+      continue;
+    }
+    __m128i c[3];
+    load_deinterleave(src + j * channels, channels, &c[0], &c[1], &c[2]);
+    for (int k = 0; k < 3; k++) {
+      normalize16_avx2(c[swap_rb ? 2 - k : k],
+                       means[k],
+                       scales[k],
+                       dst + k * plane_size + j);
+    }
+  }
+  return j;
+}
+#endif
+
+void to_tensor_chw_row(const uint8_t* src,
+                       int width,
+                       int channels,
+                       bool swap_rb,
+                       const float* means,
+                       const float* scales,
+                       float* dst,
+                       int plane_size,
+                       bool simd) {
+  int out_channels = channels == 1 ? 1 : 3;
+  int j = 0;
+#ifdef LITE_CV_WITH_X86_SIMD
+  if (simd && cpu_has_avx2()) {
+    j = to_tensor_chw_row_avx2(
+        src, width, channels, swap_rb, means, scales, dst, plane_size);
+  } else if (simd && cpu_has_sse41()) {
+    j = to_tensor_chw_row_sse41(
+        src, width, channels, swap_rb, means, scales, dst, plane_size);
+  }
+#endif
+  for (int k = 0; k < out_channels; k++) {
+    const uint8_t* in = src + j * channels + (swap_rb ? 2 - k : k);
+    float* out = dst + k * plane_size;
+    for (int x = j; x < width; x++) {
+      out[x] = (*in - means[k]) * scales[k];
+      in += channels;
+    }
+  }
+}
+
+#ifdef LITE_CV_WITH_X86_SIMD
+// the `size` bytes of gray or bgr without a swap keep their order, the means
+// and scales repeat every 3 floats, returns the bytes done
+LITE_CV_TARGET_AVX2 static int to_tensor_hwc_avx2(const uint8_t* src,
+                                                  int size,
+                                                  int channels,
+                                                  const float* means,
+                                                  const float* scales,
+                                                  float* dst) {
+  int k = 0;
+  __m256 vmean[3], vscale[3];
+  for (int v = 0; v < 3; v++) {
+    float m[8], s[8];
+    for (int i = 0; i < 8; i++) {
+      m[i] = means[channels == 1 ? 0 : (v * 8 + i) % 3];
+      s[i] = scales[channels == 1 ? 0 : (v * 8 + i) % 3];
+    }
+    vmean[v] = _mm256_loadu_ps(m);
+    vscale[v] = _mm256_loadu_ps(s);
+  }
+  for (; k + 24 <= size; k += 24) {
+    for (int v = 0; v < 3; v++) {
+      __m256 val = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(
+          reinterpret_cast<const __m128i*>(src + k + v * 8))));
+      _mm256_storeu_ps(dst + k + v * 8,
+                       _mm256_mul_ps(_mm256_sub_ps(val, vmean[v]), vscale[v]));
+    }
+  }
+  return k;
+}
+
+LITE_CV_TARGET_SSE41 static int to_tensor_hwc_sse41(const uint8_t* src,
+                                                    int size,
+                                                    int channels,
+                                                    const float* means,
+                                                    const float* scales,
+                                                    float* dst,
+                                                    int k) {
+  __m128 vmean[3], vscale[3];
+  for (int v = 0; v < 3; v++) {
+    float m[4], s[4];
+    for (int i = 0; i < 4; i++) {
+      m[i] = means[channels == 1 ? 0 : (v * 4 + i) % 3];
+      s[i] = scales[channels == 1 ? 0 : (v * 4 + i) % 3];
+    }
+    vmean[v] = _mm_loadu_ps(m);
+    vscale[v] = _mm_loadu_ps(s);
+  }
+  for (; k + 12 <= size; k += 12) {
+    for (int v = 0; v < 3; v++) {
+      __m128 val = _mm_cvtepi32_ps(
+          _mm_cvtepu8_epi32(_mm_cvtsi32_si128(load_u32(src + k + v * 4))));
+      _mm_storeu_ps(dst + k + v * 4,
+                    _mm_mul_ps(_mm_sub_ps(val, vmean[v]), vscale[v]));
+    }
+  }
+  return k;
+}
+#endif
+
+void to_tensor_hwc_row(const uint8_t* src,
+                       int width,
+                       int channels,
+                       bool swap_rb,
+                       const float* means,
+                       const float* scales,
+                       float* dst,
+                       bool simd) {
+  int out_channels = channels == 1 ? 1 : 3;
+  int j = 0;
+#ifdef LITE_CV_WITH_X86_SIMD
+  if (simd && (channels == 1 || (channels == 3 && !swap_rb))) {
+    int size = width * channels;
+    int k = 0;
+    if (cpu_has_avx2()) {
+      k = to_tensor_hwc_avx2(src, size, channels, means, scales, dst);
+    }
+    if (cpu_has_sse41()) {
+      k = to_tensor_hwc_sse41(src, size, channels, means, scales, dst, k);
+    }
+    j = k / channels;
+  }
+#endif
+  const uint8_t* in = src + j * channels;
+  float* out = dst + j * out_channels;
+  for (; j < width; j++) {
+    for (int k = 0; k < out_channels; k++) {
+      out[k] = (in[swap_rb ? 2 - k : k] - means[k]) * scales[k];
+    }
+    in += channels;
+    out += out_channels;
+  }
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
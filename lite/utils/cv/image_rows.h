@@ -0,0 +1,159 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "lite/utils/cv/paddle_image_preprocess.h"
+
+// The cv sources keep the baseline ISA, the SSE4.1 and AVX2 row kernels are
+// compiled for their own functions only and picked at run time, as the
+// AVX-512 kernel of packed_sgemm.cc.
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+     defined(_M_IX86)) &&                                            \
+    (defined(__GNUC__) || defined(_MSC_VER))
+#define LITE_CV_WITH_X86_SIMD
+#if defined(__GNUC__)
+#define LITE_CV_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define LITE_CV_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define LITE_CV_TARGET_SSE41
+#define LITE_CV_TARGET_AVX2
+#endif
+#endif
+
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+/*
+ * Row kernels of the image preprocess, the x86 cv functions and the fused
+ * resize -> convert -> to tensor path are built on them. They compute
+ * exactly what the ARM functions compute, in the same fixed point.
+ * simd: false runs the plain C++ loop, the reference the SSE4.1/AVX2 code is
+ * checked and benchmarked against. On a CPU without SSE4.1 the C++ loop
+ * always runs.
+ */
+
+#ifdef LITE_CV_WITH_X86_SIMD
+// whether the CPU runs the SSE4.1 kernels, and the AVX2 (with FMA) ones
+bool cpu_has_sse41();
+bool cpu_has_avx2();
+#endif
+
+// bilinear coefficients, as compute_xy of image_resize.cc
+struct ResizeCoefs {
+  std::vector<int> xofs;  // byte offset of the left source pixel
+  std::vector<int> yofs;  // the top source row
+  std::vector<int16_t> ialpha;
+  std::vector<int16_t> ibeta;
+};
+
+/*
+ * param srcw, dstw: width in pixels of num bytes
+ * param scale_x, scale_y: srcw / dstw and srch / dsth of the caller, the uv
+ * plane of nv12(nv21) uses the scale of the y plane
+ */
+void compute_resize_coefs(int srcw,
+                          int srch,
+                          int dstw,
+                          int dsth,
+                          int num,
+                          double scale_x,
+                          double scale_y,
+                          ResizeCoefs* coefs);
+
+// rows[dx * num + c] = (src[xofs[dx] + c] * a0 + src[xofs[dx] + num + c] * a1)
+// >> 4, for the dstw pixels of a row
+void hresize_row(const uint8_t* src,
+                 const int* xofs,
+                 const int16_t* ialpha,
+                 int dstw,
+                 int num,
+                 int16_t* rows,
+                 bool simd = true);
+
+// dst[x] = (((rows0[x] * b0) >> 16) + ((rows1[x] * b1) >> 16) + 2) >> 2
+void vresize_row(const int16_t* rows0,
+                 const int16_t* rows1,
+                 int16_t b0,
+                 int16_t b1,
+                 int size,
+                 uint8_t* dst,
+                 bool simd = true);
+
+/*
+ * one row of nv12(nv21) to bgr(bgra)
+ * param y: the row of the y plane
+ * param uv: the row of the uv plane shared by this row and its neighbour
+ * param channels: 3 for bgr, 4 for bgra with a = 255
+ */
+void nv_to_bgr_row(const uint8_t* y,
+                   const uint8_t* uv,
+                   int width,
+                   bool nv21,
+                   int channels,
+                   uint8_t* dst,
+                   bool simd = true);
+
+// gray = (15 * c0 + 75 * c1 + 38 * c2) >> 7 of bgr(bgra) with 3(4) channels
+void bgr_to_gray_row(const uint8_t* src,
+                     int width,
+                     int channels,
+                     uint8_t* dst,
+                     bool simd = true);
+
+/*
+ * one row of gray, bgr(rgb) or bgra(rgba) to bgr(rgb) or bgra(rgba)
+ * param swap_rb: swaps the first and the third byte, bgr <-> rgb
+ * the alpha of 4 to 4 channels is kept, it is 255 for the others
+ */
+void convert_hwc_row(const uint8_t* src,
+                     int src_channels,
+                     int width,
+                     int dst_channels,
+                     bool swap_rb,
+                     uint8_t* dst,
+                     bool simd = true);
+
+/*
+ * one row of the image to the tensor, out = (pixel - mean) * scale, the
+ * alpha of 4 channels is dropped
+ * param swap_rb: channel 0 of the tensor takes the third byte of the pixel
+ * param dst: the row of channel 0, the next channels are plane_size apart
+ */
+void to_tensor_chw_row(const uint8_t* src,
+                       int width,
+                       int channels,
+                       bool swap_rb,
+                       const float* means,
+                       const float* scales,
+                       float* dst,
+                       int plane_size,
+                       bool simd = true);
+
+void to_tensor_hwc_row(const uint8_t* src,
+                       int width,
+                       int channels,
+                       bool swap_rb,
+                       const float* means,
+                       const float* scales,
+                       float* dst,
+                       bool simd = true);
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <climits>
 #include "lite/utils/cv/image2tensor.h"
+#include "lite/utils/cv/image2tensor_fused.h"
 #include "lite/utils/cv/image_convert.h"
 #include "lite/utils/cv/image_flip.h"
 #include "lite/utils/cv/image_resize.h"
@@ -216,6 +217,26 @@ __attribute__((visibility("default"))) void ImagePreprocess::image_to_tensor(
 #endif
 }
 
+__attribute__((visibility("default"))) void
+ImagePreprocess::image_resize_to_tensor(const uint8_t* src,
+                                        Tensor* dstTensor,
+                                        LayoutType layout,
+                                        float* means,
+                                        float* scales) {
+  Image2TensorFused img2tensor;
+  img2tensor.choose(src,
+                    dstTensor->mutable_data<float>(),
+                    this->srcFormat_,
+                    this->dstFormat_,
+                    layout,
+                    this->transParam_.iw,
+                    this->transParam_.ih,
+                    this->transParam_.ow,
+                    this->transParam_.oh,
+                    means,
+                    scales);
+}
+
 __attribute__((visibility("default"))) void ImagePreprocess::image_crop(
     const uint8_t* src,
     uint8_t* dst,
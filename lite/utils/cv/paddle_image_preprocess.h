@@ -247,6 +247,24 @@ class ImagePreprocess {
                        float* means,
                        float* scales);
 
+  /*
+  * image resize, color convert and image to tensor in one pass
+  * the result is the one of image_resize(src) from srcFormat_, image_convert
+  * to dstFormat_ and image_to_tensor, without the temporary images
+  * support srcFormat_ NV12(NV21), BGR(RGB), BGRA(RGBA) to dstFormat_
+  * BGR(RGB), and GRAY to GRAY
+  * param src: input image data of transParam_.iw * transParam_.ih
+  * param dstTensor: output tensor data of transParam_.ow * transParam_.oh
+  * param layout: output tensor layout，support NHWC and NCHW
+  * param means: means of image
+  * param scales: scales of image
+  */
+  void image_resize_to_tensor(const uint8_t* src,
+                              Tensor* dstTensor,
+                              LayoutType layout,
+                              float* means,
+                              float* scales);
+
   /*
   * image crop process
   * color format support 1-channel image, 3-channel image and 4-channel image
@@ -0,0 +1,109 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/parallel_defines.h"
+#include "lite/utils/cv/image2tensor.h"
+#include "lite/utils/cv/image_rows.h"
+#include "lite/utils/cv/x86/image_x86.h"
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+namespace x86 {
+
+void image_to_tensor(const uint8_t* src,
+                     float* dst,
+                     ImageFormat srcFormat,
+                     LayoutType layout,
+                     int srcw,
+                     int srch,
+                     const float* means,
+                     const float* scales,
+                     bool simd) {
+  int channels = 0;
+  if (srcFormat == BGR || srcFormat == RGB) {
+    channels = 3;
+  } else if (srcFormat == BGRA || srcFormat == RGBA) {
+    channels = 4;
+  } else if (srcFormat == GRAY) {
+    channels = 1;
+  }
+  if (channels == 0 ||
+      (layout != LayoutType::kNCHW && layout != LayoutType::kNHWC)) {
+    printf("this layout: %d or image format: %d not support \n",
+           static_cast<int>(layout),
+           srcFormat);
+    return;
+  }
+  int out_channels = channels == 1 ? 1 : 3;
+  if (layout == LayoutType::kNCHW) {
+    LITE_PARALLEL_BEGIN(i, tid, srch) {
+      to_tensor_chw_row(src + i * srcw * channels,
+                        srcw,
+                        channels,
+                        false,
+                        means,
+                        scales,
+                        dst + i * srcw,
+                        srcw * srch,
+                        simd);
+    }
+    LITE_PARALLEL_END();
+  } else {
+    LITE_PARALLEL_BEGIN(i, tid, srch) {
+      to_tensor_hwc_row(src + i * srcw * channels,
+                        srcw,
+                        channels,
+                        false,
+                        means,
+                        scales,
+                        dst + i * srcw * out_channels,
+                        simd);
+    }
+    LITE_PARALLEL_END();
+  }
+}
+
+}  // namespace x86
+
+/*
+  * change image data to tensor data
+  * support image format is BGR(RGB) and BGRA(RGBA), Data layout is NHWC and
+ * NCHW
+  * param src: input image data
+  * param dstTensor: output tensor data
+  * param srcFormat: input image format, support GRAY, BGR(GRB) and BGRA(RGBA)
+  * param srcw: input image width
+  * param srch: input image height
+  * param layout: output tensor layout，support NHWC and NCHW
+  * param means: means of image
+  * param scales: scales of image
+*/
+void Image2Tensor::choose(const uint8_t* src,
+                          Tensor* dst,
+                          ImageFormat srcFormat,
+                          LayoutType layout,
+                          int srcw,
+                          int srch,
+                          float* means,
+                          float* scales) {
+  float* output = dst->mutable_data<float>();
+  x86::image_to_tensor(
+      src, output, srcFormat, layout, srcw, srch, means, scales, true);
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
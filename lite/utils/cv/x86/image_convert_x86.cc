@@ -0,0 +1,129 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <math.h>
+#include <string.h>
+#include "lite/core/parallel_defines.h"
+#include "lite/utils/cv/image_convert.h"
+#include "lite/utils/cv/image_rows.h"
+#include "lite/utils/cv/x86/image_x86.h"
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+namespace x86 {
+
+static int pixel_channels(ImageFormat format) {
+  if (format == BGR || format == RGB) {
+    return 3;
+  } else if (format == BGRA || format == RGBA) {
+    return 4;
+  } else if (format == GRAY) {
+    return 1;
+  }
+  return 0;
+}
+
+void image_convert(const uint8_t* src,
+                   uint8_t* dst,
+                   ImageFormat srcFormat,
+                   ImageFormat dstFormat,
+                   int srcw,
+                   int srch,
+                   bool simd) {
+  if (srcFormat == dstFormat) {
+    // copy
+    int size = srcw * srch;
+    if (srcFormat == NV12 || srcFormat == NV21) {
+      size = srcw * (ceil(1.5 * srch));
+    } else if (srcFormat == BGR || srcFormat == RGB) {
+      size = 3 * srcw * srch;
+    } else if (srcFormat == BGRA || srcFormat == RGBA) {
+      size = 4 * srcw * srch;
+    }
+    memcpy(dst, src, sizeof(uint8_t) * size);
+    return;
+  }
+  int src_c = pixel_channels(srcFormat);
+  int dst_c = pixel_channels(dstFormat);
+  if ((srcFormat == NV12 || srcFormat == NV21) && dst_c > 1) {
+    // bgr order for rgb(rgba) too, as the ARM implementation
+    const uint8_t* uv = src + srcw * srch;
+    bool nv21 = srcFormat == NV21;
+    LITE_PARALLEL_BEGIN(i, tid, srch) {
+      nv_to_bgr_row(src + i * srcw,
+                    uv + (i / 2) * srcw,
+                    srcw,
+                    nv21,
+                    dst_c,
+                    dst + i * srcw * dst_c,
+                    simd);
+    }
+    LITE_PARALLEL_END();
+  } else if (src_c > 1 && dst_c == 1) {
+    LITE_PARALLEL_BEGIN(i, tid, srch) {
+      bgr_to_gray_row(
+          src + i * srcw * src_c, srcw, src_c, dst + i * srcw, simd);
+    }
+    LITE_PARALLEL_END();
+  } else if (src_c > 0 && dst_c > 1) {
+    bool src_bgr = srcFormat == BGR || srcFormat == BGRA;
+    bool dst_bgr = dstFormat == BGR || dstFormat == BGRA;
+    bool swap_rb = src_c > 1 && src_bgr != dst_bgr;
+    LITE_PARALLEL_BEGIN(i, tid, srch) {
+      convert_hwc_row(src + i * srcw * src_c,
+                      src_c,
+                      srcw,
+                      dst_c,
+                      swap_rb,
+                      dst + i * srcw * dst_c,
+                      simd);
+    }
+    LITE_PARALLEL_END();
+  } else {
+    printf("srcFormat: %d, dstFormat: %d does not support! \n",
+           srcFormat,
+           dstFormat);
+  }
+}
+
+}  // namespace x86
+
+/*
+  * image color convert
+  * support NV12/NV21_to_BGR(RGB), NV12/NV21_to_BGRA(RGBA),
+  * BGR(RGB)and BGRA(RGBA) transform,
+  * BGR(RGB)and RGB(BGR) transform,
+  * BGR(RGB)and RGBA(BGRA) transform,
+  * BGR(RGB)and GRAY transform,
+  * param src: input image data
+  * param dst: output image data
+  * param srcFormat: input image image format support: GRAY, NV12(NV21),
+ * BGR(RGB) and BGRA(RGBA)
+  * param dstFormat: output image image format, support GRAY, BGR(RGB) and
+ * BGRA(RGBA)
+*/
+void ImageConvert::choose(const uint8_t* src,
+                          uint8_t* dst,
+                          ImageFormat srcFormat,
+                          ImageFormat dstFormat,
+                          int srcw,
+                          int srch) {
+  x86::image_convert(src, dst, srcFormat, dstFormat, srcw, srch, true);
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
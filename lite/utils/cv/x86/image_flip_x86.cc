@@ -0,0 +1,219 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include "lite/core/parallel_defines.h"
+#include "lite/utils/cv/image_flip.h"
+#include "lite/utils/cv/image_rows.h"
+#ifdef LITE_CV_WITH_X86_SIMD
+#include <immintrin.h>
+#endif
+#include "lite/utils/cv/x86/image_x86.h"
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+namespace x86 {
+
+#ifdef LITE_CV_WITH_X86_SIMD
+// the mirror of 32 gray or 8 bgra pixels at a time, returns the pixels done
+LITE_CV_TARGET_AVX2 static int mirror_row_avx2(const uint8_t* src,
+                                               uint8_t* dst,
+                                               int width,
+                                               int channels) {
+  int j = 0;
+  if (channels == 1) {
+    const __m128i rev = _mm_setr_epi8(
+        15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    const __m256i rev2 = _mm256_broadcastsi128_si256(rev);
+    for (; j + 32 <= width; j += 32) {
+      __m256i v =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + j));
+      v = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, rev2), 0x4E);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + width - j - 32),
+                          v);
+    }
+  } else if (channels == 4) {
+    const __m256i rev = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    for (; j + 8 <= width; j += 8) {
+      __m256i v =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + j * 4));
+      _mm256_storeu_si256(
+          reinterpret_cast<__m256i*>(dst + (width - j - 8) * 4),
+          _mm256_permutevar8x32_epi32(v, rev));
+    }
+  }
+  return j;
+}
+
+LITE_CV_TARGET_SSE41 static int mirror_row_sse41(
+    const uint8_t* src, uint8_t* dst, int width, int channels, int j) {
+  if (channels == 1) {
+    const __m128i rev = _mm_setr_epi8(
+        15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    for (; j + 16 <= width; j += 16) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + width - j - 16),
+                       _mm_shuffle_epi8(v, rev));
+    }
+  } else if (channels == 4) {
+    for (; j + 4 <= width; j += 4) {
+      __m128i v =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j * 4));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + (width - j - 4) * 4),
+                       _mm_shuffle_epi32(v, 0x1B));
+    }
+  } else if (channels == 3) {
+    // 16 pixels of 48 bytes, each output vector takes the bytes of two or
+    // three input vectors
+    for (; j + 16 <= width; j += 16) {
+      const uint8_t* in = src + j * 3;
+      __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+      __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16));
+      __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 32));
+      __m128i o0 = _mm_or_si128(
+          _mm_shuffle_epi8(v1,
+                           _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                         -1, -1, -1, -1, -1, -1, 14)),
+          _mm_shuffle_epi8(v2,
+                           _mm_setr_epi8(13, 14, 15, 10, 11, 12, 7, 8, 9, 4, 5,
+                                         6, 1, 2, 3, -1)));
+      __m128i o1 = _mm_or_si128(
+          _mm_or_si128(
+              _mm_shuffle_epi8(v0,
+                               _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                                             -1, -1, -1, -1, -1, -1, 15, -1)),
+              _mm_shuffle_epi8(v1,
+                               _mm_setr_epi8(15, -1, 11, 12, 13, 8, 9, 10, 5, 6,
+                                             7, 2, 3, 4, -1, 0))),
+          _mm_shuffle_epi8(v2,
+                           _mm_setr_epi8(-1, 0, -1, -1, -1, -1, -1, -1, -1, -1,
+                                         -1, -1, -1, -1, -1, -1)));
+      __m128i o2 = _mm_or_si128(
+          _mm_shuffle_epi8(v0,
+                           _mm_setr_epi8(-1, 12, 13, 14, 9, 10, 11, 6, 7, 8, 3,
+                                         4, 5, 0, 1, 2)),
+          _mm_shuffle_epi8(v1,
+                           _mm_setr_epi8(1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                         -1, -1, -1, -1, -1, -1)));
+      uint8_t* out = dst + (width - j - 16) * 3;
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), o0);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), o1);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 32), o2);
+    }
+  }
+  return j;
+}
+#endif
+
+// dst is src with its pixels of channels bytes in the reverse order
+static void mirror_row(
+    const uint8_t* src, uint8_t* dst, int width, int channels, bool simd) {
+  int j = 0;
+#ifdef LITE_CV_WITH_X86_SIMD
+  if (simd && cpu_has_avx2()) {
+    j = mirror_row_avx2(src, dst, width, channels);
+  }
+  if (simd && cpu_has_sse41()) {
+    j = mirror_row_sse41(src, dst, width, channels, j);
+  }
+#endif
+  for (; j < width; j++) {
+    const uint8_t* in = src + j * channels;
+    uint8_t* out = dst + (width - 1 - j) * channels;
+    for (int c = 0; c < channels; c++) {
+      out[c] = in[c];
+    }
+  }
+}
+
+/*
+ * flip X:  1 2 3    7 8 9
+ *          4 5 6 -> 4 5 6
+ *          7 8 9    1 2 3
+ * flip Y mirrors every row, flip XY does both
+ */
+void image_flip(const uint8_t* src,
+                uint8_t* dst,
+                int channels,
+                int srcw,
+                int srch,
+                FlipParam flip_param,
+                bool simd) {
+  if (flip_param != X && flip_param != Y && flip_param != XY) {
+    printf("its doesn't support Flip: %d \n", static_cast<int>(flip_param));
+    return;
+  }
+  int row_size = srcw * channels;
+  LITE_PARALLEL_BEGIN(i, tid, srch) {
+    const uint8_t* in = src + i * row_size;
+    int dst_row = flip_param == Y ? i : srch - 1 - i;
+    uint8_t* out = dst + dst_row * row_size;
+    if (flip_param == X) {
+      memcpy(out, in, sizeof(uint8_t) * row_size);
+    } else {
+      mirror_row(in, out, srcw, channels, simd);
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+}  // namespace x86
+
+void ImageFlip::choose(const uint8_t* src,
+                       uint8_t* dst,
+                       ImageFormat srcFormat,
+                       int srcw,
+                       int srch,
+                       FlipParam flip_param) {
+  if (srcFormat == GRAY) {
+    flip_hwc1(src, dst, srcw, srch, flip_param);
+  } else if (srcFormat == BGR || srcFormat == RGB) {
+    flip_hwc3(src, dst, srcw, srch, flip_param);
+  } else if (srcFormat == BGRA || srcFormat == RGBA) {
+    flip_hwc4(src, dst, srcw, srch, flip_param);
+  } else {
+    printf("this srcFormat: %d does not support! \n", srcFormat);
+    return;
+  }
+}
+
+void flip_hwc1(const uint8_t* src,
+               uint8_t* dst,
+               int srcw,
+               int srch,
+               FlipParam flip_param) {
+  x86::image_flip(src, dst, 1, srcw, srch, flip_param, true);
+}
+
+void flip_hwc3(const uint8_t* src,
+               uint8_t* dst,
+               int srcw,
+               int srch,
+               FlipParam flip_param) {
+  x86::image_flip(src, dst, 3, srcw, srch, flip_param, true);
+}
+
+void flip_hwc4(const uint8_t* src,
+               uint8_t* dst,
+               int srcw,
+               int srch,
+               FlipParam flip_param) {
+  x86::image_flip(src, dst, 4, srcw, srch, flip_param, true);
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,216 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "lite/core/parallel_defines.h"
+#include "lite/utils/cv/image_resize.h"
+#include "lite/utils/cv/image_rows.h"
+#include "lite/utils/cv/x86/image_x86.h"
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+namespace x86 {
+
+// the rows of a task share the horizontally resized source rows
+static const int kResizeRowsPerTask = 16;
+
+// bilinear resize of a plane of pixels of num bytes, rows are stride apart
+static void resize_plane(const uint8_t* src,
+                         int src_stride,
+                         int srcw,
+                         int srch,
+                         uint8_t* dst,
+                         int dst_stride,
+                         int dstw,
+                         int dsth,
+                         int num,
+                         double scale_x,
+                         double scale_y,
+                         bool simd) {
+  ResizeCoefs coefs;
+  compute_resize_coefs(
+      srcw, srch, dstw, dsth, num, scale_x, scale_y, &coefs);
+  const int row_size = dstw * num;
+  LITE_PARALLEL_COMMON_BEGIN(dy0, tid, dsth, 0, kResizeRowsPerTask) {
+    std::vector<int16_t> rowsbuf(row_size * 2);
+    int16_t* rows0 = rowsbuf.data();
+    int16_t* rows1 = rows0 + row_size;
+    int prev_sy = -2;
+    int dy_end = std::min(dy0 + kResizeRowsPerTask, dsth);
+    for (int dy = dy0; dy < dy_end; dy++) {
+      int sy = coefs.yofs[dy];
+      if (sy == prev_sy + 1) {
+        // hresize one row
+        std::swap(rows0, rows1);
+        hresize_row(src + src_stride * (sy + 1),
+                    coefs.xofs.data(),
+                    coefs.ialpha.data(),
+                    dstw,
+                    num,
+                    rows1,
+                    simd);
+      } else if (sy != prev_sy) {
+        // hresize two rows
+        hresize_row(src + src_stride * sy,
+                    coefs.xofs.data(),
+                    coefs.ialpha.data(),
+                    dstw,
+                    num,
+                    rows0,
+                    simd);
+        hresize_row(src + src_stride * (sy + 1),
+                    coefs.xofs.data(),
+                    coefs.ialpha.data(),
+                    dstw,
+                    num,
+                    rows1,
+                    simd);
+      }
+      prev_sy = sy;
+      vresize_row(rows0,
+                  rows1,
+                  coefs.ibeta[dy * 2],
+                  coefs.ibeta[dy * 2 + 1],
+                  row_size,
+                  dst + dst_stride * dy,
+                  simd);
+    }
+  }
+  LITE_PARALLEL_COMMON_END();
+}
+
+void image_resize(const uint8_t* src,
+                  uint8_t* dst,
+                  ImageFormat srcFormat,
+                  int srcw,
+                  int srch,
+                  int dstw,
+                  int dsth,
+                  bool simd) {
+  int size = srcw * srch;
+  if (srcw == dstw && srch == dsth) {
+    if (srcFormat == NV12 || srcFormat == NV21) {
+      size = srcw * (static_cast<int>(1.5 * srch));
+    } else if (srcFormat == BGR || srcFormat == RGB) {
+      size = 3 * srcw * srch;
+    } else if (srcFormat == BGRA || srcFormat == RGBA) {
+      size = 4 * srcw * srch;
+    }
+    memcpy(dst, src, sizeof(uint8_t) * size);
+    return;
+  }
+  double scale_x = static_cast<double>(srcw) / dstw;
+  double scale_y = static_cast<double>(srch) / dsth;
+  if (srcFormat == GRAY) {
+    resize_plane(src,
+                 srcw,
+                 srcw,
+                 srch,
+                 dst,
+                 dstw,
+                 dstw,
+                 dsth,
+                 1,
+                 scale_x,
+                 scale_y,
+                 simd);
+  } else if (srcFormat == NV12 || srcFormat == NV21) {
+    // y
+    resize_plane(src,
+                 srcw,
+                 srcw,
+                 srch,
+                 dst,
+                 dstw,
+                 dstw,
+                 dsth,
+                 1,
+                 scale_x,
+                 scale_y,
+                 simd);
+    // uv, pairs of bytes of half the height
+    int uv_h = srch / 2;
+    int dst_uv_h = dsth / 2;
+    resize_plane(src + srcw * srch,
+                 srcw,
+                 srcw / 2,
+                 uv_h,
+                 dst + dstw * dsth,
+                 dstw,
+                 dstw / 2,
+                 dst_uv_h,
+                 2,
+                 scale_x,
+                 static_cast<double>(uv_h) / dst_uv_h,
+                 simd);
+  } else if (srcFormat == BGR || srcFormat == RGB) {
+    resize_plane(src,
+                 srcw * 3,
+                 srcw,
+                 srch,
+                 dst,
+                 dstw * 3,
+                 dstw,
+                 dsth,
+                 3,
+                 scale_x,
+                 scale_y,
+                 simd);
+  } else if (srcFormat == BGRA || srcFormat == RGBA) {
+    resize_plane(src,
+                 srcw * 4,
+                 srcw,
+                 srch,
+                 dst,
+                 dstw * 4,
+                 dstw,
+                 dsth,
+                 4,
+                 scale_x,
+                 scale_y,
+                 simd);
+  }
+}
+
+}  // namespace x86
+
+void ImageResize::choose(const uint8_t* src,
+                         uint8_t* dst,
+                         ImageFormat srcFormat,
+                         int srcw,
+                         int srch,
+                         int dstw,
+                         int dsth) {
+  resize(src, dst, srcFormat, srcw, srch, dstw, dsth);
+}
+
+// use bilinear method to resize
+void resize(const uint8_t* src,
+            uint8_t* dst,
+            ImageFormat srcFormat,
+            int srcw,
+            int srch,
+            int dstw,
+            int dsth) {
+  x86::image_resize(src, dst, srcFormat, srcw, srch, dstw, dsth, true);
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,226 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include <algorithm>
+#include "lite/core/parallel_defines.h"
+#include "lite/utils/cv/bgr_rotate.h"
+#include "lite/utils/cv/image_rotate.h"
+#include "lite/utils/cv/image_rows.h"
+#ifdef LITE_CV_WITH_X86_SIMD
+#include <immintrin.h>
+#endif
+#include "lite/utils/cv/x86/image_x86.h"
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+namespace x86 {
+
+// the rotation goes by blocks of kRotateBlock x kRotateBlock pixels
+static const int kRotateBlock = 8;
+
+// the destination pixel of src pixel (i, j), w_out = srch
+static inline int rotate_index(
+    int i, int j, int srcw, int srch, bool clockwise) {
+  return clockwise ? j * srch + (srch - 1 - i) : (srcw - 1 - j) * srch + i;
+}
+
+#ifdef LITE_CV_WITH_X86_SIMD
+// transposes the 8 x 8 bytes of src rows r[0] .. r[7] starting at column j,
+// dst row k gets column k
+LITE_CV_TARGET_SSE41 static void transpose8x8(const uint8_t* const* r,
+                                              int j,
+                                              uint8_t* const* dst) {
+  __m128i r0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(r[0] + j));
+  __m128i r1 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(r[1] + j));
+  __m128i r2 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(r[2] + j));
+  __m128i r3 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(r[3] + j));
+  __m128i r4 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(r[4] + j));
+  __m128i r5 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(r[5] + j));
+  __m128i r6 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(r[6] + j));
+  __m128i r7 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(r[7] + j));
+  __m128i t0 = _mm_unpacklo_epi8(r0, r1);
+  __m128i t1 = _mm_unpacklo_epi8(r2, r3);
+  __m128i t2 = _mm_unpacklo_epi8(r4, r5);
+  __m128i t3 = _mm_unpacklo_epi8(r6, r7);
+  __m128i u0 = _mm_unpacklo_epi16(t0, t1);
+  __m128i u1 = _mm_unpackhi_epi16(t0, t1);
+  __m128i u2 = _mm_unpacklo_epi16(t2, t3);
+  __m128i u3 = _mm_unpackhi_epi16(t2, t3);
+  __m128i cols[4] = {_mm_unpacklo_epi32(u0, u2),
+                     _mm_unpackhi_epi32(u0, u2),
+                     _mm_unpacklo_epi32(u1, u3),
+                     _mm_unpackhi_epi32(u1, u3)};
+  for (int k = 0; k < 4; k++) {
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst[k * 2]), cols[k]);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst[k * 2 + 1]),
+                     _mm_unpackhi_epi64(cols[k], cols[k]));
+  }
+}
+
+// the same for 4 x 4 pixels of 4 bytes
+LITE_CV_TARGET_SSE41 static void transpose4x4_u32(const uint8_t* const* r,
+                                                  int j,
+                                                  uint8_t* const* dst) {
+  __m128 r0 = _mm_loadu_ps(reinterpret_cast<const float*>(r[0] + j * 4));
+  __m128 r1 = _mm_loadu_ps(reinterpret_cast<const float*>(r[1] + j * 4));
+  __m128 r2 = _mm_loadu_ps(reinterpret_cast<const float*>(r[2] + j * 4));
+  __m128 r3 = _mm_loadu_ps(reinterpret_cast<const float*>(r[3] + j * 4));
+  // only moves the bits
+  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+  _mm_storeu_ps(reinterpret_cast<float*>(dst[0]), r0);
+  _mm_storeu_ps(reinterpret_cast<float*>(dst[1]), r1);
+  _mm_storeu_ps(reinterpret_cast<float*>(dst[2]), r2);
+  _mm_storeu_ps(reinterpret_cast<float*>(dst[3]), r3);
+}
+#endif
+
+/*
+ * rotate 90:  1 2 3    7 4 1      rotate 270:  1 2 3    3 6 9
+ *             4 5 6 -> 8 5 2                   4 5 6 -> 2 5 8
+ *             7 8 9    9 6 3                   7 8 9    1 4 7
+ */
+static void rotate_90_270(const uint8_t* src,
+                          uint8_t* dst,
+                          int channels,
+                          int srcw,
+                          int srch,
+                          bool clockwise,
+                          bool simd) {
+  const int row_size = srcw * channels;
+  LITE_PARALLEL_COMMON_BEGIN(i0, tid, srch, 0, kRotateBlock) {
+    int i_end = std::min(i0 + kRotateBlock, srch);
+    // the first row the transposes leave
+    int i_tail = i0;
+#ifdef LITE_CV_WITH_X86_SIMD
+    int tile = channels == 1 ? 8 : channels == 4 ? 4 : 0;
+    if (!simd || !cpu_has_sse41()) {
+      tile = 0;
+    }
+    for (; tile > 0 && i_tail + tile <= i_end; i_tail += tile) {
+      // clockwise reads the rows bottom up so the columns land in order
+      const uint8_t* rows[8];
+      for (int k = 0; k < tile; k++) {
+        int i = clockwise ? i_tail + tile - 1 - k : i_tail + k;
+        rows[k] = src + i * row_size;
+      }
+      int first_i = clockwise ? i_tail + tile - 1 : i_tail;
+      int j = 0;
+      for (; j + tile <= srcw; j += tile) {
+        uint8_t* outs[8];
+        for (int k = 0; k < tile; k++) {
+          outs[k] = dst +
+                    rotate_index(first_i, j + k, srcw, srch, clockwise) *
+                        channels;
+        }
+        if (channels == 1) {
+          transpose8x8(rows, j, outs);
+        } else {
+          transpose4x4_u32(rows, j, outs);
+        }
+      }
+      // the right columns
+      for (int i = i_tail; i < i_tail + tile; i++) {
+        for (int jt = j; jt < srcw; jt++) {
+          memcpy(dst + rotate_index(i, jt, srcw, srch, clockwise) * channels,
+                 src + i * row_size + jt * channels,
+                 channels);
+        }
+      }
+    }
+#endif
+    // plain loops over tiles of the columns
+    for (int jb = 0; jb < srcw; jb += kRotateBlock) {
+      int j_end = std::min(jb + kRotateBlock, srcw);
+      for (int i = i_tail; i < i_end; i++) {
+        const uint8_t* in = src + i * row_size;
+        for (int j = jb; j < j_end; j++) {
+          uint8_t* out =
+              dst + rotate_index(i, j, srcw, srch, clockwise) * channels;
+          for (int c = 0; c < channels; c++) {
+            out[c] = in[j * channels + c];
+          }
+        }
+      }
+    }
+  }
+  LITE_PARALLEL_COMMON_END();
+}
+
+void image_rotate(const uint8_t* src,
+                  uint8_t* dst,
+                  int channels,
+                  int srcw,
+                  int srch,
+                  int degree,
+                  bool simd) {
+  if (degree == 90) {
+    rotate_90_270(src, dst, channels, srcw, srch, true, simd);
+  } else if (degree == 270) {
+    rotate_90_270(src, dst, channels, srcw, srch, false, simd);
+  } else if (degree == 180) {
+    image_flip(src, dst, channels, srcw, srch, XY, simd);
+  } else {
+    printf("this degree: %d does not support! \n", degree);
+  }
+}
+
+}  // namespace x86
+
+void ImageRotate::choose(const uint8_t* src,
+                         uint8_t* dst,
+                         ImageFormat srcFormat,
+                         int srcw,
+                         int srch,
+                         float degree) {
+  if (degree != 90 && degree != 180 && degree != 270) {
+    printf("this degree: %f not support \n", degree);
+  }
+  if (srcFormat == GRAY) {
+    rotate_hwc1(src, dst, srcw, srch, degree);
+  } else if (srcFormat == BGR || srcFormat == RGB) {
+    bgr_rotate_hwc(src, dst, srcw, srch, static_cast<int>(degree));
+  } else if (srcFormat == BGRA || srcFormat == RGBA) {
+    rotate_hwc4(src, dst, srcw, srch, degree);
+  } else {
+    printf("this srcFormat: %d does not support! \n", srcFormat);
+    return;
+  }
+}
+
+void rotate_hwc1(
+    const uint8_t* src, uint8_t* dst, int srcw, int srch, float degree) {
+  x86::image_rotate(src, dst, 1, srcw, srch, static_cast<int>(degree), true);
+}
+
+void rotate_hwc3(
+    const uint8_t* src, uint8_t* dst, int srcw, int srch, float degree) {
+  x86::image_rotate(src, dst, 3, srcw, srch, static_cast<int>(degree), true);
+}
+
+void rotate_hwc4(
+    const uint8_t* src, uint8_t* dst, int srcw, int srch, float degree) {
+  x86::image_rotate(src, dst, 4, srcw, srch, static_cast<int>(degree), true);
+}
+
+void bgr_rotate_hwc(
+    const uint8_t* src, uint8_t* dst, int w_in, int h_in, int angle) {
+  x86::image_rotate(src, dst, 3, w_in, h_in, angle, true);
+}
+
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,78 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include "lite/utils/cv/paddle_image_preprocess.h"
+namespace paddle {
+namespace lite {
+namespace utils {
+namespace cv {
+namespace x86 {
+/*
+ * The x86 implementations of ImageConvert, ImageResize, Image2Tensor,
+ * ImageFlip and ImageRotate, they give the same bytes as the ARM ones.
+ * param simd: false runs the plain C++ code, the reference of the tests and
+ * the benchmark, the cv classes run with true.
+ */
+void image_convert(const uint8_t* src,
+                   uint8_t* dst,
+                   ImageFormat srcFormat,
+                   ImageFormat dstFormat,
+                   int srcw,
+                   int srch,
+                   bool simd);
+
+void image_resize(const uint8_t* src,
+                  uint8_t* dst,
+                  ImageFormat srcFormat,
+                  int srcw,
+                  int srch,
+                  int dstw,
+                  int dsth,
+                  bool simd);
+
+void image_to_tensor(const uint8_t* src,
+                     float* dst,
+                     ImageFormat srcFormat,
+                     LayoutType layout,
+                     int srcw,
+                     int srch,
+                     const float* means,
+                     const float* scales,
+                     bool simd);
+
+// param channels: 1 for GRAY, 3 for BGR(RGB) and 4 for BGRA(RGBA)
+void image_flip(const uint8_t* src,
+                uint8_t* dst,
+                int channels,
+                int srcw,
+                int srch,
+                FlipParam flip_param,
+                bool simd);
+
+void image_rotate(const uint8_t* src,
+                  uint8_t* dst,
+                  int channels,
+                  int srcw,
+                  int srch,
+                  int degree,
+                  bool simd);
+
+}  // namespace x86
+}  // namespace cv
+}  // namespace utils
+}  // namespace lite
+}  // namespace paddle
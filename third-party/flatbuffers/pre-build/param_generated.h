@@ -58,6 +58,69 @@ inline const flatbuffers::TypeTable *ParamDescTypeTable();
 
 namespace ParamDesc_ {
 
+enum Compression {
+  Compression_NONE = 0,
+  Compression_LZ4 = 1,
+  Compression_MIN = Compression_NONE,
+  Compression_MAX = Compression_LZ4
+};
+
+inline const Compression (&EnumValuesCompression())[2] {
+  static const Compression values[] = {
+    Compression_NONE,
+    Compression_LZ4
+  };
+  return values;
+}
+
+inline const char * const *EnumNamesCompression() {
+  static const char * const names[3] = {
+    "NONE",
+    "LZ4",
+    nullptr
+  };
+  return names;
+}
+
+inline const char *EnumNameCompression(Compression e) {
+  if (flatbuffers::IsOutRange(e, Compression_NONE, Compression_LZ4)) return "";
+  const size_t index = static_cast<size_t>(e);
+  return EnumNamesCompression()[index];
+}
+
+enum Storage {
+  Storage_RAW = 0,
+  Storage_FP16 = 1,
+  Storage_INT8 = 2,
+  Storage_MIN = Storage_RAW,
+  Storage_MAX = Storage_INT8
+};
+
+inline const Storage (&EnumValuesStorage())[3] {
+  static const Storage values[] = {
+    Storage_RAW,
+    Storage_FP16,
+    Storage_INT8
+  };
+  return values;
+}
+
+inline const char * const *EnumNamesStorage() {
+  static const char * const names[4] = {
+    "RAW",
+    "FP16",
+    "INT8",
+    nullptr
+  };
+  return names;
+}
+
+inline const char *EnumNameStorage(Storage e) {
+  if (flatbuffers::IsOutRange(e, Storage_RAW, Storage_INT8)) return "";
+  const size_t index = static_cast<size_t>(e);
+  return EnumNamesStorage()[index];
+}
+
 enum VariableDesc {
   VariableDesc_NONE = 0,
   VariableDesc_LoDTensorDesc = 1,
@@ -255,9 +318,16 @@ struct LoDTensorDescT : public flatbuffers::NativeTable {
   std::vector<int64_t> dim;
   paddle::lite::fbs::proto::VarType_::Type data_type;
   std::vector<int8_t> data;
+  paddle::lite::fbs::proto::ParamDesc_::Compression compression;
+  paddle::lite::fbs::proto::ParamDesc_::Storage storage;
+  uint64_t raw_size;
+  std::vector<float> scales;
   LoDTensorDescT()
       : lod_level(0),
-        data_type(paddle::lite::fbs::proto::VarType_::Type_BOOL) {
+        data_type(paddle::lite::fbs::proto::VarType_::Type_BOOL),
+        compression(paddle::lite::fbs::proto::ParamDesc_::Compression_NONE),
+        storage(paddle::lite::fbs::proto::ParamDesc_::Storage_RAW),
+        raw_size(0) {
   }
 };
 
@@ -267,7 +337,11 @@ inline bool operator==(const LoDTensorDescT &lhs, const LoDTensorDescT &rhs) {
       (lhs.lod == rhs.lod) &&
       (lhs.dim == rhs.dim) &&
       (lhs.data_type == rhs.data_type) &&
-      (lhs.data == rhs.data);
+      (lhs.data == rhs.data) &&
+      (lhs.compression == rhs.compression) &&
+      (lhs.storage == rhs.storage) &&
+      (lhs.raw_size == rhs.raw_size) &&
+      (lhs.scales == rhs.scales);
 }
 
 inline bool operator!=(const LoDTensorDescT &lhs, const LoDTensorDescT &rhs) {
@@ -286,7 +360,11 @@ struct LoDTensorDesc FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
     VT_LOD = 6,
     VT_DIM = 8,
     VT_DATA_TYPE = 10,
-    VT_DATA = 12
+    VT_DATA = 12,
+    VT_COMPRESSION = 14,
+    VT_STORAGE = 16,
+    VT_RAW_SIZE = 18,
+    VT_SCALES = 20
   };
   int32_t lod_level() const {
     return GetField<int32_t>(VT_LOD_LEVEL, 0);
@@ -318,6 +396,30 @@ struct LoDTensorDesc FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   flatbuffers::Vector<int8_t> *mutable_data() {
     return GetPointer<flatbuffers::Vector<int8_t> *>(VT_DATA);
   }
+  paddle::lite::fbs::proto::ParamDesc_::Compression compression() const {
+    return static_cast<paddle::lite::fbs::proto::ParamDesc_::Compression>(GetField<int32_t>(VT_COMPRESSION, 0));
+  }
+  bool mutate_compression(paddle::lite::fbs::proto::ParamDesc_::Compression _compression) {
+    return SetField<int32_t>(VT_COMPRESSION, static_cast<int32_t>(_compression), 0);
+  }
+  paddle::lite::fbs::proto::ParamDesc_::Storage storage() const {
+    return static_cast<paddle::lite::fbs::proto::ParamDesc_::Storage>(GetField<int32_t>(VT_STORAGE, 0));
+  }
+  bool mutate_storage(paddle::lite::fbs::proto::ParamDesc_::Storage _storage) {
+    return SetField<int32_t>(VT_STORAGE, static_cast<int32_t>(_storage), 0);
+  }
+  uint64_t raw_size() const {
+    return GetField<uint64_t>(VT_RAW_SIZE, 0);
+  }
+  bool mutate_raw_size(uint64_t _raw_size) {
+    return SetField<uint64_t>(VT_RAW_SIZE, _raw_size, 0);
+  }
+  const flatbuffers::Vector<float> *scales() const {
+    return GetPointer<const flatbuffers::Vector<float> *>(VT_SCALES);
+  }
+  flatbuffers::Vector<float> *mutable_scales() {
+    return GetPointer<flatbuffers::Vector<float> *>(VT_SCALES);
+  }
   bool Verify(flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyField<int32_t>(verifier, VT_LOD_LEVEL) &&
@@ -328,6 +430,11 @@ struct LoDTensorDesc FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            VerifyField<int32_t>(verifier, VT_DATA_TYPE) &&
            VerifyOffset(verifier, VT_DATA) &&
            verifier.VerifyVector(data()) &&
+           VerifyField<int32_t>(verifier, VT_COMPRESSION) &&
+           VerifyField<int32_t>(verifier, VT_STORAGE) &&
+           VerifyField<uint64_t>(verifier, VT_RAW_SIZE) &&
+           VerifyOffset(verifier, VT_SCALES) &&
+           verifier.VerifyVector(scales()) &&
            verifier.EndTable();
   }
   LoDTensorDescT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
@@ -354,6 +461,18 @@ struct LoDTensorDescBuilder {
   void add_data(flatbuffers::Offset<flatbuffers::Vector<int8_t>> data) {
     fbb_.AddOffset(LoDTensorDesc::VT_DATA, data);
   }
+  void add_compression(paddle::lite::fbs::proto::ParamDesc_::Compression compression) {
+    fbb_.AddElement<int32_t>(LoDTensorDesc::VT_COMPRESSION, static_cast<int32_t>(compression), 0);
+  }
+  void add_storage(paddle::lite::fbs::proto::ParamDesc_::Storage storage) {
+    fbb_.AddElement<int32_t>(LoDTensorDesc::VT_STORAGE, static_cast<int32_t>(storage), 0);
+  }
+  void add_raw_size(uint64_t raw_size) {
+    fbb_.AddElement<uint64_t>(LoDTensorDesc::VT_RAW_SIZE, raw_size, 0);
+  }
+  void add_scales(flatbuffers::Offset<flatbuffers::Vector<float>> scales) {
+    fbb_.AddOffset(LoDTensorDesc::VT_SCALES, scales);
+  }
   explicit LoDTensorDescBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -372,8 +491,16 @@ inline flatbuffers::Offset<LoDTensorDesc> CreateLoDTensorDesc(
     flatbuffers::Offset<flatbuffers::Vector<int64_t>> lod = 0,
     flatbuffers::Offset<flatbuffers::Vector<int64_t>> dim = 0,
     paddle::lite::fbs::proto::VarType_::Type data_type = paddle::lite::fbs::proto::VarType_::Type_BOOL,
-    flatbuffers::Offset<flatbuffers::Vector<int8_t>> data = 0) {
+    flatbuffers::Offset<flatbuffers::Vector<int8_t>> data = 0,
+    paddle::lite::fbs::proto::ParamDesc_::Compression compression = paddle::lite::fbs::proto::ParamDesc_::Compression_NONE,
+    paddle::lite::fbs::proto::ParamDesc_::Storage storage = paddle::lite::fbs::proto::ParamDesc_::Storage_RAW,
+    uint64_t raw_size = 0,
+    flatbuffers::Offset<flatbuffers::Vector<float>> scales = 0) {
   LoDTensorDescBuilder builder_(_fbb);
+  builder_.add_raw_size(raw_size);
+  builder_.add_scales(scales);
+  builder_.add_storage(storage);
+  builder_.add_compression(compression);
   builder_.add_data(data);
   builder_.add_data_type(data_type);
   builder_.add_dim(dim);
@@ -388,17 +515,26 @@ inline flatbuffers::Offset<LoDTensorDesc> CreateLoDTensorDescDirect(
     const std::vector<int64_t> *lod = nullptr,
     const std::vector<int64_t> *dim = nullptr,
     paddle::lite::fbs::proto::VarType_::Type data_type = paddle::lite::fbs::proto::VarType_::Type_BOOL,
-    const std::vector<int8_t> *data = nullptr) {
+    const std::vector<int8_t> *data = nullptr,
+    paddle::lite::fbs::proto::ParamDesc_::Compression compression = paddle::lite::fbs::proto::ParamDesc_::Compression_NONE,
+    paddle::lite::fbs::proto::ParamDesc_::Storage storage = paddle::lite::fbs::proto::ParamDesc_::Storage_RAW,
+    uint64_t raw_size = 0,
+    const std::vector<float> *scales = nullptr) {
   auto lod__ = lod ? _fbb.CreateVector<int64_t>(*lod) : 0;
   auto dim__ = dim ? _fbb.CreateVector<int64_t>(*dim) : 0;
   auto data__ = data ? _fbb.CreateVector<int8_t>(*data) : 0;
+  auto scales__ = scales ? _fbb.CreateVector<float>(*scales) : 0;
   return paddle::lite::fbs::proto::ParamDesc_::CreateLoDTensorDesc(
       _fbb,
       lod_level,
       lod__,
       dim__,
       data_type,
-      data__);
+      data__,
+      compression,
+      storage,
+      raw_size,
+      scales__);
 }
 
 flatbuffers::Offset<LoDTensorDesc> CreateLoDTensorDesc(flatbuffers::FlatBufferBuilder &_fbb, const LoDTensorDescT *_o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
@@ -679,6 +815,10 @@ inline void LoDTensorDesc::UnPackTo(LoDTensorDescT *_o, const flatbuffers::resol
   { auto _e = dim(); if (_e) { _o->dim.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->dim[_i] = _e->Get(_i); } } }
   { auto _e = data_type(); _o->data_type = _e; }
   { auto _e = data(); if (_e) { _o->data.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->data[_i] = _e->Get(_i); } } }
+  { auto _e = compression(); _o->compression = _e; }
+  { auto _e = storage(); _o->storage = _e; }
+  { auto _e = raw_size(); _o->raw_size = _e; }
+  { auto _e = scales(); if (_e) { _o->scales.resize(_e->size()); for (flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { _o->scales[_i] = _e->Get(_i); } } }
 }
 
 inline flatbuffers::Offset<LoDTensorDesc> LoDTensorDesc::Pack(flatbuffers::FlatBufferBuilder &_fbb, const LoDTensorDescT* _o, const flatbuffers::rehasher_function_t *_rehasher) {
@@ -694,13 +834,21 @@ inline flatbuffers::Offset<LoDTensorDesc> CreateLoDTensorDesc(flatbuffers::FlatB
   auto _dim = _fbb.CreateVector(_o->dim);
   auto _data_type = _o->data_type;
   auto _data = _fbb.CreateVector(_o->data);
+  auto _compression = _o->compression;
+  auto _storage = _o->storage;
+  auto _raw_size = _o->raw_size;
+  auto _scales = _fbb.CreateVector(_o->scales);
   return paddle::lite::fbs::proto::ParamDesc_::CreateLoDTensorDesc(
       _fbb,
       _lod_level,
       _lod,
       _dim,
       _data_type,
-      _data);
+      _data,
+      _compression,
+      _storage,
+      _raw_size,
+      _scales);
 }
 
 inline VersionDescT *VersionDesc::UnPack(const flatbuffers::resolver_function_t *_resolver) const {
@@ -840,6 +988,44 @@ inline void VariableDescUnion::Reset() {
   type = VariableDesc_NONE;
 }
 
+inline const flatbuffers::TypeTable *CompressionTypeTable() {
+  static const flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_INT, 0, 0 },
+    { flatbuffers::ET_INT, 0, 0 }
+  };
+  static const flatbuffers::TypeFunction type_refs[] = {
+    paddle::lite::fbs::proto::ParamDesc_::CompressionTypeTable
+  };
+  static const char * const names[] = {
+    "NONE",
+    "LZ4"
+  };
+  static const flatbuffers::TypeTable tt = {
+    flatbuffers::ST_ENUM, 2, type_codes, type_refs, nullptr, names
+  };
+  return &tt;
+}
+
+inline const flatbuffers::TypeTable *StorageTypeTable() {
+  static const flatbuffers::TypeCode type_codes[] = {
+    { flatbuffers::ET_INT, 0, 0 },
+    { flatbuffers::ET_INT, 0, 0 },
+    { flatbuffers::ET_INT, 0, 0 }
+  };
+  static const flatbuffers::TypeFunction type_refs[] = {
+    paddle::lite::fbs::proto::ParamDesc_::StorageTypeTable
+  };
+  static const char * const names[] = {
+    "RAW",
+    "FP16",
+    "INT8"
+  };
+  static const flatbuffers::TypeTable tt = {
+    flatbuffers::ST_ENUM, 3, type_codes, type_refs, nullptr, names
+  };
+  return &tt;
+}
+
 inline const flatbuffers::TypeTable *VariableDescTypeTable() {
   static const flatbuffers::TypeCode type_codes[] = {
     { flatbuffers::ET_SEQUENCE, 0, -1 },
@@ -884,20 +1070,30 @@ inline const flatbuffers::TypeTable *LoDTensorDescTypeTable() {
     { flatbuffers::ET_LONG, 1, -1 },
     { flatbuffers::ET_LONG, 1, -1 },
     { flatbuffers::ET_INT, 0, 0 },
-    { flatbuffers::ET_CHAR, 1, -1 }
+    { flatbuffers::ET_CHAR, 1, -1 },
+    { flatbuffers::ET_INT, 0, 1 },
+    { flatbuffers::ET_INT, 0, 2 },
+    { flatbuffers::ET_ULONG, 0, -1 },
+    { flatbuffers::ET_FLOAT, 1, -1 }
   };
   static const flatbuffers::TypeFunction type_refs[] = {
-    paddle::lite::fbs::proto::VarType_::TypeTypeTable
+    paddle::lite::fbs::proto::VarType_::TypeTypeTable,
+    paddle::lite::fbs::proto::ParamDesc_::CompressionTypeTable,
+    paddle::lite::fbs::proto::ParamDesc_::StorageTypeTable
   };
   static const char * const names[] = {
     "lod_level",
     "lod",
     "dim",
     "data_type",
-    "data"
+    "data",
+    "compression",
+    "storage",
+    "raw_size",
+    "scales"
   };
   static const flatbuffers::TypeTable tt = {
-    flatbuffers::ST_TABLE, 5, type_codes, type_refs, nullptr, names
+    flatbuffers::ST_TABLE, 9, type_codes, type_refs, nullptr, names
   };
   return &tt;
 }